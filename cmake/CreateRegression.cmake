@@ -17,6 +17,11 @@ macro(create_regression)
             continue()
         endif()
 
+        # Performance regression files are copied to their own folder, see below.
+        if("${REGRESSION_SOURCE_FILE_NAME}" MATCHES "^perf/")
+            string(CONCAT REGRESSION_BINARY_FILE "${CMAKE_BINARY_DIR}/" "${REGRESSION_SOURCE_FILE_NAME}")
+        endif()
+
         add_custom_command(OUTPUT ${REGRESSION_BINARY_FILE}
                 COMMAND ${CMAKE_COMMAND} -E copy
                         ${REGRESSION_SOURCE_FILE}
@@ -53,7 +58,7 @@ macro(create_regression)
     foreach(REGRESSION_TEST IN LISTS REGRESSION_TESTS)
         get_filename_component(REGRESSION_TEST_NAME "${REGRESSION_TEST}" NAME)
 
-        if("${REGRESSION_TEST_NAME}" STREQUAL "regression.cfg")
+        if("${REGRESSION_TEST_NAME}" STREQUAL "regression.cfg" OR "${REGRESSION_TEST_NAME}" STREQUAL "perf")
             continue()
         endif()
 
@@ -83,4 +88,44 @@ macro(create_regression)
     # Create a new target which runs the regression
     add_custom_target(regression
             DEPENDS ${REGRESSION_TARGETS})
+
+    # Find all the performance regression tests, and create targets to run
+    # them and to update their baseline. These are not part of 'ctest', as
+    # the baseline only applies to the machine it was recorded on.
+    file(GLOB PERF_TESTS ${CMAKE_SOURCE_DIR}/regression/perf/*/test.sav)
+    foreach(PERF_TEST IN LISTS PERF_TESTS)
+        get_filename_component(PERF_TEST_DIR "${PERF_TEST}" DIRECTORY)
+        get_filename_component(PERF_TEST_NAME "${PERF_TEST_DIR}" NAME)
+
+        add_custom_target(regression_perf_${PERF_TEST_NAME}
+                COMMAND ${CMAKE_COMMAND}
+                        -DOPENTTD_EXECUTABLE=$<TARGET_FILE:openttd>
+                        -DEDITBIN_EXECUTABLE=${EDITBIN_EXECUTABLE}
+                        -DPERF_TEST=${PERF_TEST_NAME}
+                        -DPERF_BASELINE=${PERF_TEST_DIR}/baseline.txt
+                        -P "${CMAKE_SOURCE_DIR}/cmake/scripts/PerfRegression.cmake"
+                DEPENDS openttd regression_files
+                WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+                COMMENT "Running performance regression test ${PERF_TEST_NAME}"
+                )
+
+        add_custom_target(regression_perf_update_${PERF_TEST_NAME}
+                COMMAND ${CMAKE_COMMAND}
+                        -DOPENTTD_EXECUTABLE=$<TARGET_FILE:openttd>
+                        -DEDITBIN_EXECUTABLE=${EDITBIN_EXECUTABLE}
+                        -DPERF_TEST=${PERF_TEST_NAME}
+                        -DPERF_BASELINE=${PERF_TEST_DIR}/baseline.txt
+                        -DPERF_UPDATE_BASELINE=ON
+                        -P "${CMAKE_SOURCE_DIR}/cmake/scripts/PerfRegression.cmake"
+                DEPENDS openttd regression_files
+                WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+                COMMENT "Updating performance baseline of ${PERF_TEST_NAME}"
+                )
+
+        list(APPEND PERF_TARGETS regression_perf_${PERF_TEST_NAME})
+    endforeach()
+
+    # Create a new target which runs the performance regression
+    add_custom_target(regression_perf
+            DEPENDS ${PERF_TARGETS})
 endmacro()
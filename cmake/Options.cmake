@@ -67,6 +67,7 @@ function(set_options)
     option(OPTION_USE_NSIS "Use NSIS to create windows installer; enable only for stable releases" OFF)
     option(OPTION_TOOLS_ONLY "Build only tools target" OFF)
     option(OPTION_DOCS_ONLY "Build only docs target" OFF)
+    option(OPTION_REPLAY_COMMANDS "Replay commands.log from the save folder at startup, for desync and performance debugging only" OFF)
 
     if (OPTION_DOCS_ONLY)
         set(OPTION_TOOLS_ONLY ON PARENT_SCOPE)
@@ -84,6 +85,7 @@ function(show_options)
     message(STATUS "Option Use assert - ${OPTION_USE_ASSERTS}")
     message(STATUS "Option Use threads - ${OPTION_USE_THREADS}")
     message(STATUS "Option Use NSIS - ${OPTION_USE_NSIS}")
+    message(STATUS "Option Replay commands - ${OPTION_REPLAY_COMMANDS}")
 endfunction()
 
 # Add the definitions for the options that are selected.
@@ -104,4 +106,8 @@ function(add_definitions_based_on_options)
     else()
         add_definitions(-DNDEBUG)
     endif()
+
+    if(OPTION_REPLAY_COMMANDS)
+        add_definitions(-DDEBUG_DUMP_COMMANDS)
+    endif()
 endfunction()
@@ -0,0 +1,169 @@
+cmake_minimum_required(VERSION 3.5)
+
+#
+# Runs a single performance regression test
+#
+# The savegame perf/${PERF_TEST}/test.sav is run for a fixed number of ticks
+# with the benchmark mode of the null video driver. The mean duration of each
+# performance element and the resident memory are compared against
+# ${PERF_BASELINE}, which consists of lines in the format "<key> <value>":
+#
+#   ticks <number of ticks to run>
+#   tolerance_percent <allowed relative increase>
+#   tolerance_ms <allowed absolute increase of a mean duration>
+#   memory_tolerance_percent <allowed relative increase of the memory>
+#   memory <resident memory after the run, in bytes>
+#   <element> <mean duration of a measurement of the element, in ms>
+#
+# With -DPERF_UPDATE_BASELINE=ON the measured values are written to the
+# baseline instead, keeping the ticks and tolerances.
+#
+
+if(NOT PERF_TEST)
+    message(FATAL_ERROR "Script needs PERF_TEST defined (tip: use -DPERF_TEST=..)")
+endif()
+if(NOT OPENTTD_EXECUTABLE)
+    message(FATAL_ERROR "Script needs OPENTTD_EXECUTABLE defined (tip: use -DOPENTTD_EXECUTABLE=..)")
+endif()
+if(NOT PERF_BASELINE)
+    message(FATAL_ERROR "Script needs PERF_BASELINE defined (tip: use -DPERF_BASELINE=..)")
+endif()
+
+if(NOT EXISTS perf/${PERF_TEST}/test.sav)
+    message(FATAL_ERROR "Performance regression test ${PERF_TEST} does not exist (tip: check regression/perf folder for the correct spelling)")
+endif()
+
+# Convert a decimal number with up to 4 decimals to an integer in units of 1/10000.
+function(perf_to_int VALUE OUTPUT)
+    if(NOT VALUE MATCHES "^([0-9]+)(\\.([0-9]*))?$")
+        message(FATAL_ERROR "Invalid number: ${VALUE}")
+    endif()
+    set(WHOLE "${CMAKE_MATCH_1}")
+    string(SUBSTRING "${CMAKE_MATCH_3}0000" 0 4 FRACTION)
+    # Prefix the fraction with a 1, so leading zeros are not a problem.
+    math(EXPR RESULT "${WHOLE} * 10000 + 1${FRACTION} - 10000")
+    set(${OUTPUT} ${RESULT} PARENT_SCOPE)
+endfunction()
+
+# Read the baseline
+set(TICKS 3000)
+set(TOLERANCE_PERCENT 25)
+set(TOLERANCE_MS 0.01)
+set(MEMORY_TOLERANCE_PERCENT 10)
+set(BASELINE_ELEMENTS "")
+if(EXISTS ${PERF_BASELINE})
+    file(STRINGS ${PERF_BASELINE} BASELINE_LINES)
+    foreach(LINE IN LISTS BASELINE_LINES)
+        if(LINE MATCHES "^#" OR NOT LINE MATCHES "^([a-z0-9_]+) +([0-9.]+)$")
+            continue()
+        endif()
+        set(KEY "${CMAKE_MATCH_1}")
+        set(VALUE "${CMAKE_MATCH_2}")
+        if(KEY STREQUAL "ticks")
+            set(TICKS ${VALUE})
+        elseif(KEY STREQUAL "tolerance_percent")
+            set(TOLERANCE_PERCENT ${VALUE})
+        elseif(KEY STREQUAL "tolerance_ms")
+            set(TOLERANCE_MS ${VALUE})
+        elseif(KEY STREQUAL "memory_tolerance_percent")
+            set(MEMORY_TOLERANCE_PERCENT ${VALUE})
+        elseif(KEY STREQUAL "memory")
+            set(BASELINE_MEMORY ${VALUE})
+        else()
+            list(APPEND BASELINE_ELEMENTS ${KEY})
+            set(BASELINE_${KEY} ${VALUE})
+        endif()
+    endforeach()
+elseif(NOT PERF_UPDATE_BASELINE)
+    message(FATAL_ERROR "No baseline for ${PERF_TEST} (tip: create one with the regression_perf_update_${PERF_TEST} target)")
+endif()
+
+# If editbin is given, copy the executable to a new folder, and change the
+# subsystem to console. The copy is needed as multiple regressions can run
+# at the same time.
+if(EDITBIN_EXECUTABLE)
+    execute_process(COMMAND ${CMAKE_COMMAND} -E copy ${OPENTTD_EXECUTABLE} regression_perf_${PERF_TEST}.exe)
+    set(OPENTTD_EXECUTABLE "regression_perf_${PERF_TEST}.exe")
+
+    execute_process(COMMAND ${EDITBIN_EXECUTABLE} /nologo /subsystem:console ${OPENTTD_EXECUTABLE})
+endif()
+
+# Run the savegame
+set(PERF_RESULT_FILE "${CMAKE_CURRENT_BINARY_DIR}/regression_perf_${PERF_TEST}.json")
+file(REMOVE ${PERF_RESULT_FILE})
+execute_process(COMMAND ${OPENTTD_EXECUTABLE}
+                        -x
+                        -c perf/perf.cfg
+                        -g perf/${PERF_TEST}/test.sav
+                        -snull
+                        -mnull
+                        -vnull:ticks=${TICKS},benchmark=${PERF_RESULT_FILE}
+                        -Q
+                RESULT_VARIABLE PERF_EXIT_CODE
+                OUTPUT_QUIET
+                ERROR_QUIET
+)
+
+if(NOT PERF_EXIT_CODE EQUAL 0 OR NOT EXISTS ${PERF_RESULT_FILE})
+    message(FATAL_ERROR "Performance regression ${PERF_TEST} did not produce a result; did the compilation fail?")
+endif()
+
+# Extract the measurements; the benchmark report has one element per line.
+# Only read the lines of interest, as CMake lists do not split inside brackets.
+file(STRINGS ${PERF_RESULT_FILE} RESULT_LINES REGEX "\"(element|resident_memory_after_run)\"")
+set(RESULT_ELEMENTS "")
+foreach(LINE IN LISTS RESULT_LINES)
+    if(LINE MATCHES "\"element\": \"([a-z0-9_]+)\".*\"mean_ms\": ([0-9.]+)")
+        list(APPEND RESULT_ELEMENTS ${CMAKE_MATCH_1})
+        set(RESULT_${CMAKE_MATCH_1} ${CMAKE_MATCH_2})
+    elseif(LINE MATCHES "\"resident_memory_after_run\": (-?[0-9]+)")
+        set(RESULT_MEMORY ${CMAKE_MATCH_1})
+    endif()
+endforeach()
+
+if(PERF_UPDATE_BASELINE)
+    set(BASELINE "# Performance baseline of ${PERF_TEST}, see cmake/scripts/PerfRegression.cmake\n")
+    string(APPEND BASELINE "ticks ${TICKS}\n")
+    string(APPEND BASELINE "tolerance_percent ${TOLERANCE_PERCENT}\n")
+    string(APPEND BASELINE "tolerance_ms ${TOLERANCE_MS}\n")
+    string(APPEND BASELINE "memory_tolerance_percent ${MEMORY_TOLERANCE_PERCENT}\n")
+    if(RESULT_MEMORY AND NOT RESULT_MEMORY LESS 0)
+        string(APPEND BASELINE "memory ${RESULT_MEMORY}\n")
+    endif()
+    foreach(ELEMENT IN LISTS RESULT_ELEMENTS)
+        string(APPEND BASELINE "${ELEMENT} ${RESULT_${ELEMENT}}\n")
+    endforeach()
+    file(WRITE ${PERF_BASELINE} "${BASELINE}")
+    message("Baseline of ${PERF_TEST} written to ${PERF_BASELINE}")
+    return()
+endif()
+
+# Compare the measurements
+set(ERROR NO)
+perf_to_int(${TOLERANCE_MS} TOLERANCE_INT)
+foreach(ELEMENT IN LISTS BASELINE_ELEMENTS)
+    if(NOT DEFINED RESULT_${ELEMENT})
+        message("${ELEMENT}: not measured")
+        set(ERROR YES)
+        continue()
+    endif()
+    perf_to_int(${BASELINE_${ELEMENT}} EXPECTED_INT)
+    perf_to_int(${RESULT_${ELEMENT}} RESULT_INT)
+    math(EXPR LIMIT_INT "${EXPECTED_INT} * (100 + ${TOLERANCE_PERCENT}) / 100 + ${TOLERANCE_INT}")
+    if(RESULT_INT GREATER LIMIT_INT)
+        message("${ELEMENT}: ${RESULT_${ELEMENT}} ms, baseline ${BASELINE_${ELEMENT}} ms")
+        set(ERROR YES)
+    endif()
+endforeach()
+
+if(BASELINE_MEMORY AND RESULT_MEMORY AND NOT RESULT_MEMORY LESS 0)
+    math(EXPR MEMORY_LIMIT "${BASELINE_MEMORY} / 100 * (100 + ${MEMORY_TOLERANCE_PERCENT})")
+    if(RESULT_MEMORY GREATER MEMORY_LIMIT)
+        message("memory: ${RESULT_MEMORY} bytes, baseline ${BASELINE_MEMORY} bytes")
+        set(ERROR YES)
+    endif()
+endif()
+
+if(ERROR)
+    message(FATAL_ERROR "Performance regression failed - Measurements in ${PERF_RESULT_FILE}")
+endif()
@@ -76,18 +76,26 @@
 	/* The speed with which AIs go, is limited by the 'competitor_speed' */
 	AI::frame_counter++;
 	assert(_settings_game.difficulty.competitor_speed <= 4);
-	if ((AI::frame_counter & ((1 << (4 - _settings_game.difficulty.competitor_speed)) - 1)) != 0) return;
+	const uint interval_mask = (1 << (4 - _settings_game.difficulty.competitor_speed)) - 1;
+
+	/* When staggered, each AI runs at the same rate but on a tick offset by its company index,
+	 * so the AIs are spread over the interval instead of all running on the same tick. */
+	const bool stagger = _settings_client.perf.stagger_ai_ticks && interval_mask != 0;
+	if (!stagger && (AI::frame_counter & interval_mask) != 0) return;
 
 	Backup<CompanyID> cur_company(_current_company, FILE_LINE);
 	for (const Company *c : Company::Iterate()) {
 		if (c->is_ai) {
+			const uint frame = stagger ? AI::frame_counter + c->index : AI::frame_counter;
+			if ((frame & interval_mask) != 0) continue;
+
 			SCOPE_INFO_FMT([&], "AI::GameLoop: %i: %s (v%d)\n", (int)c->index, c->ai_info->GetName(), c->ai_info->GetVersion());
 			PerformanceMeasurer framerate((PerformanceElement)(PFE_AI0 + c->index));
 			cur_company.Change(c->index);
 			c->ai_instance->GameLoop();
 			/* Occasionally collect garbage; every 255 ticks do one company.
 			 * Effectively collecting garbage once every two months per AI. */
-			if ((AI::frame_counter & 255) == 0 && (CompanyID)GB(AI::frame_counter, 8, 4) == c->index) {
+			if ((frame & 255) == 0 && (CompanyID)GB(frame, 8, 4) == c->index) {
 				c->ai_instance->CollectGarbage();
 			}
 		} else {
@@ -127,6 +127,14 @@ AirportFTAClass::AirportFTAClass(
 {
 	/* Build the state machine itself */
 	this->layout = AirportBuildAutomata(this->nofelements, apFA);
+
+	/* Flatten it into a table of the moves for each position and heading, so aircraft do not need to walk the lists when moving */
+	this->transitions = MallocT<AirportTransition>(this->nofelements * (MAX_HEADINGS + 1));
+	for (uint position = 0; position < this->nofelements; position++) {
+		for (uint heading = 0; heading <= MAX_HEADINGS; heading++) {
+			this->transitions[position * (MAX_HEADINGS + 1) + heading] = this->ComputeTransition(position, heading);
+		}
+	}
 }
 
 AirportFTAClass::~AirportFTAClass()
@@ -140,6 +148,56 @@ AirportFTAClass::~AirportFTAClass()
 		}
 	}
 	free(layout);
+	free(transitions);
+}
+
+/**
+ * Determine the move of an aircraft from a position for its heading, by walking the state machine.
+ * If there is only one choice at the position it is taken, otherwise the first one matching the heading, or for all headings.
+ * @param position Element number the aircraft is at.
+ * @param heading Current heading (state) of the aircraft.
+ * @return The move to make.
+ */
+AirportTransition AirportFTAClass::ComputeTransition(byte position, byte heading) const
+{
+	AirportTransition transition = { 0, (byte)MAX_ELEMENTS, false, false };
+
+	const AirportFTA *reference = &this->layout[position];
+	const AirportFTA *current_pos = reference;
+	if (current_pos->next != nullptr) {
+		while (current_pos != nullptr && current_pos->heading != heading && current_pos->heading != TO_ALL) {
+			current_pos = current_pos->next;
+		}
+		if (current_pos == nullptr) return transition;
+	}
+
+	const AirportFTA *next = &this->layout[current_pos->next_position];
+	transition.next_position = current_pos->next_position;
+
+	/* if the next position is in another block, it has to be checked and the aircraft waits until it is free */
+	if ((reference->block & next->block) != next->block) {
+		uint64 airport_flags = next->block;
+		/* search for all all elements in the list with the same state, and blocks != N
+		 * this means more blocks should be checked/set */
+		const AirportFTA *current = current_pos;
+		if (current == reference) current = current->next;
+		while (current != nullptr) {
+			if (current->heading == current_pos->heading && current->block != 0) {
+				airport_flags |= current->block;
+				break;
+			}
+			current = current->next;
+		}
+
+		/* if the block to be checked is in the next position, then exclude that from
+		 * checking, because it has been set by the airplane before */
+		if (current_pos->block == next->block) airport_flags ^= next->block;
+
+		transition.block_mask = airport_flags;
+		transition.check_blocks = true;
+		transition.set_blocks = (next->block != NOTHING_block);
+	}
+	return transition;
 }
 
 /**
@@ -139,6 +139,14 @@ AirportMovingData RotateAirportMovingData(const AirportMovingData *orig, Directi
 
 struct AirportFTAbuildup;
 
+/** Precomputed move of an aircraft from a position of an airport, for the heading of the aircraft. */
+struct AirportTransition {
+	uint64 block_mask;  ///< Blocks which must be free before moving, and which are occupied when moving.
+	byte next_position; ///< Position to move to, #MAX_ELEMENTS if there is no move for the heading.
+	bool check_blocks;  ///< Whether the next position is in another block, so the blocks have to be checked.
+	bool set_blocks;    ///< Whether the blocks are occupied when moving, i.e. the next position has a block.
+};
+
 /** Finite sTate mAchine (FTA) of an airport. */
 struct AirportFTAClass {
 public:
@@ -173,8 +181,24 @@ public:
 		return &moving_data[position];
 	}
 
+	/**
+	 * Get the move of an aircraft from a position for its heading.
+	 * @param position Element number the aircraft is at.
+	 * @param heading Current heading (state) of the aircraft.
+	 * @return The move to make.
+	 */
+	AirportTransition GetTransition(byte position, byte heading) const
+	{
+		assert(position < nofelements);
+		if (heading > MAX_HEADINGS) return this->ComputeTransition(position, heading);
+		return this->transitions[position * (MAX_HEADINGS + 1) + heading];
+	}
+
+	AirportTransition ComputeTransition(byte position, byte heading) const;
+
 	const AirportMovingData *moving_data; ///< Movement data.
 	struct AirportFTA *layout;            ///< state machine for airport
+	AirportTransition *transitions;       ///< moves for each position and heading up to #MAX_HEADINGS, see #GetTransition
 	const byte *terminals;                ///< %Array with the number of terminal groups, followed by the number of terminals in each group.
 	const byte num_helipads;              ///< Number of helipads on this airport. When 0 helicopters will go to normal terminals.
 	Flags flags;                          ///< Flags for this airport type.
@@ -22,6 +22,13 @@
 /** The table/list with animated tiles. */
 btree::btree_map<TileIndex, AnimatedTileInfo> _animated_tiles;
 
+/**
+ * Lower bound of the animation speed of all animated tiles which are not pending deletion.
+ * Ticks where no tile can be due are skipped without walking the table.
+ * This is exact after each full pass over the table, and lowered whenever a tile is added.
+ */
+static uint8 _animated_tiles_min_speed = 0;
+
 /**
  * Removes the given tile from the animated tile table.
  * @param tile the tile to remove
@@ -76,6 +83,7 @@ void AddAnimatedTile(TileIndex tile, bool mark_dirty)
 	AnimatedTileInfo &info = _animated_tiles[tile];
 	UpdateAnimatedTileSpeed(tile, info);
 	info.pending_deletion = false;
+	_animated_tiles_min_speed = std::min(_animated_tiles_min_speed, info.speed);
 }
 
 int GetAnimatedTileSpeed(TileIndex tile)
@@ -98,10 +106,17 @@ void AnimateAnimatedTiles()
 	extern void AnimateTile_Object(TileIndex tile);
 
 	PerformanceAccumulator framerate(PFE_GL_LANDSCAPE);
+	PerformanceAccumulator framerate_animation(PFE_GL_ANIMATION);
 
 	const uint32 ticks = (uint) _scaled_tick_counter;
 	const uint8 max_speed = (ticks == 0) ? 32 : FindFirstBit(ticks);
 
+	/* No tile is due this tick, pending deletions are left for the next full pass. */
+	if (max_speed < _animated_tiles_min_speed) return;
+
+	/* Recompute the bound during this pass, tiles added meanwhile lower it as usual. */
+	_animated_tiles_min_speed = UINT8_MAX;
+	uint8 min_speed = UINT8_MAX;
 	auto iter = _animated_tiles.begin();
 	while (iter != _animated_tiles.end()) {
 		if (iter->second.pending_deletion) {
@@ -109,6 +124,8 @@ void AnimateAnimatedTiles()
 			continue;
 		}
 
+		min_speed = std::min(min_speed, iter->second.speed);
+
 		if (iter->second.speed <= max_speed) {
 			const TileIndex curr = iter->first;
 			switch (GetTileType(curr)) {
@@ -134,10 +151,13 @@ void AnimateAnimatedTiles()
 		}
 		++iter;
 	}
+
+	_animated_tiles_min_speed = std::min(_animated_tiles_min_speed, min_speed);
 }
 
 void UpdateAllAnimatedTileSpeeds()
 {
+	_animated_tiles_min_speed = UINT8_MAX;
 	auto iter = _animated_tiles.begin();
 	while (iter != _animated_tiles.end()) {
 		if (iter->second.pending_deletion) {
@@ -145,6 +165,7 @@ void UpdateAllAnimatedTileSpeeds()
 			continue;
 		}
 		UpdateAnimatedTileSpeed(iter->first, iter->second);
+		_animated_tiles_min_speed = std::min(_animated_tiles_min_speed, iter->second.speed);
 		++iter;
 	}
 }
@@ -155,4 +176,5 @@ void UpdateAllAnimatedTileSpeeds()
 void InitializeAnimatedTiles()
 {
 	_animated_tiles.clear();
+	_animated_tiles_min_speed = 0;
 }
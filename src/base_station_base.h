@@ -91,6 +91,9 @@ struct BaseStation : StationPool::PoolItem<&_station_pool> {
 	TileArea train_station;         ///< Tile area the train 'station' part covers
 	StationRect rect;               ///< NOSAVE: Station spread out rectangle maintained by StationRect::xxx() functions
 
+	mutable std::vector<TileIndex> cached_rail_station_tiles; ///< NOSAVE: Tiles of train_station which belong to this station, in ascending order, see GetRailStationTiles
+	mutable bool cached_rail_station_tiles_valid = false;     ///< NOSAVE: Whether cached_rail_station_tiles is valid
+
 	std::vector<RoadStopTileData> custom_roadstop_tile_data; ///< List of custom road stop tile data
 
 	/**
@@ -112,6 +115,17 @@ struct BaseStation : StationPool::PoolItem<&_station_pool> {
 	 */
 	virtual bool TileBelongsToRailStation(TileIndex tile) const = 0;
 
+	const std::vector<TileIndex> &GetRailStationTiles() const;
+
+	/**
+	 * Invalidate the cached list of rail station tiles, this must be called whenever a rail station tile is added to or removed from this station.
+	 */
+	inline void InvalidateRailStationTiles()
+	{
+		this->cached_rail_station_tiles_valid = false;
+		this->cached_rail_station_tiles.clear();
+	}
+
 	/**
 	 * Helper function to get a NewGRF variable that isn't implemented by the base class.
 	 * @param object the resolver object related to this query
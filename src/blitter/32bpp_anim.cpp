@@ -311,6 +311,8 @@ void Blitter_32bppAnim::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomL
 		return;
 	}
 
+	this->MarkAnimRows(bp->dst, bp->top, bp->height);
+
 	const BlitterSpriteFlags sprite_flags = ((const SpriteData *) bp->sprite)->flags;
 
 	switch (mode) {
@@ -397,6 +399,7 @@ void Blitter_32bppAnim::SetPixel(void *video, int x, int y, uint8 colour)
 	/* Set the colour in the anim-buffer too, if we are rendering to the screen */
 	if (_screen_disable_anim) return;
 	this->anim_buf[this->ScreenToAnimOffset((uint32 *)video) + x + y * this->anim_buf_pitch] = colour | (DEFAULT_BRIGHTNESS << 8);
+	this->MarkAnimRows(video, y, 1);
 }
 
 void Blitter_32bppAnim::SetPixel32(void *video, int x, int y, uint8 colour, uint32 colour32)
@@ -419,10 +422,15 @@ void Blitter_32bppAnim::DrawLine(void *video, int x, int y, int x2, int y2, int
 	} else {
 		uint16 * const offset_anim_buf = this->anim_buf + this->ScreenToAnimOffset((uint32 *)video);
 		const uint16 anim_colour = colour | (DEFAULT_BRIGHTNESS << 8);
+		int min_y = INT_MAX;
+		int max_y = INT_MIN;
 		this->DrawLineGeneric(x, y, x2, y2, screen_width, screen_height, width, dash, [&](int x, int y) {
 			*((Colour *)video + x + y * _screen.pitch) = c;
 			offset_anim_buf[x + y * this->anim_buf_pitch] = anim_colour;
+			min_y = std::min(min_y, y);
+			max_y = std::max(max_y, y);
 		});
+		if (min_y <= max_y) this->MarkAnimRows(video, min_y, max_y - min_y + 1);
 	}
 }
 
@@ -442,6 +450,7 @@ void Blitter_32bppAnim::SetRect(void *video, int x, int y, const uint8 *colours,
 			colours += pitch - width;
 		} while (--lines);
 	} else {
+		this->MarkAnimRows(video, y, lines);
 		uint16 *dstanim = (uint16 *)(&this->anim_buf[this->ScreenToAnimOffset((uint32 *)video) + x + y * this->anim_buf_pitch]);
 		do {
 			uint w = width;
@@ -491,6 +500,7 @@ void Blitter_32bppAnim::DrawRect(void *video, int width, int height, uint8 colou
 
 	Colour colour32 = LookupColourInPalette(colour);
 	uint16 *anim_line = this->ScreenToAnimOffset((uint32 *)video) + this->anim_buf;
+	if (colour >= PALETTE_ANIM_START) this->MarkAnimRows(video, 0, height);
 
 	do {
 		Colour *dst = (Colour *)video;
@@ -520,6 +530,7 @@ void Blitter_32bppAnim::CopyFromBuffer(void *video, const void *src, int width,
 	Colour *dst = (Colour *)video;
 	const uint32 *usrc = (const uint32 *)src;
 	uint16 *anim_line = this->ScreenToAnimOffset((uint32 *)video) + this->anim_buf;
+	this->MarkAnimRows(video, 0, height);
 
 	for (; height > 0; height--) {
 		/* We need to keep those for palette animation. */
@@ -581,6 +592,9 @@ void Blitter_32bppAnim::ScrollBuffer(void *video, int left, int top, int width,
 	assert(video >= _screen.dst_ptr && video <= (uint32 *)_screen.dst_ptr + _screen.width + _screen.height * _screen.pitch);
 	uint16 *dst, *src;
 
+	/* Animated pixels may be scrolled into any row of the area */
+	this->MarkAnimRows(_screen.dst_ptr, top, height);
+
 	/* We need to scroll the anim-buffer too */
 	if (scroll_y > 0) {
 		dst = this->anim_buf + left + (top + height - 1) * this->anim_buf_pitch;
@@ -641,30 +655,46 @@ void Blitter_32bppAnim::PaletteAnimate(const Palette &palette)
 	 *  Especially when going between toyland and non-toyland. */
 	assert(this->palette.first_dirty == PALETTE_ANIM_START || this->palette.first_dirty == 0);
 
-	const uint16 *anim = this->anim_buf;
-	Colour *dst = (Colour *)_screen.dst_ptr;
+	int first_row = INT_MAX;
+	int last_row = INT_MIN;
 
-	/* Let's walk the anim buffer and try to find the pixels */
+	/* Let's walk the anim buffer and try to find the pixels, skipping rows which cannot contain any */
 	const int width = this->anim_buf_width;
-	const int pitch_offset = _screen.pitch - width;
-	const int anim_pitch_offset = this->anim_buf_pitch - width;
-	for (int y = this->anim_buf_height; y != 0 ; y--) {
+	for (int y = 0; y < this->anim_buf_height; y++) {
+		if (!this->anim_rows[y]) continue;
+
+		const uint16 *anim = this->anim_buf + y * this->anim_buf_pitch;
+		Colour *dst = (Colour *)_screen.dst_ptr + y * _screen.pitch;
+		bool row_animated = false;
 		for (int x = width; x != 0 ; x--) {
 			uint16 value = *anim;
 			uint8 colour = GB(value, 0, 8);
 			if (colour >= PALETTE_ANIM_START) {
 				/* Update this pixel */
 				*dst = this->AdjustBrightness(LookupColourInPalette(colour), GB(value, 8, 8));
+				row_animated = true;
 			}
 			dst++;
 			anim++;
 		}
-		dst += pitch_offset;
-		anim += anim_pitch_offset;
+
+		if (row_animated) {
+			first_row = std::min(first_row, y);
+			last_row = y;
+		} else {
+			this->anim_rows[y] = false;
+		}
 	}
 
-	/* Make sure the backend redraws the whole screen */
-	VideoDriver::GetInstance()->MakeDirty(0, 0, _screen.width, _screen.height);
+	this->MakePaletteAnimatedRowsDirty(first_row, last_row);
+}
+
+void Blitter_32bppAnim::MakePaletteAnimatedRowsDirty(int first_row, int last_row)
+{
+	if (first_row > last_row) return;
+
+	/* Make sure the backend redraws the animated part of the screen */
+	VideoDriver::GetInstance()->MakeDirty(0, first_row, _screen.width, last_row - first_row + 1);
 }
 
 Blitter::PaletteAnimation Blitter_32bppAnim::UsePaletteAnimation()
@@ -684,5 +714,8 @@ void Blitter_32bppAnim::PostResize()
 
 		/* align buffer to next 16 byte boundary */
 		this->anim_buf = reinterpret_cast<uint16 *>((reinterpret_cast<uintptr_t>(this->anim_alloc) + 0xF) & (~0xF));
+
+		/* The new buffer is all zero, so no row contains animated pixels */
+		this->anim_rows.assign(this->anim_buf_height, false);
 	}
 }
@@ -21,6 +21,7 @@ protected:
 	int anim_buf_pitch;  ///< The pitch of the animation buffer (width rounded up to 16 byte boundary).
 	int anim_buf_height; ///< The height of the animation buffer.
 	Palette palette;     ///< The current palette.
+	std::vector<bool> anim_rows; ///< Per row of the animation buffer, whether it may contain animated palette indices. Rows without are skipped by PaletteAnimate.
 
 public:
 	Blitter_32bppAnim() :
@@ -72,6 +73,29 @@ public:
 		return across + (lines * this->anim_buf_pitch);
 	}
 
+	/**
+	 * Mark rows of the animation buffer as possibly containing animated palette indices.
+	 * This must be called for every write to the animation buffer which may store an animated colour.
+	 * @param video Pointer into the screen buffer, the row of which the rows are relative to.
+	 * @param y First row, relative to \a video.
+	 * @param count Number of rows.
+	 */
+	inline void MarkAnimRows(const void *video, int y, int count)
+	{
+		int first = ((const uint32 *)video - (const uint32 *)_screen.dst_ptr) / _screen.pitch + y;
+		int last = std::min<int>(first + count, (int)this->anim_rows.size());
+		for (int row = std::max<int>(first, 0); row < last; row++) {
+			this->anim_rows[row] = true;
+		}
+	}
+
+	/**
+	 * Mark the screen rows which were changed by a palette animation step dirty in the video driver.
+	 * @param first_row First changed row.
+	 * @param last_row Last changed row, or less than \a first_row if none were changed.
+	 */
+	void MakePaletteAnimatedRowsDirty(int first_row, int last_row);
+
 	template <BlitterMode mode, bool no_anim_translucent> void Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom);
 };
 
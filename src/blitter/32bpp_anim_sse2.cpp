@@ -30,21 +30,20 @@ void Blitter_32bppSSE2_Anim::PaletteAnimate(const Palette &palette)
 	 *  Especially when going between toyland and non-toyland. */
 	assert(this->palette.first_dirty == PALETTE_ANIM_START || this->palette.first_dirty == 0);
 
-	const uint16 *anim = this->anim_buf;
-	Colour *dst = (Colour *)_screen.dst_ptr;
+	int first_row = INT_MAX;
+	int last_row = INT_MIN;
 
-	bool screen_dirty = false;
-
-	/* Let's walk the anim buffer and try to find the pixels */
+	/* Let's walk the anim buffer and try to find the pixels, skipping rows which cannot contain any */
 	const int width = this->anim_buf_width;
-	const int screen_pitch = _screen.pitch;
-	const int anim_pitch = this->anim_buf_pitch;
 	__m128i anim_cmp = _mm_set1_epi16(PALETTE_ANIM_START - 1);
 	__m128i brightness_cmp = _mm_set1_epi16(Blitter_32bppBase::DEFAULT_BRIGHTNESS);
 	__m128i colour_mask = _mm_set1_epi16(0xFF);
-	for (int y = this->anim_buf_height; y != 0 ; y--) {
-		Colour *next_dst_ln = dst + screen_pitch;
-		const uint16 *next_anim_ln = anim + anim_pitch;
+	for (int y = 0; y < this->anim_buf_height; y++) {
+		if (!this->anim_rows[y]) continue;
+
+		const uint16 *anim = this->anim_buf + y * this->anim_buf_pitch;
+		Colour *dst = (Colour *)_screen.dst_ptr + y * _screen.pitch;
+		bool row_animated = false;
 		int x = width;
 		while (x > 0) {
 			__m128i data = _mm_load_si128((const __m128i *) anim);
@@ -65,7 +64,7 @@ void Blitter_32bppSSE2_Anim::PaletteAnimate(const Palette &palette)
 						if (colour >= PALETTE_ANIM_START) {
 							/* Update this pixel */
 							*dst = AdjustBrightneSSE(LookupColourInPalette(colour), GB(value, 8, 8));
-							screen_dirty = true;
+							row_animated = true;
 						}
 						data = _mm_srli_si128(data, 2);
 						dst++;
@@ -77,7 +76,7 @@ void Blitter_32bppSSE2_Anim::PaletteAnimate(const Palette &palette)
 						colour_data = _mm_srli_si128(colour_data, 2);
 						dst++;
 					}
-					screen_dirty = true;
+					row_animated = true;
 				}
 			} else {
 				/* fast path, no animation */
@@ -86,14 +85,16 @@ void Blitter_32bppSSE2_Anim::PaletteAnimate(const Palette &palette)
 			anim += 8;
 			x -= 8;
 		}
-		dst = next_dst_ln;
-		anim = next_anim_ln;
-	}
 
-	if (screen_dirty) {
-		/* Make sure the backend redraws the whole screen */
-		VideoDriver::GetInstance()->MakeDirty(0, 0, _screen.width, _screen.height);
+		if (row_animated) {
+			first_row = std::min(first_row, y);
+			last_row = y;
+		} else {
+			this->anim_rows[y] = false;
+		}
 	}
+
+	this->MakePaletteAnimatedRowsDirty(first_row, last_row);
 }
 
 #endif /* WITH_SSE */
@@ -443,6 +443,8 @@ void Blitter_32bppSSE4_Anim::Draw(Blitter::BlitterParams *bp, BlitterMode mode,
 		return;
 	}
 
+	this->MarkAnimRows(bp->dst, bp->top, bp->height);
+
 	const BlitterSpriteFlags sprite_flags = ((const Blitter_32bppSSE_Base::SpriteData *) bp->sprite)->flags;
 	switch (mode) {
 		default: {
@@ -109,6 +109,48 @@ static inline __m128i DarkenTwoPixels(__m128i src, __m128i dst, const __m128i &d
 	return _mm_packus_epi16(dstAB, dstAB);
 }
 
+#if (SSE_VERSION >= 5)
+/* Same as AlphaBlendTwoPixels(), but for 4 pixels: each 128 bit lane holds 2 pixels expanded to uint16.
+ * The masks are the 128 bit masks broadcasted to both lanes.
+ */
+GNU_TARGET(SSE_TARGET)
+static inline __m128i AlphaBlendFourPixels(__m128i src, __m128i dst, const __m256i &distribution_mask, const __m256i &pack_mask, const __m256i &alpha_mask)
+{
+	__m256i srcAB = _mm256_cvtepu8_epi16(src);  // VPMOVZXBW, expand each uint8 into uint16
+	__m256i dstAB = _mm256_cvtepu8_epi16(dst);
+
+	__m256i alphaMaskAB = _mm256_cmpgt_epi16(srcAB, _mm256_setzero_si256()); // (alpha > 0) ? 0xFFFF : 0
+	__m256i alphaAB = _mm256_sub_epi16(srcAB, alphaMaskAB);                  // if (alpha > 0) a++;
+	alphaAB = _mm256_shuffle_epi8(alphaAB, distribution_mask);
+
+	srcAB = _mm256_sub_epi16(srcAB, dstAB);     // (r - Cr)
+	srcAB = _mm256_mullo_epi16(srcAB, alphaAB); // a*(r - Cr)
+	srcAB = _mm256_srli_epi16(srcAB, 8);        // a*(r - Cr)/256
+	srcAB = _mm256_add_epi16(srcAB, dstAB);     // a*(r - Cr)/256 + Cr
+
+	alphaMaskAB = _mm256_and_si256(alphaMaskAB, alpha_mask); // set non alpha fields to 0
+	srcAB = _mm256_or_si256(srcAB, alphaMaskAB);             // set alpha fields to 0xFFFF is src alpha was > 0
+
+	srcAB = _mm256_shuffle_epi8(srcAB, pack_mask);                        // pack each lane into its low 64 bits
+	return _mm256_castsi256_si128(_mm256_permute4x64_epi64(srcAB, 0x08)); // join the low 64 bits of both lanes
+}
+
+/* Same as DarkenTwoPixels(), but for 4 pixels. */
+GNU_TARGET(SSE_TARGET)
+static inline __m128i DarkenFourPixels(__m128i src, __m128i dst, const __m256i &distribution_mask, const __m256i &tr_nom_base)
+{
+	__m256i srcAB = _mm256_cvtepu8_epi16(src);
+	__m256i dstAB = _mm256_cvtepu8_epi16(dst);
+	__m256i alphaAB = _mm256_shuffle_epi8(srcAB, distribution_mask);
+	alphaAB = _mm256_srli_epi16(alphaAB, 2); // Reduce to 64 levels of shades so the max value fits in 16 bits.
+	__m256i nom = _mm256_sub_epi16(tr_nom_base, alphaAB);
+	dstAB = _mm256_mullo_epi16(dstAB, nom);
+	dstAB = _mm256_srli_epi16(dstAB, 8);
+	dstAB = _mm256_packus_epi16(dstAB, dstAB);
+	return _mm256_castsi256_si128(_mm256_permute4x64_epi64(dstAB, 0x08));
+}
+#endif
+
 IGNORE_UNINITIALIZED_WARNING_START
 GNU_TARGET(SSE_TARGET)
 static Colour ReallyAdjustBrightness(Colour colour, uint8 brightness)
@@ -212,6 +254,8 @@ inline void Blitter_32bppSSE2::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 inline void Blitter_32bppSSSE3::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
 #elif (SSE_VERSION == 4)
 inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
+#elif (SSE_VERSION == 5)
+inline void Blitter_32bppAVX2::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
 #endif
 {
 	const byte * const remap = bp->remap;
@@ -254,6 +298,13 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 	#define DARKEN_PARAM_2      tr_nom_base
 #endif
 	const __m128i tr_nom_base = TRANSPARENT_NOM_BASE;
+#if (SSE_VERSION >= 5)
+	const __m256i alpha_and_256   = _mm256_broadcastsi128_si256(alpha_and);
+	const __m256i a_cm_256        = _mm256_broadcastsi128_si256(a_cm);
+	const __m256i pack_low_cm_256 = _mm256_broadcastsi128_si256(pack_low_cm);
+	const __m256i tr_nom_base_256 = _mm256_broadcastsi128_si256(tr_nom_base);
+	const __m256i alpha_bits_256  = _mm256_set1_epi32(0xFF000000);
+#endif
 
 	for (int y = bp->height; y != 0; y--) {
 		Colour *dst = dst_line;
@@ -276,7 +327,19 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 		switch (mode) {
 			default:
 				if (!translucent) {
-					for (uint x = (uint) effective_width; x > 0; x--) {
+					uint x = (uint) effective_width;
+#if (SSE_VERSION >= 5)
+					/* Copy the pixels with a non-zero alpha, like the loop below. */
+					for (; x >= 8; x -= 8) {
+						__m256i srcABCD = _mm256_loadu_si256((const __m256i*) src);
+						__m256i dstABCD = _mm256_loadu_si256((__m256i*) dst);
+						__m256i transparent = _mm256_cmpeq_epi32(_mm256_and_si256(srcABCD, alpha_bits_256), _mm256_setzero_si256());
+						_mm256_storeu_si256((__m256i*) dst, _mm256_blendv_epi8(srcABCD, dstABCD, transparent));
+						src += 8;
+						dst += 8;
+					}
+#endif
+					for (; x > 0; x--) {
 						if (src->a) *dst = *src;
 						src++;
 						dst++;
@@ -284,12 +347,24 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 					break;
 				}
 
-				for (uint x = (uint) effective_width / 2; x > 0; x--) {
-					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
-					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
-					_mm_storel_epi64((__m128i*) dst, AlphaBlendTwoPixels(srcABCD, dstABCD, ALPHA_BLEND_PARAM_1, ALPHA_BLEND_PARAM_2, ALPHA_BLEND_PARAM_3));
-					src += 2;
-					dst += 2;
+				{
+					uint x = (uint) effective_width / 2;
+#if (SSE_VERSION >= 5)
+					for (; x >= 2; x -= 2) {
+						__m128i srcABCD = _mm_loadu_si128((const __m128i*) src);
+						__m128i dstABCD = _mm_loadu_si128((__m128i*) dst);
+						_mm_storeu_si128((__m128i*) dst, AlphaBlendFourPixels(srcABCD, dstABCD, a_cm_256, pack_low_cm_256, alpha_and_256));
+						src += 4;
+						dst += 4;
+					}
+#endif
+					for (; x > 0; x--) {
+						__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
+						__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
+						_mm_storel_epi64((__m128i*) dst, AlphaBlendTwoPixels(srcABCD, dstABCD, ALPHA_BLEND_PARAM_1, ALPHA_BLEND_PARAM_2, ALPHA_BLEND_PARAM_3));
+						src += 2;
+						dst += 2;
+					}
 				}
 
 				if ((bt_last == BT_NONE && effective_width & 1) || bt_last == BT_ODD) {
@@ -383,12 +458,24 @@ bmcr_alpha_blend_single:
 
 			case BM_TRANSPARENT:
 				/* Make the current colour a bit more black, so it looks like this image is transparent. */
-				for (uint x = (uint) bp->width / 2; x > 0; x--) {
-					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
-					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
-					_mm_storel_epi64((__m128i *) dst, DarkenTwoPixels(srcABCD, dstABCD, DARKEN_PARAM_1, DARKEN_PARAM_2));
-					src += 2;
-					dst += 2;
+				{
+					uint x = (uint) bp->width / 2;
+#if (SSE_VERSION >= 5)
+					for (; x >= 2; x -= 2) {
+						__m128i srcABCD = _mm_loadu_si128((const __m128i*) src);
+						__m128i dstABCD = _mm_loadu_si128((__m128i*) dst);
+						_mm_storeu_si128((__m128i *) dst, DarkenFourPixels(srcABCD, dstABCD, a_cm_256, tr_nom_base_256));
+						src += 4;
+						dst += 4;
+					}
+#endif
+					for (; x > 0; x--) {
+						__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
+						__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
+						_mm_storel_epi64((__m128i *) dst, DarkenTwoPixels(srcABCD, dstABCD, DARKEN_PARAM_1, DARKEN_PARAM_2));
+						src += 2;
+						dst += 2;
+					}
 				}
 
 				if ((bt_last == BT_NONE && bp->width & 1) || bt_last == BT_ODD) {
@@ -503,6 +590,8 @@ void Blitter_32bppSSE2::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomL
 void Blitter_32bppSSSE3::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
 #elif (SSE_VERSION == 4)
 void Blitter_32bppSSE4::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
+#elif (SSE_VERSION == 5)
+void Blitter_32bppAVX2::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
 #endif
 {
 	switch (mode) {
@@ -187,6 +187,24 @@ bool CargoShift::operator()(CargoPacket *cp)
 	return cp_new == cp;
 }
 
+/**
+ * Get the new next hop for a rerouted packet from the given source station, avoiding #avoid and #avoid2.
+ * Consecutive packets usually share a source station, so the flow stat of the previous lookup is reused.
+ * @param source Source station of the packet.
+ * @return New next hop.
+ */
+template <class Tlist>
+StationID CargoReroute<Tlist>::GetVia(StationID source)
+{
+	if (!this->flow_cache_valid || source != this->cached_source) {
+		FlowStatMap::const_iterator flow_it(this->ge->flows.find(source));
+		this->cached_flow = (flow_it != this->ge->flows.end()) ? &(*flow_it) : nullptr;
+		this->cached_source = source;
+		this->flow_cache_valid = true;
+	}
+	return this->cached_flow != nullptr ? this->cached_flow->GetVia(this->avoid, this->avoid2) : INVALID_STATION;
+}
+
 /**
  * Reroutes some cargo from one Station sublist to another.
  * @param cp Packet to be rerouted.
@@ -196,7 +214,7 @@ bool StationCargoReroute::operator()(CargoPacket *cp)
 {
 	CargoPacket *cp_new = this->Preprocess(cp);
 	if (cp_new == nullptr) cp_new = cp;
-	StationID next = this->ge->GetVia(cp_new->SourceStation(), this->avoid, this->avoid2);
+	StationID next = this->GetVia(cp_new->SourceStation());
 	assert(next != this->avoid && next != this->avoid2);
 	if (this->source != this->destination) {
 		this->source->RemoveFromCache(cp_new, cp_new->Count());
@@ -221,7 +239,7 @@ bool VehicleCargoReroute::operator()(CargoPacket *cp, std::vector<CargoPacket *>
 	CargoPacket *cp_new = this->Preprocess(cp);
 	if (cp_new == nullptr) cp_new = cp;
 	if (cp_new->NextStation() == this->avoid || cp_new->NextStation() == this->avoid2) {
-		cp->SetNextStation(this->ge->GetVia(cp_new->SourceStation(), this->avoid, this->avoid2));
+		cp->SetNextStation(this->GetVia(cp_new->SourceStation()));
 	}
 	if (unlikely(this->source != this->destination)) {
 		this->source->RemoveFromMeta(cp_new, VehicleCargoList::MTA_TRANSFER, cp_new->Count());
@@ -240,3 +258,5 @@ template uint CargoRemoval<VehicleCargoList>::Preprocess(CargoPacket *cp);
 template uint CargoRemoval<StationCargoList>::Preprocess(CargoPacket *cp);
 template bool CargoRemoval<VehicleCargoList>::Postprocess(CargoPacket *cp, uint remove);
 template bool CargoRemoval<StationCargoList>::Postprocess(CargoPacket *cp, uint remove);
+template StationID CargoReroute<VehicleCargoList>::GetVia(StationID source);
+template StationID CargoReroute<StationCargoList>::GetVia(StationID source);
@@ -13,6 +13,8 @@
 #include "cargopacket.h"
 #include <vector>
 
+class FlowStat;
+
 /**
  * Abstract action of removing cargo from a vehicle or a station.
  * @tparam Tsource CargoList subclass to remove cargo from.
@@ -118,6 +120,11 @@ protected:
 	StationID avoid;
 	StationID avoid2;
 	const GoodsEntry *ge;
+	bool flow_cache_valid = false;  ///< Whether #cached_source and #cached_flow are valid.
+	StationID cached_source;        ///< Source station of the last flow lookup.
+	const FlowStat *cached_flow;    ///< Flow stat of #cached_source, or nullptr if there is none.
+
+	StationID GetVia(StationID source);
 public:
 	CargoReroute(Tlist *source, Tlist *dest, uint max_move, StationID avoid, StationID avoid2, const GoodsEntry *ge) :
 			CargoMovement<Tlist, Tlist>(source, dest, max_move), avoid(avoid), avoid2(avoid2), ge(ge) {}
@@ -106,6 +106,52 @@ int32 GetPickupAmount(CargoMonitorID monitor, bool keep_monitoring)
 	return GetAmount(_cargo_pickups, monitor, keep_monitoring);
 }
 
+/**
+ * Get and reset the amounts of all active cargo monitors within a range of monitor numbers.
+ * @param[in,out] monitor_map Monitoring map to search (and reset for the queried entries).
+ * @param first First cargo monitor number of the range.
+ * @param last Last cargo monitor number of the range (inclusive).
+ * @param keep_monitoring After returning from this call, continue monitoring.
+ * @param[out] amounts Cargo monitors found in the range and their amounts, in increasing monitor number order.
+ */
+static void GetAmounts(CargoMonitorMap &monitor_map, CargoMonitorID first, CargoMonitorID last, bool keep_monitoring, CargoMonitorAmountList &amounts)
+{
+	CargoMonitorMap::iterator iter = monitor_map.lower_bound(first);
+	while (iter != monitor_map.end() && iter->first <= last) {
+		amounts.emplace_back(iter->first, iter->second);
+		if (keep_monitoring) {
+			iter->second = 0;
+			++iter;
+		} else {
+			iter = monitor_map.erase(iter);
+		}
+	}
+}
+
+/**
+ * Get the amounts of cargo delivered for all active cargo monitors within a range of monitor numbers, since activation or last query.
+ * @param first First cargo monitor number of the range.
+ * @param last Last cargo monitor number of the range (inclusive).
+ * @param keep_monitoring After returning from this call, continue monitoring.
+ * @param[out] amounts Cargo monitors found in the range and their amounts of delivered cargo.
+ */
+void GetDeliveryAmounts(CargoMonitorID first, CargoMonitorID last, bool keep_monitoring, CargoMonitorAmountList &amounts)
+{
+	GetAmounts(_cargo_deliveries, first, last, keep_monitoring, amounts);
+}
+
+/**
+ * Get the amounts of cargo picked up for all active cargo monitors within a range of monitor numbers, since activation or last query.
+ * @param first First cargo monitor number of the range.
+ * @param last Last cargo monitor number of the range (inclusive).
+ * @param keep_monitoring After returning from this call, continue monitoring.
+ * @param[out] amounts Cargo monitors found in the range and their amounts of picked up cargo.
+ */
+void GetPickupAmounts(CargoMonitorID first, CargoMonitorID last, bool keep_monitoring, CargoMonitorAmountList &amounts)
+{
+	GetAmounts(_cargo_pickups, first, last, keep_monitoring, amounts);
+}
+
 /**
  * Cargo was delivered to its final destination, update the pickup and delivery maps.
  * @param cargo_type type of cargo.
@@ -120,7 +166,10 @@ void AddCargoDelivery(CargoID cargo_type, CompanyID company, uint32 amount, Sour
 {
 	if (amount == 0) return;
 
-	if (src != INVALID_SOURCE) {
+	/* Nothing is being monitored, which is the usual case when no game script uses cargo monitors. */
+	if (_cargo_pickups.empty() && _cargo_deliveries.empty()) return;
+
+	if (src != INVALID_SOURCE && !_cargo_pickups.empty()) {
 		/* Handle pickup update. */
 		switch (src_type) {
 			case SourceType::Industry: {
@@ -147,10 +196,10 @@ void AddCargoDelivery(CargoID cargo_type, CompanyID company, uint32 amount, Sour
 	CargoMonitorMap::iterator iter = _cargo_deliveries.find(num);
 	if (iter != _cargo_deliveries.end()) iter->second += amount;
 
-	/* Industry delivery. */
-	for (const auto &i : st->industries_near) {
-		if (i.industry->index != dest) continue;
-		CargoMonitorID num = EncodeCargoIndustryMonitor(company, cargo_type, i.industry->index);
+	/* Industry delivery.
+	 * The destination industry is always one of the station's nearby industries, so the monitor can be looked up directly. */
+	if (dest != INVALID_INDUSTRY) {
+		CargoMonitorID num = EncodeCargoIndustryMonitor(company, cargo_type, dest);
 		CargoMonitorMap::iterator iter = _cargo_deliveries.find(num);
 		if (iter != _cargo_deliveries.end()) iter->second += amount;
 	}
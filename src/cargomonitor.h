@@ -16,6 +16,8 @@
 #include "town.h"
 #include "core/overflowsafe_type.hpp"
 #include "3rdparty/cpp-btree/btree_map.h"
+
+#include <vector>
 struct Station;
 
 /**
@@ -146,6 +148,12 @@ void ClearCargoPickupMonitoring(CompanyID company = INVALID_OWNER);
 void ClearCargoDeliveryMonitoring(CompanyID company = INVALID_OWNER);
 int32 GetDeliveryAmount(CargoMonitorID monitor, bool keep_monitoring);
 int32 GetPickupAmount(CargoMonitorID monitor, bool keep_monitoring);
+
+/** List of active cargo monitors and their amounts collected since the last query/activation. */
+typedef std::vector<std::pair<CargoMonitorID, int32>> CargoMonitorAmountList;
+
+void GetDeliveryAmounts(CargoMonitorID first, CargoMonitorID last, bool keep_monitoring, CargoMonitorAmountList &amounts);
+void GetPickupAmounts(CargoMonitorID first, CargoMonitorID last, bool keep_monitoring, CargoMonitorAmountList &amounts);
 void AddCargoDelivery(CargoID cargo_type, CompanyID company, uint32 amount, SourceType src_type, SourceID src, const Station *st, IndustryID dest = INVALID_INDUSTRY);
 
 #endif /* CARGOMONITOR_H */
@@ -20,6 +20,7 @@
 #include "strings_func.h"
 #include "3rdparty/cpp-btree/btree_map.h"
 
+#include <optional>
 #include <vector>
 
 #include "safeguards.h"
@@ -117,9 +118,9 @@ CargoPacket::CargoPacket()
  * that, in contrary to all other pools, does not memset to 0.
  */
 CargoPacket::CargoPacket(StationID source, TileIndex source_xy, uint16 count, SourceType source_type, SourceID source_id) :
-	feeder_share(0),
 	count(count),
 	days_in_transit(0),
+	feeder_share(0),
 	source_id(source_id),
 	source(source),
 	source_xy(source_xy),
@@ -144,9 +145,9 @@ CargoPacket::CargoPacket(StationID source, TileIndex source_xy, uint16 count, So
  * that, in contrary to all other pools, does not memset to 0.
  */
 CargoPacket::CargoPacket(uint16 count, uint16 days_in_transit, StationID source, TileIndex source_xy, TileIndex loaded_at_xy, Money feeder_share, SourceType source_type, SourceID source_id) :
-		feeder_share(feeder_share),
 		count(count),
 		days_in_transit(days_in_transit),
+		feeder_share(feeder_share),
 		source_id(source_id),
 		source(source),
 		source_xy(source_xy),
@@ -642,6 +643,26 @@ bool VehicleCargoList::Stage(bool accepted, StationID current_station, StationID
 	bool force_keep = (order_flags & OUFB_NO_UNLOAD) != 0;
 	bool force_unload = (order_flags & OUFB_UNLOAD) != 0;
 	bool force_transfer = (order_flags & (OUFB_TRANSFER | OUFB_UNLOAD)) != 0;
+
+	/* Consecutive packets usually share a source station, so remember the flow lookup for the previous source,
+	 * and for forced transfers the shares with the excluded next hops removed, which would otherwise be copied
+	 * and modified for every packet. */
+	StationID flow_source = INVALID_STATION;
+	const FlowStat *flow = nullptr;
+	bool flow_valid = false;
+	auto find_flow = [&](StationID source) -> const FlowStat * {
+		if (!flow_valid || flow_source != source) {
+			FlowStatMap::const_iterator flow_it(ge->flows.find(source));
+			flow = (flow_it != ge->flows.end()) ? &(*flow_it) : nullptr;
+			flow_source = source;
+			flow_valid = true;
+		}
+		return flow;
+	};
+	StationID transfer_shares_source = INVALID_STATION;
+	std::optional<FlowStat> transfer_shares;
+	bool transfer_shares_valid = false;
+
 	dbg_assert(this->count > 0 || it == this->packets.end());
 	while (sum < this->count) {
 		CargoPacket *cp = *it;
@@ -657,21 +678,25 @@ bool VehicleCargoList::Stage(bool accepted, StationID current_station, StationID
 			action = MTA_TRANSFER;
 			/* We cannot send the cargo to any of the possible next hops and
 			 * also not to the current station. */
-			FlowStatMap::const_iterator flow_it(ge->flows.find(cp->source));
-			if (flow_it == ge->flows.end()) {
+			if (!transfer_shares_valid || transfer_shares_source != cp->source) {
+				transfer_shares.reset();
+				const FlowStat *flow_stat = find_flow(cp->source);
+				if (flow_stat != nullptr) {
+					FlowStat new_shares = *flow_stat;
+					new_shares.ChangeShare(current_station, INT_MIN);
+					StationIDStack excluded = next_station;
+					while (!excluded.IsEmpty() && !new_shares.empty()) {
+						new_shares.ChangeShare(excluded.Pop(), INT_MIN);
+					}
+					if (!new_shares.empty()) transfer_shares.emplace(std::move(new_shares));
+				}
+				transfer_shares_source = cp->source;
+				transfer_shares_valid = true;
+			}
+			if (!transfer_shares.has_value()) {
 				cargo_next = INVALID_STATION;
 			} else {
-				FlowStat new_shares = *flow_it;
-				new_shares.ChangeShare(current_station, INT_MIN);
-				StationIDStack excluded = next_station;
-				while (!excluded.IsEmpty() && !new_shares.empty()) {
-					new_shares.ChangeShare(excluded.Pop(), INT_MIN);
-				}
-				if (new_shares.empty()) {
-					cargo_next = INVALID_STATION;
-				} else {
-					cargo_next = new_shares.GetVia();
-				}
+				cargo_next = transfer_shares->GetVia();
 			}
 		} else {
 			/* Rewrite an invalid source station to some random other one to
@@ -680,17 +705,17 @@ bool VehicleCargoList::Stage(bool accepted, StationID current_station, StationID
 				cp->source = ge->flows.FirstStationID();
 			}
 			bool restricted = false;
-			FlowStatMap::const_iterator flow_it(ge->flows.find(cp->source));
-			if (flow_it == ge->flows.end()) {
+			const FlowStat *flow_stat = find_flow(cp->source);
+			if (flow_stat == nullptr) {
 				cargo_next = INVALID_STATION;
 			} else {
-				cargo_next = flow_it->GetViaWithRestricted(restricted);
+				cargo_next = flow_stat->GetViaWithRestricted(restricted);
 			}
 			action = VehicleCargoList::ChooseAction(cp, cargo_next, current_station, accepted, next_station);
 			if (restricted && action == MTA_TRANSFER) {
 				/* If the flow is restricted we can't transfer to it. Choose an
 				 * unrestricted one instead. */
-				cargo_next = flow_it->GetVia();
+				cargo_next = flow_stat->GetVia();
 				action = VehicleCargoList::ChooseAction(cp, cargo_next, current_station, accepted, next_station);
 			}
 		}
@@ -927,15 +952,20 @@ void StationCargoList::Append(CargoPacket *cp, StationID next)
 template <class Taction>
 bool StationCargoList::ShiftCargo(Taction &action, StationID next)
 {
-	for (Iterator it = this->packets.lower_bound(next); it != this->packets.end() && it.GetKey() == next;) {
+	StationCargoPacketMap::MapIterator map_it = this->packets.find(next);
+	if (map_it == this->packets.end()) return true;
+
+	StationCargoPacketMap::List &list = map_it->second;
+	while (!list.empty()) {
 		if (action.MaxMove() == 0) return false;
-		CargoPacket *cp = *it;
+		CargoPacket *cp = list.front();
 		if (action(cp)) {
-			it = this->packets.erase(it);
+			list.pop_front();
 		} else {
 			return false;
 		}
 	}
+	this->packets.StationCargoPacketMap::Map::erase(map_it);
 	return true;
 }
 
@@ -983,20 +1013,35 @@ uint StationCargoList::ShiftCargo(Taction action, StationIDStack next, bool incl
 template <class Taction>
 bool StationCargoList::ShiftCargoFromSource(Taction &action, StationID source, StationID next)
 {
-	for (Iterator it = this->packets.lower_bound(next); it != this->packets.end() && it.GetKey() == next;) {
-		if (action.MaxMove() == 0) return false;
-		CargoPacket *cp = *it;
+	StationCargoPacketMap::MapIterator map_it = this->packets.find(next);
+	if (map_it == this->packets.end()) return true;
+
+	/* Compact the packets which are kept towards the front in a single pass,
+	 * instead of erasing each removed packet from the middle of the list. */
+	StationCargoPacketMap::List &list = map_it->second;
+	StationCargoPacketMap::ListIterator write = list.begin();
+	StationCargoPacketMap::ListIterator read = list.begin();
+	bool all_removed = true;
+	for (; read != list.end(); ++read) {
+		if (action.MaxMove() == 0) {
+			all_removed = false;
+			break;
+		}
+		CargoPacket *cp = *read;
 		if (cp->SourceStation() != source) {
-			++it;
+			*write = cp;
+			++write;
 			continue;
 		}
-		if (action(cp)) {
-			it = this->packets.erase(it);
-		} else {
-			return false;
+		if (!action(cp)) {
+			all_removed = false;
+			break;
 		}
 	}
-	return true;
+	write = std::move(read, list.end(), write);
+	list.erase(write, list.end());
+	if (list.empty()) this->packets.StationCargoPacketMap::Map::erase(map_it);
+	return all_removed;
 }
 
 /**
@@ -1030,9 +1075,12 @@ uint StationCargoList::ShiftCargoFromSource(Taction action, StationID source, St
 
 uint StationCargoList::AvailableViaCount(StationID next) const
 {
+	StationCargoPacketMap::ConstMapIterator map_it = this->packets.find(next);
+	if (map_it == this->packets.end()) return 0;
+
 	uint count = 0;
-	for (ConstIterator it = this->packets.lower_bound(next); it != this->packets.end() && it.GetKey() == next; ++it) {
-		count += (*it)->count;
+	for (const CargoPacket *cp : map_it->second) {
+		count += cp->count;
 	}
 	return count;
 }
@@ -384,46 +384,46 @@ static void TileLoop_Clear(TileIndex tile)
 
 void GenerateClearTile()
 {
-	uint i, gi;
-	TileIndex tile;
-
 	/* add rough tiles */
-	i = ScaleByMapSize(GB(Random(), 0, 10) + 0x400);
-	gi = ScaleByMapSize(GB(Random(), 0, 7) + 0x80);
-
-	SetGeneratingWorldProgress(GWP_ROUGH_ROCKY, gi + i);
-	do {
-		IncreaseGeneratingWorldProgress(GWP_ROUGH_ROCKY);
-		tile = RandomTile();
-		if (IsTileType(tile, MP_CLEAR) && !IsClearGround(tile, CLEAR_DESERT)) SetClearGroundDensity(tile, CLEAR_ROUGH, 3);
-	} while (--i);
+	const uint rough = ScaleByMapSize(GB(Random(), 0, 10) + 0x400);
+	const uint rocky = ScaleByMapSize(GB(Random(), 0, 7) + 0x80);
+
+	SetGeneratingWorldProgress(GWP_ROUGH_ROCKY, 4);
+	RunGenerateWorldBandPass(GWP_ROUGH_ROCKY, [&](uint y_begin, uint y_end, Randomizer &random) {
+		for (uint i = GetGenerateWorldBandShare(rough, y_begin, y_end); i != 0; i--) {
+			TileIndex tile = TileXY(random.Next(MapSizeX()), y_begin + random.Next(y_end - y_begin));
+			if (IsTileType(tile, MP_CLEAR) && !IsClearGround(tile, CLEAR_DESERT)) SetClearGroundDensity(tile, CLEAR_ROUGH, 3);
+		}
+	});
 
 	/* add rocky tiles */
-	i = gi;
-	do {
-		uint32 r = Random();
-		tile = RandomTileSeed(r);
-
-		IncreaseGeneratingWorldProgress(GWP_ROUGH_ROCKY);
+	RunGenerateWorldBandPass(GWP_ROUGH_ROCKY, [&](uint y_begin, uint y_end, Randomizer &random) {
+		/* Rocky areas may spread into the margin around the band. */
+		const uint y_min = y_begin > GENWORLD_BAND_MARGIN ? y_begin - GENWORLD_BAND_MARGIN : 0;
+		const uint y_max = y_end + GENWORLD_BAND_MARGIN;
 		auto IsUsableTile = [&](TileIndex t) -> bool {
-			return IsTileType(t, MP_CLEAR) && (_allow_rocks_desert || !IsClearGround(t, CLEAR_DESERT));
+			return IsInsideMM(TileY(t), y_min, y_max) && IsTileType(t, MP_CLEAR) && (_allow_rocks_desert || !IsClearGround(t, CLEAR_DESERT));
 		};
-		if (IsUsableTile(tile)) {
+
+		for (uint i = GetGenerateWorldBandShare(rocky, y_begin, y_end); i != 0; i--) {
+			uint32 r = random.Next();
+			TileIndex tile = TileXY(random.Next(MapSizeX()), y_begin + random.Next(y_end - y_begin));
+			if (!IsUsableTile(tile)) continue;
+
 			uint j = GB(r, 16, 4) + _settings_game.game_creation.amount_of_rocks + ((int)TileHeight(tile) * _settings_game.game_creation.height_affects_rocks);
 			for (;;) {
 				TileIndex tile_new;
 
 				SetClearGroundDensity(tile, CLEAR_ROCKS, 3);
-				MarkTileDirtyByTile(tile);
 				do {
 					if (--j == 0) goto get_out;
-					tile_new = tile + TileOffsByDiagDir((DiagDirection)GB(Random(), 0, 2));
-				} while (!IsUsableTile(tile_new));
+					tile_new = tile + TileOffsByDiagDir((DiagDirection)GB(random.Next(), 0, 2));
+				} while (tile_new >= MapSize() || !IsUsableTile(tile_new));
 				tile = tile_new;
 			}
 get_out:;
 		}
-	} while (--i);
+	});
 }
 
 static TrackStatus GetTileTrackStatus_Clear(TileIndex tile, TransportType mode, uint sub_mode, DiagDirection side)
@@ -34,7 +34,9 @@
 #include "debug_settings.h"
 #include "debug_desync.h"
 #include "order_backup.h"
+#include "framerate_type.h"
 #include <array>
+#include <chrono>
 #include <deque>
 
 #include "table/strings.h"
@@ -639,12 +641,121 @@ struct CommandQueueItem {
 };
 static std::deque<CommandQueueItem> _command_queue;
 
+/** Execution time of a command ID or of the commands of a company, see #DumpCommandTimings. */
+struct CommandTiming {
+	uint64 test_count = 0;   ///< Number of test runs.
+	uint64 test_ns = 0;      ///< Total time of the test runs, in nanoseconds.
+	uint64 test_max_ns = 0;  ///< Longest test run, in nanoseconds.
+	uint64 exec_count = 0;   ///< Number of executions.
+	uint64 exec_ns = 0;      ///< Total time of the executions, in nanoseconds.
+	uint64 exec_max_ns = 0;  ///< Longest execution, in nanoseconds.
+
+	/** Get the total time of the test runs and executions, in nanoseconds. */
+	uint64 GetTotal() const { return this->test_ns + this->exec_ns; }
+};
+
+static std::array<CommandTiming, CMD_END> _command_timings;            ///< Timings per command ID.
+static std::array<CommandTiming, OWNER_END> _command_company_timings;  ///< Timings per company running the command, OWNER_NONE for spectators and the server.
+
+/**
+ * Get the current time for command timings.
+ * @return Monotonic time in nanoseconds.
+ */
+static uint64 GetCommandTimestamp()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Record the time of a test run or execution of a command.
+ * @param cmd_id The command ID.
+ * @param company The company running the command.
+ * @param exec Whether the command was executed, instead of tested.
+ * @param start The start time, see #GetCommandTimestamp.
+ */
+static void RecordCommandTiming(uint cmd_id, CompanyID company, bool exec, uint64 start)
+{
+	const uint64 duration = GetCommandTimestamp() - start;
+	auto add = [&](CommandTiming &timing) {
+		if (exec) {
+			timing.exec_count++;
+			timing.exec_ns += duration;
+			timing.exec_max_ns = std::max(timing.exec_max_ns, duration);
+		} else {
+			timing.test_count++;
+			timing.test_ns += duration;
+			timing.test_max_ns = std::max(timing.test_max_ns, duration);
+		}
+	};
+	add(_command_timings[cmd_id]);
+	add(_command_company_timings[company < OWNER_END ? company : OWNER_NONE]);
+}
+
+/** Discard all command timings. */
+void ClearCommandTimings()
+{
+	_command_timings.fill({});
+	_command_company_timings.fill({});
+}
+
+/**
+ * Dump the time spent per command ID and per company, most expensive first.
+ * @param buffer The output buffer.
+ * @param last The end of the output buffer.
+ * @return The end of the written output.
+ */
+char *DumpCommandTimings(char *buffer, const char *last)
+{
+	auto to_ms = [](uint64 ns) -> double { return ns / 1000000.0; };
+	auto dump = [&](const char *name, const CommandTiming &timing) {
+		buffer += seprintf(buffer, last, "  %s: total: %.3f ms, test: " OTTD_PRINTF64U " x, %.3f ms, max: %.3f ms, exec: " OTTD_PRINTF64U " x, %.3f ms, max: %.3f ms\n",
+				name, to_ms(timing.GetTotal()), timing.test_count, to_ms(timing.test_ns), to_ms(timing.test_max_ns),
+				timing.exec_count, to_ms(timing.exec_ns), to_ms(timing.exec_max_ns));
+	};
+
+	std::vector<uint> order;
+	for (uint i = 0; i < CMD_END; i++) {
+		if (_command_timings[i].test_count > 0) order.push_back(i);
+	}
+	std::sort(order.begin(), order.end(), [](uint a, uint b) { return _command_timings[a].GetTotal() > _command_timings[b].GetTotal(); });
+	buffer += seprintf(buffer, last, "Command timings:\n");
+	for (uint i : order) {
+		dump(GetCommandName(i), _command_timings[i]);
+	}
+
+	order.clear();
+	for (uint i = 0; i < OWNER_END; i++) {
+		if (_command_company_timings[i].test_count > 0) order.push_back(i);
+	}
+	std::sort(order.begin(), order.end(), [](uint a, uint b) { return _command_company_timings[a].GetTotal() > _command_company_timings[b].GetTotal(); });
+	buffer += seprintf(buffer, last, "\nCommand timings per company:\n");
+	for (uint i : order) {
+		char name[32];
+		if (i < MAX_COMPANIES) {
+			seprintf(name, lastof(name), "company %u", i + 1);
+		} else {
+			strecpy(name, i == OWNER_DEITY ? "game script" : "server/spectator", lastof(name));
+		}
+		dump(name, _command_company_timings[i]);
+	}
+	return buffer;
+}
+
 void ClearCommandLog()
 {
 	_command_log.Reset();
 	_command_log_aux.Reset();
 }
 
+/**
+ * Get the number of commands logged since the command log was last cleared.
+ * @return Total number of entries appended to the command logs.
+ */
+uint64 GetCommandLogTotalCount()
+{
+	return (uint64)_command_log.count + _command_log_aux.count;
+}
+
 static void DumpSubCommandLogEntry(char *&buffer, const char *last, const CommandLogEntry &entry)
 {
 		auto fc = [&](CommandLogEntryFlag flag, char c) -> char {
@@ -1112,6 +1223,9 @@ CommandCost DoCommandPInternal(TileIndex tile, uint32 p1, uint32 p2, uint64 p3,
 	assert(_docommand_recursive == 0);
 	_docommand_recursive = 1;
 
+	LatencyMeasurer latency(LHT_COMMAND);
+	const CompanyID timing_company = _current_company;
+
 	/* Reset the state. */
 	_additional_cash_required = 0;
 
@@ -1156,7 +1270,9 @@ CommandCost DoCommandPInternal(TileIndex tile, uint32 p1, uint32 p2, uint64 p3,
 	_cleared_object_areas.clear();
 	SetTownRatingTestMode(true);
 	BasePersistentStorageArray::SwitchMode(PSM_ENTER_TESTMODE);
+	const uint64 test_start = GetCommandTimestamp();
 	CommandCost res = command.Execute(tile, flags, p1, p2, p3, text, aux_data);
+	RecordCommandTiming(cmd_id, timing_company, false, test_start);
 	BasePersistentStorageArray::SwitchMode(PSM_LEAVE_TESTMODE);
 	SetTownRatingTestMode(false);
 
@@ -1208,7 +1324,9 @@ CommandCost DoCommandPInternal(TileIndex tile, uint32 p1, uint32 p2, uint64 p3,
 	 * use the construction one */
 	_cleared_object_areas.clear();
 	BasePersistentStorageArray::SwitchMode(PSM_ENTER_COMMAND);
+	const uint64 exec_start = GetCommandTimestamp();
 	CommandCost res2 = command.Execute(tile, flags | DC_EXEC, p1, p2, p3, text, aux_data);
+	RecordCommandTiming(cmd_id, timing_company, true, exec_start);
 	BasePersistentStorageArray::SwitchMode(PSM_LEAVE_COMMAND);
 
 	if (cmd_id == CMD_COMPANY_CTRL) {
@@ -83,7 +83,10 @@ static inline DoCommandFlag CommandFlagsToDCFlags(CommandFlags cmd_flags)
 }
 
 void ClearCommandLog();
+uint64 GetCommandLogTotalCount();
 char *DumpCommandLog(char *buffer, const char *last);
+void ClearCommandTimings();
+char *DumpCommandTimings(char *buffer, const char *last);
 
 void ExecuteCommandQueue();
 void ClearCommandQueue();
@@ -61,6 +61,11 @@
 #include "event_logs.h"
 #include "tile_cmd.h"
 #include "object_base.h"
+#include "tracing.h"
+#include "vehicle_profile.h"
+#include "memory_stats.h"
+#include "framerate_type.h"
+#include "tests/pathfinder_benchmark.h"
 #include <time.h>
 
 #include <set>
@@ -2547,6 +2552,199 @@ DEF_CONSOLE_CMD(ConGetFullDate)
 	return true;
 }
 
+DEF_CONSOLE_CMD(ConBenchmarkSaveLoad)
+{
+	if (argc == 0) {
+		IConsoleHelp("Benchmark saving the current game with each savegame format and decompressing it again, reporting the results as JSON.");
+		IConsoleHelp("Usage: 'benchmark_saveload [<iterations>] [<filename>]'. The results are also written to <filename> in the save directory, if given.");
+		return true;
+	}
+
+	if (argc > 3) return false;
+
+	uint32 iterations = 1;
+	if (argc >= 2 && (!GetArgumentInteger(&iterations, argv[1]) || iterations == 0)) return false;
+
+	std::string result = SaveLoadBenchmark(iterations);
+	if (result.empty()) {
+		IConsolePrint(CC_ERROR, "Savegame benchmark failed");
+		return true;
+	}
+	PrintLineByLine(result);
+
+	if (argc == 3) {
+		FILE *f = FioFOpenFile(argv[2], "wb", SAVE_DIR);
+		if (f == nullptr) {
+			IConsolePrintF(CC_ERROR, "Cannot open file '%s' for writing", argv[2]);
+			return true;
+		}
+		fwrite(result.data(), 1, result.size(), f);
+		fputc('\n', f);
+		fclose(f);
+		IConsolePrintF(CC_DEFAULT, "Results written to %s", argv[2]);
+	}
+	return true;
+}
+
+DEF_CONSOLE_CMD(ConBenchmarkPathfinder)
+{
+	if (argc == 0) {
+		IConsoleHelp("Benchmark the path searches of the trains, road vehicles and ships in the current game, reporting the results as JSON.");
+		IConsoleHelp("Usage: 'benchmark_pathfinder [<iterations>] [<filename>]'. The results are also written to <filename> in the save directory, if given.");
+		return true;
+	}
+
+	if (argc > 3) return false;
+
+	uint32 iterations = 1;
+	if (argc >= 2 && (!GetArgumentInteger(&iterations, argv[1]) || iterations == 0)) return false;
+
+	std::string result = PathfinderBenchmark(iterations);
+	PrintLineByLine(result);
+
+	if (argc == 3) {
+		FILE *f = FioFOpenFile(argv[2], "wb", SAVE_DIR);
+		if (f == nullptr) {
+			IConsolePrintF(CC_ERROR, "Cannot open file '%s' for writing", argv[2]);
+			return true;
+		}
+		fwrite(result.data(), 1, result.size(), f);
+		fputc('\n', f);
+		fclose(f);
+		IConsolePrintF(CC_DEFAULT, "Results written to %s", argv[2]);
+	}
+	return true;
+}
+
+DEF_CONSOLE_CMD(ConTrace)
+{
+	if (argc == 0) {
+		IConsoleHelp("Record a timeline of the game loop, drawing and worker threads, for viewing in chrome://tracing or Perfetto.");
+		IConsoleHelp("Usage: 'trace start [<events per thread>]' to start recording, 'trace stop <filename>' to stop and write the trace to <filename> in the save directory.");
+		return true;
+	}
+
+	if (argc >= 2 && strcmp(argv[1], "start") == 0 && argc <= 3) {
+		uint32 events = 100000;
+		if (argc == 3 && (!GetArgumentInteger(&events, argv[2]) || events == 0)) return false;
+		StartTracing(events);
+		IConsolePrintF(CC_DEFAULT, "Tracing started, recording up to %u events per thread", events);
+		return true;
+	}
+
+	if (argc == 3 && strcmp(argv[1], "stop") == 0) {
+		StopTracing();
+		std::string result = GetTraceJSON();
+
+		FILE *f = FioFOpenFile(argv[2], "wb", SAVE_DIR);
+		if (f == nullptr) {
+			IConsolePrintF(CC_ERROR, "Cannot open file '%s' for writing", argv[2]);
+			return true;
+		}
+		fwrite(result.data(), 1, result.size(), f);
+		fclose(f);
+		IConsolePrintF(CC_DEFAULT, "Trace written to %s", argv[2]);
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * Format the breakdown of a vehicle profile cost for the console.
+ * @param cost The cost.
+ * @param ticks The number of profiled ticks.
+ * @return The formatted cost.
+ */
+static std::string FormatVehicleProfileCost(const VehicleProfileCost &cost, uint ticks)
+{
+	auto to_ms = [](uint64 ns) -> double { return ns / 1000000.0; };
+	return stdstr_fmt("%.3f ms (%.1f us/tick): tick %.3f ms, pathfinding %.3f ms, NewGRF %.3f ms",
+			to_ms(cost.Total()), cost.Total() / 1000.0 / std::max<uint>(ticks, 1),
+			to_ms(cost.time[VPC_TICK]), to_ms(cost.time[VPC_PATHFINDING]), to_ms(cost.time[VPC_NEWGRF]));
+}
+
+DEF_CONSOLE_CMD(ConVehicleProfile)
+{
+	if (argc == 0) {
+		IConsoleHelp("Attribute the time spent on vehicle ticks, pathfinding and NewGRF callbacks to individual vehicles and companies.");
+		IConsoleHelp("Usage: 'vehicle_profile start' to start profiling, 'vehicle_profile stop' to stop profiling, 'vehicle_profile top [<count>]' to list the most expensive vehicles and companies.");
+		return true;
+	}
+
+	if (argc == 2 && strcmp(argv[1], "start") == 0) {
+		StartVehicleProfile();
+		IConsolePrint(CC_DEFAULT, "Vehicle profiling started");
+		return true;
+	}
+
+	if (argc == 2 && strcmp(argv[1], "stop") == 0) {
+		StopVehicleProfile();
+		IConsolePrintF(CC_DEFAULT, "Vehicle profiling stopped after %u ticks", GetVehicleProfileTicks());
+		return true;
+	}
+
+	if (argc >= 2 && strcmp(argv[1], "top") == 0 && argc <= 3) {
+		uint32 count = 10;
+		if (argc == 3 && !GetArgumentInteger(&count, argv[2])) return false;
+
+		static const char * const type_names[] = { "train", "road vehicle", "ship", "aircraft" };
+		const uint ticks = GetVehicleProfileTicks();
+
+		std::vector<VehicleProfileVehicleResult> vehicles;
+		std::vector<VehicleProfileCompanyResult> companies;
+		GetVehicleProfileTop(count, vehicles, companies);
+
+		IConsolePrintF(CC_DEFAULT, "%s, %u ticks profiled", _vehicle_profile_enabled ? "Profiling" : "Not profiling", ticks);
+		IConsolePrint(CC_DEFAULT, "Companies:");
+		for (const VehicleProfileCompanyResult &c : companies) {
+			std::string owner = c.owner < MAX_COMPANIES ? stdstr_fmt("company %u", c.owner + 1) : std::string("no owner");
+			IConsolePrintF(CC_DEFAULT, "  %s: %s", owner.c_str(), FormatVehicleProfileCost(c.cost, ticks).c_str());
+		}
+		IConsolePrint(CC_DEFAULT, "Vehicles:");
+		for (const VehicleProfileVehicleResult &v : vehicles) {
+			const Vehicle *u = Vehicle::GetIfValid(v.id);
+			std::string unit = (u != nullptr && u->IsPrimaryVehicle()) ? stdstr_fmt(" #%u", u->unitnumber) : std::string();
+			std::string owner = v.owner < MAX_COMPANIES ? stdstr_fmt("company %u", v.owner + 1) : std::string("no owner");
+			IConsolePrintF(CC_DEFAULT, "  %u (%s%s, %s): %s", v.id, v.type < lengthof(type_names) ? type_names[v.type] : "other",
+					unit.c_str(), owner.c_str(), FormatVehicleProfileCost(v.cost, ticks).c_str());
+		}
+		return true;
+	}
+
+	return false;
+}
+
+DEF_CONSOLE_CMD(ConPoolStats)
+{
+	if (argc == 0) {
+		IConsoleHelp("Show the item size, capacity, occupancy and fragmentation of all pools, and the memory used by cargo lists, flows and order lists.");
+		IConsoleHelp("Usage: 'pool_stats' to show the statistics, 'pool_stats compact' to first release the unused tail and allocation cache of all pools.");
+		IConsoleHelp("Compacting does not move items, so it only releases free space after the highest used index of each pool.");
+		return true;
+	}
+
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "compact") != 0)) return false;
+
+	if (argc == 2) {
+		const size_t released = CompactPools();
+		IConsolePrintF(CC_DEFAULT, "Released " PRINTF_SIZE " bytes", released);
+	}
+
+	IConsolePrint(CC_DEFAULT, "Pools:");
+	for (const PoolStats &ps : GetPoolStats()) {
+		IConsolePrintF(CC_DEFAULT, "  %s: item size: " PRINTF_SIZE ", capacity: " PRINTF_SIZE ", used range: " PRINTF_SIZE ", items: " PRINTF_SIZE
+				", free in range: " PRINTF_SIZE ", fragmentation: %.1f%%, cached: " PRINTF_SIZE ", " PRINTF_SIZE " KiB",
+				ps.name, ps.item_size, ps.capacity, ps.used_range, ps.items, ps.GetHoles(), ps.GetFragmentation() * 100.0, ps.cached_items, ps.GetBytes() / 1024);
+	}
+	IConsolePrint(CC_DEFAULT, "Containers:");
+	for (const ContainerMemoryStats &cs : GetContainerMemoryStats()) {
+		IConsolePrintF(CC_DEFAULT, "  %s: containers: " PRINTF_SIZE ", entries: " PRINTF_SIZE ", " PRINTF_SIZE " KiB",
+				cs.name, cs.containers, cs.entries, cs.bytes / 1024);
+	}
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConDumpCommandLog)
 {
 	if (argc == 0) {
@@ -2560,6 +2758,28 @@ DEF_CONSOLE_CMD(ConDumpCommandLog)
 	return true;
 }
 
+DEF_CONSOLE_CMD(ConDumpCommandTimings)
+{
+	if (argc == 0) {
+		IConsoleHelp("Dump the time spent testing and executing commands, per command and per company, most expensive first.");
+		IConsoleHelp("Usage: 'dump_command_timings' to dump, 'dump_command_timings reset' to discard the timings.");
+		return true;
+	}
+
+	if (argc == 2 && strcmp(argv[1], "reset") == 0) {
+		ClearCommandTimings();
+		IConsolePrint(CC_DEFAULT, "Command timings reset");
+		return true;
+	}
+
+	if (argc != 1) return false;
+
+	char buffer[32768];
+	DumpCommandTimings(buffer, lastof(buffer));
+	PrintLineByLine(buffer);
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConDumpSpecialEventsLog)
 {
 	if (argc == 0) {
@@ -2716,11 +2936,17 @@ DEF_CONSOLE_CMD(ConDumpLinkgraphJobs)
 		ConvertDateToYMD(lgj->StartDateTicks() / DAY_TICKS, &start_ymd);
 		YearMonthDay join_ymd;
 		ConvertDateToYMD(lgj->JoinDateTicks() / DAY_TICKS, &join_ymd);
-		IConsolePrintF(CC_DEFAULT, "  Job: %5u, nodes: %u, cost: " OTTD_PRINTF64U ", start: (%u, %4i-%02i-%02i, %i), end: (%u, %4i-%02i-%02i, %i), duration: %u",
+		char run_time[32];
+		if (lgj->IsJobCompleted()) {
+			seprintf(run_time, lastof(run_time), OTTD_PRINTF64U " us", lgj->RunTime());
+		} else {
+			strecpy(run_time, "running", lastof(run_time));
+		}
+		IConsolePrintF(CC_DEFAULT, "  Job: %5u, nodes: %u, cost: " OTTD_PRINTF64U ", start: (%u, %4i-%02i-%02i, %i), end: (%u, %4i-%02i-%02i, %i), duration: %u, predicted run time: " OTTD_PRINTF64U " us, actual run time: %s",
 				lgj->index, lgj->Graph().Size(), lgj->Graph().CalculateCostEstimate(),
 				lgj->StartDateTicks(), start_ymd.year, start_ymd.month + 1, start_ymd.day, lgj->StartDateTicks() % DAY_TICKS,
 				lgj->JoinDateTicks(), join_ymd.year, join_ymd.month + 1, join_ymd.day, lgj->JoinDateTicks() % DAY_TICKS,
-				lgj->JoinDateTicks() - lgj->StartDateTicks());
+				lgj->JoinDateTicks() - lgj->StartDateTicks(), lgj->PredictedRunTime(), run_time);
 	 }
 	return true;
 }
@@ -3044,6 +3270,23 @@ DEF_CONSOLE_CMD(ConCheckCaches)
 	return true;
 }
 
+DEF_CONSOLE_CMD(ConStateChecksums)
+{
+	if (argc == 0) {
+		IConsoleHelp("Debug: Output checksums of the game state subsystems, to compare between the server and a desynced client. Usage: 'state_checksums [<detail>]'");
+		return true;
+	}
+
+	if (argc > 2) return false;
+
+	bool detail = (argc == 2 && atoi(argv[1]) > 0);
+	LogStateSubsystemChecksums([&](const char *str) {
+		IConsolePrint(CC_DEFAULT, str);
+	}, detail);
+
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConShowTownWindow)
 {
 	if (argc != 2) {
@@ -3351,13 +3594,13 @@ DEF_CONSOLE_CMD(ConNewGRFProfile)
 		IConsoleHelp("Usage: newgrf_profile [list]");
 		IConsoleHelp("  List all NewGRFs that can be profiled, and their status.");
 		IConsoleHelp("Usage: newgrf_profile select <grf-num>...");
-		IConsoleHelp("  Select one or more GRFs for profiling.");
+		IConsoleHelp("  Select one or more GRFs for profiling. Use the keyword \"all\" instead of a GRF number to select all.");
 		IConsoleHelp("Usage: newgrf_profile unselect <grf-num>...");
 		IConsoleHelp("  Unselect one or more GRFs from profiling. Use the keyword \"all\" instead of a GRF number to unselect all. Removing an active profiler aborts data collection.");
 		IConsoleHelp("Usage: newgrf_profile start [<num-days>]");
 		IConsoleHelp("  Begin profiling all selected GRFs. If a number of days is provided, profiling stops after that many in-game days.");
 		IConsoleHelp("Usage: newgrf_profile stop");
-		IConsoleHelp("  End profiling and write the collected data to CSV files.");
+		IConsoleHelp("  End profiling and write the collected data to CSV, folded stack (for flame graphs) and Chrome trace files.");
 		IConsoleHelp("Usage: newgrf_profile abort");
 		IConsoleHelp("  End profiling and discard all collected data.");
 		return true;
@@ -3384,6 +3627,14 @@ DEF_CONSOLE_CMD(ConNewGRFProfile)
 	/* "select" sub-command */
 	if (strncasecmp(argv[1], "sel", 3) == 0 && argc >= 3) {
 		for (size_t argnum = 2; argnum < argc; ++argnum) {
+			if (strcasecmp(argv[argnum], "all") == 0) {
+				for (GRFFile *grf : files) {
+					if (std::none_of(_newgrf_profilers.begin(), _newgrf_profilers.end(), [&](NewGRFProfiler &pr) { return pr.grffile == grf; })) {
+						_newgrf_profilers.emplace_back(grf);
+					}
+				}
+				break;
+			}
 			int grfnum = atoi(argv[argnum]);
 			if (grfnum < 1 || grfnum > (int)files.size()) { // safe cast, files.size() should not be larger than a few hundred in the most extreme cases
 				IConsolePrintF(CC_WARNING, "GRF number %d out of range, not added.", grfnum);
@@ -3606,6 +3857,60 @@ DEF_CONSOLE_CMD(ConFramerate)
 	return true;
 }
 
+DEF_CONSOLE_CMD(ConLatencyHistogram)
+{
+	if (argc == 0) {
+		IConsoleHelp("Show histograms of the durations of each performance element, autosaves, link graph join waits and commands, recorded since the last reset.");
+		IConsoleHelp("Usage: 'latency_histogram' to summarise all histograms, 'latency_histogram <name>' to list the buckets of one histogram, 'latency_histogram reset' to discard all measurements.");
+		return true;
+	}
+
+	if (argc > 2) return false;
+
+	if (argc == 2 && strcmp(argv[1], "reset") == 0) {
+		ResetLatencyHistograms();
+		IConsolePrint(CC_DEFAULT, "Latency histograms reset");
+		return true;
+	}
+
+	auto to_ms = [](uint64 us) -> double { return us / 1000.0; };
+
+	if (argc == 1) {
+		/* Count the measurements in the bucket containing 30 ms and above, i.e. ticks which took longer than a tick should. */
+		const uint64 slow_us = LatencyHistogram::GetBucketLowerBound(LatencyHistogram::GetBucket(30000));
+		IConsolePrintF(CC_DEFAULT, "Recorded over " OTTD_PRINTF64U " seconds:", GetLatencyHistogramSeconds());
+		for (LatencyHistogramType type = LHT_ELEMENT_FIRST; type < LHT_END; type++) {
+			const LatencyHistogram &histogram = GetLatencyHistogram(type);
+			if (histogram.count == 0) continue;
+			IConsolePrintF(CC_DEFAULT, "  %s: " OTTD_PRINTF64U " samples, mean: %.3f ms, p50: %.3f ms, p99: %.3f ms, p99.9: %.3f ms, max: %.3f ms, >= %.1f ms: " OTTD_PRINTF64U,
+					GetLatencyHistogramName(type), histogram.count, to_ms(histogram.sum_us) / histogram.count,
+					to_ms(histogram.GetPercentile(0.5)), to_ms(histogram.GetPercentile(0.99)), to_ms(histogram.GetPercentile(0.999)),
+					to_ms(histogram.max_us), to_ms(slow_us), histogram.CountAtLeast(slow_us));
+		}
+		return true;
+	}
+
+	for (LatencyHistogramType type = LHT_ELEMENT_FIRST; type < LHT_END; type++) {
+		if (strcmp(argv[1], GetLatencyHistogramName(type)) != 0) continue;
+
+		const LatencyHistogram &histogram = GetLatencyHistogram(type);
+		IConsolePrintF(CC_DEFAULT, "%s: " OTTD_PRINTF64U " samples over " OTTD_PRINTF64U " seconds", argv[1], histogram.count, GetLatencyHistogramSeconds());
+		uint64 seen = 0;
+		for (uint bucket = 0; bucket < LatencyHistogram::BUCKETS; bucket++) {
+			const uint64 count = histogram.counts[bucket];
+			if (count == 0) continue;
+			seen += count;
+			IConsolePrintF(CC_DEFAULT, "  %.3f - %.3f ms: " OTTD_PRINTF64U " (%.3f%%)", to_ms(LatencyHistogram::GetBucketLowerBound(bucket)),
+					bucket + 1 < LatencyHistogram::BUCKETS ? to_ms(LatencyHistogram::GetBucketLowerBound(bucket + 1)) : to_ms(histogram.max_us),
+					count, 100.0 * seen / histogram.count);
+		}
+		return true;
+	}
+
+	IConsolePrintF(CC_ERROR, "Unknown histogram: '%s'", argv[1]);
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConFramerateWindow)
 {
 	if (argc == 0) {
@@ -3833,11 +4138,18 @@ void IConsoleStdLibRegister()
 #endif
 	IConsole::CmdRegister("fps",                     ConFramerate);
 	IConsole::CmdRegister("fps_wnd",                 ConFramerateWindow);
+	IConsole::CmdRegister("latency_histogram",       ConLatencyHistogram);
 
 	IConsole::CmdRegister("find_non_realistic_braking_signal", ConFindNonRealisticBrakingSignal);
 
 	IConsole::CmdRegister("getfulldate",             ConGetFullDate,      nullptr, true);
+	IConsole::CmdRegister("benchmark_saveload",      ConBenchmarkSaveLoad, nullptr, true);
+	IConsole::CmdRegister("benchmark_pathfinder",    ConBenchmarkPathfinder, nullptr, true);
+	IConsole::CmdRegister("trace",                   ConTrace, nullptr, true);
+	IConsole::CmdRegister("vehicle_profile",         ConVehicleProfile, nullptr, true);
+	IConsole::CmdRegister("pool_stats",              ConPoolStats,        nullptr, true);
 	IConsole::CmdRegister("dump_command_log",        ConDumpCommandLog,   nullptr, true);
+	IConsole::CmdRegister("dump_command_timings",    ConDumpCommandTimings, nullptr, true);
 	IConsole::CmdRegister("dump_special_events_log", ConDumpSpecialEventsLog, nullptr, true);
 	IConsole::CmdRegister("dump_desync_msgs",        ConDumpDesyncMsgLog, nullptr, true);
 	IConsole::CmdRegister("dump_inflation",          ConDumpInflation,    nullptr, true);
@@ -3856,6 +4168,7 @@ void IConsoleStdLibRegister()
 	IConsole::CmdRegister("dump_vehicle",            ConDumpVehicle,      nullptr, true);
 	IConsole::CmdRegister("dump_tile",               ConDumpTile,         nullptr, true);
 	IConsole::CmdRegister("check_caches",            ConCheckCaches,      nullptr, true);
+	IConsole::CmdRegister("state_checksums",         ConStateChecksums,   nullptr, true);
 	IConsole::CmdRegister("show_town_window",        ConShowTownWindow,   nullptr, true);
 	IConsole::CmdRegister("show_station_window",     ConShowStationWindow, nullptr, true);
 	IConsole::CmdRegister("show_industry_window",    ConShowIndustryWindow, nullptr, true);
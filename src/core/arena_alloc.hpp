@@ -24,13 +24,19 @@ class UniformArenaAllocator {
 	void *current_block = nullptr;
 	void *last_freed = nullptr;
 	size_t next_position = 0;
+	size_t next_block = 0;
 
 	void NewBlock()
 	{
-		current_block = malloc(SIZE * N_PER_CHUNK);
-		assert(current_block != nullptr);
+		if (next_block < used_blocks.size()) {
+			current_block = used_blocks[next_block];
+		} else {
+			current_block = malloc(SIZE * N_PER_CHUNK);
+			assert(current_block != nullptr);
+			used_blocks.push_back(current_block);
+		}
+		next_block++;
 		next_position = 0;
-		used_blocks.push_back(current_block);
 	}
 
 public:
@@ -48,12 +54,29 @@ public:
 		current_block = nullptr;
 		last_freed = nullptr;
 		next_position = 0;
+		next_block = 0;
 		for (void *block : used_blocks) {
 			free(block);
 		}
 		used_blocks.clear();
 	}
 
+	/**
+	 * Forget all allocations, but keep the allocated blocks for reuse by later allocations.
+	 * @param max_retained_blocks Maximum number of blocks to keep, any further blocks are freed.
+	 */
+	void RewindArena(size_t max_retained_blocks = SIZE_MAX)
+	{
+		current_block = nullptr;
+		last_freed = nullptr;
+		next_position = 0;
+		next_block = 0;
+		while (used_blocks.size() > max_retained_blocks) {
+			free(used_blocks.back());
+			used_blocks.pop_back();
+		}
+	}
+
 	void ResetArena()
 	{
 		EmptyArena();
@@ -74,6 +97,17 @@ public:
 		}
 	}
 
+	/**
+	 * Get an allocation by the order in which it was allocated.
+	 * This is only valid when Free has not been used since the arena was last emptied or rewound.
+	 * @param index Index of the allocation, this must be less than the number of allocations.
+	 * @return Pointer to the allocation.
+	 */
+	void *GetAllocationByIndex(size_t index) const
+	{
+		return reinterpret_cast<char *>(used_blocks[index / N_PER_CHUNK]) + (SIZE * (index % N_PER_CHUNK));
+	}
+
 	void Free(void *ptr) {
 		if (!ptr) return;
 		assert(current_block != nullptr);
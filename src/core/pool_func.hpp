@@ -230,6 +230,51 @@ DEFINE_POOL_METHOD(void)::CleanPool()
 	}
 }
 
+/** Gets the occupancy statistics of the pool. */
+DEFINE_POOL_METHOD(PoolStats)::GetStats() const
+{
+	size_t cached_items = 0;
+	if (Tcache) {
+		for (const AllocCache *ac = this->alloc_cache; ac != nullptr; ac = ac->next) cached_items++;
+	}
+	return { this->name, sizeof(Titem), this->size, this->first_unused, this->items, cached_items };
+}
+
+/**
+ * Releases the index slots above the highest used index and frees the allocation cache.
+ * @return Number of bytes released.
+ */
+DEFINE_POOL_METHOD(size_t)::ShrinkToFit()
+{
+	size_t released = 0;
+
+	if (Tcache) {
+		while (this->alloc_cache != nullptr) {
+			AllocCache *ac = this->alloc_cache;
+			this->alloc_cache = ac->next;
+			free(ac);
+			released += sizeof(Titem);
+		}
+	}
+
+	/* Keep the size a multiple of 64, so no bits of the free bitmap have to be set past the end. */
+	const size_t new_size = std::min(Tmax_size, Align(this->first_unused, 64));
+	if (new_size >= this->size) return released;
+
+	released += (this->size - new_size) * sizeof(Titem *) + (CeilDivT<size_t>(this->size, 64) - CeilDivT<size_t>(new_size, 64)) * sizeof(uint64);
+	if (new_size == 0) {
+		free(this->data);
+		free(this->free_bitmap);
+		this->data = nullptr;
+		this->free_bitmap = nullptr;
+	} else {
+		this->data = ReallocT(this->data, new_size);
+		this->free_bitmap = ReallocT(this->free_bitmap, CeilDivT<size_t>(new_size, 64));
+	}
+	this->size = new_size;
+	return released;
+}
+
 #undef DEFINE_POOL_METHOD
 
 /**
@@ -241,6 +286,8 @@ DEFINE_POOL_METHOD(void)::CleanPool()
 	template void * name ## Pool::GetNew(size_t size); \
 	template void * name ## Pool::GetNew(size_t size, size_t index); \
 	template void name ## Pool::FreeItem(size_t index); \
-	template void name ## Pool::CleanPool();
+	template void name ## Pool::CleanPool(); \
+	template PoolStats name ## Pool::GetStats() const; \
+	template size_t name ## Pool::ShrinkToFit();
 
 #endif /* POOL_FUNC_HPP */
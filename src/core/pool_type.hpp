@@ -26,6 +26,28 @@ DECLARE_ENUM_AS_BIT_SET(PoolType)
 
 typedef std::vector<struct PoolBase *> PoolVector; ///< Vector of pointers to PoolBase
 
+/** Occupancy statistics of a pool, see #PoolBase::GetStats. */
+struct PoolStats {
+	const char *name;    ///< Name of the pool.
+	size_t item_size;    ///< Size of the item type, derived item types may be larger.
+	size_t capacity;     ///< Number of allocated index slots.
+	size_t used_range;   ///< Number of index slots up to and including the highest used index.
+	size_t items;        ///< Number of live items.
+	size_t cached_items; ///< Number of freed items kept for reuse, only for pools with an allocation cache.
+
+	/** Get the number of free index slots below the highest used index. */
+	size_t GetHoles() const { return this->used_range - this->items; }
+
+	/** Get the fraction of the used index range which is free, between 0 and 1. */
+	double GetFragmentation() const { return this->used_range > 0 ? (double)this->GetHoles() / (double)this->used_range : 0.0; }
+
+	/** Get the number of bytes used by the index slots, the free bitmap, the items and the allocation cache. */
+	size_t GetBytes() const
+	{
+		return this->capacity * sizeof(void *) + ((this->capacity + 63) / 64) * sizeof(uint64) + (this->items + this->cached_items) * this->item_size;
+	}
+};
+
 /** Base class for base of all pools. */
 struct PoolBase {
 	const PoolType type; ///< Type of this pool.
@@ -58,6 +80,19 @@ struct PoolBase {
 	 */
 	virtual void CleanPool() = 0;
 
+	/**
+	 * Virtual method that gets the occupancy statistics of the pool.
+	 * @return The statistics.
+	 */
+	virtual PoolStats GetStats() const = 0;
+
+	/**
+	 * Virtual method that releases the unused tail of the index slots and the allocation cache.
+	 * The indices of the items are not changed.
+	 * @return Number of bytes released.
+	 */
+	virtual size_t ShrinkToFit() = 0;
+
 private:
 	/**
 	 * Dummy private copy constructor to prevent compilers from
@@ -100,6 +135,8 @@ struct Pool : PoolBase {
 
 	Pool(const char *name);
 	virtual void CleanPool();
+	virtual PoolStats GetStats() const;
+	virtual size_t ShrinkToFit();
 
 	/**
 	 * Returns Titem with given index
@@ -124,7 +124,7 @@ uint64 ottd_rdtsc() {return 0;}
 #if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
 void ottd_cpuid(int info[4], int type)
 {
-	__cpuid(info, type);
+	__cpuidex(info, type, 0);
 }
 #elif defined(__x86_64__) || defined(__i386)
 void ottd_cpuid(int info[4], int type)
@@ -144,13 +144,13 @@ void ottd_cpuid(int info[4], int type)
 			/* It is safe to write "=r" for (info[1]) as in case that PIC is enabled for i386,
 			 * the compiler will not choose EBX as target register (but something else).
 			 */
-			: "a" (type)
+			: "a" (type), "c" (0)
 	);
 #else
 	__asm__ __volatile__ (
 			"cpuid           \n\t"
 			: "=a" (info[0]), "=b" (info[1]), "=c" (info[2]), "=d" (info[3])
-			: "a" (type)
+			: "a" (type), "c" (0)
 	);
 #endif /* i386 PIC */
 }
@@ -189,3 +189,28 @@ bool HasCPUIDFlag(uint type, uint index, uint bit)
 	ottd_cpuid(cpu_info, type);
 	return HasBit(cpu_info[index], bit);
 }
+
+/**
+ * Get the extended control register 0 (XCR0), which tells which register states the OS saves.
+ * @return The value of XCR0, or 0 when it cannot be read.
+ */
+static uint64 GetXCR0()
+{
+	/* XGETBV is only available when the OS has enabled XSAVE (OSXSAVE). */
+	if (!HasCPUIDFlag(1, 2, 27)) return 0;
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+	return _xgetbv(0);
+#elif defined(__x86_64__) || defined(__i386)
+	uint32 high, low;
+	__asm__ __volatile__ ("xgetbv" : "=a" (low), "=d" (high) : "c" (0));
+	return ((uint64)high << 32) | low;
+#else
+	return 0;
+#endif
+}
+
+bool HasCPUAVX2Support()
+{
+	if (!HasCPUIDFlag(1, 2, 28) || !HasCPUIDFlag(7, 1, 5)) return false;
+	return (GetXCR0() & 0x6) == 0x6; // XMM and YMM state
+}
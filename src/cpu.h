@@ -32,4 +32,11 @@ void ottd_cpuid(int info[4], int type);
  */
 bool HasCPUIDFlag(uint type, uint index, uint bit);
 
+/**
+ * Check whether AVX2 instructions can be used: the CPU has to support
+ * them and the OS has to preserve the (upper halves of the) YMM registers.
+ * @return True when AVX2 can be used.
+ */
+bool HasCPUAVX2Support();
+
 #endif /* CPU_H */
@@ -827,6 +827,8 @@ bool CrashLog::MakeCrashLog(char *buffer, const char *last)
 	if (crashlogged) return false;
 	crashlogged = true;
 
+	DebugFlushDeferredOutput();
+
 	char *name_buffer_date = this->name_buffer + seprintf(this->name_buffer, lastof(this->name_buffer), "crash-");
 	UTCTime::Format(name_buffer_date, lastof(this->name_buffer), "%Y%m%dT%H%M%SZ");
 
@@ -18,8 +18,10 @@
 #include "thread.h"
 #include <array>
 #include <mutex>
+#include <condition_variable>
 #if defined(__MINGW32__)
 #include "3rdparty/mingw-std-threads/mingw.mutex.h"
+#include "3rdparty/mingw-std-threads/mingw.condition_variable.h"
 #endif
 
 #if defined(_WIN32)
@@ -47,6 +49,20 @@ std::mutex _debug_remote_console_mutex; ///< Mutex to guard the queue of debug m
 std::vector<QueuedDebugItem> _debug_remote_console_queue; ///< Queue for debug messages to be passed to NetworkAdminConsole or IConsolePrint.
 std::vector<QueuedDebugItem> _debug_remote_console_queue_spare; ///< Spare queue to swap with _debug_remote_console_queue.
 
+/** Element in the queue of formatted debug output to be written by the debug output thread. */
+struct DeferredDebugOutput {
+	FILE *file;       ///< File to write to.
+	bool flush;       ///< Whether the file should be flushed after writing.
+	std::string text; ///< The formatted output, including line ending.
+};
+static std::mutex _debug_output_mutex;                           ///< Mutex to guard the debug output queue and thread state.
+static std::mutex _debug_output_write_mutex;                     ///< Mutex held while writing deferred debug output, to keep it in order.
+static std::condition_variable _debug_output_cv;                 ///< Signalled when debug output is queued, or the thread should exit.
+static std::condition_variable _debug_output_done_cv;            ///< Signalled when the debug output thread has exited.
+static std::vector<DeferredDebugOutput> _debug_output_queue;     ///< Debug output waiting to be written by the debug output thread.
+static bool _debug_output_thread_running = false;                ///< Whether the debug output thread is running and accepting output.
+static bool _debug_output_thread_exit = false;                   ///< Whether the debug output thread should exit once the queue is empty.
+
 int _debug_driver_level;
 int _debug_grf_level;
 int _debug_map_level;
@@ -136,6 +152,116 @@ char *DumpDebugFacilityNames(char *buf, char *last)
 	return buf;
 }
 
+/**
+ * Write deferred debug output.
+ * @param items Output to write.
+ */
+static void WriteDeferredDebugOutput(const std::vector<DeferredDebugOutput> &items)
+{
+	FILE *flush_file = nullptr;
+	for (const DeferredDebugOutput &item : items) {
+		if (flush_file != nullptr && flush_file != item.file) fflush(flush_file);
+		fputs(item.text.c_str(), item.file);
+		flush_file = item.flush ? item.file : nullptr;
+	}
+	if (flush_file != nullptr) fflush(flush_file);
+}
+
+/**
+ * Write formatted debug output, either directly or via the debug output thread if it is running.
+ * @param f File to write to.
+ * @param text Formatted output, including line ending.
+ * @param flush Whether the file should be flushed after writing.
+ */
+static void DebugWriteOutput(FILE *f, const char *text, bool flush)
+{
+	{
+		std::lock_guard<std::mutex> lock(_debug_output_mutex);
+		if (_debug_output_thread_running) {
+			_debug_output_queue.push_back({ f, flush, text });
+			_debug_output_cv.notify_one();
+			return;
+		}
+	}
+
+	fputs(text, f);
+	if (flush) fflush(f);
+}
+
+static void DebugOutputThread()
+{
+	std::vector<DeferredDebugOutput> items;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(_debug_output_mutex);
+			_debug_output_cv.wait(lock, []() { return !_debug_output_queue.empty() || _debug_output_thread_exit; });
+			if (_debug_output_queue.empty()) break;
+		}
+
+		std::lock_guard<std::mutex> write_lock(_debug_output_write_mutex);
+		{
+			std::lock_guard<std::mutex> lock(_debug_output_mutex);
+			items.swap(_debug_output_queue);
+		}
+		WriteDeferredDebugOutput(items);
+		items.clear();
+	}
+
+	std::lock_guard<std::mutex> lock(_debug_output_mutex);
+	_debug_output_thread_exit = false;
+	_debug_output_done_cv.notify_all();
+}
+
+/**
+ * Start the debug output thread.
+ * While it is running, debug output to the console and log files is written by the thread,
+ * instead of by the thread which produced it.
+ */
+void DebugStartOutputThread()
+{
+	{
+		std::lock_guard<std::mutex> lock(_debug_output_mutex);
+		if (_debug_output_thread_running) return;
+	}
+
+	/* Thread startup failures are logged, so this is done without holding the lock. */
+	if (!StartNewThread(nullptr, "ottd:debug", &DebugOutputThread)) return;
+
+	std::lock_guard<std::mutex> lock(_debug_output_mutex);
+	_debug_output_thread_running = true;
+}
+
+/**
+ * Stop the debug output thread, after writing any queued output.
+ */
+void DebugStopOutputThread()
+{
+	std::unique_lock<std::mutex> lock(_debug_output_mutex);
+	if (!_debug_output_thread_running) return;
+
+	/* Any further output is written directly. */
+	_debug_output_thread_running = false;
+	_debug_output_thread_exit = true;
+	_debug_output_cv.notify_one();
+	_debug_output_done_cv.wait(lock, []() { return !_debug_output_thread_exit; });
+}
+
+/**
+ * Write any debug output which is still queued for the debug output thread.
+ * This is for use when exiting or crashing, so does not wait if the output is currently in use.
+ */
+void DebugFlushDeferredOutput()
+{
+	std::unique_lock<std::mutex> write_lock(_debug_output_write_mutex, std::try_to_lock);
+	if (!write_lock.owns_lock()) return;
+
+	std::unique_lock<std::mutex> lock(_debug_output_mutex, std::try_to_lock);
+	if (!lock.owns_lock()) return;
+
+	WriteDeferredDebugOutput(_debug_output_queue);
+	_debug_output_queue.clear();
+}
+
 /**
  * Internal function for outputting the debug line.
  * @param dbg Debug category.
@@ -160,8 +286,9 @@ void debug_print(const char *dbg, const char *buf)
 	if (strcmp(dbg, "desync") == 0) {
 		static FILE *f = FioFOpenFile("commands-out.log", "wb", AUTOSAVE_DIR);
 		if (f != nullptr) {
-			fprintf(f, "%s%s\n", GetLogPrefix(), buf);
-			fflush(f);
+			char buf2[1024 + 32];
+			seprintf(buf2, lastof(buf2), "%s%s\n", GetLogPrefix(), buf);
+			DebugWriteOutput(f, buf2, true);
 		}
 #ifdef RANDOM_DEBUG
 	} else if (strcmp(dbg, "random") == 0 || strcmp(dbg, "statecsum") == 0) {
@@ -206,10 +333,10 @@ void debug_print(const char *dbg, const char *buf)
 	 * crashing, and NetworkTextMessage includes these */
 #if defined(_WIN32)
 	if (strcmp(dbg, "desync") != 0) {
-		fputs(buffer, stderr);
+		DebugWriteOutput(stderr, buffer, false);
 	}
 #else
-	fputs(buffer, stderr);
+	DebugWriteOutput(stderr, buffer, false);
 #endif
 
 	if (_debug_remote_console.load()) {
@@ -340,7 +467,7 @@ const char *GetDebugString()
  */
 const char *GetLogPrefix()
 {
-	static char _log_prefix[24];
+	static thread_local char _log_prefix[24];
 	if (_settings_client.gui.show_date_in_logs) {
 		LocalTime::Format(_log_prefix, lastof(_log_prefix), "[%Y-%m-%d %H:%M:%S] ");
 	} else {
@@ -140,4 +140,8 @@ char *DumpDesyncMsgLog(char *buffer, const char *last);
 void DebugSendRemoteMessages();
 void DebugReconsiderSendRemoteMessages();
 
+void DebugStartOutputThread();
+void DebugStopOutputThread();
+void DebugFlushDeferredOutput();
+
 #endif /* DEBUG_H */
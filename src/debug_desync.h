@@ -22,5 +22,7 @@ enum CheckCachesFlags : uint32 {
 DECLARE_ENUM_AS_BIT_SET(CheckCachesFlags)
 
 extern void CheckCaches(bool force_check, std::function<void(const char *)> log = nullptr, CheckCachesFlags flags = CHECK_CACHE_ALL);
+extern void CheckCachesIncremental(uint budget_us);
+extern void LogStateSubsystemChecksums(std::function<void(const char *)> log, bool detail);
 
 #endif /* DEBUG_DESYNC_H */
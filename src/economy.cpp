@@ -49,6 +49,7 @@
 #include "cargomonitor.h"
 #include "goal_base.h"
 #include "story_base.h"
+#include "order_func.h"
 #include "linkgraph/refresh.h"
 #include "tracerestrict.h"
 #include "tbtr_template_vehicle.h"
@@ -1113,12 +1114,9 @@ void ForAcceptingIndustries(const Station *st, CargoID cargo_type, IndustryID so
 		Industry *ind = i.industry;
 		if (ind->index == source) continue;
 
-		uint cargo_index;
-		for (cargo_index = 0; cargo_index < lengthof(ind->accepts_cargo); cargo_index++) {
-			if (cargo_type == ind->accepts_cargo[cargo_index]) break;
-		}
 		/* Check if matching cargo has been found */
-		if (cargo_index >= lengthof(ind->accepts_cargo)) continue;
+		const int cargo_index = ind->GetCargoAcceptedIndex(cargo_type);
+		if (cargo_index < 0) continue;
 
 		/* Check if industry temporarily refuses acceptance */
 		if (IndustryTemporarilyRefusesCargo(ind, cargo_type)) continue;
@@ -1168,7 +1166,9 @@ uint DeliverGoodsToIndustryEqually(const Station *st, CargoID cargo_type, uint n
 		uint delivered;
 	};
 
-	std::vector<AcceptingIndustry> acceptingIndustries;
+	/* This is called for every delivered packet, so reuse the buffer instead of allocating each time */
+	static std::vector<AcceptingIndustry> acceptingIndustries;
+	acceptingIndustries.clear();
 
 	ForAcceptingIndustries(st, cargo_type, source, company, [&](Industry *ind, uint cargo_index) {
 		uint capacity = 0xFFFFu - ind->incoming_cargo_waiting[cargo_index];
@@ -1487,6 +1487,7 @@ void PrepareUnload(Vehicle *front_v)
 {
 	Station *curr_station = Station::Get(front_v->last_station_visited);
 	curr_station->loading_vehicles.push_back(front_v);
+	_stations_with_loading_vehicles.insert(curr_station->index);
 
 	/* At this moment loading cannot be finished */
 	ClrBit(front_v->vehicle_flags, VF_LOADING_FINISHED);
@@ -1494,6 +1495,8 @@ void PrepareUnload(Vehicle *front_v)
 	/* Start unloading at the first possible moment */
 	front_v->load_unload_ticks = 1;
 
+	InvalidateConditionalOrderCache();
+
 	assert(front_v->cargo_payment == nullptr);
 	/* One CargoPayment per vehicle and the vehicle limit equals the
 	 * limit in number of CargoPayments. Can't go wrong. */
@@ -1539,7 +1542,7 @@ static uint GetLoadAmount(Vehicle *v)
 		if (e->GetGRF() != nullptr && e->GetGRF()->grf_version >= 8) {
 			/* Use callback 36 */
 			cb_load_amount = GetVehicleProperty(v, PROP_VEHICLE_LOAD_AMOUNT, CALLBACK_FAILED);
-		} else if (HasBit(e->info.callback_mask, CBM_VEHICLE_LOAD_AMOUNT)) {
+		} else if (HasBit(e->info.callback_mask, CBM_VEHICLE_LOAD_AMOUNT) && (e->callbacks_used & SGCU_VEHICLE_LOAD_AMOUNT)) {
 			/* Use callback 12 */
 			cb_load_amount = GetVehicleCallback(CBID_VEHICLE_LOAD_AMOUNT, 0, 0, v->engine_type, v);
 		}
@@ -1810,9 +1813,15 @@ struct ReserveCargoAction {
 			if (flags & OLFB_NO_LOAD) return true;
 			if (!(flags & OLFB_FULL_LOAD) && !through_load) return true;
 		}
-		if (v->cargo_cap > v->cargo.RemainingCount() && MayLoadUnderExclusiveRights(st, v)) {
-			st->goods[v->cargo_type].cargo.Reserve(v->cargo_cap - v->cargo.RemainingCount(),
-					&v->cargo, st->xy, next_station.Get(v->cargo_type));
+		if (v->cargo_cap > v->cargo.RemainingCount()) {
+			StationCargoList &station_cargo = st->goods[v->cargo_type].cargo;
+
+			/* Nothing to reserve, this is the common case for the rest of a long consist once the waiting cargo has run out. */
+			if (station_cargo.AvailableCount() == 0) return true;
+
+			if (MayLoadUnderExclusiveRights(st, v)) {
+				station_cargo.Reserve(v->cargo_cap - v->cargo.RemainingCount(), &v->cargo, st->xy, next_station.Get(v->cargo_type));
+			}
 		}
 
 		return true;
@@ -1891,6 +1900,9 @@ static void LoadUnloadVehicle(Vehicle *front)
 {
 	assert(front->current_order.IsType(OT_LOADING));
 
+	/* The load of the vehicle may change. */
+	InvalidateConditionalOrderCache();
+
 	StationID last_visited = front->last_station_visited;
 	Station *st = Station::Get(last_visited);
 
@@ -2340,7 +2352,11 @@ static void LoadUnloadVehicle(Vehicle *front)
 	if (dirty_vehicle) {
 		DirtyVehicleListWindowForVehicle(front);
 		SetWindowDirty(WC_VEHICLE_DETAILS, front->index);
-		front->MarkDirty();
+		if (front->type == VEH_TRAIN) {
+			Train::From(front)->CargoLoadChanged();
+		} else {
+			front->MarkDirty();
+		}
 	}
 	if (dirty_station) {
 		st->MarkTilesDirty(true);
@@ -2390,6 +2406,32 @@ void LoadUnloadStation(Station *st)
 	_cargo_delivery_destinations.clear();
 }
 
+/**
+ * Load/unload the vehicles at all stations which have vehicles loading, in station index order.
+ * Stations which no longer have any loading vehicles are removed from _stations_with_loading_vehicles.
+ */
+void LoadUnloadStations()
+{
+	Station *si_st = nullptr;
+	SCOPE_INFO_FMT([&si_st], "LoadUnloadStations: %s", scope_dumper().StationInfo(si_st));
+
+	auto iter = _stations_with_loading_vehicles.begin();
+	while (iter != _stations_with_loading_vehicles.end()) {
+		const StationID id = *iter;
+		Station *st = Station::GetIfValid(id);
+		if (st == nullptr || st->loading_vehicles.empty()) {
+			iter = _stations_with_loading_vehicles.erase(iter);
+			continue;
+		}
+
+		si_st = st;
+		LoadUnloadStation(st);
+
+		/* Vehicles may start loading at other stations during the above, which invalidates the iterator */
+		iter = _stations_with_loading_vehicles.upper_bound(id);
+	}
+}
+
 /**
  * Monthly update of the economic data (of the companies as well as economic fluctuations).
  */
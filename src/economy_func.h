@@ -33,6 +33,7 @@ uint MoveGoodsToStation(CargoID type, uint amount, SourceType source_type, Sourc
 
 void PrepareUnload(Vehicle *front_v);
 void LoadUnloadStation(Station *st);
+void LoadUnloadStations();
 
 Money GetPrice(Price index, uint cost_factor, const struct GRFFile *grf_file, int shift = 0);
 
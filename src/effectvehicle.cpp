@@ -18,12 +18,23 @@
 #include "effectvehicle_base.h"
 #include "core/checksum_func.hpp"
 #include "core/container_func.hpp"
+#include "network/network.h"
 
 #include <algorithm>
 
 #include "safeguards.h"
 
 
+/**
+ * Update the sprite bounds of an effect vehicle after its sprite has changed.
+ * The bounds are only used to place the vehicle in the viewports, which dedicated servers do not track.
+ * @param v Vehicle to update.
+ */
+static inline void UpdateEffectSpriteSeqBound(EffectVehicle *v)
+{
+	if (!_network_dedicated) v->UpdateSpriteSeqBound();
+}
+
 /**
  * Increment the sprite unless it has reached the end of the animation.
  * @param v Vehicle to increment sprite of.
@@ -34,7 +45,7 @@ static bool IncrementSprite(EffectVehicle *v, SpriteID last)
 {
 	if (v->sprite_seq.seq[0].sprite != last) {
 		v->sprite_seq.seq[0].sprite++;
-		v->UpdateSpriteSeqBound();
+		UpdateEffectSpriteSeqBound(v);
 		return true;
 	} else {
 		return false;
@@ -45,7 +56,7 @@ static void ChimneySmokeInit(EffectVehicle *v)
 {
 	uint32 r = Random();
 	v->sprite_seq.Set(SPR_CHIMNEY_SMOKE_0 + GB(r, 0, 3));
-	v->UpdateSpriteSeqBound();
+	UpdateEffectSpriteSeqBound(v);
 	v->progress = GB(r, 16, 3);
 }
 
@@ -63,7 +74,7 @@ static bool ChimneySmokeTick(EffectVehicle *v)
 		if (!IncrementSprite(v, SPR_CHIMNEY_SMOKE_7)) {
 			v->sprite_seq.Set(SPR_CHIMNEY_SMOKE_0);
 		}
-		v->UpdateSpriteSeqBound();
+		UpdateEffectSpriteSeqBound(v);
 		v->progress = 7;
 		v->UpdatePositionAndViewport();
 	}
@@ -74,7 +85,7 @@ static bool ChimneySmokeTick(EffectVehicle *v)
 static void SteamSmokeInit(EffectVehicle *v)
 {
 	v->sprite_seq.Set(SPR_STEAM_SMOKE_0);
-	v->UpdateSpriteSeqBound();
+	UpdateEffectSpriteSeqBound(v);
 	v->progress = 12;
 }
 
@@ -94,7 +105,6 @@ static bool SteamSmokeTick(EffectVehicle *v)
 			delete v;
 			return false;
 		}
-		v->UpdateSpriteSeqBound();
 		moved = true;
 	}
 
@@ -106,7 +116,7 @@ static bool SteamSmokeTick(EffectVehicle *v)
 static void DieselSmokeInit(EffectVehicle *v)
 {
 	v->sprite_seq.Set(SPR_DIESEL_SMOKE_0);
-	v->UpdateSpriteSeqBound();
+	UpdateEffectSpriteSeqBound(v);
 	v->progress = 0;
 }
 
@@ -122,7 +132,6 @@ static bool DieselSmokeTick(EffectVehicle *v)
 			delete v;
 			return false;
 		}
-		v->UpdateSpriteSeqBound();
 		v->UpdatePositionAndViewport();
 	}
 
@@ -132,7 +141,7 @@ static bool DieselSmokeTick(EffectVehicle *v)
 static void ElectricSparkInit(EffectVehicle *v)
 {
 	v->sprite_seq.Set(SPR_ELECTRIC_SPARK_0);
-	v->UpdateSpriteSeqBound();
+	UpdateEffectSpriteSeqBound(v);
 	v->progress = 1;
 }
 
@@ -147,7 +156,6 @@ static bool ElectricSparkTick(EffectVehicle *v)
 			delete v;
 			return false;
 		}
-		v->UpdateSpriteSeqBound();
 		v->UpdatePositionAndViewport();
 	}
 
@@ -157,7 +165,7 @@ static bool ElectricSparkTick(EffectVehicle *v)
 static void SmokeInit(EffectVehicle *v)
 {
 	v->sprite_seq.Set(SPR_SMOKE_0);
-	v->UpdateSpriteSeqBound();
+	UpdateEffectSpriteSeqBound(v);
 	v->progress = 12;
 }
 
@@ -177,7 +185,6 @@ static bool SmokeTick(EffectVehicle *v)
 			delete v;
 			return false;
 		}
-		v->UpdateSpriteSeqBound();
 		moved = true;
 	}
 
@@ -189,7 +196,7 @@ static bool SmokeTick(EffectVehicle *v)
 static void ExplosionLargeInit(EffectVehicle *v)
 {
 	v->sprite_seq.Set(SPR_EXPLOSION_LARGE_0);
-	v->UpdateSpriteSeqBound();
+	UpdateEffectSpriteSeqBound(v);
 	v->progress = 0;
 }
 
@@ -201,7 +208,6 @@ static bool ExplosionLargeTick(EffectVehicle *v)
 			delete v;
 			return false;
 		}
-		v->UpdateSpriteSeqBound();
 		v->UpdatePositionAndViewport();
 	}
 
@@ -211,7 +217,7 @@ static bool ExplosionLargeTick(EffectVehicle *v)
 static void BreakdownSmokeInit(EffectVehicle *v)
 {
 	v->sprite_seq.Set(SPR_BREAKDOWN_SMOKE_0);
-	v->UpdateSpriteSeqBound();
+	UpdateEffectSpriteSeqBound(v);
 	v->progress = 0;
 }
 
@@ -222,7 +228,7 @@ static bool BreakdownSmokeTick(EffectVehicle *v)
 		if (!IncrementSprite(v, SPR_BREAKDOWN_SMOKE_3)) {
 			v->sprite_seq.Set(SPR_BREAKDOWN_SMOKE_0);
 		}
-		v->UpdateSpriteSeqBound();
+		UpdateEffectSpriteSeqBound(v);
 		v->UpdatePositionAndViewport();
 	}
 
@@ -238,7 +244,7 @@ static bool BreakdownSmokeTick(EffectVehicle *v)
 static void ExplosionSmallInit(EffectVehicle *v)
 {
 	v->sprite_seq.Set(SPR_EXPLOSION_SMALL_0);
-	v->UpdateSpriteSeqBound();
+	UpdateEffectSpriteSeqBound(v);
 	v->progress = 0;
 }
 
@@ -250,7 +256,6 @@ static bool ExplosionSmallTick(EffectVehicle *v)
 			delete v;
 			return false;
 		}
-		v->UpdateSpriteSeqBound();
 		v->UpdatePositionAndViewport();
 	}
 
@@ -260,7 +265,7 @@ static bool ExplosionSmallTick(EffectVehicle *v)
 static void BulldozerInit(EffectVehicle *v)
 {
 	v->sprite_seq.Set(SPR_BULLDOZER_NE);
-	v->UpdateSpriteSeqBound();
+	UpdateEffectSpriteSeqBound(v);
 	v->progress = 0;
 	v->animation_state = 0;
 	v->animation_substate = 0;
@@ -312,7 +317,7 @@ static bool BulldozerTick(EffectVehicle *v)
 		const BulldozerMovement *b = &_bulldozer_movement[v->animation_state];
 
 		v->sprite_seq.Set(SPR_BULLDOZER_NE + b->image);
-		v->UpdateSpriteSeqBound();
+		UpdateEffectSpriteSeqBound(v);
 
 		v->x_pos += _inc_by_dir[b->direction].x;
 		v->y_pos += _inc_by_dir[b->direction].y;
@@ -335,7 +340,7 @@ static bool BulldozerTick(EffectVehicle *v)
 static void BubbleInit(EffectVehicle *v)
 {
 	v->sprite_seq.Set(SPR_BUBBLE_GENERATE_0);
-	v->UpdateSpriteSeqBound();
+	UpdateEffectSpriteSeqBound(v);
 	v->spritenum = 0;
 	v->progress = 0;
 }
@@ -499,7 +504,7 @@ static bool BubbleTick(EffectVehicle *v)
 
 	if (v->spritenum == 0) {
 		v->sprite_seq.seq[0].sprite++;
-		v->UpdateSpriteSeqBound();
+		UpdateEffectSpriteSeqBound(v);
 		if (v->sprite_seq.seq[0].sprite < SPR_BUBBLE_GENERATE_3) {
 			v->UpdatePositionAndViewport();
 			return true;
@@ -546,7 +551,7 @@ static bool BubbleTick(EffectVehicle *v)
 	v->y_pos += b->y;
 	v->z_pos += b->z;
 	v->sprite_seq.Set(SPR_BUBBLE_0 + b->image);
-	v->UpdateSpriteSeqBound();
+	UpdateEffectSpriteSeqBound(v);
 
 	v->UpdatePositionAndViewport();
 
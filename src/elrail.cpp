@@ -202,6 +202,54 @@ static TrackBits MaskWireBits(TileIndex t, TrackBits tracks)
 	return (tracks & mask) != TRACK_BIT_NONE ? tracks & mask : tracks;
 }
 
+/** Electrified track bits and masked wire bits of a tile, cached while drawing a viewport area. */
+struct CatenaryTileInfo {
+	TileIndex tile;
+	uint32 generation;          ///< Value of #_catenary_tile_cache_generation when this entry was filled
+	DualTrackBits track_config; ///< Result of GetRailTrackBitsUniversal
+	TrackBits wire_config;      ///< Result of MaskWireBits for the combined track bits
+};
+
+/**
+ * Direct mapped cache of #CatenaryTileInfo.
+ * Each tile is examined once as the home tile and once as the neighbour of each adjacent tile, and MaskWireBits
+ * looks at all four of its own neighbours, so caching the result for the duration of one viewport draw avoids most of the repeated work.
+ */
+static CatenaryTileInfo _catenary_tile_cache[1024];
+static uint32 _catenary_tile_cache_generation = 1;
+
+/**
+ * Invalidate the catenary tile cache, this must be called before drawing any tiles, as the map may have changed since the previous draw.
+ */
+void InvalidateCatenaryDrawCache()
+{
+	_catenary_tile_cache_generation++;
+	if (_catenary_tile_cache_generation == 0) {
+		/* Wrapped around, make sure that no old entries can match */
+		for (CatenaryTileInfo &info : _catenary_tile_cache) {
+			info.generation = 0;
+		}
+		_catenary_tile_cache_generation = 1;
+	}
+}
+
+/**
+ * Get the electrified track bits and masked wire bits of a tile, using the catenary tile cache.
+ * @param t The tile.
+ * @return The cache entry for the tile.
+ */
+static const CatenaryTileInfo &GetCatenaryTileInfo(TileIndex t)
+{
+	CatenaryTileInfo &info = _catenary_tile_cache[(TileX(t) & 31) | ((TileY(t) & 31) << 5)];
+	if (info.tile != t || info.generation != _catenary_tile_cache_generation) {
+		info.tile = t;
+		info.generation = _catenary_tile_cache_generation;
+		info.track_config = GetRailTrackBitsUniversal(t, nullptr);
+		info.wire_config = MaskWireBits(t, info.track_config.primary | info.track_config.secondary);
+	}
+	return info;
+}
+
 /**
  * Get the base wire sprite to use.
  */
@@ -339,7 +387,7 @@ static void DrawRailCatenaryRailway(const TileInfo *ti)
 	 *    which have no middle tiles */
 	DualTrackBits home_track_config = GetRailTrackBitsUniversal(ti->tile, &OverridePCP);
 	trackconfig[TS_HOME] = home_track_config.primary | home_track_config.secondary;
-	wireconfig[TS_HOME] = MaskWireBits(ti->tile, trackconfig[TS_HOME]);
+	wireconfig[TS_HOME] = GetCatenaryTileInfo(ti->tile).wire_config;
 	/* If a track bit is present that is not in the main direction, the track is level */
 	isflat[TS_HOME] = ((trackconfig[TS_HOME] & (TRACK_BIT_HORZ | TRACK_BIT_VERT)) != 0);
 
@@ -398,9 +446,9 @@ static void DrawRailCatenaryRailway(const TileInfo *ti)
 		/* Here's one of the main headaches. GetTileSlope does not correct for possibly
 		 * existing foundataions, so we do have to do that manually later on.*/
 		tileh[TS_NEIGHBOUR] = GetTileSlope(neighbour);
-		DualTrackBits neighbour_track_config = GetRailTrackBitsUniversal(neighbour, nullptr);
-		trackconfig[TS_NEIGHBOUR] = neighbour_track_config.primary | neighbour_track_config.secondary;
-		wireconfig[TS_NEIGHBOUR] = MaskWireBits(neighbour, trackconfig[TS_NEIGHBOUR]);
+		const CatenaryTileInfo &neighbour_info = GetCatenaryTileInfo(neighbour);
+		trackconfig[TS_NEIGHBOUR] = neighbour_info.track_config.primary | neighbour_info.track_config.secondary;
+		wireconfig[TS_NEIGHBOUR] = neighbour_info.wire_config;
 		if (IsTunnelTile(neighbour) && i != GetTunnelBridgeDirection(neighbour)) wireconfig[TS_NEIGHBOUR] = trackconfig[TS_NEIGHBOUR] = TRACK_BIT_NONE;
 
 		/* Ignore station tiles that allow neither wires nor pylons. */
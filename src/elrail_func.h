@@ -35,6 +35,7 @@ static inline bool HasRailCatenaryDrawn(RailType rt, RailType secondary = INVALI
 void DrawRailCatenary(const TileInfo *ti);
 void DrawRailCatenaryOnTunnel(const TileInfo *ti);
 void DrawRailCatenaryOnBridge(const TileInfo *ti);
+void InvalidateCatenaryDrawCache();
 
 void SettingsDisableElrail(int32 new_value); ///< _settings_game.disable_elrail callback
 
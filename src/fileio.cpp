@@ -1039,6 +1039,8 @@ void DeterminePaths(const char *exe, bool only_local_path)
 	_private_file = config_dir + "private.cfg";
 	extern std::string _secrets_file;
 	_secrets_file = config_dir + "secrets.cfg";
+	extern std::string _grf_md5_cache_file;
+	_grf_md5_cache_file = config_dir + "grf_md5.cache";
 
 #ifdef USE_XDG
 	if (config_dir == config_home) {
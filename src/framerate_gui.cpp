@@ -18,6 +18,7 @@
 #include "console_func.h"
 #include "console_type.h"
 #include "guitimer_func.h"
+#include "spritecache.h"
 #include "company_base.h"
 #include "ai/ai_info.hpp"
 #include "ai/ai_instance.hpp"
@@ -71,6 +72,12 @@ namespace {
 		/** Start time for current accumulation cycle */
 		TimingMeasurement acc_timestamp;
 
+		/** If not nullptr, every completed measurement is also appended here, see #StartPerformanceBenchmark */
+		std::vector<TimingMeasurement> *benchmark_samples = nullptr;
+
+		/** All completed measurements since the last #ResetLatencyHistograms */
+		LatencyHistogram histogram;
+
 		/**
 		 * Initialize a data element with an expected collection rate
 		 * @param expected_rate
@@ -84,6 +91,8 @@ namespace {
 		{
 			this->durations[this->next_index] = end_time - start_time;
 			this->timestamps[this->next_index] = start_time;
+			if (this->benchmark_samples != nullptr) this->benchmark_samples->push_back(end_time - start_time);
+			this->histogram.Add((end_time - start_time) * 1000000 / TIMESTAMP_PRECISION);
 			this->prev_index = this->next_index;
 			this->next_index += 1;
 			if (this->next_index >= NUM_FRAMERATE_POINTS) this->next_index = 0;
@@ -95,6 +104,8 @@ namespace {
 		{
 			this->timestamps[this->next_index] = this->acc_timestamp;
 			this->durations[this->next_index] = this->acc_duration;
+			if (this->benchmark_samples != nullptr) this->benchmark_samples->push_back(this->acc_duration);
+			this->histogram.Add(this->acc_duration * 1000000 / TIMESTAMP_PRECISION);
 			this->prev_index = this->next_index;
 			this->next_index += 1;
 			if (this->next_index >= NUM_FRAMERATE_POINTS) this->next_index = 0;
@@ -192,10 +203,19 @@ namespace {
 		PerformanceData(1),                     // PFE_GAMELOOP
 		PerformanceData(1),                     // PFE_ACC_GL_ECONOMY
 		PerformanceData(1),                     // PFE_ACC_GL_TRAINS
+		PerformanceData(1),                     // PFE_ACC_GL_TRAIN_PF
+		PerformanceData(1),                     // PFE_ACC_GL_SIGNALS
 		PerformanceData(1),                     // PFE_ACC_GL_ROADVEHS
+		PerformanceData(1),                     // PFE_ACC_GL_ROADVEH_PF
 		PerformanceData(1),                     // PFE_ACC_GL_SHIPS
+		PerformanceData(1),                     // PFE_ACC_GL_SHIP_PF
 		PerformanceData(1),                     // PFE_ACC_GL_AIRCRAFT
 		PerformanceData(1),                     // PFE_GL_LANDSCAPE
+		PerformanceData(1),                     // PFE_ACC_GL_TILELOOP
+		PerformanceData(1),                     // PFE_ACC_GL_ANIMATION
+		PerformanceData(1),                     // PFE_ACC_GL_TOWNS
+		PerformanceData(1),                     // PFE_ACC_GL_INDUSTRIES
+		PerformanceData(1),                     // PFE_ACC_GL_STATIONS
 		PerformanceData(1),                     // PFE_GL_LINKGRAPH
 		PerformanceData(1000.0 / 30),           // PFE_DRAWING
 		PerformanceData(1),                     // PFE_ACC_DRAWWORLD
@@ -220,6 +240,12 @@ namespace {
 		PerformanceData(1),                     // PFE_AI14
 	};
 
+	/** Histograms of the types after the performance elements, see #LatencyHistogramType */
+	LatencyHistogram _extra_latency_histograms[LHT_END - PFE_MAX];
+
+	/** Time of the last #ResetLatencyHistograms */
+	std::chrono::steady_clock::time_point _latency_histogram_start = std::chrono::steady_clock::now();
+
 }
 
 
@@ -324,6 +350,151 @@ void PerformanceAccumulator::Reset(PerformanceElement elem)
 }
 
 
+/**
+ * Get the bucket of a duration.
+ * @param duration_us The duration, in microseconds.
+ * @return The bucket.
+ */
+/* static */ uint LatencyHistogram::GetBucket(uint64 duration_us)
+{
+	if (duration_us < SUB_BUCKETS) return (uint)duration_us;
+	duration_us = std::min<uint64>(duration_us, UINT32_MAX);
+	const uint shift = FindLastBit(duration_us) - SUB_BUCKET_BITS;
+	return shift * SUB_BUCKETS + (uint)(duration_us >> shift);
+}
+
+/**
+ * Get the shortest duration in a bucket.
+ * @param bucket The bucket.
+ * @return The duration, in microseconds.
+ */
+/* static */ uint64 LatencyHistogram::GetBucketLowerBound(uint bucket)
+{
+	if (bucket < SUB_BUCKETS) return bucket;
+	const uint shift = bucket / SUB_BUCKETS - 1;
+	return (uint64)(bucket % SUB_BUCKETS + SUB_BUCKETS) << shift;
+}
+
+/**
+ * Add a measurement.
+ * @param duration_us The duration, in microseconds.
+ */
+void LatencyHistogram::Add(uint64 duration_us)
+{
+	this->counts[GetBucket(duration_us)]++;
+	this->count++;
+	this->sum_us += duration_us;
+	this->max_us = std::max(this->max_us, duration_us);
+}
+
+/**
+ * Get an upper bound of a percentile of the measurements.
+ * @param fraction The percentile, between 0 and 1.
+ * @return The end of the bucket containing the percentile, limited to the longest measurement, in microseconds.
+ */
+uint64 LatencyHistogram::GetPercentile(double fraction) const
+{
+	if (this->count == 0) return 0;
+	const uint64 target = std::max<uint64>(1, (uint64)(fraction * this->count + 0.5));
+	uint64 seen = 0;
+	for (uint bucket = 0; bucket < BUCKETS; bucket++) {
+		seen += this->counts[bucket];
+		if (seen >= target) {
+			const uint64 end = bucket + 1 < BUCKETS ? GetBucketLowerBound(bucket + 1) - 1 : this->max_us;
+			return std::min(end, this->max_us);
+		}
+	}
+	return this->max_us;
+}
+
+/**
+ * Count the measurements of at least a duration.
+ * @param duration_us The duration, in microseconds. Measurements are counted per bucket, so this is rounded down to the start of its bucket.
+ * @return The number of measurements.
+ */
+uint64 LatencyHistogram::CountAtLeast(uint64 duration_us) const
+{
+	uint64 result = 0;
+	for (uint bucket = GetBucket(duration_us); bucket < BUCKETS; bucket++) {
+		result += this->counts[bucket];
+	}
+	return result;
+}
+
+/**
+ * Start measuring a duration for a latency histogram.
+ * @param type The histogram, which must not be one of a performance element.
+ */
+LatencyMeasurer::LatencyMeasurer(LatencyHistogramType type)
+{
+	assert(type >= LHT_AUTOSAVE && type < LHT_END);
+
+	this->type = type;
+	this->start_time = GetPerformanceTimer();
+}
+
+/** Finish measuring and add the duration to the histogram. */
+LatencyMeasurer::~LatencyMeasurer()
+{
+	_extra_latency_histograms[this->type - LHT_AUTOSAVE].Add((GetPerformanceTimer() - this->start_time) * 1000000 / TIMESTAMP_PRECISION);
+}
+
+/**
+ * Get a latency histogram.
+ * @param type The histogram.
+ * @return The histogram.
+ */
+const LatencyHistogram &GetLatencyHistogram(LatencyHistogramType type)
+{
+	assert(type < LHT_END);
+	if (type < LHT_AUTOSAVE) return _pf_data[type].histogram;
+	return _extra_latency_histograms[type - LHT_AUTOSAVE];
+}
+
+/** Identifiers of the performance elements in reports, the AIs are numbered instead. */
+static const char * const _pf_element_ids[PFE_AI0] = {
+	"gameloop", "gl_economy", "gl_trains", "gl_train_pf", "gl_signals", "gl_roadvehs", "gl_roadveh_pf", "gl_ships", "gl_ship_pf", "gl_aircraft",
+	"gl_landscape", "gl_tileloop", "gl_animation", "gl_towns", "gl_industries", "gl_stations", "gl_linkgraph",
+	"drawing", "drawworld", "video", "sound", "allscripts", "gamescript",
+};
+
+/**
+ * Get the identifier of a latency histogram in reports.
+ * @param type The histogram.
+ * @return The identifier, e.g. "gameloop" or "autosave".
+ */
+const char *GetLatencyHistogramName(LatencyHistogramType type)
+{
+	static const char * const AI_IDS[] = {
+		"ai0", "ai1", "ai2", "ai3", "ai4", "ai5", "ai6", "ai7", "ai8", "ai9", "ai10", "ai11", "ai12", "ai13", "ai14",
+	};
+	static_assert(lengthof(AI_IDS) == PFE_MAX - PFE_AI0);
+	static const char * const EXTRA_IDS[] = { "autosave", "linkgraph_join", "command" };
+	static_assert(lengthof(EXTRA_IDS) == LHT_END - PFE_MAX);
+
+	if (type < LHT_ELEMENT_FIRST + PFE_AI0) return _pf_element_ids[type];
+	if (type < LHT_AUTOSAVE) return AI_IDS[type - PFE_AI0];
+	return EXTRA_IDS[type - LHT_AUTOSAVE];
+}
+
+/**
+ * Get the time over which the latency histograms have been recorded.
+ * @return The number of seconds since the last #ResetLatencyHistograms, or since the game started.
+ */
+uint64 GetLatencyHistogramSeconds()
+{
+	return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - _latency_histogram_start).count();
+}
+
+/** Discard all measurements of the latency histograms. */
+void ResetLatencyHistograms()
+{
+	for (PerformanceData &pf : _pf_data) pf.histogram = {};
+	for (LatencyHistogram &histogram : _extra_latency_histograms) histogram = {};
+	_latency_histogram_start = std::chrono::steady_clock::now();
+}
+
+
 void ShowFrametimeGraphWindow(PerformanceElement elem);
 
 
@@ -331,10 +502,19 @@ static const PerformanceElement DISPLAY_ORDER_PFE[PFE_MAX] = {
 	PFE_GAMELOOP,
 	PFE_GL_ECONOMY,
 	PFE_GL_TRAINS,
+	PFE_GL_TRAIN_PF,
+	PFE_GL_SIGNALS,
 	PFE_GL_ROADVEHS,
+	PFE_GL_ROADVEH_PF,
 	PFE_GL_SHIPS,
+	PFE_GL_SHIP_PF,
 	PFE_GL_AIRCRAFT,
 	PFE_GL_LANDSCAPE,
+	PFE_GL_TILELOOP,
+	PFE_GL_ANIMATION,
+	PFE_GL_TOWNS,
+	PFE_GL_INDUSTRIES,
+	PFE_GL_STATIONS,
 	PFE_ALLSCRIPTS,
 	PFE_GAMESCRIPT,
 	PFE_AI0,
@@ -365,6 +545,42 @@ static const char * GetAIName(int ai_index)
 	return Company::Get(ai_index)->ai_info->GetName();
 }
 
+/**
+ * Check whether the script of a performance element is limited by its time budget.
+ * @param e The performance element.
+ * @return True if the element is a script which is currently throttled.
+ */
+static bool IsScriptThrottled(PerformanceElement e)
+{
+	if (e == PFE_GAMESCRIPT) return Game::GetInstance() != nullptr && Game::GetInstance()->IsThrottled();
+	if (e < PFE_AI0 || !Company::IsValidAiID(e - PFE_AI0)) return false;
+	const ScriptInstance *instance = Company::Get(e - PFE_AI0)->ai_instance;
+	return instance != nullptr && instance->IsThrottled();
+}
+
+/**
+ * Set the string parameters for the name of a performance element.
+ * @param e The performance element.
+ * @param throttled Whether to mark the element as a throttled script.
+ * @return The string to draw the name with.
+ */
+static StringID SetElementNameParams(PerformanceElement e, bool throttled)
+{
+	StringID str;
+	uint offset = throttled ? 1 : 0;
+	if (e < PFE_AI0) {
+		str = STR_FRAMERATE_GAMELOOP + e;
+	} else {
+		str = STR_FRAMERATE_AI;
+		SetDParam(offset, e - PFE_AI0 + 1);
+		SetDParamStr(offset + 1, GetAIName(e - PFE_AI0));
+	}
+	if (!throttled) return str;
+
+	SetDParam(0, str);
+	return STR_FRAMERATE_SCRIPT_THROTTLED;
+}
+
 /** @hideinitializer */
 static const NWidgetPart _framerate_window_widgets[] = {
 	NWidget(NWID_HORIZONTAL),
@@ -566,14 +782,7 @@ struct FramerateWindow : Window {
 				resize->height = FONT_HEIGHT_NORMAL;
 				for (PerformanceElement e : DISPLAY_ORDER_PFE) {
 					if (_pf_data[e].num_valid == 0) continue;
-					Dimension line_size;
-					if (e < PFE_AI0) {
-						line_size = GetStringBoundingBox(STR_FRAMERATE_GAMELOOP + e);
-					} else {
-						SetDParam(0, e - PFE_AI0 + 1);
-						SetDParamStr(1, GetAIName(e - PFE_AI0));
-						line_size = GetStringBoundingBox(STR_FRAMERATE_AI);
-					}
+					Dimension line_size = GetStringBoundingBox(SetElementNameParams(e, e == PFE_GAMESCRIPT || e >= PFE_AI0));
 					size->width = std::max(size->width, line_size.width);
 				}
 				break;
@@ -663,13 +872,7 @@ struct FramerateWindow : Window {
 					if (skip > 0) {
 						skip--;
 					} else {
-						if (e < PFE_AI0) {
-							DrawString(r.left, r.right, y, STR_FRAMERATE_GAMELOOP + e, TC_FROMSTRING, SA_LEFT);
-						} else {
-							SetDParam(0, e - PFE_AI0 + 1);
-							SetDParamStr(1, GetAIName(e - PFE_AI0));
-							DrawString(r.left, r.right, y, STR_FRAMERATE_AI, TC_FROMSTRING, SA_LEFT);
-						}
+						DrawString(r.left, r.right, y, SetElementNameParams(e, IsScriptThrottled(e)), TC_FROMSTRING, SA_LEFT);
 						y += FONT_HEIGHT_NORMAL;
 						drawable--;
 						if (drawable == 0) break;
@@ -1033,6 +1236,91 @@ void ShowFrametimeGraphWindow(PerformanceElement elem)
 }
 
 /** Print performance statistics to game console */
+/**
+ * Exclusive upper bounds in microseconds of the duration histogram buckets of #PerformanceElementSummary.
+ * The last bucket, which has no upper bound, is not listed.
+ */
+const uint32 _performance_histogram_bounds_us[PERFORMANCE_HISTOGRAM_BUCKETS - 1] = { 1000, 2000, 5000, 10000, 20000, 30000, 50000 };
+
+/**
+ * Summarise the recorded measurements of a performance element.
+ * @param elem The performance element.
+ * @return The summary.
+ */
+PerformanceElementSummary GetPerformanceElementSummary(PerformanceElement elem)
+{
+	PerformanceData &pf = _pf_data[elem];
+
+	PerformanceElementSummary summary{};
+	summary.num_valid = pf.num_valid;
+	if (pf.num_valid == 0) return summary;
+
+	summary.rate = pf.GetRate();
+	summary.expected_rate = pf.expected_rate;
+	summary.average_ms = pf.GetAverageDurationMilliseconds(NUM_FRAMERATE_POINTS);
+
+	TimingMeasurement peak = 0;
+	const int count = std::min(pf.num_valid, NUM_FRAMERATE_POINTS);
+	for (int i = 0; i < count; i++) {
+		const TimingMeasurement duration = pf.durations[i];
+		if (duration == PerformanceData::INVALID_DURATION) continue;
+		peak = std::max(peak, duration);
+
+		const uint64 duration_us = duration * 1000000 / TIMESTAMP_PRECISION;
+		const uint32 *bound = std::upper_bound(std::begin(_performance_histogram_bounds_us), std::end(_performance_histogram_bounds_us), duration_us);
+		summary.histogram[bound - std::begin(_performance_histogram_bounds_us)]++;
+	}
+	summary.peak_ms = (double)peak * 1000 / TIMESTAMP_PRECISION;
+
+	return summary;
+}
+
+/** Measurements recorded per performance element while a benchmark is running. */
+static std::vector<TimingMeasurement> _pf_benchmark_samples[PFE_MAX];
+
+/** Start recording every measurement of every performance element, until #StopPerformanceBenchmark is called. */
+void StartPerformanceBenchmark()
+{
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
+		_pf_benchmark_samples[e].clear();
+		_pf_data[e].benchmark_samples = &_pf_benchmark_samples[e];
+	}
+}
+
+/**
+ * Stop recording measurements for a benchmark and summarise them.
+ * @return JSON array with the number of measurements, the total, mean, 50th/90th/99th percentile and maximum duration per measured element.
+ */
+std::string StopPerformanceBenchmark()
+{
+	auto to_ms = [](TimingMeasurement t) -> double { return (double)t * 1000 / TIMESTAMP_PRECISION; };
+
+	std::string result = "[";
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
+		_pf_data[e].benchmark_samples = nullptr;
+		std::vector<TimingMeasurement> &samples = _pf_benchmark_samples[e];
+		if (samples.empty()) continue;
+
+		std::sort(samples.begin(), samples.end());
+		TimingMeasurement total = 0;
+		for (TimingMeasurement t : samples) total += t;
+		auto percentile = [&](uint p) -> TimingMeasurement {
+			return samples[std::min<size_t>(samples.size() - 1, (samples.size() * p) / 100)];
+		};
+
+		const char *id = GetLatencyHistogramName((LatencyHistogramType)e);
+		if (result.size() > 1) result += ",";
+		result += stdstr_fmt("\n    { \"element\": \"%s\", \"count\": " PRINTF_SIZE ", \"total_ms\": %.3f, \"mean_ms\": %.4f, \"p50_ms\": %.4f, \"p90_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f }",
+				id, samples.size(), to_ms(total), to_ms(total) / samples.size(),
+				to_ms(percentile(50)), to_ms(percentile(90)), to_ms(percentile(99)), to_ms(samples.back()));
+
+		samples.clear();
+		samples.shrink_to_fit();
+	}
+	result += "\n  ]";
+	return result;
+}
+
 void ConPrintFramerate()
 {
 	const int count1 = NUM_FRAMERATE_POINTS / 8;
@@ -1045,10 +1333,19 @@ void ConPrintFramerate()
 		"Game loop",
 		"  GL station ticks",
 		"  GL train ticks",
+		"    GL train pathfinding",
+		"    GL signal updates",
 		"  GL road vehicle ticks",
+		"    GL road vehicle pathfinding",
 		"  GL ship ticks",
+		"    GL ship pathfinding",
 		"  GL aircraft ticks",
 		"  GL landscape ticks",
+		"    GL tile loop",
+		"    GL tile animation",
+		"    GL town ticks",
+		"    GL industry ticks",
+		"    GL station ticks",
 		"  GL link graph delays",
 		"Drawing",
 		"  Viewport drawing",
@@ -1094,6 +1391,12 @@ void ConPrintFramerate()
 	if (!printed_anything) {
 		IConsoleWarning("No performance measurements have been taken yet");
 	}
+
+	const SpriteCacheStats sc_stats = GetSpriteCacheStats();
+	const uint64 sc_requests = sc_stats.hits + sc_stats.misses;
+	IConsolePrintF(TC_SILVER, "Sprite cache: " PRINTF_SIZE " KiB in use of " PRINTF_SIZE " KiB target", sc_stats.bytes_used / 1024, sc_stats.target_size / 1024);
+	IConsolePrintF(TC_SILVER, "  hits: " OTTD_PRINTF64U ", misses: " OTTD_PRINTF64U " (%.2f%% hit rate), evictions: " OTTD_PRINTF64U " (" OTTD_PRINTF64U " KiB)",
+			sc_stats.hits, sc_stats.misses, sc_requests > 0 ? (100.0 * sc_stats.hits) / sc_requests : 0.0, sc_stats.evictions, sc_stats.evicted_bytes / 1024);
 }
 
 void ProcessPendingPerformanceMeasurements()
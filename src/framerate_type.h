@@ -37,6 +37,7 @@
 
 #include "stdafx.h"
 #include "core/enum_type.hpp"
+#include <array>
 
 /**
  * Elements of game performance that can be measured.
@@ -49,10 +50,19 @@ enum PerformanceElement {
 	PFE_GAMELOOP = 0,  ///< Speed of gameloop processing.
 	PFE_GL_ECONOMY,    ///< Time spent processing cargo movement
 	PFE_GL_TRAINS,     ///< Time spent processing trains
+	PFE_GL_TRAIN_PF,   ///< Time spent pathfinding for trains
+	PFE_GL_SIGNALS,    ///< Time spent updating signal blocks
 	PFE_GL_ROADVEHS,   ///< Time spend processing road vehicles
+	PFE_GL_ROADVEH_PF, ///< Time spent pathfinding for road vehicles
 	PFE_GL_SHIPS,      ///< Time spent processing ships
+	PFE_GL_SHIP_PF,    ///< Time spent pathfinding for ships
 	PFE_GL_AIRCRAFT,   ///< Time spent processing aircraft
 	PFE_GL_LANDSCAPE,  ///< Time spent processing other world features
+	PFE_GL_TILELOOP,   ///< Time spent in the tile loop, including the auxiliary flooding loop
+	PFE_GL_ANIMATION,  ///< Time spent animating tiles
+	PFE_GL_TOWNS,      ///< Time spent processing town ticks
+	PFE_GL_INDUSTRIES, ///< Time spent processing industry ticks
+	PFE_GL_STATIONS,   ///< Time spent processing station ticks, including station ratings
 	PFE_GL_LINKGRAPH,  ///< Time spent waiting for link graph background jobs
 	PFE_DRAWING,       ///< Speed of drawing world and GUI.
 	PFE_DRAWWORLD,     ///< Time spent drawing world viewports in GUI
@@ -120,7 +130,73 @@ public:
 	static void Reset(PerformanceElement elem);
 };
 
+/** Number of buckets in the duration histogram of #PerformanceElementSummary. */
+/** Types of duration histograms, see #LatencyHistogram. */
+enum LatencyHistogramType {
+	LHT_ELEMENT_FIRST = 0,  ///< Histograms of the performance elements, the element is the offset from this.
+	LHT_AUTOSAVE = PFE_MAX, ///< Autosaves, until the save has been handed over to the save thread.
+	LHT_LINKGRAPH_JOIN,     ///< Waits for link graph job threads to finish.
+	LHT_COMMAND,            ///< Command execution, including the test run.
+	LHT_END,                ///< End of enum, must be last.
+};
+DECLARE_POSTFIX_INCREMENT(LatencyHistogramType)
+
+/**
+ * Histogram of durations since the last #ResetLatencyHistograms.
+ * The buckets are exact below #SUB_BUCKETS microseconds, above that each power of two is split into #SUB_BUCKETS buckets,
+ * giving a relative precision of about 6% up to about 71 minutes. Adding a measurement takes constant time and does not
+ * allocate, so the histograms are always recorded.
+ */
+struct LatencyHistogram {
+	static const uint SUB_BUCKET_BITS = 4;                                     ///< Number of bits of precision of the buckets.
+	static const uint SUB_BUCKETS = 1 << SUB_BUCKET_BITS;                      ///< Number of buckets per power of two.
+	static const uint BUCKETS = (32 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;      ///< Total number of buckets.
+
+	std::array<uint64, BUCKETS> counts = {}; ///< Number of measurements per bucket.
+	uint64 count = 0;                        ///< Total number of measurements.
+	uint64 sum_us = 0;                       ///< Sum of all measurements, in microseconds.
+	uint64 max_us = 0;                       ///< Longest measurement, in microseconds.
+
+	static uint GetBucket(uint64 duration_us);
+	static uint64 GetBucketLowerBound(uint bucket);
+	void Add(uint64 duration_us);
+	uint64 GetPercentile(double fraction) const;
+	uint64 CountAtLeast(uint64 duration_us) const;
+};
+
+/**
+ * RAII class for recording the duration of a scope in one of the additional latency histograms.
+ * Only use this on the game thread.
+ */
+class LatencyMeasurer {
+	LatencyHistogramType type;
+	TimingMeasurement start_time;
+public:
+	LatencyMeasurer(LatencyHistogramType type);
+	~LatencyMeasurer();
+};
+
+static const uint PERFORMANCE_HISTOGRAM_BUCKETS = 8;
+extern const uint32 _performance_histogram_bounds_us[PERFORMANCE_HISTOGRAM_BUCKETS - 1];
+
+/** Summary of the recorded measurements of a performance element. */
+struct PerformanceElementSummary {
+	uint num_valid;       ///< Number of recorded measurements, 0 when the element has not been measured yet.
+	double rate;          ///< Current rate, in cycles per second.
+	double expected_rate; ///< Expected rate, in cycles per second.
+	double average_ms;    ///< Average duration of the recorded measurements, in milliseconds.
+	double peak_ms;       ///< Longest duration of the recorded measurements, in milliseconds.
+	std::array<uint32, PERFORMANCE_HISTOGRAM_BUCKETS> histogram; ///< Number of recorded measurements per bucket of #_performance_histogram_bounds_us.
+};
+
 void ShowFramerateWindow();
 void ProcessPendingPerformanceMeasurements();
+PerformanceElementSummary GetPerformanceElementSummary(PerformanceElement elem);
+void StartPerformanceBenchmark();
+std::string StopPerformanceBenchmark();
+const LatencyHistogram &GetLatencyHistogram(LatencyHistogramType type);
+const char *GetLatencyHistogramName(LatencyHistogramType type);
+uint64 GetLatencyHistogramSeconds();
+void ResetLatencyHistograms();
 
 #endif /* FRAMERATE_TYPE_H */
@@ -36,6 +36,7 @@
 #include "tgp.h"
 #include "signal_func.h"
 #include "newgrf_industrytiles.h"
+#include "worker_thread.h"
 
 #include "safeguards.h"
 
@@ -233,6 +234,56 @@ void GenerateWorldSetCallback(GWDoneProc *proc)
 	_gw.proc = proc;
 }
 
+/**
+ * Get the part of a number of random placements over the whole map which falls in a band of map rows.
+ * The parts of all bands add up to the total.
+ * @param total Number of placements over the whole map.
+ * @param y_begin The first row of the band.
+ * @param y_end The row past the last row of the band.
+ * @return The number of placements in the band.
+ */
+uint GetGenerateWorldBandShare(uint total, uint y_begin, uint y_end)
+{
+	const uint64 rows = MapSizeY();
+	return (uint)((total * (uint64)y_end) / rows - (total * (uint64)y_begin) / rows);
+}
+
+/**
+ * Run a map generation pass over bands of #GENWORLD_BAND_ROWS map rows, in parallel on the worker pool.
+ * Each band has its own random number generator, seeded from a single draw of the game random number generator
+ * and the index of the band, so the generated map does not depend on the number of worker threads.
+ * The even bands are processed first, then the odd bands. This way a band may read and write tiles up to
+ * #GENWORLD_BAND_MARGIN rows outside of itself, without racing the other bands which are processed at the same time.
+ * Tiles are not marked dirty, the whole screen is redrawn when the map generation is done.
+ * @param cls The progress class, it is increased after each of the two phases.
+ * @param proc The function to call for each band.
+ */
+void RunGenerateWorldBandPass(GenWorldProgress cls, GenerateWorldBandProc proc)
+{
+	const uint32 seed = Random();
+	const uint bands = CeilDiv(MapSizeY(), GENWORLD_BAND_ROWS);
+
+	auto run_band = [&](uint band) {
+		Randomizer random;
+		random.SetSeed(seed + band * 0x9E3779B9);
+		const uint y_begin = band * GENWORLD_BAND_ROWS;
+		proc(y_begin, std::min(MapSizeY(), y_begin + GENWORLD_BAND_ROWS), random);
+	};
+
+	for (uint phase = 0; phase < 2; phase++) {
+		const uint count = (bands + 1 - phase) / 2;
+		if (_general_worker_pool.GetWorkerCount() == 0 || count <= 1) {
+			for (uint i = 0; i < count; i++) run_band(i * 2 + phase);
+		} else {
+			WorkerTaskGroup group;
+			group.ParallelFor(0, count, 1, [&](size_t i) {
+				run_band((uint)i * 2 + phase);
+			});
+		}
+		IncreaseGeneratingWorldProgress(cls);
+	}
+}
+
 /**
  * Set here the function, if any, that you want to be called when landscape
  * generation is aborted.
@@ -11,6 +11,7 @@
 #define GENWORLD_H
 
 #include "company_type.h"
+#include <functional>
 #include <thread>
 #if defined(__MINGW32__)
 #include "3rdparty/mingw-std-threads/mingw.thread.h"
@@ -86,7 +87,25 @@ enum GenWorldProgress {
 	GWP_CLASS_COUNT
 };
 
+/** Number of map rows in a band of #RunGenerateWorldBandPass. */
+static const uint GENWORLD_BAND_ROWS = 64;
+/** Number of map rows outside of its band that a band of #RunGenerateWorldBandPass may access. */
+static const uint GENWORLD_BAND_MARGIN = 24;
+static_assert(2 * GENWORLD_BAND_MARGIN < GENWORLD_BAND_ROWS);
+
+struct Randomizer;
+
+/**
+ * Function of a map generation pass, called for each band of map rows by #RunGenerateWorldBandPass.
+ * @param y_begin The first row of the band.
+ * @param y_end The row past the last row of the band.
+ * @param random The random number generator of the band.
+ */
+using GenerateWorldBandProc = std::function<void(uint y_begin, uint y_end, Randomizer &random)>;
+
 /* genworld.cpp */
+uint GetGenerateWorldBandShare(uint total, uint y_begin, uint y_end);
+void RunGenerateWorldBandPass(GenWorldProgress cls, GenerateWorldBandProc proc);
 void GenerateWorldSetCallback(GWDoneProc *proc);
 void GenerateWorldSetAbortCallback(GWAbortProc *proc);
 void GenerateWorld(GenWorldMode mode, uint size_x, uint size_y, bool reset_settings = true);
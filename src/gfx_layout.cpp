@@ -16,6 +16,8 @@
 
 #include "table/control_codes.h"
 
+#include <algorithm>
+
 #ifdef WITH_ICU_LX
 #include <unicode/ustring.h>
 #endif /* WITH_ICU_LX */
@@ -33,6 +35,7 @@
 
 /** Cache of ParagraphLayout lines. */
 Layouter::LineCache *Layouter::linecache;
+uint64 Layouter::linecache_use_counter = 0;
 
 /** Cache of Font instances. */
 Layouter::FontColourMap Layouter::fonts[FS_END];
@@ -894,8 +897,11 @@ Layouter::LineCacheItem &Layouter::GetCachedParagraphLayout(const char *str, siz
 		linecache = new LineCache();
 	}
 
+	linecache_use_counter++;
+
 	if (auto match = linecache->find(LineCacheQuery{state, std::string_view{str, len}});
 		match != linecache->end()) {
+		match->second.last_used = linecache_use_counter;
 		return match->second;
 	}
 
@@ -903,7 +909,9 @@ Layouter::LineCacheItem &Layouter::GetCachedParagraphLayout(const char *str, siz
 	LineCacheKey key;
 	key.state_before = state;
 	key.str.assign(str, len);
-	return (*linecache)[key];
+	LineCacheItem &item = (*linecache)[key];
+	item.last_used = linecache_use_counter;
+	return item;
 }
 
 /**
@@ -914,13 +922,31 @@ void Layouter::ResetLineCache()
 	if (linecache != nullptr) linecache->clear();
 }
 
+static const size_t LINE_CACHE_MAX_SIZE = 4096;    ///< Number of lines in the linecache above which it is reduced.
+static const size_t LINE_CACHE_TARGET_SIZE = 3072; ///< Number of lines to keep in the linecache when it is reduced.
+
 /**
  * Reduce the size of linecache if necessary to prevent infinite growth.
  */
 void Layouter::ReduceLineCache()
 {
-	if (linecache != nullptr) {
-		/* TODO LRU cache would be fancy, but not exactly necessary */
-		if (linecache->size() > 4096) ResetLineCache();
+	if (linecache != nullptr && linecache->size() > LINE_CACHE_MAX_SIZE) {
+		/* Evict the least recently used lines, instead of dropping the whole cache. */
+		std::vector<uint64> last_used;
+		last_used.reserve(linecache->size());
+		for (const auto &it : *linecache) {
+			last_used.push_back(it.second.last_used);
+		}
+		const size_t evict = linecache->size() - LINE_CACHE_TARGET_SIZE;
+		std::nth_element(last_used.begin(), last_used.begin() + evict, last_used.end());
+		const uint64 threshold = last_used[evict];
+
+		for (auto it = linecache->begin(); it != linecache->end();) {
+			if (it->second.last_used < threshold) {
+				it = linecache->erase(it);
+			} else {
+				++it;
+			}
+		}
 	}
 }
@@ -187,13 +187,15 @@ public:
 
 		FontState state_after;     ///< Font state after the line.
 		ParagraphLayouter *layout; ///< Layout of the line.
+		uint64 last_used;          ///< Value of #Layouter::linecache_use_counter when the line was last used, for LRU eviction.
 
-		LineCacheItem() : buffer(nullptr), layout(nullptr) {}
+		LineCacheItem() : buffer(nullptr), layout(nullptr), last_used(0) {}
 		~LineCacheItem() { delete layout; free(buffer); }
 	};
 private:
 	typedef std::map<LineCacheKey, LineCacheItem, LineCacheCompare> LineCache;
 	static LineCache *linecache;
+	static uint64 linecache_use_counter;
 
 	static LineCacheItem &GetCachedParagraphLayout(const char *str, size_t len, const FontState &state);
 
@@ -66,6 +66,7 @@ void GroundVehicle<T, Type>::PowerChanged()
 	}
 
 	this->gcache.cached_max_track_speed = max_track_speed;
+	this->InvalidateAccelerationCache();
 }
 
 template <class T, VehicleType Type>
@@ -99,6 +100,19 @@ void GroundVehicle<T, Type>::CalculatePower(uint32& total_power, uint32& max_te,
  */
 template <class T, VehicleType Type>
 void GroundVehicle<T, Type>::CargoChanged()
+{
+	this->CargoWeightChanged();
+
+	/* Now update vehicle power (tractive effort is dependent on weight). */
+	this->PowerChanged();
+}
+
+/**
+ * Recalculates the cached weight, weight dependent resistances and centre of mass of a vehicle and its parts.
+ * This does not update the cached power and tractive effort, use #CargoChanged for that.
+ */
+template <class T, VehicleType Type>
+void GroundVehicle<T, Type>::CargoWeightChanged()
 {
 	assert(this->First() == this);
 	uint32 weight = 0;
@@ -135,17 +149,63 @@ void GroundVehicle<T, Type>::CargoChanged()
 	this->gcache.cached_weight = std::max(1u, weight);
 	/* Friction in bearings and other mechanical parts is 0.1% of the weight (result in N). */
 	this->gcache.cached_axle_resistance = 10 * weight;
+	this->InvalidateAccelerationCache();
+}
 
-	/* Now update vehicle power (tractive effort is dependent on weight). */
-	this->PowerChanged();
+/**
+ * Get the inputs of the acceleration calculation which are not cached values of the consist, to check whether the cached acceleration can be used.
+ * @return The speed, acceleration status, air drag area, acceleration type and improved breakdowns setting, packed together.
+ */
+template <class T, VehicleType Type>
+uint32 GroundVehicle<T, Type>::GetAccelerationCacheState() const
+{
+	const T *v = T::From(this);
+	uint32 state = this->cur_speed;
+	SB(state, 16, 1, v->GetAccelerationStatus() == AS_ACCEL ? 1 : 0);
+	SB(state, 17, 1, _settings_game.vehicle.improved_breakdowns ? 1 : 0);
+	SB(state, 18, 2, v->GetAccelerationType());
+	SB(state, 24, 8, v->GetAirDragArea());
+	return state;
 }
 
 /**
  * Calculates the acceleration of the vehicle under its current conditions.
+ * The result is reused while the speed, slope resistance and other inputs stay the same, which is the usual case for cruising vehicles.
  * @return Current upper and lower bounds of acceleration of the vehicle.
  */
 template <class T, VehicleType Type>
 GroundVehicleAcceleration GroundVehicle<T, Type>::GetAcceleration()
+{
+	const int64 slope_resistance = this->GetSlopeResistance();
+
+	/* Slow vehicles may be marked as too heavy, and reduced power due to breakdowns depends on every part, so always calculate those. */
+	if (this->cur_speed < 3 || (Type == VEH_TRAIN && HasBit(Train::From(this)->flags, VRF_BREAKDOWN_POWER))) {
+		this->InvalidateAccelerationCache();
+		return this->CalculateAcceleration(slope_resistance);
+	}
+
+	const uint32 state = this->GetAccelerationCacheState();
+	GroundVehicleAccelerationCache &cache = this->accel_cache;
+	if (cache.valid && cache.state == state && cache.slope_resistance == slope_resistance) {
+		if (_settings_game.vehicle.improved_breakdowns) this->breakdown_chance_factor = cache.breakdown_chance_factor;
+		return cache.result;
+	}
+
+	cache.result = this->CalculateAcceleration(slope_resistance);
+	cache.state = state;
+	cache.slope_resistance = slope_resistance;
+	cache.breakdown_chance_factor = this->breakdown_chance_factor;
+	cache.valid = true;
+	return cache.result;
+}
+
+/**
+ * Calculates the acceleration of the vehicle under its current conditions, without using the cache.
+ * @param slope_resistance Current slope resistance of the vehicle, see #GetSlopeResistance.
+ * @return Current upper and lower bounds of acceleration of the vehicle.
+ */
+template <class T, VehicleType Type>
+GroundVehicleAcceleration GroundVehicle<T, Type>::CalculateAcceleration(int64 slope_resistance)
 {
 	/* Templated class used for function calls for performance reasons. */
 	const T *v = T::From(this);
@@ -187,7 +247,7 @@ GroundVehicleAcceleration GroundVehicle<T, Type>::GetAcceleration()
 	 * so we need some magic conversion factor. */
 	resistance += static_cast<int64>(area) * this->gcache.cached_air_drag * speed * speed / 1000;
 
-	resistance += this->GetSlopeResistance();
+	resistance += slope_resistance;
 
 	/* This value allows to know if the vehicle is accelerating or braking. */
 	AccelStatus mode = v->GetAccelerationStatus();
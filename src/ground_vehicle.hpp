@@ -61,6 +61,15 @@ struct GroundVehicleAcceleration {
 	int braking;
 };
 
+/** Last calculated acceleration of a ground vehicle, reused while its inputs do not change, e.g. when cruising. */
+struct GroundVehicleAccelerationCache {
+	int64 slope_resistance = 0;            ///< Slope resistance the acceleration was calculated for.
+	uint32 state = 0;                      ///< Speed and other inputs the acceleration was calculated for, see GroundVehicle::GetAccelerationCacheState.
+	GroundVehicleAcceleration result = {}; ///< The calculated acceleration.
+	byte breakdown_chance_factor = 0;      ///< Breakdown chance factor calculated together with the acceleration.
+	bool valid = false;                    ///< Whether the cached acceleration may be used.
+};
+
 /**
  * Base class for all vehicles that move through ground.
  *
@@ -88,6 +97,7 @@ template <class T, VehicleType Type>
 struct GroundVehicle : public SpecializedVehicle<T, Type> {
 	GroundVehicleCache gcache; ///< Cache of often calculated values.
 	uint16 gv_flags;           ///< @see GroundVehicleFlags.
+	GroundVehicleAccelerationCache accel_cache; ///< Last calculated acceleration, only valid for the first vehicle.
 
 	typedef GroundVehicle<T, Type> GroundVehicleBase; ///< Our type
 
@@ -98,12 +108,27 @@ struct GroundVehicle : public SpecializedVehicle<T, Type> {
 
 	void PowerChanged();
 	void CargoChanged();
+	void CargoWeightChanged();
 	bool IsChainInDepot() const override;
 
 	void CalculatePower(uint32& power, uint32& max_te, bool breakdowns) const;
 
 	GroundVehicleAcceleration GetAcceleration();
 
+	/**
+	 * Invalidate the cached acceleration, to be called when any of the cached values it is calculated from changes.
+	 */
+	inline void InvalidateAccelerationCache()
+	{
+		this->accel_cache.valid = false;
+	}
+
+private:
+	uint32 GetAccelerationCacheState() const;
+	GroundVehicleAcceleration CalculateAcceleration(int64 slope_resistance);
+
+public:
+
 	/**
 	 * Common code executed for crashed ground vehicles
 	 * @param flooded was this vehicle flooded?
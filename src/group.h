@@ -17,6 +17,7 @@
 #include "engine_type.h"
 #include "livery.h"
 #include <string>
+#include <vector>
 
 typedef Pool<Group, GroupID, 16, 64000> GroupPool;
 extern GroupPool _group_pool; ///< Pool of groups.
@@ -64,6 +65,13 @@ struct GroupStatistics {
 	static void UpdateAutoreplace(CompanyID company);
 };
 
+/** Statistics of a group including its sub-groups. */
+struct GroupRollupStatistics {
+	Money profit_last_year_min_age = 0;     ///< Sum of profits for vehicles considered for profit statistics.
+	uint num_vehicle = 0;                   ///< Number of vehicles.
+	uint num_vehicle_min_age = 0;           ///< Number of vehicles considered for profit statistics.
+};
+
 enum GroupFlags : uint8 {
 	GF_REPLACE_PROTECTION,    ///< If set to true, the global autoreplace has no effect on the group
 	GF_REPLACE_WAGON_REMOVAL, ///< If set, autoreplace will perform wagon removal on vehicles in this group.
@@ -79,6 +87,8 @@ struct Group : GroupPool::PoolItem<&_group_pool> {
 	uint8 flags;                ///< Group flags
 	Livery livery;              ///< Custom colour scheme for vehicles in this group
 	GroupStatistics statistics; ///< NOSAVE: Statistics and caches on the vehicles in the group.
+	GroupRollupStatistics rollup; ///< NOSAVE: Statistics of the group and its sub-groups, updated on demand.
+	std::vector<GroupID> children; ///< NOSAVE: Direct sub-groups, updated together with #rollup.
 
 	bool folded;                ///< NOSAVE: Is this group folded in the group view?
 
@@ -118,6 +128,7 @@ void UpdateTrainGroupID(Train *v);
 void RemoveVehicleFromGroup(const Vehicle *v);
 void RemoveAllGroupsForCompany(const CompanyID company);
 bool GroupIsInGroup(GroupID search, GroupID group);
+void InvalidateGroupRollups();
 
 std::string GenerateAutoNameForVehicleGroup(const Vehicle *v);
 
@@ -50,6 +50,8 @@ GroupStatistics::~GroupStatistics()
  */
 void GroupStatistics::Clear()
 {
+	InvalidateGroupRollups();
+
 	this->num_vehicle = 0;
 	this->profit_last_year = 0;
 	this->num_vehicle_min_age = 0;
@@ -147,6 +149,8 @@ void GroupStatistics::Clear()
 	GroupStatistics &stats_all = GroupStatistics::GetAllGroup(v);
 	GroupStatistics &stats = GroupStatistics::Get(v);
 
+	InvalidateGroupRollups();
+
 	stats_all.num_vehicle += delta;
 	stats_all.profit_last_year += v->GetDisplayProfitLastYear() * delta;
 	stats.num_vehicle += delta;
@@ -171,6 +175,7 @@ void GroupStatistics::Clear()
 	if (HasBit(v->subtype, GVSF_VIRTUAL)) return;
 
 	assert(delta == 1 || delta == -1);
+	InvalidateGroupRollups();
 	GroupStatistics::GetAllGroup(v).num_engines[v->engine_type] += delta;
 	GroupStatistics::Get(v).num_engines[v->engine_type] += delta;
 }
@@ -195,6 +200,8 @@ void GroupStatistics::Clear()
 	GroupStatistics &stats_all = GroupStatistics::GetAllGroup(v);
 	GroupStatistics &stats = GroupStatistics::Get(v);
 
+	InvalidateGroupRollups();
+
 	stats_all.num_vehicle_min_age++;
 	stats_all.profit_last_year_min_age += v->GetDisplayProfitLastYear();
 	stats.num_vehicle_min_age++;
@@ -206,6 +213,8 @@ void GroupStatistics::Clear()
  */
 /* static */ void GroupStatistics::UpdateProfits()
 {
+	InvalidateGroupRollups();
+
 	/* Set up the engine count for all companies */
 	for (Company *c : Company::Iterate()) {
 		for (VehicleType type = VEH_BEGIN; type < VEH_COMPANY_END; type++) {
@@ -345,6 +354,7 @@ Group::Group(Owner owner)
 {
 	this->owner = owner;
 	this->folded = false;
+	InvalidateGroupRollups();
 }
 
 
@@ -449,6 +459,7 @@ CommandCost CmdDeleteGroup(TileIndex tile, DoCommandFlag flags, uint32 p1, uint3
 		/* Delete the Replace Vehicle Windows */
 		DeleteWindowById(WC_REPLACE_VEHICLE, g->vehicle_type);
 		delete g;
+		InvalidateGroupRollups();
 
 		InvalidateWindowData(GetWindowClassForVehicleType(vt), VehicleListIdentifier(VL_GROUP_LIST, vt, _current_company).Pack());
 		InvalidateWindowData(WC_COMPANY_COLOUR, _current_company, vt);
@@ -506,6 +517,7 @@ CommandCost CmdAlterGroup(TileIndex tile, DoCommandFlag flags, uint32 p1, uint32
 
 		if (flags & DC_EXEC) {
 			g->parent = (pg == nullptr) ? INVALID_GROUP : pg->index;
+			InvalidateGroupRollups();
 			GroupStatistics::UpdateAutoreplace(g->owner);
 			if (g->vehicle_type == VEH_TRAIN) ReindexTemplateReplacementsRecursive();
 
@@ -946,6 +958,7 @@ void SetTrainGroupID(Train *v, GroupID new_g)
 		u->InvalidateImageCache();
 		u->UpdateViewport(true);
 	}
+	MarkTrainTemplateDifferenceDirty(v->index);
 
 	/* Update the Replace Vehicle Windows */
 	GroupStatistics::UpdateAutoreplace(v->owner);
@@ -973,12 +986,61 @@ void UpdateTrainGroupID(Train *v)
 		u->InvalidateNewGRFCache();
 		u->InvalidateImageCache();
 	}
+	MarkTrainTemplateDifferenceDirty(v->index);
 
 	/* Update the Replace Vehicle Windows */
 	GroupStatistics::UpdateAutoreplace(v->owner);
 	SetWindowDirty(WC_REPLACE_VEHICLE, VEH_TRAIN);
 }
 
+static bool _group_rollups_valid = false; ///< Whether #Group::rollup and #Group::children are up to date.
+
+/**
+ * Mark the statistics including sub-groups as outdated.
+ * Call this when the statistics of a group or the group hierarchy change, the statistics are updated when next needed.
+ */
+void InvalidateGroupRollups()
+{
+	_group_rollups_valid = false;
+}
+
+/**
+ * Update the statistics including sub-groups of all groups, if outdated.
+ * The statistics of each group are added to the group and all its ancestors.
+ */
+static void UpdateGroupRollups()
+{
+	if (_group_rollups_valid) return;
+
+	for (Group *g : Group::Iterate()) {
+		g->rollup = {};
+		g->children.clear();
+	}
+
+	for (const Group *g : Group::Iterate()) {
+		if (g->parent != INVALID_GROUP) Group::Get(g->parent)->children.push_back(g->index);
+
+		for (Group *pg = Group::Get(g->index); pg != nullptr; pg = Group::GetIfValid(pg->parent)) {
+			pg->rollup.num_vehicle += g->statistics.num_vehicle;
+			pg->rollup.num_vehicle_min_age += g->statistics.num_vehicle_min_age;
+			pg->rollup.profit_last_year_min_age += g->statistics.profit_last_year_min_age;
+		}
+	}
+
+	_group_rollups_valid = true;
+}
+
+/**
+ * Get the statistics of a group including its sub-groups.
+ * @param id_g The group, must be valid.
+ * @return The statistics.
+ */
+static const GroupRollupStatistics &GetGroupRollup(GroupID id_g)
+{
+	UpdateGroupRollups();
+	return Group::Get(id_g)->rollup;
+}
+
 /**
  * Get the number of engines with EngineID id_e in the group with GroupID
  * id_g and its sub-groups.
@@ -989,12 +1051,19 @@ void UpdateTrainGroupID(Train *v)
  */
 uint GetGroupNumEngines(CompanyID company, GroupID id_g, EngineID id_e)
 {
-	uint count = 0;
 	const Engine *e = Engine::Get(id_e);
-	IterateDescendantsOfGroup(id_g, [&](Group *g) {
-		count += GroupStatistics::Get(company, g->index, e->type).num_engines[id_e];
-	});
-	return count + GroupStatistics::Get(company, id_g, e->type).num_engines[id_e];
+	if (!Group::IsValidID(id_g)) return GroupStatistics::Get(company, id_g, e->type).num_engines[id_e];
+
+	UpdateGroupRollups();
+	uint count = 0;
+	std::vector<GroupID> stack = { id_g };
+	while (!stack.empty()) {
+		const Group *g = Group::Get(stack.back());
+		stack.pop_back();
+		count += g->statistics.num_engines[id_e];
+		stack.insert(stack.end(), g->children.begin(), g->children.end());
+	}
+	return count;
 }
 
 /**
@@ -1007,11 +1076,8 @@ uint GetGroupNumEngines(CompanyID company, GroupID id_g, EngineID id_e)
  */
 uint GetGroupNumVehicle(CompanyID company, GroupID id_g, VehicleType type)
 {
-	uint count = 0;
-	IterateDescendantsOfGroup(id_g, [&](Group *g) {
-		count += GroupStatistics::Get(company, g->index, type).num_vehicle;
-	});
-	return count + GroupStatistics::Get(company, id_g, type).num_vehicle;
+	if (!Group::IsValidID(id_g)) return GroupStatistics::Get(company, id_g, type).num_vehicle;
+	return GetGroupRollup(id_g).num_vehicle;
 }
 
 /**
@@ -1024,11 +1090,8 @@ uint GetGroupNumVehicle(CompanyID company, GroupID id_g, VehicleType type)
  */
 uint GetGroupNumVehicleMinAge(CompanyID company, GroupID id_g, VehicleType type)
 {
-	uint count = 0;
-	IterateDescendantsOfGroup(id_g, [&](Group *g) {
-		count += GroupStatistics::Get(company, g->index, type).num_vehicle_min_age;
-	});
-	return count + GroupStatistics::Get(company, id_g, type).num_vehicle_min_age;
+	if (!Group::IsValidID(id_g)) return GroupStatistics::Get(company, id_g, type).num_vehicle_min_age;
+	return GetGroupRollup(id_g).num_vehicle_min_age;
 }
 
 /**
@@ -1041,11 +1104,8 @@ uint GetGroupNumVehicleMinAge(CompanyID company, GroupID id_g, VehicleType type)
  */
 Money GetGroupProfitLastYearMinAge(CompanyID company, GroupID id_g, VehicleType type)
 {
-	Money sum = 0;
-	IterateDescendantsOfGroup(id_g, [&](Group *g) {
-		sum += GroupStatistics::Get(company, g->index, type).profit_last_year_min_age;
-	});
-	return sum + GroupStatistics::Get(company, id_g, type).profit_last_year_min_age;
+	if (!Group::IsValidID(id_g)) return GroupStatistics::Get(company, id_g, type).profit_last_year_min_age;
+	return GetGroupRollup(id_g).profit_last_year_min_age;
 }
 
 void RemoveAllGroupsForCompany(const CompanyID company)
@@ -1058,6 +1118,7 @@ void RemoveAllGroupsForCompany(const CompanyID company)
 			delete g;
 		}
 	}
+	InvalidateGroupRollups();
 }
 
 
@@ -72,14 +72,41 @@ static inline byte RGBToGrayscale(byte red, byte green, byte blue)
 
 #include <png.h>
 
+/**
+ * Read a single row of a PNG image.
+ * @param png_ptr PNG read struct.
+ * @param row     Buffer for the row.
+ * @return True if the row was read successfully.
+ */
+static bool PNGReadRow(png_structp png_ptr, png_bytep row)
+{
+	if (setjmp(png_jmpbuf(png_ptr))) return false;
+
+	png_read_row(png_ptr, row, nullptr);
+	return true;
+}
+
+/**
+ * Read a whole PNG image.
+ * @param png_ptr PNG read struct.
+ * @param rows    Buffers for each row.
+ * @return True if the image was read successfully.
+ */
+static bool PNGReadImage(png_structp png_ptr, png_bytepp rows)
+{
+	if (setjmp(png_jmpbuf(png_ptr))) return false;
+
+	png_read_image(png_ptr, rows);
+	return true;
+}
+
 /**
  * The PNG Heightmap loader.
+ * @return True if the image data was read successfully.
  */
-static void ReadHeightmapPNGImageData(byte *map, png_structp png_ptr, png_infop info_ptr)
+static bool ReadHeightmapPNGImageData(byte *map, png_structp png_ptr, png_infop info_ptr, int passes)
 {
-	uint x, y;
 	byte gray_palette[256];
-	png_bytep *row_pointers = nullptr;
 	bool has_palette = png_get_color_type(png_ptr, info_ptr) == PNG_COLOR_TYPE_PALETTE;
 	uint channels = png_get_channels(png_ptr, info_ptr);
 
@@ -109,24 +136,49 @@ static void ReadHeightmapPNGImageData(byte *map, png_structp png_ptr, png_infop
 		}
 	}
 
-	row_pointers = png_get_rows(png_ptr, info_ptr);
+	const uint width = png_get_image_width(png_ptr, info_ptr);
+	const uint height = png_get_image_height(png_ptr, info_ptr);
+	const size_t row_bytes = png_get_rowbytes(png_ptr, info_ptr);
 
-	/* Read the raw image data and convert in 8-bit grayscale */
-	for (x = 0; x < png_get_image_width(png_ptr, info_ptr); x++) {
-		for (y = 0; y < png_get_image_height(png_ptr, info_ptr); y++) {
-			byte *pixel = &map[y * png_get_image_width(png_ptr, info_ptr) + x];
+	/* Convert a row of raw image data into 8-bit grayscale */
+	auto convert_row = [&](png_const_bytep row, byte *pixel) {
+		for (uint x = 0; x < width; x++, pixel++) {
 			uint x_offset = x * channels;
 
 			if (has_palette) {
-				*pixel = gray_palette[row_pointers[y][x_offset]];
+				*pixel = gray_palette[row[x_offset]];
 			} else if (channels == 3) {
-				*pixel = RGBToGrayscale(row_pointers[y][x_offset + 0],
-						row_pointers[y][x_offset + 1], row_pointers[y][x_offset + 2]);
+				*pixel = RGBToGrayscale(row[x_offset + 0], row[x_offset + 1], row[x_offset + 2]);
 			} else {
-				*pixel = row_pointers[y][x_offset];
+				*pixel = row[x_offset];
 			}
 		}
+	};
+
+	bool ok = true;
+	if (passes == 1) {
+		/* Convert each row as it is decoded, so that the raw image is never held in memory as a whole */
+		png_bytep row = MallocT<png_byte>(row_bytes);
+		for (uint y = 0; y < height && ok; y++) {
+			ok = PNGReadRow(png_ptr, row);
+			if (ok) convert_row(row, map + static_cast<size_t>(y) * width);
+		}
+		free(row);
+	} else {
+		/* Interlaced images can only be decoded as a whole */
+		png_bytep image = MallocT<png_byte>(row_bytes * height);
+		png_bytepp rows = MallocT<png_bytep>(height);
+		for (uint y = 0; y < height; y++) {
+			rows[y] = image + y * row_bytes;
+		}
+		ok = PNGReadImage(png_ptr, rows);
+		for (uint y = 0; y < height && ok; y++) {
+			convert_row(rows[y], map + static_cast<size_t>(y) * width);
+		}
+		free(rows);
+		free(image);
 	}
+	return ok;
 }
 
 /**
@@ -163,10 +215,15 @@ static bool ReadHeightmapPNG(const char *filename, uint *x, uint *y, byte **map)
 
 	png_init_io(png_ptr, fp);
 
-	/* Allocate memory and read image, without alpha or 16-bit samples
-	 * (result is either 8-bit indexed/grayscale or 24-bit RGB) */
+	/* Read the image header, and set up reading the image without alpha or 16-bit samples
+	 * (result is either 8-bit indexed/grayscale or 24-bit RGB).
+	 * The image data itself is only decoded if it is actually needed. */
+	png_read_info(png_ptr, info_ptr);
 	png_set_packing(png_ptr);
-	png_read_png(png_ptr, info_ptr, PNG_TRANSFORM_PACKING | PNG_TRANSFORM_STRIP_ALPHA | PNG_TRANSFORM_STRIP_16, nullptr);
+	png_set_strip_alpha(png_ptr);
+	png_set_strip_16(png_ptr);
+	const int passes = png_set_interlace_handling(png_ptr);
+	png_read_update_info(png_ptr, info_ptr);
 
 	/* Maps of wrong colour-depth are not used.
 	 * (this should have been taken care of by stripping alpha and 16-bit samples on load) */
@@ -189,7 +246,12 @@ static bool ReadHeightmapPNG(const char *filename, uint *x, uint *y, byte **map)
 
 	if (map != nullptr) {
 		*map = MallocT<byte>(static_cast<size_t>(width) * height);
-		ReadHeightmapPNGImageData(*map, png_ptr, info_ptr);
+		if (!ReadHeightmapPNGImageData(*map, png_ptr, info_ptr, passes)) {
+			ShowErrorMessage(STR_ERROR_PNGMAP, STR_ERROR_PNGMAP_MISC, WL_ERROR);
+			fclose(fp);
+			png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+			return false;
+		}
 	}
 
 	*x = width;
@@ -98,6 +98,8 @@ DECLARE_ENUM_AS_BIT_SET(HouseExtraFlags)
 enum HouseCtrlFlags {
 	HCF_NONE                 =       0,
 	HCF_NO_TRIGGERS          = 1U << 0,  ///< this house does not use random triggers
+	HCF_NO_DESTRUCTION_CB    = 1U << 1,  ///< the destruction callback of this house can never return a result, and has no side effects
+	HCF_NO_PRODUCE_CARGO_CB  = 1U << 2,  ///< the produce cargo callback of this house can never return a result, and has no side effects
 };
 
 DECLARE_ENUM_AS_BIT_SET(HouseCtrlFlags)
@@ -44,6 +44,9 @@
 #include "cmd_helper.h"
 #include "string_func.h"
 #include "event_logs.h"
+#include "pathfinder/water_regions.h"
+#include "tile_candidates.h"
+#include "scope.h"
 
 #include "table/strings.h"
 #include "table/industry_land.h"
@@ -218,6 +221,10 @@ void Industry::PostDestructor(size_t index)
 {
 	if (Industry::GetNumItems() == 0) return nullptr;
 	int num = RandomRange((uint16)Industry::GetNumItems());
+
+	/* Without holes in the pool the num-th valid item is simply at index num */
+	if (Industry::GetNumItems() == Industry::GetPoolSize()) return Industry::Get(num);
+
 	size_t index = MAX_UVALUE(size_t);
 
 	while (num >= 0) {
@@ -1997,6 +2004,7 @@ static void DoCreateNewIndustry(Industry *i, TileIndex tile, IndustryType type,
 			DoCommand(cur_tile, 0, 0, DC_EXEC | DC_NO_TEST_TOWN_RATING | DC_NO_MODIFY_TOWN_RATING, CMD_LANDSCAPE_CLEAR);
 
 			MakeIndustry(cur_tile, i->index, it.gfx, Random(), wc);
+			InvalidateWaterRegion(cur_tile);
 
 			if (_generating_world) {
 				SetIndustryConstructionCounter(cur_tile, 3);
@@ -2362,20 +2370,127 @@ static uint GetNumberOfIndustries()
 	return std::min<uint>(IndustryPool::MAX_SIZE, ScaleByMapSize(numof_industry_table[difficulty]));
 }
 
+/** Kinds of tiles which the north tile of an industry must be on. */
+enum IndustryOriginKind {
+	IOK_LAND,  ///< The north tile must not be on water.
+	IOK_WATER, ///< The north tile must be on water.
+	IOK_ANY,   ///< The north tile may be on land or water, or is not part of all layouts.
+	IOK_END = IOK_ANY,
+};
+
+/** Candidate north tiles of industries per #IndustryOriginKind, while #GenerateIndustries runs. */
+struct IndustryCandidates {
+	TileCandidateSet sets[IOK_END]; ///< The candidates, only valid when built.
+	bool built[IOK_END] = {};       ///< Whether the candidates are built.
+};
+static IndustryCandidates *_industry_candidates = nullptr;
+
+/**
+ * Check whether a tile is on water, as in the land/water check of #CheckIfIndustryTilesAreFree.
+ * @param tile The tile.
+ * @return Whether the tile is on water.
+ */
+static inline bool IsIndustryTileOnWater(TileIndex tile)
+{
+	return HasTileWaterClass(tile) && IsTileOnWater(tile);
+}
+
+/**
+ * Get which kind of tile the north tile of an industry of the given type must be on, according to #CheckIfIndustryTilesAreFree.
+ * @param type The industry type.
+ * @return The kind of tile, IOK_ANY if there is no requirement that holds for all layouts.
+ */
+static IndustryOriginKind GetIndustryOriginKind(IndustryType type)
+{
+	const IndustrySpec *indspec = GetIndustrySpec(type);
+	if (indspec->layouts.empty()) return IOK_ANY;
+
+	IndustryOriginKind result = IOK_ANY;
+	bool first = true;
+	for (const IndustryTileLayout &layout : indspec->layouts) {
+		IndustryOriginKind kind = IOK_ANY;
+		for (const IndustryTileLayoutTile &it : layout) {
+			if (it.ti.x != 0 || it.ti.y != 0) continue;
+			IndustryGfx gfx = GetTranslatedIndustryTileID(it.gfx);
+			if (gfx == GFX_WATERTILE_SPECIALCHECK) {
+				kind = IOK_WATER;
+			} else if (!HasBit(GetIndustryTileSpec(gfx)->slopes_refused, 5)) {
+				kind = (indspec->behaviour & INDUSTRYBEH_BUILT_ONWATER) ? IOK_WATER : IOK_LAND;
+			}
+			break;
+		}
+		if (first) {
+			result = kind;
+			first = false;
+		} else if (result != kind) {
+			return IOK_ANY;
+		}
+	}
+	return result;
+}
+
+/**
+ * Get the candidate north tiles for an industry type during map generation, building them if needed.
+ * @param type The industry type.
+ * @return The candidates, or nullptr if random tiles of the whole map are to be used.
+ */
+static TileCandidateSet *GetIndustryCandidates(IndustryType type)
+{
+	if (_industry_candidates == nullptr) return nullptr;
+
+	const IndustryOriginKind kind = GetIndustryOriginKind(type);
+	if (kind == IOK_ANY) return nullptr;
+
+	TileCandidateSet &candidates = _industry_candidates->sets[kind];
+	if (!_industry_candidates->built[kind]) {
+		const bool water = (kind == IOK_WATER);
+		candidates.Build([water](TileIndex tile) { return IsValidTile(tile) && IsIndustryTileOnWater(tile) == water; });
+		_industry_candidates->built[kind] = true;
+	}
+	return &candidates;
+}
+
+/**
+ * Remove the tiles of a new industry from the candidate north tiles, as they cannot be cleared for another industry.
+ * @param ind The new industry.
+ */
+static void RemoveIndustryCandidates(const Industry *ind)
+{
+	for (TileIndex tile : ind->location) {
+		if (!IsTileType(tile, MP_INDUSTRY) || GetIndustryIndex(tile) != ind->index) continue;
+		for (uint kind = 0; kind < IOK_END; kind++) {
+			if (_industry_candidates->built[kind]) _industry_candidates->sets[kind].Remove(tile);
+		}
+	}
+}
+
 /**
  * Try to place the industry in the game.
  * Since there is no feedback why placement fails, there is no other option
  * than to try a few times before concluding it does not work.
+ * During map generation, the tiles are drawn from the candidate north tiles of the industry type, if there are any.
  * @param type     Industry type of the desired industry.
  * @param try_hard Try very hard to find a place. (Used to place at least one industry per type.)
  * @return Pointer to created industry, or \c nullptr if creation failed.
  */
 static Industry *PlaceIndustry(IndustryType type, IndustryAvailabilityCallType creation_type, bool try_hard)
 {
+	TileCandidateSet *candidates = GetIndustryCandidates(type);
+
 	uint tries = try_hard ? 10000u : 2000u;
 	for (; tries > 0; tries--) {
-		Industry *ind = CreateNewIndustry(RandomTile(), type, creation_type);
-		if (ind != nullptr) return ind;
+		TileIndex tile;
+		if (candidates != nullptr) {
+			if (candidates->Count() == 0) return nullptr;
+			tile = candidates->Get(RandomRange(candidates->Count()));
+		} else {
+			tile = RandomTile();
+		}
+		Industry *ind = CreateNewIndustry(tile, type, creation_type);
+		if (ind != nullptr) {
+			if (_industry_candidates != nullptr) RemoveIndustryCandidates(ind);
+			return ind;
+		}
 	}
 	return nullptr;
 }
@@ -2449,6 +2564,12 @@ void GenerateIndustries()
 {
 	if (_game_mode != GM_EDITOR && _settings_game.difficulty.industry_density == ID_FUND_ONLY) return; // No industries in the game.
 
+	IndustryCandidates candidates;
+	_industry_candidates = &candidates;
+	auto guard = scope_guard([]() {
+		_industry_candidates = nullptr;
+	});
+
 	uint32 industry_probs[NUM_INDUSTRYTYPES];
 	bool force_at_least_one[NUM_INDUSTRYTYPES];
 	uint32 total_prob = 0;
@@ -3079,12 +3200,13 @@ void IndustryMonthlyLoop()
 			delete i;
 		} else {
 			ChangeIndustryProduction(i, true);
-			SetWindowDirty(WC_INDUSTRY_VIEW, i->index);
 		}
 	}
 
 	cur_company.Restore();
 
+	SetWindowClassesDirty(WC_INDUSTRY_VIEW);
+
 	/* production-change */
 	InvalidateWindowData(WC_INDUSTRY_DIRECTORY, 0, IDIWD_PRODUCTION_CHANGE);
 }
@@ -92,6 +92,13 @@ enum IndustryTileSpecialFlags {
 };
 DECLARE_ENUM_AS_BIT_SET(IndustryTileSpecialFlags)
 
+/** Flags for industry tile properties determined by analysis of the NewGRF sprite groups */
+enum IndustryTileCtrlFlags {
+	ITCF_NONE                             = 0,
+	ITCF_NO_TRIGGERS                      = 1 << 0, ///< this industry tile does not use random triggers
+};
+DECLARE_ENUM_AS_BIT_SET(IndustryTileCtrlFlags)
+
 /** Definition of one tile in an industry tile layout */
 struct IndustryTileLayoutTile {
 	TileIndexDiffC ti;
@@ -169,6 +176,7 @@ struct IndustryTileSpec {
 	uint8 callback_mask;                  ///< Bitmask of industry tile callbacks that have to be called
 	AnimationInfo animation;              ///< Information about the animation (is it looping, how many loops etc)
 	IndustryTileSpecialFlags special_flags; ///< Bitmask of extra flags used by the tile
+	IndustryTileCtrlFlags ctrl_flags;     ///< control flags
 	bool enabled;                         ///< entity still available (by default true).newgrf can disable it, though
 	GRFFileProps grf_prop;                ///< properties related to the grf file
 };
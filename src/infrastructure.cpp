@@ -26,6 +26,7 @@
 #include "order_cmd.h"
 #include "strings_func.h"
 #include "scope.h"
+#include "worker_thread.h"
 
 #include "table/strings.h"
 
@@ -60,37 +61,51 @@ void PayStationSharingFee(Vehicle *v, const Station *st)
 	PaySharingFee(v, st->owner, (cost << 8) / DAY_TICKS);
 }
 
-uint16 is2_GetWeight(Train *v)
-{
-	uint16 weight = (CargoSpec::Get(v->cargo_type)->weight * v->cargo.StoredCount() * FreightWagonMult(v->cargo_type)) / 16;
-		/* Vehicle weight is not added for articulated parts. */
-	if (!v->IsArticulatedPart()) {
-		weight += GetVehicleProperty(v, PROP_TRAIN_WEIGHT, RailVehInfo(v->engine_type)->weight);
-	}
-		/* Powered wagons have extra weight added. */
-	if (HasBit(v->flags, VRF_POWEREDWAGON)) {
-		weight += RailVehInfo(v->gcache.first_engine)->pow_wag_weight;
-	}
-		return weight;
-}
-
-
 /**
  * Pay the daily fee for trains on foreign tracks.
  * @param v The vehicle to pay the fee for.
  */
 void PayDailyTrackSharingFee(Train *v)
 {
+	/* Avoid looking up the weight, which may involve a NewGRF callback, when there is nothing to pay. */
+	if (_settings_game.economy.sharing_fee[VEH_TRAIN] == 0) return;
 	Owner owner = GetTileOwner(v->tile);
 	if (owner == v->owner) return;
 	Money cost = _settings_game.economy.sharing_fee[VEH_TRAIN] << 8;
 	/* Cost is calculated per 1000 tonnes */
-	cost = cost * is2_GetWeight(v) / 1000;
+	cost = cost * (v->GetWeightWithoutCargo() + v->GetCargoWeight()) / 1000;
 	/* Only pay the required fraction */
 	cost = cost * v->running_ticks / DAY_TICKS;
 	if (cost != 0) PaySharingFee(v, owner, cost);
 }
 
+/**
+ * Find the tiles of the map matching a filter, scanning the map on the worker pool.
+ * @param filter Function returning whether a tile is wanted, it must be safe to call from multiple threads.
+ * @return The matching tiles, in ascending order.
+ */
+template <typename F>
+static std::vector<TileIndex> FindInfrastructureTiles(F filter)
+{
+	std::vector<std::vector<TileIndex>> rows(MapSizeY());
+
+	const uint workers = _general_worker_pool.GetWorkerCount();
+	WorkerTaskGroup group;
+	group.ParallelFor(0, MapSizeY(), CeilDiv(MapSizeY(), (workers + 1) * 4), [&](size_t y) {
+		const TileIndex first = TileXY(0, (uint)y);
+		const TileIndex last = first + MapSizeX();
+		for (TileIndex tile = first; tile != last; tile++) {
+			if (filter(tile)) rows[y].push_back(tile);
+		}
+	});
+
+	std::vector<TileIndex> tiles;
+	for (const std::vector<TileIndex> &row : rows) {
+		tiles.insert(tiles.end(), row.begin(), row.end());
+	}
+	return tiles;
+}
+
 /**
  * Check whether a vehicle is in an allowed position.
  * @param v     The vehicle to check.
@@ -358,31 +373,32 @@ void HandleSharingCompanyDeletion(Owner owner)
 	}
 
 	if (_settings_game.vehicle.train_braking_model == TBM_REALISTIC && _settings_game.economy.infrastructure_sharing[VEH_TRAIN]) {
-		for (TileIndex t = 0; t < MapSize(); t++) {
+		/* Only the reserved tiles of the company are of interest, find them without visiting the rest of the map one by one. */
+		const std::vector<TileIndex> reserved_tiles = FindInfrastructureTiles([owner](TileIndex t) -> bool {
 			switch (GetTileType(t)) {
 				case MP_RAILWAY:
 				case MP_ROAD:
 				case MP_STATION:
 				case MP_TUNNELBRIDGE:
-					if (GetTileOwner(t) == owner) {
-						TrackBits bits = GetReservedTrackbits(t);
-						if (bits != TRACK_BIT_NONE) {
-							/* Vehicles of this company and vehicles physically on tiles of this company have all been removed, but this tile is still reserved.
-							 * The reservation may belong to a train of another company which is still on another company's infrastructure, remove it.
-							 */
-							for (Track track : SetTrackBitIterator(bits)) {
-								Train *v = GetTrainForReservation(t, track);
-								if (v != nullptr) RemoveAndSellVehicle(v, v->owner != owner);
-							}
-						}
-					}
-					break;
+					return GetTileOwner(t) == owner && GetReservedTrackbits(t) != TRACK_BIT_NONE;
 
 				default:
-					break;
+					return false;
+			}
+		});
+		for (TileIndex t : reserved_tiles) {
+			/* Removing a vehicle may have freed reservations of later tiles in the list. */
+			TrackBits bits = GetReservedTrackbits(t);
+			if (bits != TRACK_BIT_NONE) {
+				/* Vehicles of this company and vehicles physically on tiles of this company have all been removed, but this tile is still reserved.
+				 * The reservation may belong to a train of another company which is still on another company's infrastructure, remove it.
+				 */
+				for (Track track : SetTrackBitIterator(bits)) {
+					Train *v = GetTrainForReservation(t, track);
+					if (v != nullptr) RemoveAndSellVehicle(v, v->owner != owner);
+				}
 			}
 		}
-
 	}
 }
 
@@ -394,22 +410,27 @@ void HandleSharingCompanyDeletion(Owner owner)
 void UpdateAllBlockSignals(Owner owner)
 {
 	Owner last_owner = INVALID_OWNER;
-	auto check_owner = [&](Owner track_owner) -> bool {
-		if (owner != INVALID_OWNER && track_owner != owner) return true;
-
+	auto check_owner = [&](Owner track_owner) {
 		if (!IsOneSignalBlock(track_owner, last_owner)) {
 			/* Cannot update signals of two different companies in one run,
 			 * if these signal blocks are not joined */
 			UpdateSignalsInBuffer();
 			last_owner = track_owner;
 		}
-		return false;
 	};
-	TileIndex tile = 0;
-	do {
-		if (IsTileType(tile, MP_RAILWAY) && HasSignals(tile)) {
+	/* Signals and crossings are sparse, find them first and only visit those in map order. */
+	const std::vector<TileIndex> tiles = FindInfrastructureTiles([owner](TileIndex tile) -> bool {
+		if (IsTileType(tile, MP_RAILWAY)) {
+			if (!HasSignals(tile)) return false;
+		} else if (!IsLevelCrossingTile(tile) && !IsTunnelBridgeWithSignalSimulation(tile)) {
+			return false;
+		}
+		return owner == INVALID_OWNER || GetTileOwner(tile) == owner;
+	});
+	for (TileIndex tile : tiles) {
+		if (IsTileType(tile, MP_RAILWAY)) {
 			Owner track_owner = GetTileOwner(tile);
-			if (check_owner(track_owner)) continue;
+			check_owner(track_owner);
 			TrackBits bits = GetTrackBits(tile);
 			do {
 				Track track = RemoveFirstTrack(&bits);
@@ -417,11 +438,11 @@ void UpdateAllBlockSignals(Owner owner)
 					AddTrackToSignalBuffer(tile, track, track_owner);
 				}
 			} while (bits != TRACK_BIT_NONE);
-		} else if (IsLevelCrossingTile(tile) && (owner == INVALID_OWNER || GetTileOwner(tile) == owner)) {
+		} else if (IsLevelCrossingTile(tile)) {
 			UpdateLevelCrossing(tile);
-		} else if (IsTunnelBridgeWithSignalSimulation(tile)) {
+		} else {
 			Owner track_owner = GetTileOwner(tile);
-			if (check_owner(track_owner)) continue;
+			check_owner(track_owner);
 			if (IsTunnelBridgeSignalSimulationExit(tile)) {
 				AddSideToSignalBuffer(tile, INVALID_DIAGDIR, track_owner);
 			}
@@ -430,7 +451,7 @@ void UpdateAllBlockSignals(Owner owner)
 				UpdateAspectDeferred(tile, GetTunnelBridgeEntranceTrackdir(tile));
 			}
 		}
-	} while (++tile != MapSize());
+	}
 
 	UpdateSignalsInBuffer();
 	FlushDeferredAspectUpdates();
@@ -29,11 +29,12 @@
 #include "object_base.h"
 #include "company_func.h"
 #include "tunnelbridge_map.h"
-#include "pathfinder/npf/aystar.h"
+#include "pathfinder/water_regions.h"
 #include "saveload/saveload.h"
 #include "framerate_type.h"
+#include "tracing.h"
 #include "town.h"
-#include "3rdparty/cpp-btree/btree_set.h"
+#include "3rdparty/robin_hood/robin_hood.h"
 #include "scope_info.h"
 #include <array>
 #include <list>
@@ -102,6 +103,12 @@ static TileIndex _current_estuary = INVALID_TILE;
 /** Whether the current river is a big river that others flow into */
 static bool _is_main_river = false;
 
+/** Bit of #_river_flow_directions which is set when the directions of the tile are known. */
+static const uint8 RIVER_FLOW_DIRECTIONS_CACHED = 7;
+
+/** Per tile, the directions in which a river can flow down, during river generation. See #GetRiverFlowDirections. */
+static std::vector<uint8> _river_flow_directions;
+
 byte _cached_snowline = 0;
 byte _cached_highest_snowline = 0;
 byte _cached_lowest_snowline = 0;
@@ -301,6 +308,33 @@ static constexpr uint InternalGetPartialPixelZ(int x, int y, Slope corners)
 	}
 }
 
+/**
+ * Lookup table of #InternalGetPartialPixelZ for all non-halftile slopes, indexed by slope and (x * TILE_SIZE + y).
+ * Entries of invalid slopes are zero.
+ */
+struct PartialPixelZTable {
+	uint8 z[SLOPE_HALFTILE][TILE_SIZE * TILE_SIZE] = {};
+
+	static constexpr bool IsValidTableSlope(uint slope)
+	{
+		/* Steep slopes are only valid on top of a three corner slope */
+		return (slope & SLOPE_STEEP) == 0 || (slope & SLOPE_ELEVATED) == SLOPE_ENW || (slope & SLOPE_ELEVATED) == SLOPE_SEN ||
+				(slope & SLOPE_ELEVATED) == SLOPE_WSE || (slope & SLOPE_ELEVATED) == SLOPE_NWS;
+	}
+
+	constexpr PartialPixelZTable()
+	{
+		for (uint slope = 0; slope < SLOPE_HALFTILE; slope++) {
+			if (!IsValidTableSlope(slope)) continue;
+			for (uint i = 0; i < TILE_SIZE * TILE_SIZE; i++) {
+				this->z[slope][i] = InternalGetPartialPixelZ(i / TILE_SIZE, i % TILE_SIZE, (Slope)slope);
+			}
+		}
+	}
+};
+
+static constexpr PartialPixelZTable _partial_pixel_z_table;
+
 #include "tests/landscape_partial_pixel_z.h"
 
 /**
@@ -313,7 +347,8 @@ static constexpr uint InternalGetPartialPixelZ(int x, int y, Slope corners)
  */
 uint GetPartialPixelZ(int x, int y, Slope corners)
 {
-	return InternalGetPartialPixelZ(x, y, corners);
+	if (unlikely(IsHalftileSlope(corners))) return InternalGetPartialPixelZ(x, y, corners);
+	return _partial_pixel_z_table.z[corners][x * TILE_SIZE + y];
 }
 
 /**
@@ -577,6 +612,7 @@ void DoClearSquare(TileIndex tile)
 
 	MakeClear(tile, CLEAR_GRASS, _generating_world ? 3 : 0);
 	MarkTileDirtyByTile(tile);
+	InvalidateWaterRegion(tile);
 }
 
 /**
@@ -824,6 +860,8 @@ static uint32 GetTileLoopFeedback()
 void RunTileLoop()
 {
 	PerformanceAccumulator framerate(PFE_GL_LANDSCAPE);
+	PerformanceAccumulator framerate_tileloop(PFE_GL_TILELOOP);
+	TRACE_SCOPE("RunTileLoop");
 
 	const uint32 feedback = GetTileLoopFeedback();
 
@@ -843,10 +881,15 @@ void RunTileLoop()
 	}
 
 	while (count--) {
+		/* Get the next tile in sequence using a Galois LFSR.
+		 * The sequence jumps all over the map, so start fetching the next tile while this one is processed. */
+		const TileIndex next = (tile >> 1) ^ (-(int32)(tile & 1) & feedback);
+		PREFETCH_NTA(&_m[next]);
+		PREFETCH_NTA(&_me[next]);
+
 		_tile_type_procs[GetTileType(tile)]->tile_loop_proc(tile);
 
-		/* Get the next tile in sequence using a Galois LFSR. */
-		tile = (tile >> 1) ^ (-(int32)(tile & 1) & feedback);
+		tile = next;
 	}
 
 	_cur_tileloop_tile = tile;
@@ -858,19 +901,24 @@ void RunAuxiliaryTileLoop()
 	if (_settings_game.economy.day_length_factor <= 4 || (_scaled_tick_counter % 4) != 0) return;
 
 	PerformanceAccumulator framerate(PFE_GL_LANDSCAPE);
+	PerformanceAccumulator framerate_tileloop(PFE_GL_TILELOOP);
 
 	const uint32 feedback = GetTileLoopFeedback();
 	uint count = 1 << (MapLogX() + MapLogY() - 8);
 	TileIndex tile = _aux_tileloop_tile;
 
 	while (count--) {
+		/* Get the next tile in sequence using a Galois LFSR.
+		 * Most tiles are rejected after a single read of the tile type, so the loop is dominated by cache misses: fetch ahead. */
+		const TileIndex next = (tile >> 1) ^ (-(int32)(tile & 1) & feedback);
+		PREFETCH_NTA(&_m[next]);
+
 		if (!IsNonFloodingWaterTile(tile)) {
 			FloodingBehaviour fb = GetFloodingBehaviour(tile);
 			if (fb != FLOOD_NONE) TileLoopWaterFlooding(fb, tile);
 		}
 
-		/* Get the next tile in sequence using a Galois LFSR. */
-		tile = (tile >> 1) ^ (-(int32)(tile & 1) & feedback);
+		tile = next;
 	}
 
 	_aux_tileloop_tile = tile;
@@ -1201,39 +1249,120 @@ static bool FlowsDown(TileIndex begin, TileIndex end)
 			((slopeEnd == slopeBegin && heightEnd < heightBegin) || slopeEnd == SLOPE_FLAT || slopeBegin == SLOPE_FLAT);
 }
 
-/* AyStar callback for checking whether we reached our destination. */
-static int32 River_EndNodeCheck(const AyStar *aystar, const OpenListNode *current)
+/**
+ * Get the directions in which a river can flow down from a tile to a neighbouring tile, see #FlowsDown.
+ * The result is cached in #_river_flow_directions, as the slopes do not change while the rivers are generated.
+ * @param tile The origin of the flow.
+ * @return Bitmask of the DiagDirection in which the river can flow.
+ */
+static uint8 GetRiverFlowDirections(TileIndex tile)
 {
-	return current->path.node.tile == *(TileIndex*)aystar->user_target ? AYSTAR_FOUND_END_NODE : AYSTAR_DONE;
+	uint8 &dirs = _river_flow_directions[tile];
+	if (!HasBit(dirs, RIVER_FLOW_DIRECTIONS_CACHED)) {
+		dirs = 1 << RIVER_FLOW_DIRECTIONS_CACHED;
+		for (DiagDirection d = DIAGDIR_BEGIN; d < DIAGDIR_END; d++) {
+			TileIndex t2 = tile + TileOffsByDiagDir(d);
+			if (IsValidTile(t2) && FlowsDown(tile, t2)) SetBit(dirs, d);
+		}
+	}
+	return dirs & ~(1 << RIVER_FLOW_DIRECTIONS_CACHED);
 }
 
-/* AyStar callback for getting the cost of the current node. */
-static int32 River_CalculateG(AyStar *aystar, AyStarNode *current, OpenListNode *parent)
-{
-	return 1 + RandomRange(_settings_game.game_creation.river_route_random);
-}
+/**
+ * A* search for the route of a river between two tiles, where the river can only flow down.
+ * Each step has a random cost, so that rivers meander instead of following straight lines.
+ */
+class RiverRouter {
+	/** Search state of a tile. */
+	struct Node {
+		uint32 g;         ///< Cost of the best known route from the begin.
+		TileIndex parent; ///< Previous tile of the best known route, INVALID_TILE for the begin.
+		bool closed;      ///< Whether the best route to the tile is final.
+	};
 
-/* AyStar callback for getting the estimated cost to the destination. */
-static int32 River_CalculateH(AyStar *aystar, AyStarNode *current, OpenListNode *parent)
-{
-	return DistanceManhattan(*(TileIndex*)aystar->user_target, current->tile);
-}
+	/** Entry of the open list. Entries of tiles for which a better route was found are skipped when popped. */
+	struct OpenEntry {
+		uint32 f;       ///< Estimated cost of the route to the end via the tile.
+		uint32 g;       ///< Cost of the route to the tile when the entry was added.
+		uint32 order;   ///< Insertion order, to pop entries with the same cost in a stable order.
+		TileIndex tile; ///< The tile.
+
+		/* The heap is a max heap, so the entry to pop first must be the greatest. */
+		bool operator<(const OpenEntry &other) const
+		{
+			if (this->f != other.f) return this->f > other.f;
+			return this->order > other.order;
+		}
+	};
 
-/* AyStar callback for getting the neighbouring nodes of the given node. */
-static void River_GetNeighbours(AyStar *aystar, OpenListNode *current)
-{
-	TileIndex tile = current->path.node.tile;
+	robin_hood::unordered_flat_map<TileIndex, Node> nodes; ///< Search state of the tiles reached so far.
+	std::vector<OpenEntry> open;                           ///< The open list, as a binary heap.
+	uint32 order = 0;                                      ///< Insertion order of the next open list entry.
 
-	aystar->num_neighbours = 0;
-	for (DiagDirection d = DIAGDIR_BEGIN; d < DIAGDIR_END; d++) {
-		TileIndex t2 = tile + TileOffsByDiagDir(d);
-		if (IsValidTile(t2) && FlowsDown(tile, t2)) {
-			aystar->neighbours[aystar->num_neighbours].tile = t2;
-			aystar->neighbours[aystar->num_neighbours].direction = INVALID_TRACKDIR;
-			aystar->num_neighbours++;
+	void Push(TileIndex tile, uint32 g, uint32 f)
+	{
+		this->open.push_back({ f, g, this->order++, tile });
+		std::push_heap(this->open.begin(), this->open.end());
+	}
+
+public:
+	/**
+	 * Find a route down hill.
+	 * @param begin The begin of the river.
+	 * @param end The end of the river.
+	 * @return Whether a route was found.
+	 */
+	bool FindRoute(TileIndex begin, TileIndex end)
+	{
+		this->nodes.clear();
+		this->open.clear();
+		this->order = 0;
+
+		this->nodes[begin] = { 0, INVALID_TILE, false };
+		this->Push(begin, 0, DistanceManhattan(begin, end));
+
+		while (!this->open.empty()) {
+			std::pop_heap(this->open.begin(), this->open.end());
+			const OpenEntry current = this->open.back();
+			this->open.pop_back();
+
+			Node &node = this->nodes[current.tile];
+			if (node.closed || node.g != current.g) continue;
+			if (current.tile == end) return true;
+			node.closed = true;
+
+			const uint8 dirs = GetRiverFlowDirections(current.tile);
+			for (DiagDirection d = DIAGDIR_BEGIN; d < DIAGDIR_END; d++) {
+				if (!HasBit(dirs, d)) continue;
+
+				TileIndex t2 = current.tile + TileOffsByDiagDir(d);
+				auto it = this->nodes.find(t2);
+				if (it != this->nodes.end() && it->second.closed) continue;
+
+				const uint32 g = current.g + 1 + RandomRange(_settings_game.game_creation.river_route_random);
+				if (it != this->nodes.end()) {
+					if (g >= it->second.g) continue;
+					it->second.g = g;
+					it->second.parent = current.tile;
+				} else {
+					this->nodes.emplace(t2, Node{ g, current.tile, false });
+				}
+				this->Push(t2, g, g + DistanceManhattan(end, t2));
+			}
 		}
+		return false;
 	}
-}
+
+	/**
+	 * Get the previous tile of the route found by #FindRoute.
+	 * @param tile A tile of the route.
+	 * @return The previous tile, or INVALID_TILE for the begin.
+	 */
+	TileIndex GetParent(TileIndex tile) const
+	{
+		return this->nodes.find(tile)->second.parent;
+	}
+};
 
 /** Callback to widen a river tile. */
 static bool RiverMakeWider(TileIndex tile, void *data)
@@ -1249,58 +1378,38 @@ static bool RiverMakeWider(TileIndex tile, void *data)
 	return false;
 }
 
-/* AyStar callback when an route has been found. */
-static void River_FoundEndNode(AyStar *aystar, OpenListNode *current)
+/**
+ * Actually build the river between the begin and end tiles.
+ * @param begin The begin of the river.
+ * @param end The end of the river.
+ */
+static void BuildRiver(TileIndex begin, TileIndex end)
 {
-	for (PathNode *path = &current->path; path != nullptr; path = path->parent) {
-		TileIndex tile = path->node.tile;
+	RiverRouter router;
+	if (!router.FindRoute(begin, end)) return;
+
+	for (TileIndex tile = end; tile != INVALID_TILE; tile = router.GetParent(tile)) {
 		if (!IsWaterTile(tile)) {
 			MakeRiver(tile, Random());
 
 			// Widen river depending on how far we are away from the source.
-			const uint current_river_length = DistanceManhattan(_current_spring, path->node.tile);
+			const uint current_river_length = DistanceManhattan(_current_spring, tile);
 			const uint long_river_length = _settings_game.game_creation.min_river_length * 4;
 			const uint radius = std::min(3u, (current_river_length / (long_river_length / 3u)) + 1u);
 
 			MarkTileDirtyByTile(tile);
 
+			TileIndex search_tile = tile;
 			if (_settings_game.game_creation.land_generator != LG_ORIGINAL && _is_main_river && (radius > 1)) {
-				CircularTileSearch(&tile, radius + RandomRange(1), RiverMakeWider, (void *)&path->node.tile);
+				CircularTileSearch(&search_tile, radius + RandomRange(1), RiverMakeWider, &tile);
 			} else {
 				/* Remove desert directly around the river tile. */
-				CircularTileSearch(&tile, _settings_game.game_creation.river_tropics_width, RiverModifyDesertZone, nullptr);
+				CircularTileSearch(&search_tile, _settings_game.game_creation.river_tropics_width, RiverModifyDesertZone, nullptr);
 			}
 		}
 	}
 }
 
-static const uint RIVER_HASH_SIZE = 8; ///< The number of bits the hash for river finding should have.
-
-/**
- * Actually build the river between the begin and end tiles using AyStar.
- * @param begin The begin of the river.
- * @param end The end of the river.
- */
-static void BuildRiver(TileIndex begin, TileIndex end)
-{
-	AyStar finder = {};
-	finder.CalculateG = River_CalculateG;
-	finder.CalculateH = River_CalculateH;
-	finder.GetNeighbours = River_GetNeighbours;
-	finder.EndNodeCheck = River_EndNodeCheck;
-	finder.FoundEndNode = River_FoundEndNode;
-	finder.user_target = &end;
-
-	finder.Init(1 << RIVER_HASH_SIZE);
-
-	AyStarNode start;
-	start.tile = begin;
-	start.direction = INVALID_TRACKDIR;
-	finder.AddStartNode(&start, 0);
-	finder.Main();
-	finder.Free();
-}
-
 /**
  * Try to flow the river down from a given begin.
  * @param spring The springing point of the river.
@@ -1310,9 +1419,6 @@ static void BuildRiver(TileIndex begin, TileIndex end)
  */
 static bool FlowRiver(TileIndex spring, TileIndex begin, uint min_river_length)
 {
-#	define SET_MARK(x) marks.insert(x)
-#	define IS_MARKED(x) (marks.find(x) != marks.end())
-
 	uint height = TileHeight(begin);
 	if (IsWaterTile(begin))
 	{
@@ -1324,8 +1430,11 @@ static bool FlowRiver(TileIndex spring, TileIndex begin, uint min_river_length)
 		return DistanceManhattan(spring, begin) > min_river_length;
 	}
 
-	btree::btree_set<TileIndex> marks;
-	SET_MARK(begin);
+	/* Tiles considered, both as a set and in the order they were considered. */
+	robin_hood::unordered_flat_set<TileIndex> marks;
+	std::vector<TileIndex> marked;
+	marks.insert(begin);
+	marked.push_back(begin);
 
 	/* Breadth first search for the closest tile we can flow down to. */
 	std::deque<TileIndex> queue;
@@ -1344,10 +1453,11 @@ static bool FlowRiver(TileIndex spring, TileIndex begin, uint min_river_length)
 			break;
 		}
 
+		const uint8 dirs = GetRiverFlowDirections(end);
 		for (DiagDirection d = DIAGDIR_BEGIN; d < DIAGDIR_END; d++) {
 			TileIndex t2 = end + TileOffsByDiagDir(d);
-			if (IsValidTile(t2) && !IS_MARKED(t2) && FlowsDown(end, t2)) {
-				SET_MARK(t2);
+			if (HasBit(dirs, d) && marks.insert(t2).second) {
+				marked.push_back(t2);
 				count++;
 				queue.push_back(t2);
 			}
@@ -1358,12 +1468,10 @@ static bool FlowRiver(TileIndex spring, TileIndex begin, uint min_river_length)
 		/* Flow further down hill. */
 		found = FlowRiver(spring, end, min_river_length);
 	} else if (count > 32 && _settings_game.game_creation.lake_size != 0) {
-		/* Maybe we can make a lake. Find the Nth of the considered tiles. */
-		TileIndex lakeCenter = 0;
-		int i = RandomRange(count - 1) + 1;
-		btree::btree_set<TileIndex>::const_iterator cit = marks.begin();
-		while (--i) cit++;
-		lakeCenter = *cit;
+		/* Maybe we can make a lake. Find the Nth of the considered tiles, in tile index order. */
+		const uint i = RandomRange(count - 1);
+		std::nth_element(marked.begin(), marked.begin() + i, marked.end());
+		TileIndex lakeCenter = marked[i];
 
 		if (IsValidTile(lakeCenter) &&
 				/* A river, or lake, can only be built on flat slopes. */
@@ -1409,7 +1517,6 @@ static bool FlowRiver(TileIndex spring, TileIndex begin, uint min_river_length)
 		}
 	}
 
-	marks.clear();
 	if (found) BuildRiver(begin, end);
 	return found;
 }
@@ -1426,6 +1533,8 @@ static void CreateRivers()
 	const uint num_short_rivers = wells - std::max(1u, wells / 10);
 	SetGeneratingWorldProgress(GWP_RIVER, wells + 256 / 64); // Include the tile loop calls below.
 
+	_river_flow_directions.assign(MapSize(), 0);
+
 	for (; wells > num_short_rivers; wells--) {
 		IncreaseGeneratingWorldProgress(GWP_RIVER);
 		for (int tries = 0; tries < 128; tries++) {
@@ -1448,6 +1557,9 @@ static void CreateRivers()
 		}
 	}
 
+	_river_flow_directions.clear();
+	_river_flow_directions.shrink_to_fit();
+
 	/* Widening rivers may have left some tiles requiring to be watered. */
 	ConvertGroundTilesIntoWaterTiles();
 
@@ -1687,10 +1799,19 @@ void CallLandscapeTick()
 	{
 		PerformanceAccumulator framerate(PFE_GL_LANDSCAPE);
 
-		OnTick_Town();
+		{
+			PerformanceAccumulator framerate_towns(PFE_GL_TOWNS);
+			OnTick_Town();
+		}
 		OnTick_Trees();
-		OnTick_Station();
-		OnTick_Industry();
+		{
+			PerformanceAccumulator framerate_stations(PFE_GL_STATIONS);
+			OnTick_Station();
+		}
+		{
+			PerformanceAccumulator framerate_industries(PFE_GL_INDUSTRIES);
+			OnTick_Industry();
+		}
 	}
 
 	OnTick_LinkGraph();
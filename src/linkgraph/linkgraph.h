@@ -358,6 +358,19 @@ public:
 	 */
 	inline CargoID Cargo() const { return this->cargo; }
 
+	/**
+	 * Get the wall-clock run time of the last job which was run for this link graph.
+	 * This is local to this client, and so must not be used for anything affecting the game state.
+	 * @return Run time in microseconds, or 0 if not known.
+	 */
+	inline uint64 LastJobRunTime() const { return this->last_job_run_time; }
+
+	/**
+	 * Set the wall-clock run time of the last job which was run for this link graph.
+	 * @param run_time Run time in microseconds.
+	 */
+	inline void SetLastJobRunTime(uint64 run_time) { this->last_job_run_time = run_time; }
+
 	/**
 	 * Scale a value to its monthly equivalent, based on last compression.
 	 * @param base Value to be scaled.
@@ -396,6 +409,7 @@ protected:
 	Date last_compression; ///< Last time the capacities and supplies were compressed.
 	NodeVector nodes;      ///< Nodes in the component.
 	EdgeMatrix edges;      ///< Edges in the component.
+	uint64 last_job_run_time = 0; ///< NOSAVE: Wall-clock run time in microseconds of the last job for this component, 0 if not known.
 
 public:
 	const EdgeMatrix &GetEdges() const { return this->edges; }
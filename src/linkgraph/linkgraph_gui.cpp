@@ -111,6 +111,7 @@ void LinkGraphOverlay::MarkStationViewportLinksDirty(const Station *st)
  */
 void LinkGraphOverlay::RebuildCache(bool incremental)
 {
+	this->draw_index_dirty = true;
 	if (!incremental) {
 		this->dirty = false;
 		this->cached_links.clear();
@@ -364,6 +365,7 @@ inline bool LinkGraphOverlay::IsLinkVisible(Point pta, Point ptb, const DrawPixe
 
 void LinkGraphOverlay::RefreshDrawCache()
 {
+	this->draw_index_dirty = true;
 	for (StationSupplyList::iterator i(this->cached_stations.begin()); i != this->cached_stations.end(); ++i) {
 		const Station *st = Station::GetIfValid(i->id);
 		if (st == nullptr) continue;
@@ -393,6 +395,138 @@ void LinkGraphOverlay::PrepareDraw()
 		this->last_update_number = GetWindowUpdateNumber();
 		this->RefreshDrawCache();
 	}
+	if (this->draw_index_dirty) {
+		this->RebuildDrawIndex();
+	}
+}
+
+/**
+ * Build the grid from the screen space bounds of each item.
+ * @param bounds Bounds of each item, the index of the bounds is the item index.
+ */
+void LinkGraphOverlay::DrawIndex::Build(const std::vector<Rect> &bounds)
+{
+	static const uint MIN_CELL_SHIFT = 7;    ///< Cells are at least 128 pixels wide.
+	static const uint MAX_GRID_SIZE = 64;    ///< Maximum number of cells along each axis.
+	static const uint MAX_ITEM_CELLS = 16;   ///< Maximum number of cells an item may be put in, otherwise it is unindexed.
+
+	this->cell_offsets.clear();
+	this->items.clear();
+	this->unindexed.clear();
+	this->width = 0;
+	this->height = 0;
+	if (bounds.empty()) return;
+
+	Rect extent = bounds[0];
+	for (const Rect &r : bounds) {
+		extent.left = std::min(extent.left, r.left);
+		extent.top = std::min(extent.top, r.top);
+		extent.right = std::max(extent.right, r.right);
+		extent.bottom = std::max(extent.bottom, r.bottom);
+	}
+	this->left = extent.left;
+	this->top = extent.top;
+	this->cell_shift = MIN_CELL_SHIFT;
+	while ((((int64)extent.right - extent.left) >> this->cell_shift) >= MAX_GRID_SIZE || (((int64)extent.bottom - extent.top) >> this->cell_shift) >= MAX_GRID_SIZE) {
+		this->cell_shift++;
+	}
+	this->width = (uint)(((int64)extent.right - extent.left) >> this->cell_shift) + 1;
+	this->height = (uint)(((int64)extent.bottom - extent.top) >> this->cell_shift) + 1;
+
+	auto cell_range = [&](const Rect &r, uint &x0, uint &y0, uint &x1, uint &y1) {
+		x0 = (uint)(((int64)r.left - this->left) >> this->cell_shift);
+		y0 = (uint)(((int64)r.top - this->top) >> this->cell_shift);
+		x1 = (uint)(((int64)r.right - this->left) >> this->cell_shift);
+		y1 = (uint)(((int64)r.bottom - this->top) >> this->cell_shift);
+		return (x1 - x0 + 1) * (y1 - y0 + 1) <= MAX_ITEM_CELLS;
+	};
+
+	/* Count the items of each cell, then fill them in. */
+	this->cell_offsets.assign(this->width * this->height + 1, 0);
+	for (uint i = 0; i < (uint)bounds.size(); i++) {
+		uint x0, y0, x1, y1;
+		if (!cell_range(bounds[i], x0, y0, x1, y1)) continue;
+		for (uint y = y0; y <= y1; y++) {
+			for (uint x = x0; x <= x1; x++) {
+				this->cell_offsets[(y * this->width) + x + 1]++;
+			}
+		}
+	}
+	for (uint i = 1; i < (uint)this->cell_offsets.size(); i++) {
+		this->cell_offsets[i] += this->cell_offsets[i - 1];
+	}
+	this->items.resize(this->cell_offsets.back());
+	std::vector<uint> fill(this->cell_offsets.begin(), this->cell_offsets.end() - 1);
+	for (uint i = 0; i < (uint)bounds.size(); i++) {
+		uint x0, y0, x1, y1;
+		if (!cell_range(bounds[i], x0, y0, x1, y1)) {
+			this->unindexed.push_back(i);
+			continue;
+		}
+		for (uint y = y0; y <= y1; y++) {
+			for (uint x = x0; x <= x1; x++) {
+				this->items[fill[(y * this->width) + x]++] = i;
+			}
+		}
+	}
+}
+
+/**
+ * Get the indices of the items which may be visible in an area, in ascending order.
+ * @param dpi Visible area.
+ * @param padding Extent of the items beyond their bounds.
+ * @param result Vector to store the item indices in.
+ * @return False if the area covers most of the grid, and all items should be checked instead.
+ */
+bool LinkGraphOverlay::DrawIndex::GetItems(const DrawPixelInfo *dpi, int padding, std::vector<uint> &result) const
+{
+	result.clear();
+	if (this->width == 0) return true;
+
+	const int64 left = (int64)dpi->left - padding - this->left;
+	const int64 top = (int64)dpi->top - padding - this->top;
+	const int64 right = (int64)dpi->left + dpi->width + padding - this->left;
+	const int64 bottom = (int64)dpi->top + dpi->height + padding - this->top;
+
+	const int64 x0 = std::max<int64>(0, left >> this->cell_shift);
+	const int64 y0 = std::max<int64>(0, top >> this->cell_shift);
+	const int64 x1 = std::min<int64>(this->width - 1, right >> this->cell_shift);
+	const int64 y1 = std::min<int64>(this->height - 1, bottom >> this->cell_shift);
+
+	if (x0 <= x1 && y0 <= y1) {
+		if ((x1 - x0 + 1) * (y1 - y0 + 1) * 2 > (int64)(this->width * this->height)) return false;
+		for (int64 y = y0; y <= y1; y++) {
+			const uint row = (uint)y * this->width;
+			result.insert(result.end(), this->items.begin() + this->cell_offsets[row + x0], this->items.begin() + this->cell_offsets[row + x1 + 1]);
+		}
+	}
+	result.insert(result.end(), this->unindexed.begin(), this->unindexed.end());
+
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+	return true;
+}
+
+/**
+ * Rebuild the spatial indices of the cached links and stations.
+ */
+void LinkGraphOverlay::RebuildDrawIndex()
+{
+	this->draw_index_dirty = false;
+
+	std::vector<Rect> bounds;
+	bounds.reserve(this->cached_links.size());
+	for (const LinkInfo &link : this->cached_links) {
+		bounds.push_back({ std::min(link.from_pt.x, link.to_pt.x), std::min(link.from_pt.y, link.to_pt.y),
+				std::max(link.from_pt.x, link.to_pt.x), std::max(link.from_pt.y, link.to_pt.y) });
+	}
+	this->link_index.Build(bounds);
+
+	bounds.clear();
+	for (const StationSupplyInfo &station : this->cached_stations) {
+		bounds.push_back({ station.pt.x, station.pt.y, station.pt.x, station.pt.y });
+	}
+	this->station_index.Build(bounds);
 }
 
 /**
@@ -412,11 +546,18 @@ void LinkGraphOverlay::Draw(const DrawPixelInfo *dpi) const
 void LinkGraphOverlay::DrawLinks(const DrawPixelInfo *dpi) const
 {
 	int width = ScaleGUITrad(this->scale);
-	for (LinkList::const_iterator i(this->cached_links.begin()); i != this->cached_links.end(); ++i) {
-		if (!this->IsLinkVisible(i->from_pt, i->to_pt, dpi, width + 2)) continue;
-		if (!Station::IsValidID(i->from_id)) continue;
-		if (!Station::IsValidID(i->to_id)) continue;
-		this->DrawContent(dpi, i->from_pt, i->to_pt, i->prop);
+	auto draw_link = [&](const LinkInfo &link) {
+		if (!this->IsLinkVisible(link.from_pt, link.to_pt, dpi, width + 2)) return;
+		if (!Station::IsValidID(link.from_id)) return;
+		if (!Station::IsValidID(link.to_id)) return;
+		this->DrawContent(dpi, link.from_pt, link.to_pt, link.prop);
+	};
+
+	std::vector<uint> indices;
+	if (!this->draw_index_dirty && this->link_index.GetItems(dpi, width + 2, indices)) {
+		for (uint i : indices) draw_link(this->cached_links[i]);
+	} else {
+		for (const LinkInfo &link : this->cached_links) draw_link(link);
 	}
 }
 
@@ -454,19 +595,26 @@ void LinkGraphOverlay::DrawContent(const DrawPixelInfo *dpi, Point pta, Point pt
 void LinkGraphOverlay::DrawStationDots(const DrawPixelInfo *dpi) const
 {
 	int width = ScaleGUITrad(this->scale);
-	for (StationSupplyList::const_iterator i(this->cached_stations.begin()); i != this->cached_stations.end(); ++i) {
-		const Point &pt = i->pt;
-		if (!this->IsPointVisible(pt, dpi, 3 * width)) continue;
+	auto draw_station = [&](const StationSupplyInfo &info) {
+		const Point &pt = info.pt;
+		if (!this->IsPointVisible(pt, dpi, 3 * width)) return;
 
-		const Station *st = Station::GetIfValid(i->id);
-		if (st == nullptr) continue;
+		const Station *st = Station::GetIfValid(info.id);
+		if (st == nullptr) return;
 
-		uint r = width * 2 + width * 2 * std::min<uint>(200, i->quantity) / 200;
+		uint r = width * 2 + width * 2 * std::min<uint>(200, info.quantity) / 200;
 
 		LinkGraphOverlay::DrawVertex(dpi, pt.x, pt.y, r,
 				_colour_gradient[st->owner != OWNER_NONE ?
 						(Colours)Company::Get(st->owner)->colour : COLOUR_GREY][5],
 				_colour_gradient[COLOUR_GREY][1]);
+	};
+
+	std::vector<uint> indices;
+	if (!this->draw_index_dirty && this->station_index.GetItems(dpi, 3 * width, indices)) {
+		for (uint i : indices) draw_station(this->cached_stations[i]);
+	} else {
+		for (const StationSupplyInfo &info : this->cached_stations) draw_station(info);
 	}
 }
 
@@ -59,6 +59,21 @@ public:
 	typedef std::vector<StationSupplyInfo> StationSupplyList;
 	typedef std::vector<LinkInfo> LinkList;
 
+	/** Coarse grid of screen space cells, listing the indices of the cached items which may be visible in each cell. */
+	struct DrawIndex {
+		int left = 0;                   ///< Left edge of the grid.
+		int top = 0;                    ///< Top edge of the grid.
+		uint cell_shift = 0;            ///< Log2 of the edge length of a cell.
+		uint width = 0;                 ///< Number of cells horizontally.
+		uint height = 0;                ///< Number of cells vertically.
+		std::vector<uint> cell_offsets; ///< Offset of the first item of each cell in items, followed by the total.
+		std::vector<uint> items;        ///< Item indices of all cells.
+		std::vector<uint> unindexed;    ///< Item indices which cover too many cells to be put in the grid.
+
+		void Build(const std::vector<Rect> &bounds);
+		bool GetItems(const DrawPixelInfo *dpi, int padding, std::vector<uint> &result) const;
+	};
+
 	static const uint8 LINK_COLOURS[][12];
 
 	/**
@@ -103,10 +118,14 @@ protected:
 	uint scale;                        ///< Width of link lines.
 	bool dirty;                        ///< Set if overlay should be rebuilt.
 	uint64 last_update_number = 0;     ///< Last window update number
+	DrawIndex link_index;              ///< Spatial index of cached_links, for drawing.
+	DrawIndex station_index;           ///< Spatial index of cached_stations, for drawing.
+	bool draw_index_dirty = true;      ///< Set if link_index and station_index have to be rebuilt.
 
 	Point GetStationMiddle(const Station *st) const;
 
 	void RefreshDrawCache();
+	void RebuildDrawIndex();
 	void DrawLinks(const DrawPixelInfo *dpi) const;
 	void DrawStationDots(const DrawPixelInfo *dpi) const;
 	void DrawContent(const DrawPixelInfo *dpi, Point pta, Point ptb, const LinkProperties &cargo) const;
@@ -48,6 +48,42 @@ LinkGraphJob::LinkGraphJob(const LinkGraph &orig, uint duration_multiplier) :
 		job_completed(false),
 		job_aborted(false)
 {
+	if (this->settings.mcf_warm_start) this->InitWarmStartHops();
+}
+
+/**
+ * Record the flows currently planned at the stations of the link graph as warm start hops.
+ * This has to be done in the main thread when spawning the job, as the station flows are modified by the game.
+ */
+void LinkGraphJob::InitWarmStartHops()
+{
+	const CargoID cargo = this->Cargo();
+	auto get_node = [&](StationID station) -> NodeID {
+		const Station *st = Station::GetIfValid(station);
+		if (st == nullptr) return INVALID_NODE;
+		const GoodsEntry &ge = st->goods[cargo];
+		if (ge.link_graph != this->link_graph.index || ge.node >= this->Size()) return INVALID_NODE;
+		return ge.node;
+	};
+
+	for (NodeID node_id = 0; node_id < this->Size(); ++node_id) {
+		StationID station = this->link_graph[node_id].Station();
+		if (get_node(station) != node_id) continue;
+
+		for (const FlowStat &flow : Station::Get(station)->goods[cargo].flows) {
+			NodeID origin = get_node(flow.GetOrigin());
+			if (origin == INVALID_NODE) continue;
+			for (const FlowStat::ShareEntry &share : flow) {
+				if (share.second == INVALID_STATION || share.second == station) continue;
+				NodeID via = get_node(share.second);
+				if (via == INVALID_NODE) continue;
+				this->warm_start_hops.push_back({ node_id, origin, via });
+			}
+		}
+	}
+
+	std::sort(this->warm_start_hops.begin(), this->warm_start_hops.end());
+	this->warm_start_hops.erase(std::unique(this->warm_start_hops.begin(), this->warm_start_hops.end()), this->warm_start_hops.end());
 }
 
 /**
@@ -194,6 +230,7 @@ void LinkGraphJob::Init()
 {
 	uint size = this->Size();
 	this->nodes.resize(size);
+	this->node_flows.resize(size);
 	for (uint i = 0; i < size; ++i) {
 		this->nodes[i].Init(this->link_graph[i].Supply());
 	}
@@ -250,6 +287,33 @@ void LinkGraphJob::Init()
 		idx++;
 	}
 	flush();
+
+	if (!this->warm_start_hops.empty()) {
+		/* Drop hops along edges which don't exist any more, the origins of those can't be warm started. */
+		this->warm_start_sources.assign(size, true);
+		auto has_edge = [&](const WarmStartHop &hop) -> bool {
+			span<Edge> node_edges = this->nodes[hop.node].edges;
+			auto iter = std::lower_bound(node_edges.begin(), node_edges.end(), hop.via, [](const Edge &edge, NodeID to) {
+				return edge.To() < to;
+			});
+			return iter != node_edges.end() && iter->To() == hop.via;
+		};
+		auto new_end = std::remove_if(this->warm_start_hops.begin(), this->warm_start_hops.end(), [&](const WarmStartHop &hop) -> bool {
+			if (hop.node >= size || hop.origin >= size || hop.via >= size || !has_edge(hop)) {
+				if (hop.origin < size) this->warm_start_sources[hop.origin] = false;
+				return true;
+			}
+			return false;
+		});
+		this->warm_start_hops.erase(new_end, this->warm_start_hops.end());
+
+		for (auto iter = this->warm_start_hops.begin(); iter != this->warm_start_hops.end();) {
+			const NodeID node = iter->node;
+			auto node_end = std::find_if(iter, this->warm_start_hops.end(), [&](const WarmStartHop &hop) { return hop.node != node; });
+			this->node_flows[node].warm_start_hops = { &*iter, (size_t)(node_end - iter) };
+			iter = node_end;
+		}
+	}
 }
 
 /**
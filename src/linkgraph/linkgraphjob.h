@@ -16,6 +16,7 @@
 #include <vector>
 #include <memory>
 #include <atomic>
+#include <tuple>
 
 class LinkGraphJob;
 class Path;
@@ -112,25 +113,55 @@ public:
 
 	typedef std::vector<Edge> EdgeAnnotationVector;
 
+	/**
+	 * Flow hop of the previous solution of the link graph, used to seed a warm-started MCF calculation.
+	 */
+	struct WarmStartHop {
+		NodeID node;             ///< Node the flow passes.
+		NodeID origin;           ///< Origin node of the flow.
+		NodeID via;              ///< Next hop of the flow.
+
+		bool operator<(const WarmStartHop &other) const
+		{
+			return std::tie(this->node, this->origin, this->via) < std::tie(other.node, other.origin, other.via);
+		}
+
+		bool operator==(const WarmStartHop &other) const
+		{
+			return this->node == other.node && this->origin == other.origin && this->via == other.via;
+		}
+	};
+
 private:
 	/**
 	 * Annotation for a link graph node.
+	 * This only contains the data accessed by the inner loops of the demand and MCF calculations, so that it is compact.
 	 */
 	struct NodeAnnotation {
 		uint undelivered_supply; ///< Amount of supply that hasn't been distributed yet.
 		uint received_demand;    ///< Received demand towards this node.
-		PathList paths;          ///< Paths through this node, sorted so that those with flow == 0 are in the back.
-		FlowStatMap flows;       ///< Planned flows to other nodes.
 		span<DemandAnnotation> demands; ///< Demand annotations belonging to this node.
-		span<Edge> edges;        ///< Edges with annotations belonging to this node.
+		span<Edge> edges;        ///< Edges with annotations belonging to this node, sorted by destination. These are contiguous in LinkGraphJob::edges.
 		void Init(uint supply);
 	};
 
+	/**
+	 * Path and flow annotation for a link graph node.
+	 */
+	struct NodeFlowAnnotation {
+		PathList paths;          ///< Paths through this node, sorted so that those with flow == 0 are in the back.
+		FlowStatMap flows;       ///< Planned flows to other nodes.
+		span<const WarmStartHop> warm_start_hops; ///< Warm start flow hops passing this node.
+	};
+
 	typedef std::vector<NodeAnnotation> NodeAnnotationVector;
+	typedef std::vector<NodeFlowAnnotation> NodeFlowAnnotationVector;
 
 	friend SaveLoadTable GetLinkGraphJobDesc();
 	friend upstream_sl::SaveLoadTable upstream_sl::GetLinkGraphJobDesc();
 	friend void GetLinkGraphJobDayLengthScaleAfterLoad(LinkGraphJob *lgj);
+	friend void Save_LinkGraphJobWarmStartHops(LinkGraphJob *lgj);
+	friend void Load_LinkGraphJobWarmStartHops(LinkGraphJob *lgj);
 	friend class LinkGraphSchedule;
 	friend class LinkGraphJobGroup;
 
@@ -142,11 +173,15 @@ protected:
 	DateTicks join_date_ticks;        ///< Date when the job is to be joined.
 	DateTicks start_date_ticks;       ///< Date when the job was started.
 	NodeAnnotationVector nodes;       ///< Extra node data necessary for link graph calculation.
+	NodeFlowAnnotationVector node_flows; ///< Paths and flows of the nodes.
 	EdgeAnnotationVector edges;       ///< Edge data necessary for link graph calculation.
 	std::atomic<bool> job_completed;  ///< Is the job still running. This is accessed by multiple threads and reads may be stale.
 	std::atomic<bool> job_aborted;    ///< Has the job been aborted. This is accessed by multiple threads and reads may be stale.
+	uint64 run_time = 0;              ///< Wall-clock run time of the job handlers in microseconds, only valid once the job has completed.
+	std::vector<WarmStartHop> warm_start_hops; ///< Flow hops of the previous solution at spawn time, sorted. Only used for warm starts.
 
 	void EraseFlows(NodeID from);
+	void InitWarmStartHops();
 	void JoinThread();
 	void SetJobGroup(std::shared_ptr<LinkGraphJobGroup> group);
 
@@ -156,6 +191,41 @@ public:
 	std::vector<DemandAnnotation> demand_annotation_store;        ///< Demand annotation store.
 
 	DynUniformArenaAllocator path_allocator; ///< Arena allocator used for paths
+	std::vector<std::unique_ptr<DynUniformArenaAllocator>> batch_path_allocators; ///< Additional arena allocators used for paths of parallel Dijkstra batches
+
+	/**
+	 * Get the arena allocator used for paths of the given slot of a Dijkstra batch.
+	 * @param slot Slot within the batch, 0 is the main path allocator.
+	 * @return Path allocator.
+	 */
+	DynUniformArenaAllocator &GetPathAllocator(uint slot)
+	{
+		return slot == 0 ? this->path_allocator : *this->batch_path_allocators[slot - 1];
+	}
+
+	/**
+	 * Make sure that path allocators exist for the given number of batch slots.
+	 * @param count Number of slots.
+	 */
+	void ReservePathAllocators(uint count)
+	{
+		while (this->batch_path_allocators.size() + 1 < count) {
+			this->batch_path_allocators.push_back(std::make_unique<DynUniformArenaAllocator>());
+		}
+	}
+
+	/**
+	 * Free all paths of all path allocators.
+	 */
+	void ResetPathAllocators()
+	{
+		this->path_allocator.ResetArena();
+		for (auto &allocator : this->batch_path_allocators) {
+			allocator->ResetArena();
+		}
+	}
+
+	std::vector<bool> warm_start_sources;    ///< Source nodes which are routed along their warm start flow hops instead of by the first MCF pass.
 
 	/**
 	 * Link graph job node. Wraps a constant link graph node and a modifiable
@@ -164,6 +234,7 @@ public:
 	class Node : public LinkGraph::ConstNode {
 	private:
 		NodeAnnotation &node_anno;  ///< Annotation being wrapped.
+		NodeFlowAnnotation &node_flow_anno; ///< Path and flow annotation being wrapped.
 	public:
 
 		/**
@@ -173,7 +244,7 @@ public:
 		 */
 		Node (LinkGraphJob *lgj, NodeID node) :
 			LinkGraph::ConstNode(&lgj->link_graph, node),
-			node_anno(lgj->nodes[node])
+			node_anno(lgj->nodes[node]), node_flow_anno(lgj->node_flows[node])
 		{}
 
 		/**
@@ -192,26 +263,26 @@ public:
 		 * Get the flows running through this node.
 		 * @return Flows.
 		 */
-		FlowStatMap &Flows() { return this->node_anno.flows; }
+		FlowStatMap &Flows() { return this->node_flow_anno.flows; }
 
 		/**
 		 * Get a constant version of the flows running through this node.
 		 * @return Flows.
 		 */
-		const FlowStatMap &Flows() const { return this->node_anno.flows; }
+		const FlowStatMap &Flows() const { return this->node_flow_anno.flows; }
 
 		/**
 		 * Get the paths this node is part of. Paths are always expected to be
 		 * sorted so that those with flow == 0 are in the back of the list.
 		 * @return Paths.
 		 */
-		PathList &Paths() { return this->node_anno.paths; }
+		PathList &Paths() { return this->node_flow_anno.paths; }
 
 		/**
 		 * Get a constant version of the paths this node is part of.
 		 * @return Paths.
 		 */
-		const PathList &Paths() const { return this->node_anno.paths; }
+		const PathList &Paths() const { return this->node_flow_anno.paths; }
 
 		/**
 		 * Deliver some supply, adding demand to the respective edge.
@@ -243,9 +314,11 @@ public:
 
 		Edge &GetEdgeTo(NodeID to)
 		{
-			for (Edge &edge : this->node_anno.edges) {
-				if (edge.To() == to) return edge;
-			}
+			span<Edge> edges = this->node_anno.edges;
+			Edge *edge = std::lower_bound(edges.begin(), edges.end(), to, [](const Edge &edge, NodeID to) {
+				return edge.To() < to;
+			});
+			if (edge != edges.end() && edge->To() == to) return *edge;
 
 			static Edge empty_edge = {};
 			return empty_edge;
@@ -255,6 +328,15 @@ public:
 		{
 			return this->node_anno.edges;
 		}
+
+		/**
+		 * Get the warm start flow hops passing this node, sorted by origin and next hop.
+		 * @return Warm start hops.
+		 */
+		span<const WarmStartHop> GetWarmStartHops() const
+		{
+			return this->node_flow_anno.warm_start_hops;
+		}
 	};
 
 	/**
@@ -311,6 +393,19 @@ public:
 	 */
 	inline DateTicks StartDateTicks() const { return start_date_ticks; }
 
+	/**
+	 * Get the predicted wall-clock run time of the job, this is the run time of the previous job for the same link graph.
+	 * @return Predicted run time in microseconds, or 0 if not known.
+	 */
+	inline uint64 PredictedRunTime() const { return this->link_graph.LastJobRunTime(); }
+
+	/**
+	 * Get the actual wall-clock run time of the job.
+	 * This must only be called once the job has completed.
+	 * @return Run time in microseconds.
+	 */
+	inline uint64 RunTime() const { return this->run_time; }
+
 	/**
 	 * Change the join date on date cheating.
 	 * @param interval Number of days to add.
@@ -16,7 +16,9 @@
 #include "../framerate_type.h"
 #include "../command_func.h"
 #include "../network/network.h"
+#include "../tracing.h"
 #include <algorithm>
+#include <chrono>
 
 #include "../safeguards.h"
 
@@ -130,6 +132,8 @@ bool LinkGraphSchedule::IsJoinWithUnfinishedJobDue() const
  */
 void LinkGraphSchedule::JoinNext()
 {
+	TRACE_SCOPE("LinkGraphSchedule::JoinNext");
+
 	while (!(this->running.empty())) {
 		if (!this->running.front()->IsScheduledToBeJoined()) return;
 		std::unique_ptr<LinkGraphJob> next = std::move(this->running.front());
@@ -137,9 +141,13 @@ void LinkGraphSchedule::JoinNext()
 		LinkGraphID id = next->LinkGraphIndex();
 		next->FinaliseJob(); // joins the thread and finalises the job
 		assert(!next->IsJobAborted());
+		DEBUG(linkgraph, 3, "LinkGraphSchedule::JoinNext(): Joined job: id: %u, nodes: %u, predicted run time: " OTTD_PRINTF64U " us, actual run time: " OTTD_PRINTF64U " us",
+				id, next->Size(), next->PredictedRunTime(), next->RunTime());
+		const uint64 run_time = next->RunTime();
 		next.reset();
 		if (LinkGraph::IsValidID(id)) {
 			LinkGraph *lg = LinkGraph::Get(id);
+			lg->SetLastJobRunTime(run_time);
 			this->Unqueue(lg); // Unqueue to avoid double-queueing recycled IDs.
 			this->Queue(lg);
 		}
@@ -152,11 +160,15 @@ void LinkGraphSchedule::JoinNext()
  */
 /* static */ void LinkGraphSchedule::Run(LinkGraphJob *job)
 {
+	const auto start = std::chrono::steady_clock::now();
+
 	for (uint i = 0; i < lengthof(instance.handlers); ++i) {
 		if (job->IsJobAborted()) return;
 		instance.handlers[i]->Run(*job);
 	}
 
+	job->run_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
 	/*
 	 * Readers of this variable in another thread may see an out of date value.
 	 * However this is OK as this will only happen just as a job is completing,
@@ -255,6 +267,7 @@ void LinkGraphJobGroup::SpawnThread()
 void LinkGraphJobGroup::JoinThread()
 {
 	if (this->thread.joinable()) {
+		LatencyMeasurer latency(LHT_LINKGRAPH_JOIN);
 		this->thread.join();
 	}
 }
@@ -275,28 +288,39 @@ void LinkGraphJobGroup::JoinThread()
 /* static */ void LinkGraphJobGroup::ExecuteJobSet(std::vector<JobInfo> jobs) {
 	const uint thread_budget = 200000;
 
+	/* Jobs are also limited by the total wall-clock run time of the previous jobs for the same link graphs, where known.
+	 * This only changes which jobs share a thread, and not when jobs are joined, so it does not affect the game state. */
+	const uint64 thread_run_time_budget = 20000; // microseconds
+
 	std::sort(jobs.begin(), jobs.end(), [](const JobInfo &a, const JobInfo &b) {
 		return std::make_pair(a.job->JoinDateTicks(), a.cost_estimate) < std::make_pair(b.job->JoinDateTicks(), b.cost_estimate);
 	});
 
 	std::vector<LinkGraphJob *> bucket;
 	uint bucket_cost = 0;
+	uint64 bucket_run_time = 0;
 	DateTicks bucket_join_date = 0;
 	auto flush_bucket = [&]() {
 		if (!bucket_cost) return;
-		DEBUG(linkgraph, 2, "LinkGraphJobGroup::ExecuteJobSet: Creating Job Group: jobs: " PRINTF_SIZE ", cost: %u, join after: %d",
-				bucket.size(), bucket_cost, bucket_join_date - ((_date * DAY_TICKS) + _date_fract));
+		DEBUG(linkgraph, 2, "LinkGraphJobGroup::ExecuteJobSet: Creating Job Group: jobs: " PRINTF_SIZE ", cost: %u, predicted run time: " OTTD_PRINTF64U " us, join after: %d",
+				bucket.size(), bucket_cost, bucket_run_time, bucket_join_date - ((_date * DAY_TICKS) + _date_fract));
 		auto group = std::make_shared<LinkGraphJobGroup>(constructor_token(), std::move(bucket));
 		group->SpawnThread();
 		bucket_cost = 0;
+		bucket_run_time = 0;
 		bucket.clear();
 	};
 
 	for (JobInfo &it : jobs) {
-		if (bucket_cost && (bucket_join_date != it.job->JoinDateTicks() || (bucket_cost + it.cost_estimate > thread_budget))) flush_bucket();
+		const uint64 run_time = it.job->PredictedRunTime();
+		if (bucket_cost && (bucket_join_date != it.job->JoinDateTicks() || (bucket_cost + it.cost_estimate > thread_budget) ||
+				(bucket_run_time + run_time > thread_run_time_budget))) {
+			flush_bucket();
+		}
 		bucket_join_date = it.job->JoinDateTicks();
 		bucket.push_back(it.job);
 		bucket_cost += it.cost_estimate;
+		bucket_run_time += run_time;
 	}
 	flush_bucket();
 }
@@ -3,6 +3,7 @@
 #include "../stdafx.h"
 #include "../core/math_func.hpp"
 #include "mcf.h"
+#include "../worker_thread.h"
 #include "../3rdparty/cpp-btree/btree_map.h"
 #include <set>
 
@@ -158,6 +159,14 @@ public:
 	const Edge &GetSavedEdge() { return *(this->saved); }
 };
 
+/**
+ * Comparator for finding the warm start hops of an origin within the (sorted) hops of a node.
+ */
+struct WarmStartHopOriginComparator {
+	bool operator()(const LinkGraphJob::WarmStartHop &hop, NodeID origin) const { return hop.origin < origin; }
+	bool operator()(NodeID origin, const LinkGraphJob::WarmStartHop &hop) const { return origin < hop.origin; }
+};
+
 /**
  * Iterator class for getting edges from a FlowStatMap.
  */
@@ -173,6 +182,12 @@ private:
 
 	/** End of the shares map. */
 	FlowStat::const_iterator end;
+
+	/** Current warm start hop, if the source is warm started. */
+	const LinkGraphJob::WarmStartHop *hop_it = nullptr;
+
+	/** End of the warm start hops of the current node and source. */
+	const LinkGraphJob::WarmStartHop *hop_end = nullptr;
 public:
 
 	/**
@@ -197,6 +212,19 @@ public:
 	 */
 	void SetNode(NodeID source, NodeID node)
 	{
+		if (!this->job.warm_start_sources.empty() && this->job.warm_start_sources[source]) {
+			/* Warm started sources have no flows from the first pass, use the flows of the previous solution instead. */
+			span<const LinkGraphJob::WarmStartHop> hops = this->job[node].GetWarmStartHops();
+			auto range = std::equal_range(hops.begin(), hops.end(), source, WarmStartHopOriginComparator());
+			this->hop_it = range.first;
+			this->hop_end = range.second;
+			this->it = nullptr;
+			this->end = nullptr;
+			return;
+		}
+		this->hop_it = nullptr;
+		this->hop_end = nullptr;
+
 		const FlowStatMap &flows = this->job[node].Flows();
 		FlowStatMap::const_iterator it = flows.find(this->job[source].Station());
 		if (it != flows.end()) {
@@ -214,6 +242,7 @@ public:
 	 */
 	NodeID Next()
 	{
+		if (this->hop_it != this->hop_end) return (this->hop_it++)->via;
 		if (this->it == this->end) return INVALID_NODE;
 		return this->station_to_node[(this->it++)->second];
 	}
@@ -288,9 +317,10 @@ bool CapacityAnnotation::IsBetter(const CapacityAnnotation *base, uint cap,
  * @tparam Tedge_iterator Iterator to be used for getting outgoing edges.
  * @param source_node Node where the algorithm starts.
  * @param paths Container for the paths to be calculated.
+ * @param allocator Arena allocator for the paths.
  */
 template<class Tannotation, class Tedge_iterator>
-void MultiCommodityFlow::Dijkstra(NodeID source_node, PathVector &paths)
+void MultiCommodityFlow::Dijkstra(NodeID source_node, PathVector &paths, DynUniformArenaAllocator &allocator)
 {
 	typedef btree::btree_set<AnnoSetItem<Tannotation>, typename Tannotation::Comparator> AnnoSet;
 	AnnoSet annos = AnnoSet(typename Tannotation::Comparator());
@@ -298,10 +328,10 @@ void MultiCommodityFlow::Dijkstra(NodeID source_node, PathVector &paths)
 	uint size = this->job.Size();
 	paths.resize(size, nullptr);
 
-	this->job.path_allocator.SetParameters(sizeof(Tannotation), (8192 - 32) / sizeof(Tannotation));
+	allocator.SetParameters(sizeof(Tannotation), (8192 - 32) / sizeof(Tannotation));
 
 	for (NodeID node = 0; node < size; ++node) {
-		Tannotation *anno = new (this->job.path_allocator.Allocate()) Tannotation(node, node == source_node);
+		Tannotation *anno = new (allocator.Allocate()) Tannotation(node, node == source_node);
 		anno->UpdateAnnotation();
 		if (node == source_node) {
 			annos.insert(AnnoSetItem<Tannotation>(anno));
@@ -337,12 +367,45 @@ void MultiCommodityFlow::Dijkstra(NodeID source_node, PathVector &paths)
 	}
 }
 
+/**
+ * Run the Dijkstra algorithm for a batch of sources. The paths of all sources are searched for using
+ * the edge flows as they are before the batch, which allows them to be searched for in parallel.
+ * @tparam Tannotation Annotation to be used.
+ * @tparam Tedge_iterator Iterator to be used for getting outgoing edges.
+ * @param first First source node of the batch.
+ * @param last One past the last source node of the batch.
+ * @param finished_sources Sources to skip.
+ * @param batch_paths Output paths for each source of the batch, indexed by source - first.
+ */
+template<class Tannotation, class Tedge_iterator>
+void MultiCommodityFlow::DijkstraBatch(NodeID first, NodeID last, const std::vector<bool> &finished_sources, std::vector<PathVector> &batch_paths)
+{
+	const uint count = last - first;
+	batch_paths.resize(std::max<size_t>(batch_paths.size(), count));
+	if (count == 1) {
+		if (!finished_sources[first]) this->Dijkstra<Tannotation, Tedge_iterator>(first, batch_paths[0], this->job.GetPathAllocator(0));
+		return;
+	}
+
+	this->job.ReservePathAllocators(count);
+	WorkerTaskGroup group;
+	for (NodeID source = first; source < last; ++source) {
+		if (finished_sources[source]) continue;
+		group.Run([this, source, first, &batch_paths]() {
+			const uint slot = source - first;
+			this->Dijkstra<Tannotation, Tedge_iterator>(source, batch_paths[slot], this->job.GetPathAllocator(slot));
+		});
+	}
+	group.Wait();
+}
+
 /**
  * Clean up paths that lead nowhere and the root path.
  * @param source_id ID of the root node.
  * @param paths Paths to be cleaned up.
+ * @param allocator Arena allocator the paths were allocated from.
  */
-void MultiCommodityFlow::CleanupPaths(NodeID source_id, PathVector &paths)
+void MultiCommodityFlow::CleanupPaths(NodeID source_id, PathVector &paths, DynUniformArenaAllocator &allocator)
 {
 	Path *source = paths[source_id];
 	paths[source_id] = nullptr;
@@ -355,12 +418,12 @@ void MultiCommodityFlow::CleanupPaths(NodeID source_id, PathVector &paths)
 			path->Detach();
 			if (path->GetNumChildren() == 0) {
 				paths[path->GetNode()] = nullptr;
-				this->job.path_allocator.Free(path);
+				allocator.Free(path);
 			}
 			path = parent;
 		}
 	}
-	this->job.path_allocator.Free(source);
+	allocator.Free(source);
 	paths.clear();
 }
 
@@ -529,18 +592,88 @@ bool MCF1stPass::EliminateCycles()
 	return cycles_found;
 }
 
+/**
+ * Decide which sources can be warm started, i.e. routed along the flows of the previous solution in the second pass only.
+ * A source can be warm started if none of its previous flows ran along removed edges, all destinations it has demand to
+ * are reachable along its previous flows, and the nodes on those flows don't have any edges which no previous flow used.
+ * If too many sources can't be warm started the whole job is calculated from scratch.
+ * @param job Link graph job to calculate.
+ */
+static void SetupWarmStartSources(LinkGraphJob &job)
+{
+	if (job.warm_start_sources.empty()) return;
+
+	uint16 size = job.Size();
+	std::vector<bool> reached(size);
+	std::vector<NodeID> queue;
+	uint sources = 0;
+	uint cold_sources = 0;
+	for (NodeID source = 0; source < size; ++source) {
+		span<DemandAnnotation> demands = job[source].GetDemandAnnotations();
+		if (std::none_of(demands.begin(), demands.end(), [](const DemandAnnotation &anno) { return anno.unsatisfied_demand > 0; })) {
+			job.warm_start_sources[source] = false;
+			continue;
+		}
+		sources++;
+
+		bool warm = job.warm_start_sources[source];
+		if (warm) {
+			std::fill(reached.begin(), reached.end(), false);
+			queue.clear();
+			queue.push_back(source);
+			reached[source] = true;
+			for (size_t i = 0; i < queue.size() && warm; i++) {
+				Node node = job[queue[i]];
+				span<const LinkGraphJob::WarmStartHop> hops = node.GetWarmStartHops();
+				for (const Edge &edge : node.GetEdges()) {
+					if (std::none_of(hops.begin(), hops.end(), [&](const LinkGraphJob::WarmStartHop &hop) { return hop.via == edge.To(); })) {
+						/* New or unused edge, this might be a better route. */
+						warm = false;
+						break;
+					}
+				}
+				auto range = std::equal_range(hops.begin(), hops.end(), source, WarmStartHopOriginComparator());
+				for (auto it = range.first; it != range.second; ++it) {
+					if (!reached[it->via]) {
+						reached[it->via] = true;
+						queue.push_back(it->via);
+					}
+				}
+			}
+			if (warm) {
+				warm = std::all_of(demands.begin(), demands.end(), [&](const DemandAnnotation &anno) {
+					return anno.unsatisfied_demand == 0 || reached[anno.dest];
+				});
+			}
+		}
+		job.warm_start_sources[source] = warm;
+		if (!warm) cold_sources++;
+	}
+
+	if (cold_sources * 4 > sources) {
+		/* Too much of the graph has changed, do a full recalculation. */
+		job.warm_start_sources.clear();
+	}
+}
+
 /**
  * Run the first pass of the MCF calculation.
  * @param job Link graph job to calculate.
  */
 MCF1stPass::MCF1stPass(LinkGraphJob &job) : MultiCommodityFlow(job)
 {
-	PathVector paths;
+	std::vector<PathVector> batch_paths;
 	uint16 size = job.Size();
 	uint accuracy = job.Settings().accuracy;
 	bool more_loops;
 	std::vector<bool> finished_sources(size);
 
+	SetupWarmStartSources(job);
+	if (!job.warm_start_sources.empty()) {
+		/* Warm started sources are only routed in the second pass. */
+		finished_sources = job.warm_start_sources;
+	}
+
 	uint min_step_size = 1;
 	const uint adjust_threshold = 50;
 	if (size >= adjust_threshold) {
@@ -562,35 +695,40 @@ MCF1stPass::MCF1stPass(LinkGraphJob &job) : MultiCommodityFlow(job)
 
 	do {
 		more_loops = false;
-		for (NodeID source = 0; source < size; ++source) {
-			if (finished_sources[source]) continue;
+		for (NodeID first = 0; first < size; first += this->batch_size) {
+			NodeID last = std::min<uint>(size, first + this->batch_size);
 
 			/* First saturate the shortest paths. */
-			this->Dijkstra<DistanceAnnotation, GraphEdgeIterator>(source, paths);
+			this->DijkstraBatch<DistanceAnnotation, GraphEdgeIterator>(first, last, finished_sources, batch_paths);
 
-			bool source_demand_left = false;
-			for (DemandAnnotation &anno : job[source].GetDemandAnnotations()) {
-				NodeID dest = anno.dest;
-				if (anno.unsatisfied_demand > 0) {
-					Path *path = paths[dest];
-					assert(path != nullptr);
-					/* Generally only allow paths that don't exceed the
-					 * available capacity. But if no demand has been assigned
-					 * yet, make an exception and allow any valid path *once*. */
-					if (path->GetFreeCapacity() > 0 && this->PushFlow(anno, path,
-							min_step_size, accuracy, this->max_saturation) > 0) {
-						/* If a path has been found there is a chance we can
-						 * find more. */
-						more_loops = more_loops || (anno.unsatisfied_demand > 0);
-					} else if (anno.unsatisfied_demand == anno.demand &&
-							path->GetFreeCapacity() > INT_MIN) {
-						this->PushFlow(anno, path, min_step_size, accuracy, UINT_MAX);
+			for (NodeID source = first; source < last; ++source) {
+				if (finished_sources[source]) continue;
+
+				PathVector &paths = batch_paths[source - first];
+				bool source_demand_left = false;
+				for (DemandAnnotation &anno : job[source].GetDemandAnnotations()) {
+					NodeID dest = anno.dest;
+					if (anno.unsatisfied_demand > 0) {
+						Path *path = paths[dest];
+						assert(path != nullptr);
+						/* Generally only allow paths that don't exceed the
+						 * available capacity. But if no demand has been assigned
+						 * yet, make an exception and allow any valid path *once*. */
+						if (path->GetFreeCapacity() > 0 && this->PushFlow(anno, path,
+								min_step_size, accuracy, this->max_saturation) > 0) {
+							/* If a path has been found there is a chance we can
+							 * find more. */
+							more_loops = more_loops || (anno.unsatisfied_demand > 0);
+						} else if (anno.unsatisfied_demand == anno.demand &&
+								path->GetFreeCapacity() > INT_MIN) {
+							this->PushFlow(anno, path, min_step_size, accuracy, UINT_MAX);
+						}
+						if (anno.unsatisfied_demand > 0) source_demand_left = true;
 					}
-					if (anno.unsatisfied_demand > 0) source_demand_left = true;
 				}
+				if (!source_demand_left) finished_sources[source] = true;
+				this->CleanupPaths(source, paths, job.GetPathAllocator(source - first));
 			}
-			if (!source_demand_left) finished_sources[source] = true;
-			this->CleanupPaths(source, paths);
 		}
 	} while ((more_loops || this->EliminateCycles()) && !job.IsJobAborted());
 }
@@ -603,32 +741,37 @@ MCF1stPass::MCF1stPass(LinkGraphJob &job) : MultiCommodityFlow(job)
 MCF2ndPass::MCF2ndPass(LinkGraphJob &job) : MultiCommodityFlow(job)
 {
 	this->max_saturation = UINT_MAX; // disable artificial cap on saturation
-	PathVector paths;
+	std::vector<PathVector> batch_paths;
 	uint16 size = job.Size();
 	uint accuracy = job.Settings().accuracy;
 	bool demand_left = true;
 	std::vector<bool> finished_sources(size);
 	while (demand_left && !job.IsJobAborted()) {
 		demand_left = false;
-		for (NodeID source = 0; source < size; ++source) {
-			if (finished_sources[source]) continue;
-
-			this->Dijkstra<CapacityAnnotation, FlowEdgeIterator>(source, paths);
-
-			bool source_demand_left = false;
-			for (DemandAnnotation &anno : this->job[source].GetDemandAnnotations()) {
-				if (anno.unsatisfied_demand == 0) continue;
-				Path *path = paths[anno.dest];
-				if (path->GetFreeCapacity() > INT_MIN) {
-					this->PushFlow(anno, path, 1, accuracy, UINT_MAX);
-					if (anno.unsatisfied_demand > 0) {
-						demand_left = true;
-						source_demand_left = true;
+		for (NodeID first = 0; first < size; first += this->batch_size) {
+			NodeID last = std::min<uint>(size, first + this->batch_size);
+
+			this->DijkstraBatch<CapacityAnnotation, FlowEdgeIterator>(first, last, finished_sources, batch_paths);
+
+			for (NodeID source = first; source < last; ++source) {
+				if (finished_sources[source]) continue;
+
+				PathVector &paths = batch_paths[source - first];
+				bool source_demand_left = false;
+				for (DemandAnnotation &anno : this->job[source].GetDemandAnnotations()) {
+					if (anno.unsatisfied_demand == 0) continue;
+					Path *path = paths[anno.dest];
+					if (path->GetFreeCapacity() > INT_MIN) {
+						this->PushFlow(anno, path, 1, accuracy, UINT_MAX);
+						if (anno.unsatisfied_demand > 0) {
+							demand_left = true;
+							source_demand_left = true;
+						}
 					}
 				}
+				if (!source_demand_left) finished_sources[source] = true;
+				this->CleanupPaths(source, paths, job.GetPathAllocator(source - first));
 			}
-			if (!source_demand_left) finished_sources[source] = true;
-			this->CleanupPaths(source, paths);
 		}
 	}
 }
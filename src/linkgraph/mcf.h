@@ -18,18 +18,23 @@ protected:
 	 * @param job Link graph job being executed.
 	 */
 	MultiCommodityFlow(LinkGraphJob &job) : job(job),
-			max_saturation(job.Settings().short_path_saturation)
+			max_saturation(job.Settings().short_path_saturation),
+			batch_size(std::max<uint>(1, job.Settings().mcf_parallel_batch))
 	{}
 
 	template<class Tannotation, class Tedge_iterator>
-	void Dijkstra(NodeID from, PathVector &paths);
+	void Dijkstra(NodeID from, PathVector &paths, DynUniformArenaAllocator &allocator);
+
+	template<class Tannotation, class Tedge_iterator>
+	void DijkstraBatch(NodeID first, NodeID last, const std::vector<bool> &finished_sources, std::vector<PathVector> &batch_paths);
 
 	uint PushFlow(DemandAnnotation &anno, Path *path, uint min_step_size, uint accuracy, uint max_saturation);
 
-	void CleanupPaths(NodeID source, PathVector &paths);
+	void CleanupPaths(NodeID source, PathVector &paths, DynUniformArenaAllocator &allocator);
 
 	LinkGraphJob &job;   ///< Job we're working with.
 	uint max_saturation; ///< Maximum saturation for edges.
+	uint batch_size;     ///< Number of sources whose paths are searched for at once.
 };
 
 /**
@@ -17,6 +17,60 @@
 
 #include "../safeguards.h"
 
+/** Everything a refresher run without refits or full loading depends on, see LinkRefresher::Run. */
+struct LinkRefreshRunKey {
+	const OrderList *orders;      ///< Order list of the vehicle.
+	VehicleOrderID order_index;   ///< Current implicit order index of the vehicle.
+	CargoTypes cargo_mask;        ///< Cargoes to refresh.
+	CargoTypes have_cargo_mask;   ///< Cargoes the vehicle carries.
+	int max_speed;                ///< Display max speed of the vehicle.
+	std::vector<uint32> state;    ///< Orders in the list and cargo and capacity of each part of the consist.
+
+	bool operator<(const LinkRefreshRunKey &other) const
+	{
+		return std::tie(this->orders, this->order_index, this->cargo_mask, this->have_cargo_mask, this->max_speed, this->state) <
+				std::tie(other.orders, other.order_index, other.cargo_mask, other.have_cargo_mask, other.max_speed, other.state);
+	}
+};
+
+static btree::btree_set<LinkRefreshRunKey> _link_refresh_runs; ///< Refresher runs done since the cache was activated.
+static bool _link_refresh_runs_active = false;
+
+/**
+ * Enable or disable skipping refresher runs identical to one already done.
+ * Refreshing links is idempotent while the game time does not change, so the cache must only be active during a single tick. It is cleared when it is disabled.
+ * @param active whether to record and skip identical runs
+ */
+/* static */ void LinkRefresher::SetRunCacheActive(bool active)
+{
+	_link_refresh_runs_active = active;
+	_link_refresh_runs.clear();
+}
+
+/**
+ * Record a refresher run without refits or full loading, and check whether an identical run was already done.
+ * Vehicles sharing orders which would refresh exactly the same links can then skip the run.
+ * @param v Vehicle to refresh links for.
+ * @param cargo_mask Cargoes to refresh.
+ * @param have_cargo_mask Cargoes the vehicle carries.
+ * @return True if the run has to be done, false if an identical run was already done.
+ */
+static bool RecordLinkRefreshRun(const Vehicle *v, CargoTypes cargo_mask, CargoTypes have_cargo_mask)
+{
+	if (!_link_refresh_runs_active) return true;
+
+	LinkRefreshRunKey key{ v->orders, v->cur_implicit_order_index, cargo_mask, have_cargo_mask, v->GetDisplayMaxSpeed(), {} };
+	/* Implicit orders can be inserted and removed during the tick, so the list contents are part of the key. */
+	for (const Order *o = v->orders->GetFirstOrder(); o != nullptr; o = o->next) {
+		key.state.push_back(o->index);
+		key.state.push_back(((uint32)o->GetType() << 16) | o->GetDestination());
+	}
+	for (const Vehicle *u = v; u != nullptr; u = u->Next()) {
+		key.state.push_back(((uint32)u->cargo_type << 16) | u->refit_cap);
+	}
+	return _link_refresh_runs.insert(std::move(key)).second;
+}
+
 /**
  * Refresh all links the given vehicle will visit.
  * @param v Vehicle to refresh links for.
@@ -34,7 +88,9 @@
 	/* Scan orders for cargo-specific load/unload, and run LinkRefresher separately for each set of cargoes where they differ. */
 	while (cargo_mask != 0) {
 		CargoTypes iter_cargo_mask = cargo_mask;
+		bool has_refit = false;
 		for (const Order *o = v->orders->GetFirstOrder(); o != nullptr; o = o->next) {
+			if ((o->IsType(OT_GOTO_DEPOT) || o->IsType(OT_GOTO_STATION)) && o->IsRefit()) has_refit = true;
 			if (o->IsType(OT_GOTO_STATION) || o->IsType(OT_IMPLICIT)) {
 				if (o->GetUnloadType() == OUFB_CARGO_TYPE_UNLOAD) {
 					CargoMaskValueFilter<uint>(iter_cargo_mask, [&](CargoID cargo) -> uint {
@@ -49,6 +105,12 @@
 			}
 		}
 
+		/* Refit capacities and full load estimates depend on the individual vehicle, otherwise skip runs which were already done for an identical vehicle. */
+		if (allow_merge && !is_full_loading && !has_refit && !RecordLinkRefreshRun(v, iter_cargo_mask, have_cargo_mask)) {
+			cargo_mask &= ~iter_cargo_mask;
+			continue;
+		}
+
 		/* Make sure the first order is a useful order. */
 		const Order *first = v->orders->GetNextDecisionNode(v->GetOrder(v->cur_implicit_order_index), 0, iter_cargo_mask);
 		if (first != nullptr) {
@@ -22,6 +22,7 @@
 class LinkRefresher {
 public:
 	static void Run(Vehicle *v, bool allow_merge = true, bool is_full_loading = false, CargoTypes cargo_mask = ALL_CARGOTYPES);
+	static void SetRunCacheActive(bool active);
 
 protected:
 	/**
@@ -14,10 +14,15 @@
 #include "string_func.h"
 #include "rail_map.h"
 #include "tunnelbridge_map.h"
+#include "pathfinder/water_regions.h"
 #include "3rdparty/cpp-btree/btree_map.h"
 #include <array>
 #include <deque>
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 #include "safeguards.h"
 
 #if defined(_MSC_VER)
@@ -55,6 +60,32 @@ bool ValidateMapSize(uint size_x, uint size_y)
 	return true;
 }
 
+/**
+ * Allocate a zeroed per-tile map array.
+ * Tile accesses are scattered over the whole array, so on Linux large arrays are aligned to
+ * and advised for transparent huge pages, to reduce the number of TLB misses.
+ * @param count Number of tiles.
+ * @return The allocated array, to be released with free().
+ */
+template <typename T>
+static T *AllocateMapArray(size_t count)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	static const uint HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+	const size_t bytes = count * sizeof(T);
+	if (bytes >= HUGE_PAGE_SIZE) {
+		const size_t aligned_bytes = Align(bytes, HUGE_PAGE_SIZE);
+		void *ptr = nullptr;
+		if (posix_memalign(&ptr, HUGE_PAGE_SIZE, aligned_bytes) == 0) {
+			madvise(ptr, aligned_bytes, MADV_HUGEPAGE);
+			memset(ptr, 0, bytes);
+			return static_cast<T *>(ptr);
+		}
+	}
+#endif
+	return CallocT<T>(count);
+}
+
 /**
  * (Re)allocates a map with the given dimension
  * @param size_x the width of the map along the NE/SW edge
@@ -79,8 +110,10 @@ void AllocateMap(uint size_x, uint size_y)
 	free(_m);
 	free(_me);
 
-	_m = CallocT<Tile>(_map_size);
-	_me = CallocT<TileExtended>(_map_size);
+	_m = AllocateMapArray<Tile>(_map_size);
+	_me = AllocateMapArray<TileExtended>(_map_size);
+
+	AllocateWaterRegions();
 }
 
 
@@ -0,0 +1,95 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file memory_stats.cpp Implementation of the statistics of the memory used by pools and the containers held by pool items. */
+
+#include "stdafx.h"
+#include "memory_stats.h"
+#include "vehicle_base.h"
+#include "station_base.h"
+#include "order_base.h"
+#include "cargopacket.h"
+
+#include "safeguards.h"
+
+/**
+ * Get the occupancy statistics of all pools.
+ * @return The statistics, in the order the pools were created.
+ */
+std::vector<PoolStats> GetPoolStats()
+{
+	std::vector<PoolStats> stats;
+	for (const PoolBase *pool : *PoolBase::GetPools()) {
+		stats.push_back(pool->GetStats());
+	}
+	return stats;
+}
+
+/**
+ * Get the memory used by the containers of cargo packets, flows and orders held by pool items.
+ * The items the containers point to are not included, they are counted in their own pools.
+ * The sizes are estimated from the capacity or number of entries, the internal overhead of the
+ * standard containers (e.g. tree nodes or deque blocks) is not included unless stated otherwise.
+ * @return The statistics.
+ */
+std::vector<ContainerMemoryStats> GetContainerMemoryStats()
+{
+	ContainerMemoryStats vehicle_cargo = { "vehicle cargo lists", 0, 0, 0 };
+	for (const Vehicle *v : Vehicle::Iterate()) {
+		const size_t packets = v->cargo.Packets()->size();
+		if (packets == 0) continue;
+		vehicle_cargo.containers++;
+		vehicle_cargo.entries += packets;
+		vehicle_cargo.bytes += packets * sizeof(CargoPacket *);
+	}
+
+	ContainerMemoryStats station_cargo = { "station cargo lists", 0, 0, 0 };
+	ContainerMemoryStats flows = { "station flows", 0, 0, 0 };
+	for (const Station *st : Station::Iterate()) {
+		for (const GoodsEntry &ge : st->goods) {
+			const StationCargoPacketMap *packets = ge.cargo.Packets();
+			if (!packets->empty()) {
+				station_cargo.containers++;
+				for (const auto &it : *packets) {
+					station_cargo.entries += it.second.size();
+					station_cargo.bytes += sizeof(it) + it.second.size() * sizeof(CargoPacket *);
+				}
+			}
+			if (!ge.flows.empty()) {
+				flows.containers++;
+				flows.entries += ge.flows.size();
+				flows.bytes += ge.flows.GetMemoryUsage();
+			}
+		}
+	}
+
+	ContainerMemoryStats orders = { "order lists", 0, 0, 0 };
+	for (const OrderList *list : OrderList::Iterate()) {
+		orders.containers++;
+		orders.entries += list->GetNumOrders();
+		orders.bytes += list->GetMemoryUsage();
+	}
+	for (const Order *o : Order::Iterate()) {
+		if (o->HasExtraInfo()) orders.bytes += sizeof(OrderExtraInfo);
+	}
+
+	return { vehicle_cargo, station_cargo, flows, orders };
+}
+
+/**
+ * Release the unused tail of the index slots and the allocation caches of all pools.
+ * The indices of all items stay the same, so the order of iteration and any saved IDs are not affected.
+ * @return Number of bytes released.
+ */
+size_t CompactPools()
+{
+	size_t released = 0;
+	for (PoolBase *pool : *PoolBase::GetPools()) {
+		released += pool->ShrinkToFit();
+	}
+	return released;
+}
@@ -0,0 +1,29 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file memory_stats.h Statistics of the memory used by pools and the containers held by pool items. */
+
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include "core/pool_type.hpp"
+
+#include <vector>
+
+/** Memory used by one kind of container held by pool items, see #GetContainerMemoryStats. */
+struct ContainerMemoryStats {
+	const char *name;  ///< Name of the kind of container.
+	size_t containers; ///< Number of non-empty containers.
+	size_t entries;    ///< Number of entries in all containers.
+	size_t bytes;      ///< Estimated number of bytes allocated by all containers.
+};
+
+std::vector<PoolStats> GetPoolStats();
+std::vector<ContainerMemoryStats> GetContainerMemoryStats();
+size_t CompactPools();
+
+#endif /* MEMORY_STATS_H */
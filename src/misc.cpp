@@ -39,6 +39,7 @@
 #include "cargopacket.h"
 #include "tbtr_template_vehicle_func.h"
 #include "event_logs.h"
+#include "saveload/saveload.h"
 
 #include "safeguards.h"
 
@@ -81,6 +82,7 @@ void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settin
 	ViewportMapClearTunnelCache();
 	ClearCommandLog();
 	ClearCommandQueue();
+	InvalidateAutosaveStateFingerprint();
 	ClearSpecialEventsLog();
 	ClearDesyncMsgLog();
 
@@ -129,6 +131,7 @@ void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settin
 	ClearNewSignalStyleMapping();
 
 	RebuildStationKdtree();
+	RebuildStationsWithLoadingVehicles();
 	RebuildTownKdtree();
 	RebuildViewportKdtree();
 
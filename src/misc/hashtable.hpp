@@ -254,4 +254,141 @@ public:
 	}
 };
 
+/**
+ * class CGenerationalHashTableT<Titem, Thash_bits> - simple hash table
+ *  of pointers allocated elsewhere, which can be cleared in constant time.
+ *
+ *  Each slot is stamped with the generation in which it was last used,
+ *  slots stamped with an older generation are treated as empty.
+ *  Clearing the table only starts a new generation.
+ *
+ *  The requirements on Titem are the same as for CHashTableT.
+ */
+template <class Titem_, int Thash_bits_>
+class CGenerationalHashTableT {
+public:
+	typedef Titem_ Titem;                         // make Titem_ visible from outside of class
+	typedef typename Titem_::Key Tkey;            // make Titem_::Key a property of HashTable
+	static const int Thash_bits = Thash_bits_;    // publish num of hash bits
+	static const int Tcapacity = 1 << Thash_bits; // and num of slots 2^bits
+
+protected:
+	struct Slot : public CHashTableSlotT<Titem_> {
+		uint32 m_generation = 0;
+	};
+
+	Slot   m_slots[Tcapacity]; // here we store our data (array of blobs)
+	int    m_num_items;        // item counter
+	uint32 m_generation;       // current generation, slots of any other generation are empty
+
+public:
+	/* default constructor */
+	inline CGenerationalHashTableT() : m_num_items(0), m_generation(1)
+	{
+	}
+
+protected:
+	/** static helper - return hash for the given key modulo number of slots */
+	inline static int CalcHash(const Tkey &key)
+	{
+		uint32 hash = key.CalcHash();
+		hash -= (hash >> 17);          // hash * 131071 / 131072
+		hash -= (hash >> 5);           //   * 31 / 32
+		hash &= (1 << Thash_bits) - 1; //   modulo slots
+		return hash;
+	}
+
+	/** return the slot for the given key, clearing it first if it is left over from an older generation */
+	inline Slot &GetSlot(const Tkey &key)
+	{
+		Slot &slot = m_slots[CalcHash(key)];
+		if (slot.m_generation != m_generation) {
+			slot.Clear();
+			slot.m_generation = m_generation;
+		}
+		return slot;
+	}
+
+public:
+	/** item count */
+	inline int Count() const
+	{
+		return m_num_items;
+	}
+
+	/** forget all items, in constant time except when the generation counter wraps */
+	inline void Clear()
+	{
+		m_num_items = 0;
+		m_generation++;
+		if (m_generation == 0) {
+			for (int i = 0; i < Tcapacity; i++) {
+				m_slots[i].Clear();
+				m_slots[i].m_generation = 0;
+			}
+			m_generation = 1;
+		}
+	}
+
+	/** const item search */
+	const Titem_ *Find(const Tkey &key) const
+	{
+		const Slot &slot = m_slots[CalcHash(key)];
+		if (slot.m_generation != m_generation) return nullptr;
+		return slot.Find(key);
+	}
+
+	/** non-const item search */
+	Titem_ *Find(const Tkey &key)
+	{
+		Slot &slot = m_slots[CalcHash(key)];
+		if (slot.m_generation != m_generation) return nullptr;
+		return slot.Find(key);
+	}
+
+	/** non-const item search & optional removal (if found) */
+	Titem_ *TryPop(const Tkey &key)
+	{
+		Titem_ *item = GetSlot(key).Detach(key);
+		if (item != nullptr) {
+			m_num_items--;
+		}
+		return item;
+	}
+
+	/** non-const item search & removal */
+	Titem_& Pop(const Tkey &key)
+	{
+		Titem_ *item = TryPop(key);
+		assert(item != nullptr);
+		return *item;
+	}
+
+	/** non-const item search & optional removal (if found) */
+	bool TryPop(Titem_ &item)
+	{
+		bool ret = GetSlot(item.GetKey()).Detach(item);
+		if (ret) {
+			m_num_items--;
+		}
+		return ret;
+	}
+
+	/** non-const item search & removal */
+	void Pop(Titem_ &item)
+	{
+		[[maybe_unused]] bool ret = TryPop(item);
+		assert(ret);
+	}
+
+	/** add one item - copy it from the given item */
+	void Push(Titem_ &new_item)
+	{
+		Slot &slot = GetSlot(new_item.GetKey());
+		assert(slot.Find(new_item.GetKey()) == nullptr);
+		slot.Attach(new_item);
+		m_num_items++;
+	}
+};
+
 #endif /* HASHTABLE_HPP */
@@ -11,10 +11,17 @@
 #include <math.h>
 #include <mutex>
 #include <atomic>
+#include <vector>
 #include "core/math_func.hpp"
 #include "framerate_type.h"
 #include "settings_type.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "safeguards.h"
 #include "mixer.h"
 
@@ -27,17 +34,16 @@ struct MixerChannel {
 	/* pointer to allocated buffer memory */
 	int8 *memory;
 
-	/* current position in memory */
+	/* samples converted to 16 bit at the play rate, see MxSetChannelRawSrc */
+	std::vector<int16> samples;
+
+	/* current position in samples */
 	uint32 pos;
-	uint32 frac_pos;
-	uint32 frac_speed;
 	uint32 samples_left;
 
 	/* Mixing volume */
 	int volume_left;
 	int volume_right;
-
-	bool is16bit;
 };
 
 static std::atomic<uint8> _active_channels;
@@ -69,76 +75,90 @@ static int RateConversion(T *b, int frac_pos)
 	return ((b[0] * ((1 << 16) - frac_pos)) + (b[1] * frac_pos)) >> 16;
 }
 
-static void mix_int16(MixerChannel *sc, int16 *buffer, uint samples, uint8 effect_vol)
+/**
+ * Convert a sample to 16 bit at the play rate.
+ * 8 bit samples are scaled up by 256, so mixing them with the 16 bit volume shift is exactly
+ * the same as mixing the 8 bit sample with an 8 bit volume shift.
+ * @param mem the sample, followed by at least one padding element
+ * @param out the converted sample, its size is the number of samples to produce
+ * @param frac_speed the input samples per output sample, as 16.16 fixed point
+ * @param shift the left shift to scale the input up to 16 bit
+ * @tparam T the size of the buffer (8 or 16 bits)
+ */
+template <typename T>
+static void ResampleToPlayRate(const T *mem, std::vector<int16> &out, uint32 frac_speed, uint shift)
 {
-	if (samples > sc->samples_left) samples = sc->samples_left;
-	sc->samples_left -= samples;
-	assert(samples > 0);
-
-	const int16 *b = (const int16 *)sc->memory + sc->pos;
-	uint32 frac_pos = sc->frac_pos;
-	uint32 frac_speed = sc->frac_speed;
-	int volume_left = sc->volume_left * effect_vol / 255;
-	int volume_right = sc->volume_right * effect_vol / 255;
+	const T *b = mem;
+	uint32 frac_pos = 0;
+	for (int16 &sample : out) {
+		sample = (int16)(RateConversion(b, frac_pos) * (1 << shift));
+		frac_pos += frac_speed;
+		b += frac_pos >> 16;
+		frac_pos &= 0xffff;
+	}
+}
 
-	if (frac_speed == 0x10000) {
-		/* Special case when frac_speed is 0x10000 */
-		do {
-			buffer[0] = Clamp(buffer[0] + (*b * volume_left  >> 16), -MAX_VOLUME, MAX_VOLUME);
-			buffer[1] = Clamp(buffer[1] + (*b * volume_right >> 16), -MAX_VOLUME, MAX_VOLUME);
-			b++;
-			buffer += 2;
-		} while (--samples > 0);
-	} else {
-		do {
-			int data = RateConversion(b, frac_pos);
-			buffer[0] = Clamp(buffer[0] + (data * volume_left  >> 16), -MAX_VOLUME, MAX_VOLUME);
-			buffer[1] = Clamp(buffer[1] + (data * volume_right >> 16), -MAX_VOLUME, MAX_VOLUME);
-			buffer += 2;
-			frac_pos += frac_speed;
-			b += frac_pos >> 16;
-			frac_pos &= 0xffff;
-		} while (--samples > 0);
+/**
+ * Mix a 16 bit mono sample into the stereo buffer.
+ * @param buffer the interleaved stereo buffer
+ * @param b the samples to mix
+ * @param samples the number of samples to mix
+ * @param volume_left the volume of the left channel
+ * @param volume_right the volume of the right channel
+ */
+static void MixSamples(int16 *buffer, const int16 *b, uint samples, int volume_left, int volume_right)
+{
+	uint i = 0;
+
+	/* The vector kernels multiply the volume as 16 bit, and clamp to the same range as the scalar path. */
+	if (volume_left <= INT16_MAX && volume_right <= INT16_MAX) {
+#if defined(__SSE2__)
+		const __m128i volume = _mm_set_epi16(volume_right, volume_left, volume_right, volume_left, volume_right, volume_left, volume_right, volume_left);
+		const __m128i min_volume = _mm_set1_epi16(-MAX_VOLUME);
+		for (; i + 8 <= samples; i += 8) {
+			const __m128i data = _mm_loadu_si128((const __m128i *)(b + i));
+			__m128i *out = (__m128i *)(buffer + i * 2);
+			const __m128i lo = _mm_mulhi_epi16(_mm_unpacklo_epi16(data, data), volume);
+			const __m128i hi = _mm_mulhi_epi16(_mm_unpackhi_epi16(data, data), volume);
+			_mm_storeu_si128(out, _mm_max_epi16(_mm_adds_epi16(_mm_loadu_si128(out), lo), min_volume));
+			_mm_storeu_si128(out + 1, _mm_max_epi16(_mm_adds_epi16(_mm_loadu_si128(out + 1), hi), min_volume));
+		}
+#elif defined(__ARM_NEON)
+		const int16 volume_pairs[4] = { (int16)volume_left, (int16)volume_right, (int16)volume_left, (int16)volume_right };
+		const int16x4_t volume = vld1_s16(volume_pairs);
+		const int16x8_t min_volume = vdupq_n_s16(-MAX_VOLUME);
+		for (; i + 8 <= samples; i += 8) {
+			const int16x8x2_t data = vzipq_s16(vld1q_s16(b + i), vld1q_s16(b + i));
+			for (uint half = 0; half < 2; half++) {
+				int16 *out = buffer + i * 2 + half * 8;
+				const int16x8_t mixed = vcombine_s16(
+						vshrn_n_s32(vmull_s16(vget_low_s16(data.val[half]), volume), 16),
+						vshrn_n_s32(vmull_s16(vget_high_s16(data.val[half]), volume), 16));
+				vst1q_s16(out, vmaxq_s16(vqaddq_s16(vld1q_s16(out), mixed), min_volume));
+			}
+		}
+#endif
 	}
 
-	sc->frac_pos = frac_pos;
-	sc->pos = b - (const int16 *)sc->memory;
+	buffer += i * 2;
+	for (; i < samples; i++) {
+		buffer[0] = Clamp(buffer[0] + (b[i] * volume_left  >> 16), -MAX_VOLUME, MAX_VOLUME);
+		buffer[1] = Clamp(buffer[1] + (b[i] * volume_right >> 16), -MAX_VOLUME, MAX_VOLUME);
+		buffer += 2;
+	}
 }
 
-static void mix_int8_to_int16(MixerChannel *sc, int16 *buffer, uint samples, uint8 effect_vol)
+static void MixChannel(MixerChannel *sc, int16 *buffer, uint samples, uint8 effect_vol)
 {
 	if (samples > sc->samples_left) samples = sc->samples_left;
 	sc->samples_left -= samples;
 	assert(samples > 0);
 
-	const int8 *b = sc->memory + sc->pos;
-	uint32 frac_pos = sc->frac_pos;
-	uint32 frac_speed = sc->frac_speed;
 	int volume_left = sc->volume_left * effect_vol / 255;
 	int volume_right = sc->volume_right * effect_vol / 255;
+	MixSamples(buffer, sc->samples.data() + sc->pos, samples, volume_left, volume_right);
 
-	if (frac_speed == 0x10000) {
-		/* Special case when frac_speed is 0x10000 */
-		do {
-			buffer[0] = Clamp(buffer[0] + (*b * volume_left  >> 8), -MAX_VOLUME, MAX_VOLUME);
-			buffer[1] = Clamp(buffer[1] + (*b * volume_right >> 8), -MAX_VOLUME, MAX_VOLUME);
-			b++;
-			buffer += 2;
-		} while (--samples > 0);
-	} else {
-		do {
-			int data = RateConversion(b, frac_pos);
-			buffer[0] = Clamp(buffer[0] + (data * volume_left  >> 8), -MAX_VOLUME, MAX_VOLUME);
-			buffer[1] = Clamp(buffer[1] + (data * volume_right >> 8), -MAX_VOLUME, MAX_VOLUME);
-			buffer += 2;
-			frac_pos += frac_speed;
-			b += frac_pos >> 16;
-			frac_pos &= 0xffff;
-		} while (--samples > 0);
-	}
-
-	sc->frac_pos = frac_pos;
-	sc->pos = b - sc->memory;
+	sc->pos += samples;
 }
 
 static void MxCloseChannel(uint8 channel_index)
@@ -177,11 +197,7 @@ void MxMixSamples(void *buffer, uint samples)
 	uint8 active = _active_channels.load(std::memory_order_acquire);
 	for (uint8 idx : SetBitIterator(active)) {
 		MixerChannel *mc = &_channels[idx];
-		if (mc->is16bit) {
-			mix_int16(mc, (int16*)buffer, samples, effect_vol);
-		} else {
-			mix_int8_to_int16(mc, (int16*)buffer, samples, effect_vol);
-		}
+		MixChannel(mc, (int16*)buffer, samples, effect_vol);
 		if (mc->samples_left == 0) MxCloseChannel(idx);
 	}
 }
@@ -200,13 +216,22 @@ MixerChannel *MxAllocateChannel()
 	return mc;
 }
 
+/**
+ * Set the sample to play on a channel.
+ * As the rates are known from here on, the sample is converted to 16 bit at the play rate once,
+ * so that mixing is a plain multiply and add.
+ * @param mc the channel
+ * @param mem the sample, followed by two bytes of padding; the channel takes ownership
+ * @param size the size of the sample, in bytes
+ * @param rate the sample rate of the sample
+ * @param is16bit whether the sample is 16 bit, otherwise it is 8 bit
+ */
 void MxSetChannelRawSrc(MixerChannel *mc, int8 *mem, size_t size, uint rate, bool is16bit)
 {
 	mc->memory = mem;
-	mc->frac_pos = 0;
 	mc->pos = 0;
 
-	mc->frac_speed = (rate << 16) / _play_rate;
+	const uint32 frac_speed = (rate << 16) / _play_rate;
 
 	if (is16bit) size /= 2;
 
@@ -217,7 +242,17 @@ void MxSetChannelRawSrc(MixerChannel *mc, int8 *mem, size_t size, uint rate, boo
 	}
 
 	mc->samples_left = (uint)size * _play_rate / rate;
-	mc->is16bit = is16bit;
+
+	mc->samples.resize(mc->samples_left);
+	if (is16bit) {
+		ResampleToPlayRate((const int16 *)mem, mc->samples, frac_speed, 0);
+	} else {
+		ResampleToPlayRate((const int8 *)mem, mc->samples, frac_speed, 8);
+	}
+
+	/* The raw sample is no longer needed. */
+	free(mc->memory);
+	mc->memory = nullptr;
 }
 
 /**
@@ -37,6 +37,36 @@ static const uint GITHASH_SUFFIX_LEN = 12;
 
 NetworkServerGameInfo _network_game_info; ///< Information about our game.
 
+/** Incremented whenever the static content of #_network_game_info is refilled, to invalidate the serialisation caches. */
+static uint32 _network_game_info_generation = 0;
+
+/** Everything the serialisation of the current server game info depends on. */
+struct NetworkGameInfoCacheKey {
+	uint32 generation;          ///< #_network_game_info_generation when serialised.
+	const GameInfo *game_info;  ///< The running game script.
+	Date game_date;             ///< Current game date.
+	byte companies_on;          ///< Number of companies.
+	byte clients_on;            ///< Number of clients.
+	byte spectators_on;         ///< Number of spectators.
+	uint16 flags;               ///< Flags of the extended game info request.
+	uint16 version;             ///< Version of the extended game info request.
+	size_t limit;               ///< Size limit of the packet serialised into.
+
+	bool operator==(const NetworkGameInfoCacheKey &other) const
+	{
+		return this->generation == other.generation && this->game_info == other.game_info && this->game_date == other.game_date &&
+				this->companies_on == other.companies_on && this->clients_on == other.clients_on && this->spectators_on == other.spectators_on &&
+				this->flags == other.flags && this->version == other.version && this->limit == other.limit;
+	}
+};
+
+/** Cached serialisation of the current server game info, without the packet header. */
+struct NetworkGameInfoCache {
+	bool valid = false;          ///< Whether the cache has been filled.
+	NetworkGameInfoCacheKey key; ///< The inputs of the cached serialisation.
+	std::vector<byte> data;      ///< The serialised game info.
+};
+
 /**
  * Get the network version string used by this build.
  * The returned string is guaranteed to be at most NETWORK_REVISON_LENGTH bytes.
@@ -142,6 +172,8 @@ void FillStaticNetworkServerGameInfo()
 
 	_network_game_info.server_name = _settings_client.network.server_name;
 	_network_game_info.server_revision = GetNetworkRevisionString();
+
+	_network_game_info_generation++;
 }
 
 /**
@@ -325,6 +357,60 @@ void SerializeNetworkGameInfoExtended(Packet *p, const NetworkServerGameInfo *in
 	}
 }
 
+/**
+ * Serialize the current server game info to the packet, reusing the previous serialisation when none of its inputs changed.
+ * @param p The packet to write the data to.
+ * @param cache The cache of the previous serialisation.
+ * @param flags Flags of the extended game info request, 0 when not extended.
+ * @param version Version of the extended game info request, 0 when not extended.
+ * @param serialize Function serializing the given game info into the given packet.
+ */
+template <typename F>
+static void SerializeCachedNetworkServerGameInfo(Packet *p, NetworkGameInfoCache &cache, uint16 flags, uint16 version, F serialize)
+{
+	const NetworkServerGameInfo *info = GetCurrentNetworkServerGameInfo();
+	const NetworkGameInfoCacheKey key = { _network_game_info_generation, Game::GetInfo(), info->game_date, info->companies_on, info->clients_on, info->spectators_on, flags, version, p->GetSerialisationLimit() };
+
+	if (!cache.valid || !(cache.key == key)) {
+		Packet tmp((PacketType)0, key.limit);
+		serialize(&tmp, info);
+		const size_t header_size = sizeof(PacketSize) + sizeof(PacketType);
+		cache.data.assign(tmp.GetBufferData() + header_size, tmp.GetBufferData() + tmp.Size());
+		cache.key = key;
+		cache.valid = true;
+	}
+
+	p->Send_binary(reinterpret_cast<const char *>(cache.data.data()), cache.data.size());
+}
+
+/**
+ * Serializes the current server game info to the packet, see #SerializeNetworkGameInfo.
+ * The serialisation is cached until any of its inputs change.
+ * @param p The packet to write the data to.
+ */
+void SerializeCurrentNetworkServerGameInfo(Packet *p)
+{
+	static NetworkGameInfoCache cache;
+	SerializeCachedNetworkServerGameInfo(p, cache, 0, 0, [](Packet *p, const NetworkServerGameInfo *info) {
+		SerializeNetworkGameInfo(p, info);
+	});
+}
+
+/**
+ * Serializes the current server game info to the packet, see #SerializeNetworkGameInfoExtended.
+ * The serialisation is cached until any of its inputs change.
+ * @param p       The packet to write the data to.
+ * @param flags   Flags of the request.
+ * @param version Version of the request.
+ */
+void SerializeCurrentNetworkServerGameInfoExtended(Packet *p, uint16 flags, uint16 version)
+{
+	static NetworkGameInfoCache cache;
+	SerializeCachedNetworkServerGameInfo(p, cache, flags, version, [&](Packet *p, const NetworkServerGameInfo *info) {
+		SerializeNetworkGameInfoExtended(p, info, flags, version);
+	});
+}
+
 /**
  * Deserializes the NetworkGameInfo struct from the packet.
  * @param p    the packet to read the data from.
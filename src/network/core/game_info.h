@@ -147,5 +147,7 @@ void DeserializeNetworkGameInfo(Packet *p, NetworkGameInfo *info, const GameInfo
 void DeserializeNetworkGameInfoExtended(Packet *p, NetworkGameInfo *info);
 void SerializeNetworkGameInfo(Packet *p, const NetworkServerGameInfo *info, bool send_newgrf_names = true);
 void SerializeNetworkGameInfoExtended(Packet *p, const NetworkServerGameInfo *info, uint16 flags, uint16 version, bool send_newgrf_names = true);
+void SerializeCurrentNetworkServerGameInfo(Packet *p);
+void SerializeCurrentNetworkServerGameInfoExtended(Packet *p, uint16 flags, uint16 version);
 
 #endif /* NETWORK_CORE_GAME_INFO_H */
@@ -67,7 +67,11 @@ public:
 	const std::string data;       ///< Data to send, if any.
 };
 
-static std::thread _http_thread;
+/** Maximum number of HTTP requests processed at the same time, each by its own thread. */
+static const uint HTTP_MAX_THREADS = 8;
+
+static std::vector<std::thread> _http_threads;
+static uint _http_idle_threads = 0;
 static std::atomic<bool> _http_thread_exit = false;
 static std::queue<std::unique_ptr<NetworkHTTPRequest>> _http_requests;
 static std::mutex _http_mutex;
@@ -77,6 +81,8 @@ static std::string _http_ca_file = "";
 static std::string _http_ca_path = "";
 #endif /* UNIX */
 
+static void HttpThread();
+
 /* static */ void NetworkHTTPSocketHandler::Connect(const std::string &uri, HTTPCallback *callback, const std::string data)
 {
 #if defined(UNIX)
@@ -86,16 +92,31 @@ static std::string _http_ca_path = "";
 	}
 #endif /* UNIX */
 
-	std::lock_guard<std::mutex> lock(_http_mutex);
-	_http_requests.push(std::make_unique<NetworkHTTPRequest>(uri, callback, data));
-	_http_cv.notify_one();
+	{
+		std::lock_guard<std::mutex> lock(_http_mutex);
+
+		/* Start another thread when all existing ones are busy, so concurrent requests do not wait for each other. */
+		if (_http_idle_threads <= _http_requests.size() && _http_threads.size() < HTTP_MAX_THREADS) {
+			_http_threads.emplace_back();
+			if (!StartNewThread(&_http_threads.back(), "ottd:http", &HttpThread)) _http_threads.pop_back();
+		}
+
+		if (!_http_threads.empty()) {
+			_http_requests.push(std::make_unique<NetworkHTTPRequest>(uri, callback, data));
+			_http_cv.notify_one();
+			return;
+		}
+	}
+
+	/* No thread to process the request. */
+	callback->OnFailure();
 }
 
 /* static */ void NetworkHTTPSocketHandler::HTTPReceive()
 {
 }
 
-void HttpThread()
+static void HttpThread()
 {
 	CURL *curl = curl_easy_init();
 	assert(curl != nullptr);
@@ -104,9 +125,11 @@ void HttpThread()
 		std::unique_lock<std::mutex> lock(_http_mutex);
 
 		/* Wait for a new request. */
+		_http_idle_threads++;
 		while (_http_requests.empty() && !_http_thread_exit) {
 			_http_cv.wait(lock);
 		}
+		_http_idle_threads--;
 		if (_http_thread_exit) break;
 
 		std::unique_ptr<NetworkHTTPRequest> request = std::move(_http_requests.front());
@@ -219,7 +242,7 @@ void NetworkHTTPInitialize()
 #endif /* UNIX */
 
 	_http_thread_exit = false;
-	StartNewThread(&_http_thread, "ottd:http", &HttpThread);
+	_http_threads.reserve(HTTP_MAX_THREADS);
 }
 
 void NetworkHTTPUninitialize()
@@ -230,10 +253,11 @@ void NetworkHTTPUninitialize()
 
 	{
 		std::lock_guard<std::mutex> lock(_http_mutex);
-		_http_cv.notify_one();
+		_http_cv.notify_all();
 	}
 
-	if (_http_thread.joinable()) {
-		_http_thread.join();
+	for (std::thread &thread : _http_threads) {
+		if (thread.joinable()) thread.join();
 	}
+	_http_threads.clear();
 }
@@ -115,6 +115,16 @@ typedef unsigned long in_addr_t;
 #	include <sys/time.h>
 #	include <netdb.h>
 
+#   if !defined(__EMSCRIPTEN__)
+/* poll() has no limit on the descriptor values and only costs the number of polled sockets, unlike select(). */
+#		include <poll.h>
+#		define HAVE_POLL
+/* writev() lets several queued packets be sent with a single system call. */
+#		include <sys/uio.h>
+#		include <limits.h>
+#		define HAVE_WRITEV
+#   endif
+
 #   if defined(__EMSCRIPTEN__)
 /* Emscripten doesn't support AI_ADDRCONFIG and errors out on it. */
 #		undef AI_ADDRCONFIG
@@ -18,6 +18,30 @@
 
 #include "../../safeguards.h"
 
+/** Maximum capacity of a packet buffer which is kept for reuse, larger buffers are freed. */
+static const size_t PACKET_BUFFER_POOL_MAX_CAPACITY = COMPAT_MTU;
+/** Maximum number of packet buffers which are kept for reuse per thread. */
+static const size_t PACKET_BUFFER_POOL_MAX_SIZE = 256;
+
+/**
+ * Buffers of destroyed packets, kept so that subsequently created packets do not have to
+ * grow a fresh buffer from scratch. Packets may be created and destroyed on different threads,
+ * (e.g. those of the map transfer), so each thread has its own pool.
+ */
+static thread_local std::vector<std::vector<byte>> _packet_buffer_pool;
+
+/**
+ * Take a buffer from the packet buffer pool, if any is available.
+ * @param buffer Buffer to assign the pooled buffer to.
+ */
+static void AcquirePooledPacketBuffer(std::vector<byte> &buffer)
+{
+	if (_packet_buffer_pool.empty()) return;
+	buffer = std::move(_packet_buffer_pool.back());
+	_packet_buffer_pool.pop_back();
+	buffer.clear();
+}
+
 /**
  * Create a packet that is used to read from a network socket.
  * @param cs                The socket handler associated with the socket we are reading from.
@@ -35,6 +59,7 @@ Packet::Packet(NetworkSocketHandler *cs, size_t limit, size_t initial_read_size)
 	assert(cs != nullptr);
 
 	this->cs = cs;
+	AcquirePooledPacketBuffer(this->buffer);
 	this->buffer.resize(initial_read_size);
 }
 
@@ -48,9 +73,21 @@ Packet::Packet(NetworkSocketHandler *cs, size_t limit, size_t initial_read_size)
  */
 Packet::Packet(PacketType type, size_t limit) : pos(0), limit(limit), cs(nullptr)
 {
+	AcquirePooledPacketBuffer(this->buffer);
 	this->ResetState(type);
 }
 
+/**
+ * Return the buffer of the packet to the packet buffer pool, if it is small enough to be worth keeping.
+ */
+Packet::~Packet()
+{
+	size_t capacity = this->buffer.capacity();
+	if (capacity != 0 && capacity <= PACKET_BUFFER_POOL_MAX_CAPACITY && _packet_buffer_pool.size() < PACKET_BUFFER_POOL_MAX_SIZE) {
+		_packet_buffer_pool.push_back(std::move(this->buffer));
+	}
+}
+
 void Packet::ResetState(PacketType type)
 {
 	this->cs = nullptr;
@@ -72,7 +109,9 @@ void Packet::PrepareToSend()
 	this->buffer[1] = GB(this->Size(), 8, 8);
 
 	this->pos  = 0; // We start reading from here
-	this->buffer.shrink_to_fit();
+
+	/* Only release excess capacity of large buffers, small ones are recycled via the packet buffer pool. */
+	if (this->buffer.capacity() > PACKET_BUFFER_POOL_MAX_CAPACITY) this->buffer.shrink_to_fit();
 }
 
 /**
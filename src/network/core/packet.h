@@ -58,6 +58,11 @@ private:
 public:
 	Packet(NetworkSocketHandler *cs, size_t limit, size_t initial_read_size = sizeof(PacketSize));
 	Packet(PacketType type, size_t limit = COMPAT_MTU);
+	Packet(const Packet &other) = default;
+	Packet(Packet &&other) = default;
+	Packet &operator=(const Packet &other) = default;
+	Packet &operator=(Packet &&other) = default;
+	~Packet();
 
 	void ResetState(PacketType type);
 
@@ -92,6 +97,17 @@ public:
 	PacketSize GetRawPos() const { return this->pos; }
 	void ReserveBuffer(size_t size) { this->buffer.reserve(size); }
 
+	/**
+	 * Mark data as transferred out, when it has been sent directly from the buffer
+	 * (starting at GetBufferData() + GetRawPos()) instead of via TransferOut.
+	 * @param bytes The amount of bytes which were transferred.
+	 */
+	void AdvanceTransferOut(size_t bytes)
+	{
+		assert(bytes <= this->RemainingBytesToTransfer());
+		this->pos += static_cast<PacketSize>(bytes);
+	}
+
 	/**
 	 * Transfer data from the packet to the given function. It starts reading at the
 	 * position the last transfer stopped.
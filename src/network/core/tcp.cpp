@@ -134,7 +134,24 @@ SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 
 	while (!this->packet_queue.empty()) {
 		Packet *p = this->packet_queue.front().get();
-		res = p->TransferOut<int>(send, this->sock, 0);
+#ifdef HAVE_WRITEV
+		if (this->packet_queue.size() > 1) {
+			/* Gather the queued packets into a single system call, instead of one per packet. */
+			iovec iov[64];
+			const size_t max_count = std::min<size_t>(lengthof(iov), IOV_MAX);
+			size_t count = 0;
+			for (const auto &queued : this->packet_queue) {
+				if (count == max_count) break;
+				iov[count].iov_base = const_cast<byte *>(queued->GetBufferData() + queued->GetRawPos());
+				iov[count].iov_len = queued->RemainingBytesToTransfer();
+				count++;
+			}
+			res = writev(this->sock, iov, (int)count);
+		} else
+#endif
+		{
+			res = p->TransferOut<int>(send, this->sock, 0);
+		}
 		if (res == -1) {
 			NetworkError err = NetworkError::GetLast();
 			if (!err.WouldBlock()) {
@@ -153,6 +170,23 @@ SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 			return SPS_CLOSED;
 		}
 
+#ifdef HAVE_WRITEV
+		if (this->packet_queue.size() > 1) {
+			/* Distribute the sent amount over the gathered packets. */
+			size_t sent = res;
+			while (sent > 0) {
+				p = this->packet_queue.front().get();
+				size_t amount = std::min(sent, p->RemainingBytesToTransfer());
+				p->AdvanceTransferOut(amount);
+				sent -= amount;
+				if (p->RemainingBytesToTransfer() != 0) return SPS_PARTLY_SENT;
+				if (_debug_net_level >= 5) this->LogSentPacket(*p);
+				this->packet_queue.pop_front();
+			}
+			continue;
+		}
+#endif
+
 		/* Is this packet sent? */
 		if (p->RemainingBytesToTransfer() == 0) {
 			/* Go to the next packet */
@@ -251,6 +285,13 @@ bool NetworkTCPSocketHandler::CanSendReceive()
 {
 	assert(this->sock != INVALID_SOCKET);
 
+#ifdef HAVE_POLL
+	pollfd fd = { this->sock, POLLIN | POLLOUT, 0 };
+	if (poll(&fd, 1, 0) < 0) return false;
+
+	this->writable = (fd.revents & POLLOUT) != 0;
+	return (fd.revents & (POLLIN | POLLHUP | POLLERR)) != 0;
+#else
 	fd_set read_fd, write_fd;
 	struct timeval tv;
 
@@ -265,4 +306,5 @@ bool NetworkTCPSocketHandler::CanSendReceive()
 
 	this->writable = !!FD_ISSET(this->sock, &write_fd);
 	return FD_ISSET(this->sock, &read_fd) != 0;
+#endif
 }
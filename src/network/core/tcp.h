@@ -74,6 +74,12 @@ public:
 	 */
 	bool HasSendQueue() { return !this->packet_queue.empty(); }
 
+	/**
+	 * Get the number of packets pending in the send queue.
+	 * @return The number of queued packets.
+	 */
+	size_t GetSendQueueLength() const { return this->packet_queue.size(); }
+
 	NetworkTCPSocketHandler(SOCKET s = INVALID_SOCKET);
 	~NetworkTCPSocketHandler();
 };
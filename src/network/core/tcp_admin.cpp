@@ -85,6 +85,10 @@ NetworkRecvStatus NetworkAdminSocketHandler::HandlePacket(Packet *p)
 		case ADMIN_PACKET_SERVER_CMD_LOGGING:     return this->Receive_SERVER_CMD_LOGGING(p);
 		case ADMIN_PACKET_SERVER_RCON_END:        return this->Receive_SERVER_RCON_END(p);
 		case ADMIN_PACKET_SERVER_PONG:            return this->Receive_SERVER_PONG(p);
+		case ADMIN_PACKET_SERVER_PERFORMANCE:     return this->Receive_SERVER_PERFORMANCE(p);
+		case ADMIN_PACKET_SERVER_VEHICLE_PROFILE: return this->Receive_SERVER_VEHICLE_PROFILE(p);
+		case ADMIN_PACKET_SERVER_POOL_STATS:      return this->Receive_SERVER_POOL_STATS(p);
+		case ADMIN_PACKET_SERVER_LATENCY_HISTOGRAM: return this->Receive_SERVER_LATENCY_HISTOGRAM(p);
 
 		default:
 			if (this->HasClientQuit()) {
@@ -164,3 +168,7 @@ NetworkRecvStatus NetworkAdminSocketHandler::Receive_SERVER_CMD_NAMES(Packet *p)
 NetworkRecvStatus NetworkAdminSocketHandler::Receive_SERVER_CMD_LOGGING(Packet *p) { return this->ReceiveInvalidPacket(ADMIN_PACKET_SERVER_CMD_LOGGING); }
 NetworkRecvStatus NetworkAdminSocketHandler::Receive_SERVER_RCON_END(Packet *p) { return this->ReceiveInvalidPacket(ADMIN_PACKET_SERVER_RCON_END); }
 NetworkRecvStatus NetworkAdminSocketHandler::Receive_SERVER_PONG(Packet *p) { return this->ReceiveInvalidPacket(ADMIN_PACKET_SERVER_PONG); }
+NetworkRecvStatus NetworkAdminSocketHandler::Receive_SERVER_PERFORMANCE(Packet *p) { return this->ReceiveInvalidPacket(ADMIN_PACKET_SERVER_PERFORMANCE); }
+NetworkRecvStatus NetworkAdminSocketHandler::Receive_SERVER_VEHICLE_PROFILE(Packet *p) { return this->ReceiveInvalidPacket(ADMIN_PACKET_SERVER_VEHICLE_PROFILE); }
+NetworkRecvStatus NetworkAdminSocketHandler::Receive_SERVER_POOL_STATS(Packet *p) { return this->ReceiveInvalidPacket(ADMIN_PACKET_SERVER_POOL_STATS); }
+NetworkRecvStatus NetworkAdminSocketHandler::Receive_SERVER_LATENCY_HISTOGRAM(Packet *p) { return this->ReceiveInvalidPacket(ADMIN_PACKET_SERVER_LATENCY_HISTOGRAM); }
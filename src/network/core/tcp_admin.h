@@ -60,6 +60,10 @@ enum PacketAdminType {
 	ADMIN_PACKET_SERVER_GAMESCRIPT,      ///< The server gives the admin information from the GameScript in JSON.
 	ADMIN_PACKET_SERVER_RCON_END,        ///< The server indicates that the remote console command has completed.
 	ADMIN_PACKET_SERVER_PONG,            ///< The server replies to a ping request from the admin.
+	ADMIN_PACKET_SERVER_PERFORMANCE,     ///< The server gives the admin performance measurements and object counts.
+	ADMIN_PACKET_SERVER_VEHICLE_PROFILE, ///< The server gives the admin the most expensive vehicles and companies.
+	ADMIN_PACKET_SERVER_POOL_STATS,      ///< The server gives the admin pool occupancy and container memory statistics.
+	ADMIN_PACKET_SERVER_LATENCY_HISTOGRAM, ///< The server gives the admin a histogram of durations.
 
 	INVALID_ADMIN_PACKET = 0xFF,         ///< An invalid marker for admin packets.
 };
@@ -83,6 +87,10 @@ enum AdminUpdateType {
 	ADMIN_UPDATE_CMD_NAMES,       ///< The admin would like a list of all DoCommand names.
 	ADMIN_UPDATE_CMD_LOGGING,     ///< The admin would like to have DoCommand information.
 	ADMIN_UPDATE_GAMESCRIPT,      ///< The admin would like to have gamescript messages.
+	ADMIN_UPDATE_PERFORMANCE,     ///< The admin would like to have performance measurements.
+	ADMIN_UPDATE_VEHICLE_PROFILE, ///< The admin would like to have the results of the vehicle profiler.
+	ADMIN_UPDATE_POOL_STATS,      ///< The admin would like to have pool and container memory statistics.
+	ADMIN_UPDATE_LATENCY_HISTOGRAM, ///< The admin would like to have histograms of durations.
 	ADMIN_UPDATE_END,             ///< Must ALWAYS be on the end of this list!! (period)
 };
 
@@ -481,6 +489,89 @@ protected:
 	 */
 	virtual NetworkRecvStatus Receive_SERVER_PONG(Packet *p);
 
+	/**
+	 * Send performance measurements and counts of game objects to the admin.
+	 * uint8   Number of performance elements which follow.
+	 * For each performance element:
+	 * uint8   ID of the performance element (see #PerformanceElement).
+	 * uint32  Current rate, in thousandths of cycles per second.
+	 * uint32  Average duration of the recent cycles, in microseconds.
+	 * uint32  Longest duration of the recent cycles, in microseconds.
+	 * uint8   Number of game loop duration histogram buckets which follow.
+	 * For each histogram bucket:
+	 * uint32  Exclusive upper bound of the bucket, in microseconds, UINT32_MAX for the last bucket.
+	 * uint32  Number of recent game loop cycles in the bucket.
+	 * uint32  Number of vehicles.
+	 * uint32  Number of cargo packets.
+	 * uint32  Number of link graph jobs.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_PERFORMANCE(Packet *p);
+
+	/**
+	 * Send the results of the vehicle profiler (see the vehicle_profile console command) to the admin.
+	 * bool    Whether the profiler is currently running.
+	 * uint32  Number of vehicle ticks profiled.
+	 * uint8   Number of companies which follow, most expensive first.
+	 * For each company:
+	 * uint8   ID of the company, or OWNER_NONE for vehicles without a company.
+	 * uint64  Time spent in vehicle ticks, excluding the time below, in nanoseconds.
+	 * uint64  Time spent in pathfinding, in nanoseconds.
+	 * uint64  Time spent in NewGRF callbacks and sprite resolution, in nanoseconds.
+	 * uint16  Number of vehicles which follow, most expensive first.
+	 * For each vehicle:
+	 * uint32  ID of the front vehicle.
+	 * uint8   ID of the owning company.
+	 * uint8   Type of the vehicle.
+	 * uint64  Time spent in vehicle ticks, excluding the time below, in nanoseconds.
+	 * uint64  Time spent in pathfinding, in nanoseconds.
+	 * uint64  Time spent in NewGRF callbacks and sprite resolution, in nanoseconds.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_VEHICLE_PROFILE(Packet *p);
+
+	/**
+	 * Send the pool occupancy and container memory statistics (see the pool_stats console command) to the admin.
+	 * uint8   Number of pools which follow.
+	 * For each pool:
+	 * string  Name of the pool.
+	 * uint32  Size of an item, in bytes.
+	 * uint32  Number of allocated index slots.
+	 * uint32  Number of index slots up to and including the highest used index.
+	 * uint32  Number of live items.
+	 * uint32  Number of freed items kept in the allocation cache.
+	 * uint64  Number of bytes used by the pool.
+	 * uint8   Number of kinds of containers which follow.
+	 * For each kind of container:
+	 * string  Name of the kind of container.
+	 * uint32  Number of non-empty containers.
+	 * uint32  Number of entries in all containers.
+	 * uint64  Estimated number of bytes allocated by all containers.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_POOL_STATS(Packet *p);
+
+	/**
+	 * Send a histogram of durations (see the latency_histogram console command) to the admin.
+	 * Only non-empty buckets are sent. Use the latency_histogram reset console command over rcon to reset the histograms.
+	 * uint8   ID of the histogram: a performance element as in ADMIN_PACKET_SERVER_PERFORMANCE, or a higher ID for an additional histogram.
+	 * string  Name of the histogram.
+	 * uint64  Number of seconds since the histograms were reset.
+	 * uint64  Number of measurements.
+	 * uint64  Sum of all measurements, in microseconds.
+	 * uint64  Longest measurement, in microseconds.
+	 * uint16  Number of buckets which follow.
+	 * For each bucket:
+	 * uint32  Shortest duration of the bucket, in microseconds. The bucket ends where the next bucket in the histogram would start.
+	 * uint64  Number of measurements in the bucket.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_LATENCY_HISTOGRAM(Packet *p);
+
 	/**
 	 * Notify the admin connection that the rcon command has finished.
 	 * string The command as requested by the admin connection.
@@ -100,6 +100,43 @@ public:
 	 */
 	static bool Receive()
 	{
+#ifdef HAVE_POLL
+		/* Listeners first, then the clients, whose pool indices are kept alongside. */
+		static std::vector<pollfd> fds;
+		static std::vector<decltype(Tsocket::index)> client_indices;
+		fds.clear();
+		client_indices.clear();
+
+		for (auto &s : sockets) {
+			fds.push_back({ s.second, POLLIN, 0 });
+		}
+		const size_t first_client = fds.size();
+		for (Tsocket *cs : Tsocket::Iterate()) {
+			fds.push_back({ cs->sock, POLLIN | POLLOUT, 0 });
+			client_indices.push_back(cs->index);
+		}
+
+		if (poll(fds.data(), fds.size(), 0) < 0) return false;
+
+		for (size_t i = 0; i < client_indices.size(); i++) {
+			Tsocket::Get(client_indices[i])->writable = (fds[first_client + i].revents & POLLOUT) != 0;
+		}
+
+		/* accept clients.. */
+		for (size_t i = 0; i < first_client; i++) {
+			if (fds[i].revents & POLLIN) AcceptClient(fds[i].fd);
+		}
+
+		/* read stuff from clients, handling a packet may close other connections */
+		for (size_t i = 0; i < client_indices.size(); i++) {
+			const pollfd &fd = fds[first_client + i];
+			if ((fd.revents & (POLLIN | POLLHUP | POLLERR)) == 0) continue;
+
+			Tsocket *cs = Tsocket::GetIfValid(client_indices[i]);
+			if (cs != nullptr && cs->sock == fd.fd) cs->ReceivePackets();
+		}
+		return _networking;
+#else
 		fd_set read_fd, write_fd;
 		struct timeval tv;
 
@@ -133,6 +170,7 @@ public:
 			}
 		}
 		return _networking;
+#endif
 	}
 
 	/**
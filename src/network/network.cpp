@@ -34,11 +34,14 @@
 #include "../rev.h"
 #include "../core/pool_func.hpp"
 #include "../gfx_func.h"
+#include "../viewport_func.h"
 #include "../error.h"
 #include "../core/checksum_func.hpp"
 #include "../string_func_extra.h"
 #include "../3rdparty/randombytes/randombytes.h"
 #include "../settings_internal.h"
+#include "../debug_desync.h"
+#include <chrono>
 #include <sstream>
 #include <iomanip>
 
@@ -63,6 +66,7 @@ bool _network_available;  ///< is network mode available?
 bool _network_dedicated;  ///< are we a dedicated server?
 bool _is_network_server;  ///< Does this client wants to be a network-server?
 bool _network_settings_access; ///< Can this client change server settings?
+bool _network_catching_up;     ///< Is this client running frames back-to-back to catch up with the server?
 NetworkCompanyState *_network_company_states = nullptr; ///< Statistics about some companies.
 std::string _network_company_server_id; ///< Server ID string used for company passwords
 uint8 _network_company_password_storage_token[16]; ///< Non-secret token for storage of company passwords in savegames
@@ -95,6 +99,9 @@ std::vector<NetworkSyncRecord> _network_client_sync_records;
 std::unique_ptr<std::array<NetworkSyncRecord, 1024>> _network_server_sync_records;
 uint32 _network_server_sync_records_next;
 
+/** Minimum number of frames a client must be behind the server to run them in catch-up mode. */
+static const uint32 NETWORK_CATCH_UP_MIN_FRAMES = DAY_TICKS;
+
 static_assert((int)NETWORK_COMPANY_NAME_LENGTH == MAX_LENGTH_COMPANY_NAME_CHARS * MAX_CHAR_LENGTH);
 
 /** The amount of clients connected */
@@ -1097,6 +1104,11 @@ void NetworkGameLoop()
 			static Date last_log;
 			if (last_log != _date) {
 				DEBUG(desync, 2, "sync: date{%08x; %02x; %02x}; %08x; %08x", _date, _date_fract, _tick_skip_counter, _random.state[0], _random.state[1]);
+				if (_debug_desync_level >= 3) {
+					LogStateSubsystemChecksums([](const char *str) {
+						DEBUG(desync, 3, "%s", str);
+					}, _debug_desync_level >= 4);
+				}
 				last_log = _date;
 			}
 		}
@@ -1106,7 +1118,7 @@ void NetworkGameLoop()
 		static FILE *f = FioFOpenFile("commands.log", "rb", SAVE_DIR);
 		static Date next_date = 0;
 		static uint32 next_date_fract;
-		static uint8 next_tick_skip_counter;
+		static uint32 next_tick_skip_counter;
 		static std::unique_ptr<CommandPacket> cp;
 		static bool check_sync_state = false;
 		static uint32 sync_state[2];
@@ -1118,8 +1130,8 @@ void NetworkGameLoop()
 		while (f != nullptr && !feof(f)) {
 			if (_date == next_date && _date_fract == next_date_fract) {
 				if (cp != nullptr) {
-					NetworkSendCommand(cp->tile, cp->p1, cp->p2, cp->p3, cp->cmd & ~CMD_FLAGS_MASK, nullptr, cp->text.c_str(), cp->company, cp->aux_data);
-					DEBUG(net, 0, "injecting: date{%08x; %02x; %02x}; %02x; %06x; %08x; %08x; " OTTD_PRINTFHEX64PAD " %08x; \"%s\" (%x) (%s)", _date, _date_fract, _tick_skip_counter, (int)_current_company, cp->tile, cp->p1, cp->p2, cp->p3, cp->cmd, cp->text.c_str(), cp->binary_length, GetCommandName(cp->cmd));
+					NetworkSendCommand(cp->tile, cp->p1, cp->p2, cp->p3, cp->cmd & ~CMD_FLAGS_MASK, nullptr, cp->text.c_str(), cp->company, cp->aux_data.get());
+					DEBUG(net, 0, "injecting: date{%08x; %02x; %02x}; %02x; %06x; %08x; %08x; " OTTD_PRINTFHEX64PAD " %08x; \"%s\" (%s)", _date, _date_fract, _tick_skip_counter, (int)_current_company, cp->tile, cp->p1, cp->p2, cp->p3, cp->cmd, cp->text.c_str(), GetCommandName(cp->cmd));
 					cp.reset();
 				}
 				if (check_sync_state) {
@@ -1204,6 +1216,7 @@ void NetworkGameLoop()
 			DEBUG(desync, 0, "End of commands.log");
 			fclose(f);
 			f = nullptr;
+			IConsoleCmdExec("exec scripts/on_replay_end.scr 0");
 		}
 #endif /* DEBUG_DUMP_COMMANDS */
 		if (_frame_counter >= _frame_counter_max) {
@@ -1246,9 +1259,35 @@ void NetworkGameLoop()
 
 		/* Make sure we are at the frame were the server is (quick-frames) */
 		if (_frame_counter_server > _frame_counter) {
+			/* When far behind, such as after joining, skip sounds and marking viewports dirty until caught up. */
+			const uint32 behind = _frame_counter_server - _frame_counter;
+			const bool catch_up = behind >= NETWORK_CATCH_UP_MIN_FRAMES;
+			if (catch_up) {
+				DEBUG(net, 1, "Catching up %u frames", behind);
+				_network_catching_up = true;
+			}
+			auto last_report = std::chrono::steady_clock::now();
+
 			/* Run a number of frames; when things go bad, get out. */
 			while (_frame_counter_server > _frame_counter) {
-				if (!ClientNetworkGameSocketHandler::GameLoop()) return;
+				if (!ClientNetworkGameSocketHandler::GameLoop()) {
+					_network_catching_up = false;
+					return;
+				}
+				if (catch_up && (_frame_counter & 0xFF) == 0) {
+					auto now = std::chrono::steady_clock::now();
+					if (now - last_report >= std::chrono::seconds(1)) {
+						DEBUG(net, 1, "Catching up: %u frames remaining", _frame_counter_server - _frame_counter);
+						last_report = now;
+					}
+				}
+			}
+
+			if (catch_up) {
+				_network_catching_up = false;
+				MarkAllViewportMapLandscapesDirty();
+				MarkWholeScreenDirty();
+				DEBUG(net, 1, "Caught up with server");
 			}
 		} else {
 			/* Else, keep on going till _frame_counter_max */
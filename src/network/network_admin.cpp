@@ -21,6 +21,12 @@
 #include "../map_func.h"
 #include "../rev.h"
 #include "../game/game.hpp"
+#include "../framerate_type.h"
+#include "../vehicle_base.h"
+#include "../cargopacket.h"
+#include "../linkgraph/linkgraphjob.h"
+#include "../vehicle_profile.h"
+#include "../memory_stats.h"
 
 #include "../safeguards.h"
 
@@ -53,6 +59,10 @@ static const AdminUpdateFrequency _admin_update_type_frequencies[] = {
 	ADMIN_FREQUENCY_POLL,                                                                                                                                  ///< ADMIN_UPDATE_CMD_NAMES
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_CMD_LOGGING
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_GAMESCRIPT
+	ADMIN_FREQUENCY_POLL | ADMIN_FREQUENCY_DAILY | ADMIN_FREQUENCY_WEEKLY | ADMIN_FREQUENCY_MONTHLY | ADMIN_FREQUENCY_QUARTERLY | ADMIN_FREQUENCY_ANUALLY, ///< ADMIN_UPDATE_PERFORMANCE
+	ADMIN_FREQUENCY_POLL,                                                                                                                                  ///< ADMIN_UPDATE_VEHICLE_PROFILE
+	ADMIN_FREQUENCY_POLL,                                                                                                                                  ///< ADMIN_UPDATE_POOL_STATS
+	ADMIN_FREQUENCY_POLL,                                                                                                                                  ///< ADMIN_UPDATE_LATENCY_HISTOGRAM
 };
 /** Sanity check. */
 static_assert(lengthof(_admin_update_type_frequencies) == ADMIN_UPDATE_END);
@@ -483,6 +493,148 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendRconEnd(const std::string
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/** Send performance measurements and counts of game objects to the admin. */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendPerformance()
+{
+	auto to_uint32 = [](double value) -> uint32 {
+		return (uint32)Clamp<double>(value, 0, UINT32_MAX);
+	};
+
+	PerformanceElementSummary summaries[PFE_MAX];
+	uint8 count = 0;
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
+		summaries[e] = GetPerformanceElementSummary(e);
+		if (summaries[e].num_valid > 0) count++;
+	}
+
+	Packet *p = new Packet(ADMIN_PACKET_SERVER_PERFORMANCE);
+
+	p->Send_uint8(count);
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
+		const PerformanceElementSummary &summary = summaries[e];
+		if (summary.num_valid == 0) continue;
+		p->Send_uint8(e);
+		p->Send_uint32(to_uint32(summary.rate * 1000));
+		p->Send_uint32(to_uint32(summary.average_ms * 1000));
+		p->Send_uint32(to_uint32(summary.peak_ms * 1000));
+	}
+
+	p->Send_uint8(PERFORMANCE_HISTOGRAM_BUCKETS);
+	for (uint i = 0; i < PERFORMANCE_HISTOGRAM_BUCKETS; i++) {
+		p->Send_uint32(i < lengthof(_performance_histogram_bounds_us) ? _performance_histogram_bounds_us[i] : UINT32_MAX);
+		p->Send_uint32(summaries[PFE_GAMELOOP].histogram[i]);
+	}
+
+	p->Send_uint32((uint32)Vehicle::GetNumItems());
+	p->Send_uint32((uint32)CargoPacket::GetNumItems());
+	p->Send_uint32((uint32)LinkGraphJob::GetNumItems());
+	this->SendPacket(p);
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
+/**
+ * Send the results of the vehicle profiler to the admin.
+ * @param count Maximum number of vehicles to send, limited to what fits in a single packet.
+ */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendVehicleProfile(uint count)
+{
+	/* Size of the header and the company entries, and of a single vehicle entry. */
+	static const uint HEADER_SIZE = 8 + OWNER_END * (1 + 3 * 8);
+	static const uint VEHICLE_SIZE = 4 + 1 + 1 + 3 * 8;
+	count = std::min<uint>(count, (TCP_MTU - HEADER_SIZE) / VEHICLE_SIZE);
+
+	std::vector<VehicleProfileVehicleResult> vehicles;
+	std::vector<VehicleProfileCompanyResult> companies;
+	GetVehicleProfileTop(count, vehicles, companies);
+
+	Packet *p = new Packet(ADMIN_PACKET_SERVER_VEHICLE_PROFILE);
+
+	p->Send_bool(_vehicle_profile_enabled);
+	p->Send_uint32(GetVehicleProfileTicks());
+
+	p->Send_uint8((uint8)companies.size());
+	for (const VehicleProfileCompanyResult &c : companies) {
+		p->Send_uint8(c.owner);
+		for (uint64 time : c.cost.time) p->Send_uint64(time);
+	}
+
+	p->Send_uint16((uint16)vehicles.size());
+	for (const VehicleProfileVehicleResult &v : vehicles) {
+		p->Send_uint32(v.id);
+		p->Send_uint8(v.owner);
+		p->Send_uint8(v.type);
+		for (uint64 time : v.cost.time) p->Send_uint64(time);
+	}
+	this->SendPacket(p);
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
+/** Send the pool occupancy and container memory statistics to the admin. */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendPoolStats()
+{
+	const std::vector<PoolStats> pools = GetPoolStats();
+	const std::vector<ContainerMemoryStats> containers = GetContainerMemoryStats();
+
+	Packet *p = new Packet(ADMIN_PACKET_SERVER_POOL_STATS);
+
+	p->Send_uint8((uint8)pools.size());
+	for (const PoolStats &ps : pools) {
+		p->Send_string(ps.name);
+		p->Send_uint32((uint32)ps.item_size);
+		p->Send_uint32((uint32)ps.capacity);
+		p->Send_uint32((uint32)ps.used_range);
+		p->Send_uint32((uint32)ps.items);
+		p->Send_uint32((uint32)ps.cached_items);
+		p->Send_uint64(ps.GetBytes());
+	}
+
+	p->Send_uint8((uint8)containers.size());
+	for (const ContainerMemoryStats &cs : containers) {
+		p->Send_string(cs.name);
+		p->Send_uint32((uint32)cs.containers);
+		p->Send_uint32((uint32)cs.entries);
+		p->Send_uint64(cs.bytes);
+	}
+	this->SendPacket(p);
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
+/**
+ * Send a histogram of durations to the admin.
+ * @param type The histogram.
+ */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendLatencyHistogram(LatencyHistogramType type)
+{
+	const LatencyHistogram &histogram = GetLatencyHistogram(type);
+
+	uint16 buckets = 0;
+	for (uint64 count : histogram.counts) {
+		if (count > 0) buckets++;
+	}
+
+	Packet *p = new Packet(ADMIN_PACKET_SERVER_LATENCY_HISTOGRAM);
+
+	p->Send_uint8(type);
+	p->Send_string(GetLatencyHistogramName(type));
+	p->Send_uint64(GetLatencyHistogramSeconds());
+	p->Send_uint64(histogram.count);
+	p->Send_uint64(histogram.sum_us);
+	p->Send_uint64(histogram.max_us);
+
+	p->Send_uint16(buckets);
+	for (uint bucket = 0; bucket < LatencyHistogram::BUCKETS; bucket++) {
+		if (histogram.counts[bucket] == 0) continue;
+		p->Send_uint32((uint32)LatencyHistogram::GetBucketLowerBound(bucket));
+		p->Send_uint64(histogram.counts[bucket]);
+	}
+	this->SendPacket(p);
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /**
  * Send the reply of an rcon command.
  * @param colour The colour of the text.
@@ -755,6 +907,32 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_POLL(Packet *p)
 			this->SendCmdNames();
 			break;
 
+		case ADMIN_UPDATE_PERFORMANCE:
+			/* The admin is requesting performance measurements. */
+			this->SendPerformance();
+			break;
+
+		case ADMIN_UPDATE_VEHICLE_PROFILE:
+			/* The admin is requesting the most expensive vehicles, d1 is the maximum number of vehicles. */
+			this->SendVehicleProfile(d1);
+			break;
+
+		case ADMIN_UPDATE_POOL_STATS:
+			/* The admin is requesting pool and container memory statistics. */
+			this->SendPoolStats();
+			break;
+
+		case ADMIN_UPDATE_LATENCY_HISTOGRAM:
+			/* The admin is requesting a histogram, d1 is its ID, or UINT32_MAX for all non-empty histograms. */
+			if (d1 == UINT32_MAX) {
+				for (LatencyHistogramType t = LHT_ELEMENT_FIRST; t < LHT_END; t++) {
+					if (GetLatencyHistogram(t).count > 0) this->SendLatencyHistogram(t);
+				}
+			} else if (d1 < LHT_END) {
+				this->SendLatencyHistogram((LatencyHistogramType)d1);
+			}
+			break;
+
 		default:
 			/* An unsupported "poll" update type. */
 			DEBUG(net, 1, "[admin] Not supported poll %d (%d) from '%s' (%s).", type, d1, this->admin_name.c_str(), this->admin_version.c_str());
@@ -1022,6 +1200,10 @@ void NetworkAdminUpdate(AdminUpdateFrequency freq)
 						as->SendCompanyStats();
 						break;
 
+					case ADMIN_UPDATE_PERFORMANCE:
+						as->SendPerformance();
+						break;
+
 					default: NOT_REACHED();
 				}
 			}
@@ -13,6 +13,7 @@
 #include "network_internal.h"
 #include "core/tcp_listen.h"
 #include "core/tcp_admin.h"
+#include "../framerate_type.h"
 
 extern AdminIndex _redirect_console_to_admin;
 
@@ -69,6 +70,10 @@ public:
 	NetworkRecvStatus SendCmdNames();
 	NetworkRecvStatus SendCmdLogging(ClientID client_id, const CommandPacket *cp);
 	NetworkRecvStatus SendRconEnd(const std::string_view command);
+	NetworkRecvStatus SendPerformance();
+	NetworkRecvStatus SendVehicleProfile(uint count);
+	NetworkRecvStatus SendPoolStats();
+	NetworkRecvStatus SendLatencyHistogram(LatencyHistogramType type);
 
 	static void Send();
 	static void AcceptConnection(SOCKET s, const NetworkAddress &address);
@@ -521,21 +521,18 @@ bool ClientNetworkContentSocketHandler::Receive_SERVER_CONTENT(Packet *p)
 }
 
 /**
- * Handle the opening of the file before downloading.
+ * Open the file to download a content file into.
+ * @param ci The content to download.
+ * @param[out] file The opened file, or nullptr when there is nothing to download.
  * @return false on any error.
  */
-bool ClientNetworkContentSocketHandler::BeforeDownload()
+static bool OpenDownloadFile(const ContentInfo *ci, FILE **file)
 {
-	if (!this->curInfo->IsValid()) {
-		delete this->curInfo;
-		this->curInfo = nullptr;
-		return false;
-	}
-
-	if (this->curInfo->filesize != 0) {
+	*file = nullptr;
+	if (ci->filesize != 0) {
 		/* The filesize is > 0, so we are going to download it */
-		std::string filename = GetFullFilename(this->curInfo, true);
-		if (filename.empty() || (this->curFile = fopen(filename.c_str(), "wb")) == nullptr) {
+		std::string filename = GetFullFilename(ci, true);
+		if (filename.empty() || (*file = fopen(filename.c_str(), "wb")) == nullptr) {
 			/* Unless that fails of course... */
 			DeleteWindowById(WC_NETWORK_STATUS_WINDOW, WN_NETWORK_STATUS_WINDOW_CONTENT_DOWNLOAD);
 			ShowErrorMessage(STR_CONTENT_ERROR_COULD_NOT_DOWNLOAD, STR_CONTENT_ERROR_COULD_NOT_DOWNLOAD_FILE_NOT_WRITABLE, WL_ERROR);
@@ -545,6 +542,21 @@ bool ClientNetworkContentSocketHandler::BeforeDownload()
 	return true;
 }
 
+/**
+ * Handle the opening of the file before downloading.
+ * @return false on any error.
+ */
+bool ClientNetworkContentSocketHandler::BeforeDownload()
+{
+	if (!this->curInfo->IsValid()) {
+		delete this->curInfo;
+		this->curInfo = nullptr;
+		return false;
+	}
+
+	return OpenDownloadFile(this->curInfo, &this->curFile);
+}
+
 /**
  * Handle the closing and extracting of a file after
  * downloading it has been done.
@@ -557,28 +569,175 @@ void ClientNetworkContentSocketHandler::AfterDownload()
 	this->curFile = nullptr;
 
 	if (GunzipFile(this->curInfo)) {
-		unlink(GetFullFilename(this->curInfo, true).c_str());
+		this->InstallDownloadedFile(this->curInfo);
+	} else {
+		ShowErrorMessage(STR_CONTENT_ERROR_COULD_NOT_EXTRACT, INVALID_STRING_ID, WL_ERROR);
+	}
+}
+
+/**
+ * Make a downloaded and extracted content file known.
+ * @param ci The content of the file.
+ */
+void ClientNetworkContentSocketHandler::InstallDownloadedFile(const ContentInfo *ci)
+{
+	unlink(GetFullFilename(ci, true).c_str());
 
-		Subdirectory sd = GetContentInfoSubDir(this->curInfo->type);
-		if (sd == NO_DIRECTORY) NOT_REACHED();
+	Subdirectory sd = GetContentInfoSubDir(ci->type);
+	if (sd == NO_DIRECTORY) NOT_REACHED();
 
-		TarScanner ts;
-		std::string fname = GetFullFilename(this->curInfo, false);
-		ts.AddFile(sd, fname);
+	TarScanner ts;
+	std::string fname = GetFullFilename(ci, false);
+	ts.AddFile(sd, fname);
 
-		if (this->curInfo->type == CONTENT_TYPE_BASE_MUSIC) {
-			/* Music can't be in a tar. So extract the tar! */
-			ExtractTar(fname, BASESET_DIR);
-			unlink(fname.c_str());
-		}
+	if (ci->type == CONTENT_TYPE_BASE_MUSIC) {
+		/* Music can't be in a tar. So extract the tar! */
+		ExtractTar(fname, BASESET_DIR);
+		unlink(fname.c_str());
+	}
 
 #ifdef __EMSCRIPTEN__
-		EM_ASM(if (window["openttd_syncfs"]) openttd_syncfs());
+	EM_ASM(if (window["openttd_syncfs"]) openttd_syncfs());
 #endif
 
-		this->OnDownloadComplete(this->curInfo->id);
+	this->OnDownloadComplete(ci->id);
+}
+
+/**
+ * Download of a single content file over HTTP.
+ * The downloads of several files may run at the same time, each on their own HTTP thread.
+ * The received file is extracted on that HTTP thread too, while the other downloads continue.
+ * The object deletes itself when the download has finished or failed.
+ */
+struct ContentHTTPFileDownload : HTTPCallback {
+	ClientNetworkContentSocketHandler *handler; ///< The content handler this download is for.
+	std::unique_ptr<ContentInfo> info;          ///< The content being downloaded.
+	FILE *file;                                 ///< The file being written, nullptr when there is nothing to download.
+	bool write_failed = false;                  ///< Whether writing to the file failed, which cancels the download.
+
+	ContentHTTPFileDownload(ClientNetworkContentSocketHandler *handler, std::unique_ptr<ContentInfo> info, FILE *file) :
+		handler(handler), info(std::move(info)), file(file) {}
+
+	void OnFailure() override
+	{
+		if (this->file != nullptr) {
+			{
+				std::lock_guard<std::mutex> lock(this->handler->http_mutex);
+				this->handler->OnDownloadProgress(this->info.get(), -1);
+			}
+			fclose(this->file);
+			this->file = nullptr;
+		}
+
+		this->handler->OnHTTPFileDownloadDone(false);
+		delete this;
+	}
+
+	void OnReceiveData(const char *data, size_t length) override
+	{
+		if (data != nullptr) {
+			if (this->file == nullptr || this->write_failed) return;
+			if (fwrite(data, 1, length, this->file) != length) {
+				/* Writing failed somehow, the download gets cancelled and retried via the old method. */
+				this->write_failed = true;
+				return;
+			}
+			std::lock_guard<std::mutex> lock(this->handler->http_mutex);
+			this->handler->OnDownloadProgress(this->info.get(), (int)length);
+			return;
+		}
+
+		if (this->file != nullptr) {
+			/* We've finished downloading the file, gunzip it without holding up the other downloads. */
+			fclose(this->file);
+			this->file = nullptr;
+
+			const bool extracted = GunzipFile(this->info.get());
+
+			std::lock_guard<std::mutex> lock(this->handler->http_mutex);
+			if (extracted) {
+				this->handler->InstallDownloadedFile(this->info.get());
+			} else {
+				ShowErrorMessage(STR_CONTENT_ERROR_COULD_NOT_EXTRACT, INVALID_STRING_ID, WL_ERROR);
+			}
+		}
+
+		this->handler->OnHTTPFileDownloadDone(true);
+		delete this;
+	}
+
+	bool IsCancelled() const override
+	{
+		return this->write_failed || this->handler->isCancelled;
+	}
+};
+
+/** Forget the content files which were still to be downloaded over HTTP. The caller must hold http_mutex. */
+void ClientNetworkContentSocketHandler::ClearHTTPPending()
+{
+	for (auto &pending : this->http_pending) delete pending.first;
+	this->http_pending.clear();
+}
+
+/** Start downloading pending content files over HTTP, up to the configured number of concurrent downloads. */
+void ClientNetworkContentSocketHandler::StartHTTPFileDownloads()
+{
+	for (;;) {
+		std::unique_ptr<ContentInfo> info;
+		std::string uri;
+		{
+			std::lock_guard<std::mutex> lock(this->http_mutex);
+			if (this->isCancelled) this->ClearHTTPPending();
+			if (this->http_pending.empty() || this->http_active >= std::max<uint>(1, _settings_client.network.http_content_download_concurrency)) return;
+
+			info.reset(this->http_pending.front().first);
+			uri = std::move(this->http_pending.front().second);
+			this->http_pending.pop_front();
+			this->http_active++;
+		}
+
+		FILE *file = nullptr;
+		bool opened;
+		{
+			std::lock_guard<std::mutex> lock(this->http_mutex);
+			opened = info->IsValid() && OpenDownloadFile(info.get(), &file);
+		}
+		if (!opened) {
+			if (this->FinishHTTPFileDownload(false)) {
+				this->OnFailure();
+				return;
+			}
+			continue;
+		}
+
+		NetworkHTTPSocketHandler::Connect(uri, new ContentHTTPFileDownload(this, std::move(info), file));
+	}
+}
+
+/**
+ * Account for a finished content file download over HTTP.
+ * @param success Whether the download succeeded; when not, the pending downloads are dropped.
+ * @return True when no content file downloads over HTTP are active or pending any more.
+ */
+bool ClientNetworkContentSocketHandler::FinishHTTPFileDownload(bool success)
+{
+	std::lock_guard<std::mutex> lock(this->http_mutex);
+	if (!success) this->ClearHTTPPending();
+	this->http_active--;
+	return this->http_active == 0 && this->http_pending.empty();
+}
+
+/**
+ * Handle a finished content file download over HTTP.
+ * @param success Whether the download succeeded.
+ */
+void ClientNetworkContentSocketHandler::OnHTTPFileDownloadDone(bool success)
+{
+	if (this->FinishHTTPFileDownload(success)) {
+		/* Not necessarily a real failure, but download whatever is left via the 'old' system and clean up. */
+		this->OnFailure();
 	} else {
-		ShowErrorMessage(STR_CONTENT_ERROR_COULD_NOT_EXTRACT, INVALID_STRING_ID, WL_ERROR);
+		this->StartHTTPFileDownloads();
 	}
 }
 
@@ -616,122 +775,92 @@ void ClientNetworkContentSocketHandler::OnReceiveData(const char *data, size_t l
 	/* Ignore any latent data coming from a connection we closed. */
 	if (this->http_response_index == -2) return;
 
-	if (this->http_response_index == -1) {
-		if (data != nullptr) {
-			/* Append the rest of the response. */
-			this->http_response.insert(this->http_response.end(), data, data + length);
-			return;
-		} else {
-			/* Make sure the response is properly terminated. */
-			this->http_response.push_back('\0');
-
-			/* And prepare for receiving the rest of the data. */
-			this->http_response_index = 0;
-		}
-	}
-
 	if (data != nullptr) {
-		/* We have data, so write it to the file. */
-		if (fwrite(data, 1, length, this->curFile) != length) {
-			/* Writing failed somehow, let try via the old method. */
-			this->OnFailure();
-		} else {
-			/* Just received the data. */
-			this->OnDownloadProgress(this->curInfo, (int)length);
-		}
-		/* Nothing more to do now. */
-		return;
-	}
-
-	if (this->curFile != nullptr) {
-		/* We've finished downloading a file. */
-		this->AfterDownload();
-	}
-
-	if ((uint)this->http_response_index >= this->http_response.size()) {
-		/* It's not a real failure, but if there's
-		 * nothing more to download it helps with
-		 * cleaning up the stuff we allocated. */
-		this->OnFailure();
+		/* Append the rest of the response. */
+		this->http_response.insert(this->http_response.end(), data, data + length);
 		return;
 	}
 
-	delete this->curInfo;
-	/* When we haven't opened a file this must be our first packet with metadata. */
-	this->curInfo = new ContentInfo;
-
-/** Check p for not being null and return calling OnFailure if that's not the case. */
-#define check_not_null(p) { if ((p) == nullptr) { this->OnFailure(); return; } }
-/** Check p for not being null and then terminate, or return calling OnFailure. */
-#define check_and_terminate(p) { check_not_null(p); *(p) = '\0'; }
+	/* Make sure the response is properly terminated. */
+	this->http_response.push_back('\0');
+	this->http_response_index = 0;
 
+	/* Parse the lines of the response into the files to download; files
+	 * which cannot be parsed are left to the 'old' system. */
+	std::deque<std::pair<ContentInfo *, std::string>> pending;
 	for (;;) {
 		char *str = this->http_response.data() + this->http_response_index;
 		char *p = strchr(str, '\n');
-		check_and_terminate(p);
+		if (p == nullptr) break;
+		*p = '\0';
 
 		/* Update the index for the next one */
 		this->http_response_index += (int)strlen(str) + 1;
 
+		std::unique_ptr<ContentInfo> ci = std::make_unique<ContentInfo>();
+
 		/* Read the ID */
 		p = strchr(str, ',');
-		check_and_terminate(p);
-		this->curInfo->id = (ContentID)atoi(str);
+		if (p == nullptr) break;
+		*p = '\0';
+		ci->id = (ContentID)atoi(str);
 
 		/* Read the type */
 		str = p + 1;
 		p = strchr(str, ',');
-		check_and_terminate(p);
-		this->curInfo->type = (ContentType)atoi(str);
+		if (p == nullptr) break;
+		*p = '\0';
+		ci->type = (ContentType)atoi(str);
 
 		/* Read the file size */
 		str = p + 1;
 		p = strchr(str, ',');
-		check_and_terminate(p);
-		this->curInfo->filesize = atoi(str);
+		if (p == nullptr) break;
+		*p = '\0';
+		ci->filesize = atoi(str);
 
 		/* Read the URL */
 		str = p + 1;
 		/* Is it a fallback URL? If so, just continue with the next one. */
-		if (strncmp(str, "ottd", 4) == 0) {
-			if ((uint)this->http_response_index >= this->http_response.size()) {
-				/* Have we gone through all lines? */
-				this->OnFailure();
-				return;
-			}
-			continue;
-		}
+		if (strncmp(str, "ottd", 4) == 0) continue;
 
 		p = strrchr(str, '/');
-		check_not_null(p);
+		if (p == nullptr) break;
 		p++; // Start after the '/'
 
 		char tmp[MAX_PATH];
-		if (strecpy(tmp, p, lastof(tmp)) == lastof(tmp)) {
-			this->OnFailure();
-			return;
-		}
+		if (strecpy(tmp, p, lastof(tmp)) == lastof(tmp)) break;
+
 		/* Remove the extension from the string. */
-		for (uint i = 0; i < 2; i++) {
+		bool valid = true;
+		for (uint i = 0; i < 2 && valid; i++) {
 			p = strrchr(tmp, '.');
-			check_and_terminate(p);
+			if (p == nullptr) {
+				valid = false;
+			} else {
+				*p = '\0';
+			}
 		}
+		if (!valid) break;
 
 		/* Copy the string, without extension, to the filename. */
-		this->curInfo->filename = tmp;
+		ci->filename = tmp;
 
-		/* Request the next file. */
-		if (!this->BeforeDownload()) {
-			this->OnFailure();
-			return;
-		}
+		pending.emplace_back(ci.release(), str);
+	}
 
-		NetworkHTTPSocketHandler::Connect(str, this);
+	if (pending.empty()) {
+		/* Nothing to download over HTTP, let the 'old' system handle it and clean up. */
+		this->OnFailure();
 		return;
 	}
 
-#undef check
-#undef check_and_terminate
+	{
+		std::lock_guard<std::mutex> lock(this->http_mutex);
+		this->ClearHTTPPending();
+		this->http_pending = std::move(pending);
+	}
+	this->StartHTTPFileDownloads();
 }
 
 /**
@@ -740,6 +869,7 @@ void ClientNetworkContentSocketHandler::OnReceiveData(const char *data, size_t l
 ClientNetworkContentSocketHandler::ClientNetworkContentSocketHandler() :
 	NetworkContentSocketHandler(),
 	http_response_index(-2),
+	http_active(0),
 	curFile(nullptr),
 	curInfo(nullptr),
 	isConnecting(false),
@@ -751,6 +881,7 @@ ClientNetworkContentSocketHandler::ClientNetworkContentSocketHandler() :
 /** Clear up the mess ;) */
 ClientNetworkContentSocketHandler::~ClientNetworkContentSocketHandler()
 {
+	this->ClearHTTPPending();
 	delete this->curInfo;
 	if (this->curFile != nullptr) fclose(this->curFile);
 
@@ -13,6 +13,8 @@
 #include "core/tcp_content.h"
 #include "core/http.h"
 #include "../3rdparty/cpp-btree/btree_map.h"
+#include <deque>
+#include <mutex>
 
 /** Vector with content info */
 typedef std::vector<ContentInfo *> ContentVector;
@@ -72,6 +74,9 @@ protected:
 	btree::btree_multimap<ContentID, ContentID> reverse_dependency_map; ///< Content reverse dependency map
 	std::vector<char> http_response;              ///< The HTTP response to the requests we've been doing
 	int http_response_index;                      ///< Where we are, in the response, with handling it
+	std::mutex http_mutex;                        ///< Protects the HTTP file download state and callbacks, which are used from the HTTP threads
+	std::deque<std::pair<ContentInfo *, std::string>> http_pending; ///< Content files still to be downloaded over HTTP, with their URL
+	uint http_active;                             ///< Number of content files currently being downloaded over HTTP
 
 	FILE *curFile;        ///< Currently downloaded file
 	ContentInfo *curInfo; ///< Information about the currently downloaded file
@@ -80,6 +85,7 @@ protected:
 	std::chrono::steady_clock::time_point lastActivity;  ///< The last time there was network activity
 
 	friend class NetworkContentConnecter;
+	friend struct ContentHTTPFileDownload;
 
 	bool Receive_SERVER_INFO(Packet *p) override;
 	bool Receive_SERVER_CONTENT(Packet *p) override;
@@ -100,6 +106,12 @@ protected:
 
 	bool BeforeDownload();
 	void AfterDownload();
+	void InstallDownloadedFile(const ContentInfo *ci);
+
+	void ClearHTTPPending();
+	void StartHTTPFileDownloads();
+	bool FinishHTTPFileDownload(bool success);
+	void OnHTTPFileDownloadDone(bool success);
 
 	void DownloadSelectedContentHTTP(const ContentIDList &content);
 	void DownloadSelectedContentFallback(const ContentIDList &content);
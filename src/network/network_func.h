@@ -11,8 +11,9 @@
 #define NETWORK_FUNC_H
 
 /**
- * Uncomment the following define to enable command replaying.
- * See docs/desync.txt for details.
+ * Uncomment the following define to enable command replaying,
+ * or configure with -DOPTION_REPLAY_COMMANDS=ON.
+ * See docs/desync.md for details.
  */
 // #define DEBUG_DUMP_COMMANDS
 // #define DEBUG_FAILED_DUMP_COMMANDS
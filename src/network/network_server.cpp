@@ -30,6 +30,8 @@
 #include "../core/random_func.hpp"
 #include "../rev.h"
 #include "../crashlog.h"
+#include <chrono>
+#include <map>
 #include <mutex>
 #include <condition_variable>
 #if defined(__MINGW32__)
@@ -58,13 +60,20 @@ INSTANTIATE_POOL_METHODS(NetworkClientSocket)
 /** Instantiate the listen sockets. */
 template SocketList TCPListenHandler<ServerNetworkGameSocketHandler, PACKET_SERVER_FULL, PACKET_SERVER_BANNED>::sockets;
 
-/** Writing a savegame directly to a number of packets. */
+/** Writing a savegame directly to a number of packets, shared by all clients receiving the same map. */
 struct PacketWriter : SaveFilter {
-	ServerNetworkGameSocketHandler *cs; ///< Socket we are associated with.
+	/** State of a client receiving this savegame. */
+	struct Receiver {
+		ServerNetworkGameSocketHandler *cs; ///< Socket of the client.
+		size_t next_packet;                 ///< Index of the first packet in the queue not yet given to the client.
+		bool map_size_sent;                 ///< Whether the map size packet has been given to the client.
+	};
+
+	std::vector<Receiver> receivers;    ///< Clients still receiving the savegame.
 	std::unique_ptr<Packet> current;    ///< The packet we're currently writing to.
 	size_t total_size;                  ///< Total size of the compressed savegame.
-	std::vector<std::unique_ptr<Packet>> packets; ///< Packet queue of the savegame; send these "slowly" to the client.
-	std::unique_ptr<Packet> map_size_packet; ///< Map size packet, fast tracked to the client
+	std::vector<std::unique_ptr<Packet>> packets; ///< Packet queue of the savegame; send these "slowly" to the clients. Entries given to all receivers are nullptr.
+	std::unique_ptr<Packet> map_size_packet; ///< Map size packet, fast tracked to the clients
 	std::mutex mutex;                   ///< Mutex for making threaded saving safe.
 	std::condition_variable exit_sig;   ///< Signal for threaded destruction of this packet writer.
 
@@ -72,8 +81,9 @@ struct PacketWriter : SaveFilter {
 	 * Create the packet writer.
 	 * @param cs The socket handler we're making the packets for.
 	 */
-	PacketWriter(ServerNetworkGameSocketHandler *cs) : SaveFilter(nullptr), cs(cs), total_size(0)
+	PacketWriter(ServerNetworkGameSocketHandler *cs) : SaveFilter(nullptr), total_size(0)
 	{
+		this->AddReceiver(cs);
 	}
 
 	/** Make sure everything is cleaned up. */
@@ -81,9 +91,8 @@ struct PacketWriter : SaveFilter {
 	{
 		std::unique_lock<std::mutex> lock(this->mutex);
 
-		if (this->cs != nullptr) this->exit_sig.wait(lock);
-
-		/* This must all wait until the Destroy function is called. */
+		/* This must all wait until the Destroy function is called for every receiver. */
+		this->exit_sig.wait(lock, [this]() { return this->receivers.empty(); });
 
 		this->packets.clear();
 		this->map_size_packet.reset();
@@ -91,20 +100,37 @@ struct PacketWriter : SaveFilter {
 	}
 
 	/**
-	 * Begin the destruction of this packet writer. It can happen in two ways:
+	 * Add a client receiving this savegame. This must happen before the savegame is made.
+	 * @param cs The socket handler of the client.
+	 */
+	void AddReceiver(ServerNetworkGameSocketHandler *cs)
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->receivers.push_back({ cs, 0, false });
+	}
+
+	/**
+	 * Begin the destruction of this packet writer for one of its clients. It can happen in two ways:
 	 * in the first case the client disconnected while saving the map. In this
-	 * case the saving has not finished and killed this PacketWriter. In that
-	 * case we simply set cs to nullptr, triggering the appending to fail due to
-	 * the connection problem and eventually triggering the destructor. In the
-	 * second case the destructor is already called, and it is waiting for our
-	 * signal which we will send. Only then the packets will be removed by the
+	 * case the saving has not finished and, if it was the last client, killed
+	 * this PacketWriter. In that case we simply remove the client, triggering
+	 * the appending to fail due to the connection problem and eventually
+	 * triggering the destructor. In the second case the destructor is already
+	 * called, and it is waiting for our signal which we will send once the
+	 * last client is removed. Only then the packets will be removed by the
 	 * destructor.
+	 * @param cs The socket handler of the client which no longer receives this savegame.
 	 */
-	void Destroy()
+	void Destroy(ServerNetworkGameSocketHandler *cs)
 	{
 		std::unique_lock<std::mutex> lock(this->mutex);
 
-		this->cs = nullptr;
+		this->receivers.erase(std::remove_if(this->receivers.begin(), this->receivers.end(), [cs](const Receiver &r) { return r.cs == cs; }), this->receivers.end());
+		if (!this->receivers.empty()) {
+			/* Packets only this client still needed can go. */
+			this->ReleaseSentPackets();
+			return;
+		}
 
 		this->exit_sig.notify_all();
 		lock.unlock();
@@ -116,8 +142,22 @@ struct PacketWriter : SaveFilter {
 	}
 
 	/**
-	 * Transfer all packets from here to the network's queue while holding
-	 * the lock on our mutex.
+	 * Free the packets which have been given to all receivers.
+	 * The caller must hold the lock on our mutex.
+	 */
+	void ReleaseSentPackets()
+	{
+		size_t first_needed = this->packets.size();
+		for (const Receiver &r : this->receivers) first_needed = std::min(first_needed, r.next_packet);
+		for (size_t i = 0; i < first_needed; i++) this->packets[i].reset();
+	}
+
+	static const size_t MAP_TRANSFER_MAX_QUEUED_PACKETS = 32; ///< Maximum number of map packets to keep in a socket's send queue.
+
+	/**
+	 * Transfer the available packets from here to the network's queue while holding
+	 * the lock on our mutex, up to MAP_TRANSFER_MAX_QUEUED_PACKETS queued packets.
+	 * Packets still needed by other clients are copied, the others are moved.
 	 * @param socket The network socket to write to.
 	 * @return True iff the last packet of the map has been sent.
 	 */
@@ -125,17 +165,35 @@ struct PacketWriter : SaveFilter {
 	{
 		std::lock_guard<std::mutex> lock(this->mutex);
 
-		if (this->map_size_packet) {
+		auto receiver = std::find_if(this->receivers.begin(), this->receivers.end(), [socket](const Receiver &r) { return r.cs == socket; });
+		assert(receiver != this->receivers.end());
+
+		const bool shared = this->receivers.size() > 1;
+
+		if (this->map_size_packet && !receiver->map_size_sent) {
 			/* Don't queue the PACKET_SERVER_MAP_SIZE before the corresponding PACKET_SERVER_MAP_BEGIN */
-			socket->SendPrependPacket(std::move(this->map_size_packet), PACKET_SERVER_MAP_BEGIN);
+			socket->SendPrependPacket(shared ? std::make_unique<Packet>(*this->map_size_packet) : std::move(this->map_size_packet), PACKET_SERVER_MAP_BEGIN);
+			receiver->map_size_sent = true;
+		}
+
+		size_t first_needed_by_others = this->packets.size();
+		for (const Receiver &r : this->receivers) {
+			if (r.cs != socket) first_needed_by_others = std::min(first_needed_by_others, r.next_packet);
 		}
+
 		bool last_packet = false;
-		for (auto &p : this->packets) {
+		for (; receiver->next_packet < this->packets.size(); receiver->next_packet++) {
+			/* Only keep a limited number of map packets queued on the socket, the rest is transferred once
+			 * the socket has drained. This avoids copying the whole map for slow receivers up front. */
+			if (socket->GetSendQueueLength() >= MAP_TRANSFER_MAX_QUEUED_PACKETS) break;
+			std::unique_ptr<Packet> &p = this->packets[receiver->next_packet];
 			if (p->GetPacketType() == PACKET_SERVER_MAP_DONE) last_packet = true;
-			socket->SendPacket(std::move(p));
-
+			if (receiver->next_packet < first_needed_by_others) {
+				socket->SendPacket(std::move(p));
+			} else {
+				socket->SendPacket(std::make_unique<Packet>(*p));
+			}
 		}
-		this->packets.clear();
 
 		return last_packet;
 	}
@@ -150,13 +208,13 @@ struct PacketWriter : SaveFilter {
 
 	void Write(byte *buf, size_t size) override
 	{
-		/* We want to abort the saving when the socket is closed. */
-		if (this->cs == nullptr) SlError(STR_NETWORK_ERROR_LOSTCONNECTION);
-
 		if (this->current == nullptr) this->current.reset(new Packet(PACKET_SERVER_MAP_DATA, SHRT_MAX));
 
 		std::lock_guard<std::mutex> lock(this->mutex);
 
+		/* We want to abort the saving when all sockets are closed. */
+		if (this->receivers.empty()) SlError(STR_NETWORK_ERROR_LOSTCONNECTION);
+
 		byte *bufe = buf + size;
 		while (buf != bufe) {
 			size_t written = this->current->Send_bytes(buf, bufe);
@@ -173,11 +231,11 @@ struct PacketWriter : SaveFilter {
 
 	void Finish() override
 	{
-		/* We want to abort the saving when the socket is closed. */
-		if (this->cs == nullptr) SlError(STR_NETWORK_ERROR_LOSTCONNECTION);
-
 		std::lock_guard<std::mutex> lock(this->mutex);
 
+		/* We want to abort the saving when all sockets are closed. */
+		if (this->receivers.empty()) SlError(STR_NETWORK_ERROR_LOSTCONNECTION);
+
 		/* Make sure the last packet is flushed. */
 		this->AppendQueue();
 
@@ -185,7 +243,7 @@ struct PacketWriter : SaveFilter {
 		this->current.reset(new Packet(PACKET_SERVER_MAP_DONE, SHRT_MAX));
 		this->AppendQueue();
 
-		/* Fast-track the size to the client. */
+		/* Fast-track the size to the clients. */
 		this->map_size_packet.reset(new Packet(PACKET_SERVER_MAP_SIZE, SHRT_MAX));
 		this->map_size_packet->Send_uint32((uint32)this->total_size);
 	}
@@ -223,7 +281,7 @@ ServerNetworkGameSocketHandler::~ServerNetworkGameSocketHandler()
 	RemoveVirtualTrainsOfUser(this->client_id);
 
 	if (this->savegame != nullptr) {
-		this->savegame->Destroy();
+		this->savegame->Destroy(this);
 		this->savegame = nullptr;
 	}
 }
@@ -273,7 +331,7 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::CloseConnection(NetworkRecvSta
 	 * process and queue the next client to receive the map. */
 	if (this->status == STATUS_MAP) {
 		/* Ensure the saving of the game is stopped too. */
-		this->savegame->Destroy();
+		this->savegame->Destroy(this);
 		this->savegame = nullptr;
 
 		this->CheckNextClientToSendMap(this);
@@ -361,7 +419,7 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendClientInfo(NetworkClientIn
 NetworkRecvStatus ServerNetworkGameSocketHandler::SendGameInfo()
 {
 	Packet *p = new Packet(PACKET_SERVER_GAME_INFO, TCP_MTU);
-	SerializeNetworkGameInfo(p, GetCurrentNetworkServerGameInfo());
+	SerializeCurrentNetworkServerGameInfo(p);
 
 	this->SendPacket(p);
 
@@ -371,7 +429,7 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendGameInfo()
 NetworkRecvStatus ServerNetworkGameSocketHandler::SendGameInfoExtended(PacketGameType reply_type, uint16 flags, uint16 version)
 {
 	Packet *p = new Packet(reply_type, SHRT_MAX);
-	SerializeNetworkGameInfoExtended(p, GetCurrentNetworkServerGameInfo(), flags, version);
+	SerializeCurrentNetworkServerGameInfoExtended(p, flags, version);
 
 	this->SendPacket(p);
 
@@ -554,6 +612,9 @@ void ServerNetworkGameSocketHandler::CheckNextClientToSendMap(NetworkClientSocke
 	for (NetworkClientSocket *new_cs : NetworkClientSocket::Iterate()) {
 		if (ignore_cs == new_cs) continue;
 
+		/* Others are still receiving a shared map, wait for them to finish. */
+		if (new_cs->status == STATUS_MAP) return;
+
 		if (new_cs->status == STATUS_MAP_WAIT) {
 			if (best == nullptr || best->GetInfo()->join_date > new_cs->GetInfo()->join_date || (best->GetInfo()->join_date == new_cs->GetInfo()->join_date && best->client_id > new_cs->client_id)) {
 				best = new_cs;
@@ -586,16 +647,29 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendMap()
 		WaitTillSaved();
 		this->savegame = new PacketWriter(this);
 
-		/* Now send the _frame_counter and how many packets are coming */
-		Packet *p = new Packet(PACKET_SERVER_MAP_BEGIN, SHRT_MAX);
-		p->Send_uint32(_frame_counter);
-		this->SendPacket(p);
+		auto start_transfer = [](ServerNetworkGameSocketHandler *cs) {
+			/* Now send the _frame_counter and how many packets are coming */
+			Packet *p = new Packet(PACKET_SERVER_MAP_BEGIN, SHRT_MAX);
+			p->Send_uint32(_frame_counter);
+			cs->SendPacket(p);
+
+			NetworkSyncCommandQueue(cs);
+			cs->status = STATUS_MAP;
+			/* Mark the start of download */
+			cs->last_frame = _frame_counter;
+			cs->last_frame_server = _frame_counter;
+		};
+		start_transfer(this);
+
+		/* Everyone else waiting for a map which can use the same compression receives this one too,
+		 * instead of waiting for their own savegame to be made after this transfer. */
+		for (NetworkClientSocket *new_cs : NetworkClientSocket::Iterate()) {
+			if (new_cs->status != STATUS_MAP_WAIT || new_cs->supports_zstd != this->supports_zstd) continue;
 
-		NetworkSyncCommandQueue(this);
-		this->status = STATUS_MAP;
-		/* Mark the start of download */
-		this->last_frame = _frame_counter;
-		this->last_frame_server = _frame_counter;
+			new_cs->savegame = this->savegame;
+			this->savegame->AddReceiver(new_cs);
+			start_transfer(new_cs);
+		}
 
 		/* Make a dump of the current game */
 		SaveModeFlags flags = SMF_NET_SERVER;
@@ -607,7 +681,7 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendMap()
 		bool last_packet = this->savegame->TransferToNetworkQueue(this);
 		if (last_packet) {
 			/* Done reading, make sure saving is done as well */
-			this->savegame->Destroy();
+			this->savegame->Destroy(this);
 			this->savegame = nullptr;
 
 			/* Set the status to DONE_MAP, no we will wait for the client
@@ -637,6 +711,9 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendJoin(ClientID client_id)
 /** Tell the client that they may run to a particular frame. */
 NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame()
 {
+	this->frame_pending = false;
+	this->last_frame_sent = _frame_counter;
+
 	Packet *p = new Packet(PACKET_SERVER_FRAME, SHRT_MAX);
 	p->Send_uint32(_frame_counter);
 	p->Send_uint32(_frame_counter_max);
@@ -847,8 +924,64 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendSettingsAccessUpdate(bool
  *   DEF_SERVER_RECEIVE_COMMAND has parameter: NetworkClientSocket *cs, Packet *p
  ************/
 
+/** Number of game info queries an address may make in a burst. */
+static const uint GAME_INFO_QUERY_BURST = 10;
+/** Sustained number of game info queries per second an address may make. */
+static const uint GAME_INFO_QUERY_RATE = 2;
+/** Maximum number of addresses to keep game info query rate limiting state for. */
+static const size_t GAME_INFO_QUERY_MAX_ADDRESSES = 4096;
+
+/** Token bucket of the game info queries of an address. */
+struct GameInfoQueryBucket {
+	double tokens;                                 ///< Number of queries which may currently be made.
+	std::chrono::steady_clock::time_point updated; ///< When tokens was last updated.
+};
+
+/**
+ * Check whether an address may make another game info query, and account for it.
+ * @param address The address making the query.
+ * @return True when the query may be answered.
+ */
+static bool AllowGameInfoQuery(NetworkAddress &address)
+{
+	static std::map<std::string, GameInfoQueryBucket> buckets;
+
+	const auto now = std::chrono::steady_clock::now();
+	auto refill = [&](GameInfoQueryBucket &bucket) {
+		const double elapsed = std::chrono::duration<double>(now - bucket.updated).count();
+		bucket.tokens = std::min<double>(GAME_INFO_QUERY_BURST, bucket.tokens + elapsed * GAME_INFO_QUERY_RATE);
+		bucket.updated = now;
+	};
+
+	if (buckets.size() >= GAME_INFO_QUERY_MAX_ADDRESSES) {
+		/* Forget the addresses which are not limited any more. */
+		for (auto it = buckets.begin(); it != buckets.end();) {
+			refill(it->second);
+			if (it->second.tokens >= GAME_INFO_QUERY_BURST) {
+				it = buckets.erase(it);
+			} else {
+				++it;
+			}
+		}
+		if (buckets.size() >= GAME_INFO_QUERY_MAX_ADDRESSES) buckets.clear();
+	}
+
+	auto result = buckets.insert({ address.GetHostname(), { (double)GAME_INFO_QUERY_BURST, now } });
+	GameInfoQueryBucket &bucket = result.first->second;
+	if (!result.second) refill(bucket);
+
+	if (bucket.tokens < 1) return false;
+	bucket.tokens -= 1;
+	return true;
+}
+
 NetworkRecvStatus ServerNetworkGameSocketHandler::Receive_CLIENT_GAME_INFO(Packet *p)
 {
+	if (!AllowGameInfoQuery(this->client_address)) {
+		DEBUG(net, 2, "Game info query from %s dropped, too many queries", this->client_address.GetHostname());
+		return this->CloseConnection(NETWORK_RECV_STATUS_CLIENT_QUIT);
+	}
+
 	if (p->CanReadFromPacket(9) && p->Recv_uint32() == FIND_SERVER_EXTENDED_TOKEN) {
 		PacketGameType reply_type = (PacketGameType)p->Recv_uint8();
 		uint16 flags = p->Recv_uint16();
@@ -1887,6 +2020,9 @@ static void NetworkHandleCommandQueue(NetworkClientSocket *cs)
 	}
 }
 
+/** Maximum number of ticks a frame update is held back for a client whose send queue has not drained. */
+static const uint32 FRAME_BUNDLE_MAX_TICKS = 8;
+
 /**
  * This is called every tick if this is a _network_server
  * @param send_frame Whether to send the frame to the clients.
@@ -2016,8 +2152,18 @@ void NetworkServer_Tick(bool send_frame)
 			/* Check if we can send command, and if we have anything in the queue */
 			NetworkHandleCommandQueue(cs);
 
-			/* Send an updated _frame_counter_max to the client */
-			if (send_frame) cs->SendFrame();
+			/* Send an updated _frame_counter_max to the client.
+			 * Each frame update supersedes the previous one, so while a client's send queue has not drained
+			 * (i.e. on a slow or distant link) the updates are held back and bundled into a single one, which
+			 * is sent as soon as the queue is empty. That way these clients receive the newest frame as early
+			 * as possible, instead of it queueing behind outdated ones. Updates are never held back for more
+			 * than FRAME_BUNDLE_MAX_TICKS, so a client whose queue never quite drains does not stall. */
+			if (send_frame) cs->frame_pending = true;
+#ifndef ENABLE_NETWORK_SYNC_EVERY_FRAME
+			if (cs->frame_pending && (!cs->HasSendQueue() || _frame_counter - cs->last_frame_sent >= FRAME_BUNDLE_MAX_TICKS)) cs->SendFrame();
+#else
+			if (cs->frame_pending) cs->SendFrame();
+#endif
 
 #ifndef ENABLE_NETWORK_SYNC_EVERY_FRAME
 			/* Send a sync-check packet */
@@ -81,6 +81,8 @@ public:
 	uint32 settings_hash_bits;   ///< Settings password hash entropy bits
 	bool settings_authed = false;///< Authorised to control all game settings
 	bool supports_zstd = false;  ///< Client supports zstd compression
+	bool frame_pending = false;  ///< A frame update was held back because the send queue had not drained yet
+	uint32 last_frame_sent = 0;  ///< The _frame_counter at which the last frame update was sent
 
 	struct PacketWriter *savegame; ///< Writer used to write the savegame.
 	NetworkAddress client_address; ///< IP-address of the client (so they can be banned)
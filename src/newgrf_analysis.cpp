@@ -41,6 +41,10 @@ void DeterministicSpriteGroup::AnalyseCallbacks(AnalyseCallbackOperation &op) co
 	};
 
 	if (op.mode == ACOM_FIND_CB_RESULT) {
+		for (const auto &adjust : this->adjusts) {
+			/* Persistent storage writes and procedure calls may have effects even when no callback result is returned */
+			if (adjust.operation == DSGA_OP_STOP || adjust.variable == 0x7E) op.result_flags |= ACORF_CB_RESULT_SIDE_EFFECTS;
+		}
 		if (this->calculated_result) {
 			op.result_flags |= ACORF_CB_RESULT_FOUND;
 			return;
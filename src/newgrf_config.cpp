@@ -28,8 +28,10 @@
 #include "fios.h"
 
 #include "thread.h"
+#include "3rdparty/cpp-btree/btree_map.h"
 #include <mutex>
 #include <condition_variable>
+#include <sys/stat.h>
 #if defined(__MINGW32__)
 #include "3rdparty/mingw-std-threads/mingw.mutex.h"
 #include "3rdparty/mingw-std-threads/mingw.condition_variable.h"
@@ -348,7 +350,7 @@ static const uint GRF_MD5_PENDING_MAX = 8;
 static void CalcGRFMD5SumFromState(const GRFMD5SumState &state)
 {
 	Md5 checksum;
-	uint8 buffer[1024];
+	uint8 buffer[64 * 1024];
 	size_t len;
 	size_t size = state.size;
 	while ((len = fread(buffer, 1, (size > sizeof(buffer)) ? sizeof(buffer) : size, state.f)) != 0 && size != 0) {
@@ -398,6 +400,108 @@ void CalcGRFMD5ThreadingEnd()
 	}
 }
 
+std::string _grf_md5_cache_file; ///< File the MD5 sums of scanned NewGRFs are cached in between runs.
+
+/** Cached MD5 sum of a NewGRF file, valid while the file (or tar containing it) keeps the same size and modification time. */
+struct GRFMD5CacheEntry {
+	uint64 size;
+	int64 mtime;
+	uint8 md5sum[16];
+	bool used;  ///< Whether the file was found by the current scan, not saved.
+};
+
+static btree::btree_map<std::string, GRFMD5CacheEntry> _grf_md5_cache; ///< NewGRF MD5 sum cache, keyed by the full path of the file.
+static bool _grf_md5_cache_loaded = false;  ///< Whether #_grf_md5_cache_file has been read.
+static bool _grf_md5_cache_scanning = false; ///< Whether a NewGRF scan is in progress, the cache is only used and updated during scans.
+static bool _grf_md5_cache_dirty = false;    ///< Whether #_grf_md5_cache differs from the contents of #_grf_md5_cache_file.
+
+/** NewGRFs whose MD5 sum is being calculated during the current scan, to be added to the cache when the scan is complete. */
+static std::vector<std::pair<GRFConfig *, std::pair<std::string, GRFMD5CacheEntry>>> _grf_md5_cache_pending;
+
+/** Read the NewGRF MD5 sum cache file, if not already done. */
+static void LoadGRFMD5Cache()
+{
+	if (_grf_md5_cache_loaded || _grf_md5_cache_file.empty()) return;
+	_grf_md5_cache_loaded = true;
+
+	FILE *f = fopen(_grf_md5_cache_file.c_str(), "r");
+	if (f == nullptr) return;
+
+	char line[4096];
+	while (fgets(line, sizeof(line), f) != nullptr) {
+		/* Format: <md5 hex> <size> <mtime> <path> */
+		char md5hex[33];
+		unsigned long long size;
+		long long mtime;
+		int path_offset = 0;
+		if (sscanf(line, "%32s %llu %lld %n", md5hex, &size, &mtime, &path_offset) != 3 || path_offset == 0) continue;
+
+		std::string path = line + path_offset;
+		while (!path.empty() && (path.back() == '\n' || path.back() == '\r')) path.pop_back();
+		if (path.empty() || strlen(md5hex) != 32) continue;
+
+		GRFMD5CacheEntry entry;
+		entry.size = size;
+		entry.mtime = mtime;
+		entry.used = false;
+		bool valid = true;
+		for (uint i = 0; i < lengthof(entry.md5sum) && valid; i++) {
+			uint byte;
+			valid = (sscanf(md5hex + i * 2, "%2x", &byte) == 1);
+			entry.md5sum[i] = byte;
+		}
+		if (valid) _grf_md5_cache[path] = entry;
+	}
+	fclose(f);
+}
+
+/** Write the NewGRF MD5 sum cache file, if it changed. */
+static void SaveGRFMD5Cache()
+{
+	if (!_grf_md5_cache_dirty || _grf_md5_cache_file.empty()) return;
+	_grf_md5_cache_dirty = false;
+
+	FILE *f = fopen(_grf_md5_cache_file.c_str(), "w");
+	if (f == nullptr) {
+		DEBUG(grf, 1, "Could not write NewGRF MD5 cache: %s", _grf_md5_cache_file.c_str());
+		return;
+	}
+	for (const auto &it : _grf_md5_cache) {
+		char md5hex[33];
+		md5sumToString(md5hex, lastof(md5hex), it.second.md5sum);
+		fprintf(f, "%s %llu %lld %s\n", md5hex, (unsigned long long)it.second.size, (long long)it.second.mtime, it.first.c_str());
+	}
+	fclose(f);
+}
+
+/** Add the MD5 sums calculated during the scan which just completed to the cache, remove files which were not found, and save it. */
+static void FlushGRFMD5CachePending()
+{
+	if (_exit_game) {
+		/* The scan was aborted, pending MD5 sums may not have been calculated */
+		_grf_md5_cache_pending.clear();
+		return;
+	}
+
+	for (auto iter = _grf_md5_cache.begin(); iter != _grf_md5_cache.end();) {
+		if (iter->second.used) {
+			iter->second.used = false;
+			++iter;
+		} else {
+			iter = _grf_md5_cache.erase(iter);
+			_grf_md5_cache_dirty = true;
+		}
+	}
+
+	for (auto &it : _grf_md5_cache_pending) {
+		memcpy(it.second.second.md5sum, it.first->ident.md5sum, sizeof(it.second.second.md5sum));
+		_grf_md5_cache[it.second.first] = it.second.second;
+		_grf_md5_cache_dirty = true;
+	}
+	_grf_md5_cache_pending.clear();
+	SaveGRFMD5Cache();
+}
+
 /**
  * Calculate the MD5 sum for a GRF, and store it in the config.
  * @param config GRF to compute.
@@ -407,9 +511,10 @@ void CalcGRFMD5ThreadingEnd()
 static bool CalcGRFMD5Sum(GRFConfig *config, Subdirectory subdir)
 {
 	size_t size;
+	std::string path;
 
 	/* open the file */
-	FILE *f = FioFOpenFile(config->filename, "rb", subdir, &size);
+	FILE *f = FioFOpenFile(config->filename, "rb", subdir, &size, _grf_md5_cache_scanning ? &path : nullptr);
 	if (f == nullptr) return false;
 
 	long start = ftell(f);
@@ -420,6 +525,27 @@ static bool CalcGRFMD5Sum(GRFConfig *config, Subdirectory subdir)
 		return false;
 	}
 
+	if (_grf_md5_cache_scanning && !path.empty()) {
+		/* For a NewGRF in a tar file, this is the modification time of the tar file */
+		struct stat sb;
+		if (fstat(fileno(f), &sb) == 0) {
+			GRFMD5CacheEntry entry;
+			entry.size = size;
+			entry.mtime = sb.st_mtime;
+			entry.used = false;
+
+			auto iter = _grf_md5_cache.find(path);
+			if (iter != _grf_md5_cache.end() && iter->second.size == entry.size && iter->second.mtime == entry.mtime) {
+				iter->second.used = true;
+				memcpy(config->ident.md5sum, iter->second.md5sum, sizeof(config->ident.md5sum));
+				FioFCloseFile(f);
+				return true;
+			}
+
+			_grf_md5_cache_pending.push_back({ config, { std::move(path), entry } });
+		}
+	}
+
 	/* calculate md5sum */
 	GRFMD5SumState state { config, size, f };
 	if (_grf_md5_parallel == 0) {
@@ -691,11 +817,15 @@ public:
 			return 0;
 		}
 
+		LoadGRFMD5Cache();
+		_grf_md5_cache_scanning = true;
 		CalcGRFMD5ThreadingStart();
 		GRFFileScanner fs;
 		fs.grfs.clear();
 		int ret = fs.Scan(".grf", NEWGRF_DIR);
 		CalcGRFMD5ThreadingEnd();
+		_grf_md5_cache_scanning = false;
+		FlushGRFMD5CachePending();
 
 		for (GRFConfig *c : fs.grfs) {
 			bool added = true;
@@ -27,6 +27,7 @@
 #include "scope_info.h"
 #include "newgrf_extension.h"
 #include "newgrf_analysis.h"
+#include "vehicle_profile.h"
 
 #include "safeguards.h"
 
@@ -763,13 +764,17 @@ static uint32 VehicleGetVariable(Vehicle *v, const VehicleScopeResolver *object,
 		case 0x60: // Count consist's engine ID occurrence
 			if (v->type != VEH_TRAIN) return v->GetEngine()->grf_prop.local_id == parameter ? 1 : 0;
 
-			{
+			/* Long consists query this for every part, so remember the count of the last queried engine ID. */
+			if (!HasBit(v->grf_cache.cache_valid, NCVV_ENGINE_ID_COUNT) || v->grf_cache.engine_id_count_parameter != parameter) {
 				uint count = 0;
-				for (; v != nullptr; v = v->Next()) {
-					if (v->GetEngine()->grf_prop.local_id == parameter) count++;
+				for (const Vehicle *u = v; u != nullptr; u = u->Next()) {
+					if (u->GetEngine()->grf_prop.local_id == parameter) count++;
 				}
-				return count;
+				v->grf_cache.engine_id_count_parameter = parameter;
+				v->grf_cache.engine_id_count = count;
+				SetBit(v->grf_cache.cache_valid, NCVV_ENGINE_ID_COUNT);
 			}
+			return v->grf_cache.engine_id_count;
 
 		case 0x61: // Get variable of n-th vehicle in chain [signed number relative to vehicle]
 			if (!v->IsGroundVehicle() || parameter == 0x61) {
@@ -1245,6 +1250,7 @@ VehicleResolverObject::VehicleResolverObject(EngineID engine_type, const Vehicle
 
 void GetCustomEngineSprite(EngineID engine, const Vehicle *v, Direction direction, EngineImageType image_type, VehicleSpriteSeq *result)
 {
+	VehicleProfileScope profile(v, VPC_NEWGRF);
 	VehicleResolverObject object(engine, v, VehicleResolverObject::WO_CACHED, false, CBID_NO_CALLBACK);
 	result->Clear();
 
@@ -1321,6 +1327,7 @@ bool UsesWagonOverride(const Vehicle *v)
  */
 uint16 GetVehicleCallback(CallbackID callback, uint32 param1, uint32 param2, EngineID engine, const Vehicle *v)
 {
+	VehicleProfileScope profile(v, VPC_NEWGRF);
 	VehicleResolverObject object(engine, v, VehicleResolverObject::WO_UNCACHED, false, callback, param1, param2);
 	return object.ResolveCallback();
 }
@@ -1337,6 +1344,7 @@ uint16 GetVehicleCallback(CallbackID callback, uint32 param1, uint32 param2, Eng
  */
 uint16 GetVehicleCallbackParent(CallbackID callback, uint32 param1, uint32 param2, EngineID engine, const Vehicle *v, const Vehicle *parent)
 {
+	VehicleProfileScope profile(v, VPC_NEWGRF);
 	VehicleResolverObject object(engine, v, VehicleResolverObject::WO_NONE, false, callback, param1, param2);
 	object.parent_scope.SetVehicle(parent);
 	return object.ResolveCallback();
@@ -1355,6 +1363,7 @@ int GetEngineProperty(EngineID engine, PropertyID property, int orig_value, cons
 	const Engine *e = Engine::Get(engine);
 	if (static_cast<uint>(property) < 64 && !HasBit(e->cb36_properties_used, property)) return orig_value;
 
+	VehicleProfileScope profile(v, VPC_NEWGRF);
 	VehicleResolverObject object(engine, v, VehicleResolverObject::WO_UNCACHED, false, CBID_VEHICLE_MODIFY_PROPERTY, property, 0);
 	if (static_cast<uint>(property) < 64 && !e->sprite_group_cb36_properties_used.empty()) {
 		auto iter = e->sprite_group_cb36_properties_used.find(object.root_spritegroup);
@@ -1575,7 +1584,18 @@ void FillNewGRFVehicleCache(const Vehicle *v)
 	static const int partial_cache_entries[] = {
 		NCVV_CONSIST_CARGO_INFORMATION_UD,
 	};
-	static_assert(NCVV_END == lengthof(cache_entries) + lengthof(partial_cache_entries));
+	/* The cache of var 60 is only valid for the parameter of the last query, so it cannot be filled for comparison. Drop it instead. */
+	static const int parameter_cache_entries[] = {
+		NCVV_ENGINE_ID_COUNT,
+	};
+	static_assert(NCVV_END == lengthof(cache_entries) + lengthof(partial_cache_entries) + lengthof(parameter_cache_entries));
+
+	NewGRFCache &grf_cache = const_cast<Vehicle *>(v)->grf_cache;
+	for (int bit : parameter_cache_entries) {
+		ClrBit(grf_cache.cache_valid, bit);
+	}
+	grf_cache.engine_id_count_parameter = 0;
+	grf_cache.engine_id_count = 0;
 
 	/* Resolve all the variables, so their caches are set. */
 	for (size_t i = 0; i < lengthof(cache_entries); i++) {
@@ -1585,8 +1605,8 @@ void FillNewGRFVehicleCache(const Vehicle *v)
 		ro.GetScope(VSG_SCOPE_SELF)->GetVariable(cache_entries[i][0], 0, &extra);
 	}
 
-	/* Make sure really all bits are set. */
-	assert(v->grf_cache.cache_valid == (1 << NCVV_END) - 1);
+	/* Make sure really all bits are set, except those of the dropped caches. */
+	assert(v->grf_cache.cache_valid == ((1 << NCVV_END) - 1 - (1 << NCVV_ENGINE_ID_COUNT)));
 }
 
 void AnalyseEngineCallbacks()
@@ -1610,6 +1630,12 @@ void AnalyseEngineCallbacks()
 			sg->AnalyseCallbacks(op);
 			callbacks_used |= op.callbacks_used;
 			cb36_properties_used |= op.properties_used;
+			if (HasBit(e->info.callback_mask, CBM_VEHICLE_LOAD_AMOUNT)) {
+				AnalyseCallbackOperation cbr_op(ACOM_FIND_CB_RESULT);
+				cbr_op.data.cb_result = { CBID_VEHICLE_LOAD_AMOUNT, false, 0 };
+				sg->AnalyseCallbacks(cbr_op);
+				if (cbr_op.result_flags & (ACORF_CB_RESULT_FOUND | ACORF_CB_RESULT_SIDE_EFFECTS)) callbacks_used |= SGCU_VEHICLE_LOAD_AMOUNT;
+			}
 			sg_cb36[sg] = op.properties_used;
 			if ((op.result_flags & ACORF_CB_REFIT_CAP_NON_WHITELIST_FOUND) && !is_purchase) refit_cap_whitelist_ok = false;
 			if ((op.result_flags & ACORF_CB_REFIT_CAP_SEEN_VAR_47) && !is_purchase) refit_cap_no_var_47 = false;
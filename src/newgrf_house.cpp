@@ -753,7 +753,7 @@ bool NewHouseTileLoop(TileIndex tile)
 	}
 
 	/* Check callback 21, which determines if a house should be destroyed. */
-	if (HasBit(hs->callback_mask, CBM_HOUSE_DESTRUCTION)) {
+	if (HasBit(hs->callback_mask, CBM_HOUSE_DESTRUCTION) && !(hs->ctrl_flags & HCF_NO_DESTRUCTION_CB)) {
 		Town *t = Town::GetByTile(tile);
 		uint16 callback_res = GetHouseCallback(CBID_HOUSE_DESTRUCTION, 0, 0, GetHouseType(tile), t, tile);
 		if (callback_res != CALLBACK_FAILED && Convert8bitBooleanCallback(hs->grf_prop.grffile, CBID_HOUSE_DESTRUCTION, callback_res)) {
@@ -869,7 +869,7 @@ void AnalyseHouseSpriteGroups()
 		spec->ctrl_flags = HCF_NONE;
 
 		if (spec->grf_prop.spritegroup[0] == nullptr) {
-			spec->ctrl_flags |= HCF_NO_TRIGGERS;
+			spec->ctrl_flags |= HCF_NO_TRIGGERS | HCF_NO_DESTRUCTION_CB | HCF_NO_PRODUCE_CARGO_CB;
 			continue;
 		}
 
@@ -878,5 +878,20 @@ void AnalyseHouseSpriteGroups()
 		if ((find_triggers_op.callbacks_used & SGCU_RANDOM_TRIGGER) == 0) {
 			spec->ctrl_flags |= HCF_NO_TRIGGERS;
 		}
+
+		auto callback_has_no_result = [&](CallbackID callback) -> bool {
+			AnalyseCallbackOperation cbr_op(ACOM_FIND_CB_RESULT);
+			cbr_op.data.cb_result.callback = callback;
+			cbr_op.data.cb_result.check_var_10 = false;
+			cbr_op.data.cb_result.var_10_value = 0;
+			spec->grf_prop.spritegroup[0]->AnalyseCallbacks(cbr_op);
+			return (cbr_op.result_flags & (ACORF_CB_RESULT_FOUND | ACORF_CB_RESULT_SIDE_EFFECTS)) == 0;
+		};
+		if (HasBit(spec->callback_mask, CBM_HOUSE_DESTRUCTION) && callback_has_no_result(CBID_HOUSE_DESTRUCTION)) {
+			spec->ctrl_flags |= HCF_NO_DESTRUCTION_CB;
+		}
+		if (HasBit(spec->callback_mask, CBM_HOUSE_PRODUCE_CARGO) && callback_has_no_result(CBID_HOUSE_PRODUCE_CARGO)) {
+			spec->ctrl_flags |= HCF_NO_PRODUCE_CARGO_CB;
+		}
 	}
 }
@@ -326,7 +326,7 @@ static void DoTriggerIndustryTile(TileIndex tile, IndustryTileTrigger trigger, I
 	IndustryGfx gfx = GetIndustryGfx(tile);
 	const IndustryTileSpec *itspec = GetIndustryTileSpec(gfx);
 
-	if (itspec->grf_prop.spritegroup[0] == nullptr) return;
+	if (itspec->grf_prop.spritegroup[0] == nullptr || (itspec->ctrl_flags & ITCF_NO_TRIGGERS)) return;
 
 	IndustryTileResolverObject object(gfx, tile, ind, CBID_RANDOM_TRIGGER);
 	object.waiting_triggers = GetIndustryTriggers(tile) | trigger;
@@ -394,6 +394,21 @@ void TriggerIndustry(Industry *ind, IndustryTileTrigger trigger)
 
 void AnalyseIndustryTileSpriteGroups()
 {
+	for (IndustryTileSpec &tilespec : _industry_tile_specs) {
+		tilespec.ctrl_flags = ITCF_NONE;
+
+		if (tilespec.grf_prop.spritegroup[0] == nullptr) {
+			tilespec.ctrl_flags |= ITCF_NO_TRIGGERS;
+			continue;
+		}
+
+		AnalyseCallbackOperation find_triggers_op(ACOM_FIND_RANDOM_TRIGGER);
+		tilespec.grf_prop.spritegroup[0]->AnalyseCallbacks(find_triggers_op);
+		if ((find_triggers_op.callbacks_used & SGCU_RANDOM_TRIGGER) == 0) {
+			tilespec.ctrl_flags |= ITCF_NO_TRIGGERS;
+		}
+	}
+
 	for (IndustrySpec &spec : _industry_specs) {
 		const uint layout_count = (uint)spec.layouts.size();
 		spec.layout_anim_masks.clear();
@@ -16,6 +16,8 @@
 #include "walltime_func.h"
 
 #include <chrono>
+#include <algorithm>
+#include <map>
 
 
 std::vector<NewGRFProfiler> _newgrf_profilers;
@@ -27,7 +29,7 @@ Date _newgrf_profile_end_date;
  * @param grffile   The GRF file to collect profiling data on
  * @param end_date  Game date to end profiling on
  */
-NewGRFProfiler::NewGRFProfiler(const GRFFile *grffile) : grffile{ grffile }, active{ false }, cur_call{}
+NewGRFProfiler::NewGRFProfiler(const GRFFile *grffile) : grffile{ grffile }, active{ false }, start_time{ 0 }, cur_call{}
 {
 }
 
@@ -38,6 +40,39 @@ NewGRFProfiler::~NewGRFProfiler()
 {
 }
 
+/**
+ * Get the current wall clock time for profiling frames.
+ * @return Time in nanoseconds.
+ */
+static uint64 GetProfilerNanoseconds()
+{
+	using namespace std::chrono;
+	return (uint64)time_point_cast<nanoseconds>(high_resolution_clock::now()).time_since_epoch().count();
+}
+
+/**
+ * Start a new frame, nested in the frame currently being resolved if any.
+ * @param sprite Pseudo-sprite index of the sprite group being resolved.
+ */
+void NewGRFProfiler::BeginFrame(uint32 sprite)
+{
+	uint32 parent = this->frame_stack.empty() ? INVALID_FRAME : this->frame_stack.back();
+	this->frame_stack.push_back((uint32)this->frames.size());
+	this->frames.push_back({ sprite, parent, (uint32)this->calls.size(), 0, GetProfilerNanoseconds() - this->start_time });
+}
+
+/**
+ * End the frame currently being resolved.
+ */
+void NewGRFProfiler::EndFrame()
+{
+	if (this->frame_stack.empty()) return;
+
+	Frame &frame = this->frames[this->frame_stack.back()];
+	frame.time = (uint32)(GetProfilerNanoseconds() - this->start_time - frame.start);
+	this->frame_stack.pop_back();
+}
+
 /**
  * Capture the start of a sprite group resolution.
  * @param resolver  Data about sprite group being resolved
@@ -52,6 +87,7 @@ void NewGRFProfiler::BeginResolve(const ResolverObject &resolver)
 	this->cur_call.cb = resolver.callback;
 	this->cur_call.feat = resolver.GetFeature();
 	this->cur_call.item = resolver.GetDebugID();
+	this->BeginFrame(this->cur_call.root_sprite);
 }
 
 /**
@@ -60,6 +96,7 @@ void NewGRFProfiler::BeginResolve(const ResolverObject &resolver)
 void NewGRFProfiler::EndResolve(const SpriteGroup *result)
 {
 	using namespace std::chrono;
+	this->EndFrame();
 	this->cur_call.time = (uint32)time_point_cast<microseconds>(high_resolution_clock::now()).time_since_epoch().count() - this->cur_call.time;
 
 	if (result == nullptr) {
@@ -76,11 +113,21 @@ void NewGRFProfiler::EndResolve(const SpriteGroup *result)
 }
 
 /**
- * Capture a recursive sprite group resolution.
+ * Capture the start of a recursive sprite group resolution.
+ * @param group Sprite group being resolved.
  */
-void NewGRFProfiler::RecursiveResolve()
+void NewGRFProfiler::BeginRecursiveResolve(const SpriteGroup *group)
 {
 	this->cur_call.subs += 1;
+	this->BeginFrame(group->nfo_line);
+}
+
+/**
+ * Capture the completion of a recursive sprite group resolution.
+ */
+void NewGRFProfiler::EndRecursiveResolve()
+{
+	this->EndFrame();
 }
 
 void NewGRFProfiler::Start()
@@ -88,6 +135,131 @@ void NewGRFProfiler::Start()
 	this->Abort();
 	this->active = true;
 	this->start_tick = _tick_counter;
+	this->start_time = GetProfilerNanoseconds();
+}
+
+/**
+ * Get the self time of each frame, i.e. the time not spent in nested frames.
+ * @param frames Frames to process.
+ * @return Self time of each frame (nanoseconds).
+ */
+static std::vector<uint64> GetFrameSelfTimes(const std::vector<NewGRFProfiler::Frame> &frames)
+{
+	std::vector<uint64> self_times(frames.size());
+	for (size_t i = 0; i < frames.size(); i++) {
+		self_times[i] += frames[i].time;
+		if (frames[i].parent != NewGRFProfiler::INVALID_FRAME) self_times[frames[i].parent] -= frames[i].time;
+	}
+	return self_times;
+}
+
+/**
+ * Write the collected frames as folded stacks, suitable for generating flame graphs.
+ * Each line is the semicolon-separated stack of sprite groups, followed by the self time in nanoseconds.
+ */
+void NewGRFProfiler::WriteFoldedStacks() const
+{
+	std::vector<uint64> self_times = GetFrameSelfTimes(this->frames);
+
+	std::map<std::string, uint64> stacks;
+	std::vector<uint32> path;
+	char buffer[64];
+	for (size_t i = 0; i < this->frames.size(); i++) {
+		path.clear();
+		for (uint32 f = (uint32)i; f != INVALID_FRAME; f = this->frames[f].parent) {
+			path.push_back(this->frames[f].sprite);
+		}
+
+		std::string key;
+		const Frame &frame = this->frames[i];
+		if (frame.call < this->calls.size()) {
+			const Call &c = this->calls[frame.call];
+			seprintf(buffer, lastof(buffer), "feat 0x%X;cb 0x%X", c.feat, (uint)c.cb);
+			key = buffer;
+		}
+		for (auto iter = path.rbegin(); iter != path.rend(); ++iter) {
+			seprintf(buffer, lastof(buffer), "%ssprite %u", key.empty() ? "" : ";", *iter);
+			key += buffer;
+		}
+		stacks[key] += self_times[i];
+	}
+
+	std::string filename = this->GetOutputFilename("folded");
+	IConsolePrintF(CC_DEBUG, "Writing %u folded stacks to %s", (uint)stacks.size(), filename.c_str());
+
+	FILE *f = FioFOpenFile(filename, "wt", Subdirectory::NO_DIRECTORY);
+	if (f == nullptr) return;
+	FileCloser fcloser(f);
+
+	for (const auto &it : stacks) {
+		fprintf(f, "%s " OTTD_PRINTF64U "\n", it.first.c_str(), it.second);
+	}
+}
+
+/**
+ * Write the collected frames in the Chrome trace event format.
+ */
+void NewGRFProfiler::WriteChromeTrace() const
+{
+	std::string filename = this->GetOutputFilename("json");
+	IConsolePrintF(CC_DEBUG, "Writing %u trace events to %s", (uint)this->frames.size(), filename.c_str());
+
+	FILE *f = FioFOpenFile(filename, "wt", Subdirectory::NO_DIRECTORY);
+	if (f == nullptr) return;
+	FileCloser fcloser(f);
+
+	fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", f);
+	for (size_t i = 0; i < this->frames.size(); i++) {
+		const Frame &frame = this->frames[i];
+		fprintf(f, "%s{\"name\":\"sprite %u\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f", i == 0 ? "" : ",\n",
+				frame.sprite, frame.start / 1000.0, frame.time / 1000.0);
+		if (frame.parent == INVALID_FRAME && frame.call < this->calls.size()) {
+			const Call &c = this->calls[frame.call];
+			fprintf(f, ",\"cat\":\"feat 0x%X\",\"args\":{\"tick\":" OTTD_PRINTF64U ",\"item\":%u,\"cb\":\"0x%X\",\"result\":%u}", c.feat, c.tick, c.item, (uint)c.cb, c.result);
+		}
+		fputs("}", f);
+	}
+	fputs("\n]}\n", f);
+}
+
+/**
+ * Print the sprite groups with the largest self time to the console.
+ */
+void NewGRFProfiler::PrintHotSpots() const
+{
+	struct GroupTimes {
+		uint32 sprite;
+		uint32 count;
+		uint64 self_time;
+		uint64 total_time;
+	};
+
+	std::vector<uint64> self_times = GetFrameSelfTimes(this->frames);
+
+	std::map<uint32, GroupTimes> groups;
+	for (size_t i = 0; i < this->frames.size(); i++) {
+		const Frame &frame = this->frames[i];
+		GroupTimes &times = groups.insert({ frame.sprite, { frame.sprite, 0, 0, 0 } }).first->second;
+		times.count++;
+		times.self_time += self_times[i];
+		times.total_time += frame.time;
+	}
+
+	std::vector<GroupTimes> sorted;
+	sorted.reserve(groups.size());
+	for (const auto &it : groups) {
+		sorted.push_back(it.second);
+	}
+	std::sort(sorted.begin(), sorted.end(), [](const GroupTimes &a, const GroupTimes &b) {
+		return a.self_time > b.self_time;
+	});
+
+	IConsolePrintF(CC_DEBUG, "Sprite groups of NewGRF [%08X] with the largest self time:", BSWAP32(this->grffile->grfid));
+	for (size_t i = 0; i < sorted.size() && i < 10; i++) {
+		const GroupTimes &times = sorted[i];
+		IConsolePrintF(CC_DEBUG, "  sprite %u: %u resolves, self: " OTTD_PRINTF64U " us, total: " OTTD_PRINTF64U " us",
+				times.sprite, times.count, times.self_time / 1000, times.total_time / 1000);
+	}
 }
 
 uint32 NewGRFProfiler::Finish()
@@ -99,18 +271,26 @@ uint32 NewGRFProfiler::Finish()
 		return 0;
 	}
 
-	std::string filename = this->GetOutputFilename();
+	std::string filename = this->GetOutputFilename("csv");
 	IConsolePrintF(CC_DEBUG, "Finished profile of NewGRF [%08X], writing %u events to %s", BSWAP32(this->grffile->grfid), (uint)this->calls.size(), filename.c_str());
 
-	FILE *f = FioFOpenFile(filename, "wt", Subdirectory::NO_DIRECTORY);
-	FileCloser fcloser(f);
-
 	uint32 total_microseconds = 0;
 
-	fputs("Tick,Sprite,Feature,Item,CallbackID,Microseconds,Depth,Result\n", f);
-	for (const Call &c : this->calls) {
-		fprintf(f, OTTD_PRINTF64U ",%u,0x%X,%u,0x%X,%u,%u,%u\n", c.tick, c.root_sprite, c.feat, c.item, (uint)c.cb, c.time, c.subs, c.result);
-		total_microseconds += c.time;
+	{
+		FILE *f = FioFOpenFile(filename, "wt", Subdirectory::NO_DIRECTORY);
+		FileCloser fcloser(f);
+
+		fputs("Tick,Sprite,Feature,Item,CallbackID,Microseconds,Depth,Result\n", f);
+		for (const Call &c : this->calls) {
+			fprintf(f, OTTD_PRINTF64U ",%u,0x%X,%u,0x%X,%u,%u,%u\n", c.tick, c.root_sprite, c.feat, c.item, (uint)c.cb, c.time, c.subs, c.result);
+			total_microseconds += c.time;
+		}
+	}
+
+	if (!this->frames.empty()) {
+		this->WriteFoldedStacks();
+		this->WriteChromeTrace();
+		this->PrintHotSpots();
 	}
 
 	this->Abort();
@@ -122,19 +302,22 @@ void NewGRFProfiler::Abort()
 {
 	this->active = false;
 	this->calls.clear();
+	this->frames.clear();
+	this->frame_stack.clear();
 }
 
 /**
  * Get name of the file that will be written.
+ * @param extension File name extension of the output format.
  * @return File name of profiling output file.
  */
-std::string NewGRFProfiler::GetOutputFilename() const
+std::string NewGRFProfiler::GetOutputFilename(const char *extension) const
 {
 	char timestamp[16] = {};
 	LocalTime::Format(timestamp, lastof(timestamp), "%Y%m%d-%H%M");
 
 	char filepath[MAX_PATH] = {};
-	seprintf(filepath, lastof(filepath), "%sgrfprofile-%s-%08X.csv", FiosGetScreenshotDir(), timestamp, BSWAP32(this->grffile->grfid));
+	seprintf(filepath, lastof(filepath), "%sgrfprofile-%s-%08X.%s", FiosGetScreenshotDir(), timestamp, BSWAP32(this->grffile->grfid), extension);
 
 	return std::string(filepath);
 }
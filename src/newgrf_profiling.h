@@ -29,12 +29,13 @@ struct NewGRFProfiler {
 
 	void BeginResolve(const ResolverObject &resolver);
 	void EndResolve(const SpriteGroup *result);
-	void RecursiveResolve();
+	void BeginRecursiveResolve(const SpriteGroup *group);
+	void EndRecursiveResolve();
 
 	void Start();
 	uint32 Finish();
 	void Abort();
-	std::string GetOutputFilename() const;
+	std::string GetOutputFilename(const char *extension) const;
 
 	static uint32 FinishAll();
 
@@ -50,11 +51,32 @@ struct NewGRFProfiler {
 		GrfSpecFeature feat; ///< GRF feature being resolved for
 	};
 
+	/** Measurement of a single, possibly nested, sprite group resolution */
+	struct Frame {
+		uint32 sprite;       ///< Pseudo-sprite index in GRF file of the sprite group
+		uint32 parent;       ///< Index of the parent frame, or INVALID_FRAME for a top-level resolution
+		uint32 call;         ///< Index of the top-level call this frame belongs to
+		uint32 time;         ///< Time taken for resolution, including nested frames (nanoseconds)
+		uint64 start;        ///< Start time, relative to the start of profiling (nanoseconds)
+	};
+
+	static const uint32 INVALID_FRAME = UINT32_MAX;
+
 	const GRFFile *grffile;  ///< Which GRF is being profiled
 	bool active;             ///< Is this profiler collecting data
 	uint64 start_tick;       ///< Tick number this profiler was started on
+	uint64 start_time;       ///< Wall clock time this profiler was started at (nanoseconds)
 	Call cur_call;           ///< Data for current call in progress
 	std::vector<Call> calls; ///< All calls collected so far
+	std::vector<Frame> frames;       ///< All sprite group resolution frames collected so far
+	std::vector<uint32> frame_stack; ///< Indices of the frames currently being resolved
+
+private:
+	void BeginFrame(uint32 sprite);
+	void EndFrame();
+	void WriteFoldedStacks() const;
+	void WriteChromeTrace() const;
+	void PrintHotSpots() const;
 };
 
 extern std::vector<NewGRFProfiler> _newgrf_profilers;
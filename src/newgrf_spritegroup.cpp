@@ -77,8 +77,10 @@ GrfSpecFeature GetGrfSpecFeatureForParentScope(GrfSpecFeature feature)
 		profiler->EndResolve(result);
 		return result;
 	} else {
-		profiler->RecursiveResolve();
-		return group->Resolve(object);
+		profiler->BeginRecursiveResolve(group);
+		const SpriteGroup *result = group->Resolve(object);
+		profiler->EndRecursiveResolve();
+		return result;
 	}
 }
 
@@ -255,15 +257,21 @@ static bool RangeHighComparator(const DeterministicSpriteGroupRange& range, uint
 	return range.high < value;
 }
 
-const SpriteGroup *DeterministicSpriteGroup::Resolve(ResolverObject &object) const
+/**
+ * Evaluate the variable adjustments of a deterministic sprite group.
+ * This is templated on the variable size so that the size does not need to be checked for each adjustment.
+ * @param group Sprite group to evaluate.
+ * @param object Resolver object.
+ * @param scope Scope resolver of the sprite group.
+ * @param[in,out] last_value Last value of the adjustment chain.
+ * @param[in,out] value Current value of the adjustment chain.
+ * @return True if all variables were available.
+ */
+template <typename U, typename S>
+static bool EvaluateDeterministicSpriteGroupAdjusts(const DeterministicSpriteGroup *group, ResolverObject &object, ScopeResolver *scope, uint32 &last_value, uint32 &value)
 {
-	uint32 last_value = 0;
-	uint32 value = 0;
-
-	ScopeResolver *scope = object.GetScope(this->var_scope, this->var_scope_count);
-
-	const DeterministicSpriteGroupAdjust *end = this->adjusts.data() + this->adjusts.size();
-	for (const DeterministicSpriteGroupAdjust *iter = this->adjusts.data(); iter != end; ++iter) {
+	const DeterministicSpriteGroupAdjust *end = group->adjusts.data() + group->adjusts.size();
+	for (const DeterministicSpriteGroupAdjust *iter = group->adjusts.data(); iter != end; ++iter) {
 		const DeterministicSpriteGroupAdjust &adjust = *iter;
 
 		if ((adjust.adjust_flags & DSGAF_SKIP_ON_ZERO) && (last_value == 0)) continue;
@@ -274,7 +282,7 @@ const SpriteGroup *DeterministicSpriteGroup::Resolve(ResolverObject &object) con
 		if (adjust.variable == 0x7E) {
 			const Vehicle *relative_scope_vehicle = nullptr;
 			VarSpriteGroupScopeOffset relative_scope_cached_count = 0;
-			if (this->var_scope == VSG_SCOPE_RELATIVE) {
+			if (group->var_scope == VSG_SCOPE_RELATIVE) {
 				/* Save relative scope vehicle in case it will be changed during the procedure */
 				VehicleResolverObject *veh_object = dynamic_cast<VehicleResolverObject *>(&object);
 				if (veh_object != nullptr) {
@@ -306,20 +314,38 @@ const SpriteGroup *DeterministicSpriteGroup::Resolve(ResolverObject &object) con
 		}
 
 		if (!extra.available) {
-			/* Unsupported variable: skip further processing and return either
-			 * the group from the first range or the default group. */
-			return SpriteGroup::Resolve(this->error_group, object, false);
+			/* Unsupported variable: skip further processing */
+			return false;
 		}
 
-		switch (this->size) {
-			case DSG_SIZE_BYTE:  value = EvalAdjustT<uint8,  int8> (adjust, scope, last_value, value, &iter); break;
-			case DSG_SIZE_WORD:  value = EvalAdjustT<uint16, int16>(adjust, scope, last_value, value, &iter); break;
-			case DSG_SIZE_DWORD: value = EvalAdjustT<uint32, int32>(adjust, scope, last_value, value, &iter); break;
-			default: NOT_REACHED();
-		}
+		value = EvalAdjustT<U, S>(adjust, scope, last_value, value, &iter);
 		last_value = value;
 	}
 
+	return true;
+}
+
+const SpriteGroup *DeterministicSpriteGroup::Resolve(ResolverObject &object) const
+{
+	uint32 last_value = 0;
+	uint32 value = 0;
+
+	ScopeResolver *scope = object.GetScope(this->var_scope, this->var_scope_count);
+
+	bool available;
+	switch (this->size) {
+		case DSG_SIZE_BYTE:  available = EvaluateDeterministicSpriteGroupAdjusts<uint8,  int8> (this, object, scope, last_value, value); break;
+		case DSG_SIZE_WORD:  available = EvaluateDeterministicSpriteGroupAdjusts<uint16, int16>(this, object, scope, last_value, value); break;
+		case DSG_SIZE_DWORD: available = EvaluateDeterministicSpriteGroupAdjusts<uint32, int32>(this, object, scope, last_value, value); break;
+		default: NOT_REACHED();
+	}
+
+	if (!available) {
+		/* Unsupported variable: skip further processing and return either
+		 * the group from the first range or the default group. */
+		return SpriteGroup::Resolve(this->error_group, object, false);
+	}
+
 	object.last_value = last_value;
 
 	if (this->calculated_result) {
@@ -89,6 +89,29 @@ struct ETileArea : TileArea {
 	}
 };
 
+/**
+ * Call a function for each rail station tile of a station in a trigger area, in ascending tile order.
+ * For the whole station, the cached list of its rail station tiles is used instead of checking each tile of its area.
+ * @param st Station to iterate.
+ * @param tile Tile in the trigger area.
+ * @param ta Trigger area.
+ * @param func Function to call for each tile.
+ */
+template <typename F>
+static void IterateTriggerAreaRailStationTiles(const BaseStation *st, TileIndex tile, TriggerArea ta, F func)
+{
+	if (ta == TA_WHOLE) {
+		for (TileIndex t : st->GetRailStationTiles()) {
+			func(t);
+		}
+		return;
+	}
+
+	for (TileIndex t : ETileArea(st, tile, ta)) {
+		if (st->TileBelongsToRailStation(t)) func(t);
+	}
+}
+
 
 /**
  * Evaluate a tile's position within a station, and return the result in a bit-stuffed format.
@@ -245,9 +268,29 @@ static struct {
 	uint32 v46;
 	uint32 v47;
 	uint32 v49;
-	uint8 valid; ///< Bits indicating what variable is valid (for each bit, \c 0 is invalid, \c 1 is valid).
+	uint8 valid;     ///< Bits indicating what variable is valid (for each bit, \c 0 is invalid, \c 1 is valid).
+	bool tile_scope; ///< Whether a #StationTileVariableCacheScope is active.
+	TileIndex tile;  ///< Tile the cached variables belong to, only used when #tile_scope is set.
 } _svc;
 
+/**
+ * Begin keeping the station variable cache valid for all resolves of \a tile,
+ * until the scope ends or another tile is resolved.
+ * @param tile Tile which is going to be resolved several times.
+ */
+StationTileVariableCacheScope::StationTileVariableCacheScope(TileIndex tile)
+{
+	assert(!_svc.tile_scope);
+	_svc.valid = 0;
+	_svc.tile_scope = true;
+	_svc.tile = tile;
+}
+
+StationTileVariableCacheScope::~StationTileVariableCacheScope()
+{
+	_svc.tile_scope = false;
+}
+
 /**
  * Get the town scope associated with a station, if it exists.
  * On the first call, the town scope is created (if possible).
@@ -566,8 +609,11 @@ StationResolverObject::StationResolverObject(const StationSpec *statspec, BaseSt
 	: ResolverObject(statspec->grf_prop.grffile, callback, callback_param1, callback_param2),
 	station_scope(*this, statspec, base_station, tile, rt), town_scope(nullptr)
 {
-	/* Invalidate all cached vars */
-	_svc.valid = 0;
+	/* Invalidate all cached vars, unless they are being kept for this tile */
+	if (!_svc.tile_scope || _svc.tile != tile) {
+		_svc.valid = 0;
+		_svc.tile = tile;
+	}
 
 	CargoID ctype = CT_DEFAULT_NA;
 
@@ -730,10 +776,9 @@ void DeallocateSpecFromStation(BaseStation *st, byte specindex)
 	/* specindex of 0 (default) is never freeable */
 	if (specindex == 0) return;
 
-	ETileArea area = ETileArea(st, INVALID_TILE, TA_WHOLE);
 	/* Check all tiles over the station to check if the specindex is still in use */
-	for (TileIndex tile : area) {
-		if (st->TileBelongsToRailStation(tile) && GetCustomStationSpecIndex(tile) == specindex) {
+	for (TileIndex tile : st->GetRailStationTiles()) {
+		if (GetCustomStationSpecIndex(tile) == specindex) {
 			return;
 		}
 	}
@@ -913,6 +958,7 @@ void AnimateStationTile(TileIndex tile)
 	const StationSpec *ss = GetStationSpec(tile);
 	if (ss == nullptr) return;
 
+	StationTileVariableCacheScope svc_scope(tile);
 	StationAnimationBase::AnimateTile(ss, BaseStation::GetByTile(tile), tile, HasBit(ss->flags, SSF_CB141_RANDOM_BITS));
 }
 
@@ -939,23 +985,20 @@ void TriggerStationAnimation(BaseStation *st, TileIndex trigger_tile, StationAni
 	if (!HasBit(st->cached_anim_triggers, trigger)) return;
 
 	uint16 random_bits = Random();
-	ETileArea area = ETileArea(st, trigger_tile, tas[trigger]);
 
 	/* Check all tiles over the station to check if the specindex is still in use */
-	for (TileIndex tile : area) {
-		if (st->TileBelongsToRailStation(tile)) {
-			const StationSpec *ss = GetStationSpec(tile);
-			if (ss != nullptr && HasBit(ss->animation.triggers, trigger)) {
-				CargoID cargo;
-				if (cargo_type == CT_INVALID) {
-					cargo = CT_INVALID;
-				} else {
-					cargo = ss->grf_prop.grffile->cargo_map[cargo_type];
-				}
-				StationAnimationBase::ChangeAnimationFrame(CBID_STATION_ANIM_START_STOP, ss, st, tile, (random_bits << 16) | GB(Random(), 0, 16), (uint8)trigger | (cargo << 8));
+	IterateTriggerAreaRailStationTiles(st, trigger_tile, tas[trigger], [&](TileIndex tile) {
+		const StationSpec *ss = GetStationSpec(tile);
+		if (ss != nullptr && HasBit(ss->animation.triggers, trigger)) {
+			CargoID cargo;
+			if (cargo_type == CT_INVALID) {
+				cargo = CT_INVALID;
+			} else {
+				cargo = ss->grf_prop.grffile->cargo_map[cargo_type];
 			}
+			StationAnimationBase::ChangeAnimationFrame(CBID_STATION_ANIM_START_STOP, ss, st, tile, (random_bits << 16) | GB(Random(), 0, 16), (uint8)trigger | (cargo << 8));
 		}
-	}
+	});
 }
 
 /**
@@ -981,7 +1024,6 @@ void TriggerStationRandomisation(Station *st, TileIndex trigger_tile, StationRan
 	if (cargo_type != CT_INVALID && !HasBit(st->cached_cargo_triggers, cargo_type)) return;
 
 	uint32 whole_reseed = 0;
-	ETileArea area = ETileArea(st, trigger_tile, tas[trigger]);
 
 	CargoTypes empty_mask = 0;
 	if (trigger == SRT_CARGO_TAKEN) {
@@ -998,42 +1040,40 @@ void TriggerStationRandomisation(Station *st, TileIndex trigger_tile, StationRan
 	uint32 used_triggers = 0;
 
 	/* Check all tiles over the station to check if the specindex is still in use */
-	for (TileIndex tile : area) {
-		if (st->TileBelongsToRailStation(tile)) {
-			const StationSpec *ss = GetStationSpec(tile);
-			if (ss == nullptr) continue;
-
-			/* Cargo taken "will only be triggered if all of those
-			 * cargo types have no more cargo waiting." */
-			if (trigger == SRT_CARGO_TAKEN) {
-				if ((ss->cargo_triggers & ~empty_mask) != 0) continue;
-			}
+	IterateTriggerAreaRailStationTiles(st, trigger_tile, tas[trigger], [&](TileIndex tile) {
+		const StationSpec *ss = GetStationSpec(tile);
+		if (ss == nullptr) return;
+
+		/* Cargo taken "will only be triggered if all of those
+		 * cargo types have no more cargo waiting." */
+		if (trigger == SRT_CARGO_TAKEN) {
+			if ((ss->cargo_triggers & ~empty_mask) != 0) return;
+		}
 
-			if (cargo_type == CT_INVALID || HasBit(ss->cargo_triggers, cargo_type)) {
-				StationResolverObject object(ss, st, tile, INVALID_RAILTYPE, CBID_RANDOM_TRIGGER, 0);
-				object.waiting_triggers = st->waiting_triggers;
+		if (cargo_type == CT_INVALID || HasBit(ss->cargo_triggers, cargo_type)) {
+			StationResolverObject object(ss, st, tile, INVALID_RAILTYPE, CBID_RANDOM_TRIGGER, 0);
+			object.waiting_triggers = st->waiting_triggers;
 
-				const SpriteGroup *group = object.Resolve();
-				if (group == nullptr) continue;
+			const SpriteGroup *group = object.Resolve();
+			if (group == nullptr) return;
 
-				used_triggers |= object.used_triggers;
+			used_triggers |= object.used_triggers;
 
-				uint32 reseed = object.GetReseedSum();
-				if (reseed != 0) {
-					whole_reseed |= reseed;
-					reseed >>= 16;
+			uint32 reseed = object.GetReseedSum();
+			if (reseed != 0) {
+				whole_reseed |= reseed;
+				reseed >>= 16;
 
-					/* Set individual tile random bits */
-					uint8 random_bits = GetStationTileRandomBits(tile);
-					random_bits &= ~reseed;
-					random_bits |= Random() & reseed;
-					SetStationTileRandomBits(tile, random_bits);
+				/* Set individual tile random bits */
+				uint8 random_bits = GetStationTileRandomBits(tile);
+				random_bits &= ~reseed;
+				random_bits |= Random() & reseed;
+				SetStationTileRandomBits(tile, random_bits);
 
-					MarkTileDirtyByTile(tile, VMDF_NOT_MAP_MODE);
-				}
+				MarkTileDirtyByTile(tile, VMDF_NOT_MAP_MODE);
 			}
 		}
-	}
+	});
 
 	/* Update whole station random bits */
 	st->waiting_triggers &= ~used_triggers;
@@ -190,6 +190,16 @@ struct StationSpec {
 /** Struct containing information relating to station classes. */
 typedef NewGRFClass<StationSpec, StationClassID, STAT_CLASS_MAX> StationClass;
 
+/**
+ * Keeps the cached 'expensive' station variables (platform and rail continuation info)
+ * of a tile valid across all resolves of that tile within the scope, e.g. while drawing it.
+ * The map must not be modified while the scope is active.
+ */
+struct StationTileVariableCacheScope {
+	StationTileVariableCacheScope(TileIndex tile);
+	~StationTileVariableCacheScope();
+};
+
 const StationSpec *GetStationSpec(TileIndex t);
 
 /* Evaluate a tile's position within a station, and return the result a bitstuffed format. */
@@ -11,6 +11,7 @@
 #define NEWGRF_STORAGE_H
 
 #include "core/pool_type.hpp"
+#include "core/bitmath_func.hpp"
 #include "tile_type.h"
 
 /**
@@ -59,16 +60,22 @@ private:
 /**
  * Class for persistent storage of data.
  * On #ClearChanges that data is either reverted or saved.
+ * The "old" state is backed up in pages of #PAGE_SIZE items, only for those pages which are written to.
  * @tparam TYPE the type of variable to store.
  * @tparam SIZE the size of the array.
  */
 template <typename TYPE, uint SIZE>
 struct PersistentStorageArray : BasePersistentStorageArray {
+	static constexpr uint PAGE_SIZE = 16;                                ///< Number of items backed up together.
+	static constexpr uint PAGE_COUNT = (SIZE + PAGE_SIZE - 1) / PAGE_SIZE; ///< Number of backup pages.
+	static_assert(PAGE_COUNT <= 64);
+
 	TYPE storage[SIZE]; ///< Memory to for the storage array
 	TYPE *prev_storage; ///< Memory to store "old" states so we can revert them on the performance of test cases for commands etc.
+	uint64 prev_pages;  ///< Bitmask of the pages of #prev_storage which hold a backup.
 
 	/** Simply construct the array */
-	PersistentStorageArray() : prev_storage(nullptr)
+	PersistentStorageArray() : prev_storage(nullptr), prev_pages(0)
 	{
 		memset(this->storage, 0, sizeof(this->storage));
 	}
@@ -101,16 +108,19 @@ struct PersistentStorageArray : BasePersistentStorageArray {
 		 * Saves a few cycles and such and it's pretty easy to check. */
 		if (this->storage[pos] == value) return;
 
-		/* We do not have made a backup; lets do so */
+		/* We do not have made a backup of this page; lets do so */
 		if (AreChangesPersistent()) {
-			assert(this->prev_storage == nullptr);
-		} else if (this->prev_storage == nullptr) {
-			this->prev_storage = MallocT<TYPE>(SIZE);
-			memcpy(this->prev_storage, this->storage, sizeof(this->storage));
-
-			/* We only need to register ourselves when we made the backup
-			 * as that is the only time something will have changed */
-			AddChangedPersistentStorage(this);
+			assert(this->prev_pages == 0);
+		} else if (!HasBit(this->prev_pages, pos / PAGE_SIZE)) {
+			if (this->prev_storage == nullptr) {
+				this->prev_storage = MallocT<TYPE>(SIZE);
+
+				/* We only need to register ourselves when we made the backup
+				 * as that is the only time something will have changed */
+				AddChangedPersistentStorage(this);
+			}
+			this->CopyPage(this->prev_storage, this->storage, pos / PAGE_SIZE);
+			SetBit(this->prev_pages, pos / PAGE_SIZE);
 		}
 
 		this->storage[pos] = value;
@@ -132,11 +142,27 @@ struct PersistentStorageArray : BasePersistentStorageArray {
 	void ClearChanges()
 	{
 		if (this->prev_storage != nullptr) {
-			memcpy(this->storage, this->prev_storage, sizeof(this->storage));
+			for (uint page : SetBitIterator<uint, uint64>(this->prev_pages)) {
+				this->CopyPage(this->storage, this->prev_storage, page);
+			}
 			free(this->prev_storage);
 			this->prev_storage = nullptr;
+			this->prev_pages = 0;
 		}
 	}
+
+private:
+	/**
+	 * Copy a single page of items.
+	 * @param dst  the array to copy to
+	 * @param src  the array to copy from
+	 * @param page the page to copy
+	 */
+	static void CopyPage(TYPE *dst, const TYPE *src, uint page)
+	{
+		const uint first = page * PAGE_SIZE;
+		memcpy(dst + first, src + first, std::min<uint>(PAGE_SIZE, SIZE - first) * sizeof(TYPE));
+	}
 };
 
 
@@ -66,6 +66,7 @@
 #include "viewport_func.h"
 #include "viewport_sprite_sorter.h"
 #include "framerate_type.h"
+#include "tracing.h"
 #include "programmable_signals.h"
 #include "smallmap_gui.h"
 #include "viewport_func.h"
@@ -91,12 +92,14 @@
 
 #include "linkgraph/linkgraphschedule.h"
 #include "tracerestrict.h"
+#include "pathfinder/water_regions.h"
 
 #include <mutex>
 #if defined(__MINGW32__)
 #include "3rdparty/mingw-std-threads/mingw.mutex.h"
 #endif
 
+#include <chrono>
 #include <stdarg.h>
 #include <system_error>
 
@@ -143,6 +146,7 @@ void CDECL usererror(const char *s, ...)
 	vseprintf(buf, lastof(buf), s, va);
 	va_end(va);
 
+	DebugFlushDeferredOutput();
 	ShowOSErrorBox(buf, false);
 	if (VideoDriver::GetInstance() != nullptr) VideoDriver::GetInstance()->Stop();
 
@@ -1008,10 +1012,12 @@ int openttd_main(int argc, char *argv[])
 	/* ScanNewGRFFiles now has control over the scanner. */
 	RequestNewGRFScan(scanner.release());
 
-	_general_worker_pool.Start("ottd:worker", 8);
+	_general_worker_pool.Start("ottd:worker", WorkerThreadPool::DEFAULT_MAX_WORKERS);
+	DebugStartOutputThread();
 
 	VideoDriver::GetInstance()->MainLoop();
 
+	DebugStopOutputThread();
 	_general_worker_pool.Stop();
 
 	WaitTillSaved();
@@ -1414,6 +1420,11 @@ void WriteVehicleInfo(char *&p, const char *last, const Vehicle *u, const Vehicl
 	}
 }
 
+/**
+ * Check whether the signal infrastructure totals of all companies match the signals present on the map.
+ * The map is scanned in bands of rows on the worker pool, and the partial sums of the bands are then added up.
+ * @return Whether the totals match.
+ */
 static bool SignalInfraTotalMatches()
 {
 	std::array<int, MAX_COMPANIES> old_signal_totals = {};
@@ -1421,34 +1432,570 @@ static bool SignalInfraTotalMatches()
 		old_signal_totals[c->index] = c->infrastructure.signal;
 	}
 
-	std::array<int, MAX_COMPANIES> new_signal_totals = {};
-	for (TileIndex tile = 0; tile < MapSize(); tile++) {
-		switch (GetTileType(tile)) {
-			case MP_RAILWAY:
-				if (HasSignals(tile)) {
-					const Company *c = Company::GetIfValid(GetTileOwner(tile));
-					if (c != nullptr) new_signal_totals[c->index] += CountBits(GetPresentSignals(tile));
+	const uint workers = _general_worker_pool.GetWorkerCount();
+	const uint band_rows = CeilDiv(MapSizeY(), (workers + 1) * 4);
+	const uint bands = CeilDiv(MapSizeY(), band_rows);
+	std::vector<std::array<int, MAX_COMPANIES>> band_signal_totals(bands);
+
+	WorkerTaskGroup group;
+	group.ParallelFor(0, bands, 1, [&](size_t band) {
+		std::array<int, MAX_COMPANIES> &totals = band_signal_totals[band];
+		totals = {};
+		const TileIndex first = TileXY(0, (uint)band * band_rows);
+		const TileIndex last = TileXY(0, std::min<uint>(((uint)band + 1) * band_rows, MapSizeY()));
+		for (TileIndex tile = first; tile != last; tile++) {
+			switch (GetTileType(tile)) {
+				case MP_RAILWAY:
+					if (HasSignals(tile)) {
+						const Company *c = Company::GetIfValid(GetTileOwner(tile));
+						if (c != nullptr) totals[c->index] += CountBits(GetPresentSignals(tile));
+					}
+					break;
+
+				case MP_TUNNELBRIDGE: {
+					/* Only count the tunnel/bridge if we're on the northern end tile. */
+					DiagDirection dir = GetTunnelBridgeDirection(tile);
+					if (dir == DIAGDIR_NE || dir == DIAGDIR_NW) break;
+
+					if (IsTunnelBridgeWithSignalSimulation(tile)) {
+						const Company *c = Company::GetIfValid(GetTileOwner(tile));
+						if (c != nullptr) totals[c->index] += GetTunnelBridgeSignalSimulationSignalCount(tile, GetOtherTunnelBridgeEnd(tile));
+					}
+					break;
 				}
+
+				default:
+					break;
+			}
+		}
+	});
+
+	std::array<int, MAX_COMPANIES> new_signal_totals = {};
+	for (const std::array<int, MAX_COMPANIES> &totals : band_signal_totals) {
+		for (uint i = 0; i < MAX_COMPANIES; i++) new_signal_totals[i] += totals[i];
+	}
+
+	return old_signal_totals == new_signal_totals;
+}
+
+/** Output of the cache checks, see #CheckCaches. */
+struct CheckCachesLog {
+	std::function<void(const char *)> log; ///< Function receiving each message, if not set the messages go to the desync log.
+	char buffer[1024];                     ///< Buffer of the current message.
+
+	void Log(const char *format, ...) WARN_FORMAT(2, 3);
+	void LogVehicle(const Vehicle *u, const Vehicle *v, uint length, const char *format, ...) WARN_FORMAT(5, 6);
+	void LogVehicle(const Vehicle *v, const char *format, ...) WARN_FORMAT(3, 4);
+
+private:
+	void Emit();
+};
+
+/** Output the message in the buffer. */
+void CheckCachesLog::Emit()
+{
+	DEBUG(desync, 0, "%s", this->buffer);
+	if (this->log) {
+		this->log(this->buffer);
+	} else {
+		LogDesyncMsg(this->buffer);
+	}
+}
+
+/**
+ * Output a message.
+ * @param format The format of the message.
+ */
+void CheckCachesLog::Log(const char *format, ...)
+{
+	va_list va;
+	va_start(va, format);
+	vseprintf(this->buffer, lastof(this->buffer), format, va);
+	va_end(va);
+	this->Emit();
+}
+
+/**
+ * Output a message followed by information about a vehicle in a consist.
+ * @param u The vehicle.
+ * @param v The front of the consist.
+ * @param length The position of the vehicle in the consist.
+ * @param format The format of the message.
+ */
+void CheckCachesLog::LogVehicle(const Vehicle *u, const Vehicle *v, uint length, const char *format, ...)
+{
+	va_list va;
+	va_start(va, format);
+	char *p = this->buffer + vseprintf(this->buffer, lastof(this->buffer), format, va);
+	va_end(va);
+	WriteVehicleInfo(p, lastof(this->buffer), u, v, length);
+	this->Emit();
+}
+
+/**
+ * Output a message followed by information about a vehicle.
+ * @param v The vehicle.
+ * @param format The format of the message.
+ */
+void CheckCachesLog::LogVehicle(const Vehicle *v, const char *format, ...)
+{
+	uint length = 0;
+	for (const Vehicle *u = v->First(); u != v; u = u->Next()) {
+		length++;
+	}
+
+	va_list va;
+	va_start(va, format);
+	char *p = this->buffer + vseprintf(this->buffer, lastof(this->buffer), format, va);
+	va_end(va);
+	WriteVehicleInfo(p, lastof(this->buffer), v, v->First(), length);
+	this->Emit();
+}
+
+#define CCLOG(...) ccl.Log(__VA_ARGS__)
+#define CCLOGV(...) ccl.LogVehicle(u, v, length, __VA_ARGS__)
+#define CCLOGV1(...) ccl.LogVehicle(v, __VA_ARGS__)
+
+/** Check the town caches, and the lists of nearby stations and industries of towns, stations and industries. */
+static void CheckTownStationIndustryCaches(CheckCachesLog &ccl)
+{
+	/* Check the town caches. */
+	std::vector<TownCache> old_town_caches;
+	std::vector<StationList> old_town_stations_nears;
+	for (const Town *t : Town::Iterate()) {
+		old_town_caches.push_back(t->cache);
+		old_town_stations_nears.push_back(t->stations_near);
+	}
+
+	std::vector<IndustryList> old_station_industries_nears;
+	std::vector<BitmapTileArea> old_station_catchment_tiles;
+	std::vector<uint> old_station_tiles;
+	for (Station *st : Station::Iterate()) {
+		old_station_industries_nears.push_back(st->industries_near);
+		old_station_catchment_tiles.push_back(st->catchment_tiles);
+		old_station_tiles.push_back(st->station_tiles);
+	}
+
+	std::vector<StationList> old_industry_stations_nears;
+	for (Industry *ind : Industry::Iterate()) {
+		old_industry_stations_nears.push_back(ind->stations_near);
+	}
+
+	RebuildTownCaches(false, false);
+	RebuildSubsidisedSourceAndDestinationCache();
+
+	Station::RecomputeCatchmentForAll();
+
+	uint i = 0;
+	for (Town *t : Town::Iterate()) {
+		if (old_town_caches[i].num_houses != t->cache.num_houses) {
+			CCLOG("town cache num_houses mismatch: town %i, (old size: %u, new size: %u)", (int)t->index, old_town_caches[i].num_houses, t->cache.num_houses);
+		}
+		if (old_town_caches[i].population != t->cache.population) {
+			CCLOG("town cache population mismatch: town %i, (old size: %u, new size: %u)", (int)t->index, old_town_caches[i].population, t->cache.population);
+		}
+		if (old_town_caches[i].part_of_subsidy != t->cache.part_of_subsidy) {
+			CCLOG("town cache population mismatch: town %i, (old size: %u, new size: %u)", (int)t->index, old_town_caches[i].part_of_subsidy, t->cache.part_of_subsidy);
+		}
+		if (MemCmpT(old_town_caches[i].squared_town_zone_radius, t->cache.squared_town_zone_radius, lengthof(t->cache.squared_town_zone_radius)) != 0) {
+			CCLOG("town cache squared_town_zone_radius mismatch: town %i", (int)t->index);
+		}
+		if (MemCmpT(&old_town_caches[i].building_counts, &t->cache.building_counts) != 0) {
+			CCLOG("town cache building_counts mismatch: town %i", (int)t->index);
+		}
+		if (old_town_stations_nears[i] != t->stations_near) {
+			CCLOG("town stations_near mismatch: town %i, (old size: %u, new size: %u)", (int)t->index, (uint)old_town_stations_nears[i].size(), (uint)t->stations_near.size());
+		}
+		i++;
+	}
+	i = 0;
+	for (Station *st : Station::Iterate()) {
+		if (old_station_industries_nears[i] != st->industries_near) {
+			CCLOG("station industries_near mismatch: st %i, (old size: %u, new size: %u)", (int)st->index, (uint)old_station_industries_nears[i].size(), (uint)st->industries_near.size());
+		}
+		if (!(old_station_catchment_tiles[i] == st->catchment_tiles)) {
+			CCLOG("station catchment_tiles mismatch: st %i", (int)st->index);
+		}
+		if (!(old_station_tiles[i] == st->station_tiles)) {
+			CCLOG("station station_tiles mismatch: st %i, (old: %u, new: %u)", (int)st->index, old_station_tiles[i], st->station_tiles);
+		}
+		if (!st->loading_vehicles.empty() && _stations_with_loading_vehicles.count(st->index) == 0) {
+			CCLOG("station loading vehicles index mismatch: st %i", (int)st->index);
+		}
+		i++;
+	}
+	i = 0;
+	for (Industry *ind : Industry::Iterate()) {
+		if (old_industry_stations_nears[i] != ind->stations_near) {
+			CCLOG("industry stations_near mismatch: ind %i, (old size: %u, new size: %u)", (int)ind->index, (uint)old_industry_stations_nears[i].size(), (uint)ind->stations_near.size());
+		}
+		StationList stlist;
+		if (ind->neutral_station != nullptr && !_settings_game.station.serve_neutral_industries) {
+			stlist.insert(ind->neutral_station);
+			if (ind->stations_near != stlist) {
+				CCLOG("industry neutral station stations_near mismatch: ind %i, (recalc size: %u, neutral size: %u)", (int)ind->index, (uint)ind->stations_near.size(), (uint)stlist.size());
+			}
+		} else {
+			ForAllStationsAroundTiles(ind->location, [ind, &stlist](Station *st, TileIndex tile) {
+				if (!IsTileType(tile, MP_INDUSTRY) || GetIndustryIndex(tile) != ind->index) return false;
+				stlist.insert(st);
+				return true;
+			});
+			if (ind->stations_near != stlist) {
+				CCLOG("industry FindStationsAroundTiles mismatch: ind %i, (recalc size: %u, find size: %u)", (int)ind->index, (uint)ind->stations_near.size(), (uint)stlist.size());
+			}
+		}
+		i++;
+	}
+}
+
+/** Check the company infrastructure totals. */
+static void CheckInfrastructureCaches(CheckCachesLog &ccl)
+{
+	std::vector<CompanyInfrastructure> old_infrastructure;
+	for (const Company *c : Company::Iterate()) old_infrastructure.push_back(c->infrastructure);
+
+	AfterLoadCompanyStats();
+
+	uint i = 0;
+	for (const Company *c : Company::Iterate()) {
+		if (MemCmpT(old_infrastructure.data() + i, &c->infrastructure) != 0) {
+			CCLOG("infrastructure cache mismatch: company %i", (int)c->index);
+			char buffer[4096];
+			old_infrastructure[i].Dump(buffer, lastof(buffer));
+			CCLOG("Previous:");
+			ProcessLineByLine(buffer, [&](const char *line) {
+				CCLOG("  %s", line);
+			});
+			c->infrastructure.Dump(buffer, lastof(buffer));
+			CCLOG("Recalculated:");
+			ProcessLineByLine(buffer, [&](const char *line) {
+				CCLOG("  %s", line);
+			});
+			if (old_infrastructure[i].signal != c->infrastructure.signal && _network_server && !HasChickenBit(DCBF_DESYNC_CHECK_PERIODIC_SIGNALS)) {
+				DoCommandP(0, 0, _settings_game.debug.chicken_bits | (1 << DCBF_DESYNC_CHECK_PERIODIC_SIGNALS), CMD_CHANGE_SETTING, nullptr, "debug.chicken_bits");
+			}
+		}
+		i++;
+	}
+}
+
+/**
+ * Strict checking of the road stop cache entries.
+ * @param rs The road stop.
+ */
+static void CheckRoadStopCaches(const RoadStop *rs)
+{
+	if (IsStandardRoadStopTile(rs->xy)) return;
+
+	assert(rs->GetEntry(DIAGDIR_NE) != rs->GetEntry(DIAGDIR_NW));
+	rs->GetEntry(DIAGDIR_NE)->CheckIntegrity(rs);
+	rs->GetEntry(DIAGDIR_NW)->CheckIntegrity(rs);
+}
+
+/**
+ * Check the vehicle tile hash of a vehicle, and the caches of the consist if it is a primary vehicle.
+ * @param v The vehicle.
+ */
+static void CheckVehicleCaches(CheckCachesLog &ccl, Vehicle *v)
+{
+	extern bool ValidateVehicleTileHash(const Vehicle *v);
+	if (!ValidateVehicleTileHash(v)) {
+		CCLOG("vehicle tile hash mismatch: type %i, vehicle %i, company %i, unit number %i", (int)v->type, v->index, (int)v->owner, v->unitnumber);
+	}
+
+	extern void FillNewGRFVehicleCache(const Vehicle *v);
+	if (v != v->First() || v->vehstatus & VS_CRASHED || !v->IsPrimaryVehicle()) return;
+
+	uint length = 0;
+	for (const Vehicle *u = v; u != nullptr; u = u->Next()) {
+		if (u->IsGroundVehicle() && (HasBit(u->GetGroundVehicleFlags(), GVF_GOINGUP_BIT) || HasBit(u->GetGroundVehicleFlags(), GVF_GOINGDOWN_BIT)) && u->GetGroundVehicleCache()->cached_slope_resistance && HasBit(v->vcache.cached_veh_flags, VCF_GV_ZERO_SLOPE_RESIST)) {
+			CCLOGV("VCF_GV_ZERO_SLOPE_RESIST set incorrectly (1)");
+		}
+		if (u->type == VEH_TRAIN && u->breakdown_ctr != 0 && !HasBit(Train::From(v)->flags, VRF_CONSIST_BREAKDOWN) && (Train::From(u)->IsEngine() || Train::From(u)->IsMultiheaded())) {
+			CCLOGV("VRF_CONSIST_BREAKDOWN incorrectly not set");
+		}
+		if (u->type == VEH_TRAIN && ((Train::From(u)->track & TRACK_BIT_WORMHOLE && !(Train::From(u)->vehstatus & VS_HIDDEN)) || Train::From(u)->track == TRACK_BIT_DEPOT) && !HasBit(Train::From(v)->flags, VRF_CONSIST_SPEED_REDUCTION)) {
+			CCLOGV("VRF_CONSIST_SPEED_REDUCTION incorrectly not set");
+		}
+		length++;
+	}
+
+	NewGRFCache        *grf_cache = CallocT<NewGRFCache>(length);
+	VehicleCache       *veh_cache = CallocT<VehicleCache>(length);
+	GroundVehicleCache *gro_cache = CallocT<GroundVehicleCache>(length);
+	AircraftCache      *air_cache = CallocT<AircraftCache>(length);
+	TrainCache         *tra_cache = CallocT<TrainCache>(length);
+	Vehicle           **veh_old   = CallocT<Vehicle *>(length);
+
+	length = 0;
+	for (const Vehicle *u = v; u != nullptr; u = u->Next()) {
+		FillNewGRFVehicleCache(u);
+		grf_cache[length] = u->grf_cache;
+		veh_cache[length] = u->vcache;
+		switch (u->type) {
+			case VEH_TRAIN:
+				gro_cache[length] = Train::From(u)->gcache;
+				tra_cache[length] = Train::From(u)->tcache;
+				veh_old[length] = CallocT<Train>(1);
+				memcpy((void *) veh_old[length], (const void *) Train::From(u), sizeof(Train));
+				break;
+			case VEH_ROAD:
+				gro_cache[length] = RoadVehicle::From(u)->gcache;
+				veh_old[length] = CallocT<RoadVehicle>(1);
+				memcpy((void *) veh_old[length], (const void *) RoadVehicle::From(u), sizeof(RoadVehicle));
 				break;
+			case VEH_AIRCRAFT:
+				air_cache[length] = Aircraft::From(u)->acache;
+				veh_old[length] = CallocT<Aircraft>(1);
+				memcpy((void *) veh_old[length], (const void *) Aircraft::From(u), sizeof(Aircraft));
+				break;
+			default:
+				veh_old[length] = CallocT<Vehicle>(1);
+				memcpy((void *) veh_old[length], (const void *) u, sizeof(Vehicle));
+				break;
+		}
+		length++;
+	}
 
-			case MP_TUNNELBRIDGE: {
-				/* Only count the tunnel/bridge if we're on the northern end tile. */
-				DiagDirection dir = GetTunnelBridgeDirection(tile);
-				if (dir == DIAGDIR_NE || dir == DIAGDIR_NW) break;
+	switch (v->type) {
+		case VEH_TRAIN:    Train::From(v)->ConsistChanged(CCF_TRACK); break;
+		case VEH_ROAD:     RoadVehUpdateCache(RoadVehicle::From(v)); break;
+		case VEH_AIRCRAFT: UpdateAircraftCache(Aircraft::From(v));   break;
+		case VEH_SHIP:     Ship::From(v)->UpdateCache();             break;
+		default: break;
+	}
 
-				if (IsTunnelBridgeWithSignalSimulation(tile)) {
-					const Company *c = Company::GetIfValid(GetTileOwner(tile));
-					if (c != nullptr) new_signal_totals[c->index] += GetTunnelBridgeSignalSimulationSignalCount(tile, GetOtherTunnelBridgeEnd(tile));
+	length = 0;
+	for (const Vehicle *u = v; u != nullptr; u = u->Next()) {
+		FillNewGRFVehicleCache(u);
+		if (memcmp(&grf_cache[length], &u->grf_cache, sizeof(NewGRFCache)) != 0) {
+			CCLOGV("newgrf cache mismatch");
+		}
+		if (veh_cache[length].cached_max_speed != u->vcache.cached_max_speed || veh_cache[length].cached_cargo_age_period != u->vcache.cached_cargo_age_period ||
+				veh_cache[length].cached_vis_effect != u->vcache.cached_vis_effect || HasBit(veh_cache[length].cached_veh_flags ^ u->vcache.cached_veh_flags, VCF_LAST_VISUAL_EFFECT)) {
+			CCLOGV("vehicle cache mismatch: %c%c%c%c",
+					veh_cache[length].cached_max_speed != u->vcache.cached_max_speed ? 'm' : '-',
+					veh_cache[length].cached_cargo_age_period != u->vcache.cached_cargo_age_period ? 'c' : '-',
+					veh_cache[length].cached_vis_effect != u->vcache.cached_vis_effect ? 'v' : '-',
+					HasBit(veh_cache[length].cached_veh_flags ^ u->vcache.cached_veh_flags, VCF_LAST_VISUAL_EFFECT) ? 'l' : '-');
+		}
+		if (u->IsGroundVehicle() && (HasBit(u->GetGroundVehicleFlags(), GVF_GOINGUP_BIT) || HasBit(u->GetGroundVehicleFlags(), GVF_GOINGDOWN_BIT)) && u->GetGroundVehicleCache()->cached_slope_resistance && HasBit(v->vcache.cached_veh_flags, VCF_GV_ZERO_SLOPE_RESIST)) {
+			CCLOGV("VCF_GV_ZERO_SLOPE_RESIST set incorrectly (2)");
+		}
+		if (veh_old[length]->acceleration != u->acceleration) {
+			CCLOGV("acceleration mismatch");
+		}
+		if (veh_old[length]->breakdown_chance != u->breakdown_chance) {
+			CCLOGV("breakdown_chance mismatch");
+		}
+		if (veh_old[length]->breakdown_ctr != u->breakdown_ctr) {
+			CCLOGV("breakdown_ctr mismatch");
+		}
+		if (veh_old[length]->breakdown_delay != u->breakdown_delay) {
+			CCLOGV("breakdown_delay mismatch");
+		}
+		if (veh_old[length]->breakdowns_since_last_service != u->breakdowns_since_last_service) {
+			CCLOGV("breakdowns_since_last_service mismatch");
+		}
+		if (veh_old[length]->breakdown_severity != u->breakdown_severity) {
+			CCLOGV("breakdown_severity mismatch");
+		}
+		if (veh_old[length]->breakdown_type != u->breakdown_type) {
+			CCLOGV("breakdown_type mismatch");
+		}
+		if (veh_old[length]->vehicle_flags != u->vehicle_flags) {
+			CCLOGV("vehicle_flags mismatch");
+		}
+		auto print_gv_cache_diff = [&](const char *vtype, const GroundVehicleCache &a, const GroundVehicleCache &b) {
+			CCLOGV("%s ground vehicle cache mismatch: %c%c%c%c%c%c%c%c%c%c",
+					vtype,
+					a.cached_weight != b.cached_weight ? 'w' : '-',
+					a.cached_slope_resistance != b.cached_slope_resistance ? 'r' : '-',
+					a.cached_max_te != b.cached_max_te ? 't' : '-',
+					a.cached_axle_resistance != b.cached_axle_resistance ? 'a' : '-',
+					a.cached_max_track_speed != b.cached_max_track_speed ? 's' : '-',
+					a.cached_power != b.cached_power ? 'p' : '-',
+					a.cached_air_drag != b.cached_air_drag ? 'd' : '-',
+					a.cached_total_length != b.cached_total_length ? 'l' : '-',
+					a.first_engine != b.first_engine ? 'e' : '-',
+					a.cached_veh_length != b.cached_veh_length ? 'L' : '-');
+		};
+		switch (u->type) {
+			case VEH_TRAIN:
+				if (memcmp(&gro_cache[length], &Train::From(u)->gcache, sizeof(GroundVehicleCache)) != 0) {
+					print_gv_cache_diff("train", gro_cache[length], Train::From(u)->gcache);
+				}
+				if (memcmp(&tra_cache[length], &Train::From(u)->tcache, sizeof(TrainCache)) != 0) {
+					CCLOGV("train cache mismatch: %c%c%c%c%c%c%c%c%c%c%c",
+							tra_cache[length].cached_override != Train::From(u)->tcache.cached_override ? 'o' : '-',
+							tra_cache[length].cached_curve_speed_mod != Train::From(u)->tcache.cached_curve_speed_mod ? 'C' : '-',
+							tra_cache[length].cached_tflags != Train::From(u)->tcache.cached_tflags ? 'f' : '-',
+							tra_cache[length].cached_num_engines != Train::From(u)->tcache.cached_num_engines ? 'e' : '-',
+							tra_cache[length].cached_centre_mass != Train::From(u)->tcache.cached_centre_mass ? 'm' : '-',
+							tra_cache[length].cached_braking_length != Train::From(u)->tcache.cached_braking_length ? 'b' : '-',
+							tra_cache[length].cached_veh_weight != Train::From(u)->tcache.cached_veh_weight ? 'w' : '-',
+							tra_cache[length].cached_uncapped_decel != Train::From(u)->tcache.cached_uncapped_decel ? 'D' : '-',
+							tra_cache[length].cached_deceleration != Train::From(u)->tcache.cached_deceleration ? 'd' : '-',
+							tra_cache[length].user_def_data != Train::From(u)->tcache.user_def_data ? 'u' : '-',
+							tra_cache[length].cached_max_curve_speed != Train::From(u)->tcache.cached_max_curve_speed ? 'c' : '-');
+				}
+				if (Train::From(veh_old[length])->railtype != Train::From(u)->railtype) {
+					CCLOGV("railtype mismatch");
+				}
+				if (Train::From(veh_old[length])->compatible_railtypes != Train::From(u)->compatible_railtypes) {
+					CCLOGV("compatible_railtypes mismatch");
+				}
+				if (Train::From(veh_old[length])->flags != Train::From(u)->flags) {
+					CCLOGV("train flags mismatch");
+				}
+				break;
+			case VEH_ROAD:
+				if (memcmp(&gro_cache[length], &RoadVehicle::From(u)->gcache, sizeof(GroundVehicleCache)) != 0) {
+					print_gv_cache_diff("road vehicle", gro_cache[length], Train::From(u)->gcache);
+				}
+				break;
+			case VEH_AIRCRAFT:
+				if (memcmp(&air_cache[length], &Aircraft::From(u)->acache, sizeof(AircraftCache)) != 0) {
+					CCLOGV("Aircraft vehicle cache mismatch: %c%c",
+							air_cache[length].cached_max_range != Aircraft::From(u)->acache.cached_max_range ? 'r' : '-',
+							air_cache[length].cached_max_range_sqr != Aircraft::From(u)->acache.cached_max_range_sqr ? 's' : '-');
 				}
 				break;
-			}
-
 			default:
 				break;
 		}
+		free(veh_old[length]);
+		length++;
 	}
 
-	return old_signal_totals == new_signal_totals;
+	free(grf_cache);
+	free(veh_cache);
+	free(gro_cache);
+	free(air_cache);
+	free(tra_cache);
+	free(veh_old);
+}
+
+/**
+ * Check the cargo cache of a vehicle.
+ * @param v The vehicle.
+ */
+static void CheckVehicleCargoCaches(CheckCachesLog &ccl, Vehicle *v)
+{
+	Money old_feeder_share = v->cargo.FeederShare();
+	uint old_count = v->cargo.TotalCount();
+	uint64 old_cargo_days_in_transit = v->cargo.CargoDaysInTransit();
+
+	v->cargo.InvalidateCache();
+
+	uint changed = 0;
+	if (v->cargo.FeederShare() != old_feeder_share) SetBit(changed, 0);
+	if (v->cargo.TotalCount() != old_count) SetBit(changed, 1);
+	if (v->cargo.CargoDaysInTransit() != old_cargo_days_in_transit) SetBit(changed, 2);
+	if (changed != 0) {
+		CCLOGV1("vehicle cargo cache mismatch: %c%c%c",
+				HasBit(changed, 0) ? 'f' : '-',
+				HasBit(changed, 1) ? 't' : '-',
+				HasBit(changed, 2) ? 'd' : '-');
+	}
+}
+
+/**
+ * Check the cargo caches, the rail station tiles and the docking tiles of a station.
+ * @param st The station.
+ */
+static void CheckStationCaches(CheckCachesLog &ccl, Station *st)
+{
+	for (CargoID c = 0; c < NUM_CARGO; c++) {
+		uint old_count = st->goods[c].cargo.TotalCount();
+		uint64 old_cargo_days_in_transit = st->goods[c].cargo.CargoDaysInTransit();
+
+		st->goods[c].cargo.InvalidateCache();
+
+		uint changed = 0;
+		if (st->goods[c].cargo.TotalCount() != old_count) SetBit(changed, 0);
+		if (st->goods[c].cargo.CargoDaysInTransit() != old_cargo_days_in_transit) SetBit(changed, 1);
+		if (changed != 0) {
+			CCLOG("station cargo cache mismatch: station %i, company %i, cargo %u: %c%c",
+					st->index, (int)st->owner, c,
+					HasBit(changed, 0) ? 't' : '-',
+					HasBit(changed, 1) ? 'd' : '-');
+		}
+	}
+
+	/* Check rail station tiles */
+	if (st->cached_rail_station_tiles_valid) {
+		const std::vector<TileIndex> old_rail_station_tiles = st->cached_rail_station_tiles;
+		st->InvalidateRailStationTiles();
+		if (old_rail_station_tiles != st->GetRailStationTiles()) {
+			CCLOG("station rail tile cache mismatch: station %i, company %i", st->index, (int)st->owner);
+		}
+	}
+
+	/* Check docking tiles */
+	TileArea ta;
+	std::map<TileIndex, bool> docking_tiles;
+	for (TileIndex tile : st->docking_station) {
+		ta.Add(tile);
+		docking_tiles[tile] = IsDockingTile(tile);
+	}
+	UpdateStationDockingTiles(st);
+	if (ta.tile != st->docking_station.tile || ta.w != st->docking_station.w || ta.h != st->docking_station.h) {
+		CCLOG("station docking mismatch: station %i, company %i, prev: (%X, %u, %u), recalc: (%X, %u, %u)",
+				st->index, (int)st->owner, ta.tile, ta.w, ta.h, st->docking_station.tile, st->docking_station.w, st->docking_station.h);
+	}
+	for (TileIndex tile : ta) {
+		if (docking_tiles[tile] != IsDockingTile(tile)) {
+			CCLOG("docking tile mismatch: tile %i", (int)tile);
+		}
+	}
+}
+
+/** Check the remaining caches, which are not per object. */
+static void CheckOtherCaches(CheckCachesLog &ccl)
+{
+	extern void ValidateVehicleTickCaches();
+	ValidateVehicleTickCaches();
+
+	for (Vehicle *v : Vehicle::Iterate()) {
+		if (v->Previous()) assert_msg(v->Previous()->Next() == v, "%u", v->index);
+		if (v->Next()) assert_msg(v->Next()->Previous() == v, "%u", v->index);
+	}
+	for (const TemplateVehicle *tv : TemplateVehicle::Iterate()) {
+		if (tv->Prev()) assert_msg(tv->Prev()->Next() == tv, "%u", tv->index);
+		if (tv->Next()) assert_msg(tv->Next()->Prev() == tv, "%u", tv->index);
+	}
+
+	{
+		extern std::string ValidateTemplateReplacementCaches();
+		std::string template_validation_result = ValidateTemplateReplacementCaches();
+		if (!template_validation_result.empty()) {
+			CCLOG("Template replacement cache validation failed: %s", template_validation_result.c_str());
+		}
+	}
+
+	if (!TraceRestrictSlot::ValidateVehicleIndex()) CCLOG("Trace restrict slot vehicle index validation failed");
+	TraceRestrictSlot::ValidateSlotOccupants(ccl.log);
+
+	CheckWaterRegionCaches(ccl.log);
+
+	if (!CargoPacket::ValidateDeferredCargoPayments()) CCLOG("Cargo packets deferred payments validation failed");
+
+	if (_order_destination_refcount_map_valid) {
+		btree::btree_map<uint32, uint32> saved_order_destination_refcount_map = std::move(_order_destination_refcount_map);
+		for (auto iter = saved_order_destination_refcount_map.begin(); iter != saved_order_destination_refcount_map.end();) {
+			if (iter->second == 0) {
+				iter = saved_order_destination_refcount_map.erase(iter);
+			} else {
+				++iter;
+			}
+		}
+		IntialiseOrderDestinationRefcountMap();
+		if (saved_order_destination_refcount_map != _order_destination_refcount_map) CCLOG("Order destination refcount map mismatch");
+	} else {
+		CCLOG("Order destination refcount map not valid");
+	}
 }
 
 /**
@@ -1480,474 +2027,273 @@ void CheckCaches(bool force_check, std::function<void(const char *)> log, CheckC
 	SCOPE_INFO_FMT([flags], "CheckCaches: %X", flags);
 
 	std::vector<std::string> saved_messages;
-	std::function<void(const char *)> log_orig;
+	CheckCachesLog ccl;
 	if (flags & CHECK_CACHE_EMIT_LOG) {
-		log_orig = std::move(log);
-		log = [&saved_messages, &log_orig](const char *str) {
-			if (log_orig) log_orig(str);
+		ccl.log = [&saved_messages, &log](const char *str) {
+			if (log) log(str);
 			saved_messages.emplace_back(str);
 		};
+	} else {
+		ccl.log = std::move(log);
 	}
 
-	char cclog_buffer[1024];
-	auto cclog_common = [&]() {
-		DEBUG(desync, 0, "%s", cclog_buffer);
-		if (log) {
-			log(cclog_buffer);
-		} else {
-			LogDesyncMsg(cclog_buffer);
-		}
-	};
-
-#define CCLOG(...) { \
-	seprintf(cclog_buffer, lastof(cclog_buffer), __VA_ARGS__); \
-	cclog_common(); \
-}
-
-	auto output_veh_info = [&](char *&p, const Vehicle *u, const Vehicle *v, uint length) {
-		WriteVehicleInfo(p, lastof(cclog_buffer), u, v, length);
-	};
-	auto output_veh_info_single = [&](char *&p, const Vehicle *v) {
-		uint length = 0;
-		for (const Vehicle *u = v->First(); u != v; u = u->Next()) {
-			length++;
-		}
-		WriteVehicleInfo(p, lastof(cclog_buffer), v, v->First(), length);
-	};
-
-#define CCLOGV(...) { \
-	char *p = cclog_buffer + seprintf(cclog_buffer, lastof(cclog_buffer), __VA_ARGS__); \
-	output_veh_info(p, u, v, length); \
-	cclog_common(); \
-}
-
-#define CCLOGV1(...) { \
-	char *p = cclog_buffer + seprintf(cclog_buffer, lastof(cclog_buffer), __VA_ARGS__); \
-	output_veh_info_single(p, v); \
-	cclog_common(); \
-}
+	if (flags & CHECK_CACHE_GENERAL) CheckTownStationIndustryCaches(ccl);
+	if (flags & CHECK_CACHE_INFRA_TOTALS) CheckInfrastructureCaches(ccl);
 
 	if (flags & CHECK_CACHE_GENERAL) {
-		/* Check the town caches. */
-		std::vector<TownCache> old_town_caches;
-		std::vector<StationList> old_town_stations_nears;
-		for (const Town *t : Town::Iterate()) {
-			old_town_caches.push_back(t->cache);
-			old_town_stations_nears.push_back(t->stations_near);
+		for (const RoadStop *rs : RoadStop::Iterate()) {
+			CheckRoadStopCaches(rs);
+		}
+		for (Vehicle *v : Vehicle::Iterate()) {
+			CheckVehicleCaches(ccl, v);
+		}
+		for (Vehicle *v : Vehicle::Iterate()) {
+			CheckVehicleCargoCaches(ccl, v);
 		}
-
-		std::vector<IndustryList> old_station_industries_nears;
-		std::vector<BitmapTileArea> old_station_catchment_tiles;
-		std::vector<uint> old_station_tiles;
 		for (Station *st : Station::Iterate()) {
-			old_station_industries_nears.push_back(st->industries_near);
-			old_station_catchment_tiles.push_back(st->catchment_tiles);
-			old_station_tiles.push_back(st->station_tiles);
+			CheckStationCaches(ccl, st);
 		}
+		for (OrderList *order_list : OrderList::Iterate()) {
+			order_list->DebugCheckSanity();
+		}
+		CheckOtherCaches(ccl);
+	}
 
-		std::vector<StationList> old_industry_stations_nears;
-		for (Industry *ind : Industry::Iterate()) {
-			old_industry_stations_nears.push_back(ind->stations_near);
+	if ((flags & CHECK_CACHE_EMIT_LOG) && !saved_messages.empty()) {
+		InconsistencyExtraInfo info;
+		info.check_caches_result = std::move(saved_messages);
+		CrashLog::InconsistencyLog(info);
+		for (std::string &str : info.check_caches_result) {
+			LogDesyncMsg(std::move(str));
 		}
+	}
+}
 
-		RebuildTownCaches(false, false);
-		RebuildSubsidisedSourceAndDestinationCache();
+/** Parts of the incremental cache check, in the order in which they are checked. */
+enum IncrementalCacheCheckPart : uint8 {
+	ICCP_TOWN_STATION_INDUSTRY, ///< Town, station and industry caches, see #CheckTownStationIndustryCaches.
+	ICCP_INFRASTRUCTURE,        ///< Company infrastructure totals, see #CheckInfrastructureCaches.
+	ICCP_ROAD_STOPS,            ///< Road stop entries, per road stop.
+	ICCP_VEHICLES,              ///< Vehicle caches, per vehicle.
+	ICCP_VEHICLE_CARGO,         ///< Vehicle cargo caches, per vehicle.
+	ICCP_STATIONS,              ///< Station caches, per station.
+	ICCP_ORDER_LISTS,           ///< Order list sanity, per order list.
+	ICCP_OTHER,                 ///< Remaining caches, see #CheckOtherCaches.
+	ICCP_END,
+};
 
-		Station::RecomputeCatchmentForAll();
+/** Progress of the incremental cache check. */
+struct IncrementalCacheCheckState {
+	IncrementalCacheCheckPart part = ICCP_TOWN_STATION_INDUSTRY; ///< Part being checked.
+	size_t index = 0;                                            ///< Pool index of the next object to check in the part.
+	int64 debt_us = 0;                                           ///< Time used in excess of the budget, which is made up in later ticks.
+};
 
-		uint i = 0;
-		for (Town *t : Town::Iterate()) {
-			if (old_town_caches[i].num_houses != t->cache.num_houses) {
-				CCLOG("town cache num_houses mismatch: town %i, (old size: %u, new size: %u)", (int)t->index, old_town_caches[i].num_houses, t->cache.num_houses);
-			}
-			if (old_town_caches[i].population != t->cache.population) {
-				CCLOG("town cache population mismatch: town %i, (old size: %u, new size: %u)", (int)t->index, old_town_caches[i].population, t->cache.population);
-			}
-			if (old_town_caches[i].part_of_subsidy != t->cache.part_of_subsidy) {
-				CCLOG("town cache population mismatch: town %i, (old size: %u, new size: %u)", (int)t->index, old_town_caches[i].part_of_subsidy, t->cache.part_of_subsidy);
-			}
-			if (MemCmpT(old_town_caches[i].squared_town_zone_radius, t->cache.squared_town_zone_radius, lengthof(t->cache.squared_town_zone_radius)) != 0) {
-				CCLOG("town cache squared_town_zone_radius mismatch: town %i", (int)t->index);
-			}
-			if (MemCmpT(&old_town_caches[i].building_counts, &t->cache.building_counts) != 0) {
-				CCLOG("town cache building_counts mismatch: town %i", (int)t->index);
-			}
-			if (old_town_stations_nears[i] != t->stations_near) {
-				CCLOG("town stations_near mismatch: town %i, (old size: %u, new size: %u)", (int)t->index, (uint)old_town_stations_nears[i].size(), (uint)t->stations_near.size());
-			}
-			i++;
-		}
-		i = 0;
-		for (Station *st : Station::Iterate()) {
-			if (old_station_industries_nears[i] != st->industries_near) {
-				CCLOG("station industries_near mismatch: st %i, (old size: %u, new size: %u)", (int)st->index, (uint)old_station_industries_nears[i].size(), (uint)st->industries_near.size());
-			}
-			if (!(old_station_catchment_tiles[i] == st->catchment_tiles)) {
-				CCLOG("station catchment_tiles mismatch: st %i", (int)st->index);
-			}
-			if (!(old_station_tiles[i] == st->station_tiles)) {
-				CCLOG("station station_tiles mismatch: st %i, (old: %u, new: %u)", (int)st->index, old_station_tiles[i], st->station_tiles);
-			}
-			i++;
-		}
-		i = 0;
-		for (Industry *ind : Industry::Iterate()) {
-			if (old_industry_stations_nears[i] != ind->stations_near) {
-				CCLOG("industry stations_near mismatch: ind %i, (old size: %u, new size: %u)", (int)ind->index, (uint)old_industry_stations_nears[i].size(), (uint)ind->stations_near.size());
-			}
-			StationList stlist;
-			if (ind->neutral_station != nullptr && !_settings_game.station.serve_neutral_industries) {
-				stlist.insert(ind->neutral_station);
-				if (ind->stations_near != stlist) {
-					CCLOG("industry neutral station stations_near mismatch: ind %i, (recalc size: %u, neutral size: %u)", (int)ind->index, (uint)ind->stations_near.size(), (uint)stlist.size());
-				}
-			} else {
-				ForAllStationsAroundTiles(ind->location, [ind, &stlist](Station *st, TileIndex tile) {
-					if (!IsTileType(tile, MP_INDUSTRY) || GetIndustryIndex(tile) != ind->index) return false;
-					stlist.insert(st);
-					return true;
-				});
-				if (ind->stations_near != stlist) {
-					CCLOG("industry FindStationsAroundTiles mismatch: ind %i, (recalc size: %u, find size: %u)", (int)ind->index, (uint)ind->stations_near.size(), (uint)stlist.size());
-				}
-			}
-			i++;
-		}
-	}
-
-	if (flags & CHECK_CACHE_INFRA_TOTALS) {
-		/* Check company infrastructure cache. */
-		std::vector<CompanyInfrastructure> old_infrastructure;
-		for (const Company *c : Company::Iterate()) old_infrastructure.push_back(c->infrastructure);
-
-		AfterLoadCompanyStats();
-
-		uint i = 0;
-		for (const Company *c : Company::Iterate()) {
-			if (MemCmpT(old_infrastructure.data() + i, &c->infrastructure) != 0) {
-				CCLOG("infrastructure cache mismatch: company %i", (int)c->index);
-				char buffer[4096];
-				old_infrastructure[i].Dump(buffer, lastof(buffer));
-				CCLOG("Previous:");
-				ProcessLineByLine(buffer, [&](const char *line) {
-					CCLOG("  %s", line);
-				});
-				c->infrastructure.Dump(buffer, lastof(buffer));
-				CCLOG("Recalculated:");
-				ProcessLineByLine(buffer, [&](const char *line) {
-					CCLOG("  %s", line);
-				});
-				if (old_infrastructure[i].signal != c->infrastructure.signal && _network_server && !HasChickenBit(DCBF_DESYNC_CHECK_PERIODIC_SIGNALS)) {
-					DoCommandP(0, 0, _settings_game.debug.chicken_bits | (1 << DCBF_DESYNC_CHECK_PERIODIC_SIGNALS), CMD_CHANGE_SETTING, nullptr, "debug.chicken_bits");
-				}
-			}
-			i++;
-		}
+static IncrementalCacheCheckState _incremental_cache_check;
+
+/**
+ * Check the objects of a pool from the given index on, until the time is up.
+ * @param index Pool index of the next object to check, updated on return.
+ * @param time_left Function returning whether there is time left.
+ * @param check Function checking a single object.
+ * @return Whether the end of the pool was reached.
+ */
+template <typename T, typename Ttime, typename Tcheck>
+static bool CheckCachesIncrementalPool(size_t &index, Ttime time_left, Tcheck check)
+{
+	for (; index < T::GetPoolSize(); index++) {
+		if (!time_left()) return false;
+		T *item = T::GetIfValid(index);
+		if (item != nullptr) check(item);
 	}
+	return true;
+}
 
-	if (flags & CHECK_CACHE_GENERAL) {
-		/* Strict checking of the road stop cache entries */
-		for (const RoadStop *rs : RoadStop::Iterate()) {
-			if (IsStandardRoadStopTile(rs->xy)) continue;
+/**
+ * Check the validity of the caches incrementally, using on average at most the given time per tick.
+ * This runs the same checks as #CheckCaches, but spread over many ticks: each tick resumes where the previous one stopped,
+ * checking one object at a time where the check is per object. Parts which can only be checked at once may use more time
+ * than is left, the excess is then made up by skipping the following ticks. A tick ends early when a full round completes.
+ * @param budget_us Time to use per tick, in microseconds.
+ */
+void CheckCachesIncremental(uint budget_us)
+{
+	IncrementalCacheCheckState &state = _incremental_cache_check;
+	if (state.debt_us >= (int64)budget_us) {
+		state.debt_us -= budget_us;
+		return;
+	}
 
-			assert(rs->GetEntry(DIAGDIR_NE) != rs->GetEntry(DIAGDIR_NW));
-			rs->GetEntry(DIAGDIR_NE)->CheckIntegrity(rs);
-			rs->GetEntry(DIAGDIR_NW)->CheckIntegrity(rs);
-		}
+	const int64 available_us = budget_us - state.debt_us;
+	const auto start = std::chrono::steady_clock::now();
+	auto elapsed_us = [&]() -> int64 {
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	};
+	auto time_left = [&]() -> bool {
+		return elapsed_us() < available_us;
+	};
 
-		for (Vehicle *v : Vehicle::Iterate()) {
-			extern bool ValidateVehicleTileHash(const Vehicle *v);
-			if (!ValidateVehicleTileHash(v)) {
-				CCLOG("vehicle tile hash mismatch: type %i, vehicle %i, company %i, unit number %i", (int)v->type, v->index, (int)v->owner, v->unitnumber);
-			}
+	SCOPE_INFO_FMT([&state], "CheckCachesIncremental: part %u, index %u", state.part, (uint)state.index);
 
-			extern void FillNewGRFVehicleCache(const Vehicle *v);
-			if (v != v->First() || v->vehstatus & VS_CRASHED || !v->IsPrimaryVehicle()) continue;
+	CheckCachesLog ccl;
+	while (time_left()) {
+		bool done = true;
+		switch (state.part) {
+			case ICCP_TOWN_STATION_INDUSTRY:
+				CheckTownStationIndustryCaches(ccl);
+				break;
 
-			uint length = 0;
-			for (const Vehicle *u = v; u != nullptr; u = u->Next()) {
-				if (u->IsGroundVehicle() && (HasBit(u->GetGroundVehicleFlags(), GVF_GOINGUP_BIT) || HasBit(u->GetGroundVehicleFlags(), GVF_GOINGDOWN_BIT)) && u->GetGroundVehicleCache()->cached_slope_resistance && HasBit(v->vcache.cached_veh_flags, VCF_GV_ZERO_SLOPE_RESIST)) {
-					CCLOGV("VCF_GV_ZERO_SLOPE_RESIST set incorrectly (1)");
-				}
-				if (u->type == VEH_TRAIN && u->breakdown_ctr != 0 && !HasBit(Train::From(v)->flags, VRF_CONSIST_BREAKDOWN) && (Train::From(u)->IsEngine() || Train::From(u)->IsMultiheaded())) {
-					CCLOGV("VRF_CONSIST_BREAKDOWN incorrectly not set");
-				}
-				if (u->type == VEH_TRAIN && ((Train::From(u)->track & TRACK_BIT_WORMHOLE && !(Train::From(u)->vehstatus & VS_HIDDEN)) || Train::From(u)->track == TRACK_BIT_DEPOT) && !HasBit(Train::From(v)->flags, VRF_CONSIST_SPEED_REDUCTION)) {
-					CCLOGV("VRF_CONSIST_SPEED_REDUCTION incorrectly not set");
-				}
-				length++;
-			}
+			case ICCP_INFRASTRUCTURE:
+				CheckInfrastructureCaches(ccl);
+				break;
 
-			NewGRFCache        *grf_cache = CallocT<NewGRFCache>(length);
-			VehicleCache       *veh_cache = CallocT<VehicleCache>(length);
-			GroundVehicleCache *gro_cache = CallocT<GroundVehicleCache>(length);
-			AircraftCache      *air_cache = CallocT<AircraftCache>(length);
-			TrainCache         *tra_cache = CallocT<TrainCache>(length);
-			Vehicle           **veh_old   = CallocT<Vehicle *>(length);
-
-			length = 0;
-			for (const Vehicle *u = v; u != nullptr; u = u->Next()) {
-				FillNewGRFVehicleCache(u);
-				grf_cache[length] = u->grf_cache;
-				veh_cache[length] = u->vcache;
-				switch (u->type) {
-					case VEH_TRAIN:
-						gro_cache[length] = Train::From(u)->gcache;
-						tra_cache[length] = Train::From(u)->tcache;
-						veh_old[length] = CallocT<Train>(1);
-						memcpy((void *) veh_old[length], (const void *) Train::From(u), sizeof(Train));
-						break;
-					case VEH_ROAD:
-						gro_cache[length] = RoadVehicle::From(u)->gcache;
-						veh_old[length] = CallocT<RoadVehicle>(1);
-						memcpy((void *) veh_old[length], (const void *) RoadVehicle::From(u), sizeof(RoadVehicle));
-						break;
-					case VEH_AIRCRAFT:
-						air_cache[length] = Aircraft::From(u)->acache;
-						veh_old[length] = CallocT<Aircraft>(1);
-						memcpy((void *) veh_old[length], (const void *) Aircraft::From(u), sizeof(Aircraft));
-						break;
-					default:
-						veh_old[length] = CallocT<Vehicle>(1);
-						memcpy((void *) veh_old[length], (const void *) u, sizeof(Vehicle));
-						break;
-				}
-				length++;
-			}
+			case ICCP_ROAD_STOPS:
+				done = CheckCachesIncrementalPool<RoadStop>(state.index, time_left, [](const RoadStop *rs) { CheckRoadStopCaches(rs); });
+				break;
 
-			switch (v->type) {
-				case VEH_TRAIN:    Train::From(v)->ConsistChanged(CCF_TRACK); break;
-				case VEH_ROAD:     RoadVehUpdateCache(RoadVehicle::From(v)); break;
-				case VEH_AIRCRAFT: UpdateAircraftCache(Aircraft::From(v));   break;
-				case VEH_SHIP:     Ship::From(v)->UpdateCache();             break;
-				default: break;
-			}
+			case ICCP_VEHICLES:
+				done = CheckCachesIncrementalPool<Vehicle>(state.index, time_left, [&](Vehicle *v) { CheckVehicleCaches(ccl, v); });
+				break;
 
-			length = 0;
-			for (const Vehicle *u = v; u != nullptr; u = u->Next()) {
-				FillNewGRFVehicleCache(u);
-				if (memcmp(&grf_cache[length], &u->grf_cache, sizeof(NewGRFCache)) != 0) {
-					CCLOGV("newgrf cache mismatch");
-				}
-				if (veh_cache[length].cached_max_speed != u->vcache.cached_max_speed || veh_cache[length].cached_cargo_age_period != u->vcache.cached_cargo_age_period ||
-						veh_cache[length].cached_vis_effect != u->vcache.cached_vis_effect || HasBit(veh_cache[length].cached_veh_flags ^ u->vcache.cached_veh_flags, VCF_LAST_VISUAL_EFFECT)) {
-					CCLOGV("vehicle cache mismatch: %c%c%c%c",
-							veh_cache[length].cached_max_speed != u->vcache.cached_max_speed ? 'm' : '-',
-							veh_cache[length].cached_cargo_age_period != u->vcache.cached_cargo_age_period ? 'c' : '-',
-							veh_cache[length].cached_vis_effect != u->vcache.cached_vis_effect ? 'v' : '-',
-							HasBit(veh_cache[length].cached_veh_flags ^ u->vcache.cached_veh_flags, VCF_LAST_VISUAL_EFFECT) ? 'l' : '-');
-				}
-				if (u->IsGroundVehicle() && (HasBit(u->GetGroundVehicleFlags(), GVF_GOINGUP_BIT) || HasBit(u->GetGroundVehicleFlags(), GVF_GOINGDOWN_BIT)) && u->GetGroundVehicleCache()->cached_slope_resistance && HasBit(v->vcache.cached_veh_flags, VCF_GV_ZERO_SLOPE_RESIST)) {
-					CCLOGV("VCF_GV_ZERO_SLOPE_RESIST set incorrectly (2)");
-				}
-				if (veh_old[length]->acceleration != u->acceleration) {
-					CCLOGV("acceleration mismatch");
-				}
-				if (veh_old[length]->breakdown_chance != u->breakdown_chance) {
-					CCLOGV("breakdown_chance mismatch");
-				}
-				if (veh_old[length]->breakdown_ctr != u->breakdown_ctr) {
-					CCLOGV("breakdown_ctr mismatch");
-				}
-				if (veh_old[length]->breakdown_delay != u->breakdown_delay) {
-					CCLOGV("breakdown_delay mismatch");
-				}
-				if (veh_old[length]->breakdowns_since_last_service != u->breakdowns_since_last_service) {
-					CCLOGV("breakdowns_since_last_service mismatch");
-				}
-				if (veh_old[length]->breakdown_severity != u->breakdown_severity) {
-					CCLOGV("breakdown_severity mismatch");
-				}
-				if (veh_old[length]->breakdown_type != u->breakdown_type) {
-					CCLOGV("breakdown_type mismatch");
-				}
-				if (veh_old[length]->vehicle_flags != u->vehicle_flags) {
-					CCLOGV("vehicle_flags mismatch");
-				}
-				auto print_gv_cache_diff = [&](const char *vtype, const GroundVehicleCache &a, const GroundVehicleCache &b) {
-					CCLOGV("%s ground vehicle cache mismatch: %c%c%c%c%c%c%c%c%c%c",
-							vtype,
-							a.cached_weight != b.cached_weight ? 'w' : '-',
-							a.cached_slope_resistance != b.cached_slope_resistance ? 'r' : '-',
-							a.cached_max_te != b.cached_max_te ? 't' : '-',
-							a.cached_axle_resistance != b.cached_axle_resistance ? 'a' : '-',
-							a.cached_max_track_speed != b.cached_max_track_speed ? 's' : '-',
-							a.cached_power != b.cached_power ? 'p' : '-',
-							a.cached_air_drag != b.cached_air_drag ? 'd' : '-',
-							a.cached_total_length != b.cached_total_length ? 'l' : '-',
-							a.first_engine != b.first_engine ? 'e' : '-',
-							a.cached_veh_length != b.cached_veh_length ? 'L' : '-');
-				};
-				switch (u->type) {
-					case VEH_TRAIN:
-						if (memcmp(&gro_cache[length], &Train::From(u)->gcache, sizeof(GroundVehicleCache)) != 0) {
-							print_gv_cache_diff("train", gro_cache[length], Train::From(u)->gcache);
-						}
-						if (memcmp(&tra_cache[length], &Train::From(u)->tcache, sizeof(TrainCache)) != 0) {
-							CCLOGV("train cache mismatch: %c%c%c%c%c%c%c%c%c%c%c",
-									tra_cache[length].cached_override != Train::From(u)->tcache.cached_override ? 'o' : '-',
-									tra_cache[length].cached_curve_speed_mod != Train::From(u)->tcache.cached_curve_speed_mod ? 'C' : '-',
-									tra_cache[length].cached_tflags != Train::From(u)->tcache.cached_tflags ? 'f' : '-',
-									tra_cache[length].cached_num_engines != Train::From(u)->tcache.cached_num_engines ? 'e' : '-',
-									tra_cache[length].cached_centre_mass != Train::From(u)->tcache.cached_centre_mass ? 'm' : '-',
-									tra_cache[length].cached_braking_length != Train::From(u)->tcache.cached_braking_length ? 'b' : '-',
-									tra_cache[length].cached_veh_weight != Train::From(u)->tcache.cached_veh_weight ? 'w' : '-',
-									tra_cache[length].cached_uncapped_decel != Train::From(u)->tcache.cached_uncapped_decel ? 'D' : '-',
-									tra_cache[length].cached_deceleration != Train::From(u)->tcache.cached_deceleration ? 'd' : '-',
-									tra_cache[length].user_def_data != Train::From(u)->tcache.user_def_data ? 'u' : '-',
-									tra_cache[length].cached_max_curve_speed != Train::From(u)->tcache.cached_max_curve_speed ? 'c' : '-');
-						}
-						if (Train::From(veh_old[length])->railtype != Train::From(u)->railtype) {
-							CCLOGV("railtype mismatch");
-						}
-						if (Train::From(veh_old[length])->compatible_railtypes != Train::From(u)->compatible_railtypes) {
-							CCLOGV("compatible_railtypes mismatch");
-						}
-						if (Train::From(veh_old[length])->flags != Train::From(u)->flags) {
-							CCLOGV("train flags mismatch");
-						}
-						break;
-					case VEH_ROAD:
-						if (memcmp(&gro_cache[length], &RoadVehicle::From(u)->gcache, sizeof(GroundVehicleCache)) != 0) {
-							print_gv_cache_diff("road vehicle", gro_cache[length], Train::From(u)->gcache);
-						}
-						break;
-					case VEH_AIRCRAFT:
-						if (memcmp(&air_cache[length], &Aircraft::From(u)->acache, sizeof(AircraftCache)) != 0) {
-							CCLOGV("Aircraft vehicle cache mismatch: %c%c",
-									air_cache[length].cached_max_range != Aircraft::From(u)->acache.cached_max_range ? 'r' : '-',
-									air_cache[length].cached_max_range_sqr != Aircraft::From(u)->acache.cached_max_range_sqr ? 's' : '-');
-						}
-						break;
-					default:
-						break;
-				}
-				free(veh_old[length]);
-				length++;
-			}
+			case ICCP_VEHICLE_CARGO:
+				done = CheckCachesIncrementalPool<Vehicle>(state.index, time_left, [&](Vehicle *v) { CheckVehicleCargoCaches(ccl, v); });
+				break;
 
-			free(grf_cache);
-			free(veh_cache);
-			free(gro_cache);
-			free(air_cache);
-			free(tra_cache);
-			free(veh_old);
-		}
+			case ICCP_STATIONS:
+				done = CheckCachesIncrementalPool<Station>(state.index, time_left, [&](Station *st) { CheckStationCaches(ccl, st); });
+				break;
 
-		/* Check whether the caches are still valid */
-		for (Vehicle *v : Vehicle::Iterate()) {
-			Money old_feeder_share = v->cargo.FeederShare();
-			uint old_count = v->cargo.TotalCount();
-			uint64 old_cargo_days_in_transit = v->cargo.CargoDaysInTransit();
-
-			v->cargo.InvalidateCache();
-
-			uint changed = 0;
-			if (v->cargo.FeederShare() != old_feeder_share) SetBit(changed, 0);
-			if (v->cargo.TotalCount() != old_count) SetBit(changed, 1);
-			if (v->cargo.CargoDaysInTransit() != old_cargo_days_in_transit) SetBit(changed, 2);
-			if (changed != 0) {
-				CCLOGV1("vehicle cargo cache mismatch: %c%c%c",
-						HasBit(changed, 0) ? 'f' : '-',
-						HasBit(changed, 1) ? 't' : '-',
-						HasBit(changed, 2) ? 'd' : '-');
-			}
-		}
+			case ICCP_ORDER_LISTS:
+				done = CheckCachesIncrementalPool<OrderList>(state.index, time_left, [](OrderList *order_list) { order_list->DebugCheckSanity(); });
+				break;
 
-		for (Station *st : Station::Iterate()) {
-			for (CargoID c = 0; c < NUM_CARGO; c++) {
-				uint old_count = st->goods[c].cargo.TotalCount();
-				uint64 old_cargo_days_in_transit = st->goods[c].cargo.CargoDaysInTransit();
-
-				st->goods[c].cargo.InvalidateCache();
-
-				uint changed = 0;
-				if (st->goods[c].cargo.TotalCount() != old_count) SetBit(changed, 0);
-				if (st->goods[c].cargo.CargoDaysInTransit() != old_cargo_days_in_transit) SetBit(changed, 1);
-				if (changed != 0) {
-					CCLOG("station cargo cache mismatch: station %i, company %i, cargo %u: %c%c",
-							st->index, (int)st->owner, c,
-							HasBit(changed, 0) ? 't' : '-',
-							HasBit(changed, 1) ? 'd' : '-');
-				}
-			}
+			case ICCP_OTHER:
+				CheckOtherCaches(ccl);
+				break;
 
-			/* Check docking tiles */
-			TileArea ta;
-			std::map<TileIndex, bool> docking_tiles;
-			for (TileIndex tile : st->docking_station) {
-				ta.Add(tile);
-				docking_tiles[tile] = IsDockingTile(tile);
-			}
-			UpdateStationDockingTiles(st);
-			if (ta.tile != st->docking_station.tile || ta.w != st->docking_station.w || ta.h != st->docking_station.h) {
-				CCLOG("station docking mismatch: station %i, company %i, prev: (%X, %u, %u), recalc: (%X, %u, %u)",
-						st->index, (int)st->owner, ta.tile, ta.w, ta.h, st->docking_station.tile, st->docking_station.w, st->docking_station.h);
-			}
-			for (TileIndex tile : ta) {
-				if (docking_tiles[tile] != IsDockingTile(tile)) {
-					CCLOG("docking tile mismatch: tile %i", (int)tile);
-				}
-			}
+			default:
+				NOT_REACHED();
 		}
+		if (!done) break;
 
-		for (OrderList *order_list : OrderList::Iterate()) {
-			order_list->DebugCheckSanity();
+		state.index = 0;
+		state.part = (IncrementalCacheCheckPart)(state.part + 1);
+		if (state.part == ICCP_END) {
+			state.part = ICCP_TOWN_STATION_INDUSTRY;
+			break;
 		}
+	}
 
-		extern void ValidateVehicleTickCaches();
-		ValidateVehicleTickCaches();
-
-		for (Vehicle *v : Vehicle::Iterate()) {
-			if (v->Previous()) assert_msg(v->Previous()->Next() == v, "%u", v->index);
-			if (v->Next()) assert_msg(v->Next()->Previous() == v, "%u", v->index);
-		}
-		for (const TemplateVehicle *tv : TemplateVehicle::Iterate()) {
-			if (tv->Prev()) assert_msg(tv->Prev()->Next() == tv, "%u", tv->index);
-			if (tv->Next()) assert_msg(tv->Next()->Prev() == tv, "%u", tv->index);
-		}
+	state.debt_us = std::max<int64>(0, elapsed_us() - available_us);
+}
 
-		{
-			extern std::string ValidateTemplateReplacementCaches();
-			std::string template_validation_result = ValidateTemplateReplacementCaches();
-			if (!template_validation_result.empty()) {
-				CCLOG("Template replacement cache validation failed: %s", template_validation_result.c_str());
-			}
-		}
+#undef CCLOG
+#undef CCLOGV
+#undef CCLOGV1
 
-		if (!TraceRestrictSlot::ValidateVehicleIndex()) CCLOG("Trace restrict slot vehicle index validation failed");
-		TraceRestrictSlot::ValidateSlotOccupants(log);
+/** Number of map rows covered by each detailed map checksum in LogStateSubsystemChecksums. */
+static const uint STATE_CHECKSUM_MAP_ROWS = 64;
+/** Number of vehicle pool indices covered by each detailed vehicle checksum in LogStateSubsystemChecksums. */
+static const uint STATE_CHECKSUM_VEHICLE_RANGE = 1024;
 
-		if (!CargoPacket::ValidateDeferredCargoPayments()) CCLOG("Cargo packets deferred payments validation failed");
+/**
+ * Output checksums of the main subsystems of the game state.
+ * Comparing the output of the server and a desynced client (or of an original game and a replay)
+ * names the divergent subsystem, and with detail also the divergent map rows or vehicle index range.
+ * @param log Function to output each line to.
+ * @param detail Whether to also output the checksums of the map row and vehicle index ranges.
+ */
+void LogStateSubsystemChecksums(std::function<void(const char *)> log, bool detail)
+{
+	char buffer[256];
+	auto output = [&](const char *name, uint64 checksum) {
+		seprintf(buffer, lastof(buffer), "state_csum: %s: " OTTD_PRINTFHEX64PAD, name, checksum);
+		log(buffer);
+	};
 
-		if (_order_destination_refcount_map_valid) {
-			btree::btree_map<uint32, uint32> saved_order_destination_refcount_map = std::move(_order_destination_refcount_map);
-			for (auto iter = saved_order_destination_refcount_map.begin(); iter != saved_order_destination_refcount_map.end();) {
-				if (iter->second == 0) {
-					iter = saved_order_destination_refcount_map.erase(iter);
-				} else {
-					++iter;
-				}
+	SimpleChecksum64 map_checksum;
+	SimpleChecksum64 rows_checksum;
+	for (uint y = 0; y < MapSizeY(); y++) {
+		const TileIndex row_start = TileXY(0, y);
+		for (TileIndex t = row_start; t < row_start + MapSizeX(); t++) {
+			uint64 tile_data;
+			memcpy(&tile_data, &_m[t], sizeof(tile_data));
+			rows_checksum.Update(tile_data);
+			uint32 extended_data;
+			memcpy(&extended_data, &_me[t], sizeof(extended_data));
+			rows_checksum.Update(extended_data);
+		}
+		if ((y + 1) % STATE_CHECKSUM_MAP_ROWS == 0 || y + 1 == MapSizeY()) {
+			map_checksum.Update(rows_checksum.state);
+			if (detail) {
+				char name[64];
+				seprintf(name, lastof(name), "map rows %u-%u", y - (y % STATE_CHECKSUM_MAP_ROWS), y);
+				output(name, rows_checksum.state);
 			}
-			IntialiseOrderDestinationRefcountMap();
-			if (saved_order_destination_refcount_map != _order_destination_refcount_map) CCLOG("Order destination refcount map mismatch");
-		} else {
-			CCLOG("Order destination refcount map not valid");
+			rows_checksum = {};
 		}
 	}
-
-	if ((flags & CHECK_CACHE_EMIT_LOG) && !saved_messages.empty()) {
-		InconsistencyExtraInfo info;
-		info.check_caches_result = std::move(saved_messages);
-		CrashLog::InconsistencyLog(info);
-		for (std::string &str : info.check_caches_result) {
-			LogDesyncMsg(std::move(str));
+	output("map", map_checksum.state);
+
+	SimpleChecksum64 vehicles_checksum;
+	SimpleChecksum64 range_checksum;
+	uint range_start = 0;
+	auto flush_vehicle_range = [&]() {
+		vehicles_checksum.Update(range_checksum.state);
+		if (detail) {
+			char name[64];
+			seprintf(name, lastof(name), "vehicles %u-%u", range_start, range_start + STATE_CHECKSUM_VEHICLE_RANGE - 1);
+			output(name, range_checksum.state);
+		}
+		range_checksum = {};
+	};
+	for (const Vehicle *v : Vehicle::Iterate()) {
+		while (v->index >= range_start + STATE_CHECKSUM_VEHICLE_RANGE) {
+			flush_vehicle_range();
+			range_start += STATE_CHECKSUM_VEHICLE_RANGE;
+		}
+		range_checksum.Update(v->index | ((uint64)v->type << 32) | ((uint64)v->direction << 40) | ((uint64)v->vehstatus << 48));
+		range_checksum.Update(v->tile | ((uint64)v->cur_speed << 32) | ((uint64)v->subspeed << 48) | ((uint64)v->progress << 56));
+		range_checksum.Update((uint32)v->x_pos | ((uint64)(uint32)v->y_pos << 32));
+		range_checksum.Update((uint32)v->z_pos | ((uint64)v->cur_real_order_index << 32) | ((uint64)v->cargo.StoredCount() << 40));
+		range_checksum.Update((int64)v->profit_this_year);
+	}
+	flush_vehicle_range();
+	output("vehicles", vehicles_checksum.state);
+
+	SimpleChecksum64 stations_checksum;
+	for (const Station *st : Station::Iterate()) {
+		stations_checksum.Update(st->index | ((uint64)st->xy << 32));
+		stations_checksum.Update(st->facilities);
+		for (const GoodsEntry &ge : st->goods) {
+			stations_checksum.Update(ge.status | ((uint64)ge.rating << 8) | ((uint64)ge.cargo.TotalCount() << 32));
 		}
 	}
+	output("stations", stations_checksum.state);
 
-#undef CCLOG
-#undef CCLOGV
-#undef CCLOGV1
+	SimpleChecksum64 companies_checksum;
+	for (const Company *c : Company::Iterate()) {
+		companies_checksum.Update(c->index);
+		companies_checksum.Update((int64)c->money);
+		companies_checksum.Update((int64)c->current_loan);
+	}
+	output("companies", companies_checksum.state);
+
+	SimpleChecksum64 towns_checksum;
+	for (const Town *t : Town::Iterate()) {
+		towns_checksum.Update(t->index | ((uint64)t->xy << 32));
+		towns_checksum.Update(t->cache.population | ((uint64)t->grow_counter << 32));
+	}
+	output("towns", towns_checksum.state);
+
+	SimpleChecksum64 industries_checksum;
+	for (const Industry *i : Industry::Iterate()) {
+		industries_checksum.Update(i->index | ((uint64)i->location.tile << 32));
+		for (uint j = 0; j < lengthof(i->produced_cargo_waiting); j++) {
+			industries_checksum.Update(i->produced_cargo_waiting[j] | ((uint64)i->production_rate[j] << 32));
+		}
+	}
+	output("industries", industries_checksum.state);
 }
 
 /**
@@ -1988,6 +2334,15 @@ void StateGameLoop()
 		PerformanceMeasurer::Paused(PFE_GL_SHIPS);
 		PerformanceMeasurer::Paused(PFE_GL_AIRCRAFT);
 		PerformanceMeasurer::Paused(PFE_GL_LANDSCAPE);
+		PerformanceMeasurer::Paused(PFE_GL_TRAIN_PF);
+		PerformanceMeasurer::Paused(PFE_GL_SIGNALS);
+		PerformanceMeasurer::Paused(PFE_GL_ROADVEH_PF);
+		PerformanceMeasurer::Paused(PFE_GL_SHIP_PF);
+		PerformanceMeasurer::Paused(PFE_GL_TILELOOP);
+		PerformanceMeasurer::Paused(PFE_GL_ANIMATION);
+		PerformanceMeasurer::Paused(PFE_GL_TOWNS);
+		PerformanceMeasurer::Paused(PFE_GL_INDUSTRIES);
+		PerformanceMeasurer::Paused(PFE_GL_STATIONS);
 
 		if (!HasModalProgress()) UpdateLandscapingLimits();
 #ifndef DEBUG_DUMP_COMMANDS
@@ -1998,6 +2353,16 @@ void StateGameLoop()
 
 	PerformanceMeasurer framerate(PFE_GAMELOOP);
 	PerformanceAccumulator::Reset(PFE_GL_LANDSCAPE);
+	PerformanceAccumulator::Reset(PFE_GL_TRAIN_PF);
+	PerformanceAccumulator::Reset(PFE_GL_SIGNALS);
+	PerformanceAccumulator::Reset(PFE_GL_ROADVEH_PF);
+	PerformanceAccumulator::Reset(PFE_GL_SHIP_PF);
+	PerformanceAccumulator::Reset(PFE_GL_TILELOOP);
+	PerformanceAccumulator::Reset(PFE_GL_ANIMATION);
+	PerformanceAccumulator::Reset(PFE_GL_TOWNS);
+	PerformanceAccumulator::Reset(PFE_GL_INDUSTRIES);
+	PerformanceAccumulator::Reset(PFE_GL_STATIONS);
+	TRACE_SCOPE("StateGameLoop");
 
 	Layouter::ReduceLineCache();
 
@@ -2021,6 +2386,7 @@ void StateGameLoop()
 		}
 
 		CheckCaches(false, nullptr, CHECK_CACHE_ALL | CHECK_CACHE_EMIT_LOG);
+		if (_settings_client.perf.incremental_cache_check_budget != 0) CheckCachesIncremental(_settings_client.perf.incremental_cache_check_budget);
 
 		/* All these actions has to be done from OWNER_NONE
 		 *  for multiplayer compatibility */
@@ -2114,6 +2480,7 @@ FiosNumberedSaveName &GetAutoSaveFiosNumberedSaveName()
  */
 static void DoAutosave()
 {
+	LatencyMeasurer latency(LHT_AUTOSAVE);
 	DoAutoOrNetsave(GetAutoSaveFiosNumberedSaveName(), true);
 }
 
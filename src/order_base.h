@@ -150,6 +150,12 @@ public:
 		return this->extra->xdata;
 	}
 
+	/** Check whether extra order info is allocated for this order. */
+	inline bool HasExtraInfo() const
+	{
+		return this->extra != nullptr;
+	}
+
 	Order *next;          ///< Pointer to next order. If nullptr, end of list
 
 	Order() : flags(0), refit_cargo(CT_NO_REFIT), max_speed(UINT16_MAX) {}
@@ -704,6 +710,12 @@ private:
 
 	std::string name;                                                   ///< Name of dispatch schedule
 
+	mutable uint32 slot_lookup_offset = UINT32_MAX;                     ///< Offset of the last slot lookup, UINT32_MAX if none
+	mutable uint32 slot_lookup_index = 0;                               ///< Index of the first slot at or after #slot_lookup_offset
+
+	/** Forget the cached slot lookup, after the slots or the duration changed. */
+	inline void InvalidateSlotLookup() { this->slot_lookup_offset = UINT32_MAX; }
+
 	inline void CopyBasicFields(const DispatchSchedule &other)
 	{
 		this->scheduled_dispatch_duration              = other.scheduled_dispatch_duration;
@@ -724,15 +736,20 @@ public:
 	void AddScheduledDispatch(uint32 offset);
 	void RemoveScheduledDispatch(uint32 offset);
 	void AdjustScheduledDispatch(int32 adjust);
-	void ClearScheduledDispatch() { this->scheduled_dispatch.clear(); }
+	void ClearScheduledDispatch() { this->scheduled_dispatch.clear(); this->InvalidateSlotLookup(); }
 	bool UpdateScheduledDispatchToDate(DateTicksScaled now);
 	void UpdateScheduledDispatch(const Vehicle *v);
+	DateTicksScaled GetScheduledDispatchSlotAtOrAfter(DateTicksScaled time) const;
 
 	/**
 	 * Set the scheduled dispatch duration, in scaled tick
 	 * @param  duration  New duration
 	 */
-	inline void SetScheduledDispatchDuration(uint32 duration) { this->scheduled_dispatch_duration = duration; }
+	inline void SetScheduledDispatchDuration(uint32 duration)
+	{
+		this->scheduled_dispatch_duration = duration;
+		this->InvalidateSlotLookup();
+	}
 
 	/**
 	 * Get the scheduled dispatch duration, in scaled tick
@@ -803,11 +820,13 @@ public:
 	{
 		this->CopyBasicFields(other);
 		this->scheduled_dispatch = std::move(other.scheduled_dispatch);
+		this->InvalidateSlotLookup();
 	}
 
 	inline void ReturnSchedule(DispatchSchedule &other)
 	{
 		other.scheduled_dispatch = std::move(this->scheduled_dispatch);
+		other.InvalidateSlotLookup();
 	}
 
 	inline std::string &ScheduleName() { return this->name; }
@@ -826,7 +845,6 @@ private:
 	friend void Ptrs_ORDL(); ///< Saving and loading of order lists.
 
 	void ReindexOrderList();
-	Order *GetOrderAtFromList(int index) const;
 
 	Order *first;                     ///< First order of the order list.
 	std::vector<Order *> order_index; ///< NOSAVE: Vector index of order list.
@@ -889,6 +907,17 @@ public:
 	 */
 	inline VehicleOrderID GetNumOrders() const { return static_cast<VehicleOrderID>(this->order_index.size()); }
 
+	/**
+	 * Get the number of bytes allocated by this order list outside of itself, excluding the orders.
+	 * @return Size of the order index and the scheduled dispatch schedules.
+	 */
+	inline size_t GetMemoryUsage() const
+	{
+		size_t bytes = this->order_index.capacity() * sizeof(Order *) + this->dispatch_schedules.capacity() * sizeof(DispatchSchedule);
+		for (const DispatchSchedule &ds : this->dispatch_schedules) bytes += ds.GetScheduledDispatch().capacity() * sizeof(uint32);
+		return bytes;
+	}
+
 	/**
 	 * Get number of manually added orders in the order list.
 	 * @return number of manual orders in the chain.
@@ -545,18 +545,6 @@ Order *OrderList::GetOrderAt(int index) const
 	return this->order_index[index];
 }
 
-Order *OrderList::GetOrderAtFromList(int index) const
-{
-	if (index < 0) return nullptr;
-
-	Order *order = this->first;
-
-	while (order != nullptr && index-- > 0) {
-		order = order->next;
-	}
-	return order;
-}
-
 /**
  * Get the index of an order of the order chain, or INVALID_VEH_ORDER_ID.
  * @param order order to get the index of.
@@ -738,7 +726,7 @@ void OrderList::InsertOrderAt(Order *new_order, int index)
 		this->total_duration += new_order->GetWaitTime() + new_order->GetTravelTime();
 	}
 	RegisterOrderDestination(new_order, this->GetFirstSharedVehicle()->type, this->GetFirstSharedVehicle()->owner);
-	this->ReindexOrderList();
+	this->order_index.insert(this->order_index.begin() + std::min<int>(index, (int)this->order_index.size()), new_order);
 
 	/* We can visit oil rigs and buoys that are not our own. They will be shown in
 	 * the list of stations. So, we need to invalidate that window if needed. */
@@ -775,7 +763,7 @@ void OrderList::DeleteOrderAt(int index)
 	}
 	UnregisterOrderDestination(to_remove, this->GetFirstSharedVehicle()->type, this->GetFirstSharedVehicle()->owner);
 	delete to_remove;
-	this->ReindexOrderList();
+	this->order_index.erase(this->order_index.begin() + index);
 }
 
 /**
@@ -794,21 +782,27 @@ void OrderList::MoveOrder(int from, int to)
 		moving_one = this->first;
 		this->first = moving_one->next;
 	} else {
-		Order *one_before = GetOrderAtFromList(from - 1);
+		Order *one_before = this->order_index[from - 1];
 		moving_one = one_before->next;
 		one_before->next = moving_one->next;
 	}
 
+	/* Move the order within the index, the orders before the target position are then in their final place */
+	if (from < to) {
+		std::rotate(this->order_index.begin() + from, this->order_index.begin() + from + 1, this->order_index.begin() + to + 1);
+	} else {
+		std::rotate(this->order_index.begin() + to, this->order_index.begin() + from, this->order_index.begin() + from + 1);
+	}
+
 	/* Insert the moving_order again in the pointer-chain */
 	if (to == 0) {
 		moving_one->next = this->first;
 		this->first = moving_one;
 	} else {
-		Order *one_before = GetOrderAtFromList(to - 1);
+		Order *one_before = this->order_index[to - 1];
 		moving_one->next = one_before->next;
 		one_before->next = moving_one;
 	}
-	this->ReindexOrderList();
 }
 
 /**
@@ -3070,16 +3064,70 @@ static btree::btree_map<TraceRestrictCounterID, int32> _pco_deferred_counter_val
 static btree::btree_map<Order *, int8> _pco_deferred_original_percent_cond;
 
 /**
- * Process a conditional order and determine the next order.
- * @param order the order the vehicle currently has
- * @param v the vehicle to update
- * @param mode whether this is a dry-run so do not execute side-effects, or if side-effects are deferred
- * @return index of next order to jump to, or INVALID_VEH_ORDER_ID to use the next order
+ * Results of conditional orders per vehicle and order, while the cache is active.
+ * The game time does not change while the cache is active, changes of the other state the cached
+ * conditions depend on invalidate the cache, see #InvalidateConditionalOrderCache.
  */
-VehicleOrderID ProcessConditionalOrder(const Order *order, const Vehicle *v, ProcessConditionalOrderMode mode)
+static btree::btree_map<std::pair<VehicleID, const Order *>, bool> _conditional_order_cache;
+static bool _conditional_order_cache_active = false;
+
+/**
+ * Enable or disable caching the results of conditional orders.
+ * The cache must only be active while the game time does not change, and is cleared when it is disabled.
+ * @param active whether to cache the results
+ */
+void SetConditionalOrderCacheActive(bool active)
 {
-	if (order->GetType() != OT_CONDITIONAL) return INVALID_VEH_ORDER_ID;
+	_conditional_order_cache_active = active;
+	_conditional_order_cache.clear();
+}
+
+/**
+ * Forget all cached results of conditional orders.
+ * Call this when a slot, counter, the cargo of a vehicle or the last dispatch of a dispatch schedule changes.
+ */
+void InvalidateConditionalOrderCache()
+{
+	if (!_conditional_order_cache.empty()) _conditional_order_cache.clear();
+}
+
+/**
+ * Check whether the result of a conditional order may be cached.
+ * @param order the conditional order
+ * @param mode the mode the order is processed in
+ * @return true if the condition has no side effects, and only depends on the time and state which invalidates the cache
+ */
+static bool IsConditionalOrderCacheable(const Order *order, ProcessConditionalOrderMode mode)
+{
+	/* Deferred processing evaluates against the pending slot and counter changes. */
+	if (mode == PCO_DEFERRED) return false;
 
+	switch (order->GetConditionVariable()) {
+		case OCV_LOAD_PERCENTAGE:
+		case OCV_CARGO_LOAD_PERCENTAGE:
+		case OCV_SLOT_OCCUPANCY:
+		case OCV_COUNTER_VALUE:
+		case OCV_DISPATCH_SLOT:
+			return true;
+
+		case OCV_VEH_IN_SLOT:
+			/* Testing for (in)equality tries to occupy the slot. */
+			return order->GetConditionComparator() != OCC_EQUALS && order->GetConditionComparator() != OCC_NOT_EQUALS;
+
+		default:
+			return false;
+	}
+}
+
+/**
+ * Evaluate the condition of a conditional order.
+ * @param order the conditional order
+ * @param v the vehicle to evaluate the condition for
+ * @param mode whether this is a dry-run so do not execute side-effects, or if side-effects are deferred
+ * @return whether to jump to the order to skip to
+ */
+static bool EvaluateConditionalOrder(const Order *order, const Vehicle *v, ProcessConditionalOrderMode mode)
+{
 	bool skip_order = false;
 	OrderConditionComparator occ = order->GetConditionComparator();
 	uint16 value = order->GetConditionValue();
@@ -3222,6 +3270,29 @@ VehicleOrderID ProcessConditionalOrder(const Order *order, const Vehicle *v, Pro
 		default: NOT_REACHED();
 	}
 
+	return skip_order;
+}
+
+/**
+ * Process a conditional order and determine the next order.
+ * @param order the order the vehicle currently has
+ * @param v the vehicle to update
+ * @param mode whether this is a dry-run so do not execute side-effects, or if side-effects are deferred
+ * @return index of next order to jump to, or INVALID_VEH_ORDER_ID to use the next order
+ */
+VehicleOrderID ProcessConditionalOrder(const Order *order, const Vehicle *v, ProcessConditionalOrderMode mode)
+{
+	if (order->GetType() != OT_CONDITIONAL) return INVALID_VEH_ORDER_ID;
+
+	bool skip_order;
+	if (_conditional_order_cache_active && IsConditionalOrderCacheable(order, mode)) {
+		auto result = _conditional_order_cache.insert({ { v->index, order }, false });
+		if (result.second) result.first->second = EvaluateConditionalOrder(order, v, mode);
+		skip_order = result.first->second;
+	} else {
+		skip_order = EvaluateConditionalOrder(order, v, mode);
+	}
+
 	return skip_order ? order->GetConditionSkipToOrder() : (VehicleOrderID)INVALID_VEH_ORDER_ID;
 }
 
@@ -29,6 +29,8 @@ enum ProcessConditionalOrderMode {
 };
 
 VehicleOrderID ProcessConditionalOrder(const Order *order, const Vehicle *v, ProcessConditionalOrderMode mode = PCO_EXEC);
+void SetConditionalOrderCacheActive(bool active);
+void InvalidateConditionalOrderCache();
 VehicleOrderID AdvanceOrderIndexDeferred(const Vehicle *v, VehicleOrderID index);
 void FlushAdvanceOrderIndexDeferred(const Vehicle *v, bool apply);
 uint GetOrderDistance(const Order *prev, const Order *cur, const Vehicle *v, int conditional_depth = 0);
@@ -0,0 +1,313 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file water_regions.cpp Handles dividing the water in the map into square regions to assist pathfinding. */
+
+#include "../stdafx.h"
+#include "../map_func.h"
+#include "../tile_cmd.h"
+#include "../tunnelbridge_map.h"
+#include "../ship.h"
+#include "follow_track.hpp"
+#include "water_regions.h"
+
+#include <array>
+#include <memory>
+
+#include "../safeguards.h"
+
+/**
+ * Represents a square section of the map of a fixed size. Within this square individual unconnected patches of water are
+ * identified using a Connected Component Labeling (CCL) algorithm. Information about whether or not an edge of the square
+ * can be traversed (i.e. whether there is a water tile on that edge which connects to the neighbouring region) is also stored.
+ * The data is calculated lazily when it is first needed, and discarded when any tile within or next to the region changes.
+ */
+class WaterRegion {
+	friend void CheckWaterRegionCaches(std::function<void(const char *)> log);
+
+	std::unique_ptr<WaterRegionPatchLabel[]> tile_patch_labels; ///< Patch label of each tile, nullptr if there are no patches.
+	std::array<uint16, DIAGDIR_END> edge_traversability_bits{}; ///< Bit i is set if tile i along the edge on that side leads into the neighbouring region.
+	bool initialized = false;                                   ///< Whether the data of this region is up to date.
+	bool has_cross_region_aqueducts = false;                    ///< Whether an aqueduct leads out of this region.
+	WaterRegionPatchLabel number_of_patches = 0;                ///< Number of patches within this region.
+
+	/**
+	 * Get the index of a tile within its region.
+	 * @param tile Tile to get the index of.
+	 * @return Index within the region.
+	 */
+	static inline uint GetLocalIndex(TileIndex tile)
+	{
+		return (TileX(tile) % WATER_REGION_EDGE_LENGTH) + WATER_REGION_EDGE_LENGTH * (TileY(tile) % WATER_REGION_EDGE_LENGTH);
+	}
+
+	/**
+	 * Check whether a tile is within the same region as a tile of the region.
+	 * @param region_tile A tile within the region.
+	 * @param tile Tile to check.
+	 * @return True if the tile is inside the region.
+	 */
+	static inline bool IsSameRegion(TileIndex region_tile, TileIndex tile)
+	{
+		return TileX(region_tile) / WATER_REGION_EDGE_LENGTH == TileX(tile) / WATER_REGION_EDGE_LENGTH &&
+				TileY(region_tile) / WATER_REGION_EDGE_LENGTH == TileY(tile) / WATER_REGION_EDGE_LENGTH;
+	}
+
+public:
+	/**
+	 * Get the patch label of a tile within this region.
+	 * @param tile Tile within this region.
+	 * @return Patch label, INVALID_WATER_REGION_PATCH if the tile is not part of any patch.
+	 */
+	WaterRegionPatchLabel GetLabel(TileIndex tile) const
+	{
+		dbg_assert(this->initialized);
+		if (this->tile_patch_labels == nullptr) return INVALID_WATER_REGION_PATCH;
+		return this->tile_patch_labels[GetLocalIndex(tile)];
+	}
+
+	uint16 GetEdgeTraversabilityBits(DiagDirection side) const { return this->edge_traversability_bits[side]; }
+	bool HasCrossRegionAqueducts() const { return this->has_cross_region_aqueducts; }
+	bool IsInitialized() const { return this->initialized; }
+
+	void Invalidate()
+	{
+		this->initialized = false;
+	}
+
+	void Update(uint region_x, uint region_y);
+};
+
+static std::vector<WaterRegion> _water_regions;
+
+static inline uint GetWaterRegionMapSizeX() { return MapSizeX() / WATER_REGION_EDGE_LENGTH; }
+static inline uint GetWaterRegionMapSizeY() { return MapSizeY() / WATER_REGION_EDGE_LENGTH; }
+
+static inline uint GetWaterRegionIndex(uint region_x, uint region_y)
+{
+	return region_x + region_y * GetWaterRegionMapSizeX();
+}
+
+static inline uint GetWaterRegionIndex(TileIndex tile)
+{
+	return GetWaterRegionIndex(TileX(tile) / WATER_REGION_EDGE_LENGTH, TileY(tile) / WATER_REGION_EDGE_LENGTH);
+}
+
+/**
+ * Get the tile along one edge of a region.
+ * @param region_x X coordinate of the region.
+ * @param region_y Y coordinate of the region.
+ * @param side Side of the region.
+ * @param i Index along the edge.
+ * @return Tile on the edge.
+ */
+static TileIndex GetEdgeTile(uint region_x, uint region_y, DiagDirection side, uint i)
+{
+	const uint x = region_x * WATER_REGION_EDGE_LENGTH;
+	const uint y = region_y * WATER_REGION_EDGE_LENGTH;
+	switch (side) {
+		case DIAGDIR_NE: return TileXY(x, y + i);
+		case DIAGDIR_SE: return TileXY(x + i, y + WATER_REGION_EDGE_LENGTH - 1);
+		case DIAGDIR_SW: return TileXY(x + WATER_REGION_EDGE_LENGTH - 1, y + i);
+		case DIAGDIR_NW: return TileXY(x + i, y);
+		default: NOT_REACHED();
+	}
+}
+
+/**
+ * Recalculate the patches and edge traversability of this region.
+ * Connectivity is determined using the same track follower as the ship pathfinder.
+ * @param region_x X coordinate of the region.
+ * @param region_y Y coordinate of the region.
+ */
+void WaterRegion::Update(uint region_x, uint region_y)
+{
+	this->initialized = true;
+	this->has_cross_region_aqueducts = false;
+	this->number_of_patches = 0;
+	this->edge_traversability_bits.fill(0);
+	this->tile_patch_labels.reset();
+
+	const TileIndex origin = TileXY(region_x * WATER_REGION_EDGE_LENGTH, region_y * WATER_REGION_EDGE_LENGTH);
+	std::array<WaterRegionPatchLabel, WATER_REGION_NUMBER_OF_TILES> labels{};
+	std::vector<TileIndex> tiles_to_check;
+
+	for (uint local = 0; local < WATER_REGION_NUMBER_OF_TILES; local++) {
+		const TileIndex start_tile = TileXY(TileX(origin) + local % WATER_REGION_EDGE_LENGTH, TileY(origin) + local / WATER_REGION_EDGE_LENGTH);
+		if (labels[local] != INVALID_WATER_REGION_PATCH) continue;
+		if (TrackStatusToTrackdirBits(GetTileTrackStatus(start_tile, TRANSPORT_WATER, 0)) == TRACKDIR_BIT_NONE) continue;
+
+		/* There can't be more patches than half the tiles in a region, so this can't overflow */
+		const WaterRegionPatchLabel label = ++this->number_of_patches;
+		labels[local] = label;
+		tiles_to_check.push_back(start_tile);
+
+		while (!tiles_to_check.empty()) {
+			const TileIndex tile = tiles_to_check.back();
+			tiles_to_check.pop_back();
+
+			for (Trackdir dir : SetBitIterator<Trackdir, TrackdirBits>(TrackStatusToTrackdirBits(GetTileTrackStatus(tile, TRANSPORT_WATER, 0)))) {
+				CFollowTrackWater ft;
+				if (!ft.Follow(tile, dir)) continue;
+
+				if (IsSameRegion(origin, ft.m_new_tile)) {
+					WaterRegionPatchLabel &new_label = labels[GetLocalIndex(ft.m_new_tile)];
+					if (new_label == INVALID_WATER_REGION_PATCH) {
+						new_label = label;
+						tiles_to_check.push_back(ft.m_new_tile);
+					}
+				} else if (!ft.m_is_bridge) {
+					const DiagDirection side = TrackdirToExitdir(dir);
+					const uint index = DiagDirToAxis(side) == AXIS_X ? TileY(tile) % WATER_REGION_EDGE_LENGTH : TileX(tile) % WATER_REGION_EDGE_LENGTH;
+					SetBit(this->edge_traversability_bits[side], index);
+				} else {
+					this->has_cross_region_aqueducts = true;
+				}
+			}
+		}
+	}
+
+	if (this->number_of_patches > 0) {
+		this->tile_patch_labels.reset(new WaterRegionPatchLabel[WATER_REGION_NUMBER_OF_TILES]);
+		std::copy(labels.begin(), labels.end(), this->tile_patch_labels.get());
+	}
+}
+
+/**
+ * Get the water region containing a tile, updating it if necessary.
+ * @param region_x X coordinate of the region.
+ * @param region_y Y coordinate of the region.
+ * @return Up to date water region.
+ */
+static WaterRegion &GetUpdatedWaterRegion(uint region_x, uint region_y)
+{
+	WaterRegion &region = _water_regions[GetWaterRegionIndex(region_x, region_y)];
+	if (!region.IsInitialized()) region.Update(region_x, region_y);
+	return region;
+}
+
+/**
+ * Get the water region patch of a tile.
+ * @param tile Tile to get the patch of.
+ * @return Patch description, the label is INVALID_WATER_REGION_PATCH if the tile is not traversable by ships.
+ */
+WaterRegionPatchDesc GetWaterRegionPatchInfo(TileIndex tile)
+{
+	const uint region_x = TileX(tile) / WATER_REGION_EDGE_LENGTH;
+	const uint region_y = TileY(tile) / WATER_REGION_EDGE_LENGTH;
+	return { region_x, region_y, GetUpdatedWaterRegion(region_x, region_y).GetLabel(tile) };
+}
+
+/**
+ * Call a function for each water region patch which can be reached directly from the given patch.
+ * Each neighbouring patch is only visited once. Patches are visited in a deterministic order.
+ * @param patch Water region patch to visit the neighbours of.
+ * @param callback Function to call for each neighbour.
+ */
+void VisitWaterRegionPatchNeighbours(const WaterRegionPatchDesc &patch, const VisitWaterRegionPatchCallback &callback)
+{
+	const WaterRegion &region = GetUpdatedWaterRegion(patch.x, patch.y);
+
+	for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
+		uint16 edge_bits = region.GetEdgeTraversabilityBits(side);
+		if (edge_bits == 0) continue;
+
+		const TileIndexDiffC offset = TileIndexDiffCByDiagDir(side);
+		const int nx = (int)patch.x + offset.x;
+		const int ny = (int)patch.y + offset.y;
+		if (nx < 0 || ny < 0 || nx >= (int)GetWaterRegionMapSizeX() || ny >= (int)GetWaterRegionMapSizeY()) continue;
+
+		const WaterRegion &neighbour = GetUpdatedWaterRegion(nx, ny);
+		uint64 seen[4] = {};
+		for (uint i : SetBitIterator<uint>(edge_bits)) {
+			const TileIndex tile = GetEdgeTile(patch.x, patch.y, side, i);
+			if (region.GetLabel(tile) != patch.label) continue;
+
+			const WaterRegionPatchLabel label = neighbour.GetLabel(GetEdgeTile(nx, ny, ReverseDiagDir(side), i));
+			if (label == INVALID_WATER_REGION_PATCH || HasBit(seen[label / 64], label % 64)) continue;
+			SetBit(seen[label / 64], label % 64);
+			callback({ (uint)nx, (uint)ny, label });
+		}
+	}
+
+	if (region.HasCrossRegionAqueducts()) {
+		const TileIndex origin = TileXY(patch.x * WATER_REGION_EDGE_LENGTH, patch.y * WATER_REGION_EDGE_LENGTH);
+		for (uint local = 0; local < WATER_REGION_NUMBER_OF_TILES; local++) {
+			const TileIndex tile = TileXY(TileX(origin) + local % WATER_REGION_EDGE_LENGTH, TileY(origin) + local / WATER_REGION_EDGE_LENGTH);
+			if (!IsBridgeTile(tile) || GetTunnelBridgeTransportType(tile) != TRANSPORT_WATER || region.GetLabel(tile) != patch.label) continue;
+
+			const TileIndex other_end = GetOtherBridgeEnd(tile);
+			if (GetWaterRegionIndex(other_end) == GetWaterRegionIndex(tile)) continue;
+
+			const WaterRegionPatchDesc other_patch = GetWaterRegionPatchInfo(other_end);
+			if (other_patch.IsValid()) callback(other_patch);
+		}
+	}
+}
+
+/**
+ * Mark the water region containing a tile as out of date, this must be called whenever the water tracks of a tile may have changed.
+ * Neighbouring regions are also invalidated if the tile is on a region edge, as their edge traversability depends on it.
+ * @param tile Changed tile.
+ */
+void InvalidateWaterRegion(TileIndex tile)
+{
+	if (_water_regions.empty()) return;
+
+	const uint index = GetWaterRegionIndex(tile);
+	_water_regions[index].Invalidate();
+
+	for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
+		const TileIndex adjacent = AddTileIndexDiffCWrap(tile, TileIndexDiffCByDiagDir(side));
+		if (adjacent == INVALID_TILE) continue;
+		const uint adjacent_index = GetWaterRegionIndex(adjacent);
+		if (adjacent_index != index) _water_regions[adjacent_index].Invalidate();
+	}
+}
+
+/**
+ * Allocate the water regions for the current map size, all regions are initially out of date.
+ */
+void AllocateWaterRegions()
+{
+	_water_regions.clear();
+	_water_regions.resize(GetWaterRegionMapSizeX() * GetWaterRegionMapSizeY());
+}
+
+/**
+ * Check that all up to date water regions match the current state of the map.
+ * @param log Logging function for any mismatches.
+ */
+void CheckWaterRegionCaches(std::function<void(const char *)> log)
+{
+	char cclog_buffer[1024];
+#define CCLOG(...) { \
+	seprintf(cclog_buffer, lastof(cclog_buffer), __VA_ARGS__); \
+	DEBUG(desync, 0, "%s", cclog_buffer); \
+	if (log) log(cclog_buffer); \
+}
+
+	for (uint y = 0; y < GetWaterRegionMapSizeY(); y++) {
+		for (uint x = 0; x < GetWaterRegionMapSizeX(); x++) {
+			const WaterRegion &region = _water_regions[GetWaterRegionIndex(x, y)];
+			if (!region.IsInitialized()) continue;
+
+			WaterRegion check;
+			check.Update(x, y);
+			bool labels_match = (region.tile_patch_labels == nullptr) == (check.tile_patch_labels == nullptr);
+			if (labels_match && region.tile_patch_labels != nullptr) {
+				labels_match = std::equal(region.tile_patch_labels.get(), region.tile_patch_labels.get() + WATER_REGION_NUMBER_OF_TILES, check.tile_patch_labels.get());
+			}
+			if (!labels_match || region.number_of_patches != check.number_of_patches ||
+					region.edge_traversability_bits != check.edge_traversability_bits ||
+					region.has_cross_region_aqueducts != check.has_cross_region_aqueducts) {
+				CCLOG("water region mismatch: region %u x %u (tile: 0x%X)", x, y, TileXY(x * WATER_REGION_EDGE_LENGTH, y * WATER_REGION_EDGE_LENGTH));
+			}
+		}
+	}
+#undef CCLOG
+}
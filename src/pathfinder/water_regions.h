@@ -0,0 +1,69 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file water_regions.h Handles dividing the water in the map into regions to assist pathfinding. */
+
+#ifndef WATER_REGIONS_H
+#define WATER_REGIONS_H
+
+#include "../tile_type.h"
+#include "../map_func.h"
+
+#include <functional>
+#include <vector>
+
+typedef uint8 WaterRegionPatchLabel;
+
+static const uint WATER_REGION_EDGE_LENGTH = 16; ///< Edge length of a water region in tiles.
+static const uint WATER_REGION_NUMBER_OF_TILES = WATER_REGION_EDGE_LENGTH * WATER_REGION_EDGE_LENGTH; ///< Number of tiles in a water region.
+
+static const WaterRegionPatchLabel INVALID_WATER_REGION_PATCH = 0; ///< Label of tiles which are not part of any patch.
+
+/**
+ * Describes a single interconnected patch of water within a particular water region.
+ */
+struct WaterRegionPatchDesc {
+	uint x;                       ///< The X coordinate of the water region, i.e. X = 2 is the 3rd water region along the X-axis.
+	uint y;                       ///< The Y coordinate of the water region, i.e. Y = 2 is the 3rd water region along the Y-axis.
+	WaterRegionPatchLabel label;  ///< Unique label identifying the patch within the region.
+
+	bool operator==(const WaterRegionPatchDesc &other) const { return this->x == other.x && this->y == other.y && this->label == other.label; }
+	bool operator!=(const WaterRegionPatchDesc &other) const { return !(*this == other); }
+
+	bool IsValid() const { return this->label != INVALID_WATER_REGION_PATCH; }
+};
+
+/**
+ * Get a unique key for a water region patch, suitable for use in maps and sets.
+ * @param patch Water region patch.
+ * @return Key.
+ */
+inline uint32 GetWaterRegionPatchKey(const WaterRegionPatchDesc &patch)
+{
+	return ((patch.y * (MapSizeX() / WATER_REGION_EDGE_LENGTH) + patch.x) << 8) | patch.label;
+}
+
+/**
+ * Get the tile at the centre of a water region.
+ * @param patch Water region patch within the region.
+ * @return Centre tile of the region.
+ */
+inline TileIndex GetWaterRegionCenterTile(const WaterRegionPatchDesc &patch)
+{
+	return TileXY(patch.x * WATER_REGION_EDGE_LENGTH + WATER_REGION_EDGE_LENGTH / 2, patch.y * WATER_REGION_EDGE_LENGTH + WATER_REGION_EDGE_LENGTH / 2);
+}
+
+typedef std::function<void(const WaterRegionPatchDesc &)> VisitWaterRegionPatchCallback;
+
+WaterRegionPatchDesc GetWaterRegionPatchInfo(TileIndex tile);
+void VisitWaterRegionPatchNeighbours(const WaterRegionPatchDesc &patch, const VisitWaterRegionPatchCallback &callback);
+
+void InvalidateWaterRegion(TileIndex tile);
+void AllocateWaterRegions();
+void CheckWaterRegionCaches(std::function<void(const char *)> log);
+
+#endif /* WATER_REGIONS_H */
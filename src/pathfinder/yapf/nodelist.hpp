@@ -10,9 +10,75 @@
 #ifndef NODELIST_HPP
 #define NODELIST_HPP
 
-#include "../../misc/array.hpp"
+#include "../../core/arena_alloc.hpp"
 #include "../../misc/hashtable.hpp"
 #include "../../misc/binaryheap.hpp"
+#include "../../string_func.h"
+
+#include <memory>
+#include <type_traits>
+
+/**
+ * Storage of the items, hash tables and priority queue of a CNodeList_HashTableT.
+ * One instance per thread is kept between searches, so that each new pathfinder instance
+ * reuses the memory of the previous one instead of allocating its own.
+ */
+template <class Titem_, int Thash_bits_open_, int Thash_bits_closed_>
+struct CNodeListStorageT {
+	typedef UniformArenaAllocator<sizeof(Titem_), 256> CItemArena;           ///< Type that we will use as item container.
+	typedef CGenerationalHashTableT<Titem_, Thash_bits_open_  > COpenList;   ///< How pointers to open nodes will be stored.
+	typedef CGenerationalHashTableT<Titem_, Thash_bits_closed_> CClosedList; ///< How pointers to closed nodes will be stored.
+	typedef CBinaryHeapT<Titem_> CPriorityQueue;                             ///< How the priority queue will be managed.
+
+	static const size_t MAX_RETAINED_BLOCKS = 64; ///< Maximum number of item blocks to keep between searches.
+
+	CItemArena      m_arena;         ///< Here we store full item data (Titem_).
+	uint            m_num_items = 0; ///< Number of items allocated from m_arena.
+	COpenList       m_open;          ///< Hash table of pointers to open item data.
+	CClosedList     m_closed;        ///< Hash table of pointers to closed item data.
+	CPriorityQueue  m_open_queue;    ///< Priority queue of pointers to open item data.
+	bool            m_in_use = false; ///< Whether a node list is currently using this storage.
+
+	CNodeListStorageT() : m_open_queue(2048) {}
+
+	~CNodeListStorageT()
+	{
+		this->Reset();
+	}
+
+	inline Titem_ &ItemAt(uint idx)
+	{
+		return *static_cast<Titem_ *>(m_arena.GetAllocationByIndex(idx));
+	}
+
+	inline const Titem_ &ItemAt(uint idx) const
+	{
+		return *static_cast<const Titem_ *>(m_arena.GetAllocationByIndex(idx));
+	}
+
+	inline Titem_ *AppendC()
+	{
+		Titem_ *item = static_cast<Titem_ *>(m_arena.Allocate());
+		new (item) Titem_;
+		m_num_items++;
+		return item;
+	}
+
+	/** Forget all items, keeping the allocated memory for the next search. */
+	void Reset()
+	{
+		if constexpr (!std::is_trivially_destructible_v<Titem_>) {
+			for (uint i = 0; i < m_num_items; i++) {
+				this->ItemAt(i).~Titem_();
+			}
+		}
+		m_num_items = 0;
+		m_arena.RewindArena(MAX_RETAINED_BLOCKS);
+		m_open.Clear();
+		m_closed.Clear();
+		m_open_queue.Clear();
+	}
+};
 
 /**
  * Hash table based node list multi-container class.
@@ -24,46 +90,64 @@ class CNodeList_HashTableT {
 public:
 	typedef Titem_ Titem;                                        ///< Make #Titem_ visible from outside of class.
 	typedef typename Titem_::Key Key;                            ///< Make Titem_::Key a property of this class.
-	typedef SmallArray<Titem_, 65536, 256> CItemArray;           ///< Type that we will use as item container.
-	typedef CHashTableT<Titem_, Thash_bits_open_  > COpenList;   ///< How pointers to open nodes will be stored.
-	typedef CHashTableT<Titem_, Thash_bits_closed_> CClosedList; ///< How pointers to closed nodes will be stored.
-	typedef CBinaryHeapT<Titem_> CPriorityQueue;                 ///< How the priority queue will be managed.
+	typedef CNodeListStorageT<Titem_, Thash_bits_open_, Thash_bits_closed_> CStorage; ///< Storage of items, hash tables and priority queue.
 
 protected:
-	CItemArray      m_arr;        ///< Here we store full item data (Titem_).
-	COpenList       m_open;       ///< Hash table of pointers to open item data.
-	CClosedList     m_closed;     ///< Hash table of pointers to closed item data.
-	CPriorityQueue  m_open_queue; ///< Priority queue of pointers to open item data.
+	std::unique_ptr<CStorage> m_own_storage; ///< Storage owned by this node list, only used when the thread's storage is already in use.
+	CStorage       &m_storage;    ///< Storage in use by this node list.
 	Titem          *m_new_node;   ///< New open node under construction.
 
+	/** Get the storage of this thread, which is reused by successive node lists. */
+	static CStorage &GetThreadStorage()
+	{
+		static thread_local std::unique_ptr<CStorage> storage;
+		if (!storage) storage.reset(new CStorage());
+		return *storage;
+	}
+
+	/** Get storage for a new node list, this is the thread's storage unless it is in use by another (nested) node list. */
+	CStorage &AcquireStorage()
+	{
+		CStorage &storage = GetThreadStorage();
+		if (!storage.m_in_use) return storage;
+		m_own_storage.reset(new CStorage());
+		return *m_own_storage;
+	}
+
 public:
 	/** default constructor */
-	CNodeList_HashTableT() : m_open_queue(2048)
+	CNodeList_HashTableT() : m_storage(AcquireStorage())
 	{
+		m_storage.m_in_use = true;
 		m_new_node = nullptr;
 	}
 
-	/** destructor */
+	/** destructor, this resets the storage for the next node list */
 	~CNodeList_HashTableT()
 	{
+		m_storage.Reset();
+		m_storage.m_in_use = false;
 	}
 
+	CNodeList_HashTableT(const CNodeList_HashTableT &other) = delete;
+	CNodeList_HashTableT& operator=(const CNodeList_HashTableT &other) = delete;
+
 	/** return number of open nodes */
 	inline int OpenCount()
 	{
-		return m_open.Count();
+		return m_storage.m_open.Count();
 	}
 
 	/** return number of closed nodes */
 	inline int ClosedCount()
 	{
-		return m_closed.Count();
+		return m_storage.m_closed.Count();
 	}
 
-	/** allocate new data item from m_arr */
+	/** allocate new data item from the storage */
 	inline Titem_ *CreateNewNode()
 	{
-		if (m_new_node == nullptr) m_new_node = m_arr.AppendC();
+		if (m_new_node == nullptr) m_new_node = m_storage.AppendC();
 		return m_new_node;
 	}
 
@@ -80,9 +164,9 @@ public:
 	/** insert given item as open node (into m_open and m_open_queue) */
 	inline void InsertOpenNode(Titem_ &item)
 	{
-		dbg_assert(m_closed.Find(item.GetKey()) == nullptr);
-		m_open.Push(item);
-		m_open_queue.Include(&item);
+		dbg_assert(m_storage.m_closed.Find(item.GetKey()) == nullptr);
+		m_storage.m_open.Push(item);
+		m_storage.m_open_queue.Include(&item);
 		if (&item == m_new_node) {
 			m_new_node = nullptr;
 		}
@@ -91,8 +175,8 @@ public:
 	/** return the best open node */
 	inline Titem_ *GetBestOpenNode()
 	{
-		if (!m_open_queue.IsEmpty()) {
-			return m_open_queue.Begin();
+		if (!m_storage.m_open_queue.IsEmpty()) {
+			return m_storage.m_open_queue.Begin();
 		}
 		return nullptr;
 	}
@@ -100,9 +184,9 @@ public:
 	/** remove and return the best open node */
 	inline Titem_ *PopBestOpenNode()
 	{
-		if (!m_open_queue.IsEmpty()) {
-			Titem_ *item = m_open_queue.Shift();
-			m_open.Pop(*item);
+		if (!m_storage.m_open_queue.IsEmpty()) {
+			Titem_ *item = m_storage.m_open_queue.Shift();
+			m_storage.m_open.Pop(*item);
 			return item;
 		}
 		return nullptr;
@@ -110,66 +194,72 @@ public:
 
 	inline void DequeueBestOpenNode()
 	{
-		dbg_assert(!m_open_queue.IsEmpty());
-		m_open_queue.Shift();
+		dbg_assert(!m_storage.m_open_queue.IsEmpty());
+		m_storage.m_open_queue.Shift();
 	}
 
 	inline void ReenqueueOpenNode(Titem_ &item)
 	{
-		m_open_queue.Include(&item);
+		m_storage.m_open_queue.Include(&item);
 	}
 
 	inline Titem_& PopAlreadyDequeuedOpenNode(const Key &key)
 	{
-		return m_open.Pop(key);
+		return m_storage.m_open.Pop(key);
 	}
 
 	/** return the open node specified by a key or nullptr if not found */
 	inline Titem_ *FindOpenNode(const Key &key)
 	{
-		Titem_ *item = m_open.Find(key);
+		Titem_ *item = m_storage.m_open.Find(key);
 		return item;
 	}
 
 	/** remove and return the open node specified by a key */
 	inline Titem_& PopOpenNode(const Key &key)
 	{
-		Titem_ &item = m_open.Pop(key);
-		uint idxPop = m_open_queue.FindIndex(item);
-		m_open_queue.Remove(idxPop);
+		Titem_ &item = m_storage.m_open.Pop(key);
+		uint idxPop = m_storage.m_open_queue.FindIndex(item);
+		m_storage.m_open_queue.Remove(idxPop);
 		return item;
 	}
 
 	/** close node */
 	inline void InsertClosedNode(Titem_ &item)
 	{
-		dbg_assert(m_open.Find(item.GetKey()) == nullptr);
-		m_closed.Push(item);
+		dbg_assert(m_storage.m_open.Find(item.GetKey()) == nullptr);
+		m_storage.m_closed.Push(item);
 	}
 
 	/** return the closed node specified by a key or nullptr if not found */
 	inline Titem_ *FindClosedNode(const Key &key)
 	{
-		Titem_ *item = m_closed.Find(key);
+		Titem_ *item = m_storage.m_closed.Find(key);
 		return item;
 	}
 
 	/** The number of items. */
 	inline int TotalCount()
 	{
-		return m_arr.Length();
+		return m_storage.m_num_items;
 	}
 
 	/** Get a particular item. */
 	inline Titem_& ItemAt(int idx)
 	{
-		return m_arr[idx];
+		return m_storage.ItemAt(idx);
 	}
 
 	/** Helper for creating output of this array. */
 	template <class D> void Dump(D &dmp) const
 	{
-		dmp.WriteStructT("m_arr", &m_arr);
+		uint num_items = m_storage.m_num_items;
+		dmp.WriteValue("num_items", num_items);
+		for (uint i = 0; i < num_items; i++) {
+			char name[32];
+			seprintf(name, lastof(name), "item[%d]", i);
+			dmp.WriteStructT(name, &m_storage.ItemAt(i));
+		}
 	}
 };
 
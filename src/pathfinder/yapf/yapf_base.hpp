@@ -13,6 +13,19 @@
 #include "../../debug.h"
 #include "../../settings_type.h"
 
+/** Totals of the path searches made while running the pathfinder benchmark. */
+struct YapfBenchmarkStats {
+	uint64 searches = 0;   ///< Number of completed searches.
+	uint64 found = 0;      ///< Number of searches which found the destination.
+	uint64 steps = 0;      ///< Number of main loop iterations.
+	uint64 nodes = 0;      ///< Number of nodes created (open and closed).
+	uint64 cost_calcs = 0; ///< Number of node costs which were calculated.
+	uint64 cache_hits = 0; ///< Number of node costs which were taken from the segment cost cache.
+};
+
+/** Statistics collected by the pathfinder benchmark, or nullptr when not benchmarking. */
+extern YapfBenchmarkStats *_yapf_benchmark_stats;
+
 /**
  * CYapfBaseT - A-star type path finder base class.
  *  Derive your own pathfinder from it. You must provide the following template argument:
@@ -139,6 +152,15 @@ public:
 
 		bDestFound &= (m_pBestDestNode != nullptr);
 
+		if (_yapf_benchmark_stats != nullptr) {
+			_yapf_benchmark_stats->searches++;
+			if (bDestFound) _yapf_benchmark_stats->found++;
+			_yapf_benchmark_stats->steps += m_num_steps;
+			_yapf_benchmark_stats->nodes += m_nodes.OpenCount() + m_nodes.ClosedCount();
+			_yapf_benchmark_stats->cost_calcs += m_stats_cost_calcs;
+			_yapf_benchmark_stats->cache_hits += m_stats_cache_hits;
+		}
+
 		if (_debug_yapf_level >= 3) {
 			UnitID veh_idx = (m_veh != nullptr) ? m_veh->unitnumber : 0;
 			char ttc = Yapf().TransportTypeChar();
@@ -95,16 +95,22 @@ public:
  *  of track layout changes and static notification function called whenever
  *  the track layout changes. It is implemented as base class because it needs
  *  to be shared between all rail YAPF types (one shared counter, one notification
- *  function.
+ *  function. Road YAPF types use a separate counter in the same way.
  */
 struct CSegmentCostCacheBase
 {
 	static int   s_rail_change_counter;
+	static int   s_road_change_counter;
 
 	static void NotifyTrackLayoutChange(TileIndex tile, Track track)
 	{
 		s_rail_change_counter++;
 	}
+
+	static void NotifyRoadLayoutChange(TileIndex tile)
+	{
+		s_road_change_counter++;
+	}
 };
 
 
@@ -122,7 +128,7 @@ template <class Tsegment>
 struct CSegmentCostCacheT : public CSegmentCostCacheBase {
 	static const int C_HASH_BITS = 14;
 
-	typedef CHashTableT<Tsegment, C_HASH_BITS> HashTable;
+	typedef CGenerationalHashTableT<Tsegment, C_HASH_BITS> HashTable;
 	typedef SmallArray<Tsegment> Heap;
 	typedef typename Tsegment::Key Key;    ///< key to hash table
 
@@ -131,9 +137,13 @@ struct CSegmentCostCacheT : public CSegmentCostCacheBase {
 
 	inline CSegmentCostCacheT() {}
 
-	/** flush (clear) the cache */
+	/**
+	 * Flush (clear) the cache.
+	 * This happens after every path reservation which used the global cache, so clearing the hash table must be cheap.
+	 */
 	inline void Flush()
 	{
+		if (m_map.Count() == 0) return;
 		m_map.Clear();
 		m_heap.Clear();
 	}
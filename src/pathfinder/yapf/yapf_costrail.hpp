@@ -61,11 +61,12 @@ protected:
 
 public:
 	bool          m_stopped_on_first_two_way_signal;
+	bool          m_trace_restrict_executed;           ///< a routing restriction program was run for the vehicle during the search
 protected:
 
 	static const int s_max_segment_cost = 10000;
 
-	CYapfCostRailT() : m_max_cost(0), m_disable_cache(false), m_stopped_on_first_two_way_signal(false)
+	CYapfCostRailT() : m_max_cost(0), m_disable_cache(false), m_stopped_on_first_two_way_signal(false), m_trace_restrict_executed(false)
 	{
 		/* pre-compute look-ahead penalties into array */
 		int p0 = Yapf().PfGetSettings().rail_look_ahead_signal_p0;
@@ -301,6 +302,7 @@ private:
 			flags_to_check |= TRPAUF_REVERSE;
 		}
 		if (prog && prog->actions_used_flags & flags_to_check) {
+			m_trace_restrict_executed = true;
 			prog->Execute(Yapf().GetVehicle(), TraceRestrictProgramInput(tile, trackdir, &TraceRestrictPreviousSignalCallback, &n), out);
 			if (out.flags & TRPRF_RESERVE_THROUGH && is_res_through != nullptr) {
 				*is_res_through = true;
@@ -327,6 +329,7 @@ private:
 		const TraceRestrictProgram *prog = GetExistingTraceRestrictProgram(tile, TrackdirToTrack(trackdir));
 		TraceRestrictProgramActionsUsedFlags flags_to_check = TRPAUF_PF;
 		if (prog && prog->actions_used_flags & flags_to_check) {
+			m_trace_restrict_executed = true;
 			prog->Execute(Yapf().GetVehicle(), TraceRestrictProgramInput(tile, trackdir, &TraceRestrictPreviousSignalCallback, &n), out);
 			if (out.flags & TRPRF_DENY) {
 				n.m_segment->m_end_segment_reason |= ESRB_DEAD_END;
@@ -430,6 +433,7 @@ public:
 							const TraceRestrictProgram *prog = GetExistingTraceRestrictProgram(tile, TrackdirToTrack(trackdir));
 							if (prog && prog->actions_used_flags & TRPAUF_PF) {
 								TraceRestrictProgramResult out;
+								m_trace_restrict_executed = true;
 								prog->Execute(Yapf().GetVehicle(), TraceRestrictProgramInput(tile, trackdir, &TraceRestrictPreviousSignalCallback, &n), out);
 								if (out.flags & TRPRF_DENY) {
 									n.m_segment->m_end_segment_reason |= ESRB_DEAD_END;
@@ -10,6 +10,8 @@
 #ifndef YAPF_DESTRAIL_HPP
 #define YAPF_DESTRAIL_HPP
 
+#include "../../3rdparty/cpp-btree/btree_map.h"
+
 class CYapfDestinationRailBase {
 protected:
 	RailTypes m_compatible_railtypes;
@@ -82,6 +84,14 @@ public:
 	typedef typename Node::Key Key;               ///< key to hash tables
 	typedef typename Types::TrackFollower TrackFollower; ///< TrackFollower. Need to typedef for gcc 2.95
 
+protected:
+	/**
+	 * Free safe waiting position results of this search, keyed by (tile << 4) | trackdir.
+	 * The map state does not change during a search, so each position only needs to be checked once.
+	 */
+	btree::btree_map<uint64, bool> m_waiting_position_results;
+
+public:
 	/** to access inherited path finder */
 	Tpf& Yapf()
 	{
@@ -97,8 +107,14 @@ public:
 	/** Called by YAPF to detect if node ends in the desired destination */
 	inline bool PfDetectDestination(TileIndex tile, Trackdir td)
 	{
-		return IsSafeWaitingPosition(Yapf().GetVehicle(), tile, td, true, !TrackFollower::Allow90degTurns()) &&
+		const uint64 key = (static_cast<uint64>(tile) << 4) | td;
+		auto iter = m_waiting_position_results.find(key);
+		if (iter != m_waiting_position_results.end()) return iter->second;
+
+		bool result = IsSafeWaitingPosition(Yapf().GetVehicle(), tile, td, true, !TrackFollower::Allow90degTurns()) &&
 				IsWaitingPositionFree(Yapf().GetVehicle(), tile, td, !TrackFollower::Allow90degTurns());
+		m_waiting_position_results[key] = result;
+		return result;
 	}
 
 	/**
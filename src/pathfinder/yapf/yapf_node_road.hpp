@@ -10,17 +10,144 @@
 #ifndef YAPF_NODE_ROAD_HPP
 #define YAPF_NODE_ROAD_HPP
 
+/**
+ * Key for cached segment cost for road YAPF.
+ * The segment layout depends on which road types the vehicle can use and on
+ * infrastructure sharing, so these are part of the key as well as the origin.
+ * The compatible road types of road and tram vehicles never overlap, which
+ * keeps road and tram segments starting from the same trackdir apart.
+ */
+struct CYapfRoadSegmentKey
+{
+	uint32    m_value;
+	RoadTypes m_compatible_roadtypes;
+	Owner     m_owner;
+
+	inline CYapfRoadSegmentKey(const CYapfNodeKeyExitDir &node_key, const RoadVehicle *v)
+	{
+		m_value = (((int)node_key.m_tile) << 4) | node_key.m_td;
+		m_compatible_roadtypes = v->compatible_roadtypes;
+		m_owner = v->owner;
+	}
+
+	inline int32 CalcHash() const
+	{
+		return m_value;
+	}
+
+	inline TileIndex GetTile() const
+	{
+		return (TileIndex)(m_value >> 4);
+	}
+
+	inline Trackdir GetTrackdir() const
+	{
+		return (Trackdir)(m_value & 0x0F);
+	}
+
+	inline bool operator==(const CYapfRoadSegmentKey &other) const
+	{
+		return m_value == other.m_value && m_compatible_roadtypes == other.m_compatible_roadtypes && m_owner == other.m_owner;
+	}
+
+	void Dump(DumpTarget &dmp) const
+	{
+		dmp.WriteTile("tile", GetTile());
+		dmp.WriteEnumT("td", GetTrackdir());
+		dmp.WriteValue("m_owner", m_owner);
+	}
+};
+
+/** Cached segment cost for road YAPF */
+struct CYapfRoadSegment
+{
+	typedef CYapfRoadSegmentKey Key;
+
+	/** Segment cost cache states */
+	enum CacheState : uint8 {
+		RSCS_EMPTY,         ///< The segment has not been walked yet.
+		RSCS_VALID,         ///< The cached cost and segment end are valid.
+		RSCS_NO_PATH,       ///< The segment is a simple loop without junctions.
+		RSCS_UNCACHEABLE,   ///< The segment contains road stops or other tiles with variable cost and has to be walked every time.
+	};
+
+	CYapfRoadSegmentKey    m_key;
+	TileIndex              m_last_tile;
+	Trackdir               m_last_td;
+	CacheState             m_state;
+	int                    m_cost;           ///< Cost of the segment, excluding vehicle speed dependent penalties.
+	int                    m_min_max_speed;  ///< Lowest maximum speed along the segment.
+	int                    m_max_min_speed;  ///< Highest minimum speed along the segment.
+	CYapfRoadSegment      *m_hash_next;
+
+	inline CYapfRoadSegment(const CYapfRoadSegmentKey &key)
+		: m_key(key)
+		, m_last_tile(INVALID_TILE)
+		, m_last_td(INVALID_TRACKDIR)
+		, m_state(RSCS_EMPTY)
+		, m_cost(-1)
+		, m_min_max_speed(INT_MAX)
+		, m_max_min_speed(0)
+		, m_hash_next(nullptr)
+	{}
+
+	inline const Key& GetKey() const
+	{
+		return m_key;
+	}
+
+	inline TileIndex GetTile() const
+	{
+		return m_key.GetTile();
+	}
+
+	inline CYapfRoadSegment *GetHashNext()
+	{
+		return m_hash_next;
+	}
+
+	inline void SetHashNext(CYapfRoadSegment *next)
+	{
+		m_hash_next = next;
+	}
+
+	/**
+	 * Can the cached cost of this segment be used for a vehicle with the given maximum speed?
+	 * The speed penalties are not part of the cached cost, so this is only the case if none would apply.
+	 * @param max_veh_speed Maximum speed of the vehicle.
+	 * @return True if the cached cost is exact for this vehicle.
+	 */
+	inline bool IsUsableForSpeed(int max_veh_speed) const
+	{
+		return max_veh_speed <= m_min_max_speed && m_max_min_speed <= max_veh_speed;
+	}
+
+	void Dump(DumpTarget &dmp) const
+	{
+		dmp.WriteStructT("m_key", &m_key);
+		dmp.WriteTile("m_last_tile", m_last_tile);
+		dmp.WriteEnumT("m_last_td", m_last_td);
+		dmp.WriteValue("m_state", m_state);
+		dmp.WriteValue("m_cost", m_cost);
+		dmp.WriteValue("m_min_max_speed", m_min_max_speed);
+		dmp.WriteValue("m_max_min_speed", m_max_min_speed);
+	}
+};
+
 /** Yapf Node for road YAPF */
 template <class Tkey_>
 struct CYapfRoadNodeT : CYapfNodeT<Tkey_, CYapfRoadNodeT<Tkey_> > {
 	typedef CYapfNodeT<Tkey_, CYapfRoadNodeT<Tkey_> > base;
+	typedef CYapfRoadSegment CachedData;
 
+	CYapfRoadSegment *m_segment;
 	TileIndex m_segment_last_tile;
 	Trackdir  m_segment_last_td;
 
 	void Set(CYapfRoadNodeT *parent, TileIndex tile, Trackdir td, bool is_choice)
 	{
 		base::Set(parent, tile, td, is_choice);
+		m_segment = nullptr;
 		m_segment_last_tile = tile;
 		m_segment_last_td = td;
 	}
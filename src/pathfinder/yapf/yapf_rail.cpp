@@ -18,6 +18,10 @@
 #include "../../newgrf_station.h"
 #include "../../tracerestrict.h"
 #include "../../debug.h"
+#include "../../3rdparty/cpp-btree/btree_map.h"
+
+#include <tuple>
+
 
 #include "../../safeguards.h"
 
@@ -543,6 +547,18 @@ public:
 		return result1;
 	}
 
+	/**
+	 * Choose a track without reserving a path, for sharing the result with other trains.
+	 * @param[out] shareable Whether the result does not depend on routing restrictions, and so only on the inputs of TrainPathfindBatchKey.
+	 */
+	static Trackdir stChooseRailTrackShareable(const Train *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, bool &shareable)
+	{
+		Tpf pf;
+		Trackdir result = pf.ChooseRailTrack(v, tile, enterdir, tracks, path_found, false, nullptr, nullptr);
+		shareable = !pf.m_trace_restrict_executed;
+		return result;
+	}
+
 	inline Trackdir ChooseRailTrack(const Train *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, bool reserve_track, PBSTileInfo *target, TileIndex *dest)
 	{
 		if (target != nullptr) target->tile = INVALID_TILE;
@@ -660,8 +676,109 @@ struct CYapfAnySafeTileRail1 : CYapfT<CYapfRail_TypesT<CYapfAnySafeTileRail1, CF
 struct CYapfAnySafeTileRail2 : CYapfT<CYapfRail_TypesT<CYapfAnySafeTileRail2, CFollowTrackFreeRailNo90, CRailNodeListTrackDir, CYapfDestinationAnySafeTileRailT , CYapfFollowAnySafeTileRailT> > {};
 
 
+/**
+ * Everything which the result of a non-reserving train path search depends on,
+ * apart from the state of the map, and routing restrictions.
+ */
+struct TrainPathfindBatchKey {
+	TileIndex origin_tile;
+	Trackdir origin_td;
+	TileIndex tile;
+	DiagDirection enterdir;
+	TrackBits tracks;
+	TileIndex veh_tile;
+	TileIndex dest_tile;
+	uint64 order;
+	uint16 order_max_speed;
+	RailTypes compatible_railtypes;
+	Owner owner;
+	uint32 total_length;
+	int max_speed;
+
+	TrainPathfindBatchKey() {}
+
+	TrainPathfindBatchKey(const Train *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks)
+	{
+		PBSTileInfo origin = FollowTrainReservation(v, nullptr, FTRF_OKAY_UNUSED);
+		this->origin_tile = origin.tile;
+		this->origin_td = origin.trackdir;
+		this->tile = tile;
+		this->enterdir = enterdir;
+		this->tracks = tracks;
+		this->veh_tile = v->tile;
+		this->dest_tile = v->dest_tile;
+		this->order = v->current_order.Pack();
+		this->order_max_speed = v->current_order.GetMaxSpeed();
+		this->compatible_railtypes = v->compatible_railtypes;
+		this->owner = v->owner;
+		this->total_length = v->gcache.cached_total_length;
+		this->max_speed = v->GetDisplayMaxSpeed();
+	}
+
+	auto Tie() const
+	{
+		return std::tie(this->origin_tile, this->origin_td, this->tile, this->enterdir, this->tracks, this->veh_tile, this->dest_tile,
+				this->order, this->order_max_speed, this->compatible_railtypes, this->owner, this->total_length, this->max_speed);
+	}
+
+	bool operator<(const TrainPathfindBatchKey &other) const
+	{
+		return this->Tie() < other.Tie();
+	}
+};
+
+/** Result of a shared train path search. */
+struct TrainPathfindBatchResult {
+	Trackdir trackdir;
+	bool path_found;
+};
+
+/**
+ * Results of the non-reserving train path searches of the current tick.
+ * Trains released together, e.g. from the same depot, search from the same origin to the same
+ * destination, so later identical searches within the same tick reuse the first result.
+ * This is not saved, as it is cleared every tick and whenever the track layout changes.
+ */
+static btree::btree_map<TrainPathfindBatchKey, TrainPathfindBatchResult> _train_pathfind_batch;
+static uint64 _train_pathfind_batch_tick = 0;
+static int _train_pathfind_batch_rail_change_counter = 0;
+
+static Trackdir YapfTrainChooseTrackBatched(const Train *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found)
+{
+	if (_train_pathfind_batch_tick != _tick_counter || _train_pathfind_batch_rail_change_counter != CSegmentCostCacheBase::s_rail_change_counter) {
+		_train_pathfind_batch.clear();
+		_train_pathfind_batch_tick = _tick_counter;
+		_train_pathfind_batch_rail_change_counter = CSegmentCostCacheBase::s_rail_change_counter;
+	}
+
+	TrainPathfindBatchKey key(v, tile, enterdir, tracks);
+	auto iter = _train_pathfind_batch.find(key);
+	if (iter != _train_pathfind_batch.end()) {
+		path_found = iter->second.path_found;
+		return iter->second.trackdir;
+	}
+
+	typedef Trackdir (*PfnChooseRailTrackShareable)(const Train*, TileIndex, DiagDirection, TrackBits, bool&, bool&);
+	PfnChooseRailTrackShareable pfnChooseRailTrack = &CYapfRail1::stChooseRailTrackShareable;
+	if (_settings_game.pf.forbid_90_deg) {
+		pfnChooseRailTrack = &CYapfRail2::stChooseRailTrackShareable; // Trackdir, forbid 90-deg
+	}
+
+	bool shareable;
+	Trackdir td_ret = pfnChooseRailTrack(v, tile, enterdir, tracks, path_found, shareable);
+	if (shareable) _train_pathfind_batch[key] = { td_ret, path_found };
+	return td_ret;
+}
+
 Track YapfTrainChooseTrack(const Train *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, bool reserve_track, PBSTileInfo *target, TileIndex *dest)
 {
+	if (!reserve_track && _settings_game.pf.yapf.rail_pathfind_batch && _debug_yapfdesync_level < 1 && _debug_desync_level < 2) {
+		if (target != nullptr) target->tile = INVALID_TILE;
+		if (dest != nullptr) *dest = INVALID_TILE;
+		Trackdir td_ret = YapfTrainChooseTrackBatched(v, tile, enterdir, tracks, path_found);
+		return (td_ret != INVALID_TRACKDIR) ? TrackdirToTrack(td_ret) : FindFirstTrack(tracks);
+	}
+
 	/* default is YAPF type 2 */
 	typedef Trackdir (*PfnChooseRailTrack)(const Train*, TileIndex, DiagDirection, TrackBits, bool&, bool, PBSTileInfo*, TileIndex*);
 	PfnChooseRailTrack pfnChooseRailTrack = &CYapfRail1::stChooseRailTrack;
@@ -10,6 +10,7 @@
 #include "../../stdafx.h"
 #include "yapf.hpp"
 #include "yapf_node_road.hpp"
+#include "yapf_cache.h"
 #include "../../roadstop_base.h"
 #include "../../vehicle_func.h"
 
@@ -34,6 +35,7 @@ public:
 	typedef typename Types::TrackFollower TrackFollower; ///< track follower helper
 	typedef typename Types::NodeList::Titem Node; ///< this will be our node type
 	typedef typename Node::Key Key;    ///< key to hash tables
+	typedef typename Node::CachedData CachedData;
 
 protected:
 	int m_max_cost;
@@ -150,18 +152,42 @@ public:
 		/* this is to handle the case where the starting tile is a junction custom bridge head,
 		 * and we have advanced across the bridge in the initial step */
 		int segment_cost = tf->m_tiles_skipped * YAPF_TILE_LENGTH;
+		int parent_cost = (n.m_parent != nullptr) ? n.m_parent->m_cost : 0;
+
+		const RoadVehicle *v = Yapf().GetVehicle();
+		int max_veh_speed = std::min<int>(v->GetDisplayMaxSpeed(), v->current_order.GetMaxSpeed() * 2);
+
+		CachedData &segment = *n.m_segment;
+		if (segment.m_state == CachedData::RSCS_NO_PATH) return false;
+		if (segment.m_state == CachedData::RSCS_VALID && segment.IsUsableForSpeed(max_veh_speed)) {
+			/* Segment is cached, no need to walk it again */
+			n.m_segment_last_tile = segment.m_last_tile;
+			n.m_segment_last_td = segment.m_last_td;
+			n.m_cost = parent_cost + segment_cost + segment.m_cost;
+			return true;
+		}
+
+		/* Only fill segments which have not been walked before, the cost of the
+		 * speed independent part is accumulated separately in static_cost. */
+		bool cacheable = (segment.m_state == CachedData::RSCS_EMPTY);
+		int static_cost = 0;
+		int min_max_speed = INT_MAX;
+		int max_min_speed = 0;
 
 		uint tiles = 0;
 		/* start at n.m_key.m_tile / n.m_key.m_td and walk to the end of segment */
 		TileIndex tile = n.m_key.m_tile;
 		Trackdir trackdir = n.m_key.m_td;
-		int parent_cost = (n.m_parent != nullptr) ? n.m_parent->m_cost : 0;
 
 		for (;;) {
 			/* base tile cost depending on distance between edges */
-			segment_cost += Yapf().OneTileCost(tile, trackdir, tf);
+			int tile_cost = Yapf().OneTileCost(tile, trackdir, tf);
+			segment_cost += tile_cost;
+			static_cost += tile_cost;
+
+			/* road stop costs depend on their occupancy */
+			if (IsTileType(tile, MP_STATION)) cacheable = false;
 
-			const RoadVehicle *v = Yapf().GetVehicle();
 			/* we have reached the vehicle's destination - segment should end here to avoid target skipping */
 			if (Yapf().PfDetectDestinationTile(tile, trackdir)) break;
 
@@ -184,6 +210,7 @@ public:
 			/* if we skipped some tunnel tiles, add their cost */
 			/* with custom bridge heads, this cost must be added before checking if the segment has ended */
 			segment_cost += F.m_tiles_skipped * YAPF_TILE_LENGTH;
+			static_cost += F.m_tiles_skipped * YAPF_TILE_LENGTH;
 			tiles += F.m_tiles_skipped + 1;
 
 			/* if there are more trackdirs available & reachable, we are at the end of segment */
@@ -192,17 +219,23 @@ public:
 			Trackdir new_td = (Trackdir)FindFirstBit2x64(F.m_new_td_bits);
 
 			/* stop if RV is on simple loop with no junctions */
-			if (F.m_new_tile == n.m_key.m_tile && new_td == n.m_key.m_td) return false;
+			if (F.m_new_tile == n.m_key.m_tile && new_td == n.m_key.m_td) {
+				if (cacheable) segment.m_state = CachedData::RSCS_NO_PATH;
+				return false;
+			}
 
 			/* add hilly terrain penalty */
-			segment_cost += Yapf().SlopeCost(tile, F.m_new_tile, trackdir);
+			int slope_cost = Yapf().SlopeCost(tile, F.m_new_tile, trackdir);
+			segment_cost += slope_cost;
+			static_cost += slope_cost;
 
 			/* add min/max speed penalties */
 			int min_speed = 0;
-			int max_veh_speed = std::min<int>(v->GetDisplayMaxSpeed(), v->current_order.GetMaxSpeed() * 2);
 			int max_speed = F.GetSpeedLimit(&min_speed);
 			if (max_speed < max_veh_speed) segment_cost += YAPF_TILE_LENGTH * (max_veh_speed - max_speed) * (4 + F.m_tiles_skipped) / max_veh_speed;
 			if (min_speed > max_veh_speed) segment_cost += YAPF_TILE_LENGTH * (min_speed - max_veh_speed);
+			min_max_speed = std::min(min_max_speed, max_speed);
+			max_min_speed = std::max(max_min_speed, min_speed);
 
 			/* move to the next tile */
 			tile = F.m_new_tile;
@@ -214,10 +247,102 @@ public:
 		n.m_segment_last_tile = tile;
 		n.m_segment_last_td = trackdir;
 
+		if (cacheable) {
+			segment.m_state = CachedData::RSCS_VALID;
+			segment.m_last_tile = tile;
+			segment.m_last_td = trackdir;
+			segment.m_cost = static_cost;
+			segment.m_min_max_speed = min_max_speed;
+			segment.m_max_min_speed = max_min_speed;
+		} else if (segment.m_state == CachedData::RSCS_EMPTY) {
+			segment.m_state = CachedData::RSCS_UNCACHEABLE;
+		}
+
 		/* save also tile cost */
 		n.m_cost = parent_cost + segment_cost;
 		return true;
 	}
+
+	inline bool CanUseGlobalCache(Node &n)
+	{
+		return (n.m_parent != nullptr)
+			&& (m_max_cost == 0)
+			&& (Yapf().leader_targets[0] == INVALID_TILE)
+			&& Yapf().CanUseGlobalCacheForDestination();
+	}
+
+	inline void ConnectNodeToCachedData(Node &n, CachedData &ci)
+	{
+		n.m_segment = &ci;
+	}
+};
+
+/**
+ * CYapfSegmentCostCacheRoadT - the yapf cost cache provider for road vehicles.
+ *  Works like CYapfSegmentCostCacheGlobalT, except that the cache key also
+ *  contains the vehicle properties which affect the segment layout.
+ */
+template <class Types>
+class CYapfSegmentCostCacheRoadT
+{
+public:
+	typedef typename Types::Tpf Tpf;              ///< the pathfinder class (derived from THIS class)
+	typedef typename Types::NodeList::Titem Node; ///< this will be our node type
+	typedef typename Node::CachedData CachedData;
+	typedef typename CachedData::Key CacheKey;
+	typedef CSegmentCostCacheT<CachedData> Cache;
+	typedef SmallArray<CachedData> LocalCache;
+
+protected:
+	LocalCache      m_local_cache;
+	Cache          &m_global_cache;
+
+	inline CYapfSegmentCostCacheRoadT() : m_global_cache(stGetGlobalCache()) {};
+
+	/** to access inherited path finder */
+	inline Tpf& Yapf()
+	{
+		return *static_cast<Tpf *>(this);
+	}
+
+	inline static Cache& stGetGlobalCache()
+	{
+		static int last_road_change_counter = 0;
+		static Cache C;
+
+		/* delete the cache sometimes... */
+		if (last_road_change_counter != Cache::s_road_change_counter) {
+			last_road_change_counter = Cache::s_road_change_counter;
+			C.Flush();
+		}
+		return C;
+	}
+
+public:
+	/**
+	 * Called by YAPF to attach cached or local segment cost data to the given node.
+	 *  @return true if globally cached data were used or false if local data was used
+	 */
+	inline bool PfNodeCacheFetch(Node &n)
+	{
+		CacheKey key(n.GetKey(), Yapf().GetVehicle());
+		if (!Yapf().CanUseGlobalCache(n)) {
+			Yapf().ConnectNodeToCachedData(n, *new (m_local_cache.Append()) CachedData(key));
+			return false;
+		}
+		bool found;
+		CachedData &item = m_global_cache.Get(key, &found);
+		Yapf().ConnectNodeToCachedData(n, item);
+		return found;
+	}
+
+	/**
+	 * Called by YAPF to flush the cached segment cost data back into cache storage.
+	 *  Current cache implementation doesn't use that.
+	 */
+	inline void PfNodeCacheFlush(Node &n)
+	{
+	}
 };
 
 
@@ -247,6 +372,12 @@ public:
 		return IsRoadDepotTile(tile);
 	}
 
+	/** Depot tiles always end a segment, so any segment can be cached. */
+	inline bool CanUseGlobalCacheForDestination() const
+	{
+		return true;
+	}
+
 	/**
 	 * Called by YAPF to calculate cost estimate. Calculates distance to the destination
 	 *  adds it to the actual cost from origin and stores the sum to the Node::m_estimate
@@ -306,6 +437,15 @@ public:
 		return m_dest_station != INVALID_STATION ? Station::GetIfValid(m_dest_station) : nullptr;
 	}
 
+	/**
+	 * Segments which contain station tiles are never cached, so the destination can only be
+	 * part of a cached segment when heading for a plain tile.
+	 */
+	inline bool CanUseGlobalCacheForDestination() const
+	{
+		return m_dest_station != INVALID_STATION;
+	}
+
 protected:
 	/** to access inherited path finder */
 	Tpf& Yapf()
@@ -623,13 +763,18 @@ struct CYapfRoad_TypesT
 	typedef CYapfFollowRoadT<Types>           PfFollow;
 	typedef CYapfOriginTileT<Types>           PfOrigin;
 	typedef Tdestination<Types>               PfDestination;
-	typedef CYapfSegmentCostCacheNoneT<Types> PfCache;
+	typedef CYapfSegmentCostCacheRoadT<Types> PfCache;
 	typedef CYapfCostRoadT<Types>             PfCost;
 };
 
 template <class Types>
 struct CYapfRoadCommon : CYapfT<Types> {
 	TileIndex leader_targets[MAX_RV_LEADER_TARGETS]; ///< the tiles targeted by vehicles in front of the current vehicle
+
+	CYapfRoadCommon()
+	{
+		leader_targets[0] = INVALID_TILE;
+	}
 };
 
 struct CYapfRoad1         : CYapfRoadCommon<CYapfRoad_TypesT<CYapfRoad1        , CRoadNodeListTrackDir, CYapfDestinationTileRoadT    > > {};
@@ -639,6 +784,14 @@ struct CYapfRoadAnyDepot1 : CYapfRoadCommon<CYapfRoad_TypesT<CYapfRoadAnyDepot1,
 struct CYapfRoadAnyDepot2 : CYapfRoadCommon<CYapfRoad_TypesT<CYapfRoadAnyDepot2, CRoadNodeListExitDir , CYapfDestinationAnyDepotRoadT> > {};
 
 
+/** if any road changes, this counter is incremented - that will invalidate segment cost cache */
+int CSegmentCostCacheBase::s_road_change_counter = 0;
+
+void YapfNotifyRoadLayoutChange(TileIndex tile)
+{
+	CSegmentCostCacheBase::NotifyRoadLayoutChange(tile);
+}
+
 Trackdir YapfRoadVehicleChooseTrack(const RoadVehicle *v, TileIndex tile, DiagDirection enterdir, TrackdirBits trackdirs, bool &path_found, RoadVehPathCache &path_cache)
 {
 	/* default is YAPF type 2 */
@@ -11,12 +11,86 @@
 #include "../../ship.h"
 #include "../../industry.h"
 #include "../../vehicle_func.h"
+#include "../../station_base.h"
+#include "../water_regions.h"
+#include "../../3rdparty/cpp-btree/btree_map.h"
 
 #include "yapf.hpp"
 #include "yapf_node_ship.hpp"
 
+#include <queue>
+
 #include "../../safeguards.h"
 
+/** Number of water regions along the high level path which the low level path search is restricted to. */
+static const uint WATER_REGION_LOOKAHEAD = 4;
+
+/**
+ * Search for a path between water region patches, using A* with the region distance as estimate.
+ * @param start Patch to start at.
+ * @param goals Patches to find a path to.
+ * @param max_nodes Maximum number of patches to visit.
+ * @return Patches along the path, starting with start, or an empty vector if no path was found.
+ */
+static std::vector<WaterRegionPatchDesc> FindWaterRegionPath(const WaterRegionPatchDesc &start, const std::vector<WaterRegionPatchDesc> &goals, uint max_nodes)
+{
+	struct RegionNode {
+		WaterRegionPatchDesc patch;
+		uint cost;
+		uint parent;
+	};
+	std::vector<RegionNode> nodes;
+	btree::btree_map<uint32, uint> best_nodes;
+
+	/* Min-heap of (estimate, node index), the node index makes the order deterministic */
+	typedef std::pair<uint, uint> OpenItem;
+	std::priority_queue<OpenItem, std::vector<OpenItem>, std::greater<OpenItem>> open;
+
+	auto estimate = [&](const WaterRegionPatchDesc &patch) -> uint {
+		uint best = UINT_MAX;
+		for (const WaterRegionPatchDesc &goal : goals) {
+			best = std::min<uint>(best, Delta(patch.x, goal.x) + Delta(patch.y, goal.y));
+		}
+		return best;
+	};
+
+	nodes.push_back({ start, 0, UINT_MAX });
+	best_nodes[GetWaterRegionPatchKey(start)] = 0;
+	open.push({ estimate(start), 0 });
+
+	while (!open.empty()) {
+		const uint index = open.top().second;
+		open.pop();
+		const RegionNode node = nodes[index];
+		if (best_nodes[GetWaterRegionPatchKey(node.patch)] != index) continue;
+
+		if (std::find(goals.begin(), goals.end(), node.patch) != goals.end()) {
+			std::vector<WaterRegionPatchDesc> path;
+			for (uint i = index; i != UINT_MAX; i = nodes[i].parent) {
+				path.push_back(nodes[i].patch);
+			}
+			std::reverse(path.begin(), path.end());
+			return path;
+		}
+		if (nodes.size() >= max_nodes) break;
+
+		VisitWaterRegionPatchNeighbours(node.patch, [&](const WaterRegionPatchDesc &next) {
+			const uint cost = node.cost + 1;
+			auto iter = best_nodes.find(GetWaterRegionPatchKey(next));
+			if (iter != best_nodes.end()) {
+				if (nodes[iter->second].cost <= cost) return;
+				iter->second = (uint)nodes.size();
+			} else {
+				best_nodes[GetWaterRegionPatchKey(next)] = (uint)nodes.size();
+			}
+			open.push({ cost + estimate(next), (uint)nodes.size() });
+			nodes.push_back({ next, cost, index });
+		});
+	}
+
+	return {};
+}
+
 template <class Types>
 class CYapfDestinationTileWaterT
 {
@@ -31,6 +105,9 @@ protected:
 	TrackdirBits m_destTrackdirs;
 	StationID    m_destStation;
 
+	std::vector<WaterRegionPatchDesc> m_water_region_corridor; ///< Water region patches the search is restricted to, empty if not restricted.
+	WaterRegionPatchDesc m_intermediate_dest{};                ///< Water region patch to search a path to instead of the destination, if valid.
+
 public:
 	void SetDestination(const Ship *v)
 	{
@@ -45,6 +122,66 @@ public:
 		}
 	}
 
+	/**
+	 * Restrict the search to the water regions along the high level path from the origin to the destination.
+	 * If the destination region is further away than WATER_REGION_LOOKAHEAD regions, search a path to the
+	 * region that far along the high level path instead. Nothing is restricted if there is no high level path.
+	 * @param v Ship.
+	 * @param origin_tile Tile the search starts at.
+	 */
+	void SetWaterRegionCorridor(const Ship *v, TileIndex origin_tile)
+	{
+		const WaterRegionPatchDesc start = GetWaterRegionPatchInfo(origin_tile);
+		if (!start.IsValid()) return;
+
+		std::vector<WaterRegionPatchDesc> goals;
+		auto add_goal = [&](TileIndex tile) {
+			const WaterRegionPatchDesc patch = GetWaterRegionPatchInfo(tile);
+			if (patch.IsValid() && std::find(goals.begin(), goals.end(), patch) == goals.end()) goals.push_back(patch);
+		};
+		if (m_destStation != INVALID_STATION) {
+			const Station *st = Station::GetIfValid(m_destStation);
+			if (st == nullptr) return;
+			for (TileIndex tile : st->docking_station) {
+				if (IsDockingTile(tile) && IsShipDestinationTile(tile, m_destStation)) add_goal(tile);
+			}
+		} else {
+			add_goal(m_destTile);
+		}
+		if (goals.empty() || std::find(goals.begin(), goals.end(), start) != goals.end()) return;
+
+		std::vector<WaterRegionPatchDesc> path = FindWaterRegionPath(start, goals, Yapf().PfGetSettings().max_search_nodes);
+		if (path.empty()) return;
+
+		if (path.size() > WATER_REGION_LOOKAHEAD + 1) {
+			path.resize(WATER_REGION_LOOKAHEAD + 1);
+			m_intermediate_dest = path.back();
+			m_destTile = GetWaterRegionCenterTile(m_intermediate_dest);
+		}
+		m_water_region_corridor = std::move(path);
+	}
+
+	/**
+	 * Check whether the search is restricted to a water region corridor.
+	 * @return True if the search is restricted.
+	 */
+	inline bool HasWaterRegionCorridor() const
+	{
+		return !m_water_region_corridor.empty();
+	}
+
+	/**
+	 * Check whether the search may enter a tile.
+	 * @param tile Tile to check.
+	 * @return True if the tile is within the water region corridor, or the search is not restricted.
+	 */
+	inline bool IsInWaterRegionCorridor(TileIndex tile) const
+	{
+		if (m_water_region_corridor.empty()) return true;
+		const WaterRegionPatchDesc patch = GetWaterRegionPatchInfo(tile);
+		return std::find(m_water_region_corridor.begin(), m_water_region_corridor.end(), patch) != m_water_region_corridor.end();
+	}
+
 protected:
 	/** to access inherited path finder */
 	inline Tpf& Yapf()
@@ -61,6 +198,10 @@ public:
 
 	inline bool PfDetectDestinationTile(TileIndex tile, Trackdir trackdir)
 	{
+		if (m_intermediate_dest.IsValid()) {
+			return GetWaterRegionPatchInfo(tile) == m_intermediate_dest;
+		}
+
 		if (m_destStation != INVALID_STATION) {
 			return IsDockingTile(tile) && IsShipDestinationTile(tile, m_destStation);
 		}
@@ -125,7 +266,7 @@ public:
 	inline void PfFollowNode(Node &old_node)
 	{
 		TrackFollower F(Yapf().GetVehicle());
-		if (F.Follow(old_node.m_key.m_tile, old_node.m_key.m_td)) {
+		if (F.Follow(old_node.m_key.m_tile, old_node.m_key.m_td) && Yapf().IsInWaterRegionCorridor(F.m_new_tile)) {
 			Yapf().AddMultipleNodes(&old_node, F);
 		}
 	}
@@ -137,6 +278,11 @@ public:
 	}
 
 	static Trackdir ChooseShipTrack(const Ship *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, ShipPathCache &path_cache)
+	{
+		return ChooseShipTrack(v, tile, enterdir, tracks, path_found, path_cache, _settings_game.pf.yapf.ship_water_regions);
+	}
+
+	static Trackdir ChooseShipTrack(const Ship *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, ShipPathCache &path_cache, bool use_water_regions)
 	{
 		/* handle special case - when next tile is destination tile */
 		if (tile == v->dest_tile) {
@@ -163,9 +309,15 @@ public:
 		/* set origin and destination nodes */
 		pf.SetOrigin(src_tile, trackdirs);
 		pf.SetDestination(v);
+		if (use_water_regions) pf.SetWaterRegionCorridor(v, src_tile);
 		/* find best path */
 		path_found = pf.FindPath(v);
 
+		if (!path_found && pf.HasWaterRegionCorridor()) {
+			/* The corridor may not be usable by this ship, e.g. if it would have to turn around, search without it instead */
+			return ChooseShipTrack(v, tile, enterdir, tracks, path_found, path_cache, false);
+		}
+
 		Trackdir next_trackdir = INVALID_TRACKDIR; // this would mean "path not found"
 
 		Node *pNode = pf.GetBestNode();
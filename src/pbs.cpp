@@ -859,6 +859,14 @@ void TrainReservationLookAhead::SetNextExtendPosition()
 	this->next_extend_position = this->current_position;
 }
 
+/**
+ * Check whether the end of a train's reservation lookahead is still consistent with the map.
+ * Only the end of the reservation needs to be checked: the lookahead is extended from its end tile,
+ * and any change to the track within the reserved path frees the whole reservation,
+ * which also clears the lookahead (see FreeTrainTrackReservation).
+ * @param v Train, which must have a lookahead.
+ * @return True if the lookahead can continue to be used and extended.
+ */
 bool ValidateLookAhead(const Train *v)
 {
 	TileIndex tile = v->lookahead->reservation_end_tile;
@@ -1155,6 +1163,14 @@ void SetTrainReservationLookaheadEnd(Train *v)
 	}
 }
 
+/**
+ * Create or extend a train's reservation lookahead.
+ * If the train already has a lookahead, only the part of the reservation beyond the current
+ * lookahead end is followed, and the new items are appended.
+ * Items which the train has passed are trimmed in AdvanceLookAheadPosition.
+ * Otherwise a new lookahead is created, by following the whole reservation from the train's position.
+ * @param v Train.
+ */
 void FillTrainReservationLookAhead(Train *v)
 {
 	TileIndex tile;
@@ -15,6 +15,7 @@
 #include "window_func.h"
 #include "company_func.h"
 #include "cmd_helper.h"
+#include "3rdparty/cpp-btree/btree_map.h"
 
 ProgramList _signal_programs;
 bool _cleaning_signal_programs = false;
@@ -43,23 +44,10 @@ struct SignalVM {
 	uint num_green;                 ///< Number of green exits from block
 	SignalProgram *program;         ///< The program being run
 
-	// Current state
-	SignalInstruction *instruction; ///< Instruction to execute next
-
 	// Output state
 	SignalState state;
 
-	void Execute()
-	{
-		DEBUG(misc, 6, "Begining execution of programmable pre-signal on tile %x, track %d",
-					this->program->tile, this->program->track);
-		do {
-			DEBUG(misc, 10, "  Executing instruction %d, opcode %d", this->instruction->Id(), this->instruction->Opcode());
-			this->instruction->Evaluate(*this);
-		} while (this->instruction);
-
-		DEBUG(misc, 6, "Completed");
-	}
+	void Execute();
 };
 
 // -- Conditions
@@ -337,10 +325,12 @@ SignalInstruction::SignalInstruction(SignalProgram *prog, SignalOpcode op)
 	: opcode(op), previous(nullptr), program(prog)
 {
 	program->instructions.push_back(this);
+	program->InvalidateCompiled();
 }
 
 SignalInstruction::~SignalInstruction()
 {
+	program->InvalidateCompiled();
 	auto pthis = std::find(program->instructions.begin(), program->instructions.end(), this);
 	assert(pthis != program->instructions.end());
 	program->instructions.erase(pthis);
@@ -376,16 +366,6 @@ SignalSpecial::SignalSpecial(SignalProgram *prog, SignalOpcode op)
 	last->previous = first;
 }
 
-void SignalSpecial::Evaluate(SignalVM &vm)
-{
-	if (this->opcode == PSO_FIRST) {
-		DEBUG(misc, 7, "  Executing First");
-		vm.instruction = this->next;
-	} else {
-		DEBUG(misc, 7, "  Executing Last");
-		vm.instruction = nullptr;
-	}
-}
 /*virtual*/ void SignalSpecial::SetNext(SignalInstruction *next_insn)
 {
 	this->next = next_insn;
@@ -417,12 +397,6 @@ SignalIf::PseudoInstruction::PseudoInstruction(SignalProgram *prog, SignalIf *bl
 	delete this;
 }
 
-/*virtual*/ void SignalIf::PseudoInstruction::Evaluate(SignalVM &vm)
-{
-	DEBUG(misc, 7, "  Executing If Pseudo Instruction %s", opcode == PSO_IF_ELSE ? "Else" : "Endif");
-	vm.instruction = this->block->after;
-}
-
 /*virtual*/ void SignalIf::PseudoInstruction::SetNext(SignalInstruction *next_insn)
 {
 	if (this->opcode == PSO_IF_ELSE) {
@@ -466,17 +440,7 @@ void SignalIf::SetCondition(SignalCondition *cond)
 	assert(cond != this->condition);
 	delete this->condition;
 	this->condition = cond;
-}
-
-/*virtual*/ void SignalIf::Evaluate(SignalVM &vm)
-{
-	bool is_true = this->condition->Evaluate(vm);
-	DEBUG(misc, 7, "  Executing If, taking %s branch", is_true ? "then" : "else");
-	if (is_true) {
-		vm.instruction = this->if_true;
-	} else {
-		vm.instruction = this->if_false;
-	}
+	this->program->InvalidateCompiled();
 }
 
 /*virtual*/ void SignalIf::SetNext(SignalInstruction *next_insn)
@@ -499,17 +463,115 @@ SignalSet::SignalSet(SignalProgram *prog, SignalState state)
 	delete this;
 }
 
-/*virtual*/ void SignalSet::Evaluate(SignalVM &vm)
+
+/*virtual*/ void SignalSet::SetNext(SignalInstruction *next_insn)
 {
-	DEBUG(misc, 7, "  Executing SetSignal, making %s", this->to_state? "green" : "red");
-	vm.state       = this->to_state;
-	vm.instruction = nullptr;
+	this->next = next_insn;
 }
 
+/**
+ * Build the flattened form of the program.
+ * Control flow through the start and If pseudo instructions is resolved, which leaves an op for each If and Set
+ * instruction, and for the end instruction, which leaves the signal red. Execution starts at the first op.
+ */
+void SignalProgram::Compile()
+{
+	btree::btree_map<const SignalInstruction *, uint16> op_index;
+
+	auto compile = [&](auto &compile, SignalInstruction *insn) -> uint16 {
+		/* Skip over the instructions which only redirect control flow */
+		for (;;) {
+			if (insn->Opcode() == PSO_FIRST) {
+				insn = static_cast<SignalSpecial *>(insn)->next;
+			} else if (insn->Opcode() == PSO_IF_ELSE || insn->Opcode() == PSO_IF_ENDIF) {
+				insn = static_cast<SignalIf::PseudoInstruction *>(insn)->block->after;
+			} else {
+				break;
+			}
+		}
 
-/*virtual*/ void SignalSet::SetNext(SignalInstruction *next_insn)
+		auto iter = op_index.find(insn);
+		if (iter != op_index.end()) return iter->second;
+
+		uint16 index = (uint16)this->compiled.size();
+		op_index[insn] = index;
+		this->compiled.push_back({ nullptr, 0, 0, SIGNAL_STATE_RED });
+
+		switch (insn->Opcode()) {
+			case PSO_LAST:
+				break;
+
+			case PSO_SET_SIGNAL:
+				this->compiled[index].state = static_cast<SignalSet *>(insn)->to_state;
+				break;
+
+			case PSO_IF: {
+				SignalIf *si = static_cast<SignalIf *>(insn);
+				this->compiled[index].condition = si->condition;
+				uint16 if_true = compile(compile, si->if_true);
+				uint16 if_false = compile(compile, si->if_false);
+				this->compiled[index].if_true = if_true;
+				this->compiled[index].if_false = if_false;
+				break;
+			}
+
+			default: NOT_REACHED();
+		}
+		return index;
+	};
+
+	this->compiled.clear();
+	compile(compile, this->first_instruction);
+}
+
+/**
+ * Evaluate a condition without going through the virtual call.
+ * @param cond Condition to evaluate.
+ * @param vm VM state.
+ * @return Result of the condition.
+ */
+static inline bool EvaluateSignalCondition(SignalCondition *cond, SignalVM &vm)
 {
-	this->next = next_insn;
+	switch (cond->ConditionCode()) {
+		case PSC_ALWAYS:
+		case PSC_NEVER:
+			return static_cast<SignalSimpleCondition *>(cond)->SignalSimpleCondition::Evaluate(vm);
+
+		case PSC_NUM_GREEN:
+		case PSC_NUM_RED:
+			return static_cast<SignalVariableCondition *>(cond)->SignalVariableCondition::Evaluate(vm);
+
+		case PSC_SIGNAL_STATE:
+			return static_cast<SignalStateCondition *>(cond)->SignalStateCondition::Evaluate(vm);
+
+		case PSC_SLOT_OCC:
+		case PSC_SLOT_OCC_REM:
+			return static_cast<SignalSlotCondition *>(cond)->SignalSlotCondition::Evaluate(vm);
+
+		case PSC_COUNTER:
+			return static_cast<SignalCounterCondition *>(cond)->SignalCounterCondition::Evaluate(vm);
+
+		default:
+			return cond->Evaluate(vm);
+	}
+}
+
+void SignalVM::Execute()
+{
+	DEBUG(misc, 6, "Begining execution of programmable pre-signal on tile %x, track %d",
+				this->program->tile, this->program->track);
+
+	if (this->program->compiled.empty()) this->program->Compile();
+
+	const SignalProgramOp *op = this->program->compiled.data();
+	while (op->condition != nullptr) {
+		bool is_true = EvaluateSignalCondition(op->condition, *this);
+		DEBUG(misc, 7, "  Executing If, taking %s branch", is_true ? "then" : "else");
+		op = &this->program->compiled[is_true ? op->if_true : op->if_false];
+	}
+	this->state = op->state;
+
+	DEBUG(misc, 6, "Completed");
 }
 
 SignalProgram *GetExistingSignalProgram(SignalReference ref)
@@ -567,7 +629,6 @@ SignalState RunSignalProgram(SignalReference ref, uint num_exits, uint num_green
 	vm.num_exits = num_exits;
 	vm.num_green = num_green;
 
-	vm.instruction = program->first_instruction;
 	vm.state = SIGNAL_STATE_RED;
 
 	DEBUG(misc, 7, "%d exits, of which %d green", vm.num_exits, vm.num_green);
@@ -768,6 +829,7 @@ CommandCost CmdModifySignalInstruction(TileIndex tile, DoCommandFlag flags, uint
 				return CommandCost();
 			SignalSet *ss = static_cast<SignalSet*>(insn);
 			ss->to_state = state;
+			prog->InvalidateCompiled();
 		} break;
 
 		case PSO_IF: {
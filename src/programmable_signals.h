@@ -25,6 +25,7 @@ struct SignalVM;
 
 class SignalInstruction;
 class SignalSpecial;
+class SignalCondition;
 typedef std::vector<SignalInstruction*> InstructionList;
 
 enum SignalProgramMgmtCode {
@@ -32,18 +33,31 @@ enum SignalProgramMgmtCode {
 	SPMC_CLONE,       ///< Clone program
 };
 
+/** Operation of the flattened form of a signal program, see SignalProgram::Compile. */
+struct SignalProgramOp {
+	SignalCondition *condition; ///< Condition of an If instruction, or nullptr if this op sets the signal state
+	uint16 if_true;             ///< Op to continue at if the condition is true
+	uint16 if_false;            ///< Op to continue at if the condition is false
+	SignalState state;          ///< State to set the signal to if there is no condition
+};
+
 /** The actual programmable pre-signal information */
 struct SignalProgram {
 	SignalProgram(TileIndex tile, Track track, bool raw = false);
 	~SignalProgram();
 	void DebugPrintProgram();
 
+	/** Discard the flattened form of the program, call this when the instructions or their links change. */
+	inline void InvalidateCompiled() { this->compiled.clear(); }
+	void Compile();
+
 	TileIndex tile;
 	Track track;
 
 	SignalSpecial *first_instruction;
 	SignalSpecial *last_instruction;
 	InstructionList instructions;
+	std::vector<SignalProgramOp> compiled; ///< NOSAVE: Flattened form of the program, empty if not compiled yet
 };
 
 /** Programmable Pre-Signal opcode.
@@ -83,9 +97,6 @@ public:
 	/// Insert this instruction, placing it before @p before_insn
 	virtual void Insert(SignalInstruction *before_insn);
 
-	/// Evaluate the instruction. The instruction should update the VM state.
-	virtual void Evaluate(SignalVM &vm) = 0;
-
 	/// Remove the instruction. When removing itself, an instruction should
 	/// <ul>
 	///   <li>Set next->previous to previous
@@ -287,12 +298,6 @@ public:
 	 */
 	SignalSpecial(SignalProgram *prog, SignalOpcode op);
 
-	/** Evaluates the instruction. If this is an Start instruction, flow will be
-	 * vectored to the first instruction; if it is an End instruction, the program
-	 * will terminate and the signal will be left red.
-	 */
-	virtual void Evaluate(SignalVM &vm);
-
 	/** Links the first and last instructions in the program. Generally only to be
 	 * called from the SignalProgram constructor.
 	 */
@@ -351,11 +356,6 @@ public:
 		 */
 		virtual void Remove();
 
-		/** Evaluate the pseudo instruction. This involves vectoring execution to
-		 * the instruction after the if.
-		 */
-		virtual void Evaluate(SignalVM &vm);
-
 		/** The block to which this instruction belongs */
 		SignalIf *block;
 		virtual void SetNext(SignalInstruction *next_insn);
@@ -371,9 +371,6 @@ public:
 	/** Sets the instruction's condition, and releases the old condition */
 	void SetCondition(SignalCondition *cond);
 
-	/** Evaluates the If and takes the appropriate branch */
-	virtual void Evaluate(SignalVM &vm);
-
 	virtual void Insert(SignalInstruction *before_insn);
 
 	/** Removes the If and all of its children */
@@ -393,7 +390,6 @@ public:
 	/// Constructs the instruction and sets the state the signal is to be set to
 	SignalSet(SignalProgram *prog, SignalState = SIGNAL_STATE_RED);
 
-	virtual void Evaluate(SignalVM &vm);
 	virtual void Remove();
 
 	/// The state to set the signal to
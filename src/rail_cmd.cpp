@@ -13,6 +13,7 @@
 #include "command_func.h"
 #include "depot_base.h"
 #include "pathfinder/yapf/yapf_cache.h"
+#include "pathfinder/water_regions.h"
 #include "newgrf_debug.h"
 #include "newgrf_railtype.h"
 #include "train.h"
@@ -895,6 +896,7 @@ CommandCost CmdBuildSingleRail(TileIndex tile, DoCommandFlag flags, uint32 p1, u
 				MakeRailNormal(tile, _current_company, trackbit, railtype);
 				if (water_ground) {
 					SetRailGroundType(tile, RAIL_GROUND_WATER);
+					InvalidateWaterRegion(tile);
 					if (IsPossibleDockingTile(tile)) CheckForDockingTile(tile);
 				}
 				Company::Get(_current_company)->infrastructure.rail[railtype]++;
@@ -1044,6 +1046,7 @@ CommandCost CmdRemoveSingleRail(TileIndex tile, DoCommandFlag flags, uint32 p1,
 						bool docking = IsDockingTile(tile);
 						MakeShore(tile);
 						SetDockingTile(tile, docking);
+						InvalidateWaterRegion(tile);
 					} else {
 						DoClearSquare(tile);
 					}
@@ -1173,6 +1176,7 @@ bool FloodHalftile(TileIndex t)
 			rail_bits = rail_bits & ~to_remove;
 			if (rail_bits == 0) {
 				MakeShore(t);
+				InvalidateWaterRegion(t);
 				MarkTileDirtyByTile(t);
 				return flooded;
 			}
@@ -1181,6 +1185,7 @@ bool FloodHalftile(TileIndex t)
 		if (IsNonContinuousFoundation(GetRailFoundation(tileh, rail_bits))) {
 			flooded = true;
 			SetRailGroundType(t, RAIL_GROUND_WATER);
+			InvalidateWaterRegion(t);
 			MarkTileDirtyByTile(t);
 		}
 	} else {
@@ -1189,6 +1194,7 @@ bool FloodHalftile(TileIndex t)
 			if (IsSteepSlope(tileh) || IsSlopeWithThreeCornersRaised(tileh)) {
 				flooded = true;
 				SetRailGroundType(t, RAIL_GROUND_WATER);
+				InvalidateWaterRegion(t);
 				MarkTileDirtyByTile(t, VMDF_NOT_MAP_MODE);
 			}
 		}
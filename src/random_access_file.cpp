@@ -14,6 +14,11 @@
 #include "fileio_func.h"
 #include "string_func.h"
 
+#if defined(UNIX)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #include "safeguards.h"
 
 /**
@@ -36,6 +41,21 @@ RandomAccessFile::RandomAccessFile(const std::string &filename, Subdirectory sub
 	this->simplified_filename = name_without_path.substr(0, name_without_path.rfind('.'));
 	strtolower(this->simplified_filename);
 
+#if defined(UNIX)
+	/* Map the whole file, so that reads do not need to go through the local buffer.
+	 * Only do this on 64 bit systems, as the address space needed for large NewGRF sets could be exhausted otherwise. */
+	if (sizeof(void *) >= 8) {
+		struct stat st;
+		if (fstat(fileno(this->file_handle), &st) == 0 && st.st_size > 0) {
+			void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fileno(this->file_handle), 0);
+			if (map != MAP_FAILED) {
+				this->map_base = static_cast<byte *>(map);
+				this->map_size = st.st_size;
+			}
+		}
+	}
+#endif
+
 	this->SeekTo((size_t)pos, SEEK_SET);
 }
 
@@ -44,6 +64,9 @@ RandomAccessFile::RandomAccessFile(const std::string &filename, Subdirectory sub
  */
 RandomAccessFile::~RandomAccessFile()
 {
+#if defined(UNIX)
+	if (this->map_base != nullptr) munmap(this->map_base, this->map_size);
+#endif
 	fclose(this->file_handle);
 }
 
@@ -84,6 +107,19 @@ void RandomAccessFile::SeekTo(size_t pos, int mode)
 {
 	if (mode == SEEK_CUR) pos += this->GetPos();
 
+	if (this->map_base != nullptr) {
+		/* Point the buffer directly at the mapped file, its end is the end of the file. */
+		if (pos < this->map_size) {
+			this->buffer = this->map_base + pos;
+			this->buffer_end = this->map_base + this->map_size;
+			this->pos = this->map_size;
+		} else {
+			this->buffer = this->buffer_end = this->map_base + this->map_size;
+			this->pos = pos;
+		}
+		return;
+	}
+
 	this->pos = pos;
 	if (fseek(this->file_handle, this->pos, SEEK_SET) < 0) {
 		DEBUG(misc, 0, "Seeking in %s failed", this->filename.c_str());
@@ -100,6 +136,9 @@ void RandomAccessFile::SeekTo(size_t pos, int mode)
 byte RandomAccessFile::ReadByteIntl()
 {
 	if (this->buffer == this->buffer_end) {
+		/* The whole file is mapped, so this is the end of the file. */
+		if (this->map_base != nullptr) return 0;
+
 		this->buffer = this->buffer_start;
 		size_t size = fread(this->buffer, 1, RandomAccessFile::BUFFER_SIZE, this->file_handle);
 		this->pos += size;
@@ -137,6 +176,14 @@ uint32 RandomAccessFile::ReadDwordIntl()
  */
 void RandomAccessFile::ReadBlock(void *ptr, size_t size)
 {
+	if (this->map_base != nullptr) {
+		size_t available = this->buffer_end - this->buffer;
+		if (size > available) size = available;
+		memcpy(ptr, this->buffer, size);
+		this->buffer += size;
+		return;
+	}
+
 	this->SeekTo(this->GetPos(), SEEK_SET);
 	this->pos += fread(ptr, 1, size, this->file_handle);
 }
@@ -31,8 +31,10 @@ class RandomAccessFile {
 	FILE *file_handle;               ///< File handle of the open file.
 	size_t pos;                      ///< Position in the file of the end of the read buffer.
 
-	byte *buffer;                    ///< Current position within the local buffer.
+	byte *buffer;                    ///< Current position within the local buffer, or the mapped file.
 	byte *buffer_end;                ///< Last valid byte of buffer.
+	byte *map_base = nullptr;        ///< Start of the memory-mapped file, or nullptr if the file is read via the local buffer.
+	size_t map_size = 0;             ///< Size of the memory-mapped file.
 	byte buffer_start[BUFFER_SIZE];  ///< Local buffer when read from file.
 
 	byte ReadByteIntl();
@@ -82,6 +82,8 @@ void ResetRoadTypes()
 
 	_roadtypes_hidden_mask = ROADTYPES_NONE;
 	_roadtypes_type        = ROADTYPES_TRAM;
+
+	InvalidateTownRoadTypeCache();
 }
 
 void ResolveRoadTypeGUISprites(RoadTypeInfo *rti)
@@ -139,6 +141,8 @@ void InitRoadTypes()
 
 void InitRoadTypesCaches()
 {
+	InvalidateTownRoadTypeCache();
+
 	std::fill(_collision_mode_roadtypes.begin(), _collision_mode_roadtypes.end(), ROADTYPES_NONE);
 	_roadtypes_non_train_colliding = ROADTYPES_NONE;
 
@@ -427,6 +431,9 @@ void RecalculateRoadCachedOneWayStates()
 
 void UpdateRoadCachedOneWayStatesAroundTile(TileIndex tile)
 {
+	/* This is called after all road layout changes, so use it to also invalidate the segment cost cache. */
+	YapfNotifyRoadLayoutChange(tile);
+
 	if (_generating_world) return;
 
 	auto check_tile = [](TileIndex t) {
@@ -1755,6 +1762,7 @@ CommandCost CmdBuildRoadDepot(TileIndex tile, DoCommandFlag flags, uint32 p1, ui
 		UpdateCompanyRoadInfrastructure(rt, _current_company, ROAD_DEPOT_TRACKBIT_FACTOR);
 
 		MakeRoadDepot(tile, _current_company, dep->index, dir, rt);
+		YapfNotifyRoadLayoutChange(tile);
 		MarkTileDirtyByTile(tile);
 		MakeDefaultName(dep);
 
@@ -1787,6 +1795,7 @@ static CommandCost RemoveRoadDepot(TileIndex tile, DoCommandFlag flags)
 		delete Depot::GetByTile(tile);
 		DoClearSquare(tile);
 
+		YapfNotifyRoadLayoutChange(tile);
 		NotifyRoadLayoutChanged(false);
 		DeleteNewGRFInspectWindow(GSF_ROADTYPES, tile);
 	}
@@ -2888,6 +2897,9 @@ static VehicleEnterTileStatus VehicleEnter_Road(Vehicle *v, TileIndex tile, int
 
 static void ChangeTileOwner_Road(TileIndex tile, Owner old_owner, Owner new_owner)
 {
+	/* Road depot and road stop access depends on the owner. */
+	YapfNotifyRoadLayoutChange(tile);
+
 	if (IsRoadDepot(tile)) {
 		if (GetTileOwner(tile) == old_owner) {
 			if (new_owner == INVALID_OWNER) {
@@ -3161,6 +3173,7 @@ CommandCost CmdConvertRoad(TileIndex tile, DoCommandFlag flags, uint32 p1, uint3
 
 				/* Perform the conversion */
 				SetRoadType(tile, rtt, to_type);
+				YapfNotifyRoadLayoutChange(tile);
 				MarkTileDirtyByTile(tile);
 
 				/* update power of train on this tile */
@@ -3237,6 +3250,7 @@ CommandCost CmdConvertRoad(TileIndex tile, DoCommandFlag flags, uint32 p1, uint3
 				/* Perform the conversion */
 				SetRoadType(tile, rtt, to_type);
 				if (include_middle) SetRoadType(endtile, rtt, to_type);
+				YapfNotifyRoadLayoutChange(tile);
 
 				FindVehicleOnPos(tile, VEH_ROAD, &affected_rvs, &UpdateRoadVehPowerProc);
 				FindVehicleOnPos(endtile, VEH_ROAD, &affected_rvs, &UpdateRoadVehPowerProc);
@@ -13,6 +13,7 @@
 #include "roadstop_base.h"
 #include "station_base.h"
 #include "vehicle_func.h"
+#include "3rdparty/robin_hood/robin_hood.h"
 
 #include "safeguards.h"
 
@@ -20,6 +21,9 @@
 RoadStopPool _roadstop_pool("RoadStop");
 INSTANTIATE_POOL_METHODS(RoadStop)
 
+/** Road stops by tile, filled when a road stop is first looked up by RoadStop::GetByTile. */
+static robin_hood::unordered_flat_map<TileIndex, RoadStop *> _roadstop_tile_cache;
+
 /**
  * De-Initializes RoadStops.
  */
@@ -31,7 +35,12 @@ RoadStop::~RoadStop()
 		delete this->west;
 	}
 
-	if (CleaningPool()) return;
+	if (CleaningPool()) {
+		_roadstop_tile_cache.clear();
+		return;
+	}
+
+	_roadstop_tile_cache.erase(this->xy);
 }
 
 /**
@@ -362,10 +371,19 @@ bool RoadStop::Enter(RoadVehicle *rv)
  */
 /* static */ RoadStop *RoadStop::GetByTile(TileIndex tile, RoadStopType type)
 {
+	auto iter = _roadstop_tile_cache.find(tile);
+	if (iter != _roadstop_tile_cache.end()) {
+		dbg_assert(iter->second->xy == tile);
+		return iter->second;
+	}
+
 	const Station *st = Station::GetByTile(tile);
 
 	for (RoadStop *rs = st->GetPrimaryRoadStop(type);; rs = rs->next) {
-		if (rs->xy == tile) return rs;
+		if (rs->xy == tile) {
+			_roadstop_tile_cache[tile] = rs;
+			return rs;
+		}
 		assert(rs->next != nullptr);
 	}
 }
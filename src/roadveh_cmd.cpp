@@ -35,6 +35,7 @@
 #include "newgrf.h"
 #include "zoom_func.h"
 #include "framerate_type.h"
+#include "vehicle_profile.h"
 #include "scope_info.h"
 #include "string_func.h"
 #include "core/checksum_func.hpp"
@@ -696,15 +697,17 @@ static Vehicle *EnumCheckRoadVehClose(Vehicle *v, void *data)
 	short x_diff = v->x_pos - rvf->x;
 	short y_diff = v->y_pos - rvf->y;
 
-	if (!v->IsInDepot() &&
-			abs(v->z_pos - rvf->veh->z_pos) < 6 &&
-			v->direction == rvf->dir &&
-			rvf->veh->First() != v->First() &&
-			HasBit(_collision_mode_roadtypes[rvf->collision_mode], RoadVehicle::From(v)->roadtype) &&
+	/* Check the direction and the position window first, these only use fields of the candidate
+	 * vehicle itself and reject almost all vehicles in the searched hash chains. */
+	if (v->direction == rvf->dir &&
 			(dist_x[v->direction] >= 0 || (x_diff > dist_x[v->direction] && x_diff <= 0)) &&
 			(dist_x[v->direction] <= 0 || (x_diff < dist_x[v->direction] && x_diff >= 0)) &&
 			(dist_y[v->direction] >= 0 || (y_diff > dist_y[v->direction] && y_diff <= 0)) &&
-			(dist_y[v->direction] <= 0 || (y_diff < dist_y[v->direction] && y_diff >= 0))) {
+			(dist_y[v->direction] <= 0 || (y_diff < dist_y[v->direction] && y_diff >= 0)) &&
+			abs(v->z_pos - rvf->veh->z_pos) < 6 &&
+			!v->IsInDepot() &&
+			rvf->veh->First() != v->First() &&
+			HasBit(_collision_mode_roadtypes[rvf->collision_mode], RoadVehicle::From(v)->roadtype)) {
 		uint diff = abs(x_diff) + abs(y_diff);
 
 		if (diff < rvf->best_diff || (diff == rvf->best_diff && v->index < rvf->best->index)) {
@@ -1163,6 +1166,9 @@ static int PickRandomBit(uint bits)
  */
 static Trackdir RoadFindPathToDest(RoadVehicle *v, TileIndex tile, DiagDirection enterdir)
 {
+	PerformanceAccumulator framerate(PFE_GL_ROADVEH_PF);
+	VehicleProfileScope profile(v, VPC_PATHFINDING);
+
 #define return_track(x) { best_track = (Trackdir)x; goto found_best_track; }
 
 	TileIndex desttile;
@@ -1394,6 +1400,9 @@ static Trackdir FollowPreviousRoadVehicle(const RoadVehicle *v, const RoadVehicl
 		} else {
 			return INVALID_TRACKDIR;
 		}
+
+		/* The previous vehicle is on this trackdir of the tile, so the road bits for it are present. */
+		if (prev->tile == tile) return dir;
 	}
 
 	/* Do some sanity checking. */
@@ -73,12 +73,14 @@
 #include "../newgrf_industrytiles.h"
 #include "../timer/timer.h"
 #include "../timer/timer_game_tick.h"
+#include "../worker_thread.h"
 
 
 #include "saveload_internal.h"
 
 #include <signal.h>
 #include <algorithm>
+#include <chrono>
 
 #include "../safeguards.h"
 
@@ -234,11 +236,16 @@ static inline RailType UpdateRailType(RailType rt, RailType min)
  */
 void UpdateAllVirtCoords()
 {
-	UpdateAllStationVirtCoords();
-	UpdateAllSignVirtCoords();
-	UpdateAllTownVirtCoords();
+	{
+		ViewportSignKdtreeBatchUpdate batch;
+		UpdateAllStationVirtCoords();
+		UpdateAllSignVirtCoords();
+		UpdateAllTownVirtCoords();
+	}
 	UpdateAllTextEffectVirtCoords();
-	RebuildViewportKdtree();
+
+	/* The batch only rebuilds the kd-tree if it was valid to begin with */
+	if (!_viewport_sign_kdtree_valid) RebuildViewportKdtree();
 }
 
 void ClearAllCachedNames()
@@ -257,6 +264,20 @@ void ClearAllCachedNames()
  * had been made.
  * Moving this out of there is both cleaner and less bug-prone.
  */
+/** Scoped timer reporting the duration of an after load step at sl debug level 2, to profile load and join times. */
+struct AfterLoadStepTimer {
+	const char *name;                                  ///< Name of the step.
+	std::chrono::steady_clock::time_point start_time;  ///< Time the step started.
+
+	AfterLoadStepTimer(const char *name) : name(name), start_time(std::chrono::steady_clock::now()) {}
+
+	~AfterLoadStepTimer()
+	{
+		auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - this->start_time);
+		DEBUG(sl, 2, "After load: %s took %u us", this->name, (uint)duration.count());
+	}
+};
+
 static void InitializeWindowsAndCaches()
 {
 	SetupTimeSettings();
@@ -663,6 +684,8 @@ static void StartScripts()
  */
 bool AfterLoadGame()
 {
+	AfterLoadStepTimer total_timer("all steps");
+
 	SetSignalHandlers();
 
 	TileIndex map_size = MapSize();
@@ -679,8 +702,13 @@ bool AfterLoadGame()
 	GamelogTestRevision();
 	GamelogTestMode();
 
-	RebuildTownKdtree();
-	RebuildStationKdtree();
+	{
+		/* These only read their own pool and build their own tree. */
+		AfterLoadStepTimer timer("town and station kd-trees");
+		WorkerTaskGroup group;
+		group.Run(RebuildTownKdtree);
+		RebuildStationKdtree();
+	}
 	UpdateCachedSnowLine();
 	UpdateCachedSnowLineBounds();
 
@@ -1012,7 +1040,10 @@ bool AfterLoadGame()
 	AnalyseHouseSpriteGroups();
 
 	/* Update all vehicles */
-	AfterLoadVehicles(true);
+	{
+		AfterLoadStepTimer timer("vehicles");
+		AfterLoadVehicles(true);
+	}
 
 	CargoPacket::PostVehiclesAfterLoad();
 
@@ -1763,6 +1794,7 @@ bool AfterLoadGame()
 	}
 
 	YapfNotifyTrackLayoutChange(INVALID_TILE, INVALID_TRACK);
+	YapfNotifyRoadLayoutChange(INVALID_TILE);
 
 	if (IsSavegameVersionBefore(SLV_34)) {
 		for (Company *c : Company::Iterate()) ResetCompanyLivery(c);
@@ -1773,7 +1805,10 @@ bool AfterLoadGame()
 		c->avail_roadtypes = GetCompanyRoadTypes(c->index);
 	}
 
-	AfterLoadStations();
+	{
+		AfterLoadStepTimer timer("stations");
+		AfterLoadStations();
+	}
 
 	/* Time starts at 0 instead of 1920.
 	 * Account for this in older games by adding an offset */
@@ -1870,7 +1905,10 @@ bool AfterLoadGame()
 	}
 
 	/* Check and update house and town values */
-	UpdateHousesAndTowns(gcf_res != GLC_ALL_GOOD, true);
+	{
+		AfterLoadStepTimer timer("houses and towns");
+		UpdateHousesAndTowns(gcf_res != GLC_ALL_GOOD, true);
+	}
 
 	if (IsSavegameVersionBefore(SLV_43)) {
 		for (TileIndex t = 0; t < map_size; t++) {
@@ -4216,8 +4254,13 @@ bool AfterLoadGame()
 	InitializeRoadGUI();
 
 	/* This needs to be done after conversion. */
-	RebuildViewportKdtree();
-	ViewportMapBuildTunnelCache();
+	{
+		/* The sign tree only reads station, town and sign positions, the tunnel cache only the tunnel pool. */
+		AfterLoadStepTimer timer("viewport sign kd-tree and tunnel cache");
+		WorkerTaskGroup group;
+		group.Run(RebuildViewportKdtree);
+		ViewportMapBuildTunnelCache();
+	}
 
 	/* Road stops is 'only' updating some caches */
 	AfterLoadRoadStops();
@@ -4231,11 +4274,17 @@ bool AfterLoadGame()
 
 	SetupTickRate();
 
-	InitializeWindowsAndCaches();
+	{
+		AfterLoadStepTimer timer("windows and caches");
+		InitializeWindowsAndCaches();
+	}
 	/* Restore the signals */
 	ResetSignalHandlers();
 
-	AfterLoadLinkGraphs();
+	{
+		AfterLoadStepTimer timer("link graphs");
+		AfterLoadLinkGraphs();
+	}
 
 	AfterLoadTraceRestrict();
 	AfterLoadTemplateVehiclesUpdate();
@@ -4246,6 +4295,8 @@ bool AfterLoadGame()
 	InvalidateVehicleTickCaches();
 	ClearVehicleTickCaches();
 
+	RebuildStationsWithLoadingVehicles();
+
 	UpdateAllVehiclesIsDrawn();
 
 	extern void YapfCheckRailSignalPenalties();
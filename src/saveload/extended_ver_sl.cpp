@@ -123,7 +123,7 @@ const SlxiSubChunkInfo _sl_xv_sub_chunk_infos[] = {
 	{ XSLFI_VEHICLE_FLAGS_EXTRA,              XSCF_NULL,                1,   1, "veh_flags_extra",                  nullptr, nullptr, nullptr          },
 	{ XSLFI_TRAIN_THROUGH_LOAD,               XSCF_NULL,                2,   2, "train_through_load",               nullptr, nullptr, nullptr          },
 	{ XSLFI_ORDER_EXTRA_DATA,                 XSCF_NULL,                2,   2, "order_extra_data",                 nullptr, nullptr, nullptr          },
-	{ XSLFI_WHOLE_MAP_CHUNK,                  XSCF_NULL,                2,   2, "whole_map_chunk",                  nullptr, nullptr, "WMAP"           },
+	{ XSLFI_WHOLE_MAP_CHUNK,                  XSCF_NULL,                3,   3, "whole_map_chunk",                  nullptr, nullptr, "WMAP"           },
 	{ XSLFI_ST_LAST_VEH_TYPE,                 XSCF_NULL,                1,   1, "station_last_veh_type",            nullptr, nullptr, nullptr          },
 	{ XSLFI_SELL_AT_DEPOT_ORDER,              XSCF_NULL,                1,   1, "sell_at_depot_order",              nullptr, nullptr, nullptr          },
 	{ XSLFI_BUY_LAND_RATE_LIMIT,              XSCF_NULL,                1,   1, "buy_land_rate_limit",              nullptr, nullptr, nullptr          },
@@ -189,6 +189,10 @@ const SlxiSubChunkInfo _sl_xv_sub_chunk_infos[] = {
 	{ XSLFI_REMAIN_NEXT_ORDER_STATION,        XSCF_IGNORABLE_UNKNOWN,   1,   1, "remain_next_order_station",        nullptr, nullptr, nullptr          },
 	{ XSLFI_LABEL_ORDERS,                     XSCF_NULL,                2,   2, "label_orders",                     nullptr, nullptr, nullptr          },
 	{ XSLFI_VARIABLE_TICK_RATE,               XSCF_IGNORABLE_ALL,       1,   1, "variable_tick_rate",               nullptr, nullptr, nullptr          },
+	{ XSLFI_LINKGRAPH_WARM_START,             XSCF_NULL,                1,   1, "linkgraph_warm_start",             nullptr, nullptr, nullptr          },
+	{ XSLFI_LINKGRAPH_PARALLEL_MCF,           XSCF_NULL,                1,   1, "linkgraph_parallel_mcf",           nullptr, nullptr, nullptr          },
+	{ XSLFI_SHIP_WATER_REGIONS,               XSCF_IGNORABLE_UNKNOWN,   1,   1, "ship_water_regions",               nullptr, nullptr, nullptr          },
+	{ XSLFI_RAIL_PATHFIND_BATCH,              XSCF_IGNORABLE_UNKNOWN,   1,   1, "rail_pathfind_batch",              nullptr, nullptr, nullptr          },
 	{ XSLFI_SCRIPT_INT64,                     XSCF_NULL,                1,   1, "script_int64",                     nullptr, nullptr, nullptr          },
 	{ XSLFI_U64_TICK_COUNTER,                 XSCF_NULL,                1,   1, "u64_tick_counter",                 nullptr, nullptr, nullptr          },
 	{ XSLFI_LINKGRAPH_TRAVEL_TIME,            XSCF_NULL,                1,   1, "linkgraph_travel_time",            nullptr, nullptr, nullptr          },
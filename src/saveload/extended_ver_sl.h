@@ -140,6 +140,10 @@ enum SlXvFeatureIndex {
 	XSLFI_REMAIN_NEXT_ORDER_STATION,              ///< Remain in station if next order is for same station
 	XSLFI_LABEL_ORDERS,                           ///< Label orders
 	XSLFI_VARIABLE_TICK_RATE,                     ///< Variable tick rate
+	XSLFI_LINKGRAPH_WARM_START,                   ///< Link graph MCF warm start setting and job flow seeds
+	XSLFI_LINKGRAPH_PARALLEL_MCF,                 ///< Link graph MCF parallel batch setting
+	XSLFI_SHIP_WATER_REGIONS,                     ///< Ship pathfinder water regions setting
+	XSLFI_RAIL_PATHFIND_BATCH,                    ///< Train pathfinder batching setting
 
 	XSLFI_SCRIPT_INT64,                           ///< See: SLV_SCRIPT_INT64
 	XSLFI_U64_TICK_COUNTER,                       ///< See: SLV_U64_TICK_COUNTER
@@ -215,6 +215,35 @@ void Load_LinkGraph(LinkGraph &lg)
 	}
 }
 
+/**
+ * Save the warm start flow hops of a link graph job.
+ * @param lgj LinkGraphJob to be saved.
+ */
+void Save_LinkGraphJobWarmStartHops(LinkGraphJob *lgj)
+{
+	SlWriteUint32((uint32)lgj->warm_start_hops.size());
+	for (const LinkGraphJob::WarmStartHop &hop : lgj->warm_start_hops) {
+		SlWriteUint16(hop.node);
+		SlWriteUint16(hop.origin);
+		SlWriteUint16(hop.via);
+	}
+}
+
+/**
+ * Load the warm start flow hops of a link graph job.
+ * @param lgj LinkGraphJob to be loaded.
+ */
+void Load_LinkGraphJobWarmStartHops(LinkGraphJob *lgj)
+{
+	uint32 count = SlReadUint32();
+	lgj->warm_start_hops.resize(count);
+	for (LinkGraphJob::WarmStartHop &hop : lgj->warm_start_hops) {
+		hop.node = SlReadUint16();
+		hop.origin = SlReadUint16();
+		hop.via = SlReadUint16();
+	}
+}
+
 /**
  * Save a link graph job.
  * @param lgj LinkGraphJob to be saved.
@@ -225,6 +254,7 @@ static void DoSave_LGRJ(LinkGraphJob *lgj)
 	_num_nodes = lgj->Size();
 	SlObjectSaveFiltered(const_cast<LinkGraph *>(&lgj->Graph()), GetLinkGraphDesc()); // GetLinkGraphDesc has no conditionals
 	Save_LinkGraph(const_cast<LinkGraph &>(lgj->Graph()));
+	Save_LinkGraphJobWarmStartHops(lgj);
 }
 
 /**
@@ -279,6 +309,9 @@ static void Load_LGRJ()
 		SlObjectLoadFiltered(&lg, GetLinkGraphDesc()); // GetLinkGraphDesc has no conditionals
 		lg.Init(_num_nodes);
 		Load_LinkGraph(lg);
+		if (SlXvIsFeaturePresent(XSLFI_LINKGRAPH_WARM_START)) {
+			Load_LinkGraphJobWarmStartHops(lgj);
+		}
 	}
 }
 
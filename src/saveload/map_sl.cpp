@@ -211,15 +211,129 @@ static void Load_MAP8()
 	}
 }
 
+/** Transform applied to a byte plane of the whole map chunk, from XSLFI_WHOLE_MAP_CHUNK version 3. */
+enum WholeMapPlaneTransform {
+	WMPT_XOR_PREV_ROW,    ///< Stored as the XOR with the same byte of the tile one row before, the first row is stored as is.
+	WMPT_DELTA_PREV_TILE, ///< Stored as the difference with the same byte of the previous tile index.
+};
+
+#define WMAP_PLANE(name, field) \
+	struct name { \
+		static byte Get(TileIndex t) { return field; } \
+		static void Set(TileIndex t, byte v) { field = v; } \
+	};
+#define WMAP_PLANE_16(name, field, shift) \
+	struct name { \
+		static byte Get(TileIndex t) { return GB(field, shift, 8); } \
+		static void Set(TileIndex t, byte v) { SB(field, shift, 8, v); } \
+	};
+
+WMAP_PLANE(WMAP_Type, _m[t].type)
+WMAP_PLANE(WMAP_Height, _m[t].height)
+WMAP_PLANE_16(WMAP_M2Lo, _m[t].m2, 0)
+WMAP_PLANE_16(WMAP_M2Hi, _m[t].m2, 8)
+WMAP_PLANE(WMAP_M1, _m[t].m1)
+WMAP_PLANE(WMAP_M3, _m[t].m3)
+WMAP_PLANE(WMAP_M4, _m[t].m4)
+WMAP_PLANE(WMAP_M5, _m[t].m5)
+WMAP_PLANE(WMAP_M6, _me[t].m6)
+WMAP_PLANE(WMAP_M7, _me[t].m7)
+WMAP_PLANE_16(WMAP_M8Lo, _me[t].m8, 0)
+WMAP_PLANE_16(WMAP_M8Hi, _me[t].m8, 8)
+
+#undef WMAP_PLANE
+#undef WMAP_PLANE_16
+
+/**
+ * Save a single transformed byte plane of the whole map chunk.
+ * @tparam F Plane accessor.
+ * @tparam transform Transform to apply before writing.
+ * @param dumper The dumper to write to.
+ */
+template <typename F, WholeMapPlaneTransform transform>
+static void Save_WMAP_Plane(MemoryDumper *dumper)
+{
+	std::array<byte, MAP_SL_BUF_SIZE> buf;
+	const TileIndex size = MapSize();
+	const uint row = MapSizeX();
+	byte prev = 0;
+
+	for (TileIndex i = 0; i != size;) {
+		for (uint j = 0; j != MAP_SL_BUF_SIZE; j++, i++) {
+			const byte value = F::Get(i);
+			switch (transform) {
+				case WMPT_XOR_PREV_ROW:
+					buf[j] = value ^ (i >= row ? F::Get(i - row) : 0);
+					break;
+
+				case WMPT_DELTA_PREV_TILE:
+					buf[j] = (byte)(value - prev);
+					prev = value;
+					break;
+			}
+		}
+		dumper->CopyBytes(buf.data(), MAP_SL_BUF_SIZE);
+	}
+}
+
+/**
+ * Load a single transformed byte plane of the whole map chunk.
+ * @tparam F Plane accessor.
+ * @tparam transform Transform to reverse after reading.
+ * @param reader The reader to read from.
+ */
+template <typename F, WholeMapPlaneTransform transform>
+static void Load_WMAP_Plane(ReadBuffer *reader)
+{
+	std::array<byte, MAP_SL_BUF_SIZE> buf;
+	const TileIndex size = MapSize();
+	const uint row = MapSizeX();
+	byte prev = 0;
+
+	for (TileIndex i = 0; i != size;) {
+		reader->CopyBytes(buf.data(), MAP_SL_BUF_SIZE);
+		for (uint j = 0; j != MAP_SL_BUF_SIZE; j++, i++) {
+			switch (transform) {
+				case WMPT_XOR_PREV_ROW:
+					F::Set(i, buf[j] ^ (i >= row ? F::Get(i - row) : 0));
+					break;
+
+				case WMPT_DELTA_PREV_TILE:
+					prev = (byte)(prev + buf[j]);
+					F::Set(i, prev);
+					break;
+			}
+		}
+	}
+}
+
 static void Load_WMAP()
 {
 	static_assert(sizeof(Tile) == 8);
 	static_assert(sizeof(TileExtended) == 4);
-	assert(_sl_xv_feature_versions[XSLFI_WHOLE_MAP_CHUNK] == 1 || _sl_xv_feature_versions[XSLFI_WHOLE_MAP_CHUNK] == 2);
+	assert(_sl_xv_feature_versions[XSLFI_WHOLE_MAP_CHUNK] >= 1 && _sl_xv_feature_versions[XSLFI_WHOLE_MAP_CHUNK] <= 3);
 
 	ReadBuffer *reader = ReadBuffer::GetCurrent();
 	const TileIndex size = MapSize();
 
+	if (_sl_xv_feature_versions[XSLFI_WHOLE_MAP_CHUNK] >= 3) {
+		/* Planes in save order, keep in sync with Save_WMAP. Heights mostly change by a constant step along a row,
+		 * all other fields mostly repeat the row before. */
+		Load_WMAP_Plane<WMAP_Type, WMPT_XOR_PREV_ROW>(reader);
+		Load_WMAP_Plane<WMAP_Height, WMPT_DELTA_PREV_TILE>(reader);
+		Load_WMAP_Plane<WMAP_M2Lo, WMPT_XOR_PREV_ROW>(reader);
+		Load_WMAP_Plane<WMAP_M2Hi, WMPT_XOR_PREV_ROW>(reader);
+		Load_WMAP_Plane<WMAP_M1, WMPT_XOR_PREV_ROW>(reader);
+		Load_WMAP_Plane<WMAP_M3, WMPT_XOR_PREV_ROW>(reader);
+		Load_WMAP_Plane<WMAP_M4, WMPT_XOR_PREV_ROW>(reader);
+		Load_WMAP_Plane<WMAP_M5, WMPT_XOR_PREV_ROW>(reader);
+		Load_WMAP_Plane<WMAP_M6, WMPT_XOR_PREV_ROW>(reader);
+		Load_WMAP_Plane<WMAP_M7, WMPT_XOR_PREV_ROW>(reader);
+		Load_WMAP_Plane<WMAP_M8Lo, WMPT_XOR_PREV_ROW>(reader);
+		Load_WMAP_Plane<WMAP_M8Hi, WMPT_XOR_PREV_ROW>(reader);
+		return;
+	}
+
 #if TTD_ENDIAN == TTD_LITTLE_ENDIAN
 	reader->CopyBytes((byte *) _m, size * 8);
 #else
@@ -263,37 +377,24 @@ static void Load_WMAP()
 
 static void Save_WMAP()
 {
-	static_assert(sizeof(Tile) == 8);
-	static_assert(sizeof(TileExtended) == 4);
-	assert(_sl_xv_feature_versions[XSLFI_WHOLE_MAP_CHUNK] == 2);
+	assert(_sl_xv_feature_versions[XSLFI_WHOLE_MAP_CHUNK] == 3);
 
 	MemoryDumper *dumper = MemoryDumper::GetCurrent();
-	const TileIndex size = MapSize();
-	SlSetLength(size * 12);
-
-#if TTD_ENDIAN == TTD_LITTLE_ENDIAN
-	dumper->CopyBytes((byte *) _m, size * 8);
-	dumper->CopyBytes((byte *) _me, size * 4);
-#else
-	for (TileIndex i = 0; i != size; i++) {
-		dumper->CheckBytes(8);
-		dumper->RawWriteByte(_m[i].type);
-		dumper->RawWriteByte(_m[i].height);
-		dumper->RawWriteByte(GB(_m[i].m2, 0, 8));
-		dumper->RawWriteByte(GB(_m[i].m2, 8, 8));
-		dumper->RawWriteByte(_m[i].m1);
-		dumper->RawWriteByte(_m[i].m3);
-		dumper->RawWriteByte(_m[i].m4);
-		dumper->RawWriteByte(_m[i].m5);
-	}
-	for (TileIndex i = 0; i != size; i++) {
-		dumper->CheckBytes(4);
-		dumper->RawWriteByte(_me[i].m6);
-		dumper->RawWriteByte(_me[i].m7);
-		dumper->RawWriteByte(GB(_me[i].m8, 0, 8));
-		dumper->RawWriteByte(GB(_me[i].m8, 8, 8));
-	}
-#endif
+	SlSetLength(MapSize() * 12);
+
+	/* Planes in load order, keep in sync with Load_WMAP. */
+	Save_WMAP_Plane<WMAP_Type, WMPT_XOR_PREV_ROW>(dumper);
+	Save_WMAP_Plane<WMAP_Height, WMPT_DELTA_PREV_TILE>(dumper);
+	Save_WMAP_Plane<WMAP_M2Lo, WMPT_XOR_PREV_ROW>(dumper);
+	Save_WMAP_Plane<WMAP_M2Hi, WMPT_XOR_PREV_ROW>(dumper);
+	Save_WMAP_Plane<WMAP_M1, WMPT_XOR_PREV_ROW>(dumper);
+	Save_WMAP_Plane<WMAP_M3, WMPT_XOR_PREV_ROW>(dumper);
+	Save_WMAP_Plane<WMAP_M4, WMPT_XOR_PREV_ROW>(dumper);
+	Save_WMAP_Plane<WMAP_M5, WMPT_XOR_PREV_ROW>(dumper);
+	Save_WMAP_Plane<WMAP_M6, WMPT_XOR_PREV_ROW>(dumper);
+	Save_WMAP_Plane<WMAP_M7, WMPT_XOR_PREV_ROW>(dumper);
+	Save_WMAP_Plane<WMAP_M8Lo, WMPT_XOR_PREV_ROW>(dumper);
+	Save_WMAP_Plane<WMAP_M8Hi, WMPT_XOR_PREV_ROW>(dumper);
 }
 
 struct MAPT {
@@ -32,6 +32,7 @@
 #include "../vehicle_base.h"
 #include "../company_func.h"
 #include "../date_func.h"
+#include "../command_func.h"
 #include "../autoreplace_base.h"
 #include "../roadstop_base.h"
 #include "../linkgraph/linkgraph.h"
@@ -44,7 +45,9 @@
 #include "../fios.h"
 #include "../error.h"
 #include "../scope.h"
+#include "../worker_thread.h"
 #include <atomic>
+#include <chrono>
 #include <deque>
 #include <string>
 #ifdef __EMSCRIPTEN__
@@ -70,6 +73,14 @@
 #include "../3rdparty/mingw-std-threads/mingw.mutex.h"
 #include "../3rdparty/mingw-std-threads/mingw.condition_variable.h"
 #endif
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+#if defined(UNIX)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 #include "../safeguards.h"
 
@@ -177,6 +188,43 @@ void MemoryDumper::AllocateBuffer()
 	this->bufe = this->buf + MEMORY_CHUNK_SIZE;
 }
 
+/**
+ * Copy a large amount of bytes into the dumper.
+ * The blocks needed are allocated up front, and then filled concurrently by the worker threads.
+ * The resulting blocks are the same as those of a serial copy.
+ * @param ptr Bytes to copy.
+ * @param length Number of bytes to copy.
+ */
+void MemoryDumper::CopyBytesParallel(const byte *ptr, size_t length)
+{
+	assert(this->saved_buf == nullptr);
+
+	struct CopyJob {
+		byte *dst;
+		const byte *src;
+		size_t size;
+	};
+	std::vector<CopyJob> jobs;
+	jobs.reserve((length / MEMORY_CHUNK_SIZE) + 2);
+
+	while (length) {
+		if (this->buf == this->bufe) {
+			this->AllocateBuffer();
+		}
+		size_t to_copy = std::min<size_t>(this->bufe - this->buf, length);
+		jobs.push_back({ this->buf, ptr, to_copy });
+		this->buf += to_copy;
+		ptr += to_copy;
+		length -= to_copy;
+	}
+
+	const uint workers = _general_worker_pool.GetWorkerCount();
+	WorkerTaskGroup group;
+	group.ParallelFor(0, jobs.size(), CeilDiv((uint)jobs.size(), (workers + 1) * 4), [&](size_t i) {
+		memcpy(jobs[i].dst, jobs[i].src, jobs[i].size);
+	});
+}
+
 /**
  * Flush this dumper into a writer.
  * @param writer The filter we want to use.
@@ -2345,11 +2393,37 @@ static void SlSaveChunk(const ChunkHandler &ch)
 	DEBUG(sl, 3, "Saved chunk %c%c%c%c (" PRINTF_SIZE " bytes)", ch.id >> 24, ch.id >> 16, ch.id >> 8, ch.id, SlGetBytesWritten() - written);
 }
 
+/** Statistics of a single chunk collected by the savegame benchmark. */
+struct SaveLoadBenchmarkChunk {
+	uint32 id;          ///< Chunk ID.
+	uint64 time_us;     ///< Total serialisation time, in microseconds.
+	uint64 bytes;       ///< Total serialised size, in bytes.
+};
+
+/** Chunk statistics collected while saving for the savegame benchmark, or nullptr when not benchmarking. */
+static std::vector<SaveLoadBenchmarkChunk> *_sl_benchmark_chunks = nullptr;
+
 /** Save all chunks */
 static void SlSaveChunks()
 {
-	for (auto &ch : ChunkHandlers()) {
-		SlSaveChunk(ch);
+	if (_sl_benchmark_chunks != nullptr) {
+		for (auto &ch : ChunkHandlers()) {
+			const size_t written = SlGetBytesWritten();
+			const auto start = std::chrono::steady_clock::now();
+			SlSaveChunk(ch);
+			const uint64 time_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+			const size_t bytes = SlGetBytesWritten() - written;
+			if (bytes == 0) continue;
+
+			auto it = std::find_if(_sl_benchmark_chunks->begin(), _sl_benchmark_chunks->end(), [&](const SaveLoadBenchmarkChunk &c) { return c.id == ch.id; });
+			if (it == _sl_benchmark_chunks->end()) it = _sl_benchmark_chunks->insert(it, { ch.id, 0, 0 });
+			it->time_us += time_us;
+			it->bytes += bytes;
+		}
+	} else {
+		for (auto &ch : ChunkHandlers()) {
+			SlSaveChunk(ch);
+		}
 	}
 
 	/* Terminator */
@@ -2407,6 +2481,20 @@ static void SlLoadCheckChunks()
 	uint32 id;
 	const ChunkHandler *ch;
 
+	/* Chunks without a load check handler are only skipped, so stop reading (and decompressing) the savegame after
+	 * the last chunk which has one. Extended savegames write their chunks in the order of ChunkHandlers(), so once
+	 * a chunk after that handler is read, every chunk of interest has either been read or is absent from the file.
+	 * The debug chunks are only of interest when debug data is wanted. */
+	const std::vector<ChunkHandler> &handlers = ChunkHandlers();
+	size_t last_check_handler = handlers.size();
+	if (_sl_is_ext_version) {
+		for (size_t i = 0; i < handlers.size(); i++) {
+			if (handlers[i].load_check_proc == nullptr) continue;
+			if (!_load_check_data.want_debug_data && (handlers[i].id == 'DBGL' || handlers[i].id == 'DBGC')) continue;
+			last_check_handler = i;
+		}
+	}
+
 	for (id = SlReadUint32(); id != 0; id = SlReadUint32()) {
 		DEBUG(sl, 2, "Loading chunk %c%c%c%c", id >> 24, id >> 16, id >> 8, id);
 		size_t read = 0;
@@ -2420,6 +2508,11 @@ static void SlLoadCheckChunks()
 		}
 		SlLoadCheckChunk(ch);
 		DEBUG(sl, 3, "Loaded chunk %c%c%c%c (" PRINTF_SIZE " bytes)", id >> 24, id >> 16, id >> 8, id, SlGetBytesRead() - read);
+
+		if (ch != nullptr && last_check_handler < handlers.size() && (size_t)(ch - handlers.data()) >= last_check_handler) {
+			DEBUG(sl, 2, "All load check chunks read, skipping the remainder of the savegame");
+			break;
+		}
 	}
 }
 
@@ -2449,17 +2542,40 @@ struct FileReader : LoadFilter {
 	FILE *file; ///< The file to read from.
 	long begin; ///< The begin of the file.
 
+	byte *map_base = nullptr; ///< Base of the read-only mapping of the whole file, if mapped.
+	size_t map_size = 0;      ///< Size of the mapping.
+	size_t map_pos = 0;       ///< Current read position within the mapping.
+
 	/**
 	 * Create the file reader, so it reads from a specific file.
 	 * @param file The file to read from.
 	 */
 	FileReader(FILE *file) : LoadFilter(nullptr), file(file), begin(ftell(file))
 	{
+#if defined(UNIX)
+		/* Map the whole file, so that reads are a single copy out of the page cache instead of going through the
+		 * stdio buffer. Only do this on 64 bit systems, as the address space could be exhausted otherwise. */
+		if (sizeof(void *) >= 8 && this->begin >= 0) {
+			struct stat st;
+			if (fstat(fileno(this->file), &st) == 0 && st.st_size > this->begin) {
+				void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fileno(this->file), 0);
+				if (map != MAP_FAILED) {
+					madvise(map, st.st_size, MADV_SEQUENTIAL);
+					this->map_base = static_cast<byte *>(map);
+					this->map_size = st.st_size;
+					this->map_pos = this->begin;
+				}
+			}
+		}
+#endif
 	}
 
 	/** Make sure everything is cleaned up. */
 	~FileReader()
 	{
+#if defined(UNIX)
+		if (this->map_base != nullptr) munmap(this->map_base, this->map_size);
+#endif
 		if (this->file != nullptr) fclose(this->file);
 		this->file = nullptr;
 
@@ -2472,11 +2588,23 @@ struct FileReader : LoadFilter {
 		/* We're in the process of shutting down, i.e. in "failure" mode. */
 		if (this->file == nullptr) return 0;
 
+		if (this->map_base != nullptr) {
+			size = std::min(size, this->map_size - this->map_pos);
+			memcpy(buf, this->map_base + this->map_pos, size);
+			this->map_pos += size;
+			return size;
+		}
+
 		return fread(buf, 1, size, this->file);
 	}
 
 	void Reset() override
 	{
+		if (this->map_base != nullptr) {
+			this->map_pos = this->begin;
+			return;
+		}
+
 		clearerr(this->file);
 		if (fseek(this->file, this->begin, SEEK_SET)) {
 			DEBUG(sl, 1, "Could not reset the file reading");
@@ -2943,6 +3071,10 @@ struct ZSTDLoadFilter : LoadFilter {
 	}
 };
 
+static const uint ZSTD_MAX_SAVE_WORKERS = 4;      ///< Maximum number of zstd compression threads used for a save.
+static const byte ZSTD_LDM_MIN_COMPRESSION = 110; ///< Lowest compression level (zstd level 10) using long distance matching.
+static const int ZSTD_LDM_WINDOW_LOG = 27;        ///< Window log used with long distance matching, the default decoder limit.
+
 /** Filter using ZSTD compression. */
 struct ZSTDSaveFilter : SaveFilter {
 	ZSTD_CCtx *zstd;  ///< ZSTD compression context
@@ -2961,6 +3093,17 @@ struct ZSTDSaveFilter : SaveFilter {
 			ZSTD_freeCCtx(this->zstd);
 			SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "invalid compresison level");
 		}
+
+		/* The following parameters are optional: a library built without multithreading support or too old for
+		 * long distance matching simply refuses them, and the stream is then compressed as before. Neither changes
+		 * the frame format, so saves stay loadable by any zstd decoder. */
+		uint workers = _general_worker_pool.GetWorkerCount();
+		if (workers > 0) ZSTD_CCtx_setParameter(this->zstd, ZSTD_c_nbWorkers, (int)std::min<uint>(workers + 1, ZSTD_MAX_SAVE_WORKERS));
+		if (compression_level >= ZSTD_LDM_MIN_COMPRESSION) {
+			/* Keep the window within the size every decoder accepts without raising its window limit. */
+			ZSTD_CCtx_setParameter(this->zstd, ZSTD_c_windowLog, ZSTD_LDM_WINDOW_LOG);
+			ZSTD_CCtx_setParameter(this->zstd, ZSTD_c_enableLongDistanceMatching, 1);
+		}
 	}
 
 	/** Clean up what we allocated. */
@@ -3313,6 +3456,132 @@ SaveOrLoadResult SaveWithFilter(SaveFilter *writer, bool threaded, SaveModeFlags
 	}
 }
 
+/** Save filter collecting the written savegame in memory, for the savegame benchmark. */
+struct BenchmarkMemoryWriter : SaveFilter {
+	std::vector<byte> &data; ///< The written savegame.
+
+	BenchmarkMemoryWriter(std::vector<byte> &data) : SaveFilter(nullptr), data(data) {}
+
+	void Write(byte *buf, size_t size) override
+	{
+		this->data.insert(this->data.end(), buf, buf + size);
+	}
+
+	void Finish() override {}
+};
+
+/** Load filter reading a savegame from memory, for the savegame benchmark. */
+struct BenchmarkMemoryReader : LoadFilter {
+	const std::vector<byte> &data; ///< The savegame to read.
+	size_t begin;                  ///< Offset to start reading at.
+	size_t pos;                    ///< Current read offset.
+
+	BenchmarkMemoryReader(const std::vector<byte> &data, size_t begin) : LoadFilter(nullptr), data(data), begin(begin), pos(begin) {}
+
+	size_t Read(byte *buf, size_t size) override
+	{
+		size = std::min(size, this->data.size() - this->pos);
+		memcpy(buf, this->data.data() + this->pos, size);
+		this->pos += size;
+		return size;
+	}
+
+	void Reset() override
+	{
+		this->pos = this->begin;
+	}
+};
+
+/**
+ * Benchmark saving the current game with each available savegame format, and decompressing the result again.
+ * @param iterations Number of times to save and decompress with each format.
+ * @return The results as JSON, or an empty string on failure.
+ */
+std::string SaveLoadBenchmark(uint iterations)
+{
+	WaitTillSaved();
+
+	const std::string old_format = _savegame_format;
+	std::vector<SaveLoadBenchmarkChunk> chunks;
+	auto guard = scope_guard([&]() {
+		_savegame_format = old_format;
+		_sl_benchmark_chunks = nullptr;
+	});
+
+	auto to_us = [](std::chrono::steady_clock::duration d) -> uint64 {
+		return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+	};
+	auto mb_per_s = [](uint64 bytes, uint64 us) -> double {
+		return us > 0 ? (double)bytes / (double)us : 0.0;
+	};
+
+	std::string formats;
+	uint64 total_serialise_us = 0;
+	uint save_count = 0;
+	for (const SaveLoadFormat &fmt : _saveload_formats) {
+		if (fmt.init_write == nullptr || fmt.init_load == nullptr) continue;
+
+		_savegame_format = fmt.name;
+		uint64 save_us = 0;
+		uint64 serialise_us = 0;
+		uint64 decompress_us = 0;
+		uint64 uncompressed_size = 0;
+		std::vector<byte> data;
+		for (uint i = 0; i < iterations; i++) {
+			data.clear();
+			_sl_benchmark_chunks = &chunks;
+			uint64 chunk_us_before = 0;
+			for (const SaveLoadBenchmarkChunk &c : chunks) chunk_us_before += c.time_us;
+
+			const auto save_start = std::chrono::steady_clock::now();
+			if (SaveWithFilter(new BenchmarkMemoryWriter(data), false, SMF_ZSTD_OK) != SL_OK) return {};
+			save_us += to_us(std::chrono::steady_clock::now() - save_start);
+			_sl_benchmark_chunks = nullptr;
+
+			uint64 chunk_us_after = 0;
+			for (const SaveLoadBenchmarkChunk &c : chunks) chunk_us_after += c.time_us;
+			serialise_us += chunk_us_after - chunk_us_before;
+			save_count++;
+
+			/* Skip the format tag and version, which are not compressed. */
+			if (data.size() < 8) return {};
+			const auto load_start = std::chrono::steady_clock::now();
+			LoadFilter *lf = fmt.init_load(new BenchmarkMemoryReader(data, 8));
+			uncompressed_size = 0;
+			try {
+				byte buf[MEMORY_CHUNK_SIZE];
+				for (size_t read; (read = lf->Read(buf, sizeof(buf))) != 0;) uncompressed_size += read;
+			} catch (...) {
+				delete lf;
+				return {};
+			}
+			delete lf;
+			decompress_us += to_us(std::chrono::steady_clock::now() - load_start);
+		}
+		total_serialise_us += serialise_us;
+
+		if (iterations == 0) continue;
+		if (!formats.empty()) formats += ",\n";
+		formats += stdstr_fmt("    { \"format\": \"%s\", \"level\": %u, \"uncompressed_size\": " OTTD_PRINTF64U ", \"compressed_size\": " PRINTF_SIZE
+				", \"save_us\": " OTTD_PRINTF64U ", \"serialise_us\": " OTTD_PRINTF64U ", \"compress_us\": " OTTD_PRINTF64U ", \"decompress_us\": " OTTD_PRINTF64U
+				", \"compress_mb_per_s\": %.1f, \"decompress_mb_per_s\": %.1f }",
+				fmt.name, fmt.default_compression, uncompressed_size, data.size(),
+				save_us / iterations, serialise_us / iterations, (save_us - serialise_us) / iterations, decompress_us / iterations,
+				mb_per_s(uncompressed_size, (save_us - serialise_us) / iterations), mb_per_s(uncompressed_size, decompress_us / iterations));
+	}
+
+	std::string result = stdstr_fmt("{\n  \"iterations\": %u,\n  \"formats\": [\n", iterations);
+	result += formats;
+	result += "\n  ],\n  \"chunks\": [\n";
+	for (const SaveLoadBenchmarkChunk &c : chunks) {
+		if (&c != &chunks.front()) result += ",\n";
+		result += stdstr_fmt("    { \"id\": \"%c%c%c%c\", \"size\": " OTTD_PRINTF64U ", \"serialise_us\": " OTTD_PRINTF64U " }",
+				c.id >> 24, c.id >> 16, c.id >> 8, c.id, save_count > 0 ? c.bytes / save_count : 0, save_count > 0 ? c.time_us / save_count : 0);
+	}
+	result += stdstr_fmt("\n  ],\n  \"serialise_us\": " OTTD_PRINTF64U "\n}", save_count > 0 ? total_serialise_us / save_count : 0);
+	return result;
+}
+
 bool IsNetworkServerSave()
 {
 	return _sl.save_flags & SMF_NET_SERVER;
@@ -3723,15 +3992,104 @@ SaveOrLoadResult SaveOrLoad(const std::string &filename, SaveLoadOperation fop,
 	}
 }
 
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+static pid_t _forked_save_pid = -1; ///< Process ID of the child process writing a forked autosave, or -1.
+
+/**
+ * Check whether a forked autosave is still being written, and reap its process if it has finished.
+ * @return True if the child process is still running.
+ */
+static bool IsForkedSaveInProgress()
+{
+	if (_forked_save_pid < 0) return false;
+
+	int status;
+	pid_t result = waitpid(_forked_save_pid, &status, WNOHANG);
+	if (result == 0) return true;
+
+	if (result != _forked_save_pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+		DEBUG(sl, 0, "Forked autosave failed");
+	}
+	_forked_save_pid = -1;
+	return false;
+}
+
+/**
+ * Save the game in a forked child process.
+ * The child writes the savegame from its copy-on-write snapshot of the game state, while the game continues in this process.
+ * @param filename The name of the savegame being created.
+ * @param sb The sub directory to save the savegame in.
+ * @param save_flags Save mode flags.
+ * @return True if the save was started or skipped, false if forking failed and the caller should save normally.
+ */
+static bool DoForkedSave(const std::string &filename, Subdirectory sb, SaveModeFlags save_flags)
+{
+	if (IsForkedSaveInProgress()) {
+		DEBUG(sl, 1, "Previous forked autosave still in progress, skipping '%s'", filename.c_str());
+		return true;
+	}
+
+	/* The save thread must not be running, it would not exist in the child. */
+	WaitTillSaved();
+
+	pid_t pid = fork();
+	if (pid < 0) {
+		DEBUG(sl, 0, "Unable to fork for autosave: %s", strerror(errno));
+		return false;
+	}
+
+	if (pid == 0) {
+		/* Only this thread exists in the child: save synchronously, and leave without running exit handlers or destructors. */
+		_general_worker_pool.ResetInForkedChild();
+		SaveOrLoadResult result = SaveOrLoad(filename, SLO_SAVE, DFT_GAME_FILE, sb, false, save_flags);
+		_exit(result == SL_OK ? 0 : 1);
+	}
+
+	_forked_save_pid = pid;
+	return true;
+}
+#endif /* UNIX && !__EMSCRIPTEN__ */
+
 /**
  * Create an autosave or netsave.
  * @param counter A reference to the counter variable to be used for rotating the file name.
  * @param netsave Indicates if this is a regular autosave or a netsave.
  */
+/** Game state at the time of an autosave, which only changes through game ticks and commands. */
+struct AutosaveStateFingerprint {
+	uint64 tick_counter;   ///< Game tick counter.
+	Date date;             ///< Current date.
+	DateFract date_fract;  ///< Fraction of the current date.
+	uint64 command_count;  ///< Number of commands logged.
+
+	bool operator==(const AutosaveStateFingerprint &other) const
+	{
+		return this->tick_counter == other.tick_counter && this->date == other.date && this->date_fract == other.date_fract && this->command_count == other.command_count;
+	}
+};
+
+static AutosaveStateFingerprint _last_autosave_state;    ///< Game state of the last autosave.
+static bool _last_autosave_state_valid = false;          ///< Whether _last_autosave_state belongs to the current game.
+
+/** Forget the game state of the last autosave, when a game is started or loaded. */
+void InvalidateAutosaveStateFingerprint()
+{
+	_last_autosave_state_valid = false;
+}
+
 void DoAutoOrNetsave(FiosNumberedSaveName &counter, bool threaded)
 {
 	char buf[MAX_PATH];
 
+	/* While paused and without commands the previous autosave already holds the current game state. */
+	const AutosaveStateFingerprint state{ _tick_counter, _date, _date_fract, GetCommandLogTotalCount() };
+	if (_settings_client.perf.skip_unchanged_autosave && _last_autosave_state_valid && _last_autosave_state == state) {
+		DEBUG(sl, 2, "Skipping autosave, the game state has not changed since the previous autosave");
+		return;
+	}
+	_last_autosave_state = state;
+	_last_autosave_state_valid = true;
+
 	if (_settings_client.gui.keep_all_autosave) {
 		GenerateDefaultSaveName(buf, lastof(buf));
 		strecat(buf, counter.Extension().c_str(), lastof(buf));
@@ -3740,7 +4098,11 @@ void DoAutoOrNetsave(FiosNumberedSaveName &counter, bool threaded)
 	}
 
 	DEBUG(sl, 2, "Autosaving to '%s'", buf);
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+	if (threaded && _network_dedicated && _settings_client.perf.forked_autosave && DoForkedSave(buf, AUTOSAVE_DIR, SMF_ZSTD_OK)) return;
+#endif
 	if (SaveOrLoad(buf, SLO_SAVE, DFT_GAME_FILE, AUTOSAVE_DIR, threaded, SMF_ZSTD_OK) != SL_OK) {
+		_last_autosave_state_valid = false;
 		ShowErrorMessage(STR_ERROR_AUTOSAVE_FAILED, INVALID_STRING_ID, WL_ERROR);
 	}
 }
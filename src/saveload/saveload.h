@@ -71,9 +71,11 @@ void ProcessAsyncSaveFinish();
 void DoExitSave();
 
 void DoAutoOrNetsave(FiosNumberedSaveName &counter, bool threaded);
+void InvalidateAutosaveStateFingerprint();
 
 SaveOrLoadResult SaveWithFilter(struct SaveFilter *writer, bool threaded, SaveModeFlags flags);
 SaveOrLoadResult LoadWithFilter(struct LoadFilter *reader);
+std::string SaveLoadBenchmark(uint iterations);
 bool IsNetworkServerSave();
 bool IsScenarioSave();
 
@@ -23,6 +23,7 @@ struct SaveFilter;
 
 /** Save in chunks of 128 KiB. */
 static const size_t MEMORY_CHUNK_SIZE = 128 * 1024;
+static const size_t MEMORY_CHUNK_PARALLEL_COPY_SIZE = 64 * MEMORY_CHUNK_SIZE; ///< Minimum size of a MemoryDumper::CopyBytes call to be spread over the worker threads.
 
 /** A buffer for reading (and buffering) savegame data. */
 struct ReadBuffer {
@@ -195,8 +196,14 @@ struct MemoryDumper {
 		*this->buf++ = b;
 	}
 
+	void CopyBytesParallel(const byte *ptr, size_t length);
+
 	inline void CopyBytes(const byte *ptr, size_t length)
 	{
+		if (unlikely(length >= MEMORY_CHUNK_PARALLEL_COPY_SIZE && this->saved_buf == nullptr)) {
+			this->CopyBytesParallel(ptr, length);
+			return;
+		}
 		while (length) {
 			if (unlikely(this->buf == this->bufe)) {
 				this->AllocateBuffer();
@@ -31,7 +31,7 @@ static void Load_TSAS()
 	while ((index = SlIterateArray()) != -1) {
 		const_cast<SignalSpeedKey &>(data.first).signal_tile = index;
 		SlObjectLoadFiltered(&data, _filtered_train_speed_adaptation_map_desc);
-		_signal_speeds.insert(data);
+		InsertSignalSpeedRestriction(data.first, data.second.train_speed, data.second.time_stamp);
 	}
 	_filtered_train_speed_adaptation_map_desc.clear();
 }
@@ -44,10 +44,10 @@ static void RealSave_TSAS(SignalSpeedType *data)
 static void Save_TSAS()
 {
 	_filtered_train_speed_adaptation_map_desc = SlFilterObject(_train_speed_adaptation_map_desc);
-	for (auto &it : _signal_speeds) {
+	for (const auto &it : _signal_speeds) {
 		SlSetArrayIndex(it.first.signal_tile);
-		SignalSpeedType *data = &it;
-		SlAutolength((AutolengthProc*) RealSave_TSAS, data);
+		SignalSpeedType data(it.first, { it.second.train_speed, GetSignalSpeedTimeStamp(it.second) });
+		SlAutolength((AutolengthProc*) RealSave_TSAS, &data);
 	}
 	_filtered_train_speed_adaptation_map_desc.clear();
 }
@@ -20,6 +20,7 @@
 #include "settings_type.h"
 #include "schdispatch.h"
 #include "vehicle_gui.h"
+#include "order_func.h"
 
 #include <algorithm>
 
@@ -577,6 +578,7 @@ void DispatchSchedule::SetScheduledDispatch(std::vector<uint32> dispatch_list)
 {
 	this->scheduled_dispatch = std::move(dispatch_list);
 	assert(std::is_sorted(this->scheduled_dispatch.begin(), this->scheduled_dispatch.end()));
+	this->InvalidateSlotLookup();
 	if (this->IsScheduledDispatchValid()) this->UpdateScheduledDispatch(nullptr);
 }
 
@@ -592,6 +594,7 @@ void DispatchSchedule::AddScheduledDispatch(uint32 offset)
 		return;
 	}
 	this->scheduled_dispatch.insert(insert_position, offset);
+	this->InvalidateSlotLookup();
 	this->UpdateScheduledDispatch(nullptr);
 }
 
@@ -607,6 +610,7 @@ void DispatchSchedule::RemoveScheduledDispatch(uint32 offset)
 		return;
 	}
 	this->scheduled_dispatch.erase(erase_position);
+	this->InvalidateSlotLookup();
 }
 
 /**
@@ -622,6 +626,38 @@ void DispatchSchedule::AdjustScheduledDispatch(int32 adjust)
 		time = (uint32)t;
 	}
 	std::sort(this->scheduled_dispatch.begin(), this->scheduled_dispatch.end());
+	this->InvalidateSlotLookup();
+}
+
+/**
+ * Get the earliest dispatch slot at or after a time.
+ * The slots are sorted, so the slot is found with a binary search within the period containing the time.
+ * The result of the last search is kept, as the vehicles of a schedule tend to search from the same offset.
+ * @param time The time.
+ * @return The time of the slot, or -1 if there are no slots within the duration.
+ */
+DateTicksScaled DispatchSchedule::GetScheduledDispatchSlotAtOrAfter(DateTicksScaled time) const
+{
+	const uint32 duration = this->GetScheduledDispatchDuration();
+	if (duration == 0) return -1;
+
+	/* Slots at or beyond the duration are never used. */
+	const auto first = this->scheduled_dispatch.begin();
+	const auto last = std::lower_bound(first, this->scheduled_dispatch.end(), duration);
+	if (first == last) return -1;
+
+	const DateTicksScaled begin_time = this->GetScheduledDispatchStartTick();
+	if (time <= begin_time) return begin_time + *first;
+
+	const DateTicksScaled period_start = begin_time + ((time - begin_time) / duration) * duration;
+	const uint32 offset = (uint32)(time - period_start);
+	if (offset != this->slot_lookup_offset) {
+		this->slot_lookup_index = (uint32)(std::lower_bound(first, last, offset) - first);
+		this->slot_lookup_offset = offset;
+	}
+
+	if (first + this->slot_lookup_index != last) return period_start + first[this->slot_lookup_index];
+	return period_start + duration + *first;
 }
 
 bool DispatchSchedule::UpdateScheduledDispatchToDate(DateTicksScaled now)
@@ -640,6 +676,7 @@ bool DispatchSchedule::UpdateScheduledDispatchToDate(DateTicksScaled now)
 		} else {
 			this->scheduled_dispatch_last_dispatch = ClampToI32(last_dispatch);
 		}
+		InvalidateConditionalOrderCache();
 	}
 	/* Most of the time this loop does not runs. It makes sure start date in in past */
 	while (this->GetScheduledDispatchStartTick() > now) {
@@ -661,6 +698,7 @@ bool DispatchSchedule::UpdateScheduledDispatchToDate(DateTicksScaled now)
 				&this->scheduled_dispatch_start_date, &this->scheduled_dispatch_start_full_date_fract);
 		update_windows = true;
 	}
+	if (update_windows) InvalidateConditionalOrderCache();
 	return update_windows;
 }
 
@@ -24,17 +24,22 @@
 
 #ifdef USE_SCOPE_INFO
 
-std::vector<std::function<int(char *, const char *)>> _scope_stack;
+ScopeStackRecord _scope_stack[SCOPE_STACK_MAX_DEPTH];
+uint _scope_stack_depth = 0;
 
 int WriteScopeLog(char *buf, const char *last)
 {
 	char *b = buf;
-	if (!_scope_stack.empty()) {
+	if (_scope_stack_depth > 0) {
 		b += seprintf(b, last, "Within context:");
+		if (_scope_stack_depth > SCOPE_STACK_MAX_DEPTH) {
+			b += seprintf(b, last, "\n    %u innermost entries omitted", _scope_stack_depth - SCOPE_STACK_MAX_DEPTH);
+		}
 		int depth = 0;
-		for (auto it = _scope_stack.rbegin(); it != _scope_stack.rend(); ++it, depth++) {
+		for (uint i = std::min<uint>(_scope_stack_depth, SCOPE_STACK_MAX_DEPTH); i > 0; i--, depth++) {
+			const ScopeStackRecord &record = _scope_stack[i - 1];
 			b += seprintf(b, last, "\n    %2d: ", depth);
-			b += (*it)(b, last);
+			b += record.func(b, last, record.context);
 		}
 		b += seprintf(b, last, "\n\n");
 	}
@@ -12,28 +12,45 @@
 
 #include "tile_type.h"
 
-#include <functional>
-#include <vector>
-
 struct Vehicle;
 struct BaseStation;
 struct Window;
 
 #ifdef USE_SCOPE_INFO
 
-extern std::vector<std::function<int(char *, const char *)>> _scope_stack;
+/** Scope stack entry: a non-capturing formatter function and the context (lambda) it formats. */
+struct ScopeStackRecord {
+	int (*func)(char *, const char *, const void *);
+	const void *context;
+};
+
+static const uint SCOPE_STACK_MAX_DEPTH = 64; ///< Maximum number of scope stack entries which are recorded, deeper entries are counted but not stored.
+
+extern ScopeStackRecord _scope_stack[SCOPE_STACK_MAX_DEPTH];
+extern uint _scope_stack_depth;
 
 struct scope_info_func_obj {
-	scope_info_func_obj(std::function<int(char *, const char *)> func)
+	/**
+	 * Push a scope stack entry.
+	 * This is only a pair of plain stores, the lambda is not called unless the crash log is written.
+	 * @param func The formatting lambda, this must outlive this object.
+	 */
+	template <typename F>
+	scope_info_func_obj(const F *func)
 	{
-		_scope_stack.emplace_back(std::move(func));
+		if (_scope_stack_depth < SCOPE_STACK_MAX_DEPTH) {
+			_scope_stack[_scope_stack_depth] = { [](char *buf, const char *last, const void *context) -> int {
+				return (*static_cast<const F *>(context))(buf, last);
+			}, func };
+		}
+		_scope_stack_depth++;
 	}
 
 	scope_info_func_obj(const scope_info_func_obj &copysrc) = delete;
 
 	~scope_info_func_obj()
 	{
-		_scope_stack.pop_back();
+		_scope_stack_depth--;
 	}
 };
 
@@ -43,16 +60,14 @@ int WriteScopeLog(char *buf, const char *last);
 
 /**
  * This creates a lambda in the current scope with the specified capture which outputs the given args as a format string.
- * This lambda is then captured by reference in a std::function which is pushed onto the scope stack
+ * A pointer to this lambda is pushed onto the scope stack, the lambda is only called when writing the crash log.
  * The scope stack is popped at the end of the scope
  */
 #define SCOPE_INFO_FMT(capture, ...) \
 	auto SCOPE_INFO_PASTE(_sc_lm_, __LINE__) = capture (char *buf, const char *last) { \
 		return seprintf(buf, last, __VA_ARGS__); \
 	}; \
-	scope_info_func_obj SCOPE_INFO_PASTE(_sc_obj_, __LINE__) ([&](char *buf, const char *last) -> int { \
-		return SCOPE_INFO_PASTE(_sc_lm_, __LINE__) (buf, last); \
-	});
+	scope_info_func_obj SCOPE_INFO_PASTE(_sc_obj_, __LINE__) (&SCOPE_INFO_PASTE(_sc_lm_, __LINE__));
 
 #else /* USE_SCOPE_INFO */
 
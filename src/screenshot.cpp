@@ -32,6 +32,7 @@
 #include "smallmap_colours.h"
 #include "smallmap_gui.h"
 #include "screenshot_gui.h"
+#include "worker_thread.h"
 
 #include "table/strings.h"
 
@@ -261,6 +262,25 @@ static void PNGAPI png_my_warning(png_structp png_ptr, png_const_charp message)
 	DEBUG(misc, 1, "[libpng] warning: %s - %s", message, (const char *)png_get_error_ptr(png_ptr));
 }
 
+/**
+ * Write rows of pixels to a PNG image.
+ * libpng reports errors by longjmp, so this sets its own jump target, which allows it to be called from a worker thread.
+ * @param png_ptr  PNG write struct.
+ * @param rows     First row to write.
+ * @param n        Number of rows.
+ * @param row_size Size of a row in bytes.
+ * @return True if the rows were written successfully.
+ */
+static bool PNGWriteRows(png_structp png_ptr, png_bytep rows, uint n, size_t row_size)
+{
+	if (setjmp(png_jmpbuf(png_ptr))) return false;
+
+	for (uint i = 0; i != n; i++) {
+		png_write_row(png_ptr, rows + i * row_size);
+	}
+	return true;
+}
+
 /**
  * Generic .PNG file image writer.
  * @param name        Filename, including extension.
@@ -392,28 +412,49 @@ static bool MakePNGImage(const char *name, ScreenshotCallback *callb, void *user
 	/* use by default 64k temp memory */
 	maxlines = Clamp(65536 / w, 16, 128);
 
-	/* now generate the bitmap bits */
-	void *buff = CallocT<uint8>(static_cast<size_t>(w) * maxlines * bpp); // by default generate 128 lines at a time.
-
-	y = 0;
-	do {
-		/* determine # lines to write */
-		n = std::min(h - y, maxlines);
-
-		/* render the pixels into the buffer */
-		callb(userdata, buff, y, w, n);
-		y += n;
+	/* now generate the bitmap bits, into two buffers so that the next lines can be generated while the previous ones are compressed. */
+	const size_t row_size = static_cast<size_t>(w) * bpp;
+	uint8 *buffs[2];
+	buffs[0] = CallocT<uint8>(row_size * maxlines); // by default generate 128 lines at a time.
+	buffs[1] = CallocT<uint8>(row_size * maxlines);
+	uint cur_buff = 0;
+	bool write_ok = true;
+
+	{
+		WorkerTaskGroup group;
+		y = 0;
+		do {
+			/* determine # lines to write */
+			n = std::min(h - y, maxlines);
+
+			/* render the pixels into the buffer */
+			callb(userdata, buffs[cur_buff], y, w, n);
+			y += n;
+
+			/* write them to png, once the previous lines have been written */
+			group.Wait();
+			if (!write_ok) break;
+			png_bytep rows = buffs[cur_buff];
+			group.Run([&write_ok, png_ptr, rows, n, row_size]() {
+				if (!PNGWriteRows(png_ptr, rows, n, row_size)) write_ok = false;
+			});
+			cur_buff ^= 1;
+		} while (y != h);
+	}
 
-		/* write them to png */
-		for (i = 0; i != n; i++) {
-			png_write_row(png_ptr, (png_bytep)buff + i * w * bpp);
-		}
-	} while (y != h);
+	if (!write_ok || setjmp(png_jmpbuf(png_ptr))) {
+		png_destroy_write_struct(&png_ptr, &info_ptr);
+		free(buffs[0]);
+		free(buffs[1]);
+		fclose(f);
+		return false;
+	}
 
 	png_write_end(png_ptr, info_ptr);
 	png_destroy_write_struct(&png_ptr, &info_ptr);
 
-	free(buff);
+	free(buffs[0]);
+	free(buffs[1]);
 	fclose(f);
 	return true;
 }
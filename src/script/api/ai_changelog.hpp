@@ -20,6 +20,29 @@
  * API additions:
  * \li AITown::ROAD_LAYOUT_RANDOM
  * \li AIVehicle::IsPrimaryVehicle
+ * \li AITileList::ValuateDistanceManhattanToTile
+ * \li AITileList::ValuateDistanceSquareToTile
+ * \li AITileList::ValuateSlope
+ * \li AITileList::ValuateBuildable
+ * \li AITileList::ValuateTerrainType
+ * \li AITileList::ValuateOwner
+ * \li AITileList::ValuateTownRating
+ * \li AITileList::ValuateCargoAcceptance
+ * \li AIEventController::GetDroppedEventCount
+ * \li AIIndustryList::ValuateIndustryType
+ * \li AIIndustryList::ValuateDistanceManhattanToTile
+ * \li AIIndustryList::ValuateStockpiledCargo
+ * \li AIIndustryList::ValuateLastMonthProduction
+ * \li AIIndustryList::ValuateLastMonthTransported
+ * \li AIIndustryList::ValuateLastMonthTransportedPercentage
+ * \li AITownList::ValuatePopulation
+ * \li AITownList::ValuateHouseCount
+ * \li AITownList::ValuateDistanceManhattanToTile
+ * \li AITownList::ValuateLastMonthProduction
+ * \li AITownList::ValuateLastMonthSupplied
+ * \li AITownList::ValuateLastMonthTransportedPercentage
+ * \li AITownList::ValuateLastMonthReceived
+ * \li AITownList::ValuateCargoGoal
  *
  * API removals:
  * \li AIError::ERR_PRECONDITION_TOO_MANY_PARAMETERS, that error is never returned anymore.
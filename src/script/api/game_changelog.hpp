@@ -74,6 +74,33 @@
  * \li GSGroupList
  * \li GSVehicleList_Group
  * \li GSVehicleList_DefaultGroup
+ * \li GSCargoMonitor::GetTownDeliveryAmounts
+ * \li GSCargoMonitor::GetIndustryDeliveryAmounts
+ * \li GSCargoMonitor::GetTownPickupAmounts
+ * \li GSCargoMonitor::GetIndustryPickupAmounts
+ * \li GSTileList::ValuateDistanceManhattanToTile
+ * \li GSTileList::ValuateDistanceSquareToTile
+ * \li GSTileList::ValuateSlope
+ * \li GSTileList::ValuateBuildable
+ * \li GSTileList::ValuateTerrainType
+ * \li GSTileList::ValuateOwner
+ * \li GSTileList::ValuateTownRating
+ * \li GSTileList::ValuateCargoAcceptance
+ * \li GSEventController::GetDroppedEventCount
+ * \li GSIndustryList::ValuateIndustryType
+ * \li GSIndustryList::ValuateDistanceManhattanToTile
+ * \li GSIndustryList::ValuateStockpiledCargo
+ * \li GSIndustryList::ValuateLastMonthProduction
+ * \li GSIndustryList::ValuateLastMonthTransported
+ * \li GSIndustryList::ValuateLastMonthTransportedPercentage
+ * \li GSTownList::ValuatePopulation
+ * \li GSTownList::ValuateHouseCount
+ * \li GSTownList::ValuateDistanceManhattanToTile
+ * \li GSTownList::ValuateLastMonthProduction
+ * \li GSTownList::ValuateLastMonthSupplied
+ * \li GSTownList::ValuateLastMonthTransportedPercentage
+ * \li GSTownList::ValuateLastMonthReceived
+ * \li GSTownList::ValuateCargoGoal
  *
  * API removals:
  * \li GSError::ERR_PRECONDITION_TOO_MANY_PARAMETERS, that error is never returned anymore.
@@ -59,6 +59,64 @@
 	return GetPickupAmount(monitor, keep_monitoring);
 }
 
+/**
+ * Convert a list of cargo monitors and their amounts to a script list of towns or industries.
+ * @param amounts Cargo monitors and their amounts.
+ * @return List with the town or industry IDs as items and the amounts as values.
+ */
+static ScriptList *MakeCargoMonitorAmountList(const CargoMonitorAmountList &amounts)
+{
+	ScriptList *list = new ScriptList();
+	for (const auto &it : amounts) {
+		list->AddItem(GB(it.first, CCB_TOWN_IND_NUMBER_START, CCB_TOWN_IND_NUMBER_LENGTH), it.second);
+	}
+	return list;
+}
+
+/* static */ ScriptList *ScriptCargoMonitor::GetTownDeliveryAmounts(ScriptCompany::CompanyID company, CargoID cargo, bool keep_monitoring)
+{
+	CompanyID cid = static_cast<CompanyID>(company);
+	if (cid >= MAX_COMPANIES) return nullptr;
+	if (!ScriptCargo::IsValidCargo(cargo)) return nullptr;
+
+	CargoMonitorAmountList amounts;
+	GetDeliveryAmounts(EncodeCargoTownMonitor(cid, cargo, 0), EncodeCargoTownMonitor(cid, cargo, UINT16_MAX), keep_monitoring, amounts);
+	return MakeCargoMonitorAmountList(amounts);
+}
+
+/* static */ ScriptList *ScriptCargoMonitor::GetIndustryDeliveryAmounts(ScriptCompany::CompanyID company, CargoID cargo, bool keep_monitoring)
+{
+	CompanyID cid = static_cast<CompanyID>(company);
+	if (cid >= MAX_COMPANIES) return nullptr;
+	if (!ScriptCargo::IsValidCargo(cargo)) return nullptr;
+
+	CargoMonitorAmountList amounts;
+	GetDeliveryAmounts(EncodeCargoIndustryMonitor(cid, cargo, 0), EncodeCargoIndustryMonitor(cid, cargo, UINT16_MAX), keep_monitoring, amounts);
+	return MakeCargoMonitorAmountList(amounts);
+}
+
+/* static */ ScriptList *ScriptCargoMonitor::GetTownPickupAmounts(ScriptCompany::CompanyID company, CargoID cargo, bool keep_monitoring)
+{
+	CompanyID cid = static_cast<CompanyID>(company);
+	if (cid >= MAX_COMPANIES) return nullptr;
+	if (!ScriptCargo::IsValidCargo(cargo)) return nullptr;
+
+	CargoMonitorAmountList amounts;
+	GetPickupAmounts(EncodeCargoTownMonitor(cid, cargo, 0), EncodeCargoTownMonitor(cid, cargo, UINT16_MAX), keep_monitoring, amounts);
+	return MakeCargoMonitorAmountList(amounts);
+}
+
+/* static */ ScriptList *ScriptCargoMonitor::GetIndustryPickupAmounts(ScriptCompany::CompanyID company, CargoID cargo, bool keep_monitoring)
+{
+	CompanyID cid = static_cast<CompanyID>(company);
+	if (cid >= MAX_COMPANIES) return nullptr;
+	if (!ScriptCargo::IsValidCargo(cargo)) return nullptr;
+
+	CargoMonitorAmountList amounts;
+	GetPickupAmounts(EncodeCargoIndustryMonitor(cid, cargo, 0), EncodeCargoIndustryMonitor(cid, cargo, UINT16_MAX), keep_monitoring, amounts);
+	return MakeCargoMonitorAmountList(amounts);
+}
+
 /* static */ void ScriptCargoMonitor::StopAllMonitoring()
 {
 	ClearCargoPickupMonitoring();
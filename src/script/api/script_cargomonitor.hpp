@@ -88,6 +88,52 @@ public:
 	 */
 	static SQInteger GetIndustryPickupAmount(ScriptCompany::CompanyID company, CargoID cargo, IndustryID industry_id, bool keep_monitoring);
 
+	/**
+	 * Get the amounts of cargo delivered to all monitored towns by a company since the last query, and update the monitoring state.
+	 * Only towns which are already being monitored for the given company and cargo type are included.
+	 * @param company %Company to query.
+	 * @param cargo Cargo type to query.
+	 * @param keep_monitoring If \c true, the returned combinations continue to be monitored for the next call. If \c false, monitoring ends.
+	 * @return A list with the monitored town IDs as items and the amounts of delivered cargo since the last call as values,
+	 * or \c null if a parameter is out-of-bound.
+	 */
+	static ScriptList *GetTownDeliveryAmounts(ScriptCompany::CompanyID company, CargoID cargo, bool keep_monitoring);
+
+	/**
+	 * Get the amounts of cargo delivered to all monitored industries by a company since the last query, and update the monitoring state.
+	 * Only industries which are already being monitored for the given company and cargo type are included.
+	 * @param company %Company to query.
+	 * @param cargo Cargo type to query.
+	 * @param keep_monitoring If \c true, the returned combinations continue to be monitored for the next call. If \c false, monitoring ends.
+	 * @return A list with the monitored industry IDs as items and the amounts of delivered cargo since the last call as values,
+	 * or \c null if a parameter is out-of-bound.
+	 */
+	static ScriptList *GetIndustryDeliveryAmounts(ScriptCompany::CompanyID company, CargoID cargo, bool keep_monitoring);
+
+	/**
+	 * Get the amounts of cargo picked up (and delivered) from all monitored towns by a company since the last query, and update the monitoring state.
+	 * Only towns which are already being monitored for the given company and cargo type are included.
+	 * @param company %Company to query.
+	 * @param cargo Cargo type to query.
+	 * @param keep_monitoring If \c true, the returned combinations continue to be monitored for the next call. If \c false, monitoring ends.
+	 * @return A list with the monitored town IDs as items and the amounts of picked up cargo since the last call as values,
+	 * or \c null if a parameter is out-of-bound.
+	 * @note Amounts of picked-up cargo are added during final delivery of it, to prevent users from getting credit for picking up without delivering it.
+	 */
+	static ScriptList *GetTownPickupAmounts(ScriptCompany::CompanyID company, CargoID cargo, bool keep_monitoring);
+
+	/**
+	 * Get the amounts of cargo picked up (and delivered) from all monitored industries by a company since the last query, and update the monitoring state.
+	 * Only industries which are already being monitored for the given company and cargo type are included.
+	 * @param company %Company to query.
+	 * @param cargo Cargo type to query.
+	 * @param keep_monitoring If \c true, the returned combinations continue to be monitored for the next call. If \c false, monitoring ends.
+	 * @return A list with the monitored industry IDs as items and the amounts of picked up cargo since the last call as values,
+	 * or \c null if a parameter is out-of-bound.
+	 * @note Amounts of picked-up cargo are added during final delivery of it, to prevent users from getting credit for picking up without delivering it.
+	 */
+	static ScriptList *GetIndustryPickupAmounts(ScriptCompany::CompanyID company, CargoID cargo, bool keep_monitoring);
+
 	/** Stop monitoring everything. */
 	static void StopAllMonitoring();
 };
@@ -9,16 +9,41 @@
 
 #include "../../stdafx.h"
 #include "script_event_types.hpp"
+#include "script_log.hpp"
+#include "../../settings_type.h"
 
 #include <queue>
+#include <set>
 
 #include "../../safeguards.h"
 
 /** The queue of events for a script. */
 struct ScriptEventData {
 	std::queue<ScriptEvent *> stack; ///< The actual queue.
+	std::set<uint64> pending_keys;   ///< Coalescing keys of the queued events which are coalesced.
+	uint dropped = 0;                ///< Number of events which were dropped because the queue was full.
 };
 
+/**
+ * Get the key identifying events which are coalesced while one is still queued.
+ * These events only tell the script that a vehicle needs attention, so
+ *  a second one for the same vehicle adds nothing while the first is still waiting.
+ * @param event The event.
+ * @return The key, or 0 if the event is never coalesced.
+ */
+static uint64 GetEventCoalescingKey(ScriptEvent *event)
+{
+	VehicleID vehicle;
+	switch (event->GetEventType()) {
+		case ScriptEvent::ET_VEHICLE_LOST:             vehicle = ScriptEventVehicleLost::Convert(event)->GetVehicleID(); break;
+		case ScriptEvent::ET_VEHICLE_WAITING_IN_DEPOT: vehicle = ScriptEventVehicleWaitingInDepot::Convert(event)->GetVehicleID(); break;
+		case ScriptEvent::ET_VEHICLE_UNPROFITABLE:     vehicle = ScriptEventVehicleUnprofitable::Convert(event)->GetVehicleID(); break;
+		case ScriptEvent::ET_AIRCRAFT_DEST_TOO_FAR:    vehicle = ScriptEventAircraftDestTooFar::Convert(event)->GetVehicleID(); break;
+		default: return 0;
+	}
+	return ((uint64)event->GetEventType() << 32) | vehicle;
+}
+
 /* static */ void ScriptEventController::CreateEventPointer()
 {
 	assert(ScriptObject::GetEventPointer() == nullptr);
@@ -58,6 +83,7 @@ struct ScriptEventData {
 
 	ScriptEvent *e = data->stack.front();
 	data->stack.pop();
+	if (!data->pending_keys.empty()) data->pending_keys.erase(GetEventCoalescingKey(e));
 	return e;
 }
 
@@ -66,7 +92,30 @@ struct ScriptEventData {
 	if (ScriptObject::GetEventPointer() == nullptr) ScriptEventController::CreateEventPointer();
 	ScriptEventData *data = (ScriptEventData *)ScriptObject::GetEventPointer();
 
+	if (_settings_client.perf.script_event_coalescing) {
+		uint64 key = GetEventCoalescingKey(event);
+		if (key != 0 && !data->pending_keys.insert(key).second) {
+			/* An identical event is still waiting; the caller holds the reference which frees this one. */
+			return;
+		}
+	}
+
+	const uint32 limit = _settings_client.perf.script_event_queue_limit;
+	if (limit != 0 && data->stack.size() >= limit) {
+		if (data->dropped == 0) ScriptLog::Warning("Event queue is full, further events are dropped until it has been emptied.");
+		data->dropped++;
+		return;
+	}
+
 	event->AddRef();
 	data->stack.push(event);
 }
 
+/* static */ SQInteger ScriptEventController::GetDroppedEventCount()
+{
+	if (ScriptObject::GetEventPointer() == nullptr) ScriptEventController::CreateEventPointer();
+	ScriptEventData *data = (ScriptEventData *)ScriptObject::GetEventPointer();
+
+	return data->dropped;
+}
+
@@ -100,6 +100,13 @@ public:
 	 */
 	static ScriptEvent *GetNextEvent();
 
+	/**
+	 * Get the number of events which were dropped because the event queue was full.
+	 * @return The number of dropped events since the script started.
+	 * @note The queue is only limited if the server has configured an event queue limit.
+	 */
+	static SQInteger GetDroppedEventCount();
+
 	/**
 	 * Insert an event to the queue for the company.
 	 * @param event The event to insert.
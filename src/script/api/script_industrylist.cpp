@@ -9,6 +9,8 @@
 
 #include "../../stdafx.h"
 #include "script_industrylist.hpp"
+#include "script_industry.hpp"
+#include "script_controller.hpp"
 #include "../../industry.h"
 
 #include "../../safeguards.h"
@@ -20,6 +22,55 @@ ScriptIndustryList::ScriptIndustryList()
 	}
 }
 
+/**
+ * Set the value of every industry in a list natively, instead of calling back into Squirrel for every industry.
+ * The script is charged a single operation per industry.
+ * @param list The list to valuate.
+ * @param valuator The function giving the value of a industry.
+ */
+template <typename F>
+static void ValuateIndustries(ScriptIndustryList *list, F valuator)
+{
+	ScriptController::DecreaseOps((int)std::min<size_t>(list->items.size(), INT_MAX));
+
+	std::vector<SQInteger> values;
+	values.reserve(list->items.size());
+	for (const auto &it : list->items) {
+		values.push_back(valuator((IndustryID)it.first));
+	}
+	list->SetValues(values);
+}
+
+void ScriptIndustryList::ValuateIndustryType()
+{
+	ValuateIndustries(this, [](IndustryID id) { return (SQInteger)ScriptIndustry::GetIndustryType(id); });
+}
+
+void ScriptIndustryList::ValuateDistanceManhattanToTile(TileIndex tile)
+{
+	ValuateIndustries(this, [&](IndustryID id) { return (SQInteger)ScriptIndustry::GetDistanceManhattanToTile(id, tile); });
+}
+
+void ScriptIndustryList::ValuateStockpiledCargo(CargoID cargo_id)
+{
+	ValuateIndustries(this, [&](IndustryID id) { return (SQInteger)ScriptIndustry::GetStockpiledCargo(id, cargo_id); });
+}
+
+void ScriptIndustryList::ValuateLastMonthProduction(CargoID cargo_id)
+{
+	ValuateIndustries(this, [&](IndustryID id) { return (SQInteger)ScriptIndustry::GetLastMonthProduction(id, cargo_id); });
+}
+
+void ScriptIndustryList::ValuateLastMonthTransported(CargoID cargo_id)
+{
+	ValuateIndustries(this, [&](IndustryID id) { return (SQInteger)ScriptIndustry::GetLastMonthTransported(id, cargo_id); });
+}
+
+void ScriptIndustryList::ValuateLastMonthTransportedPercentage(CargoID cargo_id)
+{
+	ValuateIndustries(this, [&](IndustryID id) { return (SQInteger)ScriptIndustry::GetLastMonthTransportedPercentage(id, cargo_id); });
+}
+
 ScriptIndustryList_CargoAccepting::ScriptIndustryList_CargoAccepting(CargoID cargo_id)
 {
 	for (const Industry *i : Industry::Iterate()) {
@@ -20,6 +20,51 @@
 class ScriptIndustryList : public ScriptList {
 public:
 	ScriptIndustryList();
+
+	/**
+	 * Set the value of every industry in the list to its industry type.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptIndustry.GetIndustryType).
+	 */
+	void ValuateIndustryType();
+
+	/**
+	 * Set the value of every industry in the list to the manhattan distance from its location to a tile.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptIndustry.GetDistanceManhattanToTile, tile).
+	 * @param tile The tile to get the distance to.
+	 */
+	void ValuateDistanceManhattanToTile(TileIndex tile);
+
+	/**
+	 * Set the value of every industry in the list to the amount of a cargo stockpiled for processing.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptIndustry.GetStockpiledCargo, cargo_id).
+	 * @param cargo_id The index of the cargo.
+	 * @note All values are -1 when the cargo is invalid.
+	 */
+	void ValuateStockpiledCargo(CargoID cargo_id);
+
+	/**
+	 * Set the value of every industry in the list to its last month's production of a cargo.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptIndustry.GetLastMonthProduction, cargo_id).
+	 * @param cargo_id The index of the cargo.
+	 * @note All values are -1 when the cargo is invalid.
+	 */
+	void ValuateLastMonthProduction(CargoID cargo_id);
+
+	/**
+	 * Set the value of every industry in the list to the amount of a cargo transported from it last month.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptIndustry.GetLastMonthTransported, cargo_id).
+	 * @param cargo_id The index of the cargo.
+	 * @note All values are -1 when the cargo is invalid.
+	 */
+	void ValuateLastMonthTransported(CargoID cargo_id);
+
+	/**
+	 * Set the value of every industry in the list to the percentage of its production of a cargo transported last month.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptIndustry.GetLastMonthTransportedPercentage, cargo_id).
+	 * @param cargo_id The index of the cargo.
+	 * @note All values are -1 when the cargo is invalid.
+	 */
+	void ValuateLastMonthTransportedPercentage(CargoID cargo_id);
 };
 
 /**
@@ -437,9 +437,18 @@ void ScriptList::AddItem(SQInteger item, SQInteger value)
 {
 	this->modifications++;
 
-	if (this->HasItem(item)) return;
+	/* Lists are commonly filled in ascending item order (e.g. tile areas row by
+	 * row), so append at the end of the trees without a full lookup then. */
+	if (this->items.empty() || item > this->items.rbegin()->first) {
+		this->items.emplace_hint(this->items.end(), item, value);
+		ScriptItemList &bucket = this->buckets[value];
+		bucket.emplace_hint(bucket.end(), item);
+		return;
+	}
+
+	auto res = this->items.emplace(item, value);
+	if (!res.second) return;
 
-	this->items[item] = value;
 	this->buckets[value].insert(item);
 }
 
@@ -521,6 +530,36 @@ bool ScriptList::SetValue(SQInteger item, SQInteger value)
 	return true;
 }
 
+void ScriptList::SetValues(const std::vector<SQInteger> &values)
+{
+	this->modifications++;
+
+	assert(values.size() <= this->items.size());
+
+	if (!this->sorter->IsEnd()) {
+		/* An iteration is in progress, so keep the sorter informed per item. */
+		auto value_iter = values.begin();
+		for (auto item_iter = this->items.begin(); value_iter != values.end(); ++item_iter, ++value_iter) {
+			this->SetValue(item_iter->first, *value_iter);
+		}
+		return;
+	}
+
+	auto value_iter = values.begin();
+	for (auto item_iter = this->items.begin(); value_iter != values.end(); ++item_iter, ++value_iter) {
+		item_iter->second = *value_iter;
+	}
+
+	/* Rebuild all buckets at once; items are visited in ascending order, so
+	 * each bucket is only appended to. */
+	this->sorter->End();
+	this->buckets.clear();
+	for (const auto &it : this->items) {
+		ScriptItemList &bucket = this->buckets[it.second];
+		bucket.emplace_hint(bucket.end(), it.first);
+	}
+}
+
 void ScriptList::Sort(SorterType sorter, bool ascending)
 {
 	this->modifications++;
@@ -869,6 +908,11 @@ SQInteger ScriptList::Valuate(HSQUIRRELVM vm)
 	/* Push the function to call */
 	sq_push(vm, 2);
 
+	/* Collect all values first and apply them at once afterwards, which is
+	 * much cheaper than moving every item to its new bucket individually. */
+	std::vector<SQInteger> values;
+	values.reserve(this->items.size());
+
 	for (ScriptListMap::iterator iter = this->items.begin(); iter != this->items.end(); iter++) {
 		/* Check for changing of items. */
 		int previous_modification_count = this->modifications;
@@ -883,6 +927,7 @@ SQInteger ScriptList::Valuate(HSQUIRRELVM vm)
 
 		/* Call the function. Squirrel pops all parameters and pushes the return value. */
 		if (SQ_FAILED(sq_call(vm, nparam + 1, SQTrue, SQTrue))) {
+			this->SetValues(values);
 			ScriptObject::SetAllowDoCommand(backup_allow);
 			return SQ_ERROR;
 		}
@@ -906,6 +951,7 @@ SQInteger ScriptList::Valuate(HSQUIRRELVM vm)
 				/* See below for explanation. The extra pop is the return value. */
 				sq_pop(vm, nparam + 4);
 
+				this->SetValues(values);
 				ScriptObject::SetAllowDoCommand(backup_allow);
 				return sq_throwerror(vm, "return value of valuator is not valid (not integer/bool)");
 			}
@@ -917,6 +963,7 @@ SQInteger ScriptList::Valuate(HSQUIRRELVM vm)
 			/* See below for explanation. The extra pop is the return value. */
 			sq_pop(vm, nparam + 4);
 
+			this->SetValues(values);
 			ScriptObject::SetAllowDoCommand(backup_allow);
 			return sq_throwerror(vm, "excessive CPU usage in valuator function");
 		}
@@ -926,11 +973,12 @@ SQInteger ScriptList::Valuate(HSQUIRRELVM vm)
 			/* See below for explanation. The extra pop is the return value. */
 			sq_pop(vm, nparam + 4);
 
+			this->SetValues(values);
 			ScriptObject::SetAllowDoCommand(backup_allow);
 			return sq_throwerror(vm, "modifying valuated list outside of valuator function");
 		}
 
-		this->SetValue((*iter).first, value);
+		values.push_back(value);
 
 		/* Pop the return value. */
 		sq_poptop(vm);
@@ -944,6 +992,8 @@ SQInteger ScriptList::Valuate(HSQUIRRELVM vm)
 	 * 4. The ScriptList instance object. */
 	sq_pop(vm, nparam + 3);
 
+	this->SetValues(values);
+
 	ScriptObject::SetAllowDoCommand(backup_allow);
 	return 0;
 }
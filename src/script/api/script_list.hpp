@@ -14,6 +14,7 @@
 #include "script_object.hpp"
 #include <map>
 #include <set>
+#include <vector>
 
 class ScriptListSorter;
 
@@ -131,6 +132,14 @@ public:
 	 */
 	bool SetValue(SQInteger item, SQInteger value);
 
+	/**
+	 * Set the values of the items in ascending item order, updating the
+	 * value buckets once instead of per item.
+	 * @param values The new values; may be shorter than the list, in which case only the first items are changed.
+	 * @api -all
+	 */
+	void SetValues(const std::vector<SQInteger> &values);
+
 	/**
 	 * Sort this list by the given sorter and direction.
 	 * @param sorter    the type of sorter to use
@@ -286,6 +295,7 @@ public:
 	 */
 	void Valuate(void *valuator_function, int params, ...);
 #endif /* DOXYGEN_API */
+
 };
 
 #endif /* SCRIPT_LIST_HPP */
@@ -10,8 +10,14 @@
 #include "../../stdafx.h"
 #include "script_tilelist.hpp"
 #include "script_industry.hpp"
+#include "script_tile.hpp"
+#include "script_town.hpp"
+#include "script_controller.hpp"
 #include "../../industry.h"
 #include "../../station_base.h"
+#include "../../station_func.h"
+
+#include <optional>
 
 #include "../../safeguards.h"
 
@@ -47,6 +53,103 @@ void ScriptTileList::RemoveTile(TileIndex tile)
 	this->RemoveItem(tile);
 }
 
+/**
+ * Set the value of every tile in a tile list natively, instead of calling back into Squirrel for every tile.
+ * The script is charged a single operation per tile.
+ * @param list The list to valuate.
+ * @param valuator The function giving the value of a tile.
+ */
+template <typename F>
+static void ValuateTiles(ScriptTileList *list, F valuator)
+{
+	ScriptController::DecreaseOps((int)std::min<size_t>(list->items.size(), INT_MAX));
+
+	std::vector<SQInteger> values;
+	values.reserve(list->items.size());
+	for (const auto &it : list->items) {
+		values.push_back(valuator((TileIndex)it.first));
+	}
+	list->SetValues(values);
+}
+
+void ScriptTileList::ValuateDistanceManhattanToTile(TileIndex tile)
+{
+	ValuateTiles(this, [&](TileIndex t) { return ScriptTile::GetDistanceManhattanToTile(t, tile); });
+}
+
+void ScriptTileList::ValuateDistanceSquareToTile(TileIndex tile)
+{
+	ValuateTiles(this, [&](TileIndex t) { return ScriptTile::GetDistanceSquareToTile(t, tile); });
+}
+
+void ScriptTileList::ValuateSlope()
+{
+	ValuateTiles(this, [](TileIndex t) { return (SQInteger)ScriptTile::GetSlope(t); });
+}
+
+void ScriptTileList::ValuateBuildable()
+{
+	ValuateTiles(this, [](TileIndex t) { return (SQInteger)ScriptTile::IsBuildable(t); });
+}
+
+void ScriptTileList::ValuateTerrainType()
+{
+	ValuateTiles(this, [](TileIndex t) { return (SQInteger)ScriptTile::GetTerrainType(t); });
+}
+
+void ScriptTileList::ValuateOwner()
+{
+	ValuateTiles(this, [](TileIndex t) { return (SQInteger)ScriptTile::GetOwner(t); });
+}
+
+void ScriptTileList::ValuateTownRating(ScriptCompany::CompanyID company_id)
+{
+	ValuateTiles(this, [&](TileIndex t) { return (SQInteger)ScriptTown::GetRating(ScriptTile::GetTownAuthority(t), company_id); });
+}
+
+/** Largest area, in tiles, for which acceptance is recorded when valuating a tile list by cargo acceptance. */
+static const uint MAX_VALUATE_ACCEPTANCE_SUMS_AREA = 1 << 20;
+
+void ScriptTileList::ValuateCargoAcceptance(CargoID cargo_type, SQInteger width, SQInteger height, SQInteger radius)
+{
+	if (width <= 0 || height <= 0 || radius < 0 || !ScriptCargo::IsValidCargo(cargo_type)) {
+		ValuateTiles(this, [](TileIndex) { return (SQInteger)-1; });
+		return;
+	}
+	if (this->items.empty()) return;
+
+	/* Find the bounding box of the station rectangles of all tiles which lie fully on the map. */
+	uint min_x = MapMaxX(), min_y = MapMaxY(), max_x = 0, max_y = 0;
+	for (const auto &it : this->items) {
+		TileIndex t = (TileIndex)it.first;
+		if (!::IsValidTile(t) || TileX(t) + width - 1 > MapMaxX() || TileY(t) + height - 1 > MapMaxY()) continue;
+		min_x = std::min(min_x, TileX(t));
+		min_y = std::min(min_y, TileY(t));
+		max_x = std::max<uint>(max_x, TileX(t) + width - 1);
+		max_y = std::max<uint>(max_y, TileY(t) + height - 1);
+	}
+
+	/* Record the acceptance of the cargo once for the whole area in range of any of the tiles,
+	 * unless the area is so large that recording it would take excessive memory. */
+	const int rad = _settings_game.station.modified_catchment ? radius : (int)CA_UNMODIFIED + _settings_game.station.catchment_increase;
+	std::optional<AcceptanceAreaSums> acceptance_sums;
+	if (min_x <= max_x && min_y <= max_y) {
+		TileArea sums_area = TileArea(TileXY(min_x, min_y), TileXY(max_x, max_y)).Expand(rad);
+		if ((uint)sums_area.w * sums_area.h <= MAX_VALUATE_ACCEPTANCE_SUMS_AREA) {
+			CargoTypes cargo_mask = 0;
+			SetBit(cargo_mask, cargo_type);
+			acceptance_sums.emplace(sums_area, cargo_mask);
+		}
+	}
+
+	ValuateTiles(this, [&](TileIndex t) -> SQInteger {
+		if (acceptance_sums.has_value() && ::IsValidTile(t) && TileX(t) + width - 1 <= MapMaxX() && TileY(t) + height - 1 <= MapMaxY()) {
+			return acceptance_sums->GetAcceptanceAroundTiles(t, width, height, rad)[cargo_type];
+		}
+		return ScriptTile::GetCargoAcceptance(t, cargo_type, width, height, radius);
+	});
+}
+
 /**
  * Helper to get list of tiles that will cover an industry's production or acceptance.
  * @param i Industry in question
@@ -73,6 +176,9 @@ static void FillIndustryCatchment(const Industry *i, SQInteger radius, BitmapTil
 	}
 }
 
+/** Largest area, in tiles, for which the acceptance of an industry's cargoes is recorded when listing accepting tiles. */
+static const uint MAX_ACCEPTANCE_SUMS_AREA = 1 << 16;
+
 ScriptTileList_IndustryAccepting::ScriptTileList_IndustryAccepting(IndustryID industry_id, SQInteger radius)
 {
 	if (!ScriptIndustry::IsValidIndustry(industry_id) || radius <= 0) return;
@@ -96,11 +202,23 @@ ScriptTileList_IndustryAccepting::ScriptTileList_IndustryAccepting(IndustryID in
 	BitmapTileArea bta(TileArea(i->location).Expand(radius));
 	FillIndustryCatchment(i, radius, bta);
 
+	/* Record the acceptance of the industry's cargoes once for every tile which could be in range of the catchment,
+	 * unless the radius is so large that recording the area would take excessive memory. */
+	std::optional<AcceptanceAreaSums> acceptance_sums;
+	TileArea sums_area = TileArea(i->location).Expand(radius * 2);
+	if ((uint)sums_area.w * sums_area.h <= MAX_ACCEPTANCE_SUMS_AREA) {
+		CargoTypes accepts_mask = 0;
+		for (byte j = 0; j < lengthof(i->accepts_cargo); j++) {
+			if (i->accepts_cargo[j] != CT_INVALID) SetBit(accepts_mask, i->accepts_cargo[j]);
+		}
+		acceptance_sums.emplace(sums_area, accepts_mask);
+	}
+
 	BitmapTileIterator it(bta);
 	for (TileIndex cur_tile = it; cur_tile != INVALID_TILE; cur_tile = ++it) {
 		/* Only add the tile if it accepts the cargo (sometimes just 1 tile of an
 		 *  industry triggers the acceptance). */
-		CargoArray acceptance = ::GetAcceptanceAroundTiles(cur_tile, 1, 1, radius);
+		CargoArray acceptance = acceptance_sums.has_value() ? acceptance_sums->GetAcceptanceAroundTiles(cur_tile, 1, 1, radius) : ::GetAcceptanceAroundTiles(cur_tile, 1, 1, radius);
 		{
 			bool cargo_accepts = false;
 			for (byte j = 0; j < lengthof(i->accepts_cargo); j++) {
@@ -11,6 +11,7 @@
 #define SCRIPT_TILELIST_HPP
 
 #include "script_station.hpp"
+#include "script_company.hpp"
 #include "script_list.hpp"
 
 /**
@@ -51,6 +52,62 @@ public:
 	 * @pre ScriptMap::IsValidTile(tile).
 	 */
 	void RemoveTile(TileIndex tile);
+
+	/**
+	 * Set the value of every tile in the list to its manhattan distance to a tile.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptTile.GetDistanceManhattanToTile, tile).
+	 * @param tile The tile to get the distance to.
+	 */
+	void ValuateDistanceManhattanToTile(TileIndex tile);
+
+	/**
+	 * Set the value of every tile in the list to its square distance to a tile.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptTile.GetDistanceSquareToTile, tile).
+	 * @param tile The tile to get the distance to.
+	 */
+	void ValuateDistanceSquareToTile(TileIndex tile);
+
+	/**
+	 * Set the value of every tile in the list to its slope.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptTile.GetSlope).
+	 */
+	void ValuateSlope();
+
+	/**
+	 * Set the value of every tile in the list to whether it is buildable.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptTile.IsBuildable).
+	 */
+	void ValuateBuildable();
+
+	/**
+	 * Set the value of every tile in the list to its terrain type.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptTile.GetTerrainType).
+	 */
+	void ValuateTerrainType();
+
+	/**
+	 * Set the value of every tile in the list to its owner.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptTile.GetOwner).
+	 */
+	void ValuateOwner();
+
+	/**
+	 * Set the value of every tile in the list to the rating of a company in the town which has authority for the tile.
+	 * @param company_id The company to get the rating of.
+	 * @note Tiles without a town authority get ScriptTown::TOWN_RATING_INVALID.
+	 */
+	void ValuateTownRating(ScriptCompany::CompanyID company_id);
+
+	/**
+	 * Set the value of every tile in the list to the acceptance of a cargo by a station built there.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptTile.GetCargoAcceptance, cargo_type, width, height, radius).
+	 * @param cargo_type The cargo to check the acceptance of.
+	 * @param width The width of the station.
+	 * @param height The height of the station.
+	 * @param radius The radius of the station.
+	 * @note All values are -1 when a parameter is invalid.
+	 */
+	void ValuateCargoAcceptance(CargoID cargo_type, SQInteger width, SQInteger height, SQInteger radius);
 };
 
 /**
@@ -9,6 +9,8 @@
 
 #include "../../stdafx.h"
 #include "script_townlist.hpp"
+#include "script_town.hpp"
+#include "script_controller.hpp"
 #include "../../town.h"
 
 #include "../../safeguards.h"
@@ -20,6 +22,65 @@ ScriptTownList::ScriptTownList()
 	}
 }
 
+/**
+ * Set the value of every town in a list natively, instead of calling back into Squirrel for every town.
+ * The script is charged a single operation per town.
+ * @param list The list to valuate.
+ * @param valuator The function giving the value of a town.
+ */
+template <typename F>
+static void ValuateTowns(ScriptTownList *list, F valuator)
+{
+	ScriptController::DecreaseOps((int)std::min<size_t>(list->items.size(), INT_MAX));
+
+	std::vector<SQInteger> values;
+	values.reserve(list->items.size());
+	for (const auto &it : list->items) {
+		values.push_back(valuator((TownID)it.first));
+	}
+	list->SetValues(values);
+}
+
+void ScriptTownList::ValuatePopulation()
+{
+	ValuateTowns(this, [](TownID id) { return (SQInteger)ScriptTown::GetPopulation(id); });
+}
+
+void ScriptTownList::ValuateHouseCount()
+{
+	ValuateTowns(this, [](TownID id) { return (SQInteger)ScriptTown::GetHouseCount(id); });
+}
+
+void ScriptTownList::ValuateDistanceManhattanToTile(TileIndex tile)
+{
+	ValuateTowns(this, [&](TownID id) { return (SQInteger)ScriptTown::GetDistanceManhattanToTile(id, tile); });
+}
+
+void ScriptTownList::ValuateLastMonthProduction(CargoID cargo_id)
+{
+	ValuateTowns(this, [&](TownID id) { return (SQInteger)ScriptTown::GetLastMonthProduction(id, cargo_id); });
+}
+
+void ScriptTownList::ValuateLastMonthSupplied(CargoID cargo_id)
+{
+	ValuateTowns(this, [&](TownID id) { return (SQInteger)ScriptTown::GetLastMonthSupplied(id, cargo_id); });
+}
+
+void ScriptTownList::ValuateLastMonthTransportedPercentage(CargoID cargo_id)
+{
+	ValuateTowns(this, [&](TownID id) { return (SQInteger)ScriptTown::GetLastMonthTransportedPercentage(id, cargo_id); });
+}
+
+void ScriptTownList::ValuateLastMonthReceived(ScriptCargo::TownEffect towneffect_id)
+{
+	ValuateTowns(this, [&](TownID id) { return (SQInteger)ScriptTown::GetLastMonthReceived(id, towneffect_id); });
+}
+
+void ScriptTownList::ValuateCargoGoal(ScriptCargo::TownEffect towneffect_id)
+{
+	ValuateTowns(this, [&](TownID id) { return (SQInteger)ScriptTown::GetCargoGoal(id, towneffect_id); });
+}
+
 ScriptTownEffectList::ScriptTownEffectList()
 {
 	for (int i = TE_BEGIN; i < TE_END; i++) {
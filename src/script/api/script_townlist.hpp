@@ -11,6 +11,7 @@
 #define SCRIPT_TOWNLIST_HPP
 
 #include "script_list.hpp"
+#include "script_cargo.hpp"
 
 /**
  * Creates a list of towns that are currently on the map.
@@ -20,6 +21,65 @@
 class ScriptTownList : public ScriptList {
 public:
 	ScriptTownList();
+
+	/**
+	 * Set the value of every town in the list to its population.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptTown.GetPopulation).
+	 */
+	void ValuatePopulation();
+
+	/**
+	 * Set the value of every town in the list to its number of houses.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptTown.GetHouseCount).
+	 */
+	void ValuateHouseCount();
+
+	/**
+	 * Set the value of every town in the list to the manhattan distance from its centre to a tile.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptTown.GetDistanceManhattanToTile, tile).
+	 * @param tile The tile to get the distance to.
+	 */
+	void ValuateDistanceManhattanToTile(TileIndex tile);
+
+	/**
+	 * Set the value of every town in the list to its last month's production of a cargo.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptTown.GetLastMonthProduction, cargo_id).
+	 * @param cargo_id The index of the cargo.
+	 * @note All values are -1 when the cargo is invalid.
+	 */
+	void ValuateLastMonthProduction(CargoID cargo_id);
+
+	/**
+	 * Set the value of every town in the list to the amount of a cargo it supplied for transport last month.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptTown.GetLastMonthSupplied, cargo_id).
+	 * @param cargo_id The index of the cargo.
+	 * @note All values are -1 when the cargo is invalid.
+	 */
+	void ValuateLastMonthSupplied(CargoID cargo_id);
+
+	/**
+	 * Set the value of every town in the list to the percentage of its production of a cargo transported last month.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptTown.GetLastMonthTransportedPercentage, cargo_id).
+	 * @param cargo_id The index of the cargo.
+	 * @note All values are -1 when the cargo is invalid.
+	 */
+	void ValuateLastMonthTransportedPercentage(CargoID cargo_id);
+
+	/**
+	 * Set the value of every town in the list to the amount of cargo with a town effect it received last month.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptTown.GetLastMonthReceived, towneffect_id).
+	 * @param towneffect_id The index of the town effect.
+	 * @note All values are -1 when the town effect is invalid.
+	 */
+	void ValuateLastMonthReceived(ScriptCargo::TownEffect towneffect_id);
+
+	/**
+	 * Set the value of every town in the list to the amount of cargo with a town effect it needs to grow.
+	 * This is equivalent to, but much cheaper than, Valuate(ScriptTown.GetCargoGoal, towneffect_id).
+	 * @param towneffect_id The index of the town effect.
+	 * @note All values are -1 when the town effect is invalid.
+	 */
+	void ValuateCargoGoal(ScriptCargo::TownEffect towneffect_id);
 };
 
 /**
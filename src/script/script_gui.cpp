@@ -888,12 +888,14 @@ struct ScriptDebugWindow : public Window {
 	{
 		if (widget != WID_SCRD_NAME_TEXT) return;
 
+		const ScriptInstance *instance = nullptr;
 		if (script_debug_company == OWNER_DEITY) {
 			const GameInfo *info = Game::GetInfo();
 			assert(info != nullptr);
 			SetDParam(0, STR_AI_DEBUG_NAME_AND_VERSION);
 			SetDParamStr(1, info->GetName());
 			SetDParam(2, info->GetVersion());
+			instance = Game::GetInstance();
 		} else if (script_debug_company == INVALID_COMPANY || !Company::IsValidAiID(script_debug_company)) {
 			SetDParam(0, STR_EMPTY);
 		} else {
@@ -902,7 +904,20 @@ struct ScriptDebugWindow : public Window {
 			SetDParam(0, STR_AI_DEBUG_NAME_AND_VERSION);
 			SetDParamStr(1, info->GetName());
 			SetDParam(2, info->GetVersion());
+			instance = Company::Get(script_debug_company)->ai_instance;
 		}
+
+		if (instance != nullptr) {
+			SetDParam(0, STR_AI_DEBUG_NAME_VERSION_AND_MEMORY);
+			SetDParam(3, instance->GetAllocatedMemory());
+			SetDParam(4, instance->GetReservedMemory());
+		}
+	}
+
+	void OnHundredthTick() override
+	{
+		/* Keep the memory figures next to the script name up to date. */
+		this->SetWidgetDirty(WID_SCRD_NAME_TEXT);
 	}
 
 	void DrawWidget(const Rect &r, int widget) const override
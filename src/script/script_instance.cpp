@@ -28,6 +28,9 @@
 #include "../company_func.h"
 #include "../fileio_func.h"
 #include "../league_type.h"
+#include "../settings_type.h"
+
+#include <chrono>
 
 #include "../safeguards.h"
 
@@ -64,7 +67,9 @@ ScriptInstance::ScriptInstance(const char *APIName, ScriptType script_type) :
 	callback(nullptr),
 	APIName(APIName),
 	script_type(script_type),
-	allow_text_param_mismatch(false)
+	allow_text_param_mismatch(false),
+	ns_per_op(0),
+	throttled(false)
 {
 	this->storage = new ScriptStorage();
 	this->engine  = new Squirrel(APIName);
@@ -194,6 +199,7 @@ void ScriptInstance::Died()
 	this->in_shutdown = true;
 
 	this->last_allocated_memory = this->GetAllocatedMemory(); // Update cache
+	this->last_reserved_memory = this->GetReservedMemory();
 
 	if (this->instance != nullptr) this->engine->ReleaseObject(this->instance);
 	delete this->instance;
@@ -278,8 +284,9 @@ void ScriptInstance::GameLoop()
 	}
 
 	/* Continue the VM */
+	const auto start = std::chrono::steady_clock::now();
 	try {
-		if (!this->engine->Resume(this->GetMaxOpsTillSuspend())) this->Died();
+		if (!this->engine->Resume(this->GetOpsBudget())) this->Died();
 	} catch (Script_Suspend &e) {
 		this->suspend  = e.GetSuspendTime();
 		this->callback = e.GetSuspendCallback();
@@ -289,6 +296,47 @@ void ScriptInstance::GameLoop()
 		this->engine->ResumeError();
 		this->Died();
 	}
+	if (!this->IsDead()) {
+		this->UpdateTimeBudget(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+	}
+}
+
+uint32 ScriptInstance::GetOpsBudget()
+{
+	const uint32 max_ops = this->GetMaxOpsTillSuspend();
+	const uint32 budget = _settings_client.perf.script_tick_time_budget;
+	if (budget == 0 || this->ns_per_op <= 0) {
+		this->throttled = false;
+		return max_ops;
+	}
+
+	/* Run as many operations as are expected to fit in the time budget, but always make some progress. */
+	const double ops = (budget * 1000.0) / this->ns_per_op;
+	this->throttled = ops < max_ops;
+	return this->throttled ? std::max<uint32>(100, (uint32)ops) : max_ops;
+}
+
+void ScriptInstance::UpdateTimeBudget(uint64 elapsed_us)
+{
+	const uint32 budget = _settings_client.perf.script_tick_time_budget;
+	if (budget == 0) {
+		this->ns_per_op = 0;
+		return;
+	}
+
+	const int ops = this->engine->GetLastResumeOps();
+	if (ops <= 0) return;
+
+	/* Native API calls are included in the elapsed time, so expensive calls make each operation count for more. */
+	const double sample = (elapsed_us * 1000.0) / ops;
+	this->ns_per_op = (this->ns_per_op <= 0) ? sample : (this->ns_per_op * 0.875) + (sample * 0.125);
+
+	/* A single expensive call can overrun the budget by far, pay that back by skipping the next ticks. */
+	if (elapsed_us > budget) {
+		const double excess_ops = ((elapsed_us - budget) * 1000.0) / this->ns_per_op;
+		this->engine->AddOverdrawnOps((int)std::min<double>(excess_ops, INT32_MAX / 2));
+		this->throttled = true;
+	}
 }
 
 void ScriptInstance::CollectGarbage()
@@ -385,7 +433,7 @@ static const SaveLoad _script_byte[] = {
 	SLEG_VAR(_script_sl_byte, SLE_UINT8),
 };
 
-/* static */ bool ScriptInstance::SaveObject(HSQUIRRELVM vm, SQInteger index, int max_depth, bool test)
+/* static */ bool ScriptInstance::SaveObject(HSQUIRRELVM vm, SQInteger index, int max_depth, std::vector<byte> &buffer)
 {
 	if (max_depth == 0) {
 		ScriptLog::Error("Savedata can only be nested to 25 deep. No data saved."); // SQUIRREL_MAX_DEPTH = 25
@@ -394,24 +442,16 @@ static const SaveLoad _script_byte[] = {
 
 	switch (sq_gettype(vm, index)) {
 		case OT_INTEGER: {
-			if (!test) {
-				_script_sl_byte = SQSL_INT;
-				SlObject(nullptr, _script_byte);
-			}
+			buffer.push_back(SQSL_INT);
 			SQInteger res;
 			sq_getinteger(vm, index, &res);
-			if (!test) {
-				int64 value = (int64)res;
-				SlArray(&value, 1, SLE_INT64);
-			}
+			/* Same byte order as SLE_INT64. */
+			uint64 value = (uint64)(int64)res;
+			for (int shift = 56; shift >= 0; shift -= 8) buffer.push_back(GB(value, shift, 8));
 			return true;
 		}
 
 		case OT_STRING: {
-			if (!test) {
-				_script_sl_byte = SQSL_STRING;
-				SlObject(nullptr, _script_byte);
-			}
 			const SQChar *buf;
 			sq_getstring(vm, index, &buf);
 			size_t len = strlen(buf) + 1;
@@ -419,23 +459,18 @@ static const SaveLoad _script_byte[] = {
 				ScriptLog::Error("Maximum string length is 254 chars. No data saved.");
 				return false;
 			}
-			if (!test) {
-				_script_sl_byte = (byte)len;
-				SlObject(nullptr, _script_byte);
-				SlArray(const_cast<char *>(buf), len, SLE_CHAR);
-			}
+			buffer.push_back(SQSL_STRING);
+			buffer.push_back((byte)len);
+			buffer.insert(buffer.end(), buf, buf + len);
 			return true;
 		}
 
 		case OT_ARRAY: {
-			if (!test) {
-				_script_sl_byte = SQSL_ARRAY;
-				SlObject(nullptr, _script_byte);
-			}
+			buffer.push_back(SQSL_ARRAY);
 			sq_pushnull(vm);
 			while (SQ_SUCCEEDED(sq_next(vm, index - 1))) {
 				/* Store the value */
-				bool res = SaveObject(vm, -1, max_depth - 1, test);
+				bool res = SaveObject(vm, -1, max_depth - 1, buffer);
 				sq_pop(vm, 2);
 				if (!res) {
 					sq_pop(vm, 1);
@@ -443,22 +478,16 @@ static const SaveLoad _script_byte[] = {
 				}
 			}
 			sq_pop(vm, 1);
-			if (!test) {
-				_script_sl_byte = SQSL_ARRAY_TABLE_END;
-				SlObject(nullptr, _script_byte);
-			}
+			buffer.push_back(SQSL_ARRAY_TABLE_END);
 			return true;
 		}
 
 		case OT_TABLE: {
-			if (!test) {
-				_script_sl_byte = SQSL_TABLE;
-				SlObject(nullptr, _script_byte);
-			}
+			buffer.push_back(SQSL_TABLE);
 			sq_pushnull(vm);
 			while (SQ_SUCCEEDED(sq_next(vm, index - 1))) {
 				/* Store the key + value */
-				bool res = SaveObject(vm, -2, max_depth - 1, test) && SaveObject(vm, -1, max_depth - 1, test);
+				bool res = SaveObject(vm, -2, max_depth - 1, buffer) && SaveObject(vm, -1, max_depth - 1, buffer);
 				sq_pop(vm, 2);
 				if (!res) {
 					sq_pop(vm, 1);
@@ -466,32 +495,20 @@ static const SaveLoad _script_byte[] = {
 				}
 			}
 			sq_pop(vm, 1);
-			if (!test) {
-				_script_sl_byte = SQSL_ARRAY_TABLE_END;
-				SlObject(nullptr, _script_byte);
-			}
+			buffer.push_back(SQSL_ARRAY_TABLE_END);
 			return true;
 		}
 
 		case OT_BOOL: {
-			if (!test) {
-				_script_sl_byte = SQSL_BOOL;
-				SlObject(nullptr, _script_byte);
-			}
+			buffer.push_back(SQSL_BOOL);
 			SQBool res;
 			sq_getbool(vm, index, &res);
-			if (!test) {
-				_script_sl_byte = res ? 1 : 0;
-				SlObject(nullptr, _script_byte);
-			}
+			buffer.push_back(res ? 1 : 0);
 			return true;
 		}
 
 		case OT_NULL: {
-			if (!test) {
-				_script_sl_byte = SQSL_NULL;
-				SlObject(nullptr, _script_byte);
-			}
+			buffer.push_back(SQSL_NULL);
 			return true;
 		}
 
@@ -501,6 +518,19 @@ static const SaveLoad _script_byte[] = {
 	}
 }
 
+/* static */ bool ScriptInstance::SaveObjectToSavegame(HSQUIRRELVM vm)
+{
+	/* Serialise everything first, so invalid data is detected without a separate test pass,
+	 * and the data goes into the savegame as a single block instead of element by element. */
+	std::vector<byte> buffer;
+	if (!SaveObject(vm, -1, SQUIRREL_MAX_DEPTH, buffer)) return false;
+
+	_script_sl_byte = 1;
+	SlObject(nullptr, _script_byte);
+	SlArray(buffer.data(), buffer.size(), SLE_UINT8);
+	return true;
+}
+
 /* static */ void ScriptInstance::SaveEmpty()
 {
 	_script_sl_byte = 0;
@@ -519,10 +549,8 @@ void ScriptInstance::Save()
 
 	HSQUIRRELVM vm = this->engine->GetVM();
 	if (this->is_save_data_on_stack) {
-		_script_sl_byte = 1;
-		SlObject(nullptr, _script_byte);
 		/* Save the data that was just loaded. */
-		SaveObject(vm, -1, SQUIRREL_MAX_DEPTH, false);
+		if (!SaveObjectToSavegame(vm)) SaveEmpty();
 	} else if (!this->is_started) {
 		SaveEmpty();
 		return;
@@ -561,10 +589,7 @@ void ScriptInstance::Save()
 			return;
 		}
 		sq_pushobject(vm, savedata);
-		if (SaveObject(vm, -1, SQUIRREL_MAX_DEPTH, true)) {
-			_script_sl_byte = 1;
-			SlObject(nullptr, _script_byte);
-			SaveObject(vm, -1, SQUIRREL_MAX_DEPTH, false);
+		if (SaveObjectToSavegame(vm)) {
 			this->is_save_data_on_stack = true;
 		} else {
 			SaveEmpty();
@@ -598,44 +623,49 @@ bool ScriptInstance::IsPaused()
 
 /* static */ bool ScriptInstance::LoadObjects(ScriptData *data)
 {
-	SlObject(nullptr, _script_byte);
-	switch (_script_sl_byte) {
+	/* The elements are read directly, as going through SlObject for every single byte is slow for large save data. */
+	const byte type = SlReadByte();
+	switch (type) {
 		case SQSL_INT: {
 			int64 value;
-			SlArray(&value, 1, (IsSavegameVersionBefore(SLV_SCRIPT_INT64) && SlXvIsFeatureMissing(XSLFI_SCRIPT_INT64)) ? SLE_FILE_I32 | SLE_VAR_I64 : SLE_INT64);
+			if (IsSavegameVersionBefore(SLV_SCRIPT_INT64) && SlXvIsFeatureMissing(XSLFI_SCRIPT_INT64)) {
+				SlArray(&value, 1, SLE_FILE_I32 | SLE_VAR_I64);
+			} else {
+				value = (int64)SlReadUint64();
+			}
 			if (data != nullptr) data->push_back((SQInteger)value);
 			return true;
 		}
 
 		case SQSL_STRING: {
-			SlObject(nullptr, _script_byte);
-			static char buf[std::numeric_limits<decltype(_script_sl_byte)>::max()];
-			SlArray(buf, _script_sl_byte, SLE_CHAR);
-			StrMakeValidInPlace(buf, buf + _script_sl_byte);
+			const byte len = SlReadByte();
+			static char buf[std::numeric_limits<byte>::max()];
+			SlArray(buf, len, SLE_CHAR);
+			StrMakeValidInPlace(buf, buf + len);
 			if (data != nullptr) data->push_back(std::string(buf));
 			return true;
 		}
 
 		case SQSL_ARRAY:
 		case SQSL_TABLE: {
-			if (data != nullptr) data->push_back((SQSaveLoadType)_script_sl_byte);
+			if (data != nullptr) data->push_back((SQSaveLoadType)type);
 			while (LoadObjects(data));
 			return true;
 		}
 
 		case SQSL_BOOL: {
-			SlObject(nullptr, _script_byte);
-			if (data != nullptr) data->push_back((SQBool)(_script_sl_byte != 0));
+			const byte value = SlReadByte();
+			if (data != nullptr) data->push_back((SQBool)(value != 0));
 			return true;
 		}
 
 		case SQSL_NULL: {
-			if (data != nullptr) data->push_back((SQSaveLoadType)_script_sl_byte);
+			if (data != nullptr) data->push_back((SQSaveLoadType)type);
 			return true;
 		}
 
 		case SQSL_ARRAY_TABLE_END: {
-			if (data != nullptr) data->push_back((SQSaveLoadType)_script_sl_byte);
+			if (data != nullptr) data->push_back((SQSaveLoadType)type);
 			return false;
 		}
 
@@ -835,6 +865,12 @@ size_t ScriptInstance::GetAllocatedMemory() const
 	return this->engine->GetAllocatedMemory();
 }
 
+size_t ScriptInstance::GetReservedMemory() const
+{
+	if (this->engine == nullptr) return this->last_reserved_memory;
+	return this->engine->GetReservedMemory();
+}
+
 void ScriptInstance::SetMemoryAllocationLimit(size_t limit) const
 {
 	if (this->engine != nullptr) this->engine->SetMemoryAllocationLimit(limit);
@@ -12,6 +12,7 @@
 
 #include <variant>
 #include <list>
+#include <vector>
 #include <squirrel.h>
 #include "squirrel.hpp"
 #include "script_suspend.hpp"
@@ -240,8 +241,16 @@ public:
 
 	size_t GetAllocatedMemory() const;
 
+	size_t GetReservedMemory() const;
+
 	void SetMemoryAllocationLimit(size_t limit) const;
 
+	/**
+	 * Check whether the script currently runs fewer operations per tick than
+	 *  the opcode setting allows, because it exceeded its time budget.
+	 */
+	inline bool IsThrottled() const { return this->throttled; }
+
 	/**
 	 * Indicate whether this instance is currently being destroyed.
 	 */
@@ -298,9 +307,23 @@ private:
 	bool in_shutdown;                     ///< Is this instance currently being destructed?
 	Script_SuspendCallbackProc *callback; ///< Callback that should be called in the next tick the script runs.
 	size_t last_allocated_memory;         ///< Last known allocated memory value (for display for crashed scripts)
+	size_t last_reserved_memory;          ///< Last known reserved memory value (for display for crashed scripts)
 	const char *APIName;                  ///< Name of the API used for this squirrel.
 	ScriptType script_type;               ///< Script type.
 	bool allow_text_param_mismatch;       ///< Whether ScriptText parameter mismatches are allowed
+	double ns_per_op;                     ///< Moving average of the wall clock time per operation, 0 if not yet measured
+	bool throttled;                       ///< Whether the operations of the script are currently limited by its time budget
+
+	/**
+	 * Get the amount of operations the script may run this tick, taking the time budget into account.
+	 */
+	uint32 GetOpsBudget();
+
+	/**
+	 * Update the time per operation estimate after the script ran, and charge any time over budget to the next ticks.
+	 * @param elapsed_us The wall clock time the script ran for.
+	 */
+	void UpdateTimeBudget(uint64 elapsed_us);
 
 	/**
 	 * Call the script Load function if it exists and data was loaded
@@ -309,16 +332,22 @@ private:
 	bool CallLoad();
 
 	/**
-	 * Save one object (int / string / array / table) to the savegame.
+	 * Serialise one object (int / string / array / table) in the savegame format.
 	 * @param vm The virtual machine to get all the data from.
 	 * @param index The index on the squirrel stack of the element to save.
 	 * @param max_depth The maximum depth recursive arrays / tables will be stored
 	 *   with before an error is returned.
-	 * @param test If true, don't really store the data but only check if it is
-	 *   valid.
-	 * @return True if the saving was successful.
+	 * @param buffer The buffer to append the serialised data to.
+	 * @return True if the saving was successful, otherwise the buffer contents are incomplete.
+	 */
+	static bool SaveObject(HSQUIRRELVM vm, SQInteger index, int max_depth, std::vector<byte> &buffer);
+
+	/**
+	 * Serialise the object at the top of the squirrel stack and write it to the savegame in one go.
+	 * @param vm The virtual machine to get all the data from.
+	 * @return True if the data was valid and saved, otherwise nothing has been written.
 	 */
-	static bool SaveObject(HSQUIRRELVM vm, SQInteger index, int max_depth, bool test);
+	static bool SaveObjectToSavegame(HSQUIRRELVM vm);
 
 	/**
 	 * Load all objects from a savegame.
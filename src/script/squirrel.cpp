@@ -18,9 +18,12 @@
 #include <../squirrel/sqpcheader.h>
 #include <../squirrel/sqvm.h>
 #include "../core/alloc_func.hpp"
+#include "../3rdparty/md5/md5.h"
 
 #include <stdarg.h>
 #include <map>
+#include <mutex>
+#include <vector>
 
 /**
  * In the memory allocator for Squirrel we want to directly use malloc/realloc, so when the OS
@@ -36,6 +39,14 @@
 #define SCRIPT_DEBUG_ALLOCATIONS
 */
 
+/**
+ * Memory allocator for a single script.
+ * Small blocks, which make up the bulk of the tables, arrays, closures and strings a script
+ * creates, are served from per size class free lists which are backed by slabs owned by this
+ * allocator. Larger blocks go straight to malloc. Slabs are only released when the allocator
+ * itself is destroyed, i.e. when the script is stopped, which keeps the churn of small objects
+ * away from the global heap during long running games.
+ */
 struct ScriptAllocator {
 	size_t allocated_size;   ///< Sum of allocated data size
 	size_t allocation_limit; ///< Maximum this allocator may use before allocations fail
@@ -49,6 +60,20 @@ struct ScriptAllocator {
 
 	static const size_t SAFE_LIMIT = 0x8000000; ///< 128 MiB, a safe choice for almost any situation
 
+	static const size_t POOL_GRANULARITY = 16;                            ///< Size difference between two consecutive size classes
+	static const size_t POOL_CLASSES = 16;                                ///< Number of size classes
+	static const size_t POOL_MAX_SIZE = POOL_GRANULARITY * POOL_CLASSES;  ///< Largest block served from the size classes
+	static const size_t SLAB_SIZE = 0x10000;                              ///< Size of a single slab, 64 KiB
+
+	/** Unused block in a size class, linking to the next unused block of that class. */
+	struct FreeBlock {
+		FreeBlock *next;
+	};
+
+	FreeBlock *free_blocks[POOL_CLASSES]; ///< Free list of each size class
+	std::vector<void *> slabs;            ///< Slabs owned by this allocator
+	size_t pooled_size;                   ///< Part of allocated_size which has been served from the size classes
+
 #ifdef SCRIPT_DEBUG_ALLOCATIONS
 	std::map<void *, size_t> allocations;
 #endif
@@ -59,15 +84,83 @@ struct ScriptAllocator {
 	}
 
 	/**
-	 * Catch all validation for the allocation; did it allocate too much memory according
-	 * to the allocation limit or did the allocation at the OS level maybe fail? In those
-	 * error situations a Script_FatalError is thrown, but once that has been done further
-	 * allocations are allowed to make it possible for Squirrel to throw the error and
-	 * clean everything up.
-	 * @param requested_size The requested size that was requested to be allocated.
-	 * @param p              The pointer to the allocated object, or null if allocation failed.
+	 * Get the amount of memory this allocator holds on to, i.e. all the slabs plus all blocks
+	 * which have been allocated outside of the size classes.
+	 * @return The reserved memory in bytes.
 	 */
-	void CheckAllocation(size_t requested_size, void *p)
+	size_t GetReservedSize() const
+	{
+		return (this->slabs.size() * SLAB_SIZE) + (this->allocated_size - this->pooled_size);
+	}
+
+	/**
+	 * Get the size class for a block of the given size.
+	 * @param size The size of the block.
+	 * @return The size class.
+	 */
+	static inline size_t GetPoolClass(size_t size)
+	{
+		return size == 0 ? 0 : (size - 1) / POOL_GRANULARITY;
+	}
+
+	/**
+	 * Allocate a block, either from the size classes or from the OS.
+	 * @param size The size of the block.
+	 * @return The block, or nullptr when the OS did not have enough memory.
+	 */
+	void *AllocateBlock(size_t size)
+	{
+		if (size > POOL_MAX_SIZE) return malloc(size);
+
+		const size_t pool_class = GetPoolClass(size);
+		if (this->free_blocks[pool_class] == nullptr) {
+			/* Carve a new slab into blocks of this size class. */
+			char *slab = static_cast<char *>(malloc(SLAB_SIZE));
+			if (slab == nullptr) return nullptr;
+			this->slabs.push_back(slab);
+
+			const size_t block_size = (pool_class + 1) * POOL_GRANULARITY;
+			FreeBlock *head = nullptr;
+			for (size_t offset = SLAB_SIZE - (SLAB_SIZE % block_size); offset >= block_size; offset -= block_size) {
+				FreeBlock *block = reinterpret_cast<FreeBlock *>(slab + offset - block_size);
+				block->next = head;
+				head = block;
+			}
+			this->free_blocks[pool_class] = head;
+		}
+
+		FreeBlock *block = this->free_blocks[pool_class];
+		this->free_blocks[pool_class] = block->next;
+		this->pooled_size += size;
+		return block;
+	}
+
+	/**
+	 * Release a block allocated by #AllocateBlock.
+	 * @param p    The block.
+	 * @param size The size the block was allocated with.
+	 */
+	void ReleaseBlock(void *p, size_t size)
+	{
+		if (size > POOL_MAX_SIZE) {
+			free(p);
+			return;
+		}
+
+		const size_t pool_class = GetPoolClass(size);
+		FreeBlock *block = static_cast<FreeBlock *>(p);
+		block->next = this->free_blocks[pool_class];
+		this->free_blocks[pool_class] = block;
+		this->pooled_size -= size;
+	}
+
+	/**
+	 * Catch all validation for the allocation limit. When an allocation would exceed the limit
+	 * a Script_FatalError is thrown, but once that has been done further allocations are allowed
+	 * to make it possible for Squirrel to throw the error and clean everything up.
+	 * @param requested_size The size that is going to be added to the allocated size.
+	 */
+	void CheckAllocationLimit(size_t requested_size)
 	{
 		if (this->allocated_size + requested_size > this->allocation_limit && !this->error_thrown) {
 			/* Do not allow allocating more than the allocation limit, except when an error is
@@ -77,11 +170,18 @@ struct ScriptAllocator {
 			char buff[128];
 			seprintf(buff, lastof(buff), "Maximum memory allocation exceeded by " PRINTF_SIZE " bytes when allocating " PRINTF_SIZE " bytes",
 				this->allocated_size + requested_size - this->allocation_limit, requested_size);
-			/* Don't leak the rejected allocation. */
-			free(p);
 			throw Script_FatalError(buff);
 		}
+	}
 
+	/**
+	 * Validation whether the allocation at the OS level failed. In that case a Script_FatalError
+	 * is thrown, just like when exceeding the allocation limit.
+	 * @param requested_size The size that was requested to be allocated.
+	 * @param p              The pointer to the allocated object, or null if allocation failed.
+	 */
+	void CheckAllocation(size_t requested_size, void *p)
+	{
 		if (p == nullptr) {
 			/* The OS did not have enough memory to allocate the object, regardless of the
 			 * limit imposed by OpenTTD on the amount of memory that may be allocated. */
@@ -101,7 +201,9 @@ struct ScriptAllocator {
 
 	void *Malloc(SQUnsignedInteger size)
 	{
-		void *p = malloc(size);
+		this->CheckAllocationLimit(size);
+
+		void *p = this->AllocateBlock(size);
 
 		this->CheckAllocation(size, p);
 
@@ -126,28 +228,40 @@ struct ScriptAllocator {
 			return nullptr;
 		}
 
+		if (oldsize <= POOL_MAX_SIZE && size <= POOL_MAX_SIZE && GetPoolClass(oldsize) == GetPoolClass(size)) {
+			/* The block already fits; only the accounting changes. */
+			this->CheckAllocationLimit(size - oldsize);
+			this->pooled_size += size - oldsize;
+			this->allocated_size += size - oldsize;
 #ifdef SCRIPT_DEBUG_ALLOCATIONS
-		assert(this->allocations[p] == oldsize);
-		this->allocations.erase(p);
+			assert(this->allocations[p] == oldsize);
+			this->allocations[p] = size;
 #endif
+			return p;
+		}
+
 		/* Can't use realloc directly because memory limit check.
 		 * If memory exception is thrown, the old pointer is expected
 		 * to be valid for engine cleanup.
 		 */
-		void *new_p = malloc(size);
+		this->CheckAllocationLimit(size - oldsize);
 
-		this->CheckAllocation(size - oldsize, new_p);
+		void *new_p = this->AllocateBlock(size);
+
+		this->CheckAllocation(size, new_p);
 
 		/* Memory limit test passed, we can copy data and free old pointer. */
 		memcpy(new_p, p, std::min(oldsize, size));
-		free(p);
+		this->ReleaseBlock(p, oldsize);
 
 		this->allocated_size -= oldsize;
 		this->allocated_size += size;
 
 #ifdef SCRIPT_DEBUG_ALLOCATIONS
+		assert(this->allocations[p] == oldsize);
+		this->allocations.erase(p);
 		assert(new_p != nullptr);
-		assert(this->allocations.find(p) == this->allocations.end());
+		assert(this->allocations.find(new_p) == this->allocations.end());
 		this->allocations[new_p] = size;
 #endif
 
@@ -157,7 +271,7 @@ struct ScriptAllocator {
 	void Free(void *p, SQUnsignedInteger size)
 	{
 		if (p == nullptr) return;
-		free(p);
+		this->ReleaseBlock(p, size);
 		this->allocated_size -= size;
 
 #ifdef SCRIPT_DEBUG_ALLOCATIONS
@@ -172,6 +286,8 @@ struct ScriptAllocator {
 		this->allocation_limit = static_cast<size_t>(_settings_game.script.script_max_memory_megabytes) << 20;
 		if (this->allocation_limit == 0) this->allocation_limit = SAFE_LIMIT; // in case the setting is somehow zero
 		this->error_thrown = false;
+		std::fill(std::begin(this->free_blocks), std::end(this->free_blocks), nullptr);
+		this->pooled_size = 0;
 	}
 
 	~ScriptAllocator()
@@ -179,6 +295,7 @@ struct ScriptAllocator {
 #ifdef SCRIPT_DEBUG_ALLOCATIONS
 		assert(this->allocations.size() == 0);
 #endif
+		for (void *slab : this->slabs) free(slab);
 	}
 };
 
@@ -205,6 +322,12 @@ size_t Squirrel::GetAllocatedMemory() const noexcept
 	return this->allocator->allocated_size;
 }
 
+size_t Squirrel::GetReservedMemory() const noexcept
+{
+	assert(this->allocator != nullptr);
+	return this->allocator->GetReservedSize();
+}
+
 void Squirrel::SetMemoryAllocationLimit(size_t limit) noexcept
 {
 	if (this->allocator != nullptr) {
@@ -395,6 +518,8 @@ bool Squirrel::Resume(int suspend)
 	assert(!this->crashed);
 	ScriptAllocatorScope alloc_scope(this);
 
+	this->resume_ops = 0;
+
 	/* Did we use more operations than we should have in the
 	 * previous tick? If so, subtract that from the current run. */
 	if (this->overdrawn_ops > 0 && suspend > 0) {
@@ -406,6 +531,7 @@ bool Squirrel::Resume(int suspend)
 		suspend = -this->overdrawn_ops;
 	}
 
+	this->resume_ops = suspend;
 	this->crashed = !sq_resumecatch(this->vm, suspend);
 	this->overdrawn_ops = -this->vm->_ops_till_suspend;
 	this->allocator->CheckLimit();
@@ -557,6 +683,7 @@ void Squirrel::Initialize()
 	this->print_func = nullptr;
 	this->crashed = false;
 	this->overdrawn_ops = 0;
+	this->resume_ops = 0;
 	this->vm = sq_open(1024);
 
 	/* Handle compile-errors ourself, so we can display it nicely */
@@ -581,12 +708,12 @@ void Squirrel::Initialize()
 
 class SQFile {
 private:
-	FILE *file;
+	const char *data;
 	size_t size;
 	size_t pos;
 
 public:
-	SQFile(FILE *file, size_t size) : file(file), size(size), pos(0) {}
+	SQFile(const char *data, size_t size) : data(data), size(size), pos(0) {}
 
 	size_t Read(void *buf, size_t elemsize, size_t count)
 	{
@@ -595,9 +722,9 @@ public:
 			count = (this->size - this->pos) / elemsize;
 		}
 		if (count == 0) return 0;
-		size_t ret = fread(buf, elemsize, count, this->file);
-		this->pos += ret * elemsize;
-		return ret;
+		memcpy(buf, this->data + this->pos, elemsize * count);
+		this->pos += elemsize * count;
+		return count;
 	}
 };
 
@@ -651,6 +778,81 @@ static SQInteger _io_file_read(SQUserPointer file, SQUserPointer buf, SQInteger
 	return ret;
 }
 
+static SQInteger _io_vector_write(SQUserPointer buffer, SQUserPointer data, SQInteger size)
+{
+	std::vector<byte> *vec = (std::vector<byte> *)buffer;
+	vec->insert(vec->end(), (const byte *)data, (const byte *)data + size);
+	return size;
+}
+
+/** Compiled bytecode of a script file, shared between all script instances. */
+struct ScriptBytecodeCacheEntry {
+	uint8 digest[16];            ///< MD5 of the encoding and source the bytecode was compiled from.
+	std::vector<byte> bytecode;  ///< Bytecode as written by sq_writeclosure.
+};
+
+/** Bytecode cache, keyed by API name and file name. */
+static std::map<std::string, ScriptBytecodeCacheEntry> _script_bytecode_cache;
+static std::mutex _script_bytecode_cache_mutex;
+
+/**
+ * Get the number of entries in the constant table of a VM.
+ * Constants and enums are inlined by the compiler, so bytecode can only be reused while this is zero.
+ */
+static SQInteger GetConstTableSize(HSQUIRRELVM vm)
+{
+	sq_pushconsttable(vm);
+	SQInteger size = sq_getsize(vm, -1);
+	sq_poptop(vm);
+	return size;
+}
+
+/**
+ * Compile a script source, or load its bytecode from the cache when the same source was compiled before.
+ * @param vm The VM to push the closure on.
+ * @param func The lexer feed function for the encoding of the source.
+ * @param source The source, without byte order mark.
+ * @param key The cache key of the file.
+ * @param filename The name of the file, for error messages.
+ * @param printerror Whether to print compile errors.
+ * @return Whether a closure was pushed.
+ */
+static SQRESULT CompileWithCache(HSQUIRRELVM vm, SQLEXREADFUNC func, const std::string &source, const std::string &key, const char *filename, SQBool printerror)
+{
+	bool cacheable = GetConstTableSize(vm) == 0;
+
+	uint8 digest[16];
+	if (cacheable) {
+		Md5 checksum;
+		checksum.Append(&func, sizeof(func));
+		checksum.Append(source.data(), source.size());
+		checksum.Finish(digest);
+
+		std::lock_guard<std::mutex> lock(_script_bytecode_cache_mutex);
+		auto it = _script_bytecode_cache.find(key);
+		if (it != _script_bytecode_cache.end() && memcmp(it->second.digest, digest, sizeof(digest)) == 0) {
+			const std::vector<byte> &bytecode = it->second.bytecode;
+			SQFile f((const char *)bytecode.data(), bytecode.size());
+			if (SQ_SUCCEEDED(sq_readclosure(vm, _io_file_read, &f))) return SQ_OK;
+			_script_bytecode_cache.erase(it);
+		}
+	}
+
+	SQFile f(source.data(), source.size());
+	if (SQ_FAILED(sq_compile(vm, func, &f, filename, printerror))) return SQ_ERROR;
+
+	/* A file that declared constants can't be cached either, as loading its bytecode wouldn't declare them. */
+	if (cacheable && GetConstTableSize(vm) == 0) {
+		ScriptBytecodeCacheEntry entry;
+		memcpy(entry.digest, digest, sizeof(digest));
+		if (SQ_SUCCEEDED(sq_writeclosure(vm, _io_vector_write, &entry.bytecode))) {
+			std::lock_guard<std::mutex> lock(_script_bytecode_cache_mutex);
+			_script_bytecode_cache[key] = std::move(entry);
+		}
+	}
+	return SQ_OK;
+}
+
 SQRESULT Squirrel::LoadFile(HSQUIRRELVM vm, const char *filename, SQBool printerror)
 {
 	ScriptAllocatorScope alloc_scope(this);
@@ -683,12 +885,12 @@ SQRESULT Squirrel::LoadFile(HSQUIRRELVM vm, const char *filename, SQBool printer
 				return sq_throwerror(vm, "cannot seek the file");
 			}
 
-			SQFile f(file, size);
-			if (SQ_SUCCEEDED(sq_readclosure(vm, _io_file_read, &f))) {
-				FioFCloseFile(file);
-				return SQ_OK;
-			}
+			std::string bytecode(size, '\0');
+			bool read = fread(bytecode.data(), 1, size, file) == size;
 			FioFCloseFile(file);
+
+			SQFile f(bytecode.data(), read ? size : 0);
+			if (SQ_SUCCEEDED(sq_readclosure(vm, _io_file_read, &f))) return SQ_OK;
 			return sq_throwerror(vm, "Couldn't read bytecode");
 		}
 		case 0xFFFE:
@@ -728,13 +930,15 @@ SQRESULT Squirrel::LoadFile(HSQUIRRELVM vm, const char *filename, SQBool printer
 			break;
 	}
 
-	SQFile f(file, size);
-	if (SQ_SUCCEEDED(sq_compile(vm, func, &f, filename, printerror))) {
+	/* Read the whole source at once; it is needed for the bytecode cache lookup anyway. */
+	std::string source(size, '\0');
+	if (fread(source.data(), 1, size, file) != size) {
 		FioFCloseFile(file);
-		return SQ_OK;
+		return sq_throwerror(vm, "I/O error");
 	}
 	FioFCloseFile(file);
-	return SQ_ERROR;
+
+	return CompileWithCache(vm, func, source, std::string(this->GetAPIName()) + ":" + filename, filename, printerror);
 }
 
 bool Squirrel::LoadScript(HSQUIRRELVM vm, const char *script, bool in_root)
@@ -849,3 +1053,9 @@ SQInteger Squirrel::GetOpsTillSuspend()
 {
 	return this->vm->_ops_till_suspend;
 }
+
+int Squirrel::GetLastResumeOps() const
+{
+	if (this->resume_ops <= 0) return 0;
+	return this->resume_ops - this->vm->_ops_till_suspend;
+}
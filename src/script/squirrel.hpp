@@ -31,6 +31,7 @@ private:
 	SQPrintFunc *print_func; ///< Points to either nullptr, or a custom print handler
 	bool crashed;            ///< True if the squirrel script made an error.
 	int overdrawn_ops;       ///< The amount of operations we have overdrawn.
+	int resume_ops;          ///< The amount of operations the last Resume started with, 0 if it did not run the script.
 	const char *APIName;     ///< Name of the API used for this squirrel.
 	std::unique_ptr<ScriptAllocator> allocator; ///< Allocator object used by this script.
 
@@ -271,6 +272,19 @@ public:
 	 */
 	SQInteger GetOpsTillSuspend();
 
+	/**
+	 * How many operations were executed during the last Resume?
+	 * This is also valid when the Resume was left via an exception.
+	 */
+	int GetLastResumeOps() const;
+
+	/**
+	 * Add operations to the overdrawn amount, so the next calls to Resume
+	 *  are skipped until they have been paid off.
+	 * @param ops The amount of operations to add.
+	 */
+	void AddOverdrawnOps(int ops) { this->overdrawn_ops += ops; }
+
 	/**
 	 * Completely reset the engine; start from scratch.
 	 */
@@ -281,6 +295,11 @@ public:
 	 */
 	size_t GetAllocatedMemory() const noexcept;
 
+	/**
+	 * Get number of bytes this VM's allocator holds on to, including unused pooled blocks.
+	 */
+	size_t GetReservedMemory() const noexcept;
+
 	void SetMemoryAllocationLimit(size_t limit) noexcept;
 };
 
@@ -33,6 +33,8 @@
 #include "command_func.h"
 #include "console_func.h"
 #include "pathfinder/pathfinder_type.h"
+#include "pathfinder/water_regions.h"
+#include "pathfinder/yapf/yapf_cache.h"
 #include "genworld.h"
 #include "train.h"
 #include "news_func.h"
@@ -1598,17 +1600,25 @@ static void UpdateFreeformEdges(int32 new_value)
 	if (_game_mode == GM_MENU) return;
 
 	if (new_value != 0) {
-		for (uint x = 0; x < MapSizeX(); x++) MakeVoid(TileXY(x, 0));
-		for (uint y = 0; y < MapSizeY(); y++) MakeVoid(TileXY(0, y));
+		for (uint x = 0; x < MapSizeX(); x++) {
+			MakeVoid(TileXY(x, 0));
+			InvalidateWaterRegion(TileXY(x, 0));
+		}
+		for (uint y = 0; y < MapSizeY(); y++) {
+			MakeVoid(TileXY(0, y));
+			InvalidateWaterRegion(TileXY(0, y));
+		}
 	} else {
 		/* Make tiles at the border water again. */
 		for (uint i = 0; i < MapMaxX(); i++) {
 			SetTileHeight(TileXY(i, 0), 0);
 			MakeSea(TileXY(i, 0));
+			InvalidateWaterRegion(TileXY(i, 0));
 		}
 		for (uint i = 0; i < MapMaxY(); i++) {
 			SetTileHeight(TileXY(0, i), 0);
 			MakeSea(TileXY(0, i));
+			InvalidateWaterRegion(TileXY(0, i));
 		}
 	}
 	MarkWholeScreenDirty();
@@ -1693,6 +1703,11 @@ static void InvalidateShipPathCache(int32 new_value)
 	}
 }
 
+static void InvalidateRoadSegmentCostCache(int32 new_value)
+{
+	YapfNotifyRoadLayoutChange(INVALID_TILE);
+}
+
 static void ImprovedBreakdownsSettingChanged(int32 new_value)
 {
 	if (!_settings_game.vehicle.improved_breakdowns) return;
@@ -232,6 +232,7 @@ struct GUISettings : public TimeSettings {
 	bool   auto_remove_signals;              ///< automatically remove signals when in the way during rail construction
 	uint16 refresh_rate;                     ///< How often we refresh the screen (time between draw-ticks).
 	uint16 fast_forward_speed_limit;         ///< Game speed to use when fast-forward is enabled.
+	uint16 fast_forward_refresh_rate;        ///< How often we refresh the screen while fast-forwarding, 0 to use refresh_rate.
 	uint8  show_vehicle_route_mode;          ///< How to show a vehicle's route when one of its windows is focused
 	bool   show_vehicle_route;               ///< Show route lines when vehicles route overlay is being shown
 	bool   show_vehicle_route_steps;         ///< Show route step markers when vehicles route overlay is being shown
@@ -392,6 +393,7 @@ struct NetworkSettings {
 	bool        reload_cfg;                               ///< reload the config file before restarting
 	std::string last_joined;                              ///< Last joined server
 	bool        no_http_content_downloads;                     ///< do not do content downloads over HTTP
+	uint8       http_content_download_concurrency;             ///< maximum number of content files to download over HTTP at the same time
 	UseRelayService use_relay_service;                    ///< Use relay service?
 };
 
@@ -571,6 +573,8 @@ struct YAPFSettings {
 	uint32 rail_shorter_platform_per_tile_penalty; ///< penalty for shorter station platform than train (per tile)
 	uint32 ship_curve45_penalty;                   ///< penalty for 45-deg curve for ships
 	uint32 ship_curve90_penalty;                   ///< penalty for 90-deg curve for ships
+	bool   ship_water_regions;                     ///< restrict the ship pathfinder to the water regions along a high level path
+	bool   rail_pathfind_batch;                    ///< share non-reserving train path searches between identical trains within a tick
 };
 
 /** Settings related to all pathfinders. */
@@ -724,6 +728,8 @@ struct LinkGraphSettings {
 	uint8 demand_distance;                      ///< influence of distance between stations on the demand function
 	uint8 short_path_saturation;                ///< percentage up to which short paths are saturated before saturating most capacious paths
 	uint16 aircraft_link_scale;                 ///< scale effective distance of aircraft links
+	bool mcf_warm_start;                        ///< seed the MCF solver with the previous flows of the link graph
+	uint8 mcf_parallel_batch;                   ///< number of MCF source nodes whose paths are searched in parallel, 0 to search sequentially
 
 	inline DistributionType GetDistributionType(CargoID cargo) const {
 		if (this->distribution_per_cargo[cargo] != DT_PER_CARGO_DEFAULT) return this->distribution_per_cargo[cargo];
@@ -783,6 +789,18 @@ struct DebugSettings {
 	uint32 newgrf_optimiser_flags;           ///< NewGRF optimiser flags
 };
 
+/** Settings related to multi-threading and performance tuning, these do not change the game state. */
+struct PerformanceSettings {
+	bool parallel_train_post_tick;           ///< run the per-vehicle part of the train tick after the controller on the worker pool
+	bool forked_autosave;                    ///< on dedicated servers, write autosaves from a forked copy-on-write child process
+	bool skip_unchanged_autosave;            ///< skip autosaves when no tick or command has run since the previous autosave
+	uint32 script_tick_time_budget;          ///< if non-zero, wall clock time in microseconds which a single script may use per tick on average, this makes script execution timing dependent
+	bool stagger_ai_ticks;                   ///< spread the ticks on which AIs run across the competitor speed interval, instead of running all AIs on the same tick
+	bool script_event_coalescing;            ///< drop per-vehicle script events while an identical event is still queued
+	uint32 script_event_queue_limit;         ///< if non-zero, maximum number of queued events per script, further events are dropped
+	uint32 incremental_cache_check_budget;   ///< if non-zero, average wall clock time in microseconds per tick used to continuously validate the caches, mismatches are logged to the desync log
+};
+
 /** Scenario editor settings. */
 struct ScenarioSettings {
 	bool multiple_buildings;                 ///< allow manually adding more than one church/stadium
@@ -826,6 +844,7 @@ struct ClientSettings {
 	MusicSettings        music;              ///< settings related to music/sound
 	NewsSettings         news_display;       ///< news display settings.
 	ScenarioSettings     scenario;           ///< scenario editor settings
+	PerformanceSettings  perf;               ///< performance tuning settings
 };
 
 /** The current settings for this game. */
@@ -34,6 +34,7 @@
 #include "tunnelbridge_map.h"
 #include "zoom_func.h"
 #include "framerate_type.h"
+#include "vehicle_profile.h"
 #include "industry.h"
 #include "industry_map.h"
 #include "core/checksum_func.hpp"
@@ -82,6 +83,11 @@ bool IsValidImageIndex<VEH_SHIP>(uint8 image_index)
 
 static inline TrackBits GetTileShipTrackStatus(TileIndex tile)
 {
+	/* Fast path for open water away from the map edge, which is most of the tiles ships travel over.
+	 * This gives the same result as GetTileTrackStatus_Water. */
+	if (IsWaterTile(tile) && TileX(tile) != 0 && TileY(tile) != 0) {
+		return IsTileFlat(tile) ? TRACK_BIT_ALL : TRACK_BIT_NONE;
+	}
 	return TrackdirBitsToTrackBits(GetTileTrackdirBits(tile, TRANSPORT_WATER, 0));
 }
 
@@ -579,6 +585,8 @@ static Track ChooseShipTrack(Ship *v, TileIndex tile, DiagDirection enterdir, Tr
 			v->path.clear();
 		}
 
+		PerformanceAccumulator framerate(PFE_GL_SHIP_PF);
+		VehicleProfileScope profile(v, VPC_PATHFINDING);
 		switch (_settings_game.pf.pathfinder_for_ships) {
 			case VPF_NPF: track = NPFShipChooseTrack(v, path_found); break;
 			case VPF_YAPF: track = YapfShipChooseTrack(v, tile, enterdir, tracks, path_found, v->path); break;
@@ -23,9 +23,11 @@
 #include "tunnelbridge.h"
 #include "bridge_signal_map.h"
 #include "newgrf_newsignals.h"
+#include "framerate_type.h"
 #include "core/checksum_func.hpp"
 #include "core/hash_func.hpp"
 #include "pathfinder/follow_track.hpp"
+#include "3rdparty/robin_hood/robin_hood.h"
 
 #include "safeguards.h"
 
@@ -47,10 +49,6 @@ static void MarkDependencidesForUpdate(SignalReference sig);
 /** these are the maximums used for updating signal blocks */
 static const uint SIG_TBU_SIZE    =  64; ///< number of signals entering to block
 static const uint SIG_TBD_SIZE    = 256; ///< number of intersections - open nodes in current block
-static const uint SIG_GLOB_SIZE   = 128; ///< number of open blocks (block can be opened more times until detected)
-static const uint SIG_GLOB_UPDATE =  64; ///< how many items need to be in _globset to force update
-
-static_assert(SIG_GLOB_UPDATE <= SIG_GLOB_SIZE);
 
 /** incidating trackbits with given enterdir */
 static const TrackBits _enterdir_to_trackbits[DIAGDIR_END] = {
@@ -207,19 +205,159 @@ public:
 	}
 };
 
+/**
+ * Growable set of 'tile and DiagDirection' items, used for the global signal update buffer
+ * Duplicate items are not added
+ * Small sets are searched linearly, larger sets additionally maintain a hash index
+ */
+struct SignalUpdateSet {
+private:
+	static const uint LINEAR_SEARCH_LIMIT = 32; ///< Number of items above which the hash index is used
+
+	/** Element of set */
+	struct SSdata {
+		TileIndex tile;
+		DiagDirection dir;
+	};
+	std::vector<SSdata> data;
+	robin_hood::unordered_flat_map<uint64, uint> index; ///< Index into data by item key, only valid when indexed is set
+	bool indexed = false;
+
+	static inline uint64 Key(TileIndex tile, DiagDirection dir)
+	{
+		return (static_cast<uint64>(tile) << 8) | static_cast<uint8>(dir);
+	}
+
+	/** Find the position of tile & dir in data, or -1 */
+	int Find(TileIndex tile, DiagDirection dir) const
+	{
+		if (this->indexed) {
+			auto iter = this->index.find(Key(tile, dir));
+			return iter != this->index.end() ? (int)iter->second : -1;
+		}
+		for (uint i = 0; i < (uint)this->data.size(); i++) {
+			if (this->data[i].tile == tile && this->data[i].dir == dir) return (int)i;
+		}
+		return -1;
+	}
+
+	void RemoveAt(uint i)
+	{
+		if (this->indexed) this->index.erase(Key(this->data[i].tile, this->data[i].dir));
+		if (i + 1 != this->data.size()) {
+			this->data[i] = this->data.back();
+			if (this->indexed) this->index[Key(this->data[i].tile, this->data[i].dir)] = i;
+		}
+		this->data.pop_back();
+		if (this->data.empty()) this->Reset();
+	}
+
+public:
+	/** Reset variables to default values */
+	void Reset()
+	{
+		this->data.clear();
+		this->index.clear();
+		this->indexed = false;
+	}
+
+	/**
+	 * Checks for empty set
+	 * @return is the set empty?
+	 */
+	bool IsEmpty() const
+	{
+		return this->data.empty();
+	}
+
+	/**
+	 * Reads the number of items
+	 * @return current number of items
+	 */
+	uint Items() const
+	{
+		return (uint)this->data.size();
+	}
+
+	/**
+	 * Tries to remove given tile and dir
+	 * @param tile tile
+	 * @param dir and dir to remove
+	 * @return element was found and removed
+	 */
+	bool Remove(TileIndex tile, DiagDirection dir)
+	{
+		if (this->data.empty()) return false;
+		int i = this->Find(tile, dir);
+		if (i < 0) return false;
+		this->RemoveAt((uint)i);
+		return true;
+	}
+
+	/**
+	 * Tries to find given tile and dir in the set
+	 * @param tile tile
+	 * @param dir and dir to find
+	 * @return true iff the tile & dir element was found
+	 */
+	bool IsIn(TileIndex tile, DiagDirection dir) const
+	{
+		return this->Find(tile, dir) >= 0;
+	}
+
+	/**
+	 * Adds tile & dir into the set as the last added element
+	 * If it is already present, it is moved instead of being added twice
+	 * @param tile tile
+	 * @param dir and dir to add
+	 */
+	void Add(TileIndex tile, DiagDirection dir)
+	{
+		this->Remove(tile, dir);
+
+		this->data.push_back({ tile, dir });
+		if (this->indexed) {
+			this->index[Key(tile, dir)] = (uint)this->data.size() - 1;
+		} else if (this->data.size() > LINEAR_SEARCH_LIMIT) {
+			this->indexed = true;
+			for (uint i = 0; i < (uint)this->data.size(); i++) {
+				this->index[Key(this->data[i].tile, this->data[i].dir)] = i;
+			}
+		}
+	}
+
+	/**
+	 * Reads and removes the last added element of the set
+	 * @param tile pointer where tile is written to
+	 * @param dir pointer where dir is written to
+	 * @return false iff the set was empty
+	 */
+	bool Get(TileIndex *tile, DiagDirection *dir)
+	{
+		if (this->data.empty()) return false;
+
+		*tile = this->data.back().tile;
+		*dir = this->data.back().dir;
+		this->RemoveAt((uint)this->data.size() - 1);
+
+		return true;
+	}
+};
+
 static SmallSet<Trackdir, SIG_TBU_SIZE> _tbuset("_tbuset");         ///< set of signals that will be updated
 static SmallSet<Trackdir, SIG_TBU_SIZE> _tbpset("_tbpset");         ///< set of PBS signals to update the aspect of
 static SmallSet<DiagDirection, SIG_TBD_SIZE> _tbdset("_tbdset");    ///< set of open nodes in current signal block
-static SmallSet<DiagDirection, SIG_GLOB_SIZE> _globset("_globset"); ///< set of places to be updated in following runs
+static SignalUpdateSet _globset;                                    ///< set of places to be updated in following runs, for owners in the same signal block as _last_owner
+
+/** Sets of places to be updated, for each owner which is not in the same signal block as _last_owner, see UpdateSignalsInBuffer */
+static std::vector<std::pair<Owner, SignalUpdateSet>> _pending_owner_globsets;
 
 static uint _num_signals_evaluated; ///< Number of programmable pre-signals evaluated
 
-/** Check whether there is a train on rail, not in a depot */
-static Vehicle *TrainOnTileEnum(Vehicle *v, void *)
+/** Check whether a train is on rail, not in a depot */
+static inline bool IsTrainOnRail(const Vehicle *v)
 {
-	if (Train::From(v)->track == TRACK_BIT_DEPOT) return nullptr;
-
-	return v;
+	return Train::From(v)->track != TRACK_BIT_DEPOT;
 }
 
 /** Check whether there is a train only on ramp. */
@@ -318,7 +456,13 @@ static SigInfo ExploreSegment(Owner owner)
 	TileIndex tile = INVALID_TILE; // Stop GCC from complaining about a possibly uninitialized variable (issue #8280).
 	DiagDirection enterdir = INVALID_DIAGDIR;
 
+	/* With realistic braking, UpdateSignalsAroundSegment treats any segment with a PBS signal or junction as occupied,
+	 * so once one of those has been found there is no need to search the rest of the segment for trains. */
+	const bool pbs_or_junction_implies_train = (_settings_game.vehicle.train_braking_model == TBM_REALISTIC);
+
 	while (_tbdset.Get(&tile, &enterdir)) { // tile and enterdir are initialized here, unless I'm mistaken.
+		if (pbs_or_junction_implies_train && ((info.flags & (SF_PBS | SF_JUNCTION)) || _tbuset.Items() > 1)) info.flags |= SF_TRAIN;
+
 		TileIndex oldtile = tile; // tile we are leaving
 		DiagDirection exitdir = enterdir == INVALID_DIAGDIR ? INVALID_DIAGDIR : ReverseDiagDir(enterdir); // expected new exit direction (for straight line)
 
@@ -329,14 +473,14 @@ static SigInfo ExploreSegment(Owner owner)
 				if (IsRailDepot(tile)) {
 					if (enterdir == INVALID_DIAGDIR) { // from 'inside' - train just entered or left the depot
 						if (_settings_game.vehicle.train_braking_model == TBM_REALISTIC) info.flags |= SF_PBS;
-						if (!(info.flags & SF_TRAIN) && HasVehicleOnPos(tile, VEH_TRAIN, nullptr, &TrainOnTileEnum)) info.flags |= SF_TRAIN;
+						if (!(info.flags & SF_TRAIN) && HasVehicleOnTile(tile, VEH_TRAIN, IsTrainOnRail)) info.flags |= SF_TRAIN;
 						exitdir = GetRailDepotDirection(tile);
 						tile += TileOffsByDiagDir(exitdir);
 						enterdir = ReverseDiagDir(exitdir);
 						break;
 					} else if (enterdir == GetRailDepotDirection(tile)) { // entered a depot
 						if (_settings_game.vehicle.train_braking_model == TBM_REALISTIC) info.flags |= SF_PBS;
-						if (!(info.flags & SF_TRAIN) && HasVehicleOnPos(tile, VEH_TRAIN, nullptr, &TrainOnTileEnum)) info.flags |= SF_TRAIN;
+						if (!(info.flags & SF_TRAIN) && HasVehicleOnTile(tile, VEH_TRAIN, IsTrainOnRail)) info.flags |= SF_TRAIN;
 						continue;
 					} else {
 						continue;
@@ -353,7 +497,7 @@ static SigInfo ExploreSegment(Owner owner)
 					if (!(info.flags & SF_TRAIN) && EnsureNoTrainOnTrackBits(tile, tracks).Failed()) info.flags |= SF_TRAIN;
 				} else {
 					if (tracks_masked == TRACK_BIT_NONE) continue; // no incidating track
-					if (!(info.flags & SF_TRAIN) && HasVehicleOnPos(tile, VEH_TRAIN, nullptr, &TrainOnTileEnum)) info.flags |= SF_TRAIN;
+					if (!(info.flags & SF_TRAIN) && HasVehicleOnTile(tile, VEH_TRAIN, IsTrainOnRail)) info.flags |= SF_TRAIN;
 				}
 
 				if (HasSignals(tile)) { // there is exactly one track - not zero, because there is exit from this tile
@@ -423,7 +567,7 @@ static SigInfo ExploreSegment(Owner owner)
 				if (DiagDirToAxis(enterdir) != GetRailStationAxis(tile)) continue; // different axis
 				if (IsStationTileBlocked(tile)) continue; // 'eye-candy' station tile
 
-				if (!(info.flags & SF_TRAIN) && HasVehicleOnPos(tile, VEH_TRAIN, nullptr, &TrainOnTileEnum)) info.flags |= SF_TRAIN;
+				if (!(info.flags & SF_TRAIN) && HasVehicleOnTile(tile, VEH_TRAIN, IsTrainOnRail)) info.flags |= SF_TRAIN;
 				tile += TileOffsByDiagDir(exitdir);
 				break;
 
@@ -432,7 +576,7 @@ static SigInfo ExploreSegment(Owner owner)
 				if (!IsOneSignalBlock(owner, GetTileOwner(tile))) continue;
 				if (DiagDirToAxis(enterdir) == GetCrossingRoadAxis(tile)) continue; // different axis
 
-				if (!(info.flags & SF_TRAIN) && HasVehicleOnPos(tile, VEH_TRAIN, nullptr, &TrainOnTileEnum)) info.flags |= SF_TRAIN;
+				if (!(info.flags & SF_TRAIN) && HasVehicleOnTile(tile, VEH_TRAIN, IsTrainOnRail)) info.flags |= SF_TRAIN;
 				if (_settings_game.vehicle.safer_crossings) info.flags |= SF_PBS;
 				tile += TileOffsByDiagDir(exitdir);
 				break;
@@ -455,7 +599,7 @@ static SigInfo ExploreSegment(Owner owner)
 							return EnsureNoTrainOnTrackBits(tile, tracks & (~across_tracks)).Failed();
 						}
 					} else {
-						return HasVehicleOnPos(tile, VEH_TRAIN, nullptr, &TrainOnTileEnum);
+						return HasVehicleOnTile(tile, VEH_TRAIN, IsTrainOnRail);
 					}
 				};
 
@@ -862,14 +1006,14 @@ static void UpdateSignalsAroundSegment(SigInfo info)
 			if (IsExitSignal(sig)) {
 				/* for pre-signal exits, add block to the global set */
 				DiagDirection exitdir = TrackdirToExitdir(ReverseTrackdir(trackdir));
-				_globset.Add(tile, exitdir); // do not check for full global set, first update all signals
+				_globset.Add(tile, exitdir);
 
 				// Progsig dependencies
 				MarkDependencidesForUpdate(SignalReference(tile, track));
 			} else if (_settings_game.vehicle.train_braking_model == TBM_REALISTIC && GetSignalAlwaysReserveThrough(tile, track)) {
 				/* for reserve through signals, add block to the global set */
 				DiagDirection exitdir = TrackdirToExitdir(ReverseTrackdir(trackdir));
-				_globset.Add(tile, exitdir); // do not check for full global set, first update all signals
+				_globset.Add(tile, exitdir);
 			}
 			SetSignalStateByTrackdir(tile, trackdir, newstate);
 			refresh = true;
@@ -923,6 +1067,8 @@ static SigSegState UpdateSignalsInBuffer(Owner owner)
 {
 	assert(Company::IsValidID(owner));
 
+	PerformanceAccumulator framerate(PFE_GL_SIGNALS);
+
 	bool first = true;  // first block?
 	SigSegState state = SIGSEG_FREE; // value to return
 	_num_signals_evaluated = 0;
@@ -1027,26 +1173,48 @@ static Owner _last_owner = INVALID_OWNER; ///< last owner whose track was put in
 
 
 /**
- * Update signals in buffer
+ * Update signals in buffer, for all owners
  * Called from 'outside'
  */
 void UpdateSignalsInBuffer()
 {
-	if (!_globset.IsEmpty()) {
-		UpdateSignalsInBuffer(_last_owner);
+	for (;;) {
+		if (!_globset.IsEmpty()) UpdateSignalsInBuffer(_last_owner);
 		_last_owner = INVALID_OWNER; // invalidate
+
+		if (_pending_owner_globsets.empty()) break;
+
+		/* Continue with the next owner */
+		_globset = std::move(_pending_owner_globsets.back().second);
+		_last_owner = _pending_owner_globsets.back().first;
+		_pending_owner_globsets.pop_back();
 	}
 }
 
 /**
- * Update signals in buffer if the owner could not be added to the current buffer
- * Called from 'outside'
+ * Make _globset the update set of the given owner.
+ * If _globset is currently in use by an owner which is not in the same signal block,
+ * it is set aside in _pending_owner_globsets, to be updated later by UpdateSignalsInBuffer.
+ * @param owner owner whose signals will be updated
  */
-void UpdateSignalsInBufferIfOwnerNotAddable(Owner owner)
+static void MakeSignalUpdateSetCurrent(Owner owner)
 {
-	if (!_globset.IsEmpty() && !IsOneSignalBlock(owner, _last_owner)) {
-		UpdateSignalsInBuffer(_last_owner);
-		_last_owner = INVALID_OWNER; // invalidate
+	if (!_globset.IsEmpty()) {
+		if (IsOneSignalBlock(owner, _last_owner)) {
+			_last_owner = owner;
+			return;
+		}
+		_pending_owner_globsets.emplace_back(_last_owner, std::move(_globset));
+		_globset.Reset();
+	}
+
+	_last_owner = owner;
+	for (auto iter = _pending_owner_globsets.begin(); iter != _pending_owner_globsets.end(); ++iter) {
+		if (IsOneSignalBlock(owner, iter->first)) {
+			_globset = std::move(iter->second);
+			_pending_owner_globsets.erase(iter);
+			break;
+		}
 	}
 }
 
@@ -1067,11 +1235,8 @@ void AddTrackToSignalBuffer(TileIndex tile, Track track, Owner owner)
 		DIAGDIR_SW, DIAGDIR_NW, DIAGDIR_NW, DIAGDIR_SW, DIAGDIR_NW, DIAGDIR_NE
 	};
 
-	/* do not allow signal updates for two companies in one run,
-	 * if these companies are not part of the same signal block */
-	assert(_globset.IsEmpty() || IsOneSignalBlock(owner, _last_owner));
-
-	_last_owner = owner;
+	/* signal updates for companies which are not part of the same signal block are batched separately */
+	MakeSignalUpdateSetCurrent(owner);
 
 	DiagDirection wormhole_dir = IsTileType(tile, MP_TUNNELBRIDGE) ? GetTunnelBridgeDirection(tile) : INVALID_DIAGDIR;
 
@@ -1080,12 +1245,6 @@ void AddTrackToSignalBuffer(TileIndex tile, Track track, Owner owner)
 	};
 	add_dir(_search_dir_1[track]);
 	add_dir(_search_dir_2[track]);
-
-	if (_globset.Items() >= SIG_GLOB_UPDATE) {
-		/* too many items, force update */
-		UpdateSignalsInBuffer(_last_owner);
-		_last_owner = INVALID_OWNER;
-	}
 }
 
 
@@ -1098,19 +1257,10 @@ void AddTrackToSignalBuffer(TileIndex tile, Track track, Owner owner)
  */
 void AddSideToSignalBuffer(TileIndex tile, DiagDirection side, Owner owner)
 {
-	/* do not allow signal updates for two companies in one run,
-	 * if these companies are not part of the same signal block */
-	assert(_globset.IsEmpty() || IsOneSignalBlock(owner, _last_owner));
-
-	_last_owner = owner;
+	/* signal updates for companies which are not part of the same signal block are batched separately */
+	MakeSignalUpdateSetCurrent(owner);
 
 	_globset.Add(tile, side);
-
-	if (_globset.Items() >= SIG_GLOB_UPDATE) {
-		/* too many items, force update */
-		UpdateSignalsInBuffer(_last_owner);
-		_last_owner = INVALID_OWNER;
-	}
 }
 
 /**
@@ -1125,7 +1275,7 @@ void AddSideToSignalBuffer(TileIndex tile, DiagDirection side, Owner owner)
  */
 SigSegState UpdateSignalsOnSegment(TileIndex tile, DiagDirection side, Owner owner)
 {
-	UpdateSignalsInBufferIfOwnerNotAddable(owner);
+	MakeSignalUpdateSetCurrent(owner);
 	_globset.Add(tile, side);
 
 	_last_owner = INVALID_OWNER;
@@ -185,7 +185,6 @@ void SetSignalsOnBothDir(TileIndex tile, Track track, Owner owner);
 void AddTrackToSignalBuffer(TileIndex tile, Track track, Owner owner);
 void AddSideToSignalBuffer(TileIndex tile, DiagDirection side, Owner owner);
 void UpdateSignalsInBuffer();
-void UpdateSignalsInBufferIfOwnerNotAddable(Owner owner);
 uint8 GetForwardAspectFollowingTrack(TileIndex tile, Trackdir trackdir);
 uint8 GetSignalAspectGeneric(TileIndex tile, Trackdir trackdir, bool check_non_inc_style);
 void PropagateAspectChange(TileIndex tile, Trackdir trackdir, uint8 aspect);
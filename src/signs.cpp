@@ -59,6 +59,7 @@ void Sign::UpdateVirtCoord()
 /** Update the coordinates of all signs */
 void UpdateAllSignVirtCoords()
 {
+	ViewportSignKdtreeBatchUpdate batch;
 	for (Sign *si : Sign::Iterate()) {
 		si->UpdateVirtCoord();
 	}
@@ -27,6 +27,7 @@
 #include "zoom_func.h"
 #include "object_map.h"
 #include "newgrf_object.h"
+#include "worker_thread.h"
 
 #include "smallmap_colours.h"
 #include "smallmap_gui.h"
@@ -942,6 +943,8 @@ void SmallMapWindow::DrawMapIndicators() const
 	SmallMapWindow::DrawHorizMapIndicator(upper_left.x, lower_right.x, lower_right.y);
 }
 
+static const size_t SMALLMAP_MIN_PARALLEL_COLUMNS = 64; ///< Minimum number of columns before the small map is drawn in parallel.
+
 /**
  * Draws the small map.
  *
@@ -976,6 +979,18 @@ void SmallMapWindow::DrawSmallMap(DrawPixelInfo *dpi, bool draw_indicators) cons
 	void *ptr = blitter->MoveTo(dpi->dst_ptr, x, y);
 	bool even = true;
 
+	/* Columns to draw; columns never write to the same pixel, so they can be drawn concurrently. */
+	struct SmallMapColumn {
+		void *ptr;
+		int tile_x;
+		int tile_y;
+		int reps;
+		int x;
+		int end_pos;
+		int y;
+	};
+	std::vector<SmallMapColumn> columns;
+
 	for (;;) {
 		/* Distance from left edge */
 		if (x > -4 * this->ui_zoom) {
@@ -984,7 +999,7 @@ void SmallMapWindow::DrawSmallMap(DrawPixelInfo *dpi, bool draw_indicators) cons
 			int end_pos = std::min(dpi->width, x + 4 * this->ui_zoom);
 			int reps = (dpi->height - y + 3 * this->ui_zoom - 1) / 2 / this->ui_zoom; // Number of lines.
 			if (reps > 0) {
-				this->DrawSmallMapColumn(ptr, tile_x, tile_y, dpi->pitch, reps, x, end_pos, y, dpi->height, blitter);
+				columns.push_back({ ptr, tile_x, tile_y, reps, x, end_pos, y });
 			}
 		}
 		if (even) {
@@ -1001,6 +1016,19 @@ void SmallMapWindow::DrawSmallMap(DrawPixelInfo *dpi, bool draw_indicators) cons
 		x += 2 * this->ui_zoom;
 	}
 
+	auto draw_column = [&](size_t i) {
+		const SmallMapColumn &col = columns[i];
+		this->DrawSmallMapColumn(col.ptr, col.tile_x, col.tile_y, dpi->pitch, col.reps, col.x, col.end_pos, col.y, dpi->height, blitter);
+	};
+	const uint workers = _general_worker_pool.GetWorkerCount();
+	if (workers > 0 && columns.size() >= SMALLMAP_MIN_PARALLEL_COLUMNS) {
+		/* Draw bands of adjacent columns in parallel. */
+		WorkerTaskGroup group;
+		group.ParallelFor(0, columns.size(), CeilDiv((uint)columns.size(), workers + 1), draw_column);
+	} else {
+		for (size_t i = 0; i < columns.size(); i++) draw_column(i);
+	}
+
 	/* Draw vehicles */
 	if (this->map_type == SMT_CONTOUR || this->map_type == SMT_VEHICLES) this->DrawVehicles(dpi, blitter);
 
@@ -14,6 +14,7 @@
 #include "random_access_file_type.h"
 #include "window_gui.h"
 #include "vehicle_base.h"
+#include "network/network.h"
 
 /* The type of set we're replacing */
 #define SET_TYPE "sounds"
@@ -179,6 +180,9 @@ static void StartSound(SoundID sound_id, float pan, uint volume)
 {
 	if (volume == 0) return;
 
+	/* Don't play the sounds of all the frames run while catching up with the network server. */
+	if (_network_catching_up) return;
+
 	SoundEntry *sound = GetSound(sound_id);
 	if (sound == nullptr) return;
 
@@ -37,6 +37,7 @@ uint _sprite_cache_size = 4;
 
 static size_t _spritecache_bytes_used = 0;
 static uint32 _sprite_lru_counter;
+static SpriteCacheStats _sprite_cache_stats;
 
 PACK_N(class SpriteDataBuffer {
 	void *ptr = nullptr;
@@ -593,14 +594,8 @@ static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_ty
 	return encoder->Encode(sprite, allocator);
 }
 
-struct GrfSpriteOffset {
-	size_t file_pos;
-	uint count;
-	byte control_flags;
-};
-
-/** Map from sprite numbers to position in the GRF file. */
-static btree::btree_map<uint32, GrfSpriteOffset> _grf_sprite_offsets;
+/** Map from sprite numbers to position in the GRF file currently being loaded. */
+static const btree::btree_map<uint32, GrfSpriteOffset> *_grf_sprite_offsets = nullptr;
 
 /**
  * Get the file offset for a specific sprite in the sprite section of a GRF.
@@ -609,8 +604,9 @@ static btree::btree_map<uint32, GrfSpriteOffset> _grf_sprite_offsets;
  */
 size_t GetGRFSpriteOffset(uint32 id)
 {
-	auto iter = _grf_sprite_offsets.find(id);
-	return iter != _grf_sprite_offsets.end() ? iter->second.file_pos : SIZE_MAX;
+	if (_grf_sprite_offsets == nullptr) return SIZE_MAX;
+	auto iter = _grf_sprite_offsets->find(id);
+	return iter != _grf_sprite_offsets->end() ? iter->second.file_pos : SIZE_MAX;
 }
 
 /**
@@ -619,11 +615,16 @@ size_t GetGRFSpriteOffset(uint32 id)
  */
 void ReadGRFSpriteOffsets(SpriteFile &file)
 {
-	_grf_sprite_offsets.clear();
+	_grf_sprite_offsets = &file.sprite_offsets;
 
 	if (file.GetContainerVersion() >= 2) {
 		/* Seek to sprite section of the GRF. */
 		size_t data_offset = file.ReadDword();
+
+		/* The sprite section has already been read, when loading an earlier stage. */
+		if (file.sprite_offsets_valid) return;
+		file.sprite_offsets_valid = true;
+
 		size_t old_pos = file.GetPos();
 		file.SeekTo(data_offset, SEEK_CUR);
 
@@ -634,7 +635,7 @@ void ReadGRFSpriteOffsets(SpriteFile &file)
 		uint32 id, prev_id = 0;
 		while ((id = file.ReadDword()) != 0) {
 			if (id != prev_id) {
-				_grf_sprite_offsets[prev_id] = offset;
+				file.sprite_offsets[prev_id] = offset;
 				offset.file_pos = file.GetPos() - 4;
 				offset.count = 0;
 				offset.control_flags = 0;
@@ -660,7 +661,7 @@ void ReadGRFSpriteOffsets(SpriteFile &file)
 			}
 			file.SkipBytes(length);
 		}
-		if (prev_id != 0) _grf_sprite_offsets[prev_id] = offset;
+		if (prev_id != 0) file.sprite_offsets[prev_id] = offset;
 
 		/* Continue processing the data section. */
 		file.SeekTo(old_pos, SEEK_SET);
@@ -707,8 +708,8 @@ bool LoadNextSprite(int load_index, SpriteFile &file, uint file_sprite_id)
 			return false;
 		}
 		/* It is not an error if no sprite with the provided ID is found in the sprite section. */
-		auto iter = _grf_sprite_offsets.find(file.ReadDword());
-		if (iter != _grf_sprite_offsets.end()) {
+		auto iter = file.sprite_offsets.find(file.ReadDword());
+		if (iter != file.sprite_offsets.end()) {
 			file_pos = iter->second.file_pos;
 			count = iter->second.count;
 			control_flags = iter->second.control_flags;
@@ -778,6 +779,35 @@ static size_t GetSpriteCacheUsage()
 	return _spritecache_bytes_used;
 }
 
+static size_t GetSpriteCacheTargetSize()
+{
+	int bpp = BlitterFactory::GetCurrentBlitter()->GetScreenDepth();
+	return (bpp > 0 ? _sprite_cache_size * bpp / 8 : 1) * 1024 * 1024;
+}
+
+/**
+ * Get the usage statistics of the sprite cache.
+ * @return Hit/miss/eviction counters and the current memory use.
+ */
+SpriteCacheStats GetSpriteCacheStats()
+{
+	SpriteCacheStats stats = _sprite_cache_stats;
+	stats.bytes_used = GetSpriteCacheUsage();
+	stats.target_size = GetSpriteCacheTargetSize();
+	return stats;
+}
+
+/**
+ * Whether a sprite cache entry may be evicted to make room.
+ * Recolour and font sprites are small compared to their reload cost, so are kept.
+ * @param sc Sprite cache entry.
+ * @return True if the entry is loaded and may be evicted.
+ */
+static inline bool IsSpriteCacheEntryEvictable(SpriteCache *sc)
+{
+	return sc->GetType() != SpriteType::Recolour && sc->GetType() != SpriteType::Font && sc->GetPtr() != nullptr;
+}
+
 /**
  * Delete a single entry from the sprite cache.
  * @param item Entry to delete.
@@ -819,14 +849,14 @@ static void DeleteEntriesFromSpriteCache(size_t target)
 	SpriteID i = 0;
 	for (; i != _spritecache.size() && candidate_bytes < target; i++) {
 		SpriteCache *sc = GetSpriteCache(i);
-		if (sc->GetType() != SpriteType::Recolour && sc->GetPtr() != nullptr) {
+		if (IsSpriteCacheEntryEvictable(sc)) {
 			push({ sc->lru, i, sc->buffer.GetSize() });
 			if (candidate_bytes >= target) break;
 		}
 	}
 	for (; i != _spritecache.size(); i++) {
 		SpriteCache *sc = GetSpriteCache(i);
-		if (sc->GetType() != SpriteType::Recolour && sc->GetPtr() != nullptr && sc->lru <= candidates.front().lru) {
+		if (IsSpriteCacheEntryEvictable(sc) && sc->lru <= candidates.front().lru) {
 			push({ sc->lru, i, sc->buffer.GetSize() });
 			while (!candidates.empty() && candidate_bytes - candidates.front().size >= target) {
 				pop();
@@ -837,6 +867,8 @@ static void DeleteEntriesFromSpriteCache(size_t target)
 	for (auto &it : candidates) {
 		DeleteEntryFromSpriteCache(it.id);
 	}
+	_sprite_cache_stats.evictions += candidates.size();
+	_sprite_cache_stats.evicted_bytes += candidate_bytes;
 
 	DEBUG(sprite, 3, "DeleteEntriesFromSpriteCache, deleted: " PRINTF_SIZE ", freed: " PRINTF_SIZE ", in use: " PRINTF_SIZE " --> " PRINTF_SIZE ", delta: " PRINTF_SIZE ", requested: " PRINTF_SIZE,
 			candidates.size(), candidate_bytes, initial_in_use, GetSpriteCacheUsage(), initial_in_use - GetSpriteCacheUsage(), target);
@@ -844,8 +876,7 @@ static void DeleteEntriesFromSpriteCache(size_t target)
 
 void IncreaseSpriteLRU()
 {
-	int bpp = BlitterFactory::GetCurrentBlitter()->GetScreenDepth();
-	uint target_size = (bpp > 0 ? _sprite_cache_size * bpp / 8 : 1) * 1024 * 1024;
+	const size_t target_size = GetSpriteCacheTargetSize();
 	if (_spritecache_bytes_used > target_size) {
 		DeleteEntriesFromSpriteCache(_spritecache_bytes_used - target_size + 512 * 1024);
 	}
@@ -956,9 +987,12 @@ void *GetRawSprite(SpriteID sprite, SpriteType type, AllocatorProc *allocator, S
 
 		/* Load the sprite, if it is not loaded, yet */
 		if (sc->GetPtr() == nullptr) {
+			_sprite_cache_stats.misses++;
 			void *ptr = ReadSprite(sc, sprite, type, AllocSprite, nullptr);
 			assert(ptr == _last_sprite_allocation.GetPtr());
 			sc->buffer = std::move(_last_sprite_allocation);
+		} else {
+			_sprite_cache_stats.hits++;
 		}
 
 		return sc->GetPtr();
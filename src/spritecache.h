@@ -34,6 +34,16 @@ enum SpriteCacheCtrlFlags {
 
 extern uint _sprite_cache_size;
 
+/** Usage statistics of the sprite cache, for tuning the sprite cache size. */
+struct SpriteCacheStats {
+	uint64 hits = 0;          ///< Number of requests for sprites which were already in the cache.
+	uint64 misses = 0;        ///< Number of requests for sprites which had to be read and decoded.
+	uint64 evictions = 0;     ///< Number of sprites which were evicted from the cache.
+	uint64 evicted_bytes = 0; ///< Number of bytes freed by evicting sprites.
+	size_t bytes_used = 0;    ///< Number of bytes currently used by the cache.
+	size_t target_size = 0;   ///< Size in bytes which the cache is trimmed to.
+};
+
 typedef void *AllocatorProc(size_t size);
 
 void *SimpleSpriteAlloc(size_t size);
@@ -63,6 +73,7 @@ void GfxInitSpriteMem();
 void GfxClearSpriteCache();
 void GfxClearFontSpriteCache();
 void IncreaseSpriteLRU();
+SpriteCacheStats GetSpriteCacheStats();
 
 SpriteFile &OpenCachedSpriteFile(const std::string &filename, Subdirectory subdir, bool palette_remap);
 
@@ -96,7 +107,9 @@ public:
 
 	inline void CacheSprite(SpriteID sprite, SpriteType type)
 	{
-		this->cache[sprite | (static_cast<uint32>(type) << 29)] = GetRawSprite(sprite, type);
+		/* Most sprites are drawn many times per viewport, only look each one up once */
+		auto res = this->cache.insert({ sprite | (static_cast<uint32>(type) << 29), nullptr });
+		if (res.second) res.first->second = GetRawSprite(sprite, type);
 	}
 };
 
@@ -11,6 +11,7 @@
 #define SPRITE_FILE_TYPE_HPP
 
 #include "../random_access_file_type.h"
+#include "../3rdparty/cpp-btree/btree_map.h"
 
 enum SpriteFileFlags : uint8 {
 	SFF_NONE                  = 0,
@@ -20,6 +21,13 @@ enum SpriteFileFlags : uint8 {
 };
 DECLARE_ENUM_AS_BIT_SET(SpriteFileFlags)
 
+/** Position and properties of a sprite in the sprite section of a GRF. */
+struct GrfSpriteOffset {
+	size_t file_pos;
+	uint count;
+	byte control_flags;
+};
+
 /**
  * RandomAccessFile with some extra information specific for sprite files.
  * It automatically detects and stores the container version upload opening the file.
@@ -31,6 +39,8 @@ class SpriteFile : public RandomAccessFile {
 
 public:
 	SpriteFileFlags flags = SFF_NONE;
+	bool sprite_offsets_valid = false;                            ///< Whether sprite_offsets has been read from the sprite section.
+	btree::btree_map<uint32, GrfSpriteOffset> sprite_offsets;     ///< Map from sprite numbers to position in the sprite section, see #ReadGRFSpriteOffsets.
 
 	SpriteFile(const std::string &filename, Subdirectory subdir, bool palette_remap);
 	SpriteFile(const SpriteFile&) = delete;
@@ -54,6 +54,16 @@ void RebuildStationKdtree()
 	_station_kdtree.Build(stids.begin(), stids.end());
 }
 
+btree::btree_set<StationID> _stations_with_loading_vehicles;
+
+void RebuildStationsWithLoadingVehicles()
+{
+	_stations_with_loading_vehicles.clear();
+	for (const Station *st : Station::Iterate()) {
+		if (!st->loading_vehicles.empty()) _stations_with_loading_vehicles.insert(st->index);
+	}
+}
+
 
 BaseStation::~BaseStation()
 {
@@ -201,6 +211,26 @@ bool BaseStation::SetRoadStopTileData(TileIndex tile, byte data, bool animation)
 	return data != 0;
 }
 
+/**
+ * Get the tiles of the train station area which belong to this station.
+ * For stations spread out using distant-join the train station area can contain many tiles of other stations,
+ * so this avoids having to check all of those.
+ * @return The rail station tiles, in the same order as iterating over train_station.
+ */
+const std::vector<TileIndex> &BaseStation::GetRailStationTiles() const
+{
+	if (!this->cached_rail_station_tiles_valid) {
+		this->cached_rail_station_tiles.clear();
+		if (this->train_station.tile != INVALID_TILE) {
+			for (TileIndex tile : this->train_station) {
+				if (this->TileBelongsToRailStation(tile)) this->cached_rail_station_tiles.push_back(tile);
+			}
+		}
+		this->cached_rail_station_tiles_valid = true;
+	}
+	return this->cached_rail_station_tiles;
+}
+
 void BaseStation::RemoveRoadStopTileData(TileIndex tile)
 {
 	for (RoadStopTileData &tile_data : this->custom_roadstop_tile_data) {
@@ -245,6 +245,15 @@ public:
 	 */
 	inline uint GetUnrestricted() const { return this->unrestricted; }
 
+	/**
+	 * Get the number of bytes allocated by this FlowStat outside of itself.
+	 * @return Size of the out of line share storage.
+	 */
+	inline size_t GetHeapMemoryUsage() const
+	{
+		return this->inline_mode() ? 0 : this->storage.ptr_shares.elem_capacity * sizeof(ShareEntry);
+	}
+
 	/**
 	 * Swap the shares maps, and thus the content of this FlowStat with the
 	 * other one.
@@ -456,6 +465,17 @@ public:
 		return this->flows_storage.size();
 	}
 
+	/**
+	 * Get the number of bytes allocated by this map, including the share storage of the flows.
+	 * @return The number of bytes.
+	 */
+	size_t GetMemoryUsage() const
+	{
+		size_t bytes = this->flows_storage.capacity() * sizeof(FlowStat) + this->flows_index.bytes_used();
+		for (const FlowStat &flow : this->flows_storage) bytes += flow.GetHeapMemoryUsage();
+		return bytes;
+	}
+
 	void erase(StationID st)
 	{
 		auto iter = this->flows_index.find(st);
@@ -592,10 +612,13 @@ struct GoodsEntry {
 	byte last_age;
 
 	byte amount_fract;      ///< Fractional part of the amount in the cargo list
-	StationCargoList cargo; ///< The cargo packets of cargo waiting in this station
 
+	/* The fields above and the link graph IDs below are kept together at the start of the entry,
+	 * as they are scanned for every cargo type of each station in the periodic station loops. */
 	LinkGraphID link_graph; ///< Link graph this station belongs to.
 	NodeID node;            ///< ID of node in link graph referring to this goods entry.
+
+	StationCargoList cargo; ///< The cargo packets of cargo waiting in this station
 	FlowStatMap flows;      ///< Planned flows through this station.
 	uint max_waiting_cargo; ///< Max cargo from this station waiting at any station.
 
@@ -932,6 +955,13 @@ public:
 
 void RebuildStationKdtree();
 
+/**
+ * Stations which may have vehicles in their loading_vehicles list, in index order.
+ * This is a superset, stations are added when a vehicle starts loading and removed lazily by LoadUnloadStations.
+ */
+extern btree::btree_set<StationID> _stations_with_loading_vehicles;
+void RebuildStationsWithLoadingVehicles();
+
 /**
  * Call a function on all stations that have any part of the requested area within their catchment.
  * @tparam Func The type of funcion to call
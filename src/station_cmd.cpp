@@ -25,6 +25,7 @@
 #include "newgrf_station.h"
 #include "newgrf_canal.h" /* For the buoy */
 #include "pathfinder/yapf/yapf_cache.h"
+#include "pathfinder/water_regions.h"
 #include "road_internal.h" /* For drawing catenary/checking road removal */
 #include "autoslope.h"
 #include "water.h"
@@ -60,6 +61,7 @@
 #include "cheat_type.h"
 #include "newgrf_roadstop.h"
 #include "core/math_func.hpp"
+#include "tracing.h"
 
 #include "table/strings.h"
 
@@ -529,6 +531,7 @@ void Station::MoveSign(TileIndex new_xy)
 /** Update the virtual coords needed to draw the station sign for all stations. */
 void UpdateAllStationVirtCoords()
 {
+	ViewportSignKdtreeBatchUpdate batch;
 	for (BaseStation *st : BaseStation::Iterate()) {
 		st->UpdateVirtCoord();
 	}
@@ -643,6 +646,76 @@ CargoArray GetAcceptanceAroundTiles(TileIndex center_tile, int w, int h, int rad
 	return acceptance;
 }
 
+/**
+ * Record the acceptance of the given cargoes for all tiles of an area.
+ * @param area Area to record, rectangles passed to #GetAcceptanceAroundTiles must lie within this area.
+ * @param cargo_mask Cargoes to record the acceptance of.
+ */
+AcceptanceAreaSums::AcceptanceAreaSums(OrthogonalTileArea area, CargoTypes cargo_mask) : area(area)
+{
+	for (CargoID c : SetCargoBitIterator(cargo_mask)) {
+		this->cargoes.push_back(c);
+	}
+	const size_t num_cargoes = this->cargoes.size();
+	const uint row = this->area.w + 1;
+	this->sums.resize(row * (this->area.h + 1) * num_cargoes);
+	if (num_cargoes == 0) return;
+
+	const uint base_x = TileX(this->area.tile);
+	const uint base_y = TileY(this->area.tile);
+	for (uint y = 0; y < this->area.h; y++) {
+		for (uint x = 0; x < this->area.w; x++) {
+			TileIndex tile = TileXY(base_x + x, base_y + y);
+			CargoArray acceptance;
+
+			/* Ignore industry if it has a neutral station, as in GetAcceptanceAroundTiles. */
+			if (_settings_game.station.serve_neutral_industries || !IsTileType(tile, MP_INDUSTRY) || Industry::GetByTile(tile)->neutral_station == nullptr) {
+				AddAcceptedCargo(tile, acceptance, nullptr);
+			}
+
+			uint *out = &this->sums[(((y + 1) * row) + x + 1) * num_cargoes];
+			const uint *above = &this->sums[((y * row) + x + 1) * num_cargoes];
+			const uint *left = &this->sums[(((y + 1) * row) + x) * num_cargoes];
+			const uint *above_left = &this->sums[((y * row) + x) * num_cargoes];
+			for (size_t i = 0; i < num_cargoes; i++) {
+				out[i] = acceptance[this->cargoes[i]] + above[i] + left[i] - above_left[i];
+			}
+		}
+	}
+}
+
+/**
+ * Get the acceptance of the recorded cargoes around the tile in 1/8, this is equivalent to ::GetAcceptanceAroundTiles for those cargoes.
+ * @param tile Northern tile of the search area
+ * @param w X extent of area
+ * @param h Y extent of area
+ * @param rad Search radius in addition to given area
+ * @return Acceptance, other cargoes than those recorded are 0.
+ */
+CargoArray AcceptanceAreaSums::GetAcceptanceAroundTiles(TileIndex tile, int w, int h, int rad) const
+{
+	CargoArray acceptance;
+	const size_t num_cargoes = this->cargoes.size();
+	if (num_cargoes == 0) return acceptance;
+
+	TileArea ta = TileArea(tile, w, h).Expand(rad);
+	dbg_assert(this->area.Contains(ta.tile) && this->area.Contains(TILE_ADDXY(ta.tile, ta.w - 1, ta.h - 1)));
+
+	const uint row = this->area.w + 1;
+	const uint x0 = TileX(ta.tile) - TileX(this->area.tile);
+	const uint y0 = TileY(ta.tile) - TileY(this->area.tile);
+	const uint x1 = x0 + ta.w;
+	const uint y1 = y0 + ta.h;
+	const uint *bottom_right = &this->sums[((y1 * row) + x1) * num_cargoes];
+	const uint *top_right = &this->sums[((y0 * row) + x1) * num_cargoes];
+	const uint *bottom_left = &this->sums[((y1 * row) + x0) * num_cargoes];
+	const uint *top_left = &this->sums[((y0 * row) + x0) * num_cargoes];
+	for (size_t i = 0; i < num_cargoes; i++) {
+		acceptance[this->cargoes[i]] = bottom_right[i] - top_right[i] - bottom_left[i] + top_left[i];
+	}
+	return acceptance;
+}
+
 /**
  * Get the acceptance of cargoes around the station in.
  * @param st Station to get acceptance of.
@@ -1632,6 +1705,7 @@ CommandCost CmdBuildRailStation(TileIndex tile_org, DoCommandFlag flags, uint32
 				DeleteAnimatedTile(tile);
 				byte old_specindex = HasStationTileRail(tile) ? GetCustomStationSpecIndex(tile) : 0;
 				MakeRailStation(tile, st->owner, st->index, axis, layout & ~1, rt);
+				st->InvalidateRailStationTiles();
 				/* Free the spec if we overbuild something */
 				if (old_specindex != specindex) DeallocateSpecFromStation(st, old_specindex);
 
@@ -1872,6 +1946,7 @@ CommandCost RemoveFromRailBaseStation(TileArea ta, std::vector<T *> &affected_st
 			if (!build_rail && !IsStationTileBlocked(tile)) Company::Get(owner)->infrastructure.rail[rt]--;
 
 			DoClearSquare(tile);
+			st->InvalidateRailStationTiles();
 			DeleteNewGRFInspectWindow(GSF_STATIONS, tile);
 			if (build_rail) MakeRailNormal(tile, owner, TrackToTrackBits(track), rt);
 			Company::Get(owner)->infrastructure.station--;
@@ -3087,6 +3162,8 @@ CommandCost CmdBuildDock(TileIndex tile, DoCommandFlag flags, uint32 p1, uint32
 		Company::Get(st->owner)->infrastructure.station += 2;
 
 		MakeDock(tile, st->owner, st->index, direction, wc);
+		InvalidateWaterRegion(tile);
+		InvalidateWaterRegion(flat_tile);
 		UpdateStationDockingTiles(st);
 
 		st->AfterStationTileSetChange(true, STATION_DOCK);
@@ -3327,6 +3404,7 @@ static void DrawTile_Station(TileInfo *ti, DrawTileProcParams params)
 	BaseStation *st = nullptr;
 	const StationSpec *statspec = nullptr;
 	uint tile_layout = 0;
+	std::optional<StationTileVariableCacheScope> svc_scope;
 
 	if (HasStationRail(ti->tile)) {
 		rti = GetRailTypeInfo(GetRailType(ti->tile));
@@ -3338,6 +3416,7 @@ static void DrawTile_Station(TileInfo *ti, DrawTileProcParams params)
 			statspec = st->speclist[GetCustomStationSpecIndex(ti->tile)].spec;
 
 			if (statspec != nullptr) {
+				svc_scope.emplace(ti->tile);
 				tile_layout = GetStationGfx(ti->tile);
 
 				if (HasBit(statspec->callback_mask, CBM_STATION_SPRITE_LAYOUT)) {
@@ -4051,7 +4130,7 @@ void TriggerWatchedCargoCallbacks(Station *st)
 {
 	/* Collect cargoes accepted since the last big tick. */
 	CargoTypes cargoes = 0;
-	for (CargoID cid = 0; cid < NUM_CARGO; cid++) {
+	for (CargoID cid : SetCargoBitIterator(_cargo_mask)) {
 		if (HasBit(st->goods[cid].status, GoodsEntry::GES_ACCEPTED_BIGTICK)) SetBit(cargoes, cid);
 	}
 
@@ -4224,7 +4303,15 @@ int GetVehicleAgeRating(const GoodsEntry *ge)
 	return rating;
 }
 
-int GetTargetRating(const Station *st, const CargoSpec *cs, const GoodsEntry *ge)
+/**
+ * Get the rating a goods entry is moving towards.
+ * @param st Station of the goods entry.
+ * @param cs Cargo of the goods entry.
+ * @param ge The goods entry.
+ * @param statue_rating Result of GetStatueRating(st), which is the same for all cargoes of the station.
+ * @return Target rating.
+ */
+int GetTargetRating(const Station *st, const CargoSpec *cs, const GoodsEntry *ge, int statue_rating)
 {
 	bool skip = false;
 	int rating = 0;
@@ -4248,7 +4335,7 @@ int GetTargetRating(const Station *st, const CargoSpec *cs, const GoodsEntry *ge
 		rating += GetWaitingCargoRating(st, ge);
 	}
 
-	rating += GetStatueRating(st);
+	rating += statue_rating;
 	rating += GetVehicleAgeRating(ge);
 
 	return Clamp(rating, 0, 255);
@@ -4261,6 +4348,8 @@ static void UpdateStationRating(Station *st)
 	byte_inc_sat(&st->time_since_load);
 	byte_inc_sat(&st->time_since_unload);
 
+	const int statue_rating = GetStatueRating(st);
+
 	for (const CargoSpec *cs : CargoSpec::Iterate()) {
 		GoodsEntry *ge = &st->goods[cs->Index()];
 
@@ -4284,7 +4373,7 @@ static void UpdateStationRating(Station *st)
 			}
 
 			{
-				int rating = GetTargetRating(st, cs, ge);
+				int rating = GetTargetRating(st, cs, ge, statue_rating);
 
 				uint waiting = ge->cargo.AvailableCount();
 
@@ -4615,6 +4704,8 @@ void OnTick_Station()
 {
 	if (_game_mode == GM_EDITOR) return;
 
+	TRACE_SCOPE("OnTick_Station");
+
 	ClearDeleteStaleLinksVehicleCache();
 
 	for (BaseStation *st : BaseStation::Iterate()) {
@@ -4866,8 +4957,9 @@ CommandCost CmdSetStationCargoAllowedSupply(TileIndex tile, DoCommandFlag flags,
 
 static void AddNearbyStationsByCatchment(TileIndex tile, StationList *stations, StationList &nearby)
 {
+	/* nearby is iterated in the same order as stations is sorted in, so always insert at the end. */
 	for (Station *st : nearby) {
-		if (st->TileIsInCatchment(tile)) stations->insert(st);
+		if (st->TileIsInCatchment(tile)) stations->insert(stations->end(), st);
 	}
 }
 
@@ -5051,6 +5143,7 @@ void BuildOilRig(TileIndex tile)
 	st->industry->neutral_station = st;
 	DeleteAnimatedTile(tile);
 	MakeOilrig(tile, st->index, GetWaterClass(tile));
+	InvalidateWaterRegion(tile);
 
 	st->owner = OWNER_NONE;
 	st->airport.type = AT_OILRIG;
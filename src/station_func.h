@@ -19,6 +19,9 @@
 #include "road.h"
 #include "linkgraph/linkgraph_type.h"
 #include "industry_type.h"
+#include "tilearea_type.h"
+
+#include <vector>
 
 void ModifyStationRatingAround(TileIndex tile, Owner owner, int amount, uint radius);
 
@@ -29,6 +32,21 @@ void ClearAllStationCachedNames();
 CargoArray GetProductionAroundTiles(TileIndex tile, int w, int h, int rad);
 CargoArray GetAcceptanceAroundTiles(TileIndex tile, int w, int h, int rad, CargoTypes *always_accepted = nullptr);
 
+/**
+ * Per tile acceptance of a set of cargoes within an area, stored as 2D prefix sums.
+ * This answers repeated GetAcceptanceAroundTiles-style queries for rectangles inside the area
+ * in constant time per cargo, instead of rescanning every tile of each rectangle.
+ */
+class AcceptanceAreaSums {
+	OrthogonalTileArea area;      ///< Area covered, all queried rectangles must lie within this area.
+	std::vector<CargoID> cargoes; ///< Cargoes for which acceptance is recorded.
+	std::vector<uint> sums;       ///< Prefix sums, indexed by ((y * (area.w + 1)) + x) * cargoes.size() + cargo index.
+
+public:
+	AcceptanceAreaSums(OrthogonalTileArea area, CargoTypes cargo_mask);
+	CargoArray GetAcceptanceAroundTiles(TileIndex tile, int w, int h, int rad) const;
+};
+
 void UpdateStationAcceptance(Station *st, bool show_msg);
 
 const DrawTileSprites *GetStationTileLayout(StationType st, byte gfx);
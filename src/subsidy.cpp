@@ -27,6 +27,8 @@
 
 #include "table/strings.h"
 
+#include "3rdparty/cpp-btree/btree_map.h"
+
 #include "safeguards.h"
 
 SubsidyPool _subsidy_pool("Subsidy"); ///< Pool for the subsidies.
@@ -314,6 +316,36 @@ bool FindSubsidyPassengerRoute()
 bool FindSubsidyCargoDestination(CargoID cid, SourceType src_type, SourceID src);
 
 
+/** Produced and accepted cargo of the houses around a town centre, memoised for one subsidy search pass. */
+struct SubsidyTownCargo {
+	CargoArray produced;
+	CargoArray accepted;
+};
+static btree::btree_map<TownID, SubsidyTownCargo> _subsidy_town_cargo;
+
+/**
+ * Get the produced and accepted cargo of the houses around the centre of a town.
+ * The result is memoised until the end of the current SubsidyMonthlyLoop pass, as
+ * the same towns are drawn repeatedly by the retry loops there.
+ * @param t The town.
+ * @return The cargo produced and accepted around the town centre.
+ */
+static const SubsidyTownCargo &GetSubsidyTownCargo(const Town *t)
+{
+	auto iter = _subsidy_town_cargo.find(t->index);
+	if (iter != _subsidy_town_cargo.end()) return iter->second;
+
+	SubsidyTownCargo &cargo = _subsidy_town_cargo[t->index];
+	TileArea ta = TileArea(t->xy, 1, 1).Expand(SUBSIDY_TOWN_CARGO_RADIUS);
+	for (TileIndex tile : ta) {
+		if (IsTileType(tile, MP_HOUSE)) {
+			AddProducedCargo(tile, cargo.produced);
+			AddAcceptedCargo(tile, cargo.accepted, nullptr);
+		}
+	}
+	return cargo;
+}
+
 /**
  * Tries to create a cargo subsidy with a town as source.
  * @return True iff the subsidy was created.
@@ -329,13 +361,7 @@ bool FindSubsidyTownCargoRoute()
 	if (src_town->cache.population < SUBSIDY_CARGO_MIN_POPULATION) return false;
 
 	/* Calculate the produced cargo of houses around town center. */
-	CargoArray town_cargo_produced;
-	TileArea ta = TileArea(src_town->xy, 1, 1).Expand(SUBSIDY_TOWN_CARGO_RADIUS);
-	for (TileIndex tile : ta) {
-		if (IsTileType(tile, MP_HOUSE)) {
-			AddProducedCargo(tile, town_cargo_produced);
-		}
-	}
+	CargoArray town_cargo_produced = GetSubsidyTownCargo(src_town).produced;
 
 	/* Passenger subsidies are not handled here. */
 	town_cargo_produced[CT_PASSENGERS] = 0;
@@ -439,17 +465,8 @@ bool FindSubsidyCargoDestination(CargoID cid, SourceType src_type, SourceID src)
 			/* Select a random town. */
 			const Town *dst_town = Town::GetRandom();
 
-			/* Calculate cargo acceptance of houses around town center. */
-			CargoArray town_cargo_accepted;
-			TileArea ta = TileArea(dst_town->xy, 1, 1).Expand(SUBSIDY_TOWN_CARGO_RADIUS);
-			for (TileIndex tile : ta) {
-				if (IsTileType(tile, MP_HOUSE)) {
-					AddAcceptedCargo(tile, town_cargo_accepted, nullptr);
-				}
-			}
-
-			/* Check if the town can accept this cargo. */
-			if (town_cargo_accepted[cid] < 8) return false;
+			/* Check if the houses around the town center can accept this cargo. */
+			if (GetSubsidyTownCargo(dst_town).accepted[cid] < 8) return false;
 
 			dst = dst_town->index;
 			break;
@@ -553,6 +570,8 @@ void SubsidyMonthlyLoop()
 		} while (!industry_subsidy && n--);
 	}
 
+	_subsidy_town_cargo.clear();
+
 	modified |= passenger_subsidy || town_subsidy || industry_subsidy;
 
 	if (modified) InvalidateWindowData(WC_SUBSIDIES_LIST, 0);
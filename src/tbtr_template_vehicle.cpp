@@ -49,6 +49,24 @@ robin_hood::unordered_flat_map<GroupID, TemplateID> _template_replacement_index;
 robin_hood::unordered_flat_map<GroupID, TemplateID> _template_replacement_index_recursive;
 static uint32 _template_replacement_index_recursive_guard = 0;
 
+/** How a train differs from the template of its group. */
+enum TrainTemplateDifference : uint8 {
+	TTD_NONE,    ///< The train matches the template, or its group has no template.
+	TTD_ENGINES, ///< The engines differ from the template.
+	TTD_REFIT,   ///< The engines match, but the refit or orientation differs from a template which refits.
+};
+
+/** Cached difference of a train from the template of its group. */
+struct TrainTemplateDifferenceEntry {
+	GroupID group;                     ///< Group of the train when the difference was determined.
+	TrainTemplateDifference difference; ///< The difference, never #TTD_NONE.
+};
+
+static robin_hood::unordered_flat_map<VehicleID, TrainTemplateDifferenceEntry> _train_template_differences; ///< Trains which differ from their template.
+static robin_hood::unordered_flat_map<GroupID, uint> _group_template_difference_counts; ///< Number of trains per group in #_train_template_differences.
+static robin_hood::unordered_flat_set<VehicleID> _train_template_differences_dirty;     ///< Trains whose difference must be determined again.
+static bool _train_template_differences_valid = false;                                  ///< Whether the cached differences are valid, apart from the dirty trains.
+
 static void MarkTrainsInGroupAsPendingTemplateReplacement(GroupID gid, const TemplateVehicle *tv);
 
 void TemplateVehicleImageDimensions::SetFromTrain(const Train *t)
@@ -148,18 +166,114 @@ TemplateReplacement::~TemplateReplacement()
 
 void TemplateReplacement::PreCleanPool()
 {
+	InvalidateTrainTemplateDifferences();
 	_template_replacement_index.clear();
 	_template_replacement_index_recursive.clear();
 }
 
+/**
+ * Determine the difference of a train from the template of its group again.
+ * @param id The train, which may no longer be a primary vehicle or not exist at all.
+ */
+static void UpdateTrainTemplateDifference(VehicleID id)
+{
+	auto iter = _train_template_differences.find(id);
+	if (iter != _train_template_differences.end()) {
+		_group_template_difference_counts[iter->second.group]--;
+		_train_template_differences.erase(iter);
+	}
+
+	const Train *t = Train::GetIfValid(id);
+	if (t == nullptr || !t->IsPrimaryVehicle() || t->group_id >= NEW_GROUP) return;
+
+	const TemplateVehicle *tv = GetTemplateVehicleByGroupIDRecursive(t->group_id);
+	if (tv == nullptr) return;
+
+	TrainTemplateDifference difference = TTD_NONE;
+	if (!TrainMatchesTemplate(t, tv)) {
+		difference = TTD_ENGINES;
+	} else if (!TrainMatchesTemplateRefit(t, tv)) {
+		difference = TTD_REFIT;
+	}
+	if (difference == TTD_NONE) return;
+
+	_train_template_differences[id] = { t->group_id, difference };
+	_group_template_difference_counts[t->group_id]++;
+}
+
+/** Bring the cached differences of trains from their templates up to date. */
+static void UpdateTrainTemplateDifferences()
+{
+	if (!_train_template_differences_valid) {
+		_train_template_differences.clear();
+		_group_template_difference_counts.clear();
+		_train_template_differences_dirty.clear();
+		for (const Train *t : Train::Iterate()) {
+			if (t->IsPrimaryVehicle()) UpdateTrainTemplateDifference(t->index);
+		}
+		_train_template_differences_valid = true;
+		return;
+	}
+
+	for (VehicleID id : _train_template_differences_dirty) {
+		UpdateTrainTemplateDifference(id);
+	}
+	_train_template_differences_dirty.clear();
+}
+
+/**
+ * Get the cached difference of a train from the template of its group.
+ * @param t The train.
+ * @return The difference.
+ */
+static TrainTemplateDifference GetTrainTemplateDifference(const Train *t)
+{
+	UpdateTrainTemplateDifferences();
+	auto iter = _train_template_differences.find(t->index);
+	return iter != _train_template_differences.end() ? iter->second.difference : TTD_NONE;
+}
+
+/**
+ * Mark that the consist or group of a train changed, or that the train was deleted.
+ * @param id The train.
+ */
+void MarkTrainTemplateDifferenceDirty(VehicleID id)
+{
+	if (_train_template_differences_valid) _train_template_differences_dirty.insert(id);
+}
+
+/** Forget the differences of all trains from their templates, after templates or their assignment to groups changed. */
+void InvalidateTrainTemplateDifferences()
+{
+	_train_template_differences_valid = false;
+}
+
+/**
+ * Count the trains in a group which differ from the template of the group.
+ * Trains in sub-groups are not counted.
+ * @param gid The group.
+ * @return The number of trains which need replacing or refitting.
+ */
+uint CountTrainsDifferingFromGroupTemplate(GroupID gid)
+{
+	UpdateTrainTemplateDifferences();
+	auto iter = _group_template_difference_counts.find(gid);
+	return iter != _group_template_difference_counts.end() ? iter->second : 0;
+}
+
 bool ShouldServiceTrainForTemplateReplacement(const Train *t, const TemplateVehicle *tv)
 {
 	const Company *c = Company::Get(t->owner);
 	if (tv->IsReplaceOldOnly() && !t->NeedsAutorenewing(c, false)) return false;
 	Money needed_money = c->settings.engine_renew_money;
 	if (needed_money > c->money) return false;
-	bool need_replacement = !TrainMatchesTemplate(t, tv);
-	if (need_replacement) {
+	TrainTemplateDifference difference;
+	if (t->group_id < NEW_GROUP && tv == GetTemplateVehicleByGroupIDRecursive(t->group_id)) {
+		difference = GetTrainTemplateDifference(t);
+	} else {
+		difference = !TrainMatchesTemplate(t, tv) ? TTD_ENGINES : (!TrainMatchesTemplateRefit(t, tv) ? TTD_REFIT : TTD_NONE);
+	}
+	if (difference == TTD_ENGINES) {
 		/* Check money.
 		 * We want 2*(the price of the whole template) without looking at the value of the vehicle(s) we are going to sell, or not need to buy. */
 		for (const TemplateVehicle *tv_unit = tv; tv_unit != nullptr; tv_unit = tv_unit->GetNextUnit()) {
@@ -167,7 +281,7 @@ bool ShouldServiceTrainForTemplateReplacement(const Train *t, const TemplateVehi
 			needed_money += 2 * Engine::Get(tv->engine_type)->GetCost();
 		}
 		return needed_money <= c->money;
-	} else if (!TrainMatchesTemplateRefit(t, tv) && tv->refit_as_template) {
+	} else if (difference == TTD_REFIT) {
 		return true;
 	} else {
 		return false;
@@ -217,6 +331,8 @@ static void MarkTrainsInGroupAsPendingTemplateReplacement(GroupID gid, const Tem
 
 void MarkTrainsUsingTemplateAsPendingTemplateReplacement(const TemplateVehicle *tv)
 {
+	InvalidateTrainTemplateDifferences();
+
 	Owner owner = tv->owner;
 
 	for (Train *t : Train::Iterate()) {
@@ -319,6 +435,8 @@ void ReindexTemplateReplacements()
 
 void ReindexTemplateReplacementsRecursive()
 {
+	InvalidateTrainTemplateDifferences();
+
 	if (_template_replacement_index_recursive_guard != 0) {
 		_template_replacement_index_recursive_guard |= 0x80000000;
 		return;
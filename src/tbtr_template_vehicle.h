@@ -226,6 +226,9 @@ TemplateID GetTemplateIDByGroupIDRecursive(GroupID gid);
 bool IssueTemplateReplacement(GroupID gid, TemplateID tid);
 bool ShouldServiceTrainForTemplateReplacement(const Train *t, const TemplateVehicle *tv);
 void MarkTrainsUsingTemplateAsPendingTemplateReplacement(const TemplateVehicle *tv);
+void MarkTrainTemplateDifferenceDirty(VehicleID id);
+void InvalidateTrainTemplateDifferences();
+uint CountTrainsDifferingFromGroupTemplate(GroupID gid);
 
 uint DeleteTemplateReplacementsByGroupID(const Group *g);
 
@@ -335,6 +335,8 @@ uint CountsTrainsNeedingTemplateReplacement(GroupID g_id, const TemplateVehicle
 	uint count = 0;
 	if (!tv) return count;
 
+	if (g_id < NEW_GROUP && tv == GetTemplateVehicleByGroupIDRecursive(g_id)) return CountTrainsDifferingFromGroupTemplate(g_id);
+
 	for (Train *t : Train::Iterate()) {
 		if (t->IsPrimaryVehicle() && t->group_id == g_id && (!TrainMatchesTemplate(t, tv) || !TrainMatchesTemplateRefit(t, tv))) {
 			count++;
@@ -17,6 +17,7 @@
 #include "company_base.h"
 #include "company_func.h"
 #include "core/backup_type.hpp"
+#include "pathfinder/water_regions.h"
 
 #include "table/strings.h"
 
@@ -323,6 +324,7 @@ CommandCost CmdTerraformLand(TileIndex tile, DoCommandFlag flags, uint32 p1, uin
 			int height = it->second;
 
 			SetTileHeight(t, (uint)height);
+			InvalidateWaterRegion(t);
 		}
 
 		if (c != nullptr) c->terraform_limit -= (uint32)ts.tile_to_new_height.size() << 16;
@@ -550,3 +550,24 @@ static_assert(CheckPartialPixelZ(HalftileSlope(SLOPE_STEEP_W, CORNER_W), {
 	16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,  8,  7,  7,
 	16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,  8,  7,
 	16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,  8}));
+
+
+/**
+ * Check whether the lookup table used by GetPartialPixelZ matches InternalGetPartialPixelZ
+ * for all valid non-halftile slopes and all sub-tile positions.
+ * @return True iff all table entries are the same as the calculated Z-coordinates.
+ */
+constexpr bool CheckPartialPixelZTable()
+{
+	for (uint slope = 0; slope < SLOPE_HALFTILE; slope++) {
+		if (!PartialPixelZTable::IsValidTableSlope(slope)) continue;
+		for (uint x = 0; x < TILE_SIZE; x++) {
+			for (uint y = 0; y < TILE_SIZE; y++) {
+				if (_partial_pixel_z_table.z[slope][x * TILE_SIZE + y] != InternalGetPartialPixelZ(x, y, (Slope)slope)) return false;
+			}
+		}
+	}
+	return true;
+}
+
+static_assert(CheckPartialPixelZTable());
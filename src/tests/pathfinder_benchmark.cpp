@@ -0,0 +1,147 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file pathfinder_benchmark.cpp Benchmark of the YAPF path searches of the vehicles in the current game.
+ *
+ * For each train, road vehicle and ship, a path search is made from its current position to its current destination,
+ * the same way as when the vehicle reaches a junction. No paths are reserved and the path caches of the vehicles
+ * are left untouched, so the game state is not changed. The segment cost cache of the rail pathfinder is shared
+ * between all searches, as it is in the game.
+ *
+ * Pathfinder changes can be evaluated by running the benchmark on the same savegames before and after the change,
+ * e.g. a large network with many junctions, a long mainline, a dense station throat or an open ocean.
+ */
+
+#include "../stdafx.h"
+#include "pathfinder_benchmark.h"
+#include "../train.h"
+#include "../roadveh.h"
+#include "../ship.h"
+#include "../tile_cmd.h"
+#include "../pathfinder/pathfinder_func.h"
+#include "../pathfinder/yapf/yapf.h"
+#include "../pathfinder/yapf/yapf.hpp"
+#include "../core/backup_type.hpp"
+#include "../scope.h"
+#include "../string_func.h"
+
+#include <chrono>
+
+#include "../safeguards.h"
+
+YapfBenchmarkStats *_yapf_benchmark_stats = nullptr;
+
+/**
+ * Time the path searches of one vehicle type and format the results.
+ * @param name Name of the vehicle type in the results.
+ * @param iterations Number of times to run the searches.
+ * @param run Function making the path searches of all vehicles of the type once, returning the number of searches.
+ * @return The results as a JSON object.
+ */
+template <typename F>
+static std::string RunPathfinderBenchmark(const char *name, uint iterations, F run)
+{
+	YapfBenchmarkStats stats;
+	_yapf_benchmark_stats = &stats;
+
+	uint64 queries = 0;
+	const auto start = std::chrono::steady_clock::now();
+	for (uint i = 0; i < iterations; i++) {
+		queries += run();
+	}
+	const uint64 time_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	_yapf_benchmark_stats = nullptr;
+
+	auto per = [](uint64 value, uint64 count) -> double {
+		return count > 0 ? (double)value / (double)count : 0.0;
+	};
+
+	return stdstr_fmt("    { \"type\": \"%s\", \"queries\": " OTTD_PRINTF64U ", \"total_us\": " OTTD_PRINTF64U ", \"us_per_query\": %.2f"
+			", \"searches\": " OTTD_PRINTF64U ", \"found\": " OTTD_PRINTF64U ", \"steps_per_search\": %.1f, \"nodes_per_search\": %.1f"
+			", \"cost_calcs\": " OTTD_PRINTF64U ", \"cache_hits\": " OTTD_PRINTF64U ", \"cache_hit_rate\": %.3f }",
+			name, queries, time_us, per(time_us, queries),
+			stats.searches, stats.found, per(stats.steps, stats.searches), per(stats.nodes, stats.searches),
+			stats.cost_calcs, stats.cache_hits, per(stats.cache_hits, stats.cost_calcs + stats.cache_hits));
+}
+
+/**
+ * Check whether a path search should be made for a vehicle.
+ * @param v The vehicle.
+ * @return Whether the vehicle is a primary vehicle on the map.
+ */
+static bool IsPathfinderBenchmarkVehicle(const Vehicle *v)
+{
+	return v->IsPrimaryVehicle() && !(v->vehstatus & VS_CRASHED) && !v->IsInDepot();
+}
+
+/**
+ * Benchmark the YAPF path searches of the trains, road vehicles and ships in the current game.
+ * The pathfinder settings of the game are used, except that searches of trains are not shared.
+ * @param iterations Number of times to search a path for each vehicle.
+ * @return The results as JSON.
+ */
+std::string PathfinderBenchmark(uint iterations)
+{
+	/* Each search must be made, instead of reusing the result of an identical search in the same tick. */
+	Backup<bool> batch(_settings_game.pf.yapf.rail_pathfind_batch, false, FILE_LINE);
+	auto guard = scope_guard([&]() {
+		_yapf_benchmark_stats = nullptr;
+		batch.Restore();
+	});
+
+	std::string result = stdstr_fmt("{\n  \"iterations\": %u,\n  \"pathfinders\": [\n", iterations);
+
+	result += RunPathfinderBenchmark("train", iterations, []() -> uint64 {
+		uint64 count = 0;
+		for (const Train *t : Train::Iterate()) {
+			if (!IsPathfinderBenchmarkVehicle(t)) continue;
+			bool path_found;
+			YapfTrainChooseTrack(t, t->tile, DirToDiagDir(t->direction), TRACK_BIT_NONE, path_found, false, nullptr, nullptr);
+			count++;
+		}
+		return count;
+	});
+	result += ",\n";
+
+	result += RunPathfinderBenchmark("road", iterations, []() -> uint64 {
+		uint64 count = 0;
+		for (const RoadVehicle *rv : RoadVehicle::Iterate()) {
+			if (!IsPathfinderBenchmarkVehicle(rv)) continue;
+			const DiagDirection enterdir = DirToDiagDir(rv->direction);
+			const TileIndex tile = TileAddByDiagDir(rv->tile, enterdir);
+			if (!IsValidTile(tile)) continue;
+			const TrackdirBits trackdirs = GetTrackdirBitsForRoad(tile, GetRoadTramType(rv->roadtype)) & DiagdirReachesTrackdirs(enterdir);
+			if (trackdirs == TRACKDIR_BIT_NONE) continue;
+			bool path_found;
+			RoadVehPathCache path_cache;
+			YapfRoadVehicleChooseTrack(rv, tile, enterdir, trackdirs, path_found, path_cache);
+			count++;
+		}
+		return count;
+	});
+	result += ",\n";
+
+	result += RunPathfinderBenchmark("ship", iterations, []() -> uint64 {
+		uint64 count = 0;
+		for (const Ship *s : Ship::Iterate()) {
+			if (!IsPathfinderBenchmarkVehicle(s) || s->state == TRACK_BIT_WORMHOLE) continue;
+			const DiagDirection enterdir = DirToDiagDir(s->direction);
+			const TileIndex tile = TileAddByDiagDir(s->tile, enterdir);
+			if (!IsValidTile(tile)) continue;
+			const TrackBits tracks = TrackdirBitsToTrackBits(GetTileTrackdirBits(tile, TRANSPORT_WATER, 0)) & DiagdirReachesTracks(enterdir);
+			if (tracks == TRACK_BIT_NONE) continue;
+			bool path_found;
+			ShipPathCache path_cache;
+			YapfShipChooseTrack(s, tile, enterdir, tracks, path_found, path_cache);
+			count++;
+		}
+		return count;
+	});
+
+	result += "\n  ]\n}";
+	return result;
+}
@@ -14,6 +14,7 @@
 #include "genworld.h"
 #include "core/random_func.hpp"
 #include "landscape_type.h"
+#include "worker_thread.h"
 
 #include "safeguards.h"
 
@@ -340,6 +341,74 @@ static inline void FreeHeightMap()
 	_height_map.h.clear();
 }
 
+/** Minimum number of independent items before a height map pass is run on the worker pool. */
+static const int HEIGHT_MAP_MIN_PARALLEL = 64;
+/** Width and height of the blocks of #HeightMapForEachBlockWavefront. */
+static const int HEIGHT_MAP_WAVEFRONT_BLOCK = 64;
+
+/**
+ * Call a function for each of a number of independent items, on the worker pool when there are enough of them.
+ * The calls may run in any order, so the function must not use the random number generator
+ * and must not read height map entries written by the call for another item.
+ * @param count Number of items.
+ * @param func Function to call with the index of each item.
+ */
+template <typename F>
+static void HeightMapParallelFor(int count, F func)
+{
+	const uint workers = _general_worker_pool.GetWorkerCount();
+	if (workers == 0 || count < HEIGHT_MAP_MIN_PARALLEL) {
+		for (int i = 0; i < count; i++) func(i);
+		return;
+	}
+
+	WorkerTaskGroup group;
+	group.ParallelFor(0, count, CeilDiv((uint)count, (workers + 1) * 4), [&](size_t i) {
+		func((int)i);
+	});
+}
+
+/**
+ * Call a function for each block of the height map, such that each block is only processed after
+ * the blocks before it in both the X and Y direction (or after it, when reversed).
+ * Blocks on the same anti-diagonal do not depend on each other and are processed in parallel.
+ * This gives the same result as a sequential sweep over the whole height map, for passes where each
+ * entry only depends on its neighbours which were already processed.
+ * @param reverse Whether to process the blocks from the south instead of the north corner.
+ * @param func Function to call with the first and past-the-end X and Y coordinates of each block.
+ */
+template <typename F>
+static void HeightMapForEachBlockWavefront(bool reverse, F func)
+{
+	const int end_x = _height_map.size_x + 1;
+	const int end_y = _height_map.size_y + 1;
+	const int blocks_x = CeilDiv(end_x, HEIGHT_MAP_WAVEFRONT_BLOCK);
+	const int blocks_y = CeilDiv(end_y, HEIGHT_MAP_WAVEFRONT_BLOCK);
+	const int diagonals = blocks_x + blocks_y - 1;
+
+	for (int i = 0; i < diagonals; i++) {
+		const int diagonal = reverse ? diagonals - 1 - i : i;
+		const int first_bx = std::max(0, diagonal - (blocks_y - 1));
+		const int last_bx = std::min(diagonal, blocks_x - 1);
+
+		auto process_block = [&](int bx) {
+			const int by = diagonal - bx;
+			const int x = bx * HEIGHT_MAP_WAVEFRONT_BLOCK;
+			const int y = by * HEIGHT_MAP_WAVEFRONT_BLOCK;
+			func(x, std::min(end_x, x + HEIGHT_MAP_WAVEFRONT_BLOCK), y, std::min(end_y, y + HEIGHT_MAP_WAVEFRONT_BLOCK));
+		};
+
+		if (first_bx == last_bx || _general_worker_pool.GetWorkerCount() == 0) {
+			for (int bx = first_bx; bx <= last_bx; bx++) process_block(bx);
+		} else {
+			WorkerTaskGroup group;
+			group.ParallelFor(first_bx, last_bx + 1, 1, [&](size_t bx) {
+				process_block((int)bx);
+			});
+		}
+	}
+}
+
 /**
  * Generates new random height in given amplitude (generated numbers will range from - amplitude to + amplitude)
  * @param rMax Limit of result
@@ -389,26 +458,29 @@ static void HeightMapGenerate()
 
 		/* It is regular iteration round.
 		 * Interpolate height values at odd x, even y tiles */
-		for (int y = 0; y <= _height_map.size_y; y += 2 * step) {
+		HeightMapParallelFor(_height_map.size_y / (2 * step) + 1, [&](int row) {
+			const int y = row * 2 * step;
 			for (int x = 0; x <= _height_map.size_x - 2 * step; x += 2 * step) {
 				Height h00 = _height_map.height(x + 0 * step, y);
 				Height h02 = _height_map.height(x + 2 * step, y);
 				Height h01 = (h00 + h02) / 2;
 				_height_map.height(x + 1 * step, y) = h01;
 			}
-		}
+		});
 
 		/* Interpolate height values at odd y tiles */
-		for (int y = 0; y <= _height_map.size_y - 2 * step; y += 2 * step) {
+		HeightMapParallelFor(_height_map.size_y / (2 * step), [&](int row) {
+			const int y = row * 2 * step;
 			for (int x = 0; x <= _height_map.size_x; x += step) {
 				Height h00 = _height_map.height(x, y + 0 * step);
 				Height h20 = _height_map.height(x, y + 2 * step);
 				Height h10 = (h00 + h20) / 2;
 				_height_map.height(x, y + 1 * step) = h10;
 			}
-		}
+		});
 
-		/* Add noise for next higher frequency (smaller steps) */
+		/* Add noise for next higher frequency (smaller steps).
+		 * This consumes random numbers, so it must stay sequential to generate the same map for the same seed. */
 		for (int y = 0; y <= _height_map.size_y; y += step) {
 			for (int x = 0; x <= _height_map.size_x; x += step) {
 				_height_map.height(x, y) += RandomHeight(amplitude);
@@ -424,11 +496,29 @@ static void HeightMapGetMinMaxAvg(Height *min_ptr, Height *max_ptr, Height *avg_
 	int64 h_accu = 0;
 	h_min = h_max = _height_map.height(0, 0);
 
-	/* Get h_min, h_max and accumulate heights into h_accu */
-	for (const Height &h : _height_map.h) {
-		if (h < h_min) h_min = h;
-		if (h > h_max) h_max = h;
-		h_accu += h;
+	/** Minimum, maximum and sum of the heights of one row. */
+	struct RowStats {
+		Height h_min;
+		Height h_max;
+		int64 h_accu;
+	};
+	std::vector<RowStats> row_stats(_height_map.size_y + 1);
+
+	/* Get h_min, h_max and accumulate heights into h_accu, per row and then for the whole map */
+	HeightMapParallelFor(_height_map.size_y + 1, [&](int y) {
+		RowStats &stats = row_stats[y];
+		stats = { _height_map.height(0, y), _height_map.height(0, y), 0 };
+		for (int x = 0; x < _height_map.dim_x; x++) {
+			const Height h = _height_map.height(x, y);
+			if (h < stats.h_min) stats.h_min = h;
+			if (h > stats.h_max) stats.h_max = h;
+			stats.h_accu += h;
+		}
+	});
+	for (const RowStats &stats : row_stats) {
+		h_min = std::min(h_min, stats.h_min);
+		h_max = std::max(h_max, stats.h_max);
+		h_accu += stats.h_accu;
 	}
 
 	/* Get average height */
@@ -457,76 +547,79 @@ static int *HeightMapMakeHistogram(Height h_min, Height h_max, int *hist_buf)
 /** Applies sine wave redistribution onto height map */
 static void HeightMapSineTransform(Height h_min, Height h_max)
 {
-	for (Height &h : _height_map.h) {
-		double fheight;
-
-		if (h < h_min) continue;
-
-		/* Transform height into 0..1 space */
-		fheight = (double)(h - h_min) / (double)(h_max - h_min);
-		/* Apply sine transform depending on landscape type */
-		switch (_settings_game.game_creation.landscape) {
-			case LT_TOYLAND:
-			case LT_TEMPERATE:
-				/* Move and scale 0..1 into -1..+1 */
-				fheight = 2 * fheight - 1;
-				/* Sine transform */
-				fheight = sin(fheight * M_PI_2);
-				/* Transform it back from -1..1 into 0..1 space */
-				fheight = 0.5 * (fheight + 1);
-				break;
-
-			case LT_ARCTIC:
-				{
-					/* Arctic terrain needs special height distribution.
-					 * Redistribute heights to have more tiles at highest (75%..100%) range */
-					double sine_upper_limit = 0.75;
-					double linear_compression = 2;
-					if (fheight >= sine_upper_limit) {
-						/* Over the limit we do linear compression up */
-						fheight = 1.0 - (1.0 - fheight) / linear_compression;
-					} else {
-						double m = 1.0 - (1.0 - sine_upper_limit) / linear_compression;
-						/* Get 0..sine_upper_limit into -1..1 */
-						fheight = 2.0 * fheight / sine_upper_limit - 1.0;
-						/* Sine wave transform */
-						fheight = sin(fheight * M_PI_2);
-						/* Get -1..1 back to 0..(1 - (1 - sine_upper_limit) / linear_compression) == 0.0..m */
-						fheight = 0.5 * (fheight + 1.0) * m;
+	HeightMapParallelFor(_height_map.size_y + 1, [&](int y) {
+		for (int x = 0; x < _height_map.dim_x; x++) {
+			Height &h = _height_map.height(x, y);
+			double fheight;
+
+			if (h < h_min) continue;
+
+			/* Transform height into 0..1 space */
+			fheight = (double)(h - h_min) / (double)(h_max - h_min);
+			/* Apply sine transform depending on landscape type */
+			switch (_settings_game.game_creation.landscape) {
+				case LT_TOYLAND:
+				case LT_TEMPERATE:
+					/* Move and scale 0..1 into -1..+1 */
+					fheight = 2 * fheight - 1;
+					/* Sine transform */
+					fheight = sin(fheight * M_PI_2);
+					/* Transform it back from -1..1 into 0..1 space */
+					fheight = 0.5 * (fheight + 1);
+					break;
+
+				case LT_ARCTIC:
+					{
+						/* Arctic terrain needs special height distribution.
+						 * Redistribute heights to have more tiles at highest (75%..100%) range */
+						double sine_upper_limit = 0.75;
+						double linear_compression = 2;
+						if (fheight >= sine_upper_limit) {
+							/* Over the limit we do linear compression up */
+							fheight = 1.0 - (1.0 - fheight) / linear_compression;
+						} else {
+							double m = 1.0 - (1.0 - sine_upper_limit) / linear_compression;
+							/* Get 0..sine_upper_limit into -1..1 */
+							fheight = 2.0 * fheight / sine_upper_limit - 1.0;
+							/* Sine wave transform */
+							fheight = sin(fheight * M_PI_2);
+							/* Get -1..1 back to 0..(1 - (1 - sine_upper_limit) / linear_compression) == 0.0..m */
+							fheight = 0.5 * (fheight + 1.0) * m;
+						}
 					}
-				}
-				break;
-
-			case LT_TROPIC:
-				{
-					/* Desert terrain needs special height distribution.
-					 * Half of tiles should be at lowest (0..25%) heights */
-					double sine_lower_limit = 0.5;
-					double linear_compression = 2;
-					if (fheight <= sine_lower_limit) {
-						/* Under the limit we do linear compression down */
-						fheight = fheight / linear_compression;
-					} else {
-						double m = sine_lower_limit / linear_compression;
-						/* Get sine_lower_limit..1 into -1..1 */
-						fheight = 2.0 * ((fheight - sine_lower_limit) / (1.0 - sine_lower_limit)) - 1.0;
-						/* Sine wave transform */
-						fheight = sin(fheight * M_PI_2);
-						/* Get -1..1 back to (sine_lower_limit / linear_compression)..1.0 */
-						fheight = 0.5 * ((1.0 - m) * fheight + (1.0 + m));
+					break;
+
+				case LT_TROPIC:
+					{
+						/* Desert terrain needs special height distribution.
+						 * Half of tiles should be at lowest (0..25%) heights */
+						double sine_lower_limit = 0.5;
+						double linear_compression = 2;
+						if (fheight <= sine_lower_limit) {
+							/* Under the limit we do linear compression down */
+							fheight = fheight / linear_compression;
+						} else {
+							double m = sine_lower_limit / linear_compression;
+							/* Get sine_lower_limit..1 into -1..1 */
+							fheight = 2.0 * ((fheight - sine_lower_limit) / (1.0 - sine_lower_limit)) - 1.0;
+							/* Sine wave transform */
+							fheight = sin(fheight * M_PI_2);
+							/* Get -1..1 back to (sine_lower_limit / linear_compression)..1.0 */
+							fheight = 0.5 * ((1.0 - m) * fheight + (1.0 + m));
+						}
 					}
-				}
-				break;
+					break;
 
-			default:
-				NOT_REACHED();
-				break;
+				default:
+					NOT_REACHED();
+					break;
+			}
+			/* Transform it back into h_min..h_max space */
+			h = (Height)(fheight * (h_max - h_min) + h_min);
+			if (h < 0) h = I2H(0);
+			if (h >= h_max) h = h_max - 1;
 		}
-		/* Transform it back into h_min..h_max space */
-		h = (Height)(fheight * (h_max - h_min) + h_min);
-		if (h < 0) h = I2H(0);
-		if (h >= h_max) h = h_max - 1;
-	}
+	});
 }
 
 /**
@@ -574,9 +667,6 @@ static void HeightMapCurves(uint level)
 		{ lengthof(curve_map_4), curve_map_4 },
 	};
 
-	Height ht[lengthof(curve_maps)];
-	MemSetT(ht, 0, lengthof(ht));
-
 	/* Set up a grid to choose curve maps based on location; attempt to get a somewhat square grid */
 	float factor = sqrt((float)_height_map.size_x / (float)_height_map.size_y);
 	uint sx = Clamp((int)(((1 << level) * factor) + 0.5), 1, 128);
@@ -587,8 +677,10 @@ static void HeightMapCurves(uint level)
 		c[i] = Random() % lengthof(curve_maps);
 	}
 
-	/* Apply curves */
-	for (int x = 0; x < _height_map.size_x; x++) {
+	/* Apply curves; each column is independent of the others */
+	HeightMapParallelFor(_height_map.size_x, [&](int x) {
+		Height ht[lengthof(curve_maps)];
+		MemSetT(ht, 0, lengthof(ht));
 
 		/* Get our X grid positions and bi-linear ratio */
 		float fx = (float)(sx * x) / _height_map.size_x + 1.0f;
@@ -670,7 +762,7 @@ static void HeightMapCurves(uint level)
 			/* Readd sea level */
 			*h += I2H(1);
 		}
-	}
+	});
 }
 
 /** Adjusts heights in height map to contain required amount of water tiles */
@@ -702,13 +794,16 @@ static void HeightMapAdjustWaterLevel(Amplitude water_percent, Height h_max_new)
 	 *   values from range: h_water_level..h_max are transformed into 0..h_max_new
 	 *   where h_max_new is depending on terrain type and map size.
 	 */
-	for (Height &h : _height_map.h) {
-		/* Transform height from range h_water_level..h_max into 0..h_max_new range */
-		h = (Height)(((int)h_max_new) * (h - h_water_level) / (h_max - h_water_level)) + I2H(1);
-		/* Make sure all values are in the proper range (0..h_max_new) */
-		if (h < 0) h = I2H(0);
-		if (h >= h_max_new) h = h_max_new - 1;
-	}
+	HeightMapParallelFor(_height_map.size_y + 1, [&](int y) {
+		for (int x = 0; x < _height_map.dim_x; x++) {
+			Height &h = _height_map.height(x, y);
+			/* Transform height from range h_water_level..h_max into 0..h_max_new range */
+			h = (Height)(((int)h_max_new) * (h - h_water_level) / (h_max - h_water_level)) + I2H(1);
+			/* Make sure all values are in the proper range (0..h_max_new) */
+			if (h < 0) h = I2H(0);
+			if (h >= h_max_new) h = h_max_new - 1;
+		}
+	});
 
 	free(hist_buf);
 }
@@ -849,21 +944,26 @@ static void HeightMapSmoothCoasts(uint8 water_borders)
  * one level between tiles. This routine smooths out those differences so that
  * the most it can change is one level. When OTTD can support cliffs, this
  * routine may not be necessary.
+ * Each tile depends on the already smoothed tiles before it, so the sweeps are processed as wavefronts of blocks.
  */
 static void HeightMapSmoothSlopes(Height dh_max)
 {
-	for (int y = 0; y <= (int)_height_map.size_y; y++) {
-		for (int x = 0; x <= (int)_height_map.size_x; x++) {
-			Height h_max = std::min(_height_map.height(x > 0 ? x - 1 : x, y), _height_map.height(x, y > 0 ? y - 1 : y)) + dh_max;
-			if (_height_map.height(x, y) > h_max) _height_map.height(x, y) = h_max;
+	HeightMapForEachBlockWavefront(false, [&](int x_begin, int x_end, int y_begin, int y_end) {
+		for (int y = y_begin; y < y_end; y++) {
+			for (int x = x_begin; x < x_end; x++) {
+				Height h_max = std::min(_height_map.height(x > 0 ? x - 1 : x, y), _height_map.height(x, y > 0 ? y - 1 : y)) + dh_max;
+				if (_height_map.height(x, y) > h_max) _height_map.height(x, y) = h_max;
+			}
 		}
-	}
-	for (int y = _height_map.size_y; y >= 0; y--) {
-		for (int x = _height_map.size_x; x >= 0; x--) {
-			Height h_max = std::min(_height_map.height(x < _height_map.size_x ? x + 1 : x, y), _height_map.height(x, y < _height_map.size_y ? y + 1 : y)) + dh_max;
-			if (_height_map.height(x, y) > h_max) _height_map.height(x, y) = h_max;
+	});
+	HeightMapForEachBlockWavefront(true, [&](int x_begin, int x_end, int y_begin, int y_end) {
+		for (int y = y_end - 1; y >= y_begin; y--) {
+			for (int x = x_end - 1; x >= x_begin; x--) {
+				Height h_max = std::min(_height_map.height(x < _height_map.size_x ? x + 1 : x, y), _height_map.height(x, y < _height_map.size_y ? y + 1 : y)) + dh_max;
+				if (_height_map.height(x, y) > h_max) _height_map.height(x, y) = h_max;
+			}
 		}
-	}
+	});
 }
 
 /**
@@ -1012,11 +1112,11 @@ void GenerateTerrainPerlin()
 	int max_height = H2I(TGPGetMaxHeight());
 
 	/* Transfer height map into OTTD map */
-	for (int y = 0; y < _height_map.size_y; y++) {
+	HeightMapParallelFor(_height_map.size_y, [&](int y) {
 		for (int x = 0; x < _height_map.size_x; x++) {
 			TgenSetTileHeight(TileXY(x, y), Clamp(H2I(_height_map.height(x, y)), 0, max_height));
 		}
-	}
+	});
 
 	IncreaseGeneratingWorldProgress(GWP_LANDSCAPE);
 
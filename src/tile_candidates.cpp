@@ -0,0 +1,78 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file tile_candidates.cpp Implementation of sets of candidate tiles. */
+
+#include "stdafx.h"
+#include "tile_candidates.h"
+
+#include "safeguards.h"
+
+/** Build the Fenwick tree and the count from #bits. */
+void TileCandidateSet::BuildTree()
+{
+	const size_t n = this->bits.size();
+	this->tree.assign(n + 1, 0);
+	this->count = 0;
+	for (size_t i = 1; i <= n; i++) {
+		const uint32 bits = CountBits(this->bits[i - 1]);
+		this->count += bits;
+		this->tree[i] += bits;
+		const size_t parent = i + (i & (~i + 1));
+		if (parent <= n) this->tree[parent] += this->tree[i];
+	}
+}
+
+/** Remove all candidates and free the memory. */
+void TileCandidateSet::Clear()
+{
+	this->bits.clear();
+	this->bits.shrink_to_fit();
+	this->tree.clear();
+	this->tree.shrink_to_fit();
+	this->count = 0;
+}
+
+/**
+ * Remove a tile from the set, if it is a candidate.
+ * @param tile The tile.
+ */
+void TileCandidateSet::Remove(TileIndex tile)
+{
+	if (!this->Contains(tile)) return;
+
+	ClrBit(this->bits[tile / 64], tile % 64);
+	this->count--;
+	for (size_t i = tile / 64 + 1; i < this->tree.size(); i += i & (~i + 1)) {
+		this->tree[i]--;
+	}
+}
+
+/**
+ * Get a candidate by its index in tile order.
+ * Use a random index below #Count to draw a random candidate.
+ * @param index The index, must be below #Count.
+ * @return The tile.
+ */
+TileIndex TileCandidateSet::Get(uint32 index) const
+{
+	dbg_assert(index < this->count);
+
+	/* Find the element of #bits containing the candidate, by descending the Fenwick tree. */
+	const size_t n = this->bits.size();
+	size_t pos = 0;
+	for (size_t step = (size_t)1 << FindLastBit(n); step != 0; step >>= 1) {
+		if (pos + step <= n && this->tree[pos + step] <= index) {
+			pos += step;
+			index -= this->tree[pos];
+		}
+	}
+
+	uint64 word = this->bits[pos];
+	for (; index != 0; index--) word &= word - 1;
+	return (TileIndex)(pos * 64 + FindFirstBit(word));
+}
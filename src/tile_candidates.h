@@ -0,0 +1,87 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file tile_candidates.h Sets of candidate tiles for random placement during map generation. */
+
+#ifndef TILE_CANDIDATES_H
+#define TILE_CANDIDATES_H
+
+#include "map_func.h"
+#include "core/bitmath_func.hpp"
+#include "worker_thread.h"
+#include <vector>
+
+/**
+ * Set of candidate tiles for random placement, e.g. of towns and industries during map generation.
+ * Instead of probing random tiles of the whole map until a suitable one is found, a random tile
+ * is drawn from the tiles which passed a cheap precheck. Tiles are removed when they are found to
+ * be unsuitable after all, or when something is placed on them.
+ *
+ * The set is a bitmap over the tiles of the map, with a Fenwick tree of the number of candidates
+ * per 64 tiles, so that drawing and removing a candidate takes logarithmic time.
+ */
+class TileCandidateSet {
+	std::vector<uint64> bits; ///< Bit per tile, set for candidates.
+	std::vector<uint32> tree; ///< Fenwick tree of the number of candidates per element of #bits, 1-based.
+	uint32 count = 0;         ///< Number of candidates.
+
+	void BuildTree();
+
+public:
+	/**
+	 * Build the set from a precheck of all tiles of the map, on the worker pool.
+	 * @param is_candidate Function returning whether a tile is a candidate, it must be safe to call from multiple threads.
+	 */
+	template <typename F>
+	void Build(F is_candidate)
+	{
+		static_assert(MIN_MAP_SIZE % 64 == 0);
+		const uint words_per_row = MapSizeX() / 64;
+		this->bits.assign(MapSize() / 64, 0);
+
+		const uint workers = _general_worker_pool.GetWorkerCount();
+		WorkerTaskGroup group;
+		group.ParallelFor(0, MapSizeY(), CeilDiv(MapSizeY(), (workers + 1) * 4), [&](size_t y) {
+			uint64 *row = this->bits.data() + y * words_per_row;
+			TileIndex tile = TileXY(0, (uint)y);
+			for (uint w = 0; w < words_per_row; w++) {
+				uint64 word = 0;
+				for (uint b = 0; b < 64; b++, tile++) {
+					if (is_candidate(tile)) word |= (uint64)1 << b;
+				}
+				row[w] = word;
+			}
+		});
+
+		this->BuildTree();
+	}
+
+	void Clear();
+	void Remove(TileIndex tile);
+	TileIndex Get(uint32 index) const;
+
+	/**
+	 * Check whether a tile is a candidate.
+	 * @param tile The tile.
+	 * @return Whether the tile is in the set.
+	 */
+	inline bool Contains(TileIndex tile) const
+	{
+		return HasBit(this->bits[tile / 64], tile % 64);
+	}
+
+	/**
+	 * Get the number of candidates.
+	 * @return The number of tiles in the set.
+	 */
+	inline uint32 Count() const
+	{
+		return this->count;
+	}
+};
+
+#endif /* TILE_CANDIDATES_H */
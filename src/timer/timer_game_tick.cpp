@@ -22,16 +22,12 @@ void IntervalTimer<TimerGameTick>::Elapsed(TimerGameTick::TElapsed delta)
 	if (this->period == 0) return;
 
 	this->storage.elapsed += delta;
+	if (this->storage.elapsed < this->period) return;
 
-	uint count = 0;
-	while (this->storage.elapsed >= this->period) {
-		this->storage.elapsed -= this->period;
-		count++;
-	}
+	uint count = this->storage.elapsed / this->period;
+	this->storage.elapsed %= this->period;
 
-	if (count > 0) {
-		this->callback(count);
-	}
+	this->callback(count);
 }
 
 template<>
@@ -393,6 +393,7 @@ static inline uint16 TownTicksToGameTicks(uint16 ticks) {
 
 
 RoadType GetTownRoadType();
+void InvalidateTownRoadTypeCache();
 bool MayTownModifyRoad(TileIndex tile);
 
 #endif /* TOWN_H */
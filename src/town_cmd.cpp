@@ -53,6 +53,8 @@
 #include "zoom_func.h"
 #include "zoning.h"
 #include "scope.h"
+#include "tile_candidates.h"
+#include "worker_thread.h"
 
 #include "table/strings.h"
 #include "table/town_land.h"
@@ -193,6 +195,10 @@ void Town::InitializeLayout(TownLayout layout)
 {
 	if (Town::GetNumItems() == 0) return nullptr;
 	int num = RandomRange((uint16)Town::GetNumItems());
+
+	/* Without holes in the pool the num-th valid item is simply at index num */
+	if (Town::GetNumItems() == Town::GetPoolSize()) return Town::Get(num);
+
 	size_t index = MAX_UVALUE(size_t);
 
 	while (num >= 0) {
@@ -531,6 +537,7 @@ void Town::UpdateVirtCoord()
 /** Update the virtual coords needed to draw the town sign for all towns. */
 void UpdateAllTownVirtCoords()
 {
+	ViewportSignKdtreeBatchUpdate batch;
 	for (Town *t : Town::Iterate()) {
 		t->UpdateVirtCoord();
 	}
@@ -692,7 +699,8 @@ static void TileLoop_Town(TileIndex tile)
 	StationFinder stations(TileArea(tile, 1, 1));
 
 	if (HasBit(hs->callback_mask, CBM_HOUSE_PRODUCE_CARGO)) {
-		for (uint i = 0; i < 256; i++) {
+		/* If the callback can never return a result, no cargo is produced */
+		for (uint i = 0; i < 256 && !(hs->ctrl_flags & HCF_NO_PRODUCE_CARGO_CB); i++) {
 			uint16 callback = GetHouseCallback(CBID_HOUSE_PRODUCE_CARGO, i, r, house_id, t, tile);
 
 			if (callback == CALLBACK_FAILED || callback == CALLBACK_HOUSEPRODCARGO_END) break;
@@ -980,7 +988,16 @@ static RoadBits GetTownRoadBits(TileIndex tile)
 	return GetAnyRoadBits(tile, RTT_ROAD, true);
 }
 
-RoadType GetTownRoadType()
+static Date _town_road_type_date = INVALID_DATE; ///< Date for which #_town_road_type is valid, #INVALID_DATE if it is not valid.
+static RoadType _town_road_type;                 ///< Cached result of #GetTownRoadType.
+
+/** Invalidate the cached road type built by towns, this must be called when the road types change. */
+void InvalidateTownRoadTypeCache()
+{
+	_town_road_type_date = INVALID_DATE;
+}
+
+static RoadType CalculateTownRoadType()
 {
 	RoadType best_rt = ROADTYPE_ROAD;
 	const RoadTypeInfo *best = nullptr;
@@ -1012,6 +1029,20 @@ RoadType GetTownRoadType()
 	return best_rt;
 }
 
+/**
+ * Get the road type which towns build.
+ * The result only depends on the road types and the current date, so it is cached per day.
+ * @return Road type for town roads.
+ */
+RoadType GetTownRoadType()
+{
+	if (_town_road_type_date != _date) {
+		_town_road_type = CalculateTownRoadType();
+		_town_road_type_date = _date;
+	}
+	return _town_road_type;
+}
+
 bool MayTownModifyRoad(TileIndex tile)
 {
 	if (MayHaveRoad(tile)) {
@@ -2494,6 +2525,35 @@ static TileIndex FindNearestGoodCoastalTownSpot(TileIndex tile, TownLayout layou
 	return INVALID_TILE;
 }
 
+/** Candidate tiles for land town sites, while #GenerateTowns runs. */
+static TileCandidateSet *_town_candidates = nullptr;
+
+/**
+ * Check whether a tile passes the parts of #TownCanBePlacedHere which do not depend on other towns, except the land area.
+ * @param tile The tile.
+ * @param layout The town layout.
+ * @return Whether a town may be placed at the tile.
+ */
+static bool IsTownCandidateTile(TileIndex tile, TownLayout layout)
+{
+	return IsTileAlignedToGrid(tile, layout) && DistanceFromEdge(tile) >= 12 &&
+			(IsTileType(tile, MP_CLEAR) || IsTileType(tile, MP_TREES)) && IsTileFlat(tile) &&
+			GetTileZ(tile) <= _settings_game.economy.max_town_heightlevel;
+}
+
+/**
+ * Remove the town candidate tiles which are too close to a new town.
+ * @param t The new town.
+ */
+static void RemoveTownCandidatesNearTown(const Town *t)
+{
+	const uint dist = _settings_game.economy.town_min_distance;
+	if (dist == 0) return;
+	for (TileIndex tile : TileArea(t->xy, 1, 1).Expand(dist - 1)) {
+		if (DistanceManhattan(tile, t->xy) < dist) _town_candidates->Remove(tile);
+	}
+}
+
 static Town *CreateRandomTown(uint attempts, uint32 townnameparts, TownSize size, bool city, TownLayout layout)
 {
 	assert(_game_mode == GM_EDITOR || _generating_world); // These are the preconditions for CMD_DELETE_TOWN
@@ -2509,6 +2569,15 @@ static Town *CreateRandomTown(uint attempts, uint32 townnameparts, TownSize size
 		if (IsTileType(tile, MP_WATER)) {
 			tile = FindNearestGoodCoastalTownSpot(tile, layout);
 			if (tile == INVALID_TILE) continue;
+		} else if (_town_candidates != nullptr) {
+			/* Draw a land tile from the candidates, instead of probing land tiles which are mostly unsuitable. */
+			if (_town_candidates->Count() == 0) continue;
+			tile = _town_candidates->Get(RandomRange(_town_candidates->Count()));
+			if (!IsTownCandidateTile(tile, layout)) {
+				/* Something was built on the tile since the candidates were found. */
+				_town_candidates->Remove(tile);
+				continue;
+			}
 		}
 
 		/* Make sure town can be placed here */
@@ -2521,7 +2590,11 @@ static Town *CreateRandomTown(uint attempts, uint32 townnameparts, TownSize size
 
 		/* if the population is still 0 at the point, then the
 		 * placement is so bad it couldn't grow at all */
-		if (t->cache.population > 0) return t;
+		if (t->cache.population > 0) {
+			if (_town_candidates != nullptr) RemoveTownCandidatesNearTown(t);
+			return t;
+		}
+		if (_town_candidates != nullptr) _town_candidates->Remove(tile);
 
 		Backup<CompanyID> cur_company(_current_company, OWNER_TOWN, FILE_LINE);
 		[[maybe_unused]] CommandCost rc = DoCommand(t->xy, t->index, 0, DC_EXEC, CMD_DELETE_TOWN);
@@ -2558,6 +2631,14 @@ bool GenerateTowns(TownLayout layout)
 
 	SetGeneratingWorldProgress(GWP_TOWN, total);
 
+	TileCandidateSet candidates;
+	candidates.Build([layout](TileIndex tile) { return IsTownCandidateTile(tile, layout); });
+	_town_candidates = &candidates;
+	auto guard = scope_guard([]() {
+		_town_candidates = nullptr;
+	});
+	for (const Town *t : Town::Iterate()) RemoveTownCandidatesNearTown(t);
+
 	/* First attempt will be made at creating the suggested number of towns.
 	 * Note that this is really a suggested value, not a required one.
 	 * We would not like the system to lock up just because the user wanted 100 cities on a 64*64 map, would we? */
@@ -2609,12 +2690,12 @@ HouseZonesBits TryGetTownRadiusGroup(const Town *t, TileIndex tile)
 
 	if (t->fund_buildings_months && dist <= 25) return HZB_TOWN_CENTRE;
 
-	HouseZonesBits smallest = HZB_END;
-	for (HouseZonesBits i = HZB_BEGIN; i < HZB_END; i++) {
-		if (dist < t->cache.squared_town_zone_radius[i]) smallest = i;
+	/* Zones are not necessarily nested, the innermost zone containing the tile wins. */
+	for (uint i = HZB_END; i-- > HZB_BEGIN;) {
+		if (dist < t->cache.squared_town_zone_radius[i]) return static_cast<HouseZonesBits>(i);
 	}
 
-	return smallest;
+	return HZB_END;
 }
 
 /**
@@ -4369,11 +4450,16 @@ void TownsMonthlyLoop()
 
 void TownsYearlyLoop()
 {
-	/* Increment house ages */
-	for (TileIndex t = 0; t < MapSize(); t++) {
-		if (!IsTileType(t, MP_HOUSE)) continue;
-		IncrementHouseAge(t);
-	}
+	/* Increment house ages, each row only touches its own tiles so the map scan is split over the worker pool */
+	const uint workers = _general_worker_pool.GetWorkerCount();
+	WorkerTaskGroup group;
+	group.ParallelFor(0, MapSizeY(), CeilDiv(MapSizeY(), (workers + 1) * 4), [&](size_t y) {
+		const TileIndex first = TileXY(0, (uint)y);
+		const TileIndex last = first + MapSizeX();
+		for (TileIndex t = first; t != last; t++) {
+			if (IsTileType(t, MP_HOUSE)) IncrementHouseAge(t);
+		}
+	});
 }
 
 static CommandCost TerraformTile_Town(TileIndex tile, DoCommandFlag flags, int z_new, Slope tileh_new)
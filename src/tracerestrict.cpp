@@ -17,6 +17,7 @@
 #include "viewport_func.h"
 #include "window_func.h"
 #include "order_base.h"
+#include "order_func.h"
 #include "cargotype.h"
 #include "group.h"
 #include "string_func.h"
@@ -28,6 +29,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <memory>
 
 #include "safeguards.h"
 
@@ -118,10 +120,31 @@ enum TraceRestrictCondStackFlags {
 };
 DECLARE_ENUM_AS_BIT_SET(TraceRestrictCondStackFlags)
 
+/**
+ * Condition stack with a capacity fixed before execution, used by TraceRestrictProgram::Execute
+ * The required capacity is TraceRestrictProgram::cond_max_depth
+ */
+struct TraceRestrictFixedCondStack {
+	TraceRestrictCondStackFlags *data;
+	size_t count = 0;
+	size_t capacity;
+
+	TraceRestrictFixedCondStack(TraceRestrictCondStackFlags *data, size_t capacity) : data(data), capacity(capacity) {}
+
+	bool empty() const { return this->count == 0; }
+	TraceRestrictCondStackFlags &back() { dbg_assert(this->count > 0); return this->data[this->count - 1]; }
+	void push_back(TraceRestrictCondStackFlags flags) { dbg_assert(this->count < this->capacity); this->data[this->count++] = flags; }
+	void pop_back() { dbg_assert(this->count > 0); this->count--; }
+};
+
+/** Condition stack depth which TraceRestrictProgram::Execute can handle without a heap allocation */
+static const uint TRACE_RESTRICT_INLINE_COND_STACK_SIZE = 16;
+
 /**
  * Helper function to handle condition stack manipulatoin
  */
-static void HandleCondition(std::vector<TraceRestrictCondStackFlags> &condstack, TraceRestrictCondFlags condflags, bool value)
+template <typename T>
+static void HandleCondition(T &condstack, TraceRestrictCondFlags condflags, bool value)
 {
 	if (condflags & TRCF_OR) {
 		assert(!condstack.empty());
@@ -244,9 +267,12 @@ static bool TestStationCondition(StationID station, TraceRestrictItem item)
  */
 void TraceRestrictProgram::Execute(const Train* v, const TraceRestrictProgramInput &input, TraceRestrictProgramResult& out) const
 {
-	// static to avoid needing to re-alloc/resize on each execution
-	static std::vector<TraceRestrictCondStackFlags> condstack;
-	condstack.clear();
+	dbg_assert(this->cond_skip_table.size() == this->items.size());
+
+	TraceRestrictCondStackFlags condstack_inline_buffer[TRACE_RESTRICT_INLINE_COND_STACK_SIZE];
+	std::unique_ptr<TraceRestrictCondStackFlags[]> condstack_heap_buffer;
+	if (this->cond_max_depth > TRACE_RESTRICT_INLINE_COND_STACK_SIZE) condstack_heap_buffer.reset(new TraceRestrictCondStackFlags[this->cond_max_depth]);
+	TraceRestrictFixedCondStack condstack(condstack_heap_buffer ? condstack_heap_buffer.get() : condstack_inline_buffer, std::max<uint>(this->cond_max_depth, TRACE_RESTRICT_INLINE_COND_STACK_SIZE));
 
 	byte have_previous_signal = 0;
 	TileIndex previous_signal_tile[3];
@@ -259,6 +285,7 @@ void TraceRestrictProgram::Execute(const Train* v, const TraceRestrictProgramInp
 		if (IsTraceRestrictConditional(item)) {
 			TraceRestrictCondFlags condflags = GetTraceRestrictCondFlags(item);
 			TraceRestrictCondOp condop = GetTraceRestrictCondOp(item);
+			const size_t cond_offset = i;
 
 			if (type == TRIT_COND_ENDIF) {
 				assert(!condstack.empty());
@@ -270,7 +297,12 @@ void TraceRestrictProgram::Execute(const Train* v, const TraceRestrictProgramInp
 				} else {
 					// end if
 					condstack.pop_back();
+					continue;
 				}
+			} else if ((condflags & (TRCF_OR | TRCF_ELSE)) && (((condflags & TRCF_OR) && (condstack.back() & TRCSF_ACTIVE)) || (condstack.back() & (TRCSF_DONE_IF | TRCSF_PARENT_INACTIVE)))) {
+				// elif/orif whose outcome does not depend on the condition value, do not evaluate it
+				if (IsTraceRestrictDoubleItem(item)) i++;
+				HandleCondition(condstack, condflags, false);
 			} else {
 				uint16 condvalue = GetTraceRestrictValue(item);
 				bool result = false;
@@ -639,6 +671,11 @@ void TraceRestrictProgram::Execute(const Train* v, const TraceRestrictProgramInp
 				}
 				HandleCondition(condstack, condflags, result);
 			}
+
+			if (!(condstack.back() & TRCSF_ACTIVE)) {
+				// skip the inactive block, up to the next else/elif/orif/end if at the same nesting level
+				i = this->cond_skip_table[cond_offset] - 1;
+			}
 		} else {
 			if (condstack.empty() || condstack.back() & TRCSF_ACTIVE) {
 				switch(type) {
@@ -885,6 +922,46 @@ void TraceRestrictProgram::Execute(const Train* v, const TraceRestrictProgramInp
 	assert(condstack.empty());
 }
 
+/**
+ * Build cond_skip_table and cond_max_depth from the current instruction list.
+ * This must be called whenever the structure of the instruction list changes,
+ * this is done by Validate().
+ * In-place changes to instruction values do not require this to be called.
+ */
+void TraceRestrictProgram::BuildCondSkipTable()
+{
+	this->cond_skip_table.assign(this->items.size(), (uint32)this->items.size());
+	this->cond_max_depth = 0;
+
+	// array offsets of the most recent if/elif/orif/else at each nesting level
+	std::vector<uint32> open_conditions;
+
+	const size_t size = this->items.size();
+	for (size_t i = 0; i < size; i++) {
+		const TraceRestrictItem item = this->items[i];
+		const size_t offset = i;
+		if (IsTraceRestrictDoubleItem(item)) i++;
+		if (!IsTraceRestrictConditional(item)) continue;
+
+		const TraceRestrictCondFlags condflags = GetTraceRestrictCondFlags(item);
+		if (GetTraceRestrictType(item) != TRIT_COND_ENDIF && !(condflags & (TRCF_OR | TRCF_ELSE))) {
+			// if
+			open_conditions.push_back((uint32)offset);
+			this->cond_max_depth = std::max<uint>(this->cond_max_depth, (uint)open_conditions.size());
+			continue;
+		}
+
+		// elif/orif/else/end if
+		if (open_conditions.empty()) continue; // invalid program
+		this->cond_skip_table[open_conditions.back()] = (uint32)offset;
+		if (GetTraceRestrictType(item) == TRIT_COND_ENDIF && !(condflags & TRCF_ELSE)) {
+			open_conditions.pop_back();
+		} else {
+			open_conditions.back() = (uint32)offset;
+		}
+	}
+}
+
 void TraceRestrictProgram::ClearRefIds()
 {
 	if (this->refcount > 4) free(this->ref_ids.ptr_ref_ids.buffer);
@@ -2184,6 +2261,7 @@ CommandCost CmdProgramSignalTraceRestrict(TileIndex tile, DoCommandFlag flags, u
 		// move in modified program
 		prog->items.swap(items);
 		prog->actions_used_flags = actions_used_flags;
+		prog->BuildCondSkipTable();
 
 		if (prog->items.size() == 0 && prog->refcount == 1) {
 			// program is empty, and this tile is the only reference to it
@@ -2501,6 +2579,27 @@ void TraceRestrictUpdateCompanyID(CompanyID old_company, CompanyID new_company)
 
 static btree::btree_multimap<VehicleID, TraceRestrictSlotID> slot_vehicle_index;
 
+/**
+ * Test whether vehicle ID is already an occupant
+ * This uses the vehicle index instead of scanning the occupant list, as the list may be long
+ * @param id Vehicle ID
+ * @return whether vehicle ID is an occupant
+ */
+bool TraceRestrictSlot::IsOccupant(VehicleID id) const
+{
+	if (unlikely(!veh_temporarily_added.empty() || !veh_temporarily_removed.empty())) {
+		/* Temporary changes to the occupant list are not reflected in the vehicle index */
+		if (find_index(veh_temporarily_added, this->index) >= 0 || find_index(veh_temporarily_removed, this->index) >= 0) {
+			return std::find(this->occupants.begin(), this->occupants.end(), id) != this->occupants.end();
+		}
+	}
+
+	for (auto it = slot_vehicle_index.lower_bound(id); it != slot_vehicle_index.end() && it->first == id; ++it) {
+		if (it->second == this->index) return true;
+	}
+	return false;
+}
+
 /**
  * Add vehicle ID to occupants if possible and not already an occupant
  * @param id Vehicle ID
@@ -2512,6 +2611,7 @@ bool TraceRestrictSlot::Occupy(VehicleID id, bool force)
 	if (this->IsOccupant(id)) return true;
 	if (this->occupants.size() >= this->max_occupancy && !force) return false;
 	this->occupants.push_back(id);
+	InvalidateConditionalOrderCache();
 	slot_vehicle_index.insert({ id, this->index });
 	SetBit(Vehicle::Get(id)->vehicle_flags, VF_HAVE_SLOT);
 	SetWindowDirty(WC_VEHICLE_DETAILS, id);
@@ -2543,6 +2643,7 @@ bool TraceRestrictSlot::OccupyDryRunUsingTemporaryState(VehicleID id)
 	if (this->occupants.size() >= this->max_occupancy) return false;
 
 	this->occupants.push_back(id);
+	InvalidateConditionalOrderCache();
 
 	if (find_index(veh_temporarily_removed, this->index) < 0) {
 		include(veh_temporarily_added, this->index);
@@ -2558,6 +2659,7 @@ bool TraceRestrictSlot::OccupyDryRunUsingTemporaryState(VehicleID id)
 void TraceRestrictSlot::Vacate(VehicleID id)
 {
 	if (container_unordered_remove(this->occupants, id)) {
+		InvalidateConditionalOrderCache();
 		this->DeIndex(id);
 		this->UpdateSignals();
 	}
@@ -2570,6 +2672,7 @@ void TraceRestrictSlot::Vacate(VehicleID id)
 void TraceRestrictSlot::VacateUsingTemporaryState(VehicleID id)
 {
 	if (container_unordered_remove(this->occupants, id)) {
+		InvalidateConditionalOrderCache();
 		if (find_index(veh_temporarily_added, this->index) < 0) {
 			include(veh_temporarily_removed, this->index);
 		}
@@ -2583,6 +2686,7 @@ void TraceRestrictSlot::Clear()
 		this->DeIndex(id);
 	}
 	this->occupants.clear();
+	InvalidateConditionalOrderCache();
 }
 
 void TraceRestrictSlot::UpdateSignals() {
@@ -2673,6 +2777,7 @@ void TraceRestrictSlot::RevertTemporaryChanges(VehicleID veh)
 		TraceRestrictSlot *slot = TraceRestrictSlot::Get(id);
 		include(slot->occupants, veh);
 	}
+	if (!veh_temporarily_added.empty() || !veh_temporarily_removed.empty()) InvalidateConditionalOrderCache();
 	veh_temporarily_added.clear();
 	veh_temporarily_removed.clear();
 }
@@ -2685,6 +2790,7 @@ void TraceRestrictRemoveVehicleFromAllSlots(VehicleID vehicle_id)
 	for (; it != slot_vehicle_index.end() && it->first == vehicle_id; ++it) {
 		auto slot = TraceRestrictSlot::Get(it->second);
 		container_unordered_remove(slot->occupants, vehicle_id);
+		InvalidateConditionalOrderCache();
 		slot->UpdateSignals();
 	}
 
@@ -2881,6 +2987,7 @@ CommandCost CmdAlterTraceRestrictSlot(TileIndex tile, DoCommandFlag flags, uint3
 
 		if (flags & DC_EXEC) {
 			slot->max_occupancy = p2;
+			InvalidateConditionalOrderCache();
 			slot->UpdateSignals();
 		}
 	}
@@ -2952,6 +3059,7 @@ void TraceRestrictCounter::UpdateValue(int32 new_value)
 	new_value = std::max<int32>(0, new_value);
 	if (new_value != this->value) {
 		this->value = new_value;
+		InvalidateConditionalOrderCache();
 		InvalidateWindowClassesData(WC_TRACE_RESTRICT_COUNTERS);
 		for (SignalReference sr : this->progsig_dependants) {
 			AddTrackToSignalBuffer(sr.tile, sr.track, GetTileOwner(sr.tile));
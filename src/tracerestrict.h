@@ -503,6 +503,8 @@ struct TraceRestrictProgram : TraceRestrictProgramPool::PoolItem<&_tracerestrict
 	std::vector<TraceRestrictItem> items;
 	uint32 refcount;
 	TraceRestrictProgramActionsUsedFlags actions_used_flags;
+	std::vector<uint32> cond_skip_table; ///< For each conditional item: array offset of the next else/elif/orif/end if at the same nesting level, see BuildCondSkipTable
+	uint cond_max_depth;                 ///< Maximum conditional nesting depth of items
 
 private:
 
@@ -527,7 +529,7 @@ private:
 public:
 
 	TraceRestrictProgram()
-			: refcount(0), actions_used_flags(static_cast<TraceRestrictProgramActionsUsedFlags>(0)) { }
+			: refcount(0), actions_used_flags(static_cast<TraceRestrictProgramActionsUsedFlags>(0)), cond_max_depth(0) { }
 
 	~TraceRestrictProgram()
 	{
@@ -544,6 +546,8 @@ public:
 
 	static CommandCost Validate(const std::vector<TraceRestrictItem> &items, TraceRestrictProgramActionsUsedFlags &actions_used_flags);
 
+	void BuildCondSkipTable();
+
 	static size_t InstructionOffsetToArrayOffset(const std::vector<TraceRestrictItem> &items, size_t offset);
 
 	static size_t ArrayOffsetToInstructionOffset(const std::vector<TraceRestrictItem> &items, size_t offset);
@@ -584,10 +588,12 @@ public:
 		return items.begin() + TraceRestrictProgram::InstructionOffsetToArrayOffset(items, instruction_offset);
 	}
 
-	/** Call validation function on current program instruction list and set actions_used_flags */
+	/** Call validation function on current program instruction list and set actions_used_flags, and rebuild the conditional skip table */
 	CommandCost Validate()
 	{
-		return TraceRestrictProgram::Validate(items, actions_used_flags);
+		CommandCost result = TraceRestrictProgram::Validate(items, actions_used_flags);
+		this->BuildCondSkipTable();
+		return result;
 	}
 };
 
@@ -1116,14 +1122,7 @@ struct TraceRestrictSlot : TraceRestrictSlotPool::PoolItem<&_tracerestrictslot_p
 		if (!CleaningPool()) this->Clear();
 	}
 
-	/** Test whether vehicle ID is already an occupant */
-	bool IsOccupant(VehicleID id) const {
-		for (size_t i = 0; i < occupants.size(); i++) {
-			if (occupants[i] == id) return true;
-		}
-		return false;
-	}
-
+	bool IsOccupant(VehicleID id) const;
 	bool Occupy(VehicleID id, bool force = false);
 	bool OccupyDryRun(VehicleID ids);
 	bool OccupyDryRunUsingTemporaryState(VehicleID id);
@@ -0,0 +1,174 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file tracing.cpp Implementation of timeline tracing. */
+
+#include "stdafx.h"
+#include "tracing.h"
+#include "thread.h"
+#include "string_func.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#if defined(__MINGW32__)
+#include "3rdparty/mingw-std-threads/mingw.mutex.h"
+#endif
+
+#include "safeguards.h"
+
+std::atomic<bool> _tracing_enabled;
+
+/** A completed trace event. */
+struct TraceEvent {
+	const char *name; ///< Name of the event.
+	uint64 start;     ///< Start time, see #GetTraceTimestamp.
+	uint64 end;       ///< End time, see #GetTraceTimestamp.
+};
+
+/**
+ * Events recorded by a single thread.
+ * Only the owning thread writes events, and each slot is written at most once per trace session:
+ * when the buffer is full, further events are dropped. Readers therefore only need to load #written.
+ */
+struct TraceThreadBuffer {
+	uint tid;                          ///< Thread ID used in the trace output.
+	std::string thread_name;           ///< Name of the thread.
+	uint session = 0;                  ///< Trace session the events belong to.
+	std::unique_ptr<TraceEvent[]> events; ///< Event storage.
+	size_t capacity = 0;               ///< Number of events that fit in #events.
+	std::atomic<size_t> written = 0;   ///< Number of events written in #events.
+	std::atomic<size_t> dropped = 0;   ///< Number of events dropped because the buffer was full.
+};
+
+static std::mutex _trace_lock;                                   ///< Protects the buffer list and (re)initialising buffers.
+static std::vector<std::unique_ptr<TraceThreadBuffer>> _trace_buffers; ///< Buffers of all threads that ever recorded an event.
+static std::atomic<uint> _trace_session;                         ///< Current trace session, incremented on each start.
+static size_t _trace_events_per_thread;                          ///< Buffer size for the current session.
+static uint64 _trace_start;                                      ///< Start time of the current session.
+static thread_local TraceThreadBuffer *_trace_thread_buffer = nullptr;
+
+/**
+ * Get the current time for trace events.
+ * @return Monotonic time in nanoseconds, never 0.
+ */
+uint64 GetTraceTimestamp()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count() | 1;
+}
+
+/**
+ * Prepare the buffer of the calling thread for the current trace session.
+ * @param session The current session.
+ * @return The buffer.
+ */
+static TraceThreadBuffer *GetTraceThreadBuffer(uint session)
+{
+	std::lock_guard<std::mutex> lk(_trace_lock);
+
+	TraceThreadBuffer *buffer = _trace_thread_buffer;
+	if (buffer == nullptr) {
+		_trace_buffers.push_back(std::make_unique<TraceThreadBuffer>());
+		buffer = _trace_buffers.back().get();
+		buffer->tid = (uint)_trace_buffers.size();
+		char name[32];
+		if (GetCurrentThreadName(name, lastof(name)) > 0) {
+			buffer->thread_name = name;
+		} else {
+			buffer->thread_name = stdstr_fmt("thread %u", buffer->tid);
+		}
+		_trace_thread_buffer = buffer;
+	}
+
+	if (buffer->session != session) {
+		if (buffer->capacity != _trace_events_per_thread) {
+			buffer->events.reset(new TraceEvent[_trace_events_per_thread]);
+			buffer->capacity = _trace_events_per_thread;
+		}
+		buffer->written.store(0, std::memory_order_relaxed);
+		buffer->dropped.store(0, std::memory_order_relaxed);
+		buffer->session = session;
+	}
+	return buffer;
+}
+
+/**
+ * Record a completed event in the buffer of the calling thread.
+ * @param name Name of the event, must be a string literal.
+ * @param start Start time of the event.
+ * @param end End time of the event.
+ */
+void RecordTraceEvent(const char *name, uint64 start, uint64 end)
+{
+	if (!_tracing_enabled.load(std::memory_order_relaxed)) return;
+
+	const uint session = _trace_session.load(std::memory_order_acquire);
+	TraceThreadBuffer *buffer = _trace_thread_buffer;
+	if (buffer == nullptr || buffer->session != session) buffer = GetTraceThreadBuffer(session);
+
+	const size_t index = buffer->written.load(std::memory_order_relaxed);
+	if (index >= buffer->capacity) {
+		buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	buffer->events[index] = { name, start, end };
+	buffer->written.store(index + 1, std::memory_order_release);
+}
+
+/**
+ * Start a new trace session, discarding the events of the previous one.
+ * @param events_per_thread Maximum number of events recorded per thread.
+ */
+void StartTracing(size_t events_per_thread)
+{
+	std::lock_guard<std::mutex> lk(_trace_lock);
+	_tracing_enabled.store(false, std::memory_order_relaxed);
+	_trace_events_per_thread = events_per_thread;
+	_trace_start = GetTraceTimestamp();
+	_trace_session.fetch_add(1, std::memory_order_release);
+	_tracing_enabled.store(true, std::memory_order_release);
+}
+
+/** Stop recording trace events. The recorded events are kept until the next #StartTracing. */
+void StopTracing()
+{
+	_tracing_enabled.store(false, std::memory_order_release);
+}
+
+/**
+ * Get the events of the current or last trace session.
+ * @return The events in the Chrome trace event JSON format, as understood by chrome://tracing and Perfetto.
+ */
+std::string GetTraceJSON()
+{
+	std::lock_guard<std::mutex> lk(_trace_lock);
+	const uint session = _trace_session.load(std::memory_order_relaxed);
+
+	auto to_us = [](uint64 ns) -> double { return ns / 1000.0; };
+
+	std::string result = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	for (const auto &buffer : _trace_buffers) {
+		if (buffer->session != session) continue;
+
+		const size_t written = buffer->written.load(std::memory_order_acquire);
+		const size_t dropped = buffer->dropped.load(std::memory_order_relaxed);
+		if (!first) result += ",";
+		first = false;
+		result += stdstr_fmt("\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\",\"dropped_events\":" PRINTF_SIZE "}}",
+				buffer->tid, buffer->thread_name.c_str(), dropped);
+		for (size_t i = 0; i < written; i++) {
+			const TraceEvent &ev = buffer->events[i];
+			if (ev.start < _trace_start) continue;
+			result += stdstr_fmt(",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+					ev.name, buffer->tid, to_us(ev.start - _trace_start), to_us(ev.end - ev.start));
+		}
+	}
+	result += "\n]}\n";
+	return result;
+}
@@ -0,0 +1,57 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file tracing.h
+ * Timeline tracing of scoped events across threads, for export in the Chrome trace event format.
+ *
+ * Place a #TRACE_SCOPE with a string literal name at the start of a block to record its start time and duration
+ * whenever tracing is enabled. Each thread records into its own buffer, so no locks are taken while tracing.
+ * Tracing is controlled by the \c trace console command.
+ */
+
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <atomic>
+#include <string>
+
+extern std::atomic<bool> _tracing_enabled;
+
+uint64 GetTraceTimestamp();
+void RecordTraceEvent(const char *name, uint64 start, uint64 end);
+
+/**
+ * RAII class recording a trace event for the scope it lives in.
+ * Use the #TRACE_SCOPE macro instead of using this directly.
+ */
+class TraceScope {
+	const char *name; ///< Name of the event, must be a string literal.
+	uint64 start;     ///< Start time, or 0 when tracing was disabled at the start of the scope.
+
+public:
+	TraceScope(const char *name) : name(name), start(_tracing_enabled.load(std::memory_order_relaxed) ? GetTraceTimestamp() : 0) {}
+
+	~TraceScope()
+	{
+		if (this->start != 0) RecordTraceEvent(this->name, this->start, GetTraceTimestamp());
+	}
+
+	TraceScope(const TraceScope &) = delete;
+	TraceScope &operator=(const TraceScope &) = delete;
+};
+
+#define TRACE_SCOPE_CONCAT2(a, b) a ## b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT2(a, b)
+
+/** Record a trace event with the given name (a string literal) for the rest of the enclosing scope. */
+#define TRACE_SCOPE(name) TraceScope TRACE_SCOPE_CONCAT(trace_scope_, __LINE__)(name)
+
+void StartTracing(size_t events_per_thread);
+void StopTracing();
+std::string GetTraceJSON();
+
+#endif /* TRACING_H */
@@ -102,6 +102,7 @@ enum TrainCacheFlags : byte {
 	TCF_TILT         = 0x01,     ///< Train can tilt; feature provides a bonus in curves.
 	TCF_RL_BRAKING   = 0x02,     ///< Train realistic braking (movement physics) in effect for this vehicle
 	TCF_SPD_RAILTYPE = 0x04,     ///< Train speed varies depending on railtype
+	TCF_STATIC_LOAD  = 0x08,     ///< No part of the train uses callback 36 for weight, power or tractive effort, see Train::CargoLoadChanged
 };
 DECLARE_ENUM_AS_BIT_SET(TrainCacheFlags)
 
@@ -163,6 +164,7 @@ struct Train FINAL : public GroundVehicle<Train, VEH_TRAIN> {
 	friend struct GroundVehicle<Train, VEH_TRAIN>; // GroundVehicle needs to use the acceleration functions defined at Train.
 
 	void MarkDirty() override;
+	void CargoLoadChanged();
 	void UpdateDeltaXY() override;
 	ExpensesType GetExpenseType(bool income) const override { return income ? EXPENSES_TRAIN_REVENUE : EXPENSES_TRAIN_RUN; }
 	void PlayLeaveStationSound(bool force = false) const override;
@@ -512,6 +514,14 @@ struct TrainDecelerationStats {
 	int z_pos;
 	const Train *t;
 
+	/* Braking terms which are constant for the lifetime of the stats object, these are evaluated once instead of for every lookahead item */
+	bool slope_braking;            ///< Whether descending slopes affect the braking distance
+	bool power_braking;            ///< Whether the speed for a sloped braking distance should be solved using the power/force braking model
+	int slope_ke_factor;           ///< KE change per unit z delta, (400 * 5 / 18) * slope steepness
+	uint weight;                   ///< Cached weight, only valid if power_braking
+	int64 power_w;                 ///< Braking power in W, only valid if power_braking
+	int64 min_braking_force;       ///< Minimum braking force, only valid if power_braking
+
 	TrainDecelerationStats(const Train *t, int z_pos);
 };
 
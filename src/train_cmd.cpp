@@ -35,6 +35,7 @@
 #include "zoom_func.h"
 #include "newgrf_debug.h"
 #include "framerate_type.h"
+#include "vehicle_profile.h"
 #include "tracerestrict.h"
 #include "tbtr_template_vehicle_func.h"
 #include "autoreplace_func.h"
@@ -51,6 +52,8 @@
 #include "table/strings.h"
 #include "table/train_cmd.h"
 
+#include <queue>
+
 #include "safeguards.h"
 
 extern btree::btree_multimap<VehicleID, PendingSpeedRestrictionChange> _pending_speed_restriction_change_map;
@@ -81,7 +84,26 @@ enum ChooseTrainTrackFlags {
 };
 DECLARE_ENUM_AS_BIT_SET(ChooseTrainTrackFlags)
 
-std::unordered_map<SignalSpeedKey, SignalSpeedValue, SignalSpeedKeyHashFunc> _signal_speeds(1 << 16);
+SignalSpeedMap _signal_speeds;
+DateTicksScaled _signal_speeds_time_stamp_offset = 0; ///< Offset of all time stamps in _signal_speeds, this allows adjusting all of them at once
+
+/** Entry of _signal_speed_expiry_queue */
+struct SignalSpeedExpiry {
+	DateTicksScaled time_stamp; ///< Time stamp, relative to _signal_speeds_time_stamp_offset
+	SignalSpeedKey key;
+
+	/** Ordering for a min-heap of time stamps */
+	bool operator<(const SignalSpeedExpiry &other) const
+	{
+		return this->time_stamp > other.time_stamp;
+	}
+};
+
+/**
+ * Queue of the expiry times of _signal_speeds entries, earliest first.
+ * Entries for which the map entry has since been removed or given a different time stamp are stale, and are skipped.
+ */
+static std::priority_queue<SignalSpeedExpiry> _signal_speed_expiry_queue;
 
 static void TryLongReserveChooseTrainTrackFromReservationEnd(Train *v, bool no_reserve_vehicle_tile = false);
 static Track ChooseTrainTrack(Train *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, ChooseTrainTrackFlags flags, bool *p_got_reservation, ChooseTrainTrackLookAheadState lookahead_state = {});
@@ -117,31 +139,63 @@ static DateTicksScaled GetSpeedRestrictionTimeout(const Train *t)
 /** Checks if the timeout of the specified signal speed restriction value has passed */
 static bool IsOutOfDate(const SignalSpeedValue& value)
 {
-	return _scaled_date_ticks > value.time_stamp;
+	return _scaled_date_ticks > GetSignalSpeedTimeStamp(value);
 }
 
 /** Removes all speed restrictions from all signals */
 void ClearAllSignalSpeedRestrictions()
 {
 	_signal_speeds.clear();
+	_signal_speed_expiry_queue = {};
+	_signal_speeds_time_stamp_offset = 0;
 }
 
 void AdjustAllSignalSpeedRestrictionTickValues(DateTicksScaled delta)
 {
-	for (auto &it : _signal_speeds) {
-		it.second.time_stamp += delta;
+	_signal_speeds_time_stamp_offset += delta;
+}
+
+/** Rebuild _signal_speed_expiry_queue from _signal_speeds, dropping all stale entries */
+static void RebuildSignalSpeedExpiryQueue()
+{
+	std::vector<SignalSpeedExpiry> entries;
+	entries.reserve(_signal_speeds.size());
+	for (const auto &it : _signal_speeds) {
+		entries.push_back({ it.second.time_stamp, it.first });
+	}
+	_signal_speed_expiry_queue = std::priority_queue<SignalSpeedExpiry>(std::less<SignalSpeedExpiry>(), std::move(entries));
+}
+
+/**
+ * Insert or replace a signal speed restriction.
+ * @param key Signal and direction.
+ * @param train_speed Speed of the passing train.
+ * @param time_stamp Actual time stamp at which the restriction expires.
+ */
+void InsertSignalSpeedRestriction(const SignalSpeedKey &key, uint16 train_speed, DateTicksScaled time_stamp)
+{
+	const DateTicksScaled stored_time_stamp = time_stamp - _signal_speeds_time_stamp_offset;
+	_signal_speeds[key] = { train_speed, stored_time_stamp };
+	_signal_speed_expiry_queue.push({ stored_time_stamp, key });
+
+	/* Stop the queue growing without bound when signals are repeatedly passed before their restrictions expire */
+	if (_signal_speed_expiry_queue.size() > 1024 && _signal_speed_expiry_queue.size() > 4 * _signal_speeds.size()) {
+		RebuildSignalSpeedExpiryQueue();
 	}
 }
 
 /** Removes all speed restrictions which have passed their timeout from all signals */
 void ClearOutOfDateSignalSpeedRestrictions()
 {
-	for (auto key_value_pair = _signal_speeds.begin(); key_value_pair != _signal_speeds.end(); ) {
-		if (IsOutOfDate(key_value_pair->second)) {
-			key_value_pair = _signal_speeds.erase(key_value_pair);
-		} else {
-			++key_value_pair;
+	while (!_signal_speed_expiry_queue.empty()) {
+		const SignalSpeedExpiry &expiry = _signal_speed_expiry_queue.top();
+		if (_scaled_date_ticks <= expiry.time_stamp + _signal_speeds_time_stamp_offset) break;
+
+		auto iter = _signal_speeds.find(expiry.key);
+		if (iter != _signal_speeds.end() && iter->second.time_stamp == expiry.time_stamp) {
+			_signal_speeds.erase(iter);
 		}
+		_signal_speed_expiry_queue.pop();
 	}
 }
 
@@ -260,6 +314,8 @@ void Train::ConsistChanged(ConsistChangeFlags allowed_changes)
 
 	dbg_assert(this->IsFrontEngine() || this->IsFreeWagon());
 
+	MarkTrainTemplateDifferenceDirty(this->index);
+
 	const RailVehicleInfo *rvi_v = RailVehInfo(this->engine_type);
 	EngineID first_engine = this->IsFrontEngine() ? this->engine_type : INVALID_ENGINE;
 	this->gcache.cached_total_length = 0;
@@ -268,6 +324,7 @@ void Train::ConsistChanged(ConsistChangeFlags allowed_changes)
 
 	bool train_can_tilt = true;
 	bool speed_varies_by_railtype = false;
+	bool static_load_properties = true;
 	int min_curve_speed_mod = INT_MAX;
 
 	for (Train *u = this; u != nullptr; u = u->Next()) {
@@ -309,6 +366,10 @@ void Train::ConsistChanged(ConsistChangeFlags allowed_changes)
 
 		if (!HasBit(e_u->info.misc_flags, EF_RAIL_TILTS)) train_can_tilt = false;
 		if (e_u->callbacks_used & SGCU_CB36_SPEED_RAILTYPE) speed_varies_by_railtype = true;
+		if (HasBit(e_u->cb36_properties_used, PROP_TRAIN_WEIGHT) || HasBit(e_u->cb36_properties_used, PROP_TRAIN_POWER) ||
+				HasBit(e_u->cb36_properties_used, PROP_TRAIN_TRACTIVE_EFFORT)) {
+			static_load_properties = false;
+		}
 		min_curve_speed_mod = std::min(min_curve_speed_mod, u->GetCurveSpeedModifier());
 
 		/* Cache wagon override sprite group. nullptr is returned if there is none */
@@ -395,7 +456,8 @@ void Train::ConsistChanged(ConsistChangeFlags allowed_changes)
 
 	/* store consist weight/max speed in cache */
 	this->vcache.cached_max_speed = max_speed;
-	this->tcache.cached_tflags = (train_can_tilt ? TCF_TILT : TCF_NONE) | (speed_varies_by_railtype ? TCF_SPD_RAILTYPE : TCF_NONE);
+	this->tcache.cached_tflags = (train_can_tilt ? TCF_TILT : TCF_NONE) | (speed_varies_by_railtype ? TCF_SPD_RAILTYPE : TCF_NONE) |
+			(static_load_properties ? TCF_STATIC_LOAD : TCF_NONE);
 	this->tcache.cached_curve_speed_mod = min_curve_speed_mod;
 	this->tcache.cached_max_curve_speed = this->GetCurveSpeedLimit();
 
@@ -816,6 +878,20 @@ TrainDecelerationStats::TrainDecelerationStats(const Train *t, int z_pos)
 	this->uncapped_deceleration_x2 = 2 * t->tcache.cached_uncapped_decel;
 	this->z_pos = z_pos;
 	this->t = t;
+
+	this->slope_braking = (_settings_game.vehicle.train_acceleration_model != AM_ORIGINAL);
+	/* (5/18) is due to KE being in km/h derived units instead of m/s */
+	this->slope_ke_factor = ((400 * 5) / 18) * _settings_game.vehicle.train_slope_steepness;
+	this->power_braking = (_settings_game.vehicle.train_acceleration_model == AM_REALISTIC && GetRailTypeInfo(t->railtype)->acceleration_type != 2);
+	if (this->power_braking) {
+		this->weight = t->gcache.cached_weight;
+		this->power_w = (t->gcache.cached_power * 746ll) + (t->tcache.cached_braking_length * (int64)RBC_BRAKE_POWER_PER_LENGTH);
+		this->min_braking_force = (t->tcache.cached_braking_length * (int64)RBC_BRAKE_FORCE_PER_LENGTH) + t->gcache.cached_axle_resistance + (this->weight * 16);
+	} else {
+		this->weight = 0;
+		this->power_w = 0;
+		this->min_braking_force = 0;
+	}
 }
 
 static int64 GetRealisticBrakingDistanceForSpeed(const TrainDecelerationStats &stats, int start_speed, int end_speed, int z_delta)
@@ -828,10 +904,9 @@ static int64 GetRealisticBrakingDistanceForSpeed(const TrainDecelerationStats &s
 
 	int64 dist = ke_delta / stats.deceleration_x2;
 
-	if (z_delta < 0 && _settings_game.vehicle.train_acceleration_model != AM_ORIGINAL) {
+	if (z_delta < 0 && stats.slope_braking) {
 		/* descending */
-		/* (5/18) is due to KE being in km/h derived units instead of m/s */
-		int64 slope_dist = (ke_delta - (z_delta * ((400 * 5) / 18) * _settings_game.vehicle.train_slope_steepness)) / stats.uncapped_deceleration_x2;
+		int64 slope_dist = (ke_delta - (z_delta * stats.slope_ke_factor)) / stats.uncapped_deceleration_x2;
 		dist = std::max<int64>(dist, slope_dist);
 	}
 	return dist;
@@ -848,18 +923,16 @@ static int GetRealisticBrakingSpeedForDistance(const TrainDecelerationStats &sta
 
 	if (speed_sqr <= REALISTIC_BRAKING_MIN_SPEED * REALISTIC_BRAKING_MIN_SPEED) return REALISTIC_BRAKING_MIN_SPEED;
 
-	if (z_delta < 0 && _settings_game.vehicle.train_acceleration_model != AM_ORIGINAL) {
+	if (z_delta < 0 && stats.slope_braking) {
 		/* descending */
-		/* (5/18) is due to KE being in km/h derived units instead of m/s */
-		int64 sloped_ke = target_ke + (z_delta * ((400 * 5) / 18) * _settings_game.vehicle.train_slope_steepness);
+		int64 sloped_ke = target_ke + (z_delta * stats.slope_ke_factor);
 		int64 slope_speed_sqr = sloped_ke + ((int64)stats.uncapped_deceleration_x2 * (int64)distance);
-		if (slope_speed_sqr < speed_sqr &&
-				_settings_game.vehicle.train_acceleration_model == AM_REALISTIC && GetRailTypeInfo(stats.t->railtype)->acceleration_type != 2) {
+		if (slope_speed_sqr < speed_sqr && stats.power_braking) {
 			/* calculate speed at which braking would be sufficient */
 
-			uint weight = stats.t->gcache.cached_weight;
-			int64 power_w = (stats.t->gcache.cached_power * 746ll) + (stats.t->tcache.cached_braking_length * (int64)RBC_BRAKE_POWER_PER_LENGTH);
-			int64 min_braking_force = (stats.t->tcache.cached_braking_length * (int64)RBC_BRAKE_FORCE_PER_LENGTH) + stats.t->gcache.cached_axle_resistance + (weight * 16);
+			const uint weight = stats.weight;
+			const int64 power_w = stats.power_w;
+			const int64 min_braking_force = stats.min_braking_force;
 
 			/* F = (7/8) * (F_min + ((power_w * 18) / (5 * v)))
 			 * v^2 = sloped_ke + F * s / (4 * m)
@@ -1163,6 +1236,8 @@ void Train::UpdateAcceleration()
 {
 	dbg_assert(this->IsFrontEngine() || this->IsFreeWagon());
 
+	this->InvalidateAccelerationCache();
+
 	uint power = this->gcache.cached_power;
 	uint weight = this->gcache.cached_weight;
 	assert(weight != 0);
@@ -1794,6 +1869,7 @@ static void NormaliseSubtypes(Train *chain)
 
 	/* Now clear the bits for the rest of the chain */
 	for (Train *t = chain->Next(); t != nullptr; t = t->Next()) {
+		if (t->IsFrontEngine()) MarkTrainTemplateDifferenceDirty(t->index);
 		t->ClearFreeWagon();
 		t->ClearFrontEngine();
 	}
@@ -3792,6 +3868,9 @@ static const byte _initial_tile_subcoord[6][4][3] = {
  */
 static Track DoTrainPathfind(const Train *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, bool do_track_reservation, PBSTileInfo *dest, TileIndex *final_dest)
 {
+	PerformanceAccumulator framerate(PFE_GL_TRAIN_PF);
+	VehicleProfileScope profile(v, VPC_PATHFINDING);
+
 	if (final_dest != nullptr) *final_dest = INVALID_TILE;
 
 	switch (_settings_game.pf.pathfinder_for_trains) {
@@ -4723,6 +4802,44 @@ void Train::MarkDirty()
 	this->UpdateAcceleration();
 }
 
+/**
+ * Marks the vehicles to be redrawn and updates cached variables, when only the amount of cargo loaded in the train changed.
+ * If no part of the train uses callback 36 for weight, power or tractive effort, the total power and the track speed limit
+ * cannot have changed, so only the weights and the tractive effort of the powered parts are recalculated.
+ * Otherwise this is equivalent to #MarkDirty.
+ */
+void Train::CargoLoadChanged()
+{
+	if (!(this->tcache.cached_tflags & TCF_STATIC_LOAD)) {
+		this->MarkDirty();
+		return;
+	}
+
+	uint32 max_te = 0;
+	for (Train *u = this; u != nullptr; u = u->Next()) {
+		u->colourmap = PAL_NONE;
+		u->InvalidateImageCache();
+		u->UpdateViewport(true, false);
+
+		/* Only powered parts add tractive effort, see GroundVehicle::CalculatePower */
+		if ((!u->IsArticulatedPart() && RailVehInfo(u->engine_type)->power > 0) || HasBit(u->flags, VRF_POWEREDWAGON)) {
+			if (u->GetPower() + u->GetPoweredPartPower(u) > 0) max_te += u->GetWeight() * u->GetTractiveEffort();
+		}
+	}
+	max_te *= GROUND_ACCELERATION; // Tractive effort in (tonnes * 1000 * 9.8 =) N.
+	max_te /= 256;  // Tractive effort is a [0-255] coefficient.
+
+	this->CargoWeightChanged();
+
+	if (this->gcache.cached_max_te != max_te) {
+		this->gcache.cached_max_te = max_te;
+		SetWindowDirty(WC_VEHICLE_DETAILS, this->index);
+		SetWindowWidgetDirty(WC_VEHICLE_VIEW, this->index, WID_VV_START_STOP);
+	}
+
+	this->UpdateAcceleration();
+}
+
 /**
  * This function looks at the vehicle and updates its speed (cur_speed
  * and subspeed) variables. Furthermore, it returns the distance that
@@ -4987,6 +5104,17 @@ static Vehicle *FindTrainCollideEnum(Vehicle *v, void *data)
 {
 	TrainCollideChecker *tcc = (TrainCollideChecker*)data;
 
+	int x_diff = v->x_pos - tcc->v->x_pos;
+	int y_diff = v->y_pos - tcc->v->y_pos;
+
+	/* Do fast calculation to check whether trains are not in close vicinity
+	 * and quickly reject trains distant enough for any collision.
+	 * Differences are shifted by 7, mapping range [-7 .. 8] into [0 .. 15]
+	 * Differences are then ORed and then we check for any higher bits.
+	 * This rejects nearly all vehicles in the hash chains, so do it before anything else. */
+	uint hash = (y_diff + 7) | (x_diff + 7);
+	if (hash & ~15) return nullptr;
+
 	/* not in depot */
 	if (Train::From(v)->track == TRACK_BIT_DEPOT) return nullptr;
 
@@ -5001,16 +5129,6 @@ static Vehicle *FindTrainCollideEnum(Vehicle *v, void *data)
 	/* can't collide with own wagons */
 	if (coll == tcc->v) return nullptr;
 
-	int x_diff = v->x_pos - tcc->v->x_pos;
-	int y_diff = v->y_pos - tcc->v->y_pos;
-
-	/* Do fast calculation to check whether trains are not in close vicinity
-	 * and quickly reject trains distant enough for any collision.
-	 * Differences are shifted by 7, mapping range [-7 .. 8] into [0 .. 15]
-	 * Differences are then ORed and then we check for any higher bits */
-	uint hash = (y_diff + 7) | (x_diff + 7);
-	if (hash & ~15) return nullptr;
-
 	/* Slower check using multiplication */
 	int min_diff = (Train::From(v)->gcache.cached_veh_length + 1) / 2 + (tcc->v->gcache.cached_veh_length + 1) / 2 - 1;
 	if (x_diff * x_diff + y_diff * y_diff >= min_diff * min_diff) return nullptr;
@@ -6498,6 +6616,18 @@ Money Train::CalculateCurrentOverallValue() const
 	return ovr_value;
 }
 
+/**
+ * Check whether a train is stopped and stationary with no pending state to process.
+ * Both passes of TrainLocoHandler return without any effect for such a train, so they can be skipped.
+ * @param v Front vehicle of the train.
+ * @return True if the train controller has nothing to do this tick.
+ */
+static inline bool IsTrainIdleStopped(const Train *v)
+{
+	return (v->vehstatus & (VS_STOPPED | VS_CRASHED)) == VS_STOPPED && v->cur_speed == 0 && v->crash_anim_pos == 0 &&
+			v->force_proceed == TFP_NONE && !HasBit(v->flags, VRF_CONSIST_BREAKDOWN) && !HasBit(v->flags, VRF_REVERSING);
+}
+
 static bool TrainLocoHandler(Train *v, bool mode)
 {
 	/* train has crashed? */
@@ -6733,6 +6863,8 @@ bool Train::Tick()
 
 		this->current_order_time++;
 
+		if (IsTrainIdleStopped(this)) return true;
+
 		if (!TrainLocoHandler(this, false)) return false;
 
 		return TrainLocoHandler(this, true);
@@ -7476,11 +7608,7 @@ void SetSignalTrainAdaptationSpeed(const Train *v, TileIndex tile, uint16 track)
 		speed_key.signal_track = track,
 		speed_key.last_passing_train_dir = v->GetVehicleTrackdir()
 	};
-	SignalSpeedValue speed_value = {
-		speed_value.train_speed = v->First()->cur_speed,
-		speed_value.time_stamp = GetSpeedRestrictionTimeout(v->First())
-	};
-	_signal_speeds[speed_key] = speed_value;
+	InsertSignalSpeedRestriction(speed_key, v->First()->cur_speed, GetSpeedRestrictionTimeout(v->First()));
 }
 
 void ApplySignalTrainAdaptationSpeed(Train *v, TileIndex tile, uint16 track)
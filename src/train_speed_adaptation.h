@@ -13,8 +13,7 @@
 #include "date_type.h"
 #include "track_type.h"
 #include "tile_type.h"
-
-#include <unordered_map>
+#include "3rdparty/robin_hood/robin_hood.h"
 
 struct SignalSpeedKey
 {
@@ -48,7 +47,21 @@ struct SignalSpeedKeyHashFunc
 	}
 };
 
-extern std::unordered_map<SignalSpeedKey, SignalSpeedValue, SignalSpeedKeyHashFunc> _signal_speeds;
+/**
+ * Map of signal speed restrictions.
+ * The stored time stamps are relative to _signal_speeds_time_stamp_offset, see GetSignalSpeedTimeStamp.
+ */
+typedef robin_hood::unordered_flat_map<SignalSpeedKey, SignalSpeedValue, SignalSpeedKeyHashFunc> SignalSpeedMap;
+extern SignalSpeedMap _signal_speeds;
+extern DateTicksScaled _signal_speeds_time_stamp_offset;
+
+/** Get the actual time stamp of a SignalSpeedValue in _signal_speeds */
+inline DateTicksScaled GetSignalSpeedTimeStamp(const SignalSpeedValue &value)
+{
+	return value.time_stamp + _signal_speeds_time_stamp_offset;
+}
+
+void InsertSignalSpeedRestriction(const SignalSpeedKey &key, uint16 train_speed, DateTicksScaled time_stamp);
 
 struct Train;
 void SetSignalTrainAdaptationSpeed(const Train *v, TileIndex tile, uint16 track);
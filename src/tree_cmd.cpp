@@ -23,6 +23,7 @@
 #include "core/random_func.hpp"
 #include "newgrf_generic.h"
 #include "date_func.h"
+#include "pathfinder/water_regions.h"
 
 #include "table/strings.h"
 #include "table/tree_land.h"
@@ -177,9 +178,10 @@ static void RecalculateArcticTreeOccuranceArray()
  *
  * @param tile The tile to get a random TreeType from
  * @param seed The seed for randomness, must be less than 256
+ * @param random Random number generator of a map generation band pass, or nullptr to use the game random number generator.
  * @return The random tree type
  */
-static TreeType GetRandomTreeType(TileIndex tile, uint seed)
+static TreeType GetRandomTreeType(TileIndex tile, uint seed, Randomizer *random = nullptr)
 {
 	switch (_settings_game.game_creation.landscape) {
 		case LT_TEMPERATE:
@@ -204,7 +206,7 @@ static TreeType GetRandomTreeType(TileIndex tile, uint seed)
 			uint normalised_distance = (height_above_snow_line < 0) ? -height_above_snow_line : height_above_snow_line + 1;
 			bool arctic_tree = false;
 			if (normalised_distance < _arctic_tree_occurance.size()) {
-				arctic_tree = RandomRange(256) < _arctic_tree_occurance[normalised_distance];
+				arctic_tree = (random != nullptr ? random->Next(256) : RandomRange(256)) < _arctic_tree_occurance[normalised_distance];
 			}
 			if (height_above_snow_line < 0) {
 				/* Below snow level mixed forest. */
@@ -234,14 +236,16 @@ static TreeType GetRandomTreeType(TileIndex tile, uint seed)
  *
  * @param tile The tile to make a tree-tile from
  * @param r The randomness value from a Random() value
+ * @param random Random number generator of a map generation band pass, or nullptr to use the game random number generator.
  */
-static void PlaceTree(TileIndex tile, uint32 r)
+static void PlaceTree(TileIndex tile, uint32 r, Randomizer *random = nullptr)
 {
-	TreeType tree = GetRandomTreeType(tile, GB(r, 24, 8));
+	TreeType tree = GetRandomTreeType(tile, GB(r, 24, 8), random);
 
 	if (tree != TREE_INVALID) {
 		PlantTreesOnTile(tile, tree, GB(r, 22, 2), std::min<byte>(GB(r, 16, 3), 6));
-		MarkTileDirtyByTile(tile);
+		/* Band passes do not mark tiles dirty, see RunGenerateWorldBandPass. */
+		if (random == nullptr) MarkTileDirtyByTile(tile);
 
 		/* Rerandomize ground, if neither snow nor shore */
 		TreeGround ground = GetTreeGround(tile);
@@ -259,30 +263,31 @@ static void PlaceTree(TileIndex tile, uint32 r)
  */
 static void PlaceTreeGroups(uint num_groups)
 {
-	do {
-		TileIndex center_tile = RandomTile();
+	static_assert(16 < GENWORLD_BAND_MARGIN);
 
-		for (uint i = 0; i < DEFAULT_TREE_STEPS; i++) {
-			uint32 r = Random();
-			int x = GB(r, 0, 5) - 16;
-			int y = GB(r, 8, 5) - 16;
-			uint dist = abs(x) + abs(y);
-			TileIndex cur_tile = TileAddWrap(center_tile, x, y);
+	RunGenerateWorldBandPass(GWP_TREE, [&](uint y_begin, uint y_end, Randomizer &random) {
+		for (uint n = GetGenerateWorldBandShare(num_groups, y_begin, y_end); n != 0; n--) {
+			TileIndex center_tile = TileXY(random.Next(MapSizeX()), y_begin + random.Next(y_end - y_begin));
 
-			IncreaseGeneratingWorldProgress(GWP_TREE);
+			for (uint i = 0; i < DEFAULT_TREE_STEPS; i++) {
+				uint32 r = random.Next();
+				int x = GB(r, 0, 5) - 16;
+				int y = GB(r, 8, 5) - 16;
+				uint dist = abs(x) + abs(y);
+				TileIndex cur_tile = TileAddWrap(center_tile, x, y);
 
-			if (cur_tile != INVALID_TILE && dist <= 13 && CanPlantTreesOnTile(cur_tile, true)) {
-				PlaceTree(cur_tile, r);
+				if (cur_tile != INVALID_TILE && dist <= 13 && CanPlantTreesOnTile(cur_tile, true)) {
+					PlaceTree(cur_tile, r, &random);
+				}
 			}
 		}
-
-	} while (--num_groups);
+	});
 }
 
-static TileIndex FindTreePositionAtSameHeight(TileIndex tile, int height, uint steps)
+static TileIndex FindTreePositionAtSameHeight(TileIndex tile, int height, uint steps, Randomizer *random = nullptr)
 {
 	for (uint i = 0; i < steps; i++) {
-		const uint32 r = Random();
+		const uint32 r = random != nullptr ? random->Next() : Random();
 		const int x = GB(r, 0, 5) - 16;
 		const int y = GB(r, 8, 5) - 16;
 		const TileIndex cur_tile = TileAddWrap(tile, x, y);
@@ -330,13 +335,14 @@ static void PlantTreeAtSameHeight(TileIndex tile)
  *
  * @param tile The base tile to add a new tree somewhere around
  * @param height The height (from GetTileZ)
+ * @param random Random number generator of a map generation band pass, or nullptr to use the game random number generator.
  */
-static void PlaceTreeAtSameHeight(TileIndex tile, int height)
+static void PlaceTreeAtSameHeight(TileIndex tile, int height, Randomizer *random = nullptr)
 {
-	const auto new_tile = FindTreePositionAtSameHeight(tile, height, DEFAULT_TREE_STEPS);
+	const auto new_tile = FindTreePositionAtSameHeight(tile, height, DEFAULT_TREE_STEPS, random);
 
 	if (new_tile != INVALID_TILE) {
-		PlaceTree(new_tile, Random());
+		PlaceTree(new_tile, random != nullptr ? random->Next() : Random(), random);
 	}
 }
 
@@ -424,6 +430,51 @@ void PlaceTreesRandomly()
 	}
 }
 
+/**
+ * Place some trees randomly during map generation, like #PlaceTreesRandomly.
+ * The map is processed in bands in parallel, see #RunGenerateWorldBandPass.
+ */
+static void PlaceTreesRandomlyInBands()
+{
+	/* Make sure the shared lookup table is not lazily recalculated by the bands. */
+	if (_settings_game.construction.trees_around_snow_line_range != _previous_trees_around_snow_line_range) RecalculateArcticTreeOccuranceArray();
+
+	const uint steps = ScaleByMapSize(DEFAULT_TREE_STEPS);
+	const uint rainforest_steps = ScaleByMapSize(DEFAULT_RAINFOREST_TREE_STEPS);
+
+	RunGenerateWorldBandPass(GWP_TREE, [&](uint y_begin, uint y_end, Randomizer &random) {
+		for (uint i = GetGenerateWorldBandShare(steps, y_begin, y_end); i != 0; i--) {
+			uint32 r = random.Next();
+			TileIndex tile = TileXY(random.Next(MapSizeX()), y_begin + random.Next(y_end - y_begin));
+
+			if (!CanPlantTreesOnTile(tile, true)) continue;
+
+			PlaceTree(tile, r, &random);
+			if (_settings_game.game_creation.tree_placer != TP_IMPROVED &&
+				_settings_game.game_creation.tree_placer != TP_PERFECT) continue;
+
+			/* Place a number of trees based on the tile height, see PlaceTreesRandomly. */
+			int ht = GetTileZ(tile);
+			int j = ht * 2;
+			if (_settings_game.game_creation.landscape == LT_ARCTIC && ht > GetSnowLine()) j *= 3;
+			while (j--) {
+				PlaceTreeAtSameHeight(tile, ht, &random);
+			}
+		}
+
+		/* place extra trees at rainforest area */
+		if (_settings_game.game_creation.landscape != LT_TROPIC) return;
+		for (uint i = GetGenerateWorldBandShare(rainforest_steps, y_begin, y_end); i != 0; i--) {
+			uint32 r = random.Next();
+			TileIndex tile = TileXY(random.Next(MapSizeX()), y_begin + random.Next(y_end - y_begin));
+
+			if (GetTropicZone(tile) == TROPICZONE_RAINFOREST && CanPlantTreesOnTile(tile, false)) {
+				PlaceTree(tile, r, &random);
+			}
+		}
+	});
+}
+
 /**
  * Remove all trees
  *
@@ -515,13 +566,12 @@ void GenerateTrees()
 		default: NOT_REACHED();
 	}
 
-	total = ScaleByMapSize(DEFAULT_TREE_STEPS);
-	if (_settings_game.game_creation.landscape == LT_TROPIC) total += ScaleByMapSize(DEFAULT_RAINFOREST_TREE_STEPS);
-	total *= i;
+	/* Each band pass increases the progress twice. */
+	total = 2 * i;
 	uint num_groups = (_settings_game.game_creation.landscape != LT_TOYLAND) ? ScaleByMapSize(GB(Random(), 0, 5) + 25) : 0;
 
-	if (_settings_game.game_creation.tree_placer != TP_PERFECT) {
-		total += num_groups * DEFAULT_TREE_STEPS;
+	if (_settings_game.game_creation.tree_placer != TP_PERFECT && num_groups != 0) {
+		total += 2;
 	}
 
 	SetGeneratingWorldProgress(GWP_TREE, total);
@@ -531,7 +581,7 @@ void GenerateTrees()
 	}
 
 	for (; i != 0; i--) {
-		PlaceTreesRandomly();
+		PlaceTreesRandomlyInBands();
 	}
 }
 
@@ -1008,7 +1058,10 @@ static void TileLoop_Trees(TileIndex tile)
 			} else {
 				/* just one tree, change type into MP_CLEAR */
 				switch (GetTreeGround(tile)) {
-					case TREE_GROUND_SHORE: MakeShore(tile); break;
+					case TREE_GROUND_SHORE:
+						MakeShore(tile);
+						InvalidateWaterRegion(tile);
+						break;
 					case TREE_GROUND_GRASS: MakeClear(tile, CLEAR_GRASS, GetTreeDensity(tile)); break;
 					case TREE_GROUND_ROUGH: MakeClear(tile, CLEAR_ROUGH, 3); break;
 					case TREE_GROUND_ROUGH_SNOW: {
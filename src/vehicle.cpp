@@ -54,11 +54,14 @@
 #include "linkgraph/linkgraph.h"
 #include "linkgraph/refresh.h"
 #include "framerate_type.h"
+#include "vehicle_profile.h"
+#include "tracing.h"
 #include "blitter/factory.hpp"
 #include "tbtr_template_vehicle_func.h"
 #include "string_func.h"
 #include "scope_info.h"
 #include "debug_settings.h"
+#include "worker_thread.h"
 #include "3rdparty/cpp-btree/btree_set.h"
 #include "3rdparty/cpp-btree/btree_map.h"
 
@@ -538,27 +541,18 @@ Vehicle *VehicleFromPos(TileIndex tile, VehicleType type, void *data, VehicleFro
 }
 
 /**
- * Callback that returns 'real' vehicles lower or at height \c *(int*)data .
- * @param v Vehicle to examine.
- * @param data unused.
- * @return \a v if conditions are met, else \c nullptr.
- */
-static Vehicle *EnsureNoVehicleProc(Vehicle *v, void *data)
-{
-	return v;
-}
-
-/**
- * Callback that returns 'real' train-collidable road vehicles lower or at height \c *(int*)data .
- * @param v Vehicle to examine.
- * @param data unused
- * @return \a v if conditions are met, else \c nullptr.
+ * Get the start of the tile hash chain which contains the vehicles of the given type on \a tile.
+ * The chain may also contain vehicles on other tiles.
+ * @param tile The location on the map
+ * @param type The vehicle type, this must be less than VEH_COMPANY_END.
+ * @return The first vehicle in the chain, or nullptr if the chain is empty.
  */
-static Vehicle *EnsureNoTrainCollidableRoadVehicleProc(Vehicle *v, void *data)
+Vehicle *GetVehicleTileHashChain(TileIndex tile, VehicleType type)
 {
-	if (HasBit(_roadtypes_non_train_colliding, RoadVehicle::From(v)->roadtype)) return nullptr;
+	int x = GB(TileX(tile), HASH_RES, HASH_BITS);
+	int y = GB(TileY(tile), HASH_RES, HASH_BITS) << HASH_BITS;
 
-	return v;
+	return _vehicle_tile_hash[((x + y) & TOTAL_HASH_MASK) + (TOTAL_HASH_SIZE * type)];
 }
 
 /**
@@ -593,17 +587,17 @@ CommandCost EnsureNoVehicleOnGround(TileIndex tile)
 	}
 
 	if (IsTileType(tile, MP_RAILWAY) || IsLevelCrossingTile(tile) || HasStationTileRail(tile) || IsRailTunnelBridgeTile(tile)) {
-		if (VehicleFromPos(tile, VEH_TRAIN, nullptr, &EnsureNoVehicleProc, true) != nullptr) {
+		if (HasVehicleOnTile(tile, VEH_TRAIN)) {
 			return CommandCost(STR_ERROR_TRAIN_IN_THE_WAY);
 		}
 	}
 	if (IsTileType(tile, MP_ROAD) || IsAnyRoadStopTile(tile) || (IsTileType(tile, MP_TUNNELBRIDGE) && GetTunnelBridgeTransportType(tile) == TRANSPORT_ROAD)) {
-		if (VehicleFromPos(tile, VEH_ROAD, nullptr, &EnsureNoVehicleProc, true) != nullptr) {
+		if (HasVehicleOnTile(tile, VEH_ROAD)) {
 			return CommandCost(STR_ERROR_ROAD_VEHICLE_IN_THE_WAY);
 		}
 	}
 	if (HasTileWaterClass(tile) || (IsBridgeTile(tile) && GetTunnelBridgeTransportType(tile) == TRANSPORT_WATER)) {
-		if (VehicleFromPos(tile, VEH_SHIP, nullptr, &EnsureNoVehicleProc, true) != nullptr) {
+		if (HasVehicleOnTile(tile, VEH_SHIP)) {
 			return CommandCost(STR_ERROR_SHIP_IN_THE_WAY);
 		}
 	}
@@ -613,7 +607,9 @@ CommandCost EnsureNoVehicleOnGround(TileIndex tile)
 
 bool IsTrainCollidableRoadVehicleOnGround(TileIndex tile)
 {
-	return VehicleFromPos(tile, VEH_ROAD, nullptr, &EnsureNoTrainCollidableRoadVehicleProc, true) != nullptr;
+	return HasVehicleOnTile(tile, VEH_ROAD, [](const Vehicle *v) {
+		return !HasBit(_roadtypes_non_train_colliding, RoadVehicle::From(v)->roadtype);
+	});
 }
 
 struct GetVehicleTunnelBridgeProcData {
@@ -668,89 +664,53 @@ CommandCost TunnelBridgeIsFree(TileIndex tile, TileIndex endtile, const Vehicle
 	return CommandCost();
 }
 
-struct FindTrainClosestToTunnelBridgeEndInfo {
-	Train *best;     ///< The currently "best" vehicle we have found.
-	int32 best_pos;
-	DiagDirection direction;
-
-	FindTrainClosestToTunnelBridgeEndInfo(DiagDirection direction) : best(nullptr), best_pos(INT32_MIN), direction(direction) {}
-};
-
-/** Callback for Has/FindVehicleOnPos to find a train in a signalled tunnel/bridge */
-static Vehicle *FindClosestTrainToTunnelBridgeEndEnum(Vehicle *v, void *data)
+/**
+ * Check whether a train vehicle in a signalled tunnel/bridge is the front or back of its train,
+ * and is on the across track pieces of the tunnel/bridge, when looking for train ends in the tunnel/bridge.
+ * @param v The vehicle.
+ * @return True if the vehicle is a train end which should be considered.
+ */
+static inline bool IsTunnelBridgeTrainEndCandidate(const Vehicle *v)
 {
-	FindTrainClosestToTunnelBridgeEndInfo *info = (FindTrainClosestToTunnelBridgeEndInfo *)data;
-
-	/* Only look for train heads and tails. */
-	if (v->Previous() != nullptr && v->Next() != nullptr) return nullptr;
-
-	if ((v->vehstatus & VS_CRASHED)) return nullptr;
-
-	Train *t = Train::From(v);
+	/* Don't look at wagons between front and back of train. */
+	if (v->Previous() != nullptr && v->Next() != nullptr) return false;
 
-	if (!IsDiagonalDirection(t->direction)) {
+	if (!IsDiagonalDirection(v->direction)) {
 		/* Check for vehicles on non-across track pieces of custom bridge head */
-		if ((GetAcrossTunnelBridgeTrackBits(t->tile) & t->track & TRACK_BIT_ALL) == TRACK_BIT_NONE) return nullptr;
-	}
-
-	int32 pos;
-	switch (info->direction) {
-		default: NOT_REACHED();
-		case DIAGDIR_NE: pos = -v->x_pos; break; // X: lower is better
-		case DIAGDIR_SE: pos =  v->y_pos; break; // Y: higher is better
-		case DIAGDIR_SW: pos =  v->x_pos; break; // X: higher is better
-		case DIAGDIR_NW: pos = -v->y_pos; break; // Y: lower is better
-	}
-
-	/* ALWAYS return the lowest ID (anti-desync!) if the coordinate is the same */
-	if (pos > info->best_pos || (pos == info->best_pos && t->First()->index < info->best->index)) {
-		info->best = t->First();
-		info->best_pos = pos;
+		if ((GetAcrossTunnelBridgeTrackBits(v->tile) & Train::From(v)->track & TRACK_BIT_ALL) == TRACK_BIT_NONE) return false;
 	}
 
-	return t;
+	return true;
 }
 
 Train *GetTrainClosestToTunnelBridgeEnd(TileIndex tile, TileIndex other_tile)
 {
-	FindTrainClosestToTunnelBridgeEndInfo info(ReverseDiagDir(GetTunnelBridgeDirection(tile)));
-	FindVehicleOnPos(tile, VEH_TRAIN, &info, FindClosestTrainToTunnelBridgeEndEnum);
-	FindVehicleOnPos(other_tile, VEH_TRAIN, &info, FindClosestTrainToTunnelBridgeEndEnum);
-	return info.best;
-}
-
-
-struct GetAvailableFreeTilesInSignalledTunnelBridgeChecker {
-	DiagDirection direction;
-	int pos;
-	int lowest_seen;
-};
-
-static Vehicle *GetAvailableFreeTilesInSignalledTunnelBridgeEnum(Vehicle *v, void *data)
-{
-	/* Don't look at wagons between front and back of train. */
-	if ((v->Previous() != nullptr && v->Next() != nullptr)) return nullptr;
-
-	if (!IsDiagonalDirection(v->direction)) {
-		/* Check for vehicles on non-across track pieces of custom bridge head */
-		if ((GetAcrossTunnelBridgeTrackBits(v->tile) & Train::From(v)->track & TRACK_BIT_ALL) == TRACK_BIT_NONE) return nullptr;
-	}
-
-	GetAvailableFreeTilesInSignalledTunnelBridgeChecker *checker = (GetAvailableFreeTilesInSignalledTunnelBridgeChecker*) data;
-	int v_pos;
-
-	switch (checker->direction) {
-		default: NOT_REACHED();
-		case DIAGDIR_NE: v_pos = -v->x_pos + TILE_UNIT_MASK; break;
-		case DIAGDIR_SE: v_pos =  v->y_pos; break;
-		case DIAGDIR_SW: v_pos =  v->x_pos; break;
-		case DIAGDIR_NW: v_pos = -v->y_pos + TILE_UNIT_MASK; break;
-	}
-	if (v_pos > checker->pos && v_pos < checker->lowest_seen) {
-		checker->lowest_seen = v_pos;
-	}
+	const DiagDirection direction = ReverseDiagDir(GetTunnelBridgeDirection(tile));
+	Train *best = nullptr;
+	int32 best_pos = INT32_MIN;
+
+	auto check_vehicle = [&](Vehicle *v) {
+		if ((v->vehstatus & VS_CRASHED)) return;
+		if (!IsTunnelBridgeTrainEndCandidate(v)) return;
+
+		int32 pos;
+		switch (direction) {
+			default: NOT_REACHED();
+			case DIAGDIR_NE: pos = -v->x_pos; break; // X: lower is better
+			case DIAGDIR_SE: pos =  v->y_pos; break; // Y: higher is better
+			case DIAGDIR_SW: pos =  v->x_pos; break; // X: higher is better
+			case DIAGDIR_NW: pos = -v->y_pos; break; // Y: lower is better
+		}
 
-	return nullptr;
+		/* ALWAYS return the lowest ID (anti-desync!) if the coordinate is the same */
+		if (pos > best_pos || (pos == best_pos && v->First()->index < best->index)) {
+			best = Train::From(v)->First();
+			best_pos = pos;
+		}
+	};
+	IterateVehiclesOnTile(tile, VEH_TRAIN, check_vehicle);
+	IterateVehiclesOnTile(other_tile, VEH_TRAIN, check_vehicle);
+	return best;
 }
 
 int GetAvailableFreeTilesInSignalledTunnelBridgeWithStartOffset(TileIndex entrance, TileIndex exit, int offset)
@@ -765,26 +725,41 @@ int GetAvailableFreeTilesInSignalledTunnelBridgeWithStartOffset(TileIndex entran
 
 int GetAvailableFreeTilesInSignalledTunnelBridge(TileIndex entrance, TileIndex exit, TileIndex tile)
 {
-	GetAvailableFreeTilesInSignalledTunnelBridgeChecker checker;
-	checker.direction = GetTunnelBridgeDirection(entrance);
-	checker.lowest_seen = INT_MAX;
-	switch (checker.direction) {
+	const DiagDirection direction = GetTunnelBridgeDirection(entrance);
+	int pos;
+	switch (direction) {
 		default: NOT_REACHED();
-		case DIAGDIR_NE: checker.pos = -(int)(TileX(tile) * TILE_SIZE); break;
-		case DIAGDIR_SE: checker.pos =       (TileY(tile) * TILE_SIZE); break;
-		case DIAGDIR_SW: checker.pos =       (TileX(tile) * TILE_SIZE); break;
-		case DIAGDIR_NW: checker.pos = -(int)(TileY(tile) * TILE_SIZE); break;
-	}
-
-	FindVehicleOnPos(entrance, VEH_TRAIN, &checker, &GetAvailableFreeTilesInSignalledTunnelBridgeEnum);
-	FindVehicleOnPos(exit, VEH_TRAIN, &checker, &GetAvailableFreeTilesInSignalledTunnelBridgeEnum);
+		case DIAGDIR_NE: pos = -(int)(TileX(tile) * TILE_SIZE); break;
+		case DIAGDIR_SE: pos =       (TileY(tile) * TILE_SIZE); break;
+		case DIAGDIR_SW: pos =       (TileX(tile) * TILE_SIZE); break;
+		case DIAGDIR_NW: pos = -(int)(TileY(tile) * TILE_SIZE); break;
+	}
+	int lowest_seen = INT_MAX;
+
+	auto check_vehicle = [&](const Vehicle *v) {
+		if (!IsTunnelBridgeTrainEndCandidate(v)) return;
+
+		int v_pos;
+		switch (direction) {
+			default: NOT_REACHED();
+			case DIAGDIR_NE: v_pos = -v->x_pos + TILE_UNIT_MASK; break;
+			case DIAGDIR_SE: v_pos =  v->y_pos; break;
+			case DIAGDIR_SW: v_pos =  v->x_pos; break;
+			case DIAGDIR_NW: v_pos = -v->y_pos + TILE_UNIT_MASK; break;
+		}
+		if (v_pos > pos && v_pos < lowest_seen) {
+			lowest_seen = v_pos;
+		}
+	};
+	IterateVehiclesOnTile(entrance, VEH_TRAIN, check_vehicle);
+	IterateVehiclesOnTile(exit, VEH_TRAIN, check_vehicle);
 
-	if (checker.lowest_seen == INT_MAX) {
+	if (lowest_seen == INT_MAX) {
 		/* Remainder of bridge/tunnel is clear */
 		return INT_MAX;
 	}
 
-	return (checker.lowest_seen - checker.pos) / TILE_SIZE;
+	return (lowest_seen - pos) / TILE_SIZE;
 }
 
 static Vehicle *EnsureNoTrainOnTrackProc(Vehicle *v, void *data)
@@ -869,32 +844,48 @@ bool ValidateVehicleTileHash(const Vehicle *v)
 	return v->hash_tile_current == &_vehicle_tile_hash[((x + y) & TOTAL_HASH_MASK) + (TOTAL_HASH_SIZE * v->type)];
 }
 
-static Vehicle *_vehicle_viewport_hash[1 << (GEN_HASHX_BITS + GEN_HASHY_BITS)];
+/** Visual location hash, each cell is a contiguous array of the vehicles in it. */
+static std::vector<Vehicle *> _vehicle_viewport_hash[1 << (GEN_HASHX_BITS + GEN_HASHY_BITS)];
+
+/**
+ * Remove a vehicle from a cell of the visual location hash.
+ * The last vehicle in the cell takes its place.
+ * @param v Vehicle to remove.
+ * @param hash Cell the vehicle is in.
+ */
+static inline void RemoveFromVehicleViewportHash(Vehicle *v, int hash)
+{
+	std::vector<Vehicle *> &cell = _vehicle_viewport_hash[hash];
+	Vehicle *last = cell.back();
+	cell[v->hash_viewport_index] = last;
+	last->hash_viewport_index = v->hash_viewport_index;
+	cell.pop_back();
+}
+
+/**
+ * Add a vehicle to a cell of the visual location hash.
+ * @param v Vehicle to add.
+ * @param hash Cell to add the vehicle to.
+ */
+static inline void AddToVehicleViewportHash(Vehicle *v, int hash)
+{
+	std::vector<Vehicle *> &cell = _vehicle_viewport_hash[hash];
+	v->hash_viewport_index = (uint32)cell.size();
+	cell.push_back(v);
+}
 
 static void UpdateVehicleViewportHash(Vehicle *v, int x, int y)
 {
-	Vehicle **old_hash, **new_hash;
 	int old_x = v->coord.left;
 	int old_y = v->coord.top;
 
-	new_hash = (x == INVALID_COORD) ? nullptr : &_vehicle_viewport_hash[GEN_HASH(x, y)];
-	old_hash = (old_x == INVALID_COORD) ? nullptr : &_vehicle_viewport_hash[GEN_HASH(old_x, old_y)];
+	int new_hash = (x == INVALID_COORD) ? INVALID_COORD : GEN_HASH(x, y);
+	int old_hash = (old_x == INVALID_COORD) ? INVALID_COORD : GEN_HASH(old_x, old_y);
 
 	if (old_hash == new_hash) return;
 
-	/* remove from hash table? */
-	if (old_hash != nullptr) {
-		if (v->hash_viewport_next != nullptr) v->hash_viewport_next->hash_viewport_prev = v->hash_viewport_prev;
-		*v->hash_viewport_prev = v->hash_viewport_next;
-	}
-
-	/* insert into hash table? */
-	if (new_hash != nullptr) {
-		v->hash_viewport_next = *new_hash;
-		if (v->hash_viewport_next != nullptr) v->hash_viewport_next->hash_viewport_prev = &v->hash_viewport_next;
-		v->hash_viewport_prev = new_hash;
-		*new_hash = v;
-	}
+	if (old_hash != INVALID_COORD) RemoveFromVehicleViewportHash(v, old_hash);
+	if (new_hash != INVALID_COORD) AddToVehicleViewportHash(v, new_hash);
 }
 
 struct ViewportHashDeferredItem {
@@ -920,22 +911,8 @@ static void UpdateVehicleViewportHashDeferred(Vehicle *v, int x, int y)
 static void ProcessDeferredUpdateVehicleViewportHashes()
 {
 	for (const ViewportHashDeferredItem &item : _viewport_hash_deferred) {
-		Vehicle *v = item.v;
-
-		/* remove from hash table? */
-		if (item.old_hash != INVALID_COORD) {
-			if (v->hash_viewport_next != nullptr) v->hash_viewport_next->hash_viewport_prev = v->hash_viewport_prev;
-			*v->hash_viewport_prev = v->hash_viewport_next;
-		}
-
-		/* insert into hash table? */
-		if (item.new_hash != INVALID_COORD) {
-			Vehicle **new_hash = &_vehicle_viewport_hash[item.new_hash];
-			v->hash_viewport_next = *new_hash;
-			if (v->hash_viewport_next != nullptr) v->hash_viewport_next->hash_viewport_prev = &v->hash_viewport_next;
-			v->hash_viewport_prev = new_hash;
-			*new_hash = v;
-		}
+		if (item.old_hash != INVALID_COORD) RemoveFromVehicleViewportHash(item.v, item.old_hash);
+		if (item.new_hash != INVALID_COORD) AddToVehicleViewportHash(item.v, item.new_hash);
 	}
 	_viewport_hash_deferred.clear();
 }
@@ -943,7 +920,7 @@ static void ProcessDeferredUpdateVehicleViewportHashes()
 void ResetVehicleHash()
 {
 	for (Vehicle *v : Vehicle::Iterate()) { v->hash_tile_current = nullptr; }
-	memset(_vehicle_viewport_hash, 0, sizeof(_vehicle_viewport_hash));
+	for (std::vector<Vehicle *> &cell : _vehicle_viewport_hash) cell.clear();
 	memset(_vehicle_tile_hash, 0, sizeof(_vehicle_tile_hash));
 }
 
@@ -1099,6 +1076,9 @@ void Vehicle::PreDestructor()
 
 	SCOPE_INFO_FMT([this], "Vehicle::PreDestructor: %s", scope_dumper().VehicleInfo(this));
 
+	OnVehicleProfileVehicleDeleted(this->index);
+	if (this->type == VEH_TRAIN) MarkTrainTemplateDifferenceDirty(this->index);
+
 	if (Station::IsValidID(this->last_station_visited)) {
 		Station *st = Station::Get(this->last_station_visited);
 		st->loading_vehicles.erase(std::remove(st->loading_vehicles.begin(), st->loading_vehicles.end(), this), st->loading_vehicles.end());
@@ -1424,41 +1404,131 @@ void ValidateVehicleTickCaches()
 	assert(saved_tick_other_veh_cache == _tick_other_veh_cache);
 }
 
-void VehicleTickCargoAging(Vehicle *v)
+/**
+ * Advance the cargo aging counter of a vehicle part, and age its cargo when the period elapses.
+ * The counter always runs so that its phase is unaffected by whether the part is loaded,
+ * but the cargo list is only walked when there is anything in it.
+ * @param v Vehicle part to update.
+ */
+static inline void VehicleTickCargoAging(Vehicle *v)
 {
 	if (v->vcache.cached_cargo_age_period != 0) {
 		v->cargo_age_counter = std::min(v->cargo_age_counter, v->vcache.cached_cargo_age_period);
 		if (--v->cargo_age_counter == 0) {
-			v->cargo.AgeCargo();
+			if (v->cargo.TotalCount() != 0) v->cargo.AgeCargo();
 			v->cargo_age_counter = v->vcache.cached_cargo_age_period;
 		}
 	}
 }
 
-void VehicleTickMotion(Vehicle *v, Vehicle *front)
+/**
+ * Update the motion counter of a vehicle and play the running sounds.
+ * @param v Vehicle to update.
+ * @param front_speed Current speed of the front vehicle.
+ * @param front_vehstatus Vehicle status of the front vehicle.
+ * @param play_sound Functor called with each vehicle sound event to play.
+ */
+template <typename F>
+static inline void VehicleTickMotionImpl(Vehicle *v, uint16 front_speed, byte front_vehstatus, F play_sound)
 {
 	/* Do not play any sound when crashed */
-	if (front->vehstatus & VS_CRASHED) return;
+	if (front_vehstatus & VS_CRASHED) return;
 
 	/* Do not play any sound when in depot or tunnel */
 	if (v->vehstatus & VS_HIDDEN) return;
 
-	v->motion_counter += front->cur_speed;
+	v->motion_counter += front_speed;
 	if (_settings_client.sound.vehicle && _settings_client.music.effect_vol != 0) {
 		/* Play a running sound if the motion counter passes 256 (Do we not skip sounds?) */
-		if (GB(v->motion_counter, 0, 8) < front->cur_speed) PlayVehicleSound(v, VSE_RUNNING);
+		if (GB(v->motion_counter, 0, 8) < front_speed) play_sound(v, VSE_RUNNING);
 
 		/* Play an alternating running sound every 16 ticks */
 		if (GB(v->tick_counter, 0, 4) == 0) {
 			/* Play running sound when speed > 0 and not braking */
-			bool running = (front->cur_speed > 0) && !(front->vehstatus & (VS_STOPPED | VS_TRAIN_SLOWING));
-			PlayVehicleSound(v, running ? VSE_RUNNING_16 : VSE_STOPPED_16);
+			bool running = (front_speed > 0) && !(front_vehstatus & (VS_STOPPED | VS_TRAIN_SLOWING));
+			play_sound(v, running ? VSE_RUNNING_16 : VSE_STOPPED_16);
 		}
 	}
 }
 
+void VehicleTickMotion(Vehicle *v, Vehicle *front)
+{
+	VehicleTickMotionImpl(v, front->cur_speed, front->vehstatus, [](Vehicle *u, VehicleSoundEvent event) {
+		PlayVehicleSound(u, event);
+	});
+}
+
+/** Train for which the per-vehicle part of the tick is deferred until after all trains have run their controller. */
+struct TrainPostTickItem {
+	Train *front;          ///< Front vehicle of the train
+	uint16 cur_speed;      ///< Speed of the front vehicle at the end of its tick
+	byte vehstatus;        ///< Vehicle status of the front vehicle at the end of its tick
+};
+
+/** Deferred vehicle sound event. */
+struct VehicleSoundEventRecord {
+	Vehicle *v;
+	VehicleSoundEvent event;
+};
+
+static std::vector<TrainPostTickItem> _train_post_tick_items;
+static std::vector<std::vector<VehicleSoundEventRecord>> _train_post_tick_sounds;
+
+/**
+ * Per-vehicle part of the train tick, which only modifies the vehicles of the train itself.
+ * The state of the front vehicle is that which was recorded at the end of its controller tick.
+ * @param item Train to process.
+ * @param play_sound Functor called with each vehicle sound event to play.
+ */
+template <typename F>
+static inline void TrainPostTick(const TrainPostTickItem &item, F play_sound)
+{
+	for (Train *u = item.front; u != nullptr; u = u->Next()) {
+		u->tick_counter++;
+		VehicleTickCargoAging(u);
+		if (!u->IsWagon() && !((item.vehstatus & VS_STOPPED) && item.cur_speed == 0)) VehicleTickMotionImpl(u, item.cur_speed, item.vehstatus, play_sound);
+	}
+}
+
+/**
+ * Run the deferred per-vehicle part of the train ticks on the worker pool.
+ * Sound events are collected per batch and played afterwards in train tick order.
+ */
+static void RunParallelTrainPostTick()
+{
+	static const size_t BATCH_SIZE = 64;
+
+	const size_t count = _train_post_tick_items.size();
+	const size_t batches = CeilDivT<size_t>(count, BATCH_SIZE);
+	if (_train_post_tick_sounds.size() < batches) _train_post_tick_sounds.resize(batches);
+
+	WorkerTaskGroup group;
+	for (size_t batch = 0; batch < batches; batch++) {
+		group.Run([batch, count]() {
+			std::vector<VehicleSoundEventRecord> &sounds = _train_post_tick_sounds[batch];
+			const size_t end = std::min(count, (batch + 1) * BATCH_SIZE);
+			for (size_t i = batch * BATCH_SIZE; i < end; i++) {
+				TrainPostTick(_train_post_tick_items[i], [&](Vehicle *u, VehicleSoundEvent event) {
+					sounds.push_back({ u, event });
+				});
+			}
+		});
+	}
+	group.Wait();
+
+	for (size_t batch = 0; batch < batches; batch++) {
+		for (const VehicleSoundEventRecord &record : _train_post_tick_sounds[batch]) {
+			PlayVehicleSound(record.v, record.event);
+		}
+		_train_post_tick_sounds[batch].clear();
+	}
+	_train_post_tick_items.clear();
+}
+
 void CallVehicleTicks()
 {
+	TRACE_SCOPE("CallVehicleTicks");
+
 	_vehicles_to_autoreplace.clear();
 	_vehicles_to_templatereplace.clear();
 	_vehicles_to_pay_repair.clear();
@@ -1500,16 +1570,17 @@ void CallVehicleTicks()
 
 	{
 		PerformanceMeasurer framerate(PFE_GL_ECONOMY);
-		Station *si_st = nullptr;
-		SCOPE_INFO_FMT([&si_st], "CallVehicleTicks: LoadUnloadStation: %s", scope_dumper().StationInfo(si_st));
-		for (Station *st : Station::Iterate()) {
-			si_st = st;
-			LoadUnloadStation(st);
-		}
+		LoadUnloadStations();
 	}
 
 	if (!_tick_caches_valid || HasChickenBit(DCBF_VEH_TICK_CACHE)) RebuildVehicleTickCaches();
 
+	OnVehicleProfileTick();
+	/* The time does not change while the vehicles are ticked, so conditional orders evaluated repeatedly and identical link refresher runs can be cached. */
+	/* The time does not change while the vehicles are ticked, so conditional orders evaluated repeatedly can be cached. */
+	SetConditionalOrderCacheActive(true);
+	LinkRefresher::SetRunCacheActive(true);
+
 	Vehicle *v = nullptr;
 	SCOPE_INFO_FMT([&v], "CallVehicleTicks: %s", scope_dumper().VehicleInfo(v));
 	{
@@ -1536,13 +1607,24 @@ void CallVehicleTicks()
 			}
 		}
 		_tick_train_too_heavy_cache.clear();
-		for (Train *front : _tick_train_front_cache) {
-			v = front;
-			if (!front->Train::Tick()) continue;
-			for (Train *u = front; u != nullptr; u = u->Next()) {
-				u->tick_counter++;
-				VehicleTickCargoAging(u);
-				if (!u->IsWagon() && !((front->vehstatus & VS_STOPPED) && front->cur_speed == 0)) VehicleTickMotion(u, front);
+		if (_settings_client.perf.parallel_train_post_tick && _general_worker_pool.GetWorkerCount() > 0) {
+			/* The per-vehicle part of the tick does not affect any other train, defer it and run it in parallel */
+			for (Train *front : _tick_train_front_cache) {
+				v = front;
+				VehicleProfileScope profile(front, VPC_TICK);
+				if (!front->Train::Tick()) continue;
+				_train_post_tick_items.push_back({ front, front->cur_speed, front->vehstatus });
+			}
+			v = nullptr;
+			RunParallelTrainPostTick();
+		} else {
+			for (Train *front : _tick_train_front_cache) {
+				v = front;
+				VehicleProfileScope profile(front, VPC_TICK);
+				if (!front->Train::Tick()) continue;
+				TrainPostTick({ front, front->cur_speed, front->vehstatus }, [](Vehicle *u, VehicleSoundEvent event) {
+					PlayVehicleSound(u, event);
+				});
 			}
 		}
 	}
@@ -1550,6 +1632,7 @@ void CallVehicleTicks()
 		PerformanceMeasurer framerate(PFE_GL_ROADVEHS);
 		for (RoadVehicle *front : _tick_road_veh_front_cache) {
 			v = front;
+			VehicleProfileScope profile(front, VPC_TICK);
 			if (!front->RoadVehicle::Tick()) continue;
 			for (RoadVehicle *u = front; u != nullptr; u = u->Next()) {
 				u->tick_counter++;
@@ -1562,6 +1645,7 @@ void CallVehicleTicks()
 		PerformanceMeasurer framerate(PFE_GL_AIRCRAFT);
 		for (Aircraft *front : _tick_aircraft_front_cache) {
 			v = front;
+			VehicleProfileScope profile(front, VPC_TICK);
 			if (!front->Aircraft::Tick()) continue;
 			for (Aircraft *u = front; u != nullptr; u = u->Next()) {
 				VehicleTickCargoAging(u);
@@ -1573,6 +1657,7 @@ void CallVehicleTicks()
 		PerformanceMeasurer framerate(PFE_GL_SHIPS);
 		for (Ship *s : _tick_ship_cache) {
 			v = s;
+			VehicleProfileScope profile(s, VPC_TICK);
 			if (!s->Ship::Tick()) continue;
 			for (Ship *u = s; u != nullptr; u = u->Next()) {
 				VehicleTickCargoAging(u);
@@ -1589,6 +1674,9 @@ void CallVehicleTicks()
 	}
 	v = nullptr;
 
+	SetConditionalOrderCacheActive(false);
+	LinkRefresher::SetRunCacheActive(false);
+
 	/* Handle vehicles marked for immediate sale */
 	Backup<CompanyID> sell_cur_company(_current_company, FILE_LINE);
 	for (VehicleID index : _vehicles_to_sell) {
@@ -1852,9 +1940,7 @@ void ViewportAddVehiclesIntl(DrawPixelInfo *dpi)
 
 	for (int y = vhb.yl;; y = (y + (1 << 6)) & (0x3F << 6)) {
 		for (int x = vhb.xl;; x = (x + 1) & 0x3F) {
-			const Vehicle *v = _vehicle_viewport_hash[x + y]; // already masked & 0xFFF
-
-			while (v != nullptr) {
+			for (const Vehicle *v : _vehicle_viewport_hash[x + y]) { // already masked & 0xFFF
 				if (v->IsDrawn()) {
 					if (update_vehicles &&
 							HasBit(v->vcache.cached_veh_flags, VCF_IMAGE_REFRESH) &&
@@ -1881,7 +1967,6 @@ void ViewportAddVehiclesIntl(DrawPixelInfo *dpi)
 						DoDrawVehicle(v);
 					}
 				}
-				v = v->hash_viewport_next;
 			}
 
 			if (x == vhb.xu) break;
@@ -1924,9 +2009,7 @@ void ViewportMapDrawVehicles(DrawPixelInfo *dpi, Viewport *vp)
 			for (int x = vhb.xl;; x = (x + 1) & 0x3F) {
 				if (!HasBit(vp->map_draw_vehicles_cache.done_hash_bits[y >> 6], x)) {
 					SetBit(vp->map_draw_vehicles_cache.done_hash_bits[y >> 6], x);
-					const Vehicle *v = _vehicle_viewport_hash[x + y]; // already masked & 0xFFF
-
-					while (v != nullptr) {
+					for (const Vehicle *v : _vehicle_viewport_hash[x + y]) { // already masked & 0xFFF
 						if (!(v->vehstatus & (VS_HIDDEN | VS_UNCLICKABLE)) && (v->type != VEH_EFFECT)) {
 							Point pt = RemapCoords(v->x_pos, v->y_pos, v->z_pos);
 							if (pt.x >= l && pt.x < r && pt.y >= t && pt.y < b) {
@@ -1935,7 +2018,6 @@ void ViewportMapDrawVehicles(DrawPixelInfo *dpi, Viewport *vp)
 								vp->map_draw_vehicles_cache.vehicle_pixels[pixel_x + (pixel_y) * vp->width] = true;
 							}
 						}
-						v = v->hash_viewport_next;
 					}
 				}
 
@@ -4322,10 +4404,10 @@ void VehiclesYearlyLoop()
 			v->profit_last_year = v->profit_this_year;
 			v->profit_lifetime += v->profit_this_year;
 			v->profit_this_year = 0;
-			SetWindowDirty(WC_VEHICLE_DETAILS, v->index);
 		}
 	}
 	GroupStatistics::UpdateProfits();
+	SetWindowClassesDirty(WC_VEHICLE_DETAILS);
 	SetWindowClassesDirty(WC_TRAINS_LIST);
 	SetWindowClassesDirty(WC_TRACE_RESTRICT_SLOTS);
 	SetWindowClassesDirty(WC_SHIPS_LIST);
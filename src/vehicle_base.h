@@ -74,6 +74,7 @@ enum NewGRFCacheValidValues {
 	NCVV_COMPANY_INFORMATION       = 3, ///< This bit will be set if the NewGRF var 43 currently stored is valid.
 	NCVV_POSITION_IN_VEHICLE       = 4, ///< This bit will be set if the NewGRF var 4D currently stored is valid.
 	NCVV_CONSIST_CARGO_INFORMATION_UD = 5, ///< This bit will be set if the uppermost byte of NewGRF var 42 currently stored is valid.
+	NCVV_ENGINE_ID_COUNT           = 6, ///< This bit will be set if the NewGRF var 60 currently stored is valid, for the stored parameter.
 	NCVV_END,                           ///< End of the bits.
 };
 
@@ -85,6 +86,8 @@ struct NewGRFCache {
 	uint32 consist_cargo_information; ///< Cache for NewGRF var 42. (Note: The cargotype is untranslated in the cache because the accessing GRF is yet unknown.)
 	uint32 company_information;       ///< Cache for NewGRF var 43.
 	uint32 position_in_vehicle;       ///< Cache for NewGRF var 4D.
+	uint32 engine_id_count_parameter; ///< Parameter of the NewGRF var 60 stored in engine_id_count.
+	uint32 engine_id_count;           ///< Cache for NewGRF var 60, for the last queried parameter.
 	uint8  cache_valid;               ///< Bitset that indicates which cache values are valid.
 };
 
@@ -292,41 +295,22 @@ public:
 	 */
 	TileIndex dest_tile;
 
-	Money profit_this_year;             ///< Profit this year << 8, low 8 bits are fract
-	Money profit_last_year;             ///< Profit last year << 8, low 8 bits are fract
-	Money profit_lifetime;              ///< Profit lifetime << 8, low 8 bits are fract
-	Money value;                        ///< Value of the vehicle
-
-	CargoPayment *cargo_payment;        ///< The cargo payment we're currently in
-
-	/* Used for timetabling. */
-	uint32 current_loading_time;        ///< How long loading took. Less than current_order_time if vehicle is early.
-
 	Rect coord;                         ///< NOSAVE: Graphical bounding box of the vehicle, i.e. what to redraw on moves.
 
-	Vehicle *hash_viewport_next;        ///< NOSAVE: Next vehicle in the visual location hash.
-	Vehicle **hash_viewport_prev;       ///< NOSAVE: Previous vehicle in the visual location hash.
+	uint32 hash_viewport_index;         ///< NOSAVE: Index of the vehicle in its cell of the visual location hash.
+	SpriteID colourmap;                 ///< NOSAVE: cached colour mapping
 
 	Vehicle *hash_tile_next;            ///< NOSAVE: Next vehicle in the tile location hash.
 	Vehicle **hash_tile_prev;           ///< NOSAVE: Previous vehicle in the tile location hash.
 	Vehicle **hash_tile_current;        ///< NOSAVE: Cache of the current hash chain.
 
-	byte breakdown_severity;            ///< severity of the breakdown. Note that lower means more severe
-	byte breakdown_type;                ///< Type of breakdown
-	byte breakdown_chance_factor;       ///< Improved breakdowns: current multiplier for breakdown_chance * 128, used for head vehicle only
-	SpriteID colourmap;                 ///< NOSAVE: cached colour mapping
-
-	/* Related to age and service time */
-	Year build_year;                    ///< Year the vehicle has been built.
-	Date age;                           ///< Age in days
-	Date max_age;                       ///< Maximum age
-	Date date_of_last_service;          ///< Last date the vehicle had a service at a depot.
-	uint16 reliability;                 ///< Reliability.
-	uint16 reliability_spd_dec;         ///< Reliability decrease speed.
 	byte breakdown_ctr;                 ///< Counter for managing breakdown events. @see Vehicle::HandleBreakdown
 	byte breakdown_delay;               ///< Counter for managing breakdown length.
 	byte breakdowns_since_last_service; ///< Counter for the amount of breakdowns.
 	byte breakdown_chance;              ///< Current chance of breakdowns.
+	byte breakdown_severity;            ///< severity of the breakdown. Note that lower means more severe
+	byte breakdown_type;                ///< Type of breakdown
+	byte breakdown_chance_factor;       ///< Improved breakdowns: current multiplier for breakdown_chance * 128, used for head vehicle only
 
 	int32 x_pos;                        ///< x coordinate.
 	int32 y_pos;                        ///< y coordinate.
@@ -397,6 +381,26 @@ public:
 	NewGRFCache grf_cache;              ///< Cache of often used calculated NewGRF values
 	VehicleCache vcache;                ///< Cache of often used vehicle values.
 
+	/* Fields below here are not used every tick, keep them apart from the per-tick fields above to reduce cache misses in the tick loops. */
+
+	Money profit_this_year;             ///< Profit this year << 8, low 8 bits are fract
+	Money profit_last_year;             ///< Profit last year << 8, low 8 bits are fract
+	Money profit_lifetime;              ///< Profit lifetime << 8, low 8 bits are fract
+	Money value;                        ///< Value of the vehicle
+
+	CargoPayment *cargo_payment;        ///< The cargo payment we're currently in
+
+	/* Used for timetabling. */
+	uint32 current_loading_time;        ///< How long loading took. Less than current_order_time if vehicle is early.
+
+	/* Related to age and service time */
+	Year build_year;                    ///< Year the vehicle has been built.
+	Date age;                           ///< Age in days
+	Date max_age;                       ///< Maximum age
+	Date date_of_last_service;          ///< Last date the vehicle had a service at a depot.
+	uint16 reliability;                 ///< Reliability.
+	uint16 reliability_spd_dec;         ///< Reliability decrease speed.
+
 	/**
 	 * Calculates the weight value that this vehicle will have when fully loaded with its current cargo.
 	 * @return Weight value in tonnes.
@@ -1526,6 +1530,52 @@ struct FreeUnitIDGenerator {
 /** Sentinel for an invalid coordinate. */
 static const int32 INVALID_COORD = 0x7fffffff;
 
+Vehicle *GetVehicleTileHashChain(TileIndex tile, VehicleType type);
+
+/**
+ * Checks whether a vehicle of the given type which satisfies \a predicate is on a specific location.
+ * This is equivalent to #HasVehicleOnPos, but the predicate is inlined and is only evaluated for
+ * vehicles actually on \a tile, instead of being called indirectly through a #VehicleFromPosProc.
+ * @param tile The location on the map
+ * @param type The vehicle type to look for, this must be less than VEH_COMPANY_END.
+ * @param predicate Callable taking a const Vehicle pointer and returning true if the vehicle should be "found".
+ * @return True if \a predicate returned true for any vehicle on the tile.
+ */
+template <typename F>
+bool HasVehicleOnTile(TileIndex tile, VehicleType type, F predicate)
+{
+	for (const Vehicle *v = GetVehicleTileHashChain(tile, type); v != nullptr; v = v->hash_tile_next) {
+		if (v->tile == tile && predicate(v)) return true;
+	}
+	return false;
+}
+
+/**
+ * Calls \a func for each vehicle of the given type on a specific location.
+ * This is equivalent to #FindVehicleOnPos, but \a func is inlined instead of being called indirectly through a #VehicleFromPosProc.
+ * @param tile The location on the map
+ * @param type The vehicle type to look for, this must be less than VEH_COMPANY_END.
+ * @param func Callable taking a Vehicle pointer.
+ */
+template <typename F>
+void IterateVehiclesOnTile(TileIndex tile, VehicleType type, F func)
+{
+	for (Vehicle *v = GetVehicleTileHashChain(tile, type); v != nullptr; v = v->hash_tile_next) {
+		if (v->tile == tile) func(v);
+	}
+}
+
+/**
+ * Checks whether any vehicle of the given type is on a specific location.
+ * @param tile The location on the map
+ * @param type The vehicle type to look for, this must be less than VEH_COMPANY_END.
+ * @return True if there is a vehicle of \a type on the tile.
+ */
+inline bool HasVehicleOnTile(TileIndex tile, VehicleType type)
+{
+	return HasVehicleOnTile(tile, type, [](const Vehicle *) { return true; });
+}
+
 inline void InvalidateVehicleTickCaches()
 {
 	extern bool _tick_caches_valid;
@@ -45,6 +45,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <unordered_map>
 
 #include "safeguards.h"
 
@@ -444,17 +445,36 @@ DropDownList BaseVehicleListWindow::BuildActionDropdownList(bool show_autoreplac
 	return list;
 }
 
-/* cached values for VehicleNameSorter to spare many GetString() calls */
-static const Vehicle *_last_vehicle[2] = { nullptr, nullptr };
+/* cached sort keys, so that they are computed once per vehicle instead of once per comparison */
+static std::unordered_map<VehicleID, std::string> _vehicle_sort_names;
+static std::unordered_map<VehicleID, CargoArray> _vehicle_sort_capacities;
+static std::unordered_map<VehicleID, Money> _vehicle_sort_values;
 
 static btree::btree_map<VehicleID, int> _vehicle_max_speed_loaded;
 
+/**
+ * Get the sort key of a vehicle, computing it on first use in this sort.
+ * @param cache Cache of the sort keys.
+ * @param v The vehicle.
+ * @param calc Function computing the sort key of a vehicle.
+ * @return The sort key, the reference stays valid until the cache is cleared.
+ */
+template <typename T, typename F>
+static const T &GetVehicleSortKey(std::unordered_map<VehicleID, T> &cache, const Vehicle *v, F calc)
+{
+	auto res = cache.try_emplace(v->index);
+	if (res.second) res.first->second = calc(v);
+	return res.first->second;
+}
+
 void BaseVehicleListWindow::SortVehicleList()
 {
-	if (this->vehgroups.Sort()) return;
+	this->vehgroups.Sort();
 
-	/* invalidate cached values for name sorter - vehicle names could change */
-	_last_vehicle[0] = _last_vehicle[1] = nullptr;
+	/* invalidate cached sort keys - vehicle names, cargo and values could change */
+	_vehicle_sort_names.clear();
+	_vehicle_sort_capacities.clear();
+	_vehicle_sort_values.clear();
 	_vehicle_max_speed_loaded.clear();
 }
 
@@ -1545,21 +1565,14 @@ static bool VehicleNumberSorter(const Vehicle * const &a, const Vehicle * const
 /** Sort vehicles by their name */
 static bool VehicleNameSorter(const Vehicle * const &a, const Vehicle * const &b)
 {
-	static char last_name[2][64];
-
-	if (a != _last_vehicle[0]) {
-		_last_vehicle[0] = a;
-		SetDParam(0, a->index);
-		GetString(last_name[0], STR_VEHICLE_NAME, lastof(last_name[0]));
-	}
-
-	if (b != _last_vehicle[1]) {
-		_last_vehicle[1] = b;
-		SetDParam(0, b->index);
-		GetString(last_name[1], STR_VEHICLE_NAME, lastof(last_name[1]));
-	}
+	auto get_name = [](const Vehicle *v) -> std::string {
+		char buf[64];
+		SetDParam(0, v->index);
+		GetString(buf, STR_VEHICLE_NAME, lastof(buf));
+		return buf;
+	};
 
-	int r = strnatcmp(last_name[0], last_name[1]); // Sort by name (natural sorting).
+	int r = strnatcmp(GetVehicleSortKey(_vehicle_sort_names, a, get_name).c_str(), GetVehicleSortKey(_vehicle_sort_names, b, get_name).c_str()); // Sort by name (natural sorting).
 	return (r != 0) ? r < 0: VehicleNumberSorter(a, b);
 }
 
@@ -1594,16 +1607,19 @@ static bool VehicleProfitLifetimeSorter(const Vehicle * const &a, const Vehicle
 /** Sort vehicles by their cargo */
 static bool VehicleCargoSorter(const Vehicle * const &a, const Vehicle * const &b)
 {
-	const Vehicle *v;
-	CargoArray diff;
+	auto get_capacities = [](const Vehicle *v) -> CargoArray {
+		CargoArray capacities;
+		/* Append the cargo of the connected waggons */
+		for (const Vehicle *u = v; u != nullptr; u = u->Next()) capacities[u->cargo_type] += u->cargo_cap;
+		return capacities;
+	};
 
-	/* Append the cargo of the connected waggons */
-	for (v = a; v != nullptr; v = v->Next()) diff[v->cargo_type] += v->cargo_cap;
-	for (v = b; v != nullptr; v = v->Next()) diff[v->cargo_type] -= v->cargo_cap;
+	const CargoArray &cap_a = GetVehicleSortKey(_vehicle_sort_capacities, a, get_capacities);
+	const CargoArray &cap_b = GetVehicleSortKey(_vehicle_sort_capacities, b, get_capacities);
 
 	int r = 0;
 	for (CargoID i = 0; i < NUM_CARGO; i++) {
-		r = diff[i];
+		r = cap_a[i] - cap_b[i];
 		if (r != 0) break;
 	}
 
@@ -1634,13 +1650,13 @@ static bool VehicleModelSorter(const Vehicle * const &a, const Vehicle * const &
 /** Sort vehicles by their value */
 static bool VehicleValueSorter(const Vehicle * const &a, const Vehicle * const &b)
 {
-	const Vehicle *u;
-	Money diff = 0;
-
-	for (u = a; u != nullptr; u = u->Next()) diff += u->value;
-	for (u = b; u != nullptr; u = u->Next()) diff -= u->value;
+	auto get_value = [](const Vehicle *v) -> Money {
+		Money value = 0;
+		for (const Vehicle *u = v; u != nullptr; u = u->Next()) value += u->value;
+		return value;
+	};
 
-	int r = ClampToI32(diff);
+	int r = ClampToI32(GetVehicleSortKey(_vehicle_sort_values, a, get_value) - GetVehicleSortKey(_vehicle_sort_values, b, get_value));
 	return (r != 0) ? r < 0 : VehicleNumberSorter(a, b);
 }
 
@@ -0,0 +1,147 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file vehicle_profile.cpp Implementation of the attribution of vehicle processing time. */
+
+#include "stdafx.h"
+#include "vehicle_profile.h"
+#include "vehicle_base.h"
+#include "thread.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "safeguards.h"
+
+bool _vehicle_profile_enabled = false;
+
+/** Time charged to a vehicle slot. */
+struct VehicleProfileEntry {
+	VehicleProfileCost cost;        ///< The cost.
+	Owner owner = INVALID_OWNER;    ///< Owner at the time the cost was last charged, INVALID_OWNER if unused.
+	VehicleType type = VEH_INVALID; ///< Type of the vehicle.
+};
+
+static std::vector<VehicleProfileEntry> _vehicle_profile_entries;   ///< Cost per vehicle, indexed by vehicle ID.
+static VehicleProfileCost _vehicle_profile_companies[OWNER_END];    ///< Cost per owner.
+static VehicleProfileScope *_vehicle_profile_current = nullptr;     ///< Innermost active scope.
+static uint _vehicle_profile_ticks = 0;                             ///< Number of vehicle ticks since profiling started.
+
+/**
+ * Get the current time for profiling.
+ * @return Monotonic time in nanoseconds.
+ */
+static uint64 GetVehicleProfileTimestamp()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void VehicleProfileScope::Begin(const Vehicle *v)
+{
+	if (IsNonGameThread()) return;
+
+	const Vehicle *front = v->First();
+	this->active = true;
+	this->id = front->index;
+	this->owner = front->owner < OWNER_END ? front->owner : OWNER_NONE;
+	this->type = front->type;
+	this->parent = _vehicle_profile_current;
+	_vehicle_profile_current = this;
+	this->start = GetVehicleProfileTimestamp();
+}
+
+void VehicleProfileScope::End()
+{
+	const uint64 elapsed = GetVehicleProfileTimestamp() - this->start;
+	_vehicle_profile_current = this->parent;
+	if (this->parent != nullptr) this->parent->nested += elapsed;
+
+	/* Profiling may have been stopped while this scope was active. */
+	if (!_vehicle_profile_enabled) return;
+
+	const uint64 own = elapsed > this->nested ? elapsed - this->nested : 0;
+	if (this->id >= _vehicle_profile_entries.size()) _vehicle_profile_entries.resize(this->id + 1);
+	VehicleProfileEntry &entry = _vehicle_profile_entries[this->id];
+	entry.cost.time[this->category] += own;
+	entry.owner = this->owner;
+	entry.type = this->type;
+	_vehicle_profile_companies[this->owner].time[this->category] += own;
+	if (this->parent == nullptr) {
+		entry.cost.calls++;
+		_vehicle_profile_companies[this->owner].calls++;
+	}
+}
+
+/** Start profiling, discarding the results of any previous run. */
+void StartVehicleProfile()
+{
+	_vehicle_profile_entries.clear();
+	for (VehicleProfileCost &cost : _vehicle_profile_companies) cost = {};
+	_vehicle_profile_ticks = 0;
+	_vehicle_profile_enabled = true;
+}
+
+/** Stop profiling, the results are kept until the next #StartVehicleProfile. */
+void StopVehicleProfile()
+{
+	_vehicle_profile_enabled = false;
+}
+
+/** Count a vehicle tick while profiling, so that costs can be reported per tick. */
+void OnVehicleProfileTick()
+{
+	if (_vehicle_profile_enabled) _vehicle_profile_ticks++;
+}
+
+/**
+ * Forget the cost of a deleted vehicle, so that it is not reported for a new vehicle re-using the ID.
+ * The cost remains included in the cost of the owner.
+ * @param id The vehicle.
+ */
+void OnVehicleProfileVehicleDeleted(VehicleID id)
+{
+	if (id < _vehicle_profile_entries.size()) _vehicle_profile_entries[id] = {};
+}
+
+/**
+ * Get the number of vehicle ticks profiled in the current or last run.
+ * @return The number of ticks.
+ */
+uint GetVehicleProfileTicks()
+{
+	return _vehicle_profile_ticks;
+}
+
+/**
+ * Get the most expensive vehicles and companies of the current or last run.
+ * @param count Maximum number of vehicles to return.
+ * @param[out] vehicles The most expensive vehicles, most expensive first.
+ * @param[out] companies All companies with a non-zero cost, most expensive first.
+ */
+void GetVehicleProfileTop(uint count, std::vector<VehicleProfileVehicleResult> &vehicles, std::vector<VehicleProfileCompanyResult> &companies)
+{
+	vehicles.clear();
+	for (VehicleID id = 0; id < _vehicle_profile_entries.size(); id++) {
+		const VehicleProfileEntry &entry = _vehicle_profile_entries[id];
+		if (entry.owner == INVALID_OWNER) continue;
+		vehicles.push_back({ id, entry.owner, entry.type, entry.cost });
+	}
+	auto cmp = [](const auto &a, const auto &b) { return a.cost.Total() > b.cost.Total(); };
+	if (vehicles.size() > count) {
+		std::partial_sort(vehicles.begin(), vehicles.begin() + count, vehicles.end(), cmp);
+		vehicles.resize(count);
+	} else {
+		std::sort(vehicles.begin(), vehicles.end(), cmp);
+	}
+
+	companies.clear();
+	for (Owner o = OWNER_BEGIN; o < OWNER_END; o++) {
+		if (_vehicle_profile_companies[o].Total() == 0) continue;
+		companies.push_back({ o, _vehicle_profile_companies[o] });
+	}
+	std::sort(companies.begin(), companies.end(), cmp);
+}
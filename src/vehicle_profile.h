@@ -0,0 +1,107 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file vehicle_profile.h
+ * Attribution of the game loop time spent on vehicles to individual vehicles and their owners.
+ *
+ * Place a #VehicleProfileScope at the start of a block to charge the time spent in it to a vehicle.
+ * Scopes may be nested, the time of a nested scope is only charged to the category of the innermost scope.
+ * Profiling is off by default and controlled by the \c vehicle_profile console command.
+ */
+
+#ifndef VEHICLE_PROFILE_H
+#define VEHICLE_PROFILE_H
+
+#include "vehicle_type.h"
+#include "company_type.h"
+
+#include <vector>
+
+/** Categories of time charged to a vehicle. */
+enum VehicleProfileCategory {
+	VPC_TICK,          ///< Vehicle tick, excluding the categories below.
+	VPC_PATHFINDING,   ///< Pathfinder calls.
+	VPC_NEWGRF,        ///< NewGRF callbacks and sprite resolution.
+	VPC_END,
+};
+
+/** Time charged to a single vehicle or company. */
+struct VehicleProfileCost {
+	uint64 time[VPC_END] = {}; ///< Time per category, in nanoseconds.
+	uint64 calls = 0;          ///< Number of outermost scopes charged.
+
+	/** Get the total time of all categories, in nanoseconds. */
+	uint64 Total() const
+	{
+		uint64 total = 0;
+		for (uint64 t : this->time) total += t;
+		return total;
+	}
+};
+
+/** Cost of a vehicle, as returned by #GetVehicleProfileTop. */
+struct VehicleProfileVehicleResult {
+	VehicleID id;            ///< ID of the front vehicle.
+	Owner owner;             ///< Owner at the time the cost was last charged.
+	VehicleType type;        ///< Type of the vehicle.
+	VehicleProfileCost cost; ///< The cost.
+};
+
+/** Cost of a company, as returned by #GetVehicleProfileTop. */
+struct VehicleProfileCompanyResult {
+	Owner owner;             ///< The company.
+	VehicleProfileCost cost; ///< The cost of all vehicles of the company, including since deleted vehicles.
+};
+
+extern bool _vehicle_profile_enabled;
+
+/**
+ * RAII class charging the time spent in its scope to a vehicle.
+ * Only the game thread is profiled, scopes on other threads (e.g. drawing) are ignored.
+ * The vehicle is only accessed when the scope starts, so it may be deleted within the scope.
+ */
+class VehicleProfileScope {
+	bool active;                     ///< Whether this scope is profiled.
+	VehicleProfileCategory category; ///< Category to charge.
+	VehicleID id;                    ///< Front vehicle to charge.
+	Owner owner;                     ///< Owner of the vehicle.
+	VehicleType type;                ///< Type of the vehicle.
+	uint64 start;                    ///< Start time, in nanoseconds.
+	uint64 nested = 0;               ///< Time spent in nested scopes, in nanoseconds.
+	VehicleProfileScope *parent;     ///< Enclosing scope.
+
+	void Begin(const Vehicle *v);
+	void End();
+
+public:
+	/**
+	 * Start charging time to a vehicle.
+	 * @param v The vehicle, the time is charged to its front vehicle. May be nullptr.
+	 * @param category The category to charge.
+	 */
+	VehicleProfileScope(const Vehicle *v, VehicleProfileCategory category) : active(false), category(category)
+	{
+		if (_vehicle_profile_enabled && v != nullptr) this->Begin(v);
+	}
+
+	~VehicleProfileScope()
+	{
+		if (this->active) this->End();
+	}
+
+	VehicleProfileScope(const VehicleProfileScope &) = delete;
+	VehicleProfileScope &operator=(const VehicleProfileScope &) = delete;
+};
+
+void StartVehicleProfile();
+void StopVehicleProfile();
+void OnVehicleProfileTick();
+void OnVehicleProfileVehicleDeleted(VehicleID id);
+uint GetVehicleProfileTicks();
+void GetVehicleProfileTop(uint count, std::vector<VehicleProfileVehicleResult> &vehicles, std::vector<VehicleProfileCompanyResult> &companies);
+
+#endif /* VEHICLE_PROFILE_H */
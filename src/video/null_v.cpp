@@ -13,9 +13,16 @@
 #include "../saveload/saveload.h"
 #include "../window_func.h"
 #include "../thread.h"
+#include "../framerate_type.h"
+#include "../string_func.h"
+#include "../debug.h"
 #include "null_v.h"
 
 #include <atomic>
+#include <chrono>
+#if defined(__linux__)
+#include <unistd.h>
+#endif
 
 #include "../safeguards.h"
 
@@ -35,6 +42,8 @@ const char *VideoDriver_Null::Start(const StringList &parm)
 
 	this->ticks = GetDriverParamInt(parm, "ticks", 1000);
 	this->until_exit = GetDriverParamBool(parm, "until_exit");
+	const char *benchmark = GetDriverParam(parm, "benchmark");
+	this->benchmark_file = benchmark != nullptr ? benchmark : "";
 	_screen.width  = _screen.pitch = _cur_resolution.width;
 	_screen.height = _cur_resolution.height;
 	_screen.dst_ptr = nullptr;
@@ -50,10 +59,67 @@ void VideoDriver_Null::Stop() { }
 
 void VideoDriver_Null::MakeDirty(int left, int top, int width, int height) {}
 
+/**
+ * Get the resident memory of the process, for benchmark reports.
+ * @return The resident memory in bytes, or -1 if it is not known on this platform.
+ */
+static int64 GetResidentMemory()
+{
+#if defined(__linux__)
+	FILE *f = fopen("/proc/self/statm", "r");
+	if (f == nullptr) return -1;
+	unsigned long size, resident;
+	int read = fscanf(f, "%lu %lu", &size, &resident);
+	fclose(f);
+	if (read != 2) return -1;
+	return (int64)resident * sysconf(_SC_PAGESIZE);
+#else
+	return -1;
+#endif
+}
+
+/**
+ * Run the requested number of ticks as fast as possible while recording all performance
+ * measurements, and write a JSON report of them to #benchmark_file.
+ */
+void VideoDriver_Null::RunBenchmark()
+{
+	const int64 memory_loaded = GetResidentMemory();
+
+	StartPerformanceBenchmark();
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < this->ticks && !_exit_game; i++) {
+		::GameLoop();
+		::InputLoop();
+		::UpdateWindows();
+	}
+	const uint64 run_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	std::string elements = StopPerformanceBenchmark();
+
+	const int64 memory_run = GetResidentMemory();
+
+	std::string result = stdstr_fmt("{\n  \"ticks\": %d,\n  \"run_ms\": %.3f,\n  \"ticks_per_second\": %.2f,\n"
+			"  \"resident_memory_after_load\": " OTTD_PRINTF64 ",\n  \"resident_memory_after_run\": " OTTD_PRINTF64 ",\n  \"elements\": %s\n}\n",
+			this->ticks, run_us / 1000.0, run_us > 0 ? this->ticks * 1000000.0 / run_us : 0.0,
+			memory_loaded, memory_run, elements.c_str());
+
+	FILE *f = fopen(this->benchmark_file.c_str(), "wb");
+	if (f == nullptr) {
+		DEBUG(misc, 0, "Cannot open benchmark result file '%s' for writing", this->benchmark_file.c_str());
+		fputs(result.c_str(), stdout);
+		return;
+	}
+	fputs(result.c_str(), f);
+	fclose(f);
+	DEBUG(misc, 0, "Benchmark of %d ticks finished in %.3f s, results written to '%s'", this->ticks, run_us / 1000000.0, this->benchmark_file.c_str());
+}
+
 void VideoDriver_Null::MainLoop()
 {
 	SetSelfAsGameThread();
-	if (this->until_exit) {
+	if (!this->benchmark_file.empty()) {
+		this->RunBenchmark();
+	} else if (this->until_exit) {
 		while (!_exit_game) {
 			::GameLoop();
 			::InputLoop();
@@ -17,6 +17,9 @@ class VideoDriver_Null : public VideoDriver {
 private:
 	int ticks; ///< Amount of ticks to run.
 	bool until_exit;
+	std::string benchmark_file; ///< If not empty, file to write the results of a tick benchmark to.
+
+	void RunBenchmark();
 
 public:
 	const char *Start(const StringList &param) override;
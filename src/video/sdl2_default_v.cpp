@@ -97,6 +97,28 @@ void VideoDriver_SDL_Default::MakePalette()
 	}
 }
 
+void VideoDriver_SDL_Default::MakeDirty(int left, int top, int width, int height)
+{
+	/* Keep the bounding rectangle up to date, it is used if the list below overflows. */
+	VideoDriver_SDL_Base::MakeDirty(left, top, width, height);
+
+	if (this->num_dirty_rects > MAX_DIRTY_RECTS) return;
+
+	Rect r = {left, top, left + width, top + height};
+
+	/* Merge with an overlapping or adjacent rectangle, to keep the list short. */
+	for (int i = 0; i < this->num_dirty_rects; i++) {
+		Rect &existing = this->dirty_rects[i];
+		if (r.left <= existing.right && existing.left <= r.right && r.top <= existing.bottom && existing.top <= r.bottom) {
+			existing = BoundingRect(existing, r);
+			return;
+		}
+	}
+
+	if (this->num_dirty_rects < MAX_DIRTY_RECTS) this->dirty_rects[this->num_dirty_rects] = r;
+	this->num_dirty_rects++;
+}
+
 void VideoDriver_SDL_Default::Paint()
 {
 	PerformanceMeasurer framerate(PFE_VIDEO);
@@ -125,14 +147,27 @@ void VideoDriver_SDL_Default::Paint()
 		this->local_palette.count_dirty = 0;
 	}
 
-	SDL_Rect r = { this->dirty_rect.left, this->dirty_rect.top, this->dirty_rect.right - this->dirty_rect.left, this->dirty_rect.bottom - this->dirty_rect.top };
+	/* Only copy the separate dirty areas, unless there were too many of them. */
+	SDL_Rect rects[MAX_DIRTY_RECTS];
+	int n = 0;
+	if (this->num_dirty_rects > MAX_DIRTY_RECTS) {
+		rects[n++] = { this->dirty_rect.left, this->dirty_rect.top, this->dirty_rect.right - this->dirty_rect.left, this->dirty_rect.bottom - this->dirty_rect.top };
+	} else {
+		for (int i = 0; i < this->num_dirty_rects; i++) {
+			const Rect &dr = this->dirty_rects[i];
+			rects[n++] = { dr.left, dr.top, dr.right - dr.left, dr.bottom - dr.top };
+		}
+	}
 
 	if (_sdl_surface != _sdl_real_surface) {
-		SDL_BlitSurface(_sdl_surface, &r, _sdl_real_surface, &r);
+		for (int i = 0; i < n; i++) {
+			SDL_BlitSurface(_sdl_surface, &rects[i], _sdl_real_surface, &rects[i]);
+		}
 	}
-	SDL_UpdateWindowSurfaceRects(this->sdl_window, &r, 1);
+	if (n > 0) SDL_UpdateWindowSurfaceRects(this->sdl_window, rects, n);
 
 	this->dirty_rect = {};
+	this->num_dirty_rects = 0;
 }
 
 bool VideoDriver_SDL_Default::AllocateBackingStore(int w, int h, bool force)
@@ -165,6 +200,7 @@ bool VideoDriver_SDL_Default::AllocateBackingStore(int w, int h, bool force)
 	 * will mark the whole screen dirty again anyway, but this time with the
 	 * new dimensions. */
 	this->dirty_rect = {};
+	this->num_dirty_rects = 0;
 
 	_screen.width = _sdl_surface->w;
 	_screen.height = _sdl_surface->h;
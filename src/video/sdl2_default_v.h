@@ -17,6 +17,8 @@ class VideoDriver_SDL_Default : public VideoDriver_SDL_Base {
 public:
 	const char *GetName() const override { return "sdl"; }
 
+	void MakeDirty(int left, int top, int width, int height) override;
+
 protected:
 	bool AllocateBackingStore(int w, int h, bool force = false) override;
 	void *GetVideoPointer() override;
@@ -25,6 +27,11 @@ protected:
 	void ReleaseVideoPointer() override {}
 
 private:
+	static const int MAX_DIRTY_RECTS = 100;
+
+	Rect dirty_rects[MAX_DIRTY_RECTS]; ///< Disjoint-ish dirty areas of the video buffer, only valid if num_dirty_rects <= MAX_DIRTY_RECTS.
+	int num_dirty_rects = 0;           ///< Number of entries in dirty_rects, greater than MAX_DIRTY_RECTS if the list overflowed.
+
 	void UpdatePalette();
 	void MakePalette();
 };
@@ -328,6 +328,11 @@ protected:
 
 	std::chrono::steady_clock::duration GetDrawInterval()
 	{
+		/* While fast-forwarding, optionally draw less often to leave more time for game ticks */
+		if (_settings_client.gui.fast_forward_refresh_rate != 0 && !_pause_mode && (_game_speed == 0 || _game_speed > 100) &&
+				_settings_client.gui.fast_forward_refresh_rate < _settings_client.gui.refresh_rate) {
+			return std::chrono::microseconds(1000000 / _settings_client.gui.fast_forward_refresh_rate);
+		}
 		/* If vsync, draw interval is decided by the display driver */
 		if (_video_vsync && _video_hw_accel) return std::chrono::microseconds(0);
 		return std::chrono::microseconds(1000000 / _settings_client.gui.refresh_rate);
@@ -100,6 +100,7 @@
 #include "command_func.h"
 #include "network/network_func.h"
 #include "framerate_type.h"
+#include "tracing.h"
 #include "depot_base.h"
 #include "tunnelbridge_map.h"
 #include "gui.h"
@@ -115,12 +116,15 @@
 #include "tracerestrict.h"
 #include "worker_thread.h"
 #include "vehiclelist.h"
+#include "elrail_func.h"
 #include "core/backup_type.hpp"
+#include "3rdparty/cpp-btree/btree_map.h"
 
 #include <map>
 #include <vector>
 #include <math.h>
 #include <algorithm>
+#include <iterator>
 #include <tuple>
 #include <atomic>
 
@@ -158,6 +162,13 @@ struct StringSpriteToDraw {
 	uint16 width;
 };
 
+/**
+ * Formatted viewport sign strings, keyed by the string and its parameters.
+ * The text of a sign cannot change without the sign being repositioned, as its width depends on it,
+ * so the cache is cleared by ViewportSign::UpdatePosition. This also covers language and font changes.
+ */
+static btree::btree_map<std::tuple<StringID, uint64, uint64>, std::string> _viewport_string_cache;
+
 struct TileSpriteToDraw {
 	SpriteID image;
 	PaletteID pal;
@@ -247,6 +258,12 @@ struct BridgeSetYComparator {
 	}
 };
 
+/** Bridges to draw on the viewport map, keyed by their northern end. */
+struct ViewportMapBridges {
+	btree::btree_map<TileIndex, TileIndex, BridgeSetXComparator> bridge_to_map_x;
+	btree::btree_map<TileIndex, TileIndex, BridgeSetYComparator> bridge_to_map_y;
+};
+
 /** Data structure storing rendering information */
 struct ViewportDrawer {
 	TunnelToMapStorage tunnel_to_map_x;
@@ -284,8 +301,7 @@ struct ViewportDrawerDynamic {
 	ParentSpriteToDrawVector parent_sprites_to_draw;
 	std::vector<ViewportProcessParentSpritesData> parent_sprite_sets;
 	ChildScreenSpriteToDrawVector child_screen_sprites_to_draw;
-	btree::btree_map<TileIndex, TileIndex, BridgeSetXComparator> bridge_to_map_x;
-	btree::btree_map<TileIndex, TileIndex, BridgeSetYComparator> bridge_to_map_y;
+	ViewportMapBridges map_bridges;
 
 	uint8 display_flags;
 
@@ -379,12 +395,15 @@ private:
 	bool PrepareVehicleRoutePaths(const Vehicle *veh);
 	void MarkAllRouteStepsDirty(const Vehicle *veh);
 	void MarkAllRoutePathsDirty(const Vehicle *veh);
+	void MarkChangedRouteStepsDirty(const Vehicle *veh);
+	void MarkChangedRoutePathsDirty(const Vehicle *veh);
 
 public:
 	void PrepareVehicleRoute(const Vehicle *veh);
 	void DrawVehicleRouteSteps(const Viewport *vp);
 	void DrawVehicleRoutePath(const Viewport *vp, ViewportDrawerDynamic *vdd);
 	void MarkAllDirty(const Vehicle *veh);
+	void MarkChangedDirty(const Vehicle *veh);
 
 	inline bool HasVehicleRouteSteps() const { return !this->route_steps.empty(); }
 };
@@ -1700,10 +1719,8 @@ static void ViewportAddLandscape()
 	bool last_row = false;
 	for (; !last_row; row++) {
 		last_row = true;
-		for (int column = left_column; column <= right_column; column++) {
-			/* Valid row/column? */
-			if ((row + column) % 2 != 0) continue;
-
+		/* Only (row, column) pairs which are both even or both odd are valid, so step over the others. */
+		for (int column = left_column + ((row + left_column) & 1); column <= right_column; column += 2) {
 			Point tilecoord;
 			tilecoord.x = (row - column) / 2;
 			tilecoord.y = (row + column) / 2;
@@ -1723,14 +1740,6 @@ static void ViewportAddLandscape()
 				tile_type = MP_VOID;
 			}
 
-			if (tile_type != MP_VOID) {
-				/* We are inside the map => paint landscape. */
-				_cur_ti.tileh = GetTilePixelSlope(_cur_ti.tile, &_cur_ti.z);
-			} else {
-				/* We are outside the map => paint black. */
-				_cur_ti.tileh = GetTilePixelSlopeOutsideMap(tilecoord.x, tilecoord.y, &_cur_ti.z);
-			}
-
 			int viewport_y = GetViewportY(tilecoord);
 
 			if (viewport_y + MAX_TILE_EXTENT_BOTTOM < _vdd->dpi.top) {
@@ -1765,6 +1774,16 @@ static void ViewportAddLandscape()
 
 			if (tile_visible) {
 				last_row = false;
+
+				/* Only look up the slope of tiles which are drawn, many more tiles are only checked for visibility. */
+				if (tile_type != MP_VOID) {
+					/* We are inside the map => paint landscape. */
+					_cur_ti.tileh = GetTilePixelSlope(_cur_ti.tile, &_cur_ti.z);
+				} else {
+					/* We are outside the map => paint black. */
+					_cur_ti.tileh = GetTilePixelSlopeOutsideMap(tilecoord.x, tilecoord.y, &_cur_ti.z);
+				}
+
 				_vd.foundation_part = FOUNDATION_PART_NONE;
 				_vd.foundation[0] = -1;
 				_vd.foundation[1] = -1;
@@ -1948,6 +1967,9 @@ void ViewportSign::UpdatePosition(ZoomLevel maxzoom, int center, int top, String
 {
 	if (this->width_normal != 0) this->MarkDirty(maxzoom);
 
+	/* The text of this sign may have changed. */
+	_viewport_string_cache.clear();
+
 	this->top = top;
 
 	char buffer[DRAW_STRING_BUFFER];
@@ -2012,20 +2034,28 @@ static void ViewportSortParentSprites(ParentSpriteToSortVector *psdv)
 {
 	auto psdvend = psdv->end();
 	auto psd = psdv->begin();
+
+	/* Comparison done flags are kept per position in the array being sorted, and move along with the sprites.
+	 * The same sprite may be sorted in more than one parent sprite set at once. */
+	std::vector<uint8> comparison_done(psdv->size(), 0);
+	auto done = comparison_done.begin();
+
 	while (psd != psdvend) {
 		ParentSpriteToDraw *ps = *psd;
 
-		if (ps->IsComparisonDone()) {
+		if (*done) {
 			psd++;
+			done++;
 			continue;
 		}
 
-		ps->SetComparisonDone(true);
+		*done = 1;
 
-		for (auto psd2 = psd + 1; psd2 != psdvend; psd2++) {
-			ParentSpriteToDraw *ps2 = *psd2;
+		auto done2 = done + 1;
+		for (auto psd2 = psd + 1; psd2 != psdvend; psd2++, done2++) {
+			if (*done2) continue;
 
-			if (ps2->IsComparisonDone()) continue;
+			ParentSpriteToDraw *ps2 = *psd2;
 
 			/* Decide which comparator to use, based on whether the bounding
 			 * boxes overlap
@@ -2061,6 +2091,8 @@ static void ViewportSortParentSprites(ParentSpriteToSortVector *psdv)
 				*psd3 = *(psd3 - 1);
 			}
 			*psd = temp;
+			std::move_backward(done, done2, done2 + 1);
+			*done = 0;
 		}
 	}
 }
@@ -2114,7 +2146,7 @@ static void ViewportDrawBoundingBoxes(const DrawPixelInfo *dpi, const ParentSpri
 	}
 }
 
-static void ViewportMapStoreBridge(const Viewport * const vp, const TileIndex tile)
+static void ViewportMapStoreBridge(const Viewport * const vp, const TileIndex tile, ViewportMapBridges &bridges)
 {
 	extern LegendAndColour _legend_land_owners[NUM_NO_COMPANY_ENTRIES + MAX_COMPANIES + 1];
 	extern uint _company_to_list_pos[MAX_COMPANIES];
@@ -2127,41 +2159,41 @@ static void ViewportMapStoreBridge(const Viewport * const vp, const TileIndex ti
 	switch (GetTunnelBridgeDirection(tile)) {
 		case DIAGDIR_NE: {
 			/* X axis: tile at higher coordinate, facing towards lower coordinate */
-			auto iter = _vdd->bridge_to_map_x.lower_bound(tile);
-			if (iter != _vdd->bridge_to_map_x.begin()) {
+			auto iter = bridges.bridge_to_map_x.lower_bound(tile);
+			if (iter != bridges.bridge_to_map_x.begin()) {
 				auto prev = iter;
 				--prev;
 				if (prev->second == tile) return;
 			}
-			_vdd->bridge_to_map_x.insert(iter, std::make_pair(GetOtherTunnelBridgeEnd(tile), tile));
+			bridges.bridge_to_map_x.insert(iter, std::make_pair(GetOtherTunnelBridgeEnd(tile), tile));
 			break;
 		}
 
 		case DIAGDIR_NW: {
 			/* Y axis: tile at higher coordinate, facing towards lower coordinate */
-			auto iter = _vdd->bridge_to_map_y.lower_bound(tile);
-			if (iter != _vdd->bridge_to_map_y.begin()) {
+			auto iter = bridges.bridge_to_map_y.lower_bound(tile);
+			if (iter != bridges.bridge_to_map_y.begin()) {
 				auto prev = iter;
 				--prev;
 				if (prev->second == tile) return;
 			}
-			_vdd->bridge_to_map_y.insert(iter, std::make_pair(GetOtherTunnelBridgeEnd(tile), tile));
+			bridges.bridge_to_map_y.insert(iter, std::make_pair(GetOtherTunnelBridgeEnd(tile), tile));
 			break;
 		}
 
 		case DIAGDIR_SW: {
 			/* X axis: tile at lower coordinate, facing towards higher coordinate */
-			auto iter = _vdd->bridge_to_map_x.lower_bound(tile);
-			if (iter != _vdd->bridge_to_map_x.end() && iter->first == tile) return;
-			_vdd->bridge_to_map_x.insert(iter, std::make_pair(tile, GetOtherTunnelBridgeEnd(tile)));
+			auto iter = bridges.bridge_to_map_x.lower_bound(tile);
+			if (iter != bridges.bridge_to_map_x.end() && iter->first == tile) return;
+			bridges.bridge_to_map_x.insert(iter, std::make_pair(tile, GetOtherTunnelBridgeEnd(tile)));
 			break;
 		}
 
 		case DIAGDIR_SE: {
 			/* Y axis: tile at lower coordinate, facing towards higher coordinate */
-			auto iter = _vdd->bridge_to_map_y.lower_bound(tile);
-			if (iter != _vdd->bridge_to_map_y.end() && iter->first == tile) return;
-			_vdd->bridge_to_map_y.insert(iter, std::make_pair(tile, GetOtherTunnelBridgeEnd(tile)));
+			auto iter = bridges.bridge_to_map_y.lower_bound(tile);
+			if (iter != bridges.bridge_to_map_y.end() && iter->first == tile) return;
+			bridges.bridge_to_map_y.insert(iter, std::make_pair(tile, GetOtherTunnelBridgeEnd(tile)));
 			break;
 		}
 
@@ -2264,6 +2296,27 @@ void ViewportDrawDirtyBlocks(const DrawPixelInfo *dpi, bool increment_colour)
 	} while (--bottom > 0);
 }
 
+/**
+ * Get the formatted text of a viewport string, formatting it only when it is not cached yet.
+ * @param ss The string to draw.
+ * @return The formatted text.
+ */
+static const std::string &GetViewportStringText(const StringSpriteToDraw &ss)
+{
+	/* Town populations and station facilities are parameters, limit the number of stale entries. */
+	if (_viewport_string_cache.size() >= 16384) _viewport_string_cache.clear();
+
+	auto res = _viewport_string_cache.insert({ std::make_tuple(ss.string, ss.params[0], ss.params[1]), std::string() });
+	if (res.second) {
+		SetDParam(0, ss.params[0]);
+		SetDParam(1, ss.params[1]);
+		char buffer[DRAW_STRING_BUFFER];
+		GetString(buffer, ss.string, lastof(buffer));
+		res.first->second = buffer;
+	}
+	return res.first->second;
+}
+
 static void ViewportDrawStrings(ViewportDrawerDynamic *vdd, ZoomLevel zoom, const StringSpriteToDrawVector *sstdv)
 {
 	for (const StringSpriteToDraw &ss : *sstdv) {
@@ -2274,9 +2327,6 @@ static void ViewportDrawStrings(ViewportDrawerDynamic *vdd, ZoomLevel zoom, cons
 		int y = UnScaleByZoom(ss.y, zoom);
 		int h = WidgetDimensions::scaled.fullbevel.Vertical() + (small ? FONT_HEIGHT_SMALL : FONT_HEIGHT_NORMAL);
 
-		SetDParam(0, ss.params[0]);
-		SetDParam(1, ss.params[1]);
-
 		if (ss.colour != INVALID_COLOUR) {
 			/* Do not draw signs nor station names if they are set invisible */
 			if (vdd->IsInvisibilitySet(TO_SIGNS) && ss.string != STR_WHITE_SIGN) continue;
@@ -2296,7 +2346,7 @@ static void ViewportDrawStrings(ViewportDrawerDynamic *vdd, ZoomLevel zoom, cons
 			}
 		}
 
-		DrawString(x + WidgetDimensions::scaled.fullbevel.left, x + w - 1 - WidgetDimensions::scaled.fullbevel.right, y + WidgetDimensions::scaled.fullbevel.top, ss.string, colour, SA_HOR_CENTER, false, small ? FS_SMALL : FS_NORMAL);
+		DrawString(x + WidgetDimensions::scaled.fullbevel.left, x + w - 1 - WidgetDimensions::scaled.fullbevel.right, y + WidgetDimensions::scaled.fullbevel.top, GetViewportStringText(ss), colour, SA_HOR_CENTER, false, small ? FS_SMALL : FS_NORMAL);
 	}
 }
 
@@ -3188,33 +3238,33 @@ static inline uint32 ViewportMapGetColourRoutes(const TileIndex tile, TileType t
 	return IS32(colour);
 }
 
-static inline void ViewportMapStoreBridgeAboveTile(const Viewport * const vp, const TileIndex tile)
+static inline void ViewportMapStoreBridgeAboveTile(const Viewport * const vp, const TileIndex tile, ViewportMapBridges &bridges)
 {
 	/* No need to bother for hidden things */
 	if (!_settings_client.gui.show_bridges_on_map) return;
 
 	if (GetBridgeAxis(tile) == AXIS_X) {
-		auto iter = _vdd->bridge_to_map_x.lower_bound(tile);
-		if (iter != _vdd->bridge_to_map_x.end() && iter->first < tile && iter->second > tile) return; /* already covered */
-		_vdd->bridge_to_map_x.insert(iter, std::make_pair(GetNorthernBridgeEnd(tile), GetSouthernBridgeEnd(tile)));
+		auto iter = bridges.bridge_to_map_x.lower_bound(tile);
+		if (iter != bridges.bridge_to_map_x.end() && iter->first < tile && iter->second > tile) return; /* already covered */
+		bridges.bridge_to_map_x.insert(iter, std::make_pair(GetNorthernBridgeEnd(tile), GetSouthernBridgeEnd(tile)));
 	} else {
-		auto iter = _vdd->bridge_to_map_y.lower_bound(tile);
-		if (iter != _vdd->bridge_to_map_y.end() && iter->first < tile && iter->second > tile) return; /* already covered */
-		_vdd->bridge_to_map_y.insert(iter, std::make_pair(GetNorthernBridgeEnd(tile), GetSouthernBridgeEnd(tile)));
+		auto iter = bridges.bridge_to_map_y.lower_bound(tile);
+		if (iter != bridges.bridge_to_map_y.end() && iter->first < tile && iter->second > tile) return; /* already covered */
+		bridges.bridge_to_map_y.insert(iter, std::make_pair(GetNorthernBridgeEnd(tile), GetSouthernBridgeEnd(tile)));
 	}
 }
 
-static inline TileIndex ViewportMapGetMostSignificantTileType(const Viewport * const vp, const TileIndex from_tile, TileType * const tile_type)
+static inline TileIndex ViewportMapGetMostSignificantTileType(const Viewport * const vp, const TileIndex from_tile, TileType * const tile_type, ViewportMapBridges &bridges)
 {
 	if (vp->zoom <= ZOOM_LVL_OUT_128X || !_settings_client.gui.viewport_map_scan_surroundings) {
 		const TileType ttype = GetTileType(from_tile);
 		/* Store bridges and tunnels. */
 		if (ttype != MP_TUNNELBRIDGE) {
 			*tile_type = ttype;
-			if (IsBridgeAbove(from_tile)) ViewportMapStoreBridgeAboveTile(vp, from_tile);
+			if (IsBridgeAbove(from_tile)) ViewportMapStoreBridgeAboveTile(vp, from_tile, bridges);
 		} else {
 			if (IsBridge(from_tile)) {
-				ViewportMapStoreBridge(vp, from_tile);
+				ViewportMapStoreBridge(vp, from_tile, bridges);
 			}
 			switch (GetTunnelBridgeTransportType(from_tile)) {
 				case TRANSPORT_RAIL:  *tile_type = MP_RAILWAY; break;
@@ -3241,7 +3291,7 @@ static inline TileIndex ViewportMapGetMostSignificantTileType(const Viewport * c
 			result = tile;
 		}
 		if (ttype != MP_TUNNELBRIDGE && IsBridgeAbove(tile)) {
-			ViewportMapStoreBridgeAboveTile(vp, tile);
+			ViewportMapStoreBridgeAboveTile(vp, tile, bridges);
 		}
 	}
 
@@ -3249,7 +3299,7 @@ static inline TileIndex ViewportMapGetMostSignificantTileType(const Viewport * c
 	*tile_type = GetTileType(result);
 	if (*tile_type == MP_TUNNELBRIDGE) {
 		if (IsBridge(result)) {
-			ViewportMapStoreBridge(vp, result);
+			ViewportMapStoreBridge(vp, result, bridges);
 		}
 		switch (GetTunnelBridgeTransportType(result)) {
 			case TRANSPORT_RAIL: *tile_type = MP_RAILWAY; break;
@@ -3263,7 +3313,7 @@ static inline TileIndex ViewportMapGetMostSignificantTileType(const Viewport * c
 
 /** Get the colour of a tile, can be 32bpp RGB or 8bpp palette index. */
 template <bool is_32bpp, bool show_slope>
-uint32 ViewportMapGetColour(const Viewport * const vp, int x, int y, const uint colour_index)
+uint32 ViewportMapGetColour(const Viewport * const vp, int x, int y, const uint colour_index, ViewportMapBridges &bridges)
 {
 	if (x >= static_cast<int>(MapMaxX() * TILE_SIZE) || y >= static_cast<int>(MapMaxY() * TILE_SIZE)) return 0;
 
@@ -3287,7 +3337,7 @@ uint32 ViewportMapGetColour(const Viewport * const vp, int x, int y, const uint
 		if (tile >= MapSize()) return 0;
 	}
 	TileType tile_type = MP_VOID;
-	tile = ViewportMapGetMostSignificantTileType(vp, tile, &tile_type);
+	tile = ViewportMapGetMostSignificantTileType(vp, tile, &tile_type, bridges);
 	if (tile_type == MP_VOID) return 0;
 
 	/* Return the colours. */
@@ -3492,6 +3542,8 @@ static void ViewportMapDrawBridgeTunnel(Viewport * const vp, const TunnelBridgeT
 	}
 }
 
+static const int VIEWPORT_MAP_MIN_BAND_HEIGHT = 32; ///< Minimum number of lines per band when rendering the viewport map in parallel.
+
 /** Draw the map on a viewport. */
 template <bool is_32bpp, bool show_slope>
 void ViewportMapDraw(Viewport * const vp)
@@ -3511,54 +3563,91 @@ void ViewportMapDraw(Viewport * const vp)
 	const  int sx = UnScaleByZoomLower(_vdd->dpi.left, _vdd->dpi.zoom);
 	const  int sy = UnScaleByZoomLower(_vdd->dpi.top, _vdd->dpi.zoom);
 	const uint line_padding = 2 * (sy & 1);
-	uint       colour_index_base = (sx + line_padding) & 3;
+	const uint colour_index_base = (sx + line_padding) & 3;
 
 	const  int incr_a = (1 << (vp->zoom - 2)) / ZOOM_LVL_BASE;
 	const  int incr_b = (1 << (vp->zoom - 1)) / ZOOM_LVL_BASE;
 	const  int a = (_vdd->dpi.left >> 2) / ZOOM_LVL_BASE;
-	int        b = (_vdd->dpi.top >> 1) / ZOOM_LVL_BASE;
+	const  int b_base = (_vdd->dpi.top >> 1) / ZOOM_LVL_BASE;
 	const  int w = UnScaleByZoom(_vdd->dpi.width, vp->zoom);
 	const  int h = UnScaleByZoom(_vdd->dpi.height, vp->zoom);
-	int        j = 0;
 
 	const int land_cache_start = _vdd->offset_x + (_vdd->offset_y * vp->width);
-	uint32 *land_cache_ptr32 = reinterpret_cast<uint32 *>(vp->land_pixel_cache.data()) + land_cache_start;
-	uint8 *land_cache_ptr8 = reinterpret_cast<uint8 *>(vp->land_pixel_cache.data()) + land_cache_start;
 
-	bool cache_updated = false;
-
-	/* Render base map. */
-	do { // For each line
-		int i = w;
-		uint colour_index = colour_index_base;
-		colour_index_base ^= 2;
-		int c = b - a;
-		int d = b + a;
-		do { // For each pixel of a line
-			if (is_32bpp) {
-				if (*land_cache_ptr32 == 0xD7D7D7D7) {
-					*land_cache_ptr32 = ViewportMapGetColour<is_32bpp, show_slope>(vp, c, d, colour_index);
-					cache_updated = true;
+	/* Render lines [first_line, last_line) of the base map, storing any bridges found into bridges.
+	 * Each line only writes to its own part of the land pixel cache, so disjoint line ranges can be rendered concurrently. */
+	auto render_lines = [&](const int first_line, const int last_line, ViewportMapBridges &bridges) -> bool {
+		bool updated = false;
+		uint line_colour_index_base = colour_index_base ^ ((first_line & 1) ? 2 : 0);
+		int b = b_base + (first_line * incr_b);
+		const int line_start = land_cache_start + (first_line * vp->width);
+		uint32 *land_cache_ptr32 = reinterpret_cast<uint32 *>(vp->land_pixel_cache.data()) + line_start;
+		uint8 *land_cache_ptr8 = reinterpret_cast<uint8 *>(vp->land_pixel_cache.data()) + line_start;
+
+		for (int j = first_line; j < last_line; j++) { // For each line
+			int i = w;
+			uint colour_index = line_colour_index_base;
+			line_colour_index_base ^= 2;
+			int c = b - a;
+			int d = b + a;
+			do { // For each pixel of a line
+				if (is_32bpp) {
+					if (*land_cache_ptr32 == 0xD7D7D7D7) {
+						*land_cache_ptr32 = ViewportMapGetColour<is_32bpp, show_slope>(vp, c, d, colour_index, bridges);
+						updated = true;
+					}
+					land_cache_ptr32++;
+				} else {
+					if (*land_cache_ptr8 == 0xD7) {
+						*land_cache_ptr8 = (uint8) ViewportMapGetColour<is_32bpp, show_slope>(vp, c, d, colour_index, bridges);
+						updated = true;
+					}
+					land_cache_ptr8++;
 				}
-				land_cache_ptr32++;
+				colour_index = (colour_index + 1) & 3;
+				c -= incr_a;
+				d += incr_a;
+			} while (--i);
+			if (is_32bpp) {
+				land_cache_ptr32 += (vp->width - w);
 			} else {
-				if (*land_cache_ptr8 == 0xD7) {
-					*land_cache_ptr8 = (uint8) ViewportMapGetColour<is_32bpp, show_slope>(vp, c, d, colour_index);
-					cache_updated = true;
-				}
-				land_cache_ptr8++;
+				land_cache_ptr8 += (vp->width - w);
 			}
-			colour_index = (colour_index + 1) & 3;
-			c -= incr_a;
-			d += incr_a;
-		} while (--i);
-		if (is_32bpp) {
-			land_cache_ptr32 += (vp->width - w);
-		} else {
-			land_cache_ptr8 += (vp->width - w);
+			b += incr_b;
+		}
+		return updated;
+	};
+
+	/* Render base map. */
+	ViewportMapBridges &bridges = _vdd->map_bridges;
+	bool cache_updated = false;
+	const uint bands = std::min<uint>(_general_worker_pool.GetWorkerCount() + 1, h / VIEWPORT_MAP_MIN_BAND_HEIGHT);
+	if (bands <= 1 || unlikely(HasBit(_viewport_debug_flags, VDF_DISABLE_THREAD))) {
+		cache_updated = render_lines(0, h, bridges);
+	} else {
+		/* Split the map into horizontal bands, render all but the first in worker threads.
+		 * Bridges are collected per band, and merged afterwards: each is keyed by its northern end, so the union is the same as when rendering serially. */
+		std::vector<ViewportMapBridges> band_bridges(bands - 1);
+		std::atomic<bool> band_updated = false;
+		{
+			WorkerTaskGroup group;
+			for (uint band = 1; band < bands; band++) {
+				const int first_line = (h * band) / bands;
+				const int last_line = (h * (band + 1)) / bands;
+				ViewportMapBridges &target = band_bridges[band - 1];
+				group.Run([&render_lines, &band_updated, &target, first_line, last_line]() {
+					if (render_lines(first_line, last_line, target)) band_updated.store(true, std::memory_order_relaxed);
+				});
+			}
+			cache_updated = render_lines(0, h / bands, bridges);
+			group.Wait();
+		}
+		if (band_updated.load(std::memory_order_relaxed)) cache_updated = true;
+		for (const ViewportMapBridges &band : band_bridges) {
+			bridges.bridge_to_map_x.insert(band.bridge_to_map_x.begin(), band.bridge_to_map_x.end());
+			bridges.bridge_to_map_y.insert(band.bridge_to_map_y.begin(), band.bridge_to_map_y.end());
 		}
-		b += incr_b;
-	} while (++j < h);
+	}
 
 	auto draw_tunnels = [&](const int y_intercept_min, const int y_intercept_max, const TunnelToMapStorage &storage) {
 		auto iter = std::lower_bound(storage.tunnels.begin(), storage.tunnels.end(), y_intercept_min, [](const TunnelToMap &a, int b) -> bool {
@@ -3596,14 +3685,14 @@ void ViewportMapDraw(Viewport * const vp)
 		}
 
 		/* Render bridges */
-		if (_settings_client.gui.show_bridges_on_map && _vdd->bridge_to_map_x.size() != 0) {
-			for (const auto &it : _vdd->bridge_to_map_x) { // For each bridge
+		if (_settings_client.gui.show_bridges_on_map && bridges.bridge_to_map_x.size() != 0) {
+			for (const auto &it : bridges.bridge_to_map_x) { // For each bridge
 				TunnelBridgeToMap tbtm { it.first, it.second };
 				ViewportMapDrawBridgeTunnel<is_32bpp>(vp, &tbtm, (GetBridgeHeight(tbtm.from_tile) - 1) * TILE_HEIGHT, false, w, h, blitter);
 			}
 		}
-		if (_settings_client.gui.show_bridges_on_map && _vdd->bridge_to_map_y.size() != 0) {
-			for (const auto &it : _vdd->bridge_to_map_y) { // For each bridge
+		if (_settings_client.gui.show_bridges_on_map && bridges.bridge_to_map_y.size() != 0) {
+			for (const auto &it : bridges.bridge_to_map_y) { // For each bridge
 				TunnelBridgeToMap tbtm { it.first, it.second };
 				ViewportMapDrawBridgeTunnel<is_32bpp>(vp, &tbtm, (GetBridgeHeight(tbtm.from_tile) - 1) * TILE_HEIGHT, false, w, h, blitter);
 			}
@@ -3652,7 +3741,6 @@ static void ViewportProcessParentSprites(ViewportDrawerDynamic *vdd, uint data_i
 
 			ParentSpriteToSortVector psts;
 			for (ParentSpriteToDraw *psd : data->psts) {
-				psd->SetComparisonDone(false);
 				if (psd->top + psd->height > data->dpi.top) {
 					psts.push_back(psd);
 				}
@@ -3680,7 +3768,6 @@ static void ViewportProcessParentSprites(ViewportDrawerDynamic *vdd, uint data_i
 
 			ParentSpriteToSortVector psts;
 			for (ParentSpriteToDraw *psd : data->psts) {
-				psd->SetComparisonDone(false);
 				if (psd->left + psd->width > data->dpi.left - margin) {
 					psts.push_back(psd);
 				}
@@ -3689,8 +3776,6 @@ static void ViewportProcessParentSprites(ViewportDrawerDynamic *vdd, uint data_i
 
 			ViewportProcessParentSprites(vdd, data_index);
 		}
-	} else {
-		_vp_sprite_sorter(&data->psts);
 	}
 }
 
@@ -3708,6 +3793,8 @@ void ViewportDoDraw(Viewport *vp, int left, int top, int right, int bottom, uint
 		_spare_viewport_drawers.pop_back();
 	}
 
+	InvalidateCatenaryDrawCache();
+
 	_vdd->display_flags = display_flags;
 	_vdd->transparency_opt = _transparency_opt;
 	_vdd->invisibility_opt = _invisibility_opt;
@@ -3782,6 +3869,11 @@ void ViewportDoDraw(Viewport *vp, int left, int top, int right, int bottom, uint
 
 /* This is run in a worker thread */
 static void ViewportDoDrawRenderSubJob(Viewport *vp, ViewportDrawerDynamic *vdd, uint data_index) {
+	TRACE_SCOPE("ViewportDoDrawRenderSubJob");
+
+	/* Each parent sprite set is sorted independently, in the same job as it is drawn. */
+	_vp_sprite_sorter(&vdd->parent_sprite_sets[data_index].psts);
+
 	ViewportDrawParentSprites(vdd, &vdd->parent_sprite_sets[data_index].dpi, &vdd->parent_sprite_sets[data_index].psts, &vdd->child_screen_sprites_to_draw);
 
 	if (_draw_dirty_blocks && HasBit(_viewport_debug_flags, VDF_DIRTY_BLOCK_PER_SPLIT)) {
@@ -3806,6 +3898,8 @@ static void ViewportDoDrawRenderSubJob(Viewport *vp, ViewportDrawerDynamic *vdd,
 /* This is run in a worker thread */
 static void ViewportDoDrawRenderJob(Viewport *vp, ViewportDrawerDynamic *vdd)
 {
+	TRACE_SCOPE("ViewportDoDrawRenderJob");
+
 	ViewportAddKdtreeSigns(vdd, &vdd->dpi, false);
 
 	DrawTextEffects(vdd, &vdd->dpi, vdd->IsTransparencySet(TO_LOADING));
@@ -3843,10 +3937,12 @@ void ViewportDoDrawProcessAllPending()
 	if (_viewport_drawer_jobs == 0) return;
 
 	PerformanceAccumulator framerate(PFE_DRAWWORLD);
+	TRACE_SCOPE("ViewportDoDrawProcessAllPending");
 
 	std::unique_lock<std::mutex> lk(_viewport_drawer_return_lock);
 	while (true) {
 		if (_viewport_drawer_returns.empty()) {
+			TRACE_SCOPE("ViewportDoDrawWait");
 			_viewport_drawer_empty_cv.wait(lk);
 		} else {
 			Viewport *vp = _viewport_drawer_returns.back().vp;
@@ -3918,8 +4014,8 @@ static void ViewportDoDrawPhase3(Viewport *vp)
 				(_vdd->display_flags & ND_SHADE_DIMMED) ? PALETTE_TO_TRANSPARENT : PALETTE_NEWSPAPER, FILLRECT_RECOLOUR);
 	}
 
-	_vdd->bridge_to_map_x.clear();
-	_vdd->bridge_to_map_y.clear();
+	_vdd->map_bridges.bridge_to_map_x.clear();
+	_vdd->map_bridges.bridge_to_map_y.clear();
 	_vdd->string_sprites_to_draw.clear();
 	_vdd->tile_sprites_to_draw.clear();
 	_vdd->parent_sprites_to_draw.clear();
@@ -4210,6 +4306,9 @@ void MarkViewportDirty(Viewport * const vp, int left, int top, int right, int bo
  */
 void MarkAllViewportsDirty(int left, int top, int right, int bottom, ViewportMarkDirtyFlags flags)
 {
+	/* The whole screen is marked dirty at the end of catching up with the network server. */
+	if (_network_catching_up) return;
+
 	for (uint i = 0; i < _viewport_window_cache.size(); i++) {
 		if (flags & VMDF_NOT_MAP_MODE && _viewport_window_cache[i]->zoom >= ZOOM_LVL_DRAW_MAP) continue;
 		if (flags & VMDF_NOT_MAP_MODE_NON_VEG && _viewport_window_cache[i]->zoom >= ZOOM_LVL_DRAW_MAP && _viewport_window_cache[i]->map_type != VPMT_VEGETATION) continue;
@@ -4457,6 +4556,66 @@ void ViewportRouteOverlay::MarkAllDirty(const Vehicle *veh)
 	this->MarkAllRouteStepsDirty(veh);
 }
 
+/**
+ * Rebuild the route steps of a vehicle whose orders have changed, and only mark the steps which differ from those currently drawn as dirty.
+ * @param veh Vehicle whose route steps are shown by this overlay.
+ */
+void ViewportRouteOverlay::MarkChangedRouteStepsDirty(const Vehicle *veh)
+{
+	RouteStepsMap old_steps;
+	old_steps.swap(this->route_steps);
+	this->PrepareVehicleRouteSteps(veh);
+
+	/* Both maps are ordered by tile, walk them in step */
+	auto old_it = old_steps.cbegin();
+	auto new_it = this->route_steps.cbegin();
+	while (old_it != old_steps.cend() || new_it != this->route_steps.cend()) {
+		if (new_it == this->route_steps.cend() || (old_it != old_steps.cend() && old_it->first < new_it->first)) {
+			MarkRouteStepDirty(old_it);
+			++old_it;
+		} else if (old_it == old_steps.cend() || new_it->first < old_it->first) {
+			MarkRouteStepDirty(new_it);
+			++new_it;
+		} else {
+			if (old_it->second != new_it->second) {
+				MarkRouteStepDirty(old_it);
+				MarkRouteStepDirty(new_it);
+			}
+			++old_it;
+			++new_it;
+		}
+	}
+	this->route_steps_last_mark_dirty = this->route_steps;
+}
+
+/**
+ * Rebuild the route paths of a vehicle whose orders have changed, and only mark the lines which were added or removed as dirty.
+ * @param veh Vehicle whose route paths are shown by this overlay.
+ */
+void ViewportRouteOverlay::MarkChangedRoutePathsDirty(const Vehicle *veh)
+{
+	std::vector<DrawnPathRouteTileLine> old_paths;
+	old_paths.swap(this->route_paths);
+	if (_settings_client.gui.show_vehicle_route && !this->PrepareVehicleRoutePaths(veh)) this->route_paths.clear();
+
+	/* Both vectors are sorted and free of duplicates, lines present in both do not need to be redrawn */
+	std::vector<DrawnPathRouteTileLine> changed_paths;
+	std::set_symmetric_difference(old_paths.begin(), old_paths.end(), this->route_paths.begin(), this->route_paths.end(), std::back_inserter(changed_paths));
+	MarkRoutePathsDirty(changed_paths);
+	this->route_paths_last_mark_dirty = this->route_paths;
+}
+
+/**
+ * Update the overlay after the orders of the shown vehicle have changed.
+ * Unlike MarkAllDirty, only the parts of the overlay which have changed are marked dirty.
+ * @param veh Vehicle shown by this overlay.
+ */
+void ViewportRouteOverlay::MarkChangedDirty(const Vehicle *veh)
+{
+	this->MarkChangedRoutePathsDirty(veh);
+	this->MarkChangedRouteStepsDirty(veh);
+}
+
 void MarkDirtyFocusedRoutePaths(const Vehicle *veh)
 {
 	_vp_focused_window_route_overlay.MarkAllDirty(veh);
@@ -4468,10 +4627,10 @@ void CheckMarkDirtyViewportRoutePaths(const Vehicle *veh)
 
 	const Vehicle *focused_veh = GetVehicleFromWindow(_focused_window);
 	if (focused_veh != nullptr && veh == focused_veh) {
-		MarkDirtyFocusedRoutePaths(veh);
+		_vp_focused_window_route_overlay.MarkChangedDirty(veh);
 	}
 	for (auto &it : _vp_fixed_route_overlays) {
-		if (it.veh == veh->index) it.MarkAllDirty(veh);
+		if (it.veh == veh->index) it.MarkChangedDirty(veh);
 	}
 }
 
@@ -4840,6 +4999,19 @@ void RebuildViewportKdtree()
 	_viewport_sign_kdtree.Build(items.begin(), items.end());
 }
 
+ViewportSignKdtreeBatchUpdate::ViewportSignKdtreeBatchUpdate() : rebuild(_viewport_sign_kdtree_valid)
+{
+	if (this->rebuild) {
+		_viewport_sign_kdtree_valid = false;
+		_viewport_sign_kdtree.Clear();
+	}
+}
+
+ViewportSignKdtreeBatchUpdate::~ViewportSignKdtreeBatchUpdate()
+{
+	if (this->rebuild) RebuildViewportKdtree();
+}
+
 
 static bool CheckClickOnLandscape(const Viewport *vp, int x, int y)
 {
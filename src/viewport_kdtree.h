@@ -81,4 +81,18 @@ extern bool _viewport_sign_kdtree_valid;
 
 void RebuildViewportKdtree();
 
+/**
+ * Scope guard for updating the positions of many viewport signs at once.
+ * The viewport sign kd-tree is invalidated for the duration, so that the individual sign updates do not
+ * each remove and re-insert their kd-tree item, and it is then rebuilt once at the end of the scope.
+ * Nested batches and batches while the kd-tree is already invalid do not rebuild it.
+ */
+struct ViewportSignKdtreeBatchUpdate {
+	ViewportSignKdtreeBatchUpdate();
+	~ViewportSignKdtreeBatchUpdate();
+
+private:
+	bool rebuild; ///< Whether the kd-tree was valid at the start of the batch, and so needs to be rebuilt at the end
+};
+
 #endif
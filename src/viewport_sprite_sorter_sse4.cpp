@@ -14,6 +14,8 @@
 #include "smmintrin.h"
 #include "viewport_sprite_sorter.h"
 
+#include <algorithm>
+
 #include "safeguards.h"
 
 static_assert((sizeof(ParentSpriteToDraw) % 16) == 0);
@@ -30,20 +32,28 @@ void ViewportSortParentSpritesSSE41(ParentSpriteToSortVector *psdv)
 	const __m128i mask_ptest = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  0,  0,  0);
 	auto const psdvend = psdv->end();
 	auto psd = psdv->begin();
+
+	/* Comparison done flags are kept per position in the array being sorted, and move along with the sprites.
+	 * The same sprite may be sorted in more than one parent sprite set at once. */
+	std::vector<uint8> comparison_done(psdv->size(), 0);
+	auto done = comparison_done.begin();
+
 	while (psd != psdvend) {
 		ParentSpriteToDraw * const ps = *psd;
 
-		if (ps->IsComparisonDone()) {
+		if (*done) {
 			psd++;
+			done++;
 			continue;
 		}
 
-		ps->SetComparisonDone(true);
+		*done = 1;
 
-		for (auto psd2 = psd + 1; psd2 != psdvend; psd2++) {
-			ParentSpriteToDraw * const ps2 = *psd2;
+		auto done2 = done + 1;
+		for (auto psd2 = psd + 1; psd2 != psdvend; psd2++, done2++) {
+			if (*done2) continue;
 
-			if (ps2->IsComparisonDone()) continue;
+			ParentSpriteToDraw * const ps2 = *psd2;
 
 			/*
 			 * Decide which comparator to use, based on whether the bounding boxes overlap
@@ -88,6 +98,8 @@ void ViewportSortParentSpritesSSE41(ParentSpriteToSortVector *psdv)
 				*psd3 = *(psd3 - 1);
 			}
 			*psd = temp;
+			std::move_backward(done, done2, done2 + 1);
+			*done = 0;
 		}
 	}
 }
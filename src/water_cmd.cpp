@@ -41,6 +41,7 @@
 #include "object_base.h"
 #include "object_map.h"
 #include "newgrf_object.h"
+#include "pathfinder/water_regions.h"
 
 #include "table/strings.h"
 
@@ -160,6 +161,8 @@ CommandCost CmdBuildShipDepot(TileIndex tile, DoCommandFlag flags, uint32 p1, ui
 
 		MakeShipDepot(tile,  _current_company, depot->index, DEPOT_PART_NORTH, axis, wc1);
 		MakeShipDepot(tile2, _current_company, depot->index, DEPOT_PART_SOUTH, axis, wc2);
+		InvalidateWaterRegion(tile);
+		InvalidateWaterRegion(tile2);
 		CheckForDockingTile(tile);
 		CheckForDockingTile(tile2);
 		MarkTileDirtyByTile(tile);
@@ -268,6 +271,7 @@ void MakeWaterKeepingClass(TileIndex tile, Owner o)
 	}
 
 	if (wc != WATER_CLASS_INVALID) CheckForDockingTile(tile);
+	InvalidateWaterRegion(tile);
 	MarkTileDirtyByTile(tile);
 }
 
@@ -367,6 +371,9 @@ static CommandCost DoBuildLock(TileIndex tile, DiagDirection dir, DoCommandFlag
 		}
 
 		MakeLock(tile, _current_company, dir, wc_lower, wc_upper, wc_middle);
+		InvalidateWaterRegion(tile);
+		InvalidateWaterRegion(tile - delta);
+		InvalidateWaterRegion(tile + delta);
 		CheckForDockingTile(tile - delta);
 		CheckForDockingTile(tile + delta);
 		MarkTileDirtyByTile(tile);
@@ -411,6 +418,7 @@ static CommandCost RemoveLock(TileIndex tile, DoCommandFlag flags)
 
 		if (GetWaterClass(tile) == WATER_CLASS_RIVER) {
 			MakeRiver(tile, Random());
+			InvalidateWaterRegion(tile);
 		} else {
 			DoClearSquare(tile);
 			ClearNeighbourNonFloodingStates(tile);
@@ -455,6 +463,7 @@ bool RiverModifyDesertZone(TileIndex tile, void *)
  */
 void MakeRiverAndModifyDesertZoneAround(TileIndex tile) {
 	MakeRiver(tile, Random());
+	InvalidateWaterRegion(tile);
 	MarkTileDirtyByTile(tile);
 
 	/* Remove desert directly around the river tile. */
@@ -523,6 +532,7 @@ CommandCost CmdBuildCanal(TileIndex tile, DoCommandFlag flags, uint32 p1, uint32
 			switch (wc) {
 				case WATER_CLASS_RIVER:
 					MakeRiver(current_tile, Random());
+					InvalidateWaterRegion(current_tile);
 					if (_game_mode == GM_EDITOR) {
 						TileIndex tile2 = current_tile;
 						CircularTileSearch(&tile2, _settings_game.game_creation.river_tropics_width, RiverModifyDesertZone, nullptr);
@@ -532,12 +542,14 @@ CommandCost CmdBuildCanal(TileIndex tile, DoCommandFlag flags, uint32 p1, uint32
 				case WATER_CLASS_SEA:
 					if (TileHeight(current_tile) == 0) {
 						MakeSea(current_tile);
+						InvalidateWaterRegion(current_tile);
 						break;
 					}
 					FALLTHROUGH;
 
 				default:
 					MakeCanal(current_tile, _current_company, Random());
+					InvalidateWaterRegion(current_tile);
 					if (Company::IsValidID(_current_company)) {
 						Company::Get(_current_company)->infrastructure.water++;
 						DirtyCompanyInfrastructureWindows(_current_company);
@@ -1206,6 +1218,7 @@ void DoFloodTile(TileIndex target)
 			case MP_CLEAR:
 				if (DoCommand(target, 0, 0, DC_EXEC, CMD_LANDSCAPE_CLEAR).Succeeded()) {
 					MakeShore(target);
+					InvalidateWaterRegion(target);
 					MarkTileDirtyByTile(target);
 					flooded = true;
 				}
@@ -1222,6 +1235,7 @@ void DoFloodTile(TileIndex target)
 						/* object is on the lower edge with no foundation, and now underwater, clear the tile and then flood it */
 						if (DoCommand(target, 0, 0, DC_EXEC, CMD_LANDSCAPE_CLEAR).Succeeded()) {
 							MakeShore(target);
+							InvalidateWaterRegion(target);
 							MarkTileDirtyByTile(target);
 							flooded = true;
 						}
@@ -1229,6 +1243,7 @@ void DoFloodTile(TileIndex target)
 					}
 					SetWaterClass(target, WATER_CLASS_SEA);
 					SetObjectGroundTypeDensity(target, OBJECT_GROUND_SHORE, 3);
+					InvalidateWaterRegion(target);
 					MarkTileDirtyByTile(target, VMDF_NOT_MAP_MODE);
 					flooded = true;
 				}
@@ -1245,6 +1260,7 @@ void DoFloodTile(TileIndex target)
 		/* flood flat tile */
 		if (DoCommand(target, 0, 0, DC_EXEC, CMD_LANDSCAPE_CLEAR).Succeeded()) {
 			MakeSea(target);
+			InvalidateWaterRegion(target);
 			MarkTileDirtyByTile(target);
 			flooded = true;
 		}
@@ -1297,6 +1313,7 @@ static void DoDryUp(TileIndex tile)
 
 			if (DoCommand(tile, 0, 0, DC_EXEC, CMD_LANDSCAPE_CLEAR).Succeeded()) {
 				MakeClear(tile, CLEAR_GRASS, 3);
+				InvalidateWaterRegion(tile);
 				MarkTileDirtyByTile(tile);
 			}
 			break;
@@ -1390,6 +1407,7 @@ void ConvertGroundTilesIntoWaterTiles()
 			switch (slope) {
 				case SLOPE_FLAT:
 					MakeSea(tile);
+					InvalidateWaterRegion(tile);
 					break;
 
 				case SLOPE_N:
@@ -1397,6 +1415,7 @@ void ConvertGroundTilesIntoWaterTiles()
 				case SLOPE_S:
 				case SLOPE_W:
 					MakeShore(tile);
+					InvalidateWaterRegion(tile);
 					break;
 
 				default:
@@ -1405,6 +1424,7 @@ void ConvertGroundTilesIntoWaterTiles()
 						Slope slope_dest = GetTileSlope(dest) & ~SLOPE_STEEP;
 						if (slope_dest == SLOPE_FLAT || IsSlopeWithOneCornerRaised(slope_dest) || IsTileType(dest, MP_VOID)) {
 							MakeShore(tile);
+							InvalidateWaterRegion(tile);
 							break;
 						}
 					}
@@ -3386,8 +3386,11 @@ void SetWindowClassesDirty(WindowClass cls)
 void Window::InvalidateData(int data, bool gui_scope)
 {
 	if (!gui_scope) {
-		/* Schedule GUI-scope invalidation for next redraw. */
-		this->scheduled_invalidation_data.push_back(data);
+		/* Schedule GUI-scope invalidation for next redraw.
+		 * Repeats of the most recently scheduled data are coalesced, as nothing can change between processing them. */
+		if (this->scheduled_invalidation_data.empty() || this->scheduled_invalidation_data.back() != data) {
+			this->scheduled_invalidation_data.push_back(data);
+		}
 	} else {
 		this->SetDirty();
 	}
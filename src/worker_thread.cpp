@@ -10,11 +10,17 @@
 #include "stdafx.h"
 #include "worker_thread.h"
 #include "thread.h"
+#include "tracing.h"
 
 #include "safeguards.h"
 
 WorkerThreadPool _general_worker_pool;
 
+/** Pool which the current thread is a worker of, if any. */
+static thread_local WorkerThreadPool *_current_worker_pool = nullptr;
+/** Queue index of the current thread within _current_worker_pool. */
+static thread_local uint _current_worker_index = 0;
+
 void WorkerThreadPool::Start(const char *thread_name, uint max_workers)
 {
 	uint cpus = std::thread::hardware_concurrency();
@@ -22,18 +28,22 @@ void WorkerThreadPool::Start(const char *thread_name, uint max_workers)
 
 	std::lock_guard<std::mutex> lk(this->lock);
 
+	/* The set of queues is fixed while workers are running */
+	if (this->workers > 0) return;
+
 	this->exit = false;
 
 	uint worker_target = std::min<uint>(max_workers, cpus);
-	if (this->workers >= worker_target) return;
-
-	uint new_workers = worker_target - this->workers;
+	this->queues.clear();
+	for (uint i = 0; i < worker_target; i++) {
+		this->queues.push_back(std::make_unique<WorkerQueue>());
+	}
 
-	for (uint i = 0; i < new_workers; i++) {
+	for (uint i = 0; i < worker_target; i++) {
 		this->workers++;
-		if (!StartNewThread(nullptr, thread_name, &WorkerThreadPool::Run, this)) {
+		if (!StartNewThread(nullptr, thread_name, &WorkerThreadPool::Run, this, static_cast<uint>(i))) {
 			this->workers--;
-			return;
+			break;
 		}
 	}
 }
@@ -44,41 +54,199 @@ void WorkerThreadPool::Stop()
 	this->exit = true;
 	this->worker_wait_cv.notify_all();
 	this->done_cv.wait(lk, [this]() { return this->workers == 0; });
+
+	/* Workers drain all queues before exiting, nothing can be left here */
+	this->queues.clear();
+}
+
+/**
+ * Reset the pool in a child process created by fork(), which only has the forking thread.
+ * Jobs are executed synchronously afterwards, none of the locks which other threads may have held at the time of the fork are used.
+ */
+void WorkerThreadPool::ResetInForkedChild()
+{
+	this->workers.store(0);
+	this->workers_waiting.store(0);
+	this->pending.store(0);
+}
+
+void WorkerThreadPool::PushJob(WorkerJob &&job)
+{
+	uint index;
+	if (_current_worker_pool == this) {
+		index = _current_worker_index;
+	} else {
+		index = this->next_queue.fetch_add(1, std::memory_order_relaxed) % (uint)this->queues.size();
+	}
+
+	WorkerQueue &queue = *this->queues[index];
+	{
+		std::lock_guard<std::mutex> lk(queue.lock);
+		queue.jobs.push_back(std::move(job));
+	}
+
+	this->pending.fetch_add(1);
+	if (this->workers_waiting.load() > 0) {
+		/* Take the lock so that the notification can't be lost between a worker checking pending and starting to wait */
+		std::lock_guard<std::mutex> lk(this->lock);
+		this->worker_wait_cv.notify_one();
+	}
+}
+
+/**
+ * Try to take a job, first from the back of the own queue (if any), then from the front of the other queues.
+ * @param own_index Queue index of the calling worker, or -1 if the caller is not a worker of this pool.
+ * @param job Output job.
+ * @return True if a job was taken.
+ */
+bool WorkerThreadPool::TryPopJob(int own_index, WorkerJob &job)
+{
+	if (this->pending.load(std::memory_order_relaxed) == 0) return false;
+
+	const uint count = (uint)this->queues.size();
+	if (own_index >= 0) {
+		WorkerQueue &queue = *this->queues[own_index];
+		std::lock_guard<std::mutex> lk(queue.lock);
+		if (!queue.jobs.empty()) {
+			job = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+			this->pending.fetch_sub(1);
+			return true;
+		}
+	}
+
+	const uint start = own_index >= 0 ? (uint)own_index + 1 : 0;
+	for (uint i = 0; i < count; i++) {
+		uint victim = (start + i) % count;
+		if ((int)victim == own_index) continue;
+		WorkerQueue &queue = *this->queues[victim];
+		std::unique_lock<std::mutex> lk(queue.lock, std::try_to_lock);
+		if (!lk.owns_lock() || queue.jobs.empty()) continue;
+		job = std::move(queue.jobs.front());
+		queue.jobs.pop_front();
+		this->pending.fetch_sub(1);
+		return true;
+	}
+	return false;
 }
 
 void WorkerThreadPool::EnqueueJob(WorkerJobFunc *func, void *data1, void *data2, void *data3)
 {
-	std::unique_lock<std::mutex> lk(this->lock);
 	if (this->workers == 0) {
 		/* Just execute it here and now */
-		lk.unlock();
 		func(data1, data2, data3);
 		return;
 	}
-	bool notify = this->jobs.size() < (size_t)this->workers_waiting;
-	this->jobs.push({ func, data1, data2, data3 });
-	lk.unlock();
-	if (notify) this->worker_wait_cv.notify_one();
+	WorkerJob job;
+	job.func = func;
+	job.data1 = data1;
+	job.data2 = data2;
+	job.data3 = data3;
+	this->PushJob(std::move(job));
+}
+
+void WorkerThreadPool::EnqueueJob(std::function<void()> closure)
+{
+	if (this->workers == 0) {
+		/* Just execute it here and now */
+		closure();
+		return;
+	}
+	WorkerJob job;
+	job.closure = std::move(closure);
+	this->PushJob(std::move(job));
+}
+
+/**
+ * Execute one pending job on the calling thread, if there is one.
+ * @return True if a job was executed.
+ */
+bool WorkerThreadPool::TryRunPendingJob()
+{
+	if (this->workers == 0) return false;
+
+	WorkerJob job;
+	if (!this->TryPopJob(_current_worker_pool == this ? (int)_current_worker_index : -1, job)) return false;
+	TRACE_SCOPE("WorkerJob");
+	job.Execute();
+	return true;
 }
 
-void WorkerThreadPool::Run(WorkerThreadPool *pool)
+void WorkerThreadPool::Run(WorkerThreadPool *pool, uint index)
 {
-	std::unique_lock<std::mutex> lk(pool->lock);
-	while (!pool->exit || !pool->jobs.empty()) {
-		if (pool->jobs.empty()) {
-			pool->workers_waiting++;
+	_current_worker_pool = pool;
+	_current_worker_index = index;
+
+	WorkerJob job;
+	while (true) {
+		if (pool->TryPopJob(index, job)) {
+			TRACE_SCOPE("WorkerJob");
+			job.Execute();
+			job = {};
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lk(pool->lock);
+		pool->workers_waiting++;
+		bool should_exit = false;
+		while (true) {
+			if (pool->pending.load() > 0) break;
+			if (pool->exit) {
+				should_exit = true;
+				break;
+			}
 			pool->worker_wait_cv.wait(lk);
-			pool->workers_waiting--;
-		} else {
-			WorkerJob job = pool->jobs.front();
-			pool->jobs.pop();
-			lk.unlock();
-			job.func(job.data1, job.data2, job.data3);
-			lk.lock();
 		}
+		pool->workers_waiting--;
+		if (should_exit) break;
 	}
+
+	_current_worker_pool = nullptr;
+
+	std::lock_guard<std::mutex> lk(pool->lock);
 	pool->workers--;
 	if (pool->workers == 0) {
 		pool->done_cv.notify_all();
 	}
 }
+
+void WorkerTaskGroup::JobDone()
+{
+	/* Decrement under the lock so that Wait() can't return and destroy the group while this is still running */
+	std::lock_guard<std::mutex> lk(this->lock);
+	if (this->outstanding.fetch_sub(1) == 1) this->done_cv.notify_all();
+}
+
+/**
+ * Submit a job to this group.
+ * @param job Job to execute, this is run synchronously if the pool has no workers.
+ */
+void WorkerTaskGroup::Run(std::function<void()> job)
+{
+	if (this->pool.GetWorkerCount() == 0) {
+		job();
+		return;
+	}
+	this->outstanding.fetch_add(1);
+	this->pool.EnqueueJob([this, job = std::move(job)]() {
+		job();
+		this->JobDone();
+	});
+}
+
+/**
+ * Wait for all jobs submitted to this group to complete.
+ * The calling thread helps by executing pending pool jobs while waiting.
+ */
+void WorkerTaskGroup::Wait()
+{
+	while (this->outstanding.load() > 0) {
+		if (this->pool.TryRunPendingJob()) continue;
+
+		std::unique_lock<std::mutex> lk(this->lock);
+		this->done_cv.wait(lk, [this]() { return this->outstanding.load() == 0; });
+	}
+
+	/* Synchronise with the final JobDone() */
+	std::lock_guard<std::mutex> lk(this->lock);
+}
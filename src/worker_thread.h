@@ -10,7 +10,11 @@
 #ifndef WORKER_THREAD_H
 #define WORKER_THREAD_H
 
-#include <queue>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
 #include <mutex>
 #include <condition_variable>
 #if defined(__MINGW32__)
@@ -20,30 +24,71 @@
 
 typedef void WorkerJobFunc(void *, void *, void *);
 
+/**
+ * Work-stealing worker thread pool.
+ *
+ * Each worker owns a deque of jobs, jobs enqueued by a worker go to the back of its own deque and are popped from the back (LIFO),
+ * jobs enqueued by any other thread are distributed round-robin over the worker deques.
+ * Idle workers steal from the front of the other workers' deques.
+ */
 struct WorkerThreadPool {
 private:
 	struct WorkerJob {
-		WorkerJobFunc *func;
-		void *data1;
-		void *data2;
-		void *data3;
+		WorkerJobFunc *func = nullptr;
+		void *data1 = nullptr;
+		void *data2 = nullptr;
+		void *data3 = nullptr;
+		std::function<void()> closure;
+
+		void Execute()
+		{
+			if (this->func != nullptr) {
+				this->func(this->data1, this->data2, this->data3);
+			} else {
+				this->closure();
+			}
+		}
 	};
 
-	uint workers = 0;
-	uint workers_waiting = 0;
-	bool exit = false;
-	std::mutex lock;
-	std::queue<WorkerJob> jobs;
+	/** Per-worker job deque, aligned to avoid false sharing between workers. */
+	struct alignas(64) WorkerQueue {
+		std::mutex lock;
+		std::deque<WorkerJob> jobs;
+	};
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues;
+	std::atomic<uint> workers = 0;
+	std::atomic<uint> workers_waiting = 0;
+	std::atomic<uint> pending = 0;        ///< Number of jobs currently in any of the queues
+	std::atomic<uint> next_queue = 0;     ///< Round-robin counter for jobs enqueued from outside the pool
+	std::atomic<bool> exit = false;
+	std::mutex lock;                      ///< Protects start/stop and sleeping
 	std::condition_variable worker_wait_cv;
 	std::condition_variable done_cv;
 
-	static void Run(WorkerThreadPool *pool);
+	static void Run(WorkerThreadPool *pool, uint index);
+
+	void PushJob(WorkerJob &&job);
+	bool TryPopJob(int own_index, WorkerJob &job);
 
 public:
+	static constexpr uint DEFAULT_MAX_WORKERS = 64;
 
 	void Start(const char *thread_name, uint max_workers);
 	void Stop();
 	void EnqueueJob(WorkerJobFunc *func, void *data1 = nullptr, void *data2 = nullptr, void *data3 = nullptr);
+	void EnqueueJob(std::function<void()> closure);
+	bool TryRunPendingJob();
+	void ResetInForkedChild();
+
+	/**
+	 * Get the number of worker threads currently running.
+	 * @return Worker count, 0 if jobs are executed synchronously on the calling thread.
+	 */
+	uint GetWorkerCount() const
+	{
+		return this->workers.load(std::memory_order_relaxed);
+	}
 
 	~WorkerThreadPool()
 	{
@@ -53,4 +98,51 @@ public:
 
 extern WorkerThreadPool _general_worker_pool;
 
+/**
+ * Fork/join group of jobs on a WorkerThreadPool.
+ * Wait() blocks until all jobs submitted with Run() have completed, the waiting thread executes pending pool jobs in the meantime.
+ */
+class WorkerTaskGroup {
+	WorkerThreadPool &pool;
+	std::atomic<uint> outstanding = 0;
+	std::mutex lock;
+	std::condition_variable done_cv;
+
+	void JobDone();
+
+public:
+	WorkerTaskGroup(WorkerThreadPool &pool = _general_worker_pool) : pool(pool) {}
+
+	~WorkerTaskGroup()
+	{
+		this->Wait();
+	}
+
+	WorkerTaskGroup(const WorkerTaskGroup &) = delete;
+	WorkerTaskGroup &operator=(const WorkerTaskGroup &) = delete;
+
+	void Run(std::function<void()> job);
+	void Wait();
+
+	/**
+	 * Run func(i) for each i in [begin, end), split into batches of at most batch_size, and wait for all of them to complete.
+	 * @param begin First index.
+	 * @param end One past the last index.
+	 * @param batch_size Maximum number of indices per job.
+	 * @param func Function to call for each index.
+	 */
+	template <typename F>
+	void ParallelFor(size_t begin, size_t end, size_t batch_size, F func)
+	{
+		if (batch_size == 0) batch_size = 1;
+		for (size_t start = begin; start < end; start += batch_size) {
+			size_t last = std::min(end, start + batch_size);
+			this->Run([start, last, &func]() {
+				for (size_t i = start; i < last; i++) func(i);
+			});
+		}
+		this->Wait();
+	}
+};
+
 #endif /* WORKER_THREAD_H */
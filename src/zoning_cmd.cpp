@@ -28,13 +28,90 @@
 #include "road_map.h"
 #include "debug_settings.h"
 #include "animated_tile.h"
-#include "3rdparty/cpp-btree/btree_set.h"
 
 Zoning _zoning;
 static const SpriteID ZONING_INVALID_SPRITE_ID = UINT_MAX;
 
-static btree::btree_set<uint32> _zoning_cache_inner;
-static btree::btree_set<uint32> _zoning_cache_outer;
+/**
+ * Cached zoning evaluation results of one layer.
+ * The results are stored per tile in blocks of tiles, which are only allocated once a tile in them is evaluated.
+ */
+struct ZoningCachePlane {
+	static const uint BLOCK_BITS = 6;                      ///< Width and height of a block in tiles, as a power of 2.
+	static const uint8 NOT_CACHED = 0xFF;                  ///< Value of a tile which has no cached result.
+
+	std::vector<std::unique_ptr<uint8[]>> blocks;          ///< Blocks of results, indexed by block row and column.
+
+	static inline uint GetBlockCount()
+	{
+		return (MapSizeX() >> BLOCK_BITS) * (MapSizeY() >> BLOCK_BITS);
+	}
+
+	inline uint GetBlockIndex(uint x, uint y) const
+	{
+		return ((y >> BLOCK_BITS) * (MapSizeX() >> BLOCK_BITS)) + (x >> BLOCK_BITS);
+	}
+
+	static inline uint GetIndexInBlock(uint x, uint y)
+	{
+		return ((y & ((1 << BLOCK_BITS) - 1)) << BLOCK_BITS) | (x & ((1 << BLOCK_BITS) - 1));
+	}
+
+	/**
+	 * Get the cached result of a tile.
+	 * @param tile The tile.
+	 * @return The cached result, or NOT_CACHED.
+	 */
+	uint8 Get(TileIndex tile) const
+	{
+		if (this->blocks.size() != GetBlockCount()) return NOT_CACHED;
+		const std::unique_ptr<uint8[]> &block = this->blocks[this->GetBlockIndex(TileX(tile), TileY(tile))];
+		if (block == nullptr) return NOT_CACHED;
+		return block[GetIndexInBlock(TileX(tile), TileY(tile))];
+	}
+
+	/**
+	 * Store the result of a tile.
+	 * @param tile The tile.
+	 * @param value The result.
+	 */
+	void Set(TileIndex tile, uint8 value)
+	{
+		if (this->blocks.size() != GetBlockCount()) {
+			this->blocks.clear();
+			this->blocks.resize(GetBlockCount());
+		}
+		std::unique_ptr<uint8[]> &block = this->blocks[this->GetBlockIndex(TileX(tile), TileY(tile))];
+		if (block == nullptr) {
+			block.reset(new uint8[1 << (BLOCK_BITS * 2)]);
+			memset(block.get(), NOT_CACHED, 1 << (BLOCK_BITS * 2));
+		}
+		block[GetIndexInBlock(TileX(tile), TileY(tile))] = value;
+	}
+
+	/**
+	 * Forget the results of the tiles in a rectangle.
+	 * @param rect The rectangle, in tile coordinates, inclusive.
+	 */
+	void Invalidate(const Rect &rect)
+	{
+		if (this->blocks.size() != GetBlockCount()) return;
+		for (int y = rect.top; y <= rect.bottom; y++) {
+			for (int x = rect.left; x <= rect.right; x++) {
+				std::unique_ptr<uint8[]> &block = this->blocks[this->GetBlockIndex(x, y)];
+				if (block != nullptr) block[GetIndexInBlock(x, y)] = NOT_CACHED;
+			}
+		}
+	}
+
+	void Clear()
+	{
+		this->blocks.clear();
+	}
+};
+
+static ZoningCachePlane _zoning_cache_inner;
+static ZoningCachePlane _zoning_cache_outer;
 
 /**
  * Draw the zoning sprites.
@@ -377,10 +454,10 @@ inline SpriteID TileZoningSpriteEvaluationCached(TileIndex tile, Owner owner, Zo
 	if (ev_mode == ZEM_IND_UNSER && !IsTileType(tile, MP_INDUSTRY)) return ZONING_INVALID_SPRITE_ID;
 	if (ev_mode >= ZEM_STA_CATCH && ev_mode <= ZEM_IND_UNSER) {
 		// cacheable
-		btree::btree_set<uint32> &cache = is_inner ? _zoning_cache_inner : _zoning_cache_outer;
-		auto iter = cache.lower_bound(tile << 3);
-		if (iter != cache.end() && *iter >> 3 == tile) {
-			switch (*iter & 7) {
+		ZoningCachePlane &cache = is_inner ? _zoning_cache_inner : _zoning_cache_outer;
+		const uint8 cached = cache.Get(tile);
+		if (cached != ZoningCachePlane::NOT_CACHED) {
+			switch (cached) {
 				case 0: return ZONING_INVALID_SPRITE_ID;
 				case 1: return SPR_ZONING_INNER_HIGHLIGHT_RED;
 				case 2: return SPR_ZONING_INNER_HIGHLIGHT_ORANGE;
@@ -390,16 +467,16 @@ inline SpriteID TileZoningSpriteEvaluationCached(TileIndex tile, Owner owner, Zo
 			}
 		} else {
 			SpriteID s = TileZoningSpriteEvaluation(tile, owner, ev_mode);
-			uint val = tile << 3;
+			uint8 val;
 			switch (s) {
-				case ZONING_INVALID_SPRITE_ID:              val |= 0; break;
-				case SPR_ZONING_INNER_HIGHLIGHT_RED:        val |= 1; break;
-				case SPR_ZONING_INNER_HIGHLIGHT_ORANGE:     val |= 2; break;
-				case SPR_ZONING_INNER_HIGHLIGHT_BLACK:      val |= 3; break;
-				case SPR_ZONING_INNER_HIGHLIGHT_LIGHT_BLUE: val |= 4; break;
+				case ZONING_INVALID_SPRITE_ID:              val = 0; break;
+				case SPR_ZONING_INNER_HIGHLIGHT_RED:        val = 1; break;
+				case SPR_ZONING_INNER_HIGHLIGHT_ORANGE:     val = 2; break;
+				case SPR_ZONING_INNER_HIGHLIGHT_BLACK:      val = 3; break;
+				case SPR_ZONING_INNER_HIGHLIGHT_LIGHT_BLUE: val = 4; break;
 				default: NOT_REACHED();
 			}
-			cache.insert(iter, val);
+			cache.Set(tile, val);
 			return s;
 		}
 	} else {
@@ -488,17 +565,8 @@ void ZoningMarkDirtyStationCoverageArea(const Station *st, ZoningModeMask mask)
 				MarkTileDirtyByTile(TileXY(x, y), VMDF_NOT_MAP_MODE);
 			}
 		}
-		auto invalidate_cache_rect = [&](btree::btree_set<uint32> &cache) {
-			for (int y = rect.top; y <= rect.bottom; y++) {
-				auto iter = cache.lower_bound(TileXY(rect.left, y) << 3);
-				auto end_iter = iter;
-				uint end = (TileXY(rect.right, y) + 1) << 3;
-				while (end_iter != cache.end() && *end_iter < end) ++end_iter;
-				cache.erase(iter, end_iter);
-			}
-		};
-		if (outer_radius) invalidate_cache_rect(_zoning_cache_outer);
-		if (inner_radius) invalidate_cache_rect(_zoning_cache_inner);
+		if (outer_radius) _zoning_cache_outer.Invalidate(rect);
+		if (inner_radius) _zoning_cache_inner.Invalidate(rect);
 	}
 }
 
@@ -522,19 +590,19 @@ void ZoningTownAuthorityRatingChange()
 
 void ClearZoningCaches()
 {
-	_zoning_cache_inner.clear();
-	_zoning_cache_outer.clear();
+	_zoning_cache_inner.Clear();
+	_zoning_cache_outer.Clear();
 }
 
 void SetZoningMode(bool inner, ZoningEvaluationMode mode)
 {
 	ZoningEvaluationMode &current_mode = inner ? _zoning.inner : _zoning.outer;
-	btree::btree_set<uint32> &cache = inner ? _zoning_cache_inner : _zoning_cache_outer;
+	ZoningCachePlane &cache = inner ? _zoning_cache_inner : _zoning_cache_outer;
 
 	if (current_mode == mode) return;
 
 	current_mode = mode;
-	cache.clear();
+	cache.Clear();
 	MarkWholeNonMapViewportsDirty();
 	PostZoningModeChange();
 }